@@ -0,0 +1,864 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_COMPACT_INTEGER_HPP
+#define MPPP_COMPACT_INTEGER_HPP
+
+#include <mp++/config.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/concepts.hpp>
+#include <mp++/detail/gmp.hpp>
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/exceptions.hpp>
+#include <mp++/integer.hpp>
+
+namespace mppp
+{
+
+class compact_integer;
+
+inline namespace detail
+{
+
+// The type of the machine word used by compact_integer.
+using compact_word_t = std::uintptr_t;
+
+// Number of bits available for the magnitude of an inline value: one bit is taken by the
+// tag, another one by the sign.
+constexpr unsigned compact_integer_inline_bits
+    = static_cast<unsigned>(std::numeric_limits<compact_word_t>::digits) - 2u;
+
+// Largest magnitude of an inline value.
+constexpr compact_word_t compact_integer_inline_max = (compact_word_t(1) << compact_integer_inline_bits) - 1u;
+
+// A read-only mpz view of a word-sized value, stored in local limbs.
+class compact_integer_limbs
+{
+    static constexpr std::size_t nlimbs = static_cast<std::size_t>(std::numeric_limits<compact_word_t>::digits)
+                                              / unsigned(GMP_NUMB_BITS)
+                                          + 1u;
+    template <typename T, enable_if_t<(GMP_NUMB_BITS < std::numeric_limits<T>::digits), int> = 0>
+    static void shift_limb(T &n)
+    {
+        n >>= GMP_NUMB_BITS;
+    }
+    template <typename T, enable_if_t<(GMP_NUMB_BITS >= std::numeric_limits<T>::digits), int> = 0>
+    static void shift_limb(T &n)
+    {
+        n = 0u;
+    }
+
+public:
+    explicit compact_integer_limbs(bool neg, compact_word_t mag)
+    {
+        mpz_size_t size = 0;
+        while (mag) {
+            m_limbs[static_cast<std::size_t>(size++)] = static_cast<::mp_limb_t>(mag & GMP_NUMB_MASK);
+            shift_limb(mag);
+        }
+        m_mpz._mp_alloc = static_cast<mpz_alloc_t>(nlimbs);
+        m_mpz._mp_size = neg ? -size : size;
+        m_mpz._mp_d = m_limbs.data();
+    }
+    // NOTE: the mpz points to the internal limbs.
+    compact_integer_limbs(const compact_integer_limbs &) = delete;
+    compact_integer_limbs &operator=(const compact_integer_limbs &) = delete;
+    const mpz_struct_t *get() const
+    {
+        return &m_mpz;
+    }
+
+private:
+    std::array<::mp_limb_t, nlimbs> m_limbs;
+    mpz_struct_t m_mpz;
+};
+
+// Read the magnitude of an mpz which is known to be smaller than 2**compact_integer_inline_bits.
+inline compact_word_t compact_integer_mpz_abs(const mpz_struct_t &m)
+{
+    const auto asize = get_mpz_size(&m);
+    compact_word_t retval = 0;
+    unsigned shift = 0;
+    for (std::size_t i = 0; i < asize; ++i, shift += unsigned(GMP_NUMB_BITS)) {
+        retval |= static_cast<compact_word_t>(m._mp_d[i] & GMP_NUMB_MASK) << shift;
+    }
+    return retval;
+}
+
+template <typename T, typename U>
+using compact_integer_op_types_enabler = enable_if_t<
+    disjunction<conjunction<std::is_same<T, compact_integer>, std::is_same<U, compact_integer>>,
+                conjunction<std::is_same<T, compact_integer>, is_supported_integral<U>>,
+                conjunction<is_supported_integral<T>, std::is_same<U, compact_integer>>>::value,
+    int>;
+}
+
+/// Compact multiprecision integer.
+/**
+ * \rststar
+ * This class represents an arbitrary-precision signed integer which occupies a single machine word (i.e.,
+ * the size of a pointer). Values whose absolute value is smaller than :math:`2^{B-2}`, where :math:`B` is the bit
+ * width of a pointer (that is, :math:`2^{62}` on 64-bit platforms), are stored inline in the word, together with a
+ * tag bit. Larger values are stored in a GMP integer allocated on the heap, and the word holds a pointer to it.
+ * The representation is canonical: a value is stored on the heap if and only if it does not fit inline.
+ *
+ * In comparison, :cpp:class:`integer\<1\> <mppp::integer>` occupies two words on 64-bit platforms, as its
+ * static storage holds the size of the integer next to the limb. ``compact_integer`` is thus suitable for large
+ * tables of mostly-small integers, at the price of a more expensive arithmetic on heap-allocated values.
+ *
+ * ``compact_integer`` can be constructed from, and converted to, C++ integral types and :cpp:class:`~mppp::integer`.
+ * The arithmetic operators ``+``, ``-``, ``*``, ``/`` and ``%`` (with the semantics of truncated division),
+ * their in-place counterparts and the comparison operators are provided, also in mixed mode with C++ integral types.
+ * \endrststar
+ */
+class compact_integer
+{
+    // Tag bit, set for inline values.
+    static constexpr compact_word_t inline_tag = 1u;
+    struct heap_tag {
+    };
+    // Construct an empty heap value.
+    explicit compact_integer(const heap_tag &) : m_word(0)
+    {
+        auto ptr = new mpz_struct_t;
+        ::mpz_init(ptr);
+        set_ptr(ptr);
+    }
+    void set_ptr(mpz_struct_t *ptr)
+    {
+        m_word = reinterpret_cast<compact_word_t>(ptr);
+        // NOTE: the tag bit is available because of the alignment of mpz_struct_t.
+        assert(!(m_word & inline_tag));
+    }
+    mpz_struct_t *get_ptr() const
+    {
+        assert(!is_inline());
+        return reinterpret_cast<mpz_struct_t *>(m_word);
+    }
+    void set_inline(bool neg, compact_word_t mag)
+    {
+        assert(mag <= compact_integer_inline_max);
+        // NOTE: the value is stored in two's complement, shifted up by one bit.
+        m_word = ((neg ? compact_word_t(0) - mag : mag) << 1) | inline_tag;
+    }
+    // Sign and magnitude of an inline value.
+    bool inline_neg() const
+    {
+        assert(is_inline());
+        return (m_word >> (std::numeric_limits<compact_word_t>::digits - 1)) != 0u;
+    }
+    compact_word_t inline_abs() const
+    {
+        assert(is_inline());
+        const auto u = m_word >> 1;
+        return inline_neg() ? (~u + 1u) & (compact_word_t(-1) >> 1) : u;
+    }
+    // Set from a word-sized sign and magnitude.
+    void set_word_value(bool neg, compact_word_t mag)
+    {
+        destroy();
+        if (mag <= compact_integer_inline_max) {
+            set_inline(neg, mag);
+        } else {
+            auto ptr = new mpz_struct_t;
+            const compact_integer_limbs l(neg, mag);
+            ::mpz_init_set(ptr, l.get());
+            set_ptr(ptr);
+        }
+    }
+    // Make the representation canonical after an mpz operation.
+    void normalise()
+    {
+        if (!is_inline() && ::mpz_sizeinbase(get_ptr(), 2) <= compact_integer_inline_bits) {
+            const auto ptr = get_ptr();
+            const bool neg = ptr->_mp_size < 0;
+            const auto mag = compact_integer_mpz_abs(*ptr);
+            ::mpz_clear(ptr);
+            delete ptr;
+            set_inline(neg, mag);
+        }
+    }
+    void destroy()
+    {
+        if (!is_inline()) {
+            const auto ptr = get_ptr();
+            ::mpz_clear(ptr);
+            delete ptr;
+            m_word = inline_tag;
+        }
+    }
+    // Construction from mpz.
+    void dispatch_mpz_ctor(const mpz_struct_t *n)
+    {
+        if (::mpz_sizeinbase(n, 2) <= compact_integer_inline_bits) {
+            set_inline(n->_mp_size < 0, compact_integer_mpz_abs(*n));
+        } else {
+            auto ptr = new mpz_struct_t;
+            ::mpz_init_set(ptr, n);
+            set_ptr(ptr);
+        }
+    }
+    // Construction from integrals.
+    template <typename T, enable_if_t<std::is_unsigned<T>::value, int> = 0>
+    void dispatch_integral_ctor(const T &n)
+    {
+        if (n <= compact_integer_inline_max) {
+            set_inline(false, static_cast<compact_word_t>(n));
+        } else {
+            dispatch_mpz_ctor(integer<2>{n}.get_mpz_view());
+        }
+    }
+    template <typename T, enable_if_t<std::is_signed<T>::value, int> = 0>
+    void dispatch_integral_ctor(const T &n)
+    {
+        using uT = make_unsigned_t<T>;
+        const auto mag = n < T(0) ? static_cast<uT>(uT(0) - static_cast<uT>(n)) : static_cast<uT>(n);
+        if (mag <= compact_integer_inline_max) {
+            set_inline(n < T(0), static_cast<compact_word_t>(mag));
+        } else {
+            dispatch_mpz_ctor(integer<2>{n}.get_mpz_view());
+        }
+    }
+    void dispatch_integral_ctor(const bool &b)
+    {
+        set_inline(false, static_cast<compact_word_t>(b));
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The default constructor initialises the value to zero.
+     */
+    compact_integer() : m_word(inline_tag)
+    {
+    }
+    /// Copy constructor.
+    /**
+     * @param other the object that will be copied.
+     */
+    compact_integer(const compact_integer &other) : m_word(other.m_word)
+    {
+        if (!other.is_inline()) {
+            auto ptr = new mpz_struct_t;
+            ::mpz_init_set(ptr, other.get_ptr());
+            set_ptr(ptr);
+        }
+    }
+    /// Move constructor.
+    /**
+     * @param other the object that will be moved. After the move, \p other will be zero.
+     */
+    compact_integer(compact_integer &&other) noexcept : m_word(other.m_word)
+    {
+        other.m_word = inline_tag;
+    }
+    /// Generic constructor.
+    /**
+     * \rststar
+     * This constructor is enabled only if ``T`` is a :cpp:concept:`~mppp::CppInteroperable` integral type.
+     * \endrststar
+     *
+     * @param n the value that will be used to initialise \p this.
+     */
+    template <typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
+    explicit compact_integer(const T &n) : m_word(inline_tag)
+    {
+        dispatch_integral_ctor(n);
+    }
+    /// Constructor from \link mppp::integer integer\endlink.
+    /**
+     * @param n the value that will be used to initialise \p this.
+     */
+    template <std::size_t SSize>
+    explicit compact_integer(const integer<SSize> &n) : m_word(inline_tag)
+    {
+        dispatch_mpz_ctor(n.get_mpz_view());
+    }
+    /// Constructor from string.
+    /**
+     * @param s the string that will be used to initialise \p this.
+     * @param base the base used in the string representation.
+     *
+     * @throws unspecified any exception thrown by the constructor of \link mppp::integer integer\endlink from
+     * string.
+     */
+    explicit compact_integer(const std::string &s, int base = 10) : compact_integer(integer<1>{s, base})
+    {
+    }
+    /// Copy assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     */
+    compact_integer &operator=(const compact_integer &other)
+    {
+        if (mppp_likely(this != &other)) {
+            if (other.is_inline()) {
+                destroy();
+                m_word = other.m_word;
+            } else if (is_inline()) {
+                *this = compact_integer(other);
+            } else {
+                // NOTE: reuse the existing heap storage.
+                ::mpz_set(get_ptr(), other.get_ptr());
+            }
+        }
+        return *this;
+    }
+    /// Move assignment operator.
+    /**
+     * @param other the assignment argument. After the move, \p other will be zero.
+     *
+     * @return a reference to \p this.
+     */
+    compact_integer &operator=(compact_integer &&other) noexcept
+    {
+        if (mppp_likely(this != &other)) {
+            destroy();
+            m_word = other.m_word;
+            other.m_word = inline_tag;
+        }
+        return *this;
+    }
+    /// Destructor.
+    ~compact_integer()
+    {
+        destroy();
+    }
+    /// Test for inline storage.
+    /**
+     * @return \p true if the value of \p this is stored inline, \p false if it is stored on the heap.
+     */
+    bool is_inline() const
+    {
+        return (m_word & inline_tag) != 0u;
+    }
+    /// Sign.
+    /**
+     * @return 0 if \p this is zero, 1 if \p this is positive, -1 if \p this is negative.
+     */
+    int sgn() const
+    {
+        if (is_inline()) {
+            return inline_neg() ? -1 : static_cast<int>(m_word != inline_tag);
+        }
+        return mpz_sgn(get_ptr());
+    }
+    /// Conversion to \link mppp::integer integer\endlink.
+    /**
+     * @return \p this converted to \link mppp::integer integer\endlink.
+     */
+    template <std::size_t SSize>
+    explicit operator integer<SSize>() const
+    {
+        if (is_inline()) {
+            const compact_integer_limbs l(inline_neg(), inline_abs());
+            return integer<SSize>{l.get()};
+        }
+        return integer<SSize>{get_ptr()};
+    }
+    /// Conversion to C++ integral types.
+    /**
+     * \rststar
+     * This operator is enabled only if ``T`` is a :cpp:concept:`~mppp::CppInteroperable` integral type.
+     * \endrststar
+     *
+     * @return \p this converted to \p T.
+     *
+     * @throws std::overflow_error if the value of \p this cannot be represented by \p T.
+     */
+    template <typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
+    explicit operator T() const
+    {
+        return static_cast<T>(static_cast<integer<1>>(*this));
+    }
+    /// Conversion to string.
+    /**
+     * @param base the desired base.
+     *
+     * @return a string representation of \p this.
+     *
+     * @throws std::invalid_argument if \p base is not between 2 and 62.
+     */
+    std::string to_string(int base = 10) const
+    {
+        return static_cast<integer<1>>(*this).to_string(base);
+    }
+    /// Ternary addition.
+    /**
+     * @param rop the return value.
+     * @param op1 the first argument.
+     * @param op2 the second argument.
+     *
+     * @return a reference to \p rop.
+     */
+    friend compact_integer &add(compact_integer &rop, const compact_integer &op1, const compact_integer &op2)
+    {
+        return addsub<true>(rop, op1, op2);
+    }
+    /// Ternary subtraction.
+    /**
+     * @param rop the return value.
+     * @param op1 the first argument.
+     * @param op2 the second argument.
+     *
+     * @return a reference to \p rop.
+     */
+    friend compact_integer &sub(compact_integer &rop, const compact_integer &op1, const compact_integer &op2)
+    {
+        return addsub<false>(rop, op1, op2);
+    }
+    /// Ternary multiplication.
+    /**
+     * @param rop the return value.
+     * @param op1 the first argument.
+     * @param op2 the second argument.
+     *
+     * @return a reference to \p rop.
+     */
+    friend compact_integer &mul(compact_integer &rop, const compact_integer &op1, const compact_integer &op2)
+    {
+        if (op1.is_inline() && op2.is_inline()) {
+            const auto a1 = op1.inline_abs(), a2 = op2.inline_abs();
+            constexpr auto half = compact_word_t(1) << (std::numeric_limits<compact_word_t>::digits / 2);
+            if (a1 < half && a2 < half) {
+                // The product fits in a word.
+                rop.set_word_value(op1.inline_neg() != op2.inline_neg(), a1 * a2);
+                return rop;
+            }
+        }
+        return mpz_binary(rop, op1, op2, ::mpz_mul);
+    }
+    /// Ternary truncated division.
+    /**
+     * @param rop the return value.
+     * @param op1 the dividend.
+     * @param op2 the divisor.
+     *
+     * @return a reference to \p rop.
+     *
+     * @throws zero_division_error if \p op2 is zero.
+     */
+    friend compact_integer &tdiv_q(compact_integer &rop, const compact_integer &op1, const compact_integer &op2)
+    {
+        if (mppp_unlikely(op2.sgn() == 0)) {
+            throw zero_division_error("Integer division by zero");
+        }
+        if (op1.is_inline() && op2.is_inline()) {
+            rop.set_word_value(op1.inline_neg() != op2.inline_neg(), op1.inline_abs() / op2.inline_abs());
+            return rop;
+        }
+        return mpz_binary(rop, op1, op2, ::mpz_tdiv_q);
+    }
+    /// Ternary truncated remainder.
+    /**
+     * @param rop the return value.
+     * @param op1 the dividend.
+     * @param op2 the divisor.
+     *
+     * @return a reference to \p rop.
+     *
+     * @throws zero_division_error if \p op2 is zero.
+     */
+    friend compact_integer &tdiv_r(compact_integer &rop, const compact_integer &op1, const compact_integer &op2)
+    {
+        if (mppp_unlikely(op2.sgn() == 0)) {
+            throw zero_division_error("Integer division by zero");
+        }
+        if (op1.is_inline() && op2.is_inline()) {
+            rop.set_word_value(op1.inline_neg(), op1.inline_abs() % op2.inline_abs());
+            return rop;
+        }
+        return mpz_binary(rop, op1, op2, ::mpz_tdiv_r);
+    }
+    /// Negate in place.
+    /**
+     * @return a reference to \p this.
+     */
+    compact_integer &neg()
+    {
+        if (is_inline()) {
+            set_inline(!inline_neg() && m_word != inline_tag, inline_abs());
+        } else {
+            ::mpz_neg(get_ptr(), get_ptr());
+        }
+        return *this;
+    }
+    /// Three-way comparison.
+    /**
+     * @param op1 the first argument.
+     * @param op2 the second argument.
+     *
+     * @return 0 if <tt>op1 == op2</tt>, a negative value if <tt>op1 < op2</tt>, a positive value if
+     * <tt>op1 > op2</tt>.
+     */
+    friend int cmp(const compact_integer &op1, const compact_integer &op2)
+    {
+        if (op1.is_inline() && op2.is_inline()) {
+            // NOTE: compare the signed inline values, shifting the sign bit so that unsigned
+            // comparison gives the correct ordering.
+            constexpr auto sign_bit = compact_word_t(1) << (std::numeric_limits<compact_word_t>::digits - 1);
+            const auto w1 = op1.m_word ^ sign_bit, w2 = op2.m_word ^ sign_bit;
+            return (w1 > w2) - (w1 < w2);
+        }
+        const mpz_view v1{op1}, v2{op2};
+        return ::mpz_cmp(v1.get(), v2.get());
+    }
+    /// Output stream operator.
+    /**
+     * @param os the target stream.
+     * @param n the value that will be printed.
+     *
+     * @return a reference to \p os.
+     */
+    friend std::ostream &operator<<(std::ostream &os, const compact_integer &n)
+    {
+        return os << static_cast<integer<1>>(n);
+    }
+
+private:
+    // A view of this as an mpz: either a pointer to the heap value, or the inline value in local limbs.
+    class mpz_view
+    {
+    public:
+        explicit mpz_view(const compact_integer &n)
+            : m_ptr(n.is_inline() ? nullptr : n.get_ptr()), m_limbs(n.is_inline() && n.inline_neg(),
+                                                                     n.is_inline() ? n.inline_abs() : 0u)
+        {
+        }
+        mpz_view(const mpz_view &) = delete;
+        mpz_view &operator=(const mpz_view &) = delete;
+        const mpz_struct_t *get() const
+        {
+            return m_ptr ? m_ptr : m_limbs.get();
+        }
+
+    private:
+        const mpz_struct_t *m_ptr;
+        compact_integer_limbs m_limbs;
+    };
+    template <typename F>
+    static compact_integer &mpz_binary(compact_integer &rop, const compact_integer &op1, const compact_integer &op2,
+                                       const F &f)
+    {
+        const mpz_view v1{op1}, v2{op2};
+        if (rop.is_inline()) {
+            compact_integer tmp{heap_tag{}};
+            f(tmp.get_ptr(), v1.get(), v2.get());
+            tmp.normalise();
+            rop = std::move(tmp);
+        } else {
+            // NOTE: GMP functions allow aliasing between rop and the operands.
+            f(rop.get_ptr(), v1.get(), v2.get());
+            rop.normalise();
+        }
+        return rop;
+    }
+    template <bool AddOrSub>
+    static compact_integer &addsub(compact_integer &rop, const compact_integer &op1, const compact_integer &op2)
+    {
+        if (op1.is_inline() && op2.is_inline()) {
+            const bool neg1 = op1.inline_neg(), neg2 = AddOrSub ? op2.inline_neg() : !op2.inline_neg();
+            const auto a1 = op1.inline_abs(), a2 = op2.inline_abs();
+            // NOTE: the magnitudes are smaller than 2**(B-2), thus their sum fits in a word.
+            if (neg1 == neg2) {
+                rop.set_word_value(neg1 && (a1 + a2) != 0u, a1 + a2);
+            } else if (a1 >= a2) {
+                rop.set_word_value(neg1 && a1 != a2, a1 - a2);
+            } else {
+                rop.set_word_value(neg2, a2 - a1);
+            }
+            return rop;
+        }
+        return mpz_binary(rop, op1, op2, AddOrSub ? ::mpz_add : ::mpz_sub);
+    }
+
+    compact_word_t m_word;
+};
+
+static_assert(sizeof(compact_integer) == sizeof(void *), "Invalid size for compact_integer.");
+
+inline namespace detail
+{
+
+inline const compact_integer &compact_integer_cast(const compact_integer &n)
+{
+    return n;
+}
+
+template <typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
+inline compact_integer compact_integer_cast(const T &n)
+{
+    return compact_integer{n};
+}
+}
+
+/** @defgroup compact_integer_operators compact_integer_operators
+ *  @{
+ */
+
+/// Negated copy.
+/**
+ * @param n the value that will be negated.
+ *
+ * @return <tt>-n</tt>.
+ */
+inline compact_integer operator-(const compact_integer &n)
+{
+    compact_integer retval{n};
+    retval.neg();
+    return retval;
+}
+
+/// Binary addition operator.
+/**
+ * \rststar
+ * This operator is enabled if both arguments are :cpp:class:`~mppp::compact_integer`, or if one argument
+ * is :cpp:class:`~mppp::compact_integer` and the other one a :cpp:concept:`~mppp::CppInteroperable`
+ * integral type.
+ * \endrststar
+ *
+ * @param op1 the first summand.
+ * @param op2 the second summand.
+ *
+ * @return <tt>op1 + op2</tt>.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline compact_integer operator+(const T &op1, const U &op2)
+{
+    compact_integer retval;
+    add(retval, compact_integer_cast(op1), compact_integer_cast(op2));
+    return retval;
+}
+
+/// Binary subtraction operator.
+/**
+ * @param op1 the first operand.
+ * @param op2 the second operand.
+ *
+ * @return <tt>op1 - op2</tt>.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline compact_integer operator-(const T &op1, const U &op2)
+{
+    compact_integer retval;
+    sub(retval, compact_integer_cast(op1), compact_integer_cast(op2));
+    return retval;
+}
+
+/// Binary multiplication operator.
+/**
+ * @param op1 the first factor.
+ * @param op2 the second factor.
+ *
+ * @return <tt>op1 * op2</tt>.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline compact_integer operator*(const T &op1, const U &op2)
+{
+    compact_integer retval;
+    mul(retval, compact_integer_cast(op1), compact_integer_cast(op2));
+    return retval;
+}
+
+/// Binary division operator.
+/**
+ * @param n the dividend.
+ * @param d the divisor.
+ *
+ * @return <tt>n / d</tt>, truncated.
+ *
+ * @throws zero_division_error if \p d is zero.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline compact_integer operator/(const T &n, const U &d)
+{
+    compact_integer retval;
+    tdiv_q(retval, compact_integer_cast(n), compact_integer_cast(d));
+    return retval;
+}
+
+/// Binary modulo operator.
+/**
+ * @param n the dividend.
+ * @param d the divisor.
+ *
+ * @return <tt>n % d</tt>, with the sign of \p n.
+ *
+ * @throws zero_division_error if \p d is zero.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline compact_integer operator%(const T &n, const U &d)
+{
+    compact_integer retval;
+    tdiv_r(retval, compact_integer_cast(n), compact_integer_cast(d));
+    return retval;
+}
+
+/// In-place addition operator.
+/**
+ * @param rop the augend.
+ * @param op the addend.
+ *
+ * @return a reference to \p rop.
+ */
+template <typename T, compact_integer_op_types_enabler<compact_integer, T> = 0>
+inline compact_integer &operator+=(compact_integer &rop, const T &op)
+{
+    return add(rop, rop, compact_integer_cast(op));
+}
+
+/// In-place subtraction operator.
+/**
+ * @param rop the minuend.
+ * @param op the subtrahend.
+ *
+ * @return a reference to \p rop.
+ */
+template <typename T, compact_integer_op_types_enabler<compact_integer, T> = 0>
+inline compact_integer &operator-=(compact_integer &rop, const T &op)
+{
+    return sub(rop, rop, compact_integer_cast(op));
+}
+
+/// In-place multiplication operator.
+/**
+ * @param rop the multiplicand.
+ * @param op the multiplicator.
+ *
+ * @return a reference to \p rop.
+ */
+template <typename T, compact_integer_op_types_enabler<compact_integer, T> = 0>
+inline compact_integer &operator*=(compact_integer &rop, const T &op)
+{
+    return mul(rop, rop, compact_integer_cast(op));
+}
+
+/// In-place division operator.
+/**
+ * @param rop the dividend.
+ * @param op the divisor.
+ *
+ * @return a reference to \p rop, set to <tt>rop / op</tt> (truncated).
+ *
+ * @throws zero_division_error if \p op is zero.
+ */
+template <typename T, compact_integer_op_types_enabler<compact_integer, T> = 0>
+inline compact_integer &operator/=(compact_integer &rop, const T &op)
+{
+    return tdiv_q(rop, rop, compact_integer_cast(op));
+}
+
+/// In-place modulo operator.
+/**
+ * @param rop the dividend.
+ * @param op the divisor.
+ *
+ * @return a reference to \p rop, set to <tt>rop % op</tt> (with the sign of \p rop).
+ *
+ * @throws zero_division_error if \p op is zero.
+ */
+template <typename T, compact_integer_op_types_enabler<compact_integer, T> = 0>
+inline compact_integer &operator%=(compact_integer &rop, const T &op)
+{
+    return tdiv_r(rop, rop, compact_integer_cast(op));
+}
+
+/// Equality operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 == op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline bool operator==(const T &op1, const U &op2)
+{
+    return cmp(compact_integer_cast(op1), compact_integer_cast(op2)) == 0;
+}
+
+/// Inequality operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 != op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline bool operator!=(const T &op1, const U &op2)
+{
+    return !(op1 == op2);
+}
+
+/// Less-than operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 < op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline bool operator<(const T &op1, const U &op2)
+{
+    return cmp(compact_integer_cast(op1), compact_integer_cast(op2)) < 0;
+}
+
+/// Less-than or equal operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 <= op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline bool operator<=(const T &op1, const U &op2)
+{
+    return cmp(compact_integer_cast(op1), compact_integer_cast(op2)) <= 0;
+}
+
+/// Greater-than operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 > op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline bool operator>(const T &op1, const U &op2)
+{
+    return cmp(compact_integer_cast(op1), compact_integer_cast(op2)) > 0;
+}
+
+/// Greater-than or equal operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 >= op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, compact_integer_op_types_enabler<T, U> = 0>
+inline bool operator>=(const T &op1, const U &op2)
+{
+    return cmp(compact_integer_cast(op1), compact_integer_cast(op2)) >= 0;
+}
+
+/** @} */
+}
+
+#endif
@@ -0,0 +1,121 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_DETAIL_PARALLEL_HPP
+#define MPPP_DETAIL_PARALLEL_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <mp++/config.hpp>
+
+namespace mppp
+{
+
+inline namespace detail
+{
+
+// Small helpers for the implementation of the parallel algorithms.
+
+// Determine the number of threads to be used to process a workload of n items, in such a way
+// that each thread processes at least min_items items. nthreads is the number of threads requested
+// by the user: if zero, the number of threads will be deduced from the hardware concurrency.
+// The return value is always at least 1.
+inline unsigned parallel_nthreads(std::size_t n, std::size_t min_items, unsigned nthreads)
+{
+    assert(min_items > 0u);
+    if (!nthreads) {
+        // NOTE: hardware_concurrency() returns zero if the value is not well-defined or not computable.
+        nthreads = std::thread::hardware_concurrency();
+        if (!nthreads) {
+            nthreads = 1u;
+        }
+    }
+    const auto max_threads = n / min_items;
+    if (max_threads < nthreads) {
+        return max_threads ? static_cast<unsigned>(max_threads) : 1u;
+    }
+    return nthreads;
+}
+
+// Compute the half-open range of indices [begin, end) corresponding to the i-th of nchunks
+// chunks into which n items are partitioned. The chunks are as even as possible.
+inline std::pair<std::size_t, std::size_t> parallel_chunk(std::size_t n, unsigned nchunks, unsigned i)
+{
+    assert(nchunks > 0u && i < nchunks);
+    const auto q = n / nchunks, r = n % nchunks;
+    // The first r chunks have q + 1 items, the remaining ones q items.
+    const auto begin = i * q + (i < r ? i : r);
+    return std::make_pair(begin, begin + q + (i < r ? 1u : 0u));
+}
+
+// Run f(0), f(1), ..., f(n - 1) concurrently. The last invocation is run in the calling thread,
+// the others in separate threads. If any invocation throws, the exception is transported to
+// the calling thread and re-thrown after all the threads have been joined (if multiple invocations
+// throw, the exception from the invocation with the lowest index will be re-thrown).
+template <typename F>
+inline void parallel_run(unsigned n, const F &f)
+{
+    if (n <= 1u) {
+        if (n) {
+            f(0u);
+        }
+        return;
+    }
+    std::vector<std::exception_ptr> eptrs(n);
+    auto wrapper = [&f, &eptrs](unsigned i) {
+        try {
+            f(i);
+        } catch (...) {
+            eptrs[i] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(n - 1u);
+    try {
+        for (unsigned i = 0; i < n - 1u; ++i) {
+            threads.emplace_back(wrapper, i);
+        }
+    } catch (...) {
+        // LCOV_EXCL_START
+        // Thread creation failed: join the threads started so far and re-throw.
+        for (auto &t : threads) {
+            t.join();
+        }
+        throw;
+        // LCOV_EXCL_STOP
+    }
+    wrapper(n - 1u);
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (const auto &eptr : eptrs) {
+        if (eptr) {
+            std::rethrow_exception(eptr);
+        }
+    }
+}
+
+// Partition the index range [0, n) into nthreads chunks, and run f(begin, end) concurrently on each chunk.
+template <typename F>
+inline void parallel_for(unsigned nthreads, std::size_t n, const F &f)
+{
+    assert(nthreads > 0u);
+    parallel_run(nthreads, [n, nthreads, &f](unsigned i) {
+        const auto c = parallel_chunk(n, nthreads, i);
+        f(c.first, c.second);
+    });
+}
+}
+}
+
+#endif
@@ -0,0 +1,1374 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_FIXED_INTEGER_HPP
+#define MPPP_FIXED_INTEGER_HPP
+
+#include <mp++/config.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <mp++/concepts.hpp>
+#include <mp++/detail/gmp.hpp>
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/detail/utils.hpp>
+#include <mp++/exceptions.hpp>
+#include <mp++/integer.hpp>
+
+// NOTE: fixed_integer can be used in constant expressions only in C++17 (as the non-const accessors
+// of std::array are not constexpr in earlier standards), and only if we can detect constant evaluation
+// (so that the GMP-based kernels can be replaced by the pure C++ ones).
+#if MPPP_CPLUSPLUS >= 201703L && defined(MPPP_HAVE_IS_CONSTANT_EVALUATED) && !GMP_NAIL_BITS
+
+#define MPPP_HAVE_CONSTEXPR_FIXED_INTEGER
+
+#define MPPP_CONSTEXPR_FIXED_INTEGER constexpr
+
+#else
+
+#define MPPP_CONSTEXPR_FIXED_INTEGER
+
+#endif
+
+namespace mppp
+{
+
+template <std::size_t SSize>
+class fixed_integer;
+
+inline namespace detail
+{
+
+// Detect fixed_integer.
+template <typename T>
+struct is_fixed_integer : std::false_type {
+};
+
+template <std::size_t SSize>
+struct is_fixed_integer<fixed_integer<SSize>> : std::true_type {
+};
+
+// The type resulting from a binary operation involving fixed_integer. The operands can be
+// two fixed_integer with the same static size, or a fixed_integer and a C++ integral type.
+template <typename T, typename U, typename = void>
+struct fixed_integer_common_type {
+};
+
+template <std::size_t SSize>
+struct fixed_integer_common_type<fixed_integer<SSize>, fixed_integer<SSize>> {
+    using type = fixed_integer<SSize>;
+};
+
+template <std::size_t SSize, typename U>
+struct fixed_integer_common_type<fixed_integer<SSize>, U, enable_if_t<is_supported_integral<U>::value>> {
+    using type = fixed_integer<SSize>;
+};
+
+template <std::size_t SSize, typename T>
+struct fixed_integer_common_type<T, fixed_integer<SSize>, enable_if_t<is_supported_integral<T>::value>> {
+    using type = fixed_integer<SSize>;
+};
+
+template <typename T, typename U>
+using fixed_integer_common_t = typename fixed_integer_common_type<T, U>::type;
+
+// Convert an operand of a binary fixed_integer operation to fixed_integer.
+template <std::size_t SSize>
+constexpr const fixed_integer<SSize> &fixed_integer_operand(const fixed_integer<SSize> &n)
+{
+    return n;
+}
+
+template <std::size_t SSize, typename T>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> fixed_integer_operand(const T &n)
+{
+    return fixed_integer<SSize>{n};
+}
+
+// Shift an unsigned value right by GMP_NUMB_BITS, avoiding UB if the width of the type
+// is not larger than GMP_NUMB_BITS.
+template <typename U, enable_if_t<(std::numeric_limits<U>::digits > GMP_NUMB_BITS), int> = 0>
+constexpr U fixed_integer_shift_limb(U n)
+{
+    return static_cast<U>(n >> GMP_NUMB_BITS);
+}
+
+template <typename U, enable_if_t<(std::numeric_limits<U>::digits <= GMP_NUMB_BITS), int> = 0>
+constexpr U fixed_integer_shift_limb(U)
+{
+    return U(0);
+}
+
+// Absolute value of a C++ integral, as an unsigned value.
+template <typename T, enable_if_t<std::is_same<T, bool>::value, int> = 0>
+constexpr unsigned fixed_integer_uabs(T n)
+{
+    return static_cast<unsigned>(n);
+}
+
+template <typename T, enable_if_t<conjunction<negation<std::is_same<T, bool>>, std::is_unsigned<T>>::value, int> = 0>
+constexpr T fixed_integer_uabs(T n)
+{
+    return n;
+}
+
+template <typename T, enable_if_t<std::is_signed<T>::value, int> = 0>
+constexpr make_unsigned_t<T> fixed_integer_uabs(T n)
+{
+    return n >= T(0) ? static_cast<make_unsigned_t<T>>(n) : nint_abs(n);
+}
+
+// Sign test for C++ integrals.
+template <typename T, enable_if_t<std::is_signed<T>::value, int> = 0>
+constexpr bool fixed_integer_is_negative(T n)
+{
+    return n < T(0);
+}
+
+template <typename T, enable_if_t<!std::is_signed<T>::value, int> = 0>
+constexpr bool fixed_integer_is_negative(T)
+{
+    return false;
+}
+
+// Number of digits of the absolute value of n in base base.
+// NOTE: this is a plain schoolbook repeated division, which works both at runtime and in
+// constant expressions. The limbs are divided one half at a time, so that the partial
+// dividends always fit in a limb.
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_FIXED_INTEGER std::size_t fixed_integer_ndigits(const static_int<SSize> &n, int base)
+{
+    constexpr unsigned half = unsigned(GMP_NUMB_BITS) / 2u;
+    constexpr ::mp_limb_t lo_mask = (::mp_limb_t(1) << half) - 1u;
+    auto asize = static_cast<std::size_t>(n.abs_size());
+    if (!asize) {
+        return 1u;
+    }
+    std::array<::mp_limb_t, SSize> tmp{};
+    for (std::size_t i = 0; i < asize; ++i) {
+        tmp[i] = n.m_limbs[i] & GMP_NUMB_MASK;
+    }
+    const auto b = static_cast<::mp_limb_t>(base);
+    std::size_t retval = 0;
+    while (asize) {
+        ::mp_limb_t r = 0;
+        for (auto i = asize; i > 0u; --i) {
+            const auto l = tmp[i - 1u];
+            auto cur = (r << half) | (l >> half);
+            const auto q_hi = cur / b;
+            r = cur % b;
+            cur = (r << half) | (l & lo_mask);
+            const auto q_lo = cur / b;
+            r = cur % b;
+            tmp[i - 1u] = (q_hi << half) | q_lo;
+        }
+        if (!tmp[asize - 1u]) {
+            --asize;
+        }
+        ++retval;
+    }
+    return retval;
+}
+
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+
+constexpr bool fixed_integer_constant_evaluated()
+{
+    return __builtin_is_constant_evaluated();
+}
+
+// The pure C++ kernels used for fixed_integer in constant expressions. They follow the same conventions
+// of the static kernels of integer, but they always leave the unused limbs of the result zeroed.
+
+// Set the size of rop from an upper bound n on the number of limbs and the sign, stripping
+// the most significant zero limbs.
+template <std::size_t SSize>
+constexpr void fixed_integer_ce_set_size(static_int<SSize> &rop, std::size_t n, bool neg)
+{
+    while (n && !rop.m_limbs[n - 1u]) {
+        --n;
+    }
+    rop._mp_size = neg ? -static_cast<mpz_size_t>(n) : static_cast<mpz_size_t>(n);
+}
+
+// Compare the absolute values of op1 and op2.
+template <std::size_t SSize>
+constexpr int fixed_integer_ce_cmpabs(const static_int<SSize> &op1, const static_int<SSize> &op2)
+{
+    const auto asize1 = op1.abs_size(), asize2 = op2.abs_size();
+    if (asize1 != asize2) {
+        return asize1 < asize2 ? -1 : 1;
+    }
+    for (auto i = static_cast<std::size_t>(asize1); i > 0u; --i) {
+        if (op1.m_limbs[i - 1u] != op2.m_limbs[i - 1u]) {
+            return op1.m_limbs[i - 1u] < op2.m_limbs[i - 1u] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+template <std::size_t SSize>
+constexpr int fixed_integer_ce_cmp(const static_int<SSize> &op1, const static_int<SSize> &op2)
+{
+    const bool neg1 = op1._mp_size < 0, neg2 = op2._mp_size < 0;
+    if (neg1 != neg2) {
+        return neg1 ? -1 : 1;
+    }
+    const int c = fixed_integer_ce_cmpabs(op1, op2);
+    return neg1 ? -c : c;
+}
+
+// Addition/subtraction. Returns false on overflow, in which case rop is not modified.
+template <bool AddOrSub, std::size_t SSize>
+constexpr bool fixed_integer_ce_addsub(static_int<SSize> &rop, const static_int<SSize> &op1,
+                                       const static_int<SSize> &op2)
+{
+    const auto asize1 = static_cast<std::size_t>(op1.abs_size()), asize2 = static_cast<std::size_t>(op2.abs_size());
+    const bool neg1 = op1._mp_size < 0, neg2 = AddOrSub ? op2._mp_size < 0 : op2._mp_size > 0;
+    static_int<SSize> res;
+    if (neg1 == neg2) {
+        // Same sign, add the absolute values.
+        const auto n = asize1 > asize2 ? asize1 : asize2;
+        ::mp_limb_t carry = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const ::mp_limb_t l1 = i < asize1 ? op1.m_limbs[i] : 0u, l2 = i < asize2 ? op2.m_limbs[i] : 0u;
+            const ::mp_limb_t tmp = l1 + l2, sum = tmp + carry;
+            carry = ::mp_limb_t(tmp < l1) + ::mp_limb_t(sum < tmp);
+            res.m_limbs[i] = sum;
+        }
+        if (carry) {
+            if (n == SSize) {
+                return false;
+            }
+            res.m_limbs[n] = carry;
+        }
+        fixed_integer_ce_set_size(res, carry ? n + 1u : n, neg1);
+    } else {
+        // Different signs, subtract the smaller absolute value from the larger one. The result
+        // has the sign of the operand with the larger absolute value.
+        const int c = fixed_integer_ce_cmpabs(op1, op2);
+        const auto &big = c >= 0 ? op1 : op2, &small = c >= 0 ? op2 : op1;
+        const auto big_size = c >= 0 ? asize1 : asize2, small_size = c >= 0 ? asize2 : asize1;
+        ::mp_limb_t borrow = 0;
+        for (std::size_t i = 0; i < big_size; ++i) {
+            const ::mp_limb_t l1 = big.m_limbs[i], l2 = i < small_size ? small.m_limbs[i] : 0u;
+            const ::mp_limb_t tmp = l1 - l2, diff = tmp - borrow;
+            borrow = ::mp_limb_t(l1 < l2) + ::mp_limb_t(tmp < borrow);
+            res.m_limbs[i] = diff;
+        }
+        assert(!borrow);
+        fixed_integer_ce_set_size(res, big_size, c >= 0 ? neg1 : neg2);
+    }
+    rop = res;
+    return true;
+}
+
+// Full product of two limbs, computed one half-limb at a time.
+constexpr ::mp_limb_t fixed_integer_ce_mul_limb(::mp_limb_t a, ::mp_limb_t b, ::mp_limb_t &hi)
+{
+    constexpr unsigned half = unsigned(GMP_NUMB_BITS) / 2u;
+    constexpr ::mp_limb_t lo_mask = (::mp_limb_t(1) << half) - 1u;
+    const ::mp_limb_t a_lo = a & lo_mask, a_hi = a >> half, b_lo = b & lo_mask, b_hi = b >> half;
+    const ::mp_limb_t p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+    const ::mp_limb_t mid = (p0 >> half) + (p1 & lo_mask) + (p2 & lo_mask);
+    hi = p3 + (p1 >> half) + (p2 >> half) + (mid >> half);
+    return (mid << half) | (p0 & lo_mask);
+}
+
+// Multiplication. Returns false on overflow, in which case rop is not modified.
+template <std::size_t SSize>
+constexpr bool fixed_integer_ce_mul(static_int<SSize> &rop, const static_int<SSize> &op1,
+                                    const static_int<SSize> &op2)
+{
+    const auto asize1 = static_cast<std::size_t>(op1.abs_size()), asize2 = static_cast<std::size_t>(op2.abs_size());
+    if (!asize1 || !asize2) {
+        rop = static_int<SSize>{};
+        return true;
+    }
+    // The product has at least asize1 + asize2 - 1 limbs.
+    if (asize1 + asize2 - 1u > SSize) {
+        return false;
+    }
+    std::array<::mp_limb_t, SSize * 2u> prod{};
+    for (std::size_t i = 0; i < asize1; ++i) {
+        ::mp_limb_t carry = 0;
+        for (std::size_t j = 0; j < asize2; ++j) {
+            ::mp_limb_t hi = 0;
+            const ::mp_limb_t lo = fixed_integer_ce_mul_limb(op1.m_limbs[i], op2.m_limbs[j], hi);
+            const ::mp_limb_t tmp = prod[i + j] + lo, sum = tmp + carry;
+            hi += ::mp_limb_t(tmp < lo) + ::mp_limb_t(sum < tmp);
+            prod[i + j] = sum;
+            carry = hi;
+        }
+        prod[i + asize2] = carry;
+    }
+    if (asize1 + asize2 > SSize && prod[SSize]) {
+        return false;
+    }
+    static_int<SSize> res;
+    const auto n = asize1 + asize2 > SSize ? SSize : asize1 + asize2;
+    for (std::size_t i = 0; i < n; ++i) {
+        res.m_limbs[i] = prod[i];
+    }
+    fixed_integer_ce_set_size(res, n, (op1._mp_size < 0) != (op2._mp_size < 0));
+    rop = res;
+    return true;
+}
+
+// Left shift. Returns false on overflow, in which case rop is not modified.
+template <std::size_t SSize>
+constexpr bool fixed_integer_ce_mul_2exp(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s)
+{
+    const auto asize = static_cast<std::size_t>(n.abs_size());
+    if (!asize) {
+        rop = static_int<SSize>{};
+        return true;
+    }
+    const auto ls = s / unsigned(GMP_NUMB_BITS);
+    const auto rs = static_cast<unsigned>(s % unsigned(GMP_NUMB_BITS));
+    // The result has at least asize + ls limbs.
+    if (ls > SSize - asize) {
+        return false;
+    }
+    std::array<::mp_limb_t, SSize + 1u> tmp{};
+    for (std::size_t i = 0; i < asize; ++i) {
+        const auto l = n.m_limbs[i];
+        if (rs) {
+            tmp[i + ls] |= l << rs;
+            tmp[i + ls + 1u] = l >> (unsigned(GMP_NUMB_BITS) - rs);
+        } else {
+            tmp[i + ls] = l;
+        }
+    }
+    if (tmp[SSize]) {
+        return false;
+    }
+    static_int<SSize> res;
+    const auto size = asize + ls + 1u > SSize ? SSize : static_cast<std::size_t>(asize + ls + 1u);
+    for (std::size_t i = 0; i < size; ++i) {
+        res.m_limbs[i] = tmp[i];
+    }
+    fixed_integer_ce_set_size(res, size, n._mp_size < 0);
+    rop = res;
+    return true;
+}
+
+// Truncated right shift.
+template <std::size_t SSize>
+constexpr void fixed_integer_ce_tdiv_q_2exp(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s)
+{
+    const auto asize = static_cast<std::size_t>(n.abs_size());
+    const auto ls = s / unsigned(GMP_NUMB_BITS);
+    const auto rs = static_cast<unsigned>(s % unsigned(GMP_NUMB_BITS));
+    if (ls >= asize) {
+        rop = static_int<SSize>{};
+        return;
+    }
+    static_int<SSize> res;
+    for (auto i = static_cast<std::size_t>(ls); i < asize; ++i) {
+        auto l = n.m_limbs[i] >> rs;
+        if (rs && i + 1u < asize) {
+            l |= n.m_limbs[i + 1u] << (unsigned(GMP_NUMB_BITS) - rs);
+        }
+        res.m_limbs[i - ls] = l;
+    }
+    fixed_integer_ce_set_size(res, static_cast<std::size_t>(asize - ls), n._mp_size < 0);
+    rop = res;
+}
+
+#endif
+
+// NOTE: rop is reset to zero before throwing, as it might have been left in a non-canonical state
+// by the static kernels.
+template <std::size_t SSize>
+inline void fixed_integer_overflow(static_int<SSize> &rop, const char *op)
+{
+    rop = static_int<SSize>{};
+    throw std::overflow_error(std::string("Overflow in the ") + op
+                              + " of fixed_integer values: the result does not fit in " + std::to_string(SSize)
+                              + " limb(s)");
+}
+
+// NOTE: the static addition kernels may fail even if the result would fit in static storage (the mpn-based
+// implementation gives up as soon as the top bit of an operand of maximal size is set). In such case, we
+// recompute the result with GMP and check its size.
+template <bool AddOrSub, std::size_t SSize>
+inline void fixed_integer_addsub_fallback(static_int<SSize> &rop, const static_int<SSize> &op1,
+                                          const static_int<SSize> &op2)
+{
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    const auto v1 = op1.get_mpz_view(), v2 = op2.get_mpz_view();
+    if (AddOrSub) {
+        ::mpz_add(&tmp.m_mpz, &v1, &v2);
+    } else {
+        ::mpz_sub(&tmp.m_mpz, &v1, &v2);
+    }
+    const auto asize = get_mpz_size(&tmp.m_mpz);
+    if (mppp_unlikely(asize > SSize)) {
+        fixed_integer_overflow(rop, AddOrSub ? "addition" : "subtraction");
+    }
+    rop = static_int<SSize>(tmp.m_mpz._mp_size, tmp.m_mpz._mp_d, asize);
+}
+
+// Number of significant bits in a nonzero limb.
+inline MPPP_CONSTEXPR_FIXED_INTEGER unsigned fixed_integer_limb_nbits(::mp_limb_t l)
+{
+    assert(l != 0u);
+#if defined(__clang__) || defined(__GNUC__)
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+    if (!fixed_integer_constant_evaluated())
+#endif
+    {
+        // NOTE: builtin_clz() counts zeroes also in the nail bits.
+        return unsigned(std::numeric_limits<::mp_limb_t>::digits) - builtin_clz(l);
+    }
+#endif
+    unsigned retval = 0;
+    for (; l; l >>= 1) {
+        ++retval;
+    }
+    return retval;
+}
+}
+
+/// Fixed-width integer class.
+/**
+ * \rststar
+ * This class represents signed integers whose absolute value fits in ``SSize`` limbs. Differently from
+ * :cpp:class:`~mppp::integer`, a :cpp:class:`~mppp::fixed_integer` is never promoted to dynamic
+ * storage: if the result of an operation does not fit in ``SSize`` limbs, an ``std::overflow_error``
+ * exception is raised instead. The arithmetic is implemented by the same kernels used by
+ * :cpp:class:`~mppp::integer` for static values, but the storage type check performed on every operation
+ * by :cpp:class:`~mppp::integer` is avoided altogether. This class is thus suitable for computations
+ * in which the range of the values is known in advance (e.g., bounded-width cryptographic code).
+ *
+ * A :cpp:class:`~mppp::fixed_integer` can be constructed from any type from which an
+ * :cpp:class:`~mppp::integer` with the same static size can be constructed, and it can be converted
+ * back to an :cpp:class:`~mppp::integer` or to any :cpp:concept:`~mppp::CppInteroperable` type. The binary
+ * operators accept :cpp:class:`~mppp::fixed_integer` operands with the same static size and C++ integral
+ * operands.
+ *
+ * If the compiler supports C++17 and it is able to detect constant evaluation (e.g., GCC >= 9 and
+ * clang >= 9), the construction from C++ integral types, the addition, subtraction, multiplication and
+ * bit shifting functions and operators, the comparisons and the :cpp:func:`~mppp::fixed_integer::nbits()`
+ * and :cpp:func:`~mppp::fixed_integer::to_string_size()` methods can be used in constant expressions.
+ * In such case, the ``MPPP_HAVE_CONSTEXPR_FIXED_INTEGER`` macro is defined. Large constants can then
+ * be computed at compile time and converted to :cpp:class:`~mppp::integer` at runtime via a plain limb copy:
+ *
+ * .. code-block:: c++
+ *
+ *    constexpr auto p = (fixed_integer<2>{1} << 127) - 1;
+ *    static_assert(p.nbits() == 127);
+ *    static_assert(p.to_string_size() == 39);
+ *
+ * At runtime, the same functions use the GMP-based kernels.
+ *
+ * .. code-block:: c++
+ *
+ *    fixed_integer<2> a{"123456789012345678901234567890"};
+ *    a = a * 3 + 1;    // Fine, the result fits in 2 limbs.
+ *    a = a * a;        // Throws std::overflow_error.
+ * \endrststar
+ */
+template <std::size_t SSize>
+class fixed_integer
+{
+    // Make friends with the other fixed_integer functions.
+    template <std::size_t S>
+    friend MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<S> &add(fixed_integer<S> &, const fixed_integer<S> &,
+                                                            const fixed_integer<S> &);
+    template <std::size_t S>
+    friend MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<S> &sub(fixed_integer<S> &, const fixed_integer<S> &,
+                                                            const fixed_integer<S> &);
+    template <std::size_t S>
+    friend MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<S> &mul(fixed_integer<S> &, const fixed_integer<S> &,
+                                                            const fixed_integer<S> &);
+    template <std::size_t S>
+    friend void tdiv_qr(fixed_integer<S> &, fixed_integer<S> &, const fixed_integer<S> &, const fixed_integer<S> &);
+    template <std::size_t S>
+    friend MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<S> &mul_2exp(fixed_integer<S> &, const fixed_integer<S> &,
+                                                            ::mp_bitcnt_t);
+    template <std::size_t S>
+    friend MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<S> &tdiv_q_2exp(fixed_integer<S> &, const fixed_integer<S> &,
+                                                            ::mp_bitcnt_t);
+    template <std::size_t S>
+    friend MPPP_CONSTEXPR_FIXED_INTEGER int cmp(const fixed_integer<S> &, const fixed_integer<S> &);
+
+public:
+    /// Alias for the template parameter \p SSize.
+    static constexpr std::size_t ssize = SSize;
+    /// Default constructor.
+    /**
+     * The default constructor initialises \p this to zero.
+     */
+    fixed_integer() = default;
+    /// Defaulted copy constructor.
+    fixed_integer(const fixed_integer &) = default;
+    /// Defaulted move constructor.
+    fixed_integer(fixed_integer &&) = default;
+    /// Constructor from C++ integral types.
+    /**
+     * \rststar
+     * This constructor is enabled only if ``T`` is one of the C++ integral types supported by
+     * :cpp:class:`~mppp::integer`. It can be used in constant expressions.
+     * \endrststar
+     *
+     * @param n the construction argument.
+     *
+     * @throws std::overflow_error if the value of \p n does not fit in \p SSize limbs.
+     */
+    template <typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
+    MPPP_CONSTEXPR_FIXED_INTEGER explicit fixed_integer(const T &n) : m_st()
+    {
+        auto u = fixed_integer_uabs(n);
+        std::size_t size = 0;
+        while (u) {
+            if (mppp_unlikely(size == SSize)) {
+                throw std::overflow_error("The value " + std::to_string(n) + " does not fit in a fixed_integer with "
+                                          + std::to_string(SSize) + " limb(s)");
+            }
+            m_st.m_limbs[size++] = static_cast<::mp_limb_t>(u & GMP_NUMB_MASK);
+            u = fixed_integer_shift_limb(u);
+        }
+        m_st._mp_size = fixed_integer_is_negative(n) ? -static_cast<mpz_size_t>(size) : static_cast<mpz_size_t>(size);
+    }
+    /// Generic constructor.
+    /**
+     * \rststar
+     * This constructor is enabled only if ``T`` is not a C++ integral type and an :cpp:class:`~mppp::integer`
+     * with static size ``SSize`` can be constructed from ``T``. The value of ``x`` is first converted to an
+     * :cpp:class:`~mppp::integer`, and then copied into ``this``.
+     * \endrststar
+     *
+     * @param x the construction argument.
+     *
+     * @throws std::overflow_error if the value of \p x does not fit in \p SSize limbs.
+     * @throws unspecified any exception thrown by the constructor of mppp::integer.
+     */
+    template <typename T, enable_if_t<conjunction<negation<is_fixed_integer<T>>, negation<is_supported_integral<T>>,
+                                                  std::is_constructible<integer<SSize>, const T &>>::value,
+                                      int> = 0>
+    explicit fixed_integer(const T &x)
+    {
+        dispatch_ctor(integer<SSize>(x));
+    }
+    /// Constructor from \p integer.
+    /**
+     * @param n the construction argument.
+     *
+     * @throws std::overflow_error if the value of \p n does not fit in \p SSize limbs.
+     */
+    explicit fixed_integer(const integer<SSize> &n)
+    {
+        dispatch_ctor(n);
+    }
+    /// Defaulted copy assignment operator.
+    fixed_integer &operator=(const fixed_integer &) = default;
+    /// Defaulted move assignment operator.
+    fixed_integer &operator=(fixed_integer &&) = default;
+
+private:
+    void dispatch_ctor(const integer<SSize> &n)
+    {
+        if (mppp_likely(n.is_static())) {
+            m_st = n._get_union().g_st();
+            return;
+        }
+        // NOTE: a dynamic integer might still contain a value small enough.
+        const auto &dy = n._get_union().g_dy();
+        const auto asize = get_mpz_size(&dy);
+        if (mppp_unlikely(asize > SSize)) {
+            throw std::overflow_error("The value " + n.to_string() + " does not fit in a fixed_integer with "
+                                      + std::to_string(SSize) + " limb(s)");
+        }
+        m_st = static_int<SSize>(dy._mp_size, dy._mp_d, asize);
+    }
+
+public:
+    /// Conversion to \p integer.
+    /**
+     * @return an mppp::integer with the same value as \p this.
+     */
+    integer<SSize> to_integer() const
+    {
+        integer<SSize> retval;
+        retval._get_union().g_st() = m_st;
+        return retval;
+    }
+    /// Conversion operator to \p integer.
+    /**
+     * @return an mppp::integer with the same value as \p this.
+     */
+    explicit operator integer<SSize>() const
+    {
+        return to_integer();
+    }
+    /// Generic conversion operator.
+    /**
+     * \rststar
+     * This operator is enabled only if ``T`` satisfies :cpp:concept:`~mppp::CppInteroperable`. The conversion
+     * follows the same rules as the conversion operator of :cpp:class:`~mppp::integer`.
+     * \endrststar
+     *
+     * @return \p this converted to \p T.
+     *
+     * @throws std::overflow_error if \p T is an integral type and the value of \p this does not fit in \p T.
+     */
+    template <typename T, cpp_interoperable_enabler<T> = 0>
+    explicit operator T() const
+    {
+        return static_cast<T>(to_integer());
+    }
+    /// Conversion to string.
+    /**
+     * @param base the desired base.
+     *
+     * @return a string representation of \p this.
+     *
+     * @throws std::invalid_argument if \p base is smaller than 2 or greater than 62.
+     */
+    std::string to_string(int base = 10) const
+    {
+        return to_integer().to_string(base);
+    }
+    /// Sign.
+    /**
+     * @return 0 if \p this is zero, 1 if \p this is positive, -1 if \p this is negative.
+     */
+    constexpr int sgn() const
+    {
+        return m_st._mp_size ? (m_st._mp_size > 0 ? 1 : -1) : 0;
+    }
+    /// Test if the value is zero.
+    /**
+     * @return \p true if \p this is zero, \p false otherwise.
+     */
+    constexpr bool is_zero() const
+    {
+        return m_st._mp_size == 0;
+    }
+    /// Negate in-place.
+    /**
+     * @return a reference to \p this.
+     */
+    MPPP_CONSTEXPR_14 fixed_integer &neg()
+    {
+        m_st._mp_size = -m_st._mp_size;
+        return *this;
+    }
+    /// In-place absolute value.
+    /**
+     * @return a reference to \p this.
+     */
+    MPPP_CONSTEXPR_14 fixed_integer &abs()
+    {
+        if (m_st._mp_size < 0) {
+            m_st._mp_size = -m_st._mp_size;
+        }
+        return *this;
+    }
+    /// Size in limbs.
+    /**
+     * @return the number of limbs needed to represent \p this. If \p this is zero, zero will be returned.
+     */
+    constexpr std::size_t size() const
+    {
+        return static_cast<std::size_t>(m_st.abs_size());
+    }
+    /// Size in bits.
+    /**
+     * @return the number of bits needed to represent \p this. If \p this is zero, zero will be returned.
+     */
+    MPPP_CONSTEXPR_FIXED_INTEGER std::size_t nbits() const
+    {
+        const auto ls = size();
+        if (!ls) {
+            return 0u;
+        }
+        return (ls - 1u) * unsigned(GMP_NUMB_BITS) + fixed_integer_limb_nbits(m_st.m_limbs[ls - 1u] & GMP_NUMB_MASK);
+    }
+    /// Size of the string representation.
+    /**
+     * This method can be used to size buffers, or to check the size of the output of to_string() in
+     * constant expressions.
+     *
+     * @param base the desired base.
+     *
+     * @return the number of characters in the string returned by to_string() for the same \p base,
+     * including the minus sign for negative values.
+     *
+     * @throws std::invalid_argument if \p base is smaller than 2 or greater than 62.
+     */
+    MPPP_CONSTEXPR_FIXED_INTEGER std::size_t to_string_size(int base = 10) const
+    {
+        if (mppp_unlikely(base < 2 || base > 62)) {
+            throw std::invalid_argument("Invalid base for string conversion: the base must be between "
+                                        "2 and 62, but a value of "
+                                        + std::to_string(base) + " was provided instead");
+        }
+        return fixed_integer_ndigits(m_st, base) + (m_st._mp_size < 0 ? 1u : 0u);
+    }
+    /// Const reference to the internal static integer.
+    /**
+     * This method is mostly intended for internal use.
+     *
+     * @return a const reference to the internal mppp::integer static storage.
+     */
+    constexpr const static_int<SSize> &_get_static_int() const
+    {
+        return m_st;
+    }
+
+private:
+    static_int<SSize> m_st;
+};
+
+// NOTE: from C++17, static constexpr data members are implicitly inline.
+#if MPPP_CPLUSPLUS < 201703L
+
+template <std::size_t SSize>
+constexpr std::size_t fixed_integer<SSize>::ssize;
+
+#endif
+
+/** @defgroup fixed_integer_arithmetic fixed_integer_arithmetic
+ *  @{
+ */
+
+/// Ternary addition.
+/**
+ * This function will set \p rop to <tt>op1 + op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if the result does not fit in \p SSize limbs. In such case, \p rop
+ * will be set to zero.
+ */
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> &add(fixed_integer<SSize> &rop,
+                                                              const fixed_integer<SSize> &op1,
+                                                              const fixed_integer<SSize> &op2)
+{
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+    if (fixed_integer_constant_evaluated()) {
+        if (!fixed_integer_ce_addsub<true>(rop.m_st, op1.m_st, op2.m_st)) {
+            fixed_integer_overflow(rop.m_st, "addition");
+        }
+        return rop;
+    }
+#endif
+    if (mppp_unlikely(!static_addsub<true>(rop.m_st, op1.m_st, op2.m_st))) {
+        fixed_integer_addsub_fallback<true>(rop.m_st, op1.m_st, op2.m_st);
+    }
+    return rop;
+}
+
+/// Ternary subtraction.
+/**
+ * This function will set \p rop to <tt>op1 - op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if the result does not fit in \p SSize limbs. In such case, \p rop
+ * will be set to zero.
+ */
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> &sub(fixed_integer<SSize> &rop,
+                                                              const fixed_integer<SSize> &op1,
+                                                              const fixed_integer<SSize> &op2)
+{
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+    if (fixed_integer_constant_evaluated()) {
+        if (!fixed_integer_ce_addsub<false>(rop.m_st, op1.m_st, op2.m_st)) {
+            fixed_integer_overflow(rop.m_st, "subtraction");
+        }
+        return rop;
+    }
+#endif
+    if (mppp_unlikely(!static_addsub<false>(rop.m_st, op1.m_st, op2.m_st))) {
+        fixed_integer_addsub_fallback<false>(rop.m_st, op1.m_st, op2.m_st);
+    }
+    return rop;
+}
+
+/// Ternary multiplication.
+/**
+ * This function will set \p rop to <tt>op1 * op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if the result does not fit in \p SSize limbs. In such case, \p rop
+ * will be set to zero.
+ */
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> &mul(fixed_integer<SSize> &rop,
+                                                              const fixed_integer<SSize> &op1,
+                                                              const fixed_integer<SSize> &op2)
+{
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+    if (fixed_integer_constant_evaluated()) {
+        if (!fixed_integer_ce_mul(rop.m_st, op1.m_st, op2.m_st)) {
+            fixed_integer_overflow(rop.m_st, "multiplication");
+        }
+        return rop;
+    }
+#endif
+    if (mppp_unlikely(static_mul(rop.m_st, op1.m_st, op2.m_st))) {
+        fixed_integer_overflow(rop.m_st, "multiplication");
+    }
+    return rop;
+}
+
+/// Ternary truncated division.
+/**
+ * This function will set \p q to the truncated quotient of <tt>n / d</tt>, and \p r to
+ * <tt>n % d</tt>. The remainder \p r has the same sign as \p n.
+ *
+ * @param q the quotient.
+ * @param r the remainder.
+ * @param n the dividend.
+ * @param d the divisor.
+ *
+ * @throws std::invalid_argument if \p q and \p r are the same object.
+ * @throws zero_division_error if \p d is zero.
+ */
+template <std::size_t SSize>
+inline void tdiv_qr(fixed_integer<SSize> &q, fixed_integer<SSize> &r, const fixed_integer<SSize> &n,
+                    const fixed_integer<SSize> &d)
+{
+    if (mppp_unlikely(&q == &r)) {
+        throw std::invalid_argument("When performing a division with remainder, the quotient 'q' and the "
+                                    "remainder 'r' must be distinct objects");
+    }
+    if (mppp_unlikely(d.is_zero())) {
+        throw zero_division_error("Integer division by zero");
+    }
+    static_div(q.m_st, r.m_st, n.m_st, d.m_st);
+}
+
+/// Ternary left shift.
+/**
+ * This function will set \p rop to \p n multiplied by <tt>2**s</tt>.
+ *
+ * @param rop the return value.
+ * @param n the multiplicand.
+ * @param s the bit shift value.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if the result does not fit in \p SSize limbs. In such case, \p rop
+ * will be set to zero.
+ */
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> &mul_2exp(fixed_integer<SSize> &rop,
+                                                                   const fixed_integer<SSize> &n, ::mp_bitcnt_t s)
+{
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+    if (fixed_integer_constant_evaluated()) {
+        if (!fixed_integer_ce_mul_2exp(rop.m_st, n.m_st, s)) {
+            fixed_integer_overflow(rop.m_st, "left shift");
+        }
+        return rop;
+    }
+#endif
+    if (mppp_unlikely(static_mul_2exp(rop.m_st, n.m_st, safe_cast<std::size_t>(s)))) {
+        fixed_integer_overflow(rop.m_st, "left shift");
+    }
+    return rop;
+}
+
+/// Ternary right shift.
+/**
+ * This function will set \p rop to \p n divided by <tt>2**s</tt>. \p rop will be the truncated result of the
+ * division.
+ *
+ * @param rop the return value.
+ * @param n the dividend.
+ * @param s the bit shift value.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> &tdiv_q_2exp(fixed_integer<SSize> &rop,
+                                                                      const fixed_integer<SSize> &n, ::mp_bitcnt_t s)
+{
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+    if (fixed_integer_constant_evaluated()) {
+        fixed_integer_ce_tdiv_q_2exp(rop.m_st, n.m_st, s);
+        return rop;
+    }
+#endif
+    static_tdiv_q_2exp(rop.m_st, n.m_st, s);
+    return rop;
+}
+
+/// Binary negation.
+/**
+ * @param n the argument.
+ *
+ * @return <tt>-n</tt>.
+ */
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_14 fixed_integer<SSize> neg(const fixed_integer<SSize> &n)
+{
+    fixed_integer<SSize> retval{n};
+    retval.neg();
+    return retval;
+}
+
+/// Binary absolute value.
+/**
+ * @param n the argument.
+ *
+ * @return the absolute value of \p n.
+ */
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_14 fixed_integer<SSize> abs(const fixed_integer<SSize> &n)
+{
+    fixed_integer<SSize> retval{n};
+    retval.abs();
+    return retval;
+}
+
+/** @} */
+
+/** @defgroup fixed_integer_comparison fixed_integer_comparison
+ *  @{
+ */
+
+/// Comparison function.
+/**
+ * @param op1 first argument.
+ * @param op2 second argument.
+ *
+ * @return \p 0 if <tt>op1 == op2</tt>, a negative value if <tt>op1 < op2</tt>, a positive value if
+ * <tt>op1 > op2</tt>.
+ */
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_FIXED_INTEGER int cmp(const fixed_integer<SSize> &op1, const fixed_integer<SSize> &op2)
+{
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+    if (fixed_integer_constant_evaluated()) {
+        return fixed_integer_ce_cmp(op1.m_st, op2.m_st);
+    }
+#endif
+    return static_cmp(op1.m_st, op2.m_st, integer_static_cmp_algo<static_int<SSize>>{});
+}
+
+/// Sign function.
+/**
+ * @param n the argument.
+ *
+ * @return 0 if \p n is zero, 1 if \p n is positive, -1 if \p n is negative.
+ */
+template <std::size_t SSize>
+constexpr int sgn(const fixed_integer<SSize> &n)
+{
+    return n.sgn();
+}
+
+/** @} */
+
+/** @defgroup fixed_integer_io fixed_integer_io
+ *  @{
+ */
+
+/// Output stream operator.
+/**
+ * @param os the target stream.
+ * @param n the input value.
+ *
+ * @return a reference to \p os.
+ */
+template <std::size_t SSize>
+inline std::ostream &operator<<(std::ostream &os, const fixed_integer<SSize> &n)
+{
+    return os << n.to_string();
+}
+
+/** @} */
+
+/** @defgroup fixed_integer_operators fixed_integer_operators
+ *  @{
+ */
+
+/// Identity operator.
+/**
+ * @param n the argument.
+ *
+ * @return a copy of \p n.
+ */
+template <std::size_t SSize>
+constexpr fixed_integer<SSize> operator+(const fixed_integer<SSize> &n)
+{
+    return n;
+}
+
+/// Negation operator.
+/**
+ * @param n the argument.
+ *
+ * @return <tt>-n</tt>.
+ */
+template <std::size_t SSize>
+inline MPPP_CONSTEXPR_14 fixed_integer<SSize> operator-(const fixed_integer<SSize> &n)
+{
+    return neg(n);
+}
+
+// NOTE: the binary operators accept fixed_integer operands with the same static size and C++
+// integral operands. The integral operands are converted to fixed_integer before the operation.
+
+/// Binary addition operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return <tt>op1 + op2</tt>.
+ *
+ * @throws std::overflow_error if the result does not fit in the static size.
+ */
+template <typename T, typename U>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer_common_t<T, U> operator+(const T &op1, const U &op2)
+{
+    using ret_t = fixed_integer_common_t<T, U>;
+    ret_t retval;
+    add(retval, fixed_integer_operand<ret_t::ssize>(op1), fixed_integer_operand<ret_t::ssize>(op2));
+    return retval;
+}
+
+/// Binary subtraction operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return <tt>op1 - op2</tt>.
+ *
+ * @throws std::overflow_error if the result does not fit in the static size.
+ */
+template <typename T, typename U>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer_common_t<T, U> operator-(const T &op1, const U &op2)
+{
+    using ret_t = fixed_integer_common_t<T, U>;
+    ret_t retval;
+    sub(retval, fixed_integer_operand<ret_t::ssize>(op1), fixed_integer_operand<ret_t::ssize>(op2));
+    return retval;
+}
+
+/// Binary multiplication operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return <tt>op1 * op2</tt>.
+ *
+ * @throws std::overflow_error if the result does not fit in the static size.
+ */
+template <typename T, typename U>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer_common_t<T, U> operator*(const T &op1, const U &op2)
+{
+    using ret_t = fixed_integer_common_t<T, U>;
+    ret_t retval;
+    mul(retval, fixed_integer_operand<ret_t::ssize>(op1), fixed_integer_operand<ret_t::ssize>(op2));
+    return retval;
+}
+
+/// Binary division operator.
+/**
+ * @param n the dividend.
+ * @param d the divisor.
+ *
+ * @return <tt>n / d</tt>, truncated.
+ *
+ * @throws zero_division_error if \p d is zero.
+ */
+template <typename T, typename U>
+inline fixed_integer_common_t<T, U> operator/(const T &n, const U &d)
+{
+    using ret_t = fixed_integer_common_t<T, U>;
+    ret_t q, r;
+    tdiv_qr(q, r, fixed_integer_operand<ret_t::ssize>(n), fixed_integer_operand<ret_t::ssize>(d));
+    return q;
+}
+
+/// Binary modulo operator.
+/**
+ * @param n the dividend.
+ * @param d the divisor.
+ *
+ * @return <tt>n % d</tt>.
+ *
+ * @throws zero_division_error if \p d is zero.
+ */
+template <typename T, typename U>
+inline fixed_integer_common_t<T, U> operator%(const T &n, const U &d)
+{
+    using ret_t = fixed_integer_common_t<T, U>;
+    ret_t q, r;
+    tdiv_qr(q, r, fixed_integer_operand<ret_t::ssize>(n), fixed_integer_operand<ret_t::ssize>(d));
+    return r;
+}
+
+/// In-place addition operator.
+/**
+ * @param rop the augend.
+ * @param op the addend.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if the result does not fit in the static size.
+ */
+template <std::size_t SSize, typename T>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer_common_t<fixed_integer<SSize>, T> &
+operator+=(fixed_integer<SSize> &rop, const T &op)
+{
+    return add(rop, rop, fixed_integer_operand<SSize>(op));
+}
+
+/// In-place subtraction operator.
+/**
+ * @param rop the minuend.
+ * @param op the subtrahend.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if the result does not fit in the static size.
+ */
+template <std::size_t SSize, typename T>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer_common_t<fixed_integer<SSize>, T> &
+operator-=(fixed_integer<SSize> &rop, const T &op)
+{
+    return sub(rop, rop, fixed_integer_operand<SSize>(op));
+}
+
+/// In-place multiplication operator.
+/**
+ * @param rop the multiplicand.
+ * @param op the multiplier.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if the result does not fit in the static size.
+ */
+template <std::size_t SSize, typename T>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer_common_t<fixed_integer<SSize>, T> &
+operator*=(fixed_integer<SSize> &rop, const T &op)
+{
+    return mul(rop, rop, fixed_integer_operand<SSize>(op));
+}
+
+/// In-place division operator.
+/**
+ * @param rop the dividend.
+ * @param op the divisor.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws zero_division_error if \p op is zero.
+ */
+template <std::size_t SSize, typename T>
+inline fixed_integer_common_t<fixed_integer<SSize>, T> &operator/=(fixed_integer<SSize> &rop, const T &op)
+{
+    fixed_integer<SSize> r;
+    tdiv_qr(rop, r, rop, fixed_integer_operand<SSize>(op));
+    return rop;
+}
+
+/// In-place modulo operator.
+/**
+ * @param rop the dividend.
+ * @param op the divisor.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws zero_division_error if \p op is zero.
+ */
+template <std::size_t SSize, typename T>
+inline fixed_integer_common_t<fixed_integer<SSize>, T> &operator%=(fixed_integer<SSize> &rop, const T &op)
+{
+    fixed_integer<SSize> q;
+    tdiv_qr(q, rop, rop, fixed_integer_operand<SSize>(op));
+    return rop;
+}
+
+/// Binary left shift operator.
+/**
+ * @param n the multiplicand.
+ * @param s the bit shift value.
+ *
+ * @return \p n multiplied by <tt>2**s</tt>.
+ *
+ * @throws std::overflow_error if \p s is negative or the result does not fit in the static size.
+ */
+template <std::size_t SSize, typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> operator<<(const fixed_integer<SSize> &n, const T &s)
+{
+    fixed_integer<SSize> retval;
+    mul_2exp(retval, n, safe_cast<::mp_bitcnt_t>(s));
+    return retval;
+}
+
+/// In-place left shift operator.
+/**
+ * @param rop the multiplicand.
+ * @param s the bit shift value.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if \p s is negative or the result does not fit in the static size.
+ */
+template <std::size_t SSize, typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> &operator<<=(fixed_integer<SSize> &rop, const T &s)
+{
+    return mul_2exp(rop, rop, safe_cast<::mp_bitcnt_t>(s));
+}
+
+/// Binary right shift operator.
+/**
+ * @param n the dividend.
+ * @param s the bit shift value.
+ *
+ * @return \p n divided by <tt>2**s</tt>, truncated.
+ *
+ * @throws std::overflow_error if \p s is negative.
+ */
+template <std::size_t SSize, typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> operator>>(const fixed_integer<SSize> &n, const T &s)
+{
+    fixed_integer<SSize> retval;
+    tdiv_q_2exp(retval, n, safe_cast<::mp_bitcnt_t>(s));
+    return retval;
+}
+
+/// In-place right shift operator.
+/**
+ * @param rop the dividend.
+ * @param s the bit shift value.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if \p s is negative.
+ */
+template <std::size_t SSize, typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
+inline MPPP_CONSTEXPR_FIXED_INTEGER fixed_integer<SSize> &operator>>=(fixed_integer<SSize> &rop, const T &s)
+{
+    return tdiv_q_2exp(rop, rop, safe_cast<::mp_bitcnt_t>(s));
+}
+
+inline namespace detail
+{
+
+template <typename T, typename U>
+inline MPPP_CONSTEXPR_FIXED_INTEGER int fixed_integer_cmp(const T &op1, const U &op2)
+{
+    using ret_t = fixed_integer_common_t<T, U>;
+    return cmp(fixed_integer_operand<ret_t::ssize>(op1), fixed_integer_operand<ret_t::ssize>(op2));
+}
+}
+
+/// Equality operator.
+/**
+ * @param op1 first argument.
+ * @param op2 second argument.
+ *
+ * @return \p true if <tt>op1 == op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, typename = fixed_integer_common_t<T, U>>
+inline MPPP_CONSTEXPR_FIXED_INTEGER bool operator==(const T &op1, const U &op2)
+{
+    return fixed_integer_cmp(op1, op2) == 0;
+}
+
+/// Inequality operator.
+/**
+ * @param op1 first argument.
+ * @param op2 second argument.
+ *
+ * @return \p true if <tt>op1 != op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, typename = fixed_integer_common_t<T, U>>
+inline MPPP_CONSTEXPR_FIXED_INTEGER bool operator!=(const T &op1, const U &op2)
+{
+    return fixed_integer_cmp(op1, op2) != 0;
+}
+
+/// Less-than operator.
+/**
+ * @param op1 first argument.
+ * @param op2 second argument.
+ *
+ * @return \p true if <tt>op1 < op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, typename = fixed_integer_common_t<T, U>>
+inline MPPP_CONSTEXPR_FIXED_INTEGER bool operator<(const T &op1, const U &op2)
+{
+    return fixed_integer_cmp(op1, op2) < 0;
+}
+
+/// Less-than or equal operator.
+/**
+ * @param op1 first argument.
+ * @param op2 second argument.
+ *
+ * @return \p true if <tt>op1 <= op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, typename = fixed_integer_common_t<T, U>>
+inline MPPP_CONSTEXPR_FIXED_INTEGER bool operator<=(const T &op1, const U &op2)
+{
+    return fixed_integer_cmp(op1, op2) <= 0;
+}
+
+/// Greater-than operator.
+/**
+ * @param op1 first argument.
+ * @param op2 second argument.
+ *
+ * @return \p true if <tt>op1 > op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, typename = fixed_integer_common_t<T, U>>
+inline MPPP_CONSTEXPR_FIXED_INTEGER bool operator>(const T &op1, const U &op2)
+{
+    return fixed_integer_cmp(op1, op2) > 0;
+}
+
+/// Greater-than or equal operator.
+/**
+ * @param op1 first argument.
+ * @param op2 second argument.
+ *
+ * @return \p true if <tt>op1 >= op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, typename = fixed_integer_common_t<T, U>>
+inline MPPP_CONSTEXPR_FIXED_INTEGER bool operator>=(const T &op1, const U &op2)
+{
+    return fixed_integer_cmp(op1, op2) >= 0;
+}
+
+/** @} */
+}
+
+#endif
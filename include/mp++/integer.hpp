@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
@@ -21,7 +22,9 @@
 #include <functional>
 #include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <mutex>
 #include <new>
 #include <stdexcept>
 #include <string>
@@ -73,11 +76,54 @@
 
 #endif
 
+// The 128-bit integral types can be used for construction, conversion and in the operators
+// of integer, if the limb is 64 bits wide.
+#if defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
+
+#define MPPP_INT128 __int128_t
+
+#define MPPP_HAVE_INT128_INTEROP
+
+// The Montgomery arithmetic classes on limbs (limb_mont and dlimb_mont) are available.
+#define MPPP_HAVE_LIMB_MONT
+
+#endif
+
 namespace mppp
 {
 
 inline namespace detail
 {
+
+// Detect the 128-bit integral types.
+template <typename T>
+struct is_integer_int128 : std::false_type {
+};
+
+#if defined(MPPP_HAVE_INT128_INTEROP)
+
+template <>
+struct is_integer_int128<MPPP_INT128> : std::true_type {
+};
+
+template <>
+struct is_integer_int128<MPPP_UINT128> : std::true_type {
+};
+
+// Unsigned integral type with twice the width of a limb. Unlike MPPP_UINT128, it remains
+// available in the other headers of the library.
+using dlimb_t = MPPP_UINT128;
+
+#endif
+
+// The integral and interoperable types which can be used in the operators of integer. Differently
+// from is_supported_integral and is_cpp_interoperable, they include the 128-bit integral types.
+template <typename T>
+using is_integer_op_integral = disjunction<is_supported_integral<T>, is_integer_int128<T>>;
+
+template <typename T>
+using is_integer_op_interoperable = disjunction<is_cpp_interoperable<T>, is_integer_int128<T>>;
+
 // Some misc tests to check that the mpz struct conforms to our expectations.
 // This is crucial for the implementation of the union integer type.
 struct expected_mpz_struct_t {
@@ -239,6 +285,26 @@ inline void mpz_init_set_nlimbs(mpz_struct_t &m0, const mpz_struct_t &m1)
     ::mpz_set(&m0, &m1);
 }
 
+// Make sure that m can hold at least nlimbs limbs. The storage is grown geometrically (it is at least doubled),
+// so that a sequence of operations whose results grow a limb at a time (e.g., an accumulation) triggers only a
+// logarithmic number of reallocations. GMP, on the other hand, reallocates to the exact size needed by
+// each operation.
+inline void mpz_grow_nlimbs(mpz_struct_t &m, std::size_t nlimbs)
+{
+    const auto alloc = static_cast<std::size_t>(m._mp_alloc);
+    if (nlimbs <= alloc) {
+        return;
+    }
+    const auto new_alloc = std::max(nlimbs, alloc * 2u);
+    // LCOV_EXCL_START
+    if (mppp_unlikely(new_alloc > std::numeric_limits<::mp_bitcnt_t>::max() / unsigned(GMP_NUMB_BITS))) {
+        // Leave it to GMP to deal with huge sizes.
+        return;
+    }
+    // LCOV_EXCL_STOP
+    ::mpz_realloc2(&m, static_cast<::mp_bitcnt_t>(new_alloc * unsigned(GMP_NUMB_BITS)));
+}
+
 // Convert an mpz to a string in a specific base, to be written into out.
 inline void mpz_to_str(std::vector<char> &out, const mpz_struct_t *mpz, int base = 10)
 {
@@ -331,6 +397,29 @@ inline unsigned builtin_clz(T n)
     return static_cast<unsigned>(builtin_clz_impl(n));
 }
 
+// Same for the number of trailing zeroes.
+inline int builtin_ctz_impl(unsigned n)
+{
+    return __builtin_ctz(n);
+}
+
+inline int builtin_ctz_impl(unsigned long n)
+{
+    return __builtin_ctzl(n);
+}
+
+inline int builtin_ctz_impl(unsigned long long n)
+{
+    return __builtin_ctzll(n);
+}
+
+template <typename T>
+inline unsigned builtin_ctz(T n)
+{
+    assert(n != 0u);
+    return static_cast<unsigned>(builtin_ctz_impl(n));
+}
+
 #endif
 
 // The static integer class.
@@ -360,21 +449,21 @@ struct static_int {
     // also some equivalent bits in rational) we zero regardless, but in zero_unused_limbs() we check
     // about opt_size. Let's leave this discussion for when we optimize the mpn_ implementations
     // (if ever).
-    static_int() : _mp_size(0), m_limbs() {}
+    // NOTE: the constructors, the assignment operators and the implicit (trivial) destructor are constexpr-friendly,
+    // so that static_int is a literal type. This allows to use fixed_integer in constant expressions.
+    constexpr static_int() : _mp_size(0), m_limbs() {}
     // Let's avoid copying the _mp_alloc member, as it is never written to and it must always
     // have the same value.
-    static_int(const static_int &other) : _mp_size(other._mp_size), m_limbs(other.m_limbs) {}
-    static_int(static_int &&other) noexcept : static_int(other) {}
+    constexpr static_int(const static_int &other) : _mp_size(other._mp_size), m_limbs(other.m_limbs) {}
+    constexpr static_int(static_int &&other) noexcept : static_int(other) {}
     // These 2 constructors are used in the generic constructor of integer_union.
     //
     // Constructor from a size and a single limb (will be the least significant limb).
-    explicit static_int(mpz_size_t size, ::mp_limb_t l) : _mp_size(size)
+    // NOTE: the remaining limbs are zeroed by the aggregate initialisation of m_limbs.
+    explicit MPPP_CONSTEXPR_14 static_int(mpz_size_t size, ::mp_limb_t l) : _mp_size(size), m_limbs{{l}}
     {
         // Input sanity checks.
         assert(size <= s_size && size >= -s_size);
-        m_limbs[0] = l;
-        // Zero fill the remaining limbs.
-        std::fill(m_limbs.begin() + 1, m_limbs.end(), ::mp_limb_t(0));
     }
     // Constructor from a (signed) size and a limb range. The limbs in the range will be
     // copied as the least significant limbs.
@@ -391,14 +480,14 @@ struct static_int {
         // Zero the remaining limbs, if any.
         std::fill(m_limbs.begin() + asize, m_limbs.end(), ::mp_limb_t(0));
     }
-    static_int &operator=(const static_int &other)
+    MPPP_CONSTEXPR_14 static_int &operator=(const static_int &other)
     {
         _mp_size = other._mp_size;
         // NOTE: self assignment of std::array should be fine.
         m_limbs = other.m_limbs;
         return *this;
     }
-    static_int &operator=(static_int &&other) noexcept
+    MPPP_CONSTEXPR_14 static_int &operator=(static_int &&other) noexcept
     {
         // Just forward to the copy assignment.
         return operator=(other);
@@ -431,10 +520,6 @@ struct static_int {
         return true;
         // LCOV_EXCL_STOP
     }
-    ~static_int()
-    {
-        assert(dtor_checks());
-    }
     // Zero the limbs that are not used for representing the value.
     // This is normally not needed, but it is useful when using the GMP mpn api on a static int:
     // the GMP api does not clear unused limbs, but we rely on unused limbs being zero when optimizing operations
@@ -450,7 +535,7 @@ struct static_int {
         }
     }
     // Size in limbs (absolute value of the _mp_size member).
-    mpz_size_t abs_size() const
+    constexpr mpz_size_t abs_size() const
     {
         return _mp_size >= 0 ? _mp_size : -_mp_size;
     }
@@ -526,8 +611,9 @@ union integer_union {
             // the promotion below triggers an assertion failure when destroying
             // the static int in debug mode.
             g_st().m_limbs[SSize - 1u] = 1u;
-            // There's no space for the extra limb. Promote the integer and move on.
-            promote(SSize + 1u);
+            // There's no space for the extra limb. Promote the integer and move on. The capacity
+            // is doubled, so that the following limbs do not trigger a reallocation.
+            promote(SSize * 2u);
             // Recover the upper limb.
             g_dy()._mp_d[SSize - 1u] = limb_copy;
         }
@@ -563,6 +649,35 @@ union integer_union {
     {
         assert(false);
     }
+#if defined(MPPP_HAVE_INT128_INTEROP)
+    // Construction from the 128-bit integral types. The (at most) two limbs are written directly.
+    void dispatch_int128_ctor(MPPP_UINT128 n, bool neg)
+    {
+        const auto lo = static_cast<::mp_limb_t>(n), hi = static_cast<::mp_limb_t>(n >> 64);
+        const auto asize = static_cast<mpz_size_t>(hi ? 2 : (lo ? 1 : 0));
+        if (SSize > 1u || !hi) {
+            const ::mp_limb_t limbs[] = {lo, hi};
+            ::new (static_cast<void *>(&m_st)) s_storage{neg ? -asize : asize, limbs, static_cast<std::size_t>(asize)};
+        } else {
+            ::new (static_cast<void *>(&m_dy)) d_storage;
+            mpz_init_nlimbs(m_dy, 2u);
+            m_dy._mp_d[0] = lo;
+            m_dy._mp_d[1] = hi;
+            m_dy._mp_size = neg ? -asize : asize;
+        }
+    }
+    void dispatch_generic_ctor(MPPP_UINT128 n)
+    {
+        dispatch_int128_ctor(n, false);
+    }
+    void dispatch_generic_ctor(MPPP_INT128 n)
+    {
+        // NOTE: the conversion to unsigned is modular, thus negating the unsigned counterpart
+        // of a negative n yields its absolute value.
+        const auto un = static_cast<MPPP_UINT128>(n);
+        dispatch_int128_ctor(n < 0 ? -un : un, n < 0);
+    }
+#endif
     // Special casing for bool.
     void dispatch_generic_ctor(bool b)
     {
@@ -612,16 +727,75 @@ union integer_union {
         }
     }
     // Construction from float/double.
+    // NOTE: we decompose the floating-point value as m * 2**e (via frexp()), extract the significand
+    // as an exact unsigned integer and then write it, truncated or shifted as needed, directly
+    // into the limbs. This avoids the mpz temporary and the conversion overhead of mpz_set_d().
     template <typename T, enable_if_t<disjunction<std::is_same<T, float>, std::is_same<T, double>>::value, int> = 0>
     void dispatch_generic_ctor(T x)
     {
+        // NOTE: float values are converted exactly to double, so we can work in double precision
+        // regardless of T. The significand of a double must fit in an unsigned long long.
+        using uint_t = unsigned long long;
+        constexpr int sig_digits = std::numeric_limits<double>::digits;
+        static_assert(std::numeric_limits<double>::radix == 2 && sig_digits > 0
+                          && sig_digits <= std::numeric_limits<uint_t>::digits,
+                      "Unsupported floating-point representation.");
         if (mppp_unlikely(!std::isfinite(x))) {
             throw std::domain_error("Cannot construct an integer from the non-finite floating-point value "
                                     + std::to_string(x));
         }
-        MPPP_MAYBE_TLS mpz_raii tmp;
-        ::mpz_set_d(&tmp.m_mpz, static_cast<double>(x));
-        dispatch_mpz_ctor(&tmp.m_mpz);
+        int exp;
+        const double m = std::frexp(static_cast<double>(x), &exp);
+        if (exp <= 0) {
+            // |x| < 1 (this includes zero), truncation yields zero.
+            ::new (static_cast<void *>(&m_st)) s_storage();
+            return;
+        }
+        // The absolute value of the significand as an exact integer: |x| = sig * 2**(exp - sig_digits).
+        auto sig = static_cast<uint_t>(std::ldexp(std::abs(m), sig_digits));
+        assert(sig != 0u);
+        // The bit index at which the least significant bit of sig will be written.
+        std::size_t bit_idx = 0;
+        if (exp < sig_digits) {
+            // Truncate the fractional bits.
+            sig >>= unsigned(sig_digits - exp);
+        } else {
+            bit_idx = static_cast<std::size_t>(exp - sig_digits);
+        }
+        // The result has exactly exp bits.
+        const auto nlimbs = (static_cast<std::size_t>(exp) - 1u) / unsigned(GMP_NUMB_BITS) + 1u;
+        ::mp_limb_t *data;
+        if (nlimbs <= SSize) {
+            // NOTE: the default ctor zeroes all the limbs.
+            ::new (static_cast<void *>(&m_st)) s_storage();
+            data = m_st.m_limbs.data();
+        } else {
+            ::new (static_cast<void *>(&m_dy)) d_storage;
+            mpz_init_nlimbs(m_dy, nlimbs);
+            data = m_dy._mp_d;
+            std::fill(data, data + nlimbs, ::mp_limb_t(0));
+        }
+        // Write the significand into the limbs, GMP_NUMB_BITS at a time.
+        while (true) {
+            const auto idx = bit_idx / unsigned(GMP_NUMB_BITS);
+            const auto offset = static_cast<unsigned>(bit_idx % unsigned(GMP_NUMB_BITS));
+            assert(idx < nlimbs);
+            data[idx] = static_cast<::mp_limb_t>(static_cast<::mp_limb_t>(sig << offset) & GMP_NUMB_MASK);
+            // Number of bits of sig which have been written in the current limb.
+            const auto nwritten = unsigned(GMP_NUMB_BITS) - offset;
+            if (nwritten >= unsigned(std::numeric_limits<uint_t>::digits) || !(sig >>= nwritten)) {
+                break;
+            }
+            bit_idx += nwritten;
+        }
+        assert(data[nlimbs - 1u] & GMP_NUMB_MASK);
+        // NOTE: nlimbs is tiny (at most a few tens of limbs), no overflow is possible here.
+        const auto size = x > T(0) ? static_cast<mpz_size_t>(nlimbs) : -static_cast<mpz_size_t>(nlimbs);
+        if (is_static()) {
+            g_st()._mp_size = size;
+        } else {
+            g_dy()._mp_size = size;
+        }
     }
 #if defined(MPPP_WITH_MPFR)
     // Construction from long double, requires MPFR.
@@ -773,6 +947,8 @@ union integer_union {
     ~integer_union()
     {
         if (is_static()) {
+            // NOTE: the destructor of static_int is trivial, run the sanity checks here.
+            assert(g_st().dtor_checks());
             g_st().~s_storage();
         } else {
             destroy_dynamic();
@@ -840,6 +1016,17 @@ union integer_union {
         ::new (static_cast<void *>(&m_dy)) d_storage;
         m_dy = tmp_mpz;
     }
+    // Make sure that this is dynamic and that it can hold at least nlimbs limbs, in preparation for writing
+    // the result of an arithmetic operation. The storage is grown geometrically: the promotion from static
+    // storage allocates at least twice the static size, and dynamic storage is grown via mpz_grow_nlimbs().
+    void grow(std::size_t nlimbs)
+    {
+        if (is_static()) {
+            promote(std::max(nlimbs, SSize * 2u));
+        } else {
+            mpz_grow_nlimbs(g_dy(), nlimbs);
+        }
+    }
     // Demotion from dynamic to static.
     bool demote()
     {
@@ -873,1747 +1060,4098 @@ union integer_union {
     s_storage m_st;
     d_storage m_dy;
 };
-}
 
-// Fwd declaration.
-template <std::size_t SSize>
-integer<SSize> &sqrt(integer<SSize> &, const integer<SSize> &);
+// Modular arithmetic on single limbs. In all the functions below, the modulus m must be nonzero
+// and the operands must be already reduced modulo m.
+inline ::mp_limb_t limb_addmod(::mp_limb_t a, ::mp_limb_t b, ::mp_limb_t m)
+{
+    assert(a < m && b < m);
+    // NOTE: compute the result without overflowing, via the complement of b.
+    const auto bc = m - b;
+    return a >= bc ? a - bc : a + b;
+}
 
-// NOTE: a few misc things:
-// - re-visit at one point the issue of the estimators when we need to promote from static to dynamic
-//   in arithmetic ops. Currently they are not 100% optimal since they rely on the information coming out
-//   of the static implementation rather than computing the estimated size of rop themselves, for performance
-//   reasons (see comments);
-// - maybe the lshift/rshift optimisation for 2 limbs could use dlimb types if available?
-// - it seems like it might be possible to re-implement a bare-bone mpz api on top of the mpn primitives,
-//   with the goal of providing some form of error recovery in case of memory errors (e.g., throw instead
-//   of aborting). This is probably not an immediate concern though.
-// - pow() can probably benefit for some specialised static implementation, especially in conjunction with
-//   mpn_sqr().
-// - gcd() can be improved (see notes).
-// - functions still to be de-branched: all the mpn implementations, if worth it.
-//   Probably better to wait for benchmarks before moving.
-// - performance improvements for the assignment operators to integrals, at least (maybe floats as well?): avoid
-//   cting temporary.
-// - performance improvements for arithmetic with C++ integrals? (e.g., use add_ui() and similar rather than cting
-//   temporary).
+inline ::mp_limb_t limb_submod(::mp_limb_t a, ::mp_limb_t b, ::mp_limb_t m)
+{
+    assert(a < m && b < m);
+    return a >= b ? a - b : a + (m - b);
+}
 
-/// Multiprecision integer class.
-/**
- * \rststar
- * This class represents arbitrary-precision signed integers. It acts as a wrapper around the GMP ``mpz_t`` type, with
- * a small value optimisation: integers whose size is up to ``SSize`` limbs are stored directly in the storage
- * occupied by the :cpp:class:`~mppp::integer` object, without resorting to dynamic memory allocation. The value of
- * ``SSize`` must be at least 1 and less than an implementation-defined upper limit. On most modern architectures,
- * a limb contains either 32 or 64 bits of data. Thus, for instance, is ``SSize`` is set to 2 on a 64-bit system,
- * the small value optimisation will be employed for all integral values less than :math:`2^{64 \times 2} = 2^{128}`.
- *
- * When the value of an :cpp:class:`~mppp::integer` is stored directly within the object, the *storage type* of the
- * integer is said to be *static*. When the limb size of the integer exceeds the maximum value ``SSize``, the storage
- * type becomes *dynamic*. The transition from static to dynamic storage happens transparently whenever the integer
- * value becomes large enough. The demotion from dynamic to static storage usually needs to be requested explicitly.
- * For values of ``SSize`` of 1 and 2, optimised implementations of basic arithmetic operations are employed,
- * if supported by the target architecture and if the storage type is static. For larger values of ``SSize``,
- * the ``mpn_`` low-level functions of the GMP API are used if the storage type is static. If the storage type is
- * dynamic, the usual ``mpz_`` functions from the GMP API are used.
- *
- * This class has the look and feel of a C++ builtin type: it can interact with most of C++'s integral and
- * floating-point primitive types (see the :cpp:concept:`~mppp::CppInteroperable` concept for the full list),
- * and it provides overloaded :ref:`operators <integer_operators>`. Differently from the builtin types,
- * however, this class does not allow any implicit conversion to/from other types (apart from ``bool``): construction
- * from and conversion to primitive types must always be requested explicitly. As a side effect, syntax such as
- *
- * .. code-block:: c++
- *
- *    integer<1> n = 5;
- *    int m = n;
- *
- * will not work, and direct initialization and explicit casting should be used instead:
- *
- * .. code-block:: c++
- *
- *    integer<1> n{5};
- *    int m = static_cast<int>(n);
- *
- * Most of the functionality is exposed via plain :ref:`functions <integer_functions>`, with the
- * general convention that the functions are named after the corresponding GMP functions minus the leading ``mpz_``
- * prefix. For instance, the GMP call
- *
- * .. code-block:: c++
- *
- *    mpz_add(rop,a,b);
- *
- * that writes the result of ``a + b`` into ``rop`` becomes simply
- *
- * .. code-block:: c++
- *
- *    add(rop,a,b);
- *
- * where the ``add()`` function is resolved via argument-dependent lookup. Function calls with overlapping arguments
- * are allowed, unless noted otherwise.
- *
- * Multiple overloads of the same functionality are often available.
- * Binary functions in GMP are usually implemented via three-arguments functions, in which the first
- * argument is a reference to the return value. The exponentiation function ``mpz_pow_ui()``, for instance,
- * takes three arguments: the return value, the base and the exponent. There are two overloads of the corresponding
- * :ref:`exponentiation <integer_exponentiation>` function:
- *
- * * a ternary overload semantically equivalent to ``mpz_pow_ui()``,
- * * a binary overload taking as inputs the base and the exponent, and returning the result
- *   of the exponentiation.
- *
- * This allows to avoid having to set up a return value for one-off invocations of ``pow_ui()`` (the binary overload
- * will do it for you). For example:
- *
- * .. code-block:: c++
- *
- *    integer<1> r1, r2, n{3};
- *    pow_ui(r1,n,2);   // Ternary pow_ui(): computes n**2 and stores
- *                      // the result in r1.
- *    r2 = pow_ui(n,2); // Binary pow_ui(): returns n**2, which is then
- *                      // assigned to r2.
- *
- * In case of unary functions, there are often three overloads available:
- *
- * * a binary overload taking as first parameter a reference to the return value (GMP style),
- * * a unary overload returning the result of the operation,
- * * a nullary member function that modifies the calling object in-place.
- *
- * For instance, here are three possible ways of computing the absolute value:
- *
- * .. code-block:: c++
- *
- *    integer<1> r1, r2, n{-5};
- *    abs(r1,n);   // Binary abs(): computes and stores the absolute value
- *                 // of n into r1.
- *    r2 = abs(n); // Unary abs(): returns the absolute value of n, which is
- *                 // then assigned to r2.
- *    n.abs();     // Member function abs(): replaces the value of n with its
- *                 // absolute value.
- *
- * Note that at this time only a small subset of the GMP API has been wrapped by :cpp:class:`~mppp::integer`.
- *
- * Various :ref:`overloaded operators <integer_operators>` are provided.
- * For the common arithmetic operations (``+``, ``-``, ``*`` and ``/``), the type promotion
- * rules are a natural extension of the corresponding rules for native C++ types: if the other argument
- * is a C++ integral, the result will be of type :cpp:class:`~mppp::integer`, if the other argument is a C++
- * floating-point the result will be of the same floating-point type. For example:
- *
- * .. code-block:: c++
- *
- *    integer<1> n1{1}, n2{2};
- *    auto res1 = n1 + n2; // res1 is an integer
- *    auto res2 = n1 * 2; // res2 is an integer
- *    auto res3 = 2 - n2; // res3 is an integer
- *    auto res4 = n1 / 2.f; // res4 is a float
- *    auto res5 = 12. / n1; // res5 is a double
- *
- * The modulo operator ``%`` accepts only :cpp:class:`~mppp::integer` and :cpp:concept:`~mppp::CppInteroperable`
- * integral types as arguments,
- * and it always returns :cpp:class:`~mppp::integer` as result. The bit shifting operators ``<<`` and ``>>`` accept
- * only :cpp:concept:`~mppp::CppInteroperable` integral types as shift arguments, and they always return
- * :cpp:class:`~mppp::integer` as result.
- *
- * The relational operators, ``==``, ``!=``, ``<``, ``>``, ``<=`` and ``>=`` will promote the arguments to a common type
- * before comparing them. The promotion rules are the same as in the arithmetic operators (that is, both arguments are
- * promoted to :cpp:class:`~mppp::integer` if they are both integral types, otherwise they are promoted to the type
- * of the floating-point argument).
- *
- * Several facilities for interfacing with the GMP library are provided. Specifically, :cpp:class:`~mppp::integer`
- * features:
- *
- * * a constructor and an assignment operator from the GMP integer type ``mpz_t``,
- * * a :cpp:func:`~mppp::integer::get_mpz_t()` method that promotes ``this`` to dynamic
- *   storage and returns a pointer to the internal ``mpz_t`` instance,
- * * an ``mpz_view`` class, an instance of which can be requested via the :cpp:func:`~mppp::integer::get_mpz_view()`
- *   method, which allows to use :cpp:class:`~mppp::integer` in the GMP API as a drop-in replacement for
- *   ``const mpz_t`` function arguments.
- *
- * The ``mpz_view`` class represent a read-only view of an integer object which is implicitly convertible to the type
- * ``const mpz_t`` and which is thus usable as an argument to GMP functions. For example:
- *
- * .. code-block:: c++
- *
- *    mpz_t m;
- *    mpz_init_set_si(m,1); // Create an mpz_t with the value 1.
- *    integer<1> n{1}; // Initialize an integer with the value 1.
- *    mpz_add(m,m,n.get_mpz_view()); // Compute the result of n + m and store
- *                                   // it in m using the GMP API.
- *
- * See the documentation of :cpp:func:`~mppp::integer::get_mpz_view()` for more details about the ``mpz_view`` class.
- * Via the GMP interfacing facilities, it is thus possible to use directly the GMP C API with
- * :cpp:class:`~mppp::integer` objects whenever necessary (e.g., if a GMP function has not been wrapped yet by mp++).
- * \endrststar
- */
-template <std::size_t SSize>
-class integer
+#if defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
+inline ::mp_limb_t limb_mulmod(::mp_limb_t a, ::mp_limb_t b, ::mp_limb_t m)
 {
-    // Typedefs for ease of use.
-    using s_storage = static_int<SSize>;
-    using d_storage = mpz_struct_t;
-    // The underlying static int.
-    using s_int = s_storage;
-    // mpz view class.
-    // NOTE: this class looks more complicated than it seemingly should be - it looks like
-    // it should be enough to shallow-copy around an mpz_struct_t with the limbs pointing
-    // either to a static integer or a dynamic one. This option, however, has a problem:
-    // in case of a dynamic integer, one can get 2 different mpz_struct_t instances, one
-    // via m_int.g_dy(), the other via the view class, which internally point to the same
-    // limbs vector. Having 2 *distinct* mpz_t point to the same limbs vector is not
-    // something which is supported by the GMP API, at least when one mpz_t is being written into.
-    // This happens for instance when using arithmetic functions
-    // in which the return object is the same as one of the operands (GMP supports aliasing
-    // if multiple mpz_t are the same object, but in this case they are distinct objects.)
-    //
-    // In the current implementation, mixing dynamic views with mpz_t objects in the GMP
-    // API is fine, as dynamic views point to unique mpz_t objects within the integers.
-    // We still however have potential for aliasing when using the static views: these
-    // do not point to "real" mpz_t objects, they are mpz_t objects internally pointing
-    // to the limbs of static integers. So, for instance, in an add() operation with
-    // rop dynamic, and op1 and op2 statics and the same object, we create two separate
-    // static views pointing to the same limbs internally, and feed them to the GMP API.
-    //
-    // This seems to work however: the data in the static views is strictly read-only and
-    // it cannot be modified by a modification to a rop, as this needs to be a real mpz_t
-    // in order to be used in the GMP API (views are convertible to const mpz_t only,
-    // not mutable mpz_t). That is, static views and rops can only point to distinct
-    // limbs vectors.
-    //
-    // The bottom line is that, in practice, the GMP API does not seem to be bothered by the fact
-    // that const arguments might overlap behind its back. If this ever becomes a problem,
-    // we can consider a "true" static view which does not simply point to an existing
-    // static integer but actually copies it as a data member.
-    struct mpz_view {
-        explicit mpz_view(const integer &n)
-            // NOTE: explicitly initialize mpz_struct_t() in order to avoid reading from
-            // uninited memory in the move constructor, in case of a dynamic view.
-            : m_static_view(n.is_static() ? n.m_int.g_st().get_mpz_view() : mpz_struct_t()),
-              m_ptr(n.is_static() ? &m_static_view : &(n.m_int.g_dy()))
-        {
-        }
-        mpz_view(const mpz_view &) = delete;
-        mpz_view(mpz_view &&other)
-            : m_static_view(other.m_static_view),
-              // NOTE: we need to re-init ptr here if other is a static view, because in that case
-              // other.m_ptr will be pointing to an mpz_struct_t in other and we want it to point to
-              // the struct in this now.
-              m_ptr((other.m_ptr == &other.m_static_view) ? &m_static_view : other.m_ptr)
-        {
-        }
-        mpz_view &operator=(const mpz_view &) = delete;
-        mpz_view &operator=(mpz_view &&) = delete;
-        operator const mpz_struct_t *() const
-        {
-            return get();
-        }
-        const mpz_struct_t *get() const
-        {
-            return m_ptr;
+    assert(a < m && b < m);
+    using dlimb_t = MPPP_UINT128;
+    return static_cast<::mp_limb_t>(dlimb_t(a) * b % m);
+}
+#else
+inline ::mp_limb_t limb_mulmod(::mp_limb_t a, ::mp_limb_t b, ::mp_limb_t m)
+{
+    assert(a < m && b < m);
+    std::array<::mp_limb_t, 2> prod;
+    prod[1] = ::mpn_mul_1(prod.data(), &a, 1, b);
+    return ::mpn_mod_1(prod.data(), prod[1] ? 2 : 1, m);
+}
+#endif
+
+// Modular exponentiation via square-and-multiply.
+template <typename T>
+inline ::mp_limb_t limb_powmod(::mp_limb_t base, T exp, ::mp_limb_t m)
+{
+    static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "Invalid type.");
+    ::mp_limb_t retval = m == 1u ? 0u : 1u;
+    for (; exp; exp >>= 1) {
+        if (exp & 1u) {
+            retval = limb_mulmod(retval, base, m);
         }
-        mpz_struct_t m_static_view;
-        const mpz_struct_t *m_ptr;
-    };
-    // Make friends with rational.
-    template <std::size_t>
-    friend class rational;
+        base = limb_mulmod(base, base, m);
+    }
+    return retval;
+}
+
+// Modular inverse via the extended Euclidean algorithm. Requires a and m to be coprime.
+inline ::mp_limb_t limb_invmod(::mp_limb_t a, ::mp_limb_t m)
+{
+    assert(a < m && m > 1u);
+    // NOTE: the Bezout coefficients are kept reduced modulo m, so that
+    // we can work with unsigned values.
+    ::mp_limb_t r0 = m, r1 = a, t0 = 0, t1 = 1;
+    while (r1) {
+        const auto q = r0 / r1, r2 = r0 - q * r1;
+        const auto t2 = limb_submod(t0, limb_mulmod(q % m, t1, m), m);
+        r0 = r1;
+        r1 = r2;
+        t0 = t1;
+        t1 = t2;
+    }
+    assert(r0 == 1u);
+    return t0;
+}
+
+// Quadratic residue filter for the perfect square tests: lo is the least significant limb
+// of a nonnegative value, r its remainder modulo 21483 = 63 * 31 * 11. Returns false if the value
+// is certainly not a square. Only about 1% of the non-squares pass the filter.
+inline bool limb_square_filter(::mp_limb_t lo, ::mp_limb_t r)
+{
+    // Bitmasks of the quadratic residues modulo 64, 63, 31 and 11.
+    return ((0x202021202030213ull >> (lo & 63u)) & 1u) && ((0x402483012450293ull >> (r % 63u)) & 1u)
+           && ((0x121d47b7ull >> (r % 31u)) & 1u) && ((0x23bull >> (r % 11u)) & 1u);
+}
+
+#if defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
+
+// Montgomery arithmetic modulo an odd single-limb modulus n, with R = 2**64. The elements
+// are kept in Montgomery form (that is, a is represented as a * R mod n), in the [0, n) range.
+class limb_mont
+{
+    using dlimb_t = MPPP_UINT128;
 
 public:
-    /// Alias for the template parameter \p SSize.
-    static constexpr std::size_t ssize = SSize;
-    /// Default constructor.
-    /**
-     * The default constructor initialises an integer with static storage type and value 0.
-     */
-    integer() = default;
-    /// Copy constructor.
-    /**
-     * The copy constructor deep-copies \p other into \p this, copying the original storage type as well.
-     *
-     * @param other the object that will be copied into \p this.
-     */
-    integer(const integer &other) = default;
-    /// Move constructor.
-    /**
-     * The move constructor will leave \p other in an unspecified but valid state. The storage type
-     * of \p this will be the same as <tt>other</tt>'s.
-     *
-     * @param other the object that will be moved into \p this.
-     */
-    integer(integer &&other) = default;
-/// Generic constructor.
-/**
- * This constructor will initialize an integer with the value of \p x. The initialization is always
- * successful if \p x is an integral value (construction from \p bool yields 1 for \p true, 0 for \p false).
- * If \p x is a floating-point value, the construction will fail if \p x is not finite. Construction from a
- * floating-point type yields the truncated counterpart of the input value.
- *
- * @param x value that will be used to initialize \p this.
- *
- * @throws std::domain_error if \p x is a non-finite floating-point value.
- */
-#if defined(MPPP_HAVE_CONCEPTS)
-    explicit integer(const CppInteroperable &x)
-#else
-    template <typename T, cpp_interoperable_enabler<T> = 0>
-    explicit integer(const T &x)
-#endif
-        : m_int(x)
+    explicit limb_mont(::mp_limb_t n) : m_n(n)
+    {
+        assert(n & 1u);
+        // Inverse of n modulo 2**64 via Newton's iteration. The initial value is correct
+        // to 3 bits (n * n == 1 mod 8 for odd n), each iteration doubles the number of correct bits.
+        ::mp_limb_t inv = n;
+        for (int i = 0; i < 5; ++i) {
+            inv *= 2u - n * inv;
+        }
+        assert(n * inv == 1u);
+        m_ninv = inv;
+        // R mod n and R**2 mod n.
+        m_one = static_cast<::mp_limb_t>(0u - n) % n;
+        m_r2 = static_cast<::mp_limb_t>(dlimb_t(m_one) * m_one % n);
+    }
+    // Montgomery reduction of t < n * R: returns t / R mod n.
+    ::mp_limb_t redc(dlimb_t t) const
+    {
+        const auto lo = static_cast<::mp_limb_t>(t), hi = static_cast<::mp_limb_t>(t >> 64);
+        // NOTE: by construction m * n and t have the same low limb, thus the subtraction
+        // of the high limbs gives the exact result (possibly off by n).
+        const auto mh = static_cast<::mp_limb_t>((dlimb_t(lo * m_ninv) * m_n) >> 64);
+        return hi >= mh ? hi - mh : hi - mh + m_n;
+    }
+    ::mp_limb_t to_mont(::mp_limb_t a) const
+    {
+        return redc(dlimb_t(a % m_n) * m_r2);
+    }
+    ::mp_limb_t mul(::mp_limb_t a, ::mp_limb_t b) const
+    {
+        return redc(dlimb_t(a) * b);
+    }
+    // Product of a and b in standard form (that is, a * b mod n), without divisions.
+    ::mp_limb_t mulmod(::mp_limb_t a, ::mp_limb_t b) const
+    {
+        return mul(mul(a, b), m_r2);
+    }
+    ::mp_limb_t add(::mp_limb_t a, ::mp_limb_t b) const
+    {
+        return limb_addmod(a, b, m_n);
+    }
+    ::mp_limb_t sub(::mp_limb_t a, ::mp_limb_t b) const
+    {
+        return limb_submod(a, b, m_n);
+    }
+    ::mp_limb_t pow(::mp_limb_t base, ::mp_limb_t exp) const
+    {
+        auto retval = m_one;
+        for (; exp; exp >>= 1) {
+            if (exp & 1u) {
+                retval = mul(retval, base);
+            }
+            base = mul(base, base);
+        }
+        return retval;
+    }
+    ::mp_limb_t one() const
+    {
+        return m_one;
+    }
+    ::mp_limb_t minus_one() const
     {
+        return m_n - m_one;
+    }
+    ::mp_limb_t modulus() const
+    {
+        return m_n;
     }
 
 private:
-    // A tag to call private ctors.
-    struct ptag {
-    };
-    explicit integer(const ptag &, const char *s, int base) : m_int(s, base) {}
-    explicit integer(const ptag &, const std::string &s, int base) : integer(s.c_str(), base) {}
-#if MPPP_CPLUSPLUS >= 201703L
-    explicit integer(const ptag &, const std::string_view &s, int base) : integer(s.data(), s.data() + s.size(), base)
+    ::mp_limb_t m_n, m_ninv, m_one, m_r2;
+};
+
+// Montgomery arithmetic modulo an odd double-limb modulus n, with R = 2**128.
+class dlimb_mont
+{
+    using dlimb_t = MPPP_UINT128;
+
+public:
+    explicit dlimb_mont(dlimb_t n) : m_n(n)
     {
+        assert(n & 1u);
+        dlimb_t inv = n;
+        for (int i = 0; i < 6; ++i) {
+            inv *= 2u - n * inv;
+        }
+        assert(n * inv == 1u);
+        m_ninv = inv;
+        m_one = (0u - n) % n;
+        // NOTE: there's no 256-bit modular reduction at hand, compute R**2 mod n
+        // by doubling R mod n 128 times.
+        m_r2 = m_one;
+        for (int i = 0; i < 128; ++i) {
+            m_r2 = add(m_r2, m_r2);
+        }
     }
-#endif
-public:
-    /// Constructor from string.
-    /**
-     * \rststar
-     * This constructor will initialize ``this`` from the :cpp:concept:`~mppp::StringType` ``s``, which must represent
-     * an integer value in base ``base``. The expected format is the same as specified by the ``mpz_set_str()``
-     * GMP function. ``base`` may vary from 2 to 62, or be zero. In the latter case, the base is inferred
-     * from the leading characters of the string.
-     * \endrststar
-     *
-     * @param s the input string.
-     * @param base the base used in the string representation.
-     *
-     * @throws std::invalid_argument if the \p base parameter is invalid or if \p s is not a valid string representation
-     * of an integer in the specified base.
-     * @throws unspecified any exception thrown by memory errors in standard containers.
-     *
-     * \rststar
-     * .. seealso::
-     *
-     *    https://gmplib.org/manual/Assigning-Integers.html
-     * \endrststar
-     */
-#if defined(MPPP_HAVE_CONCEPTS)
-    explicit integer(const StringType &s,
-#else
-    template <typename T, string_type_enabler<T> = 0>
-    explicit integer(const T &s,
-#endif
-                     int base = 10)
-        : integer(ptag{}, s, base)
+    // Full 128x128 -> 256 bit product.
+    static void mul_full(dlimb_t a, dlimb_t b, dlimb_t &hi, dlimb_t &lo)
+    {
+        const auto a0 = static_cast<::mp_limb_t>(a), a1 = static_cast<::mp_limb_t>(a >> 64),
+                   b0 = static_cast<::mp_limb_t>(b), b1 = static_cast<::mp_limb_t>(b >> 64);
+        const auto p00 = dlimb_t(a0) * b0, p01 = dlimb_t(a0) * b1, p10 = dlimb_t(a1) * b0, p11 = dlimb_t(a1) * b1;
+        // NOTE: mid is less than 3 * 2**64, no overflow.
+        const auto mid = (p00 >> 64) + static_cast<::mp_limb_t>(p01) + static_cast<::mp_limb_t>(p10);
+        lo = (mid << 64) | static_cast<::mp_limb_t>(p00);
+        hi = p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+    }
+    dlimb_t redc(dlimb_t hi, dlimb_t lo) const
     {
+        dlimb_t mh, ml;
+        mul_full(lo * m_ninv, m_n, mh, ml);
+        return hi >= mh ? hi - mh : hi - mh + m_n;
     }
-    /// Constructor from range of characters.
-    /**
-     * This constructor will initialise \p this from the content of the input half-open range,
-     * which is interpreted as the string representation of an integer in base \p base.
-     *
-     * Internally, the constructor will copy the content of the range to a local buffer, add a
-     * string terminator, and invoke the constructor from string.
-     *
-     * @param begin the begin of the input range.
-     * @param end the end of the input range.
-     * @param base the base used in the string representation.
-     *
-     * @throws unspecified any exception thrown by the constructor from string, or by memory
-     * allocation errors in standard containers.
-     */
-    explicit integer(const char *begin, const char *end, int base = 10) : m_int(begin, end, base) {}
-    /// Copy constructor from \p mpz_t.
-    /**
-     * This constructor will initialize \p this with the value of the GMP integer \p n. The storage type of \p this
-     * will be static if \p n fits in the static storage, otherwise it will be dynamic.
-     *
-     * \rststar
-     * .. warning::
-     *
-     *    It is the user's responsibility to ensure that ``n`` has been correctly initialized. Calling this constructor
-     *    with an uninitialized ``n`` results in undefined behaviour.
-     * \endrststar
-     *
-     * @param n the input GMP integer.
-     */
-    explicit integer(const ::mpz_t n) : m_int(n) {}
-#if !defined(_MSC_VER)
-    /// Move constructor from \p mpz_t.
-    /**
-     * This constructor will initialize \p this with the value of the GMP integer \p n, transferring the state
-     * of \p n into \p this. The storage type of \p this
-     * will be static if \p n fits in the static storage, otherwise it will be dynamic.
-     *
-     * \rststar
-     * .. warning::
-     *
-     *    It is the user's responsibility to ensure that ``n`` has been correctly initialized. Calling this constructor
-     *    with an uninitialized ``n`` results in undefined behaviour.
-     *
-     *    Additionally, the user must ensure that, after construction, ``mpz_clear()`` is never
-     *    called on ``n``: the resources previously owned by ``n`` are now owned by ``this``, which
-     *    will take care of releasing them when the destructor is called.
-     *
-     * .. note::
-     *
-     *    Due to a compiler bug, this constructor is not available on Microsoft Visual Studio.
-     * \endrststar
-     *
-     * @param n the input GMP integer.
-     */
-    explicit integer(::mpz_t &&n) : m_int(std::move(n)) {}
-#endif
-    /// Copy assignment operator.
-    /**
-     * This operator will perform a deep copy of \p other, copying its storage type as well.
-     *
-     * @param other the assignment argument.
-     *
-     * @return a reference to \p this.
-     */
-    integer &operator=(const integer &other) = default;
-    /// Move assignment operator.
-    /**
-     * After the move, \p other will be in an unspecified but valid state, and the storage type of \p this will be
-     * <tt>other</tt>'s original storage type.
-     *
-     * @param other the assignment argument.
-     *
-     * @return a reference to \p this.
-     */
-    integer &operator=(integer &&other) = default;
-/// Generic assignment operator.
-/**
- * \rststar
- * The body of this operator is equivalent to:
- *
- * .. code-block:: c++
- *
- *    return *this = integer{x};
- *
- * That is, a temporary integer is constructed from ``x`` and it is then move-assigned to ``this``.
- * \endrststar
- *
- * @param x the assignment argument.
- *
- * @return a reference to \p this.
- *
- * @throws unspecified any exception thrown by the generic constructor.
- */
-#if defined(MPPP_HAVE_CONCEPTS)
-    integer &operator=(const CppInteroperable &x)
-#else
-    template <typename T, cpp_interoperable_enabler<T> = 0>
-    integer &operator=(const T &x)
-#endif
+    dlimb_t to_mont(dlimb_t a) const
     {
-        return *this = integer{x};
+        dlimb_t hi, lo;
+        mul_full(a % m_n, m_r2, hi, lo);
+        return redc(hi, lo);
     }
-        /// Assignment from string.
-        /**
-         * \rststar
-         * The body of this operator is equivalent to:
-         *
-         * .. code-block:: c++
-         *
-         *    return *this = integer{s};
-         *
-         * That is, a temporary integer is constructed from the :cpp:concept:`~mppp::StringType`
-         * ``s`` and it is then move-assigned to ``this``.
-         * \endrststar
-         *
-         * @param s the string that will be used for the assignment.
-         *
-         * @return a reference to \p this.
-         *
-         * @throws unspecified any exception thrown by the constructor from string.
-         */
-#if defined(MPPP_HAVE_CONCEPTS)
-    integer &operator=(const StringType &s)
-#else
-    template <typename T, string_type_enabler<T> = 0>
-    integer &operator=(const T &s)
-#endif
+    dlimb_t mul(dlimb_t a, dlimb_t b) const
     {
-        return *this = integer{s};
+        dlimb_t hi, lo;
+        mul_full(a, b, hi, lo);
+        return redc(hi, lo);
     }
-    /// Copy assignment from \p mpz_t.
-    /**
-     * This assignment operator will copy into \p this the value of the GMP integer \p n. The storage type of \p this
-     * after the assignment will be static if \p n fits in the static storage, otherwise it will be dynamic.
-     *
-     * \rststar
-     * .. warning::
-     *
-     *    It is the user's responsibility to ensure that ``n`` has been correctly initialized. Calling this operator
-     *    with an uninitialized ``n`` results in undefined behaviour. Also, no aliasing is allowed: the data in ``n``
-     *    must be completely distinct from the data in ``this`` (e.g., if ``n`` is an ``mpz_view`` of ``this`` then
-     *    it might point to internal data of ``this``, and the behaviour of this operator will thus be undefined).
-     * \endrststar
-     *
-     * @param n the input GMP integer.
-     *
-     * @return a reference to \p this.
-     */
-    integer &operator=(const ::mpz_t n)
+    dlimb_t add(dlimb_t a, dlimb_t b) const
     {
-        const auto asize = get_mpz_size(n);
-        const auto s = is_static();
-        if (s && asize <= SSize) {
-            // this is static, n fits into static. Copy over.
-            m_int.g_st()._mp_size = n->_mp_size;
-            copy_limbs_no(n->_mp_d, n->_mp_d + asize, m_int.g_st().m_limbs.data());
-            if (SSize <= static_int<SSize>::opt_size) {
-                // Zero the non-copied limbs, but only if the static size is not greater than
-                // the size for which special optimisations kick in. See the documentation
-                // of zero_unused_limbs().
-                std::fill(m_int.g_st().m_limbs.begin() + asize, m_int.g_st().m_limbs.end(), ::mp_limb_t(0));
-            }
-        } else if (!s && asize > SSize) {
-            // Dynamic to dynamic.
-            ::mpz_set(&m_int.m_dy, n);
-        } else if (s && asize > SSize) {
-            // this is static, n is too big. Promote and assign.
-            // Destroy static.
-            m_int.g_st().~s_storage();
-            // Init dynamic.
-            ::new (static_cast<void *>(&m_int.m_dy)) d_storage;
-            mpz_init_set_nlimbs(m_int.m_dy, *n);
-        } else {
-            // This is dynamic and n fits into static.
-            assert(!s && asize <= SSize);
-            // Destroy the dynamic storage.
-            m_int.destroy_dynamic();
-            // Init a static with the content from n.
-            ::new (static_cast<void *>(&m_int.m_st)) s_storage{n->_mp_size, n->_mp_d, asize};
-        }
-        return *this;
+        const auto bc = m_n - b;
+        return a >= bc ? a - bc : a + b;
     }
-#if !defined(_MSC_VER)
-    /// Move assignment from \p mpz_t.
-    /**
-     * This assignment operator will move into \p this the GMP integer \p n. The storage type of \p this
-     * after the assignment will be static if \p n fits in the static storage, otherwise it will be dynamic.
-     *
-     * \rststar
-     * .. warning::
-     *
-     *    It is the user's responsibility to ensure that ``n`` has been correctly initialized. Calling this operator
-     *    with an uninitialized ``n`` results in undefined behaviour. Also, no aliasing is allowed: the data in ``n``
-     *    must be completely distinct from the data in ``this`` (e.g., if ``n`` is an ``mpz_view`` of ``this`` then
-     *    it might point to internal data of ``this``, and the behaviour of this operator will thus be undefined).
-     *
-     *    Additionally, the user must ensure that, after the assignment, ``mpz_clear()`` is never
-     *    called on ``n``: the resources previously owned by ``n`` are now owned by ``this``, which
-     *    will take care of releasing them when the destructor is called.
-     *
-     * .. note::
-     *
-     *    Due to a compiler bug, this operator is not available on Microsoft Visual Studio.
-     * \endrststar
-     *
-     * @param n the input GMP integer.
-     *
-     * @return a reference to \p this.
-     */
-    integer &operator=(::mpz_t &&n)
+    dlimb_t sub(dlimb_t a, dlimb_t b) const
     {
-        const auto asize = get_mpz_size(n);
-        const auto s = is_static();
-        if (s && asize <= SSize) {
-            // this is static, n fits into static. Copy over.
-            m_int.g_st()._mp_size = n->_mp_size;
-            copy_limbs_no(n->_mp_d, n->_mp_d + asize, m_int.g_st().m_limbs.data());
-            if (SSize <= static_int<SSize>::opt_size) {
-                // Zero the non-copied limbs, but only if the static size is not greater than
-                // the size for which special optimisations kick in. See the documentation
-                // of zero_unused_limbs().
-                std::fill(m_int.g_st().m_limbs.begin() + asize, m_int.g_st().m_limbs.end(), ::mp_limb_t(0));
+        return a >= b ? a - b : a + (m_n - b);
+    }
+    // Halving modulo n.
+    dlimb_t half(dlimb_t a) const
+    {
+        return (a & 1u) ? (a >> 1) + (m_n >> 1) + 1u : a >> 1;
+    }
+    dlimb_t pow(dlimb_t base, dlimb_t exp) const
+    {
+        auto retval = m_one;
+        for (; exp; exp >>= 1) {
+            if (exp & 1u) {
+                retval = mul(retval, base);
             }
-            // Clear out n.
-            mpz_clear_wrap(*n);
-        } else if (!s && asize > SSize) {
-            // Dynamic to dynamic: clear this, shallow copy n.
-            mpz_clear_wrap(m_int.m_dy);
-            m_int.m_dy = *n;
-        } else if (s && asize > SSize) {
-            // this is static, n is too big. Promote and assign.
-            // Destroy static.
-            m_int.g_st().~s_storage();
-            // Init dynamic with a shallow copy.
-            ::new (static_cast<void *>(&m_int.m_dy)) d_storage(*n);
-        } else {
-            // This is dynamic and n fits into static.
-            assert(!s && asize <= SSize);
-            // Destroy the dynamic storage.
-            m_int.destroy_dynamic();
-            // Init a static with the content from n.
-            ::new (static_cast<void *>(&m_int.m_st)) s_storage{n->_mp_size, n->_mp_d, asize};
-            // Clear out n.
-            mpz_clear_wrap(*n);
+            base = mul(base, base);
         }
-        return *this;
+        return retval;
     }
-#endif
-    /// Set to zero.
-    /**
-     * After calling this method, the storage type of \p this will be static and its value will be zero.
-     *
-     * \rststar
-     * .. note::
-     *
-     *   This is a specialised higher-performance alternative to the assignment operator.
-     * \endrststar
-     *
-     * @return a reference to \p this.
-     */
-    integer &set_zero()
+    dlimb_t one() const
     {
-        if (is_static()) {
-            m_int.g_st()._mp_size = 0;
-            // Zero out the whole limbs array (equivalent to the def ctor of static int).
-            std::fill(m_int.g_st().m_limbs.begin(), m_int.g_st().m_limbs.end(), ::mp_limb_t(0));
-        } else {
-            m_int.destroy_dynamic();
-            // Def construction of static results in zero.
-            ::new (static_cast<void *>(&m_int.m_st)) s_storage();
-        }
-        return *this;
+        return m_one;
+    }
+    dlimb_t minus_one() const
+    {
+        return m_n - m_one;
     }
 
 private:
-    template <bool PlusOrMinus>
-    integer &set_one_impl()
-    {
-        if (is_static()) {
-            m_int.g_st()._mp_size = PlusOrMinus ? 1 : -1;
-            m_int.g_st().m_limbs[0] = 1;
-            // Zero the unused limbs, for the usual reason that optimised implementations
-            // expect zeroes in unused limbs.
-            std::fill(m_int.g_st().m_limbs.begin() + 1, m_int.g_st().m_limbs.end(), ::mp_limb_t(0));
-        } else {
-            m_int.destroy_dynamic();
-            // Construct from a single limb the static. This will zero any unused limb.
-            ::new (static_cast<void *>(&m_int.m_st)) s_storage{PlusOrMinus ? 1 : -1, 1u};
+    dlimb_t m_n, m_ninv, m_one, m_r2;
+};
+
+// Small odd primes used for trial division in the primality tests.
+constexpr ::mp_limb_t small_odd_primes[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+
+// Strong probable prime test to base a (in Montgomery form) for the odd modulus of m,
+// with n - 1 = d * 2**s.
+template <typename Mont, typename T>
+inline bool mont_sprp(const Mont &m, T a, T d, unsigned s)
+{
+    auto x = m.pow(a, d);
+    if (x == m.one() || x == m.minus_one()) {
+        return true;
+    }
+    for (unsigned r = 1; r < s; ++r) {
+        x = m.mul(x, x);
+        if (x == m.minus_one()) {
+            return true;
         }
-        return *this;
     }
+    return false;
+}
 
-public:
-    /// Set to one.
-    /**
-     * After calling this method, the storage type of \p this will be static and its value will be one.
-     *
-     * \rststar
-     * .. note::
-     *
-     *   This is a specialised higher-performance alternative to the assignment operator.
-     * \endrststar
-     *
-     * @return a reference to \p this.
-     */
-    integer &set_one()
-    {
-        return set_one_impl<true>();
+// Deterministic primality test for single-limb values.
+inline bool limb_is_prime(::mp_limb_t n)
+{
+    if (n < 2u) {
+        return false;
     }
-    /// Set to minus one.
-    /**
-     * After calling this method, the storage type of \p this will be static and its value will be minus one.
-     *
-     * \rststar
-     * .. note::
-     *
-     *   This is a specialised higher-performance alternative to the assignment operator.
-     * \endrststar
-     *
-     * @return a reference to \p this.
-     */
-    integer &set_negative_one()
-    {
-        return set_one_impl<false>();
+    if (!(n & 1u)) {
+        return n == 2u;
     }
-    /// Test for static storage.
-    /**
-     * @return \p true if the storage type is static, \p false otherwise.
-     */
-    bool is_static() const
-    {
-        return m_int.is_static();
+    for (auto p : small_odd_primes) {
+        if (n % p == 0u) {
+            return n == p;
+        }
     }
-    /// Check for dynamic storage.
-    /**
-     * @return \p true if the storage type is dynamic, \p false otherwise.
-     */
-    bool is_dynamic() const
-    {
-        return m_int.is_dynamic();
+    // All the factors of n are larger than 53: if n < 59**2, it is prime.
+    if (n < 59u * 59u) {
+        return true;
     }
-    /// Conversion to string.
-    /**
-     * This method will convert \p this into a string in base \p base using the GMP function \p mpz_get_str().
-     *
-     * @param base the desired base.
-     *
-     * @return a string representation of \p this.
-     *
-     * @throws std::invalid_argument if \p base is smaller than 2 or greater than 62.
-     *
-     * \rststar
-     * .. seealso::
-     *
-     *    https://gmplib.org/manual/Converting-Integers.html
-     * \endrststar
-     */
-    std::string to_string(int base = 10) const
-    {
-        if (mppp_unlikely(base < 2 || base > 62)) {
-            throw std::invalid_argument("Invalid base for string conversion: the base must be between "
-                                        "2 and 62, but a value of "
-                                        + std::to_string(base) + " was provided instead");
+    const limb_mont m(n);
+    auto d = n - 1u;
+    unsigned s = 0;
+    for (; !(d & 1u); d >>= 1) {
+        ++s;
+    }
+    // NOTE: this set of bases is known to give a deterministic answer
+    // for all 64-bit values (Jim Sinclair, 2011).
+    for (::mp_limb_t b : {2ull, 325ull, 9375ull, 28178ull, 450775ull, 9780504ull, 1795265022ull}) {
+        const auto a = m.to_mont(b);
+        // NOTE: if b is a multiple of n, the base is skipped.
+        if (a && !mont_sprp(m, a, d, s)) {
+            return false;
         }
-        return mpz_to_str(get_mpz_view(), base);
     }
-    // NOTE: maybe provide a method to access the lower-level str conversion that writes to
-    // std::vector<char>?
+    return true;
+}
 
-private:
-    // Conversion to bool.
-    template <typename T, enable_if_t<std::is_same<bool, T>::value, int> = 0>
-    std::pair<bool, T> dispatch_conversion() const
-    {
-        return std::make_pair(true, m_int.m_st._mp_size != 0);
-    }
-    // Implementation of the conversion to unsigned types which fit in a limb.
-    template <typename T, bool Sign, enable_if_t<(std::numeric_limits<T>::digits <= GMP_NUMB_BITS), int> = 0>
-    std::pair<bool, T> convert_to_unsigned() const
-    {
-        static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "Invalid type.");
-        assert((Sign && m_int.m_st._mp_size > 0) || (!Sign && m_int.m_st._mp_size < 0));
-        if ((Sign && m_int.m_st._mp_size != 1) || (!Sign && m_int.m_st._mp_size != -1)) {
-            // If the asize is not 1, the conversion will fail.
-            return std::make_pair(false, T(0));
+// Jacobi symbol (a/n), n odd.
+template <typename T>
+inline int uint_jacobi(T a, T n)
+{
+    assert(n & 1u);
+    a %= n;
+    int t = 1;
+    while (a) {
+        for (; !(a & 1u); a >>= 1) {
+            const auto r = static_cast<unsigned>(n & 7u);
+            if (r == 3u || r == 5u) {
+                t = -t;
+            }
         }
-        // Get the pointer to the limbs.
-        const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
-        if ((ptr[0] & GMP_NUMB_MASK) > std::numeric_limits<T>::max()) {
-            // The only limb has a value which exceeds the limit of T.
-            return std::make_pair(false, T(0));
+        std::swap(a, n);
+        if ((a & 3u) == 3u && (n & 3u) == 3u) {
+            t = -t;
         }
-        // There's a single limb and the result fits.
-        return std::make_pair(true, static_cast<T>(ptr[0] & GMP_NUMB_MASK));
+        a %= n;
     }
-    // Implementation of the conversion to unsigned types which do not fit in a limb.
-    template <typename T, bool Sign, enable_if_t<(std::numeric_limits<T>::digits > GMP_NUMB_BITS), int> = 0>
-    std::pair<bool, T> convert_to_unsigned() const
-    {
-        static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "Invalid type.");
-        assert((Sign && m_int.m_st._mp_size > 0) || (!Sign && m_int.m_st._mp_size < 0));
-        const auto asize = Sign ? static_cast<std::size_t>(m_int.m_st._mp_size)
-                                : static_cast<std::size_t>(nint_abs(m_int.m_st._mp_size));
-        // Get the pointer to the limbs.
-        const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
-        // Init the retval with the first limb. This is safe as T has more bits than the limb type.
-        auto retval = static_cast<T>(ptr[0] & GMP_NUMB_MASK);
-        // Add the other limbs, if any.
-        constexpr unsigned u_bits = std::numeric_limits<T>::digits;
-        unsigned shift(GMP_NUMB_BITS);
-        for (std::size_t i = 1u; i < asize; ++i, shift += unsigned(GMP_NUMB_BITS)) {
-            if (shift >= u_bits) {
-                // We need to shift left the current limb. If the shift is too large, we run into UB
-                // and it also means that the value does not fit in T.
-                return std::make_pair(false, T(0));
-            }
-            // Get the current limb. Safe as T has more bits than the limb type.
-            const auto l = static_cast<T>(ptr[i] & GMP_NUMB_MASK);
-            // LCOV_EXCL_START
-            if (l >> (u_bits - shift)) {
-                // Left-shifting the current limb is well-defined from the point of view of the language, but the result
-                // overflows: the value does not fit in T.
-                // NOTE: I suspect this branch can be triggered on common architectures only with nail builds.
-                return std::make_pair(false, T(0));
-            }
-            // LCOV_EXCL_STOP
-            // This will not overflow, as there is no carry from retval and l << shift is fine.
-            retval = static_cast<T>(retval + (l << shift));
+    return n == 1u ? t : 0;
+}
+
+// Baillie-PSW probable prime test for values of exactly two limbs.
+inline bool dlimb_is_bpsw_prime(::mp_limb_t lo, ::mp_limb_t hi)
+{
+    using dlimb_t = MPPP_UINT128;
+    assert(hi);
+    const auto n = (dlimb_t(hi) << 64) | lo;
+    if (!(lo & 1u)) {
+        return false;
+    }
+    for (auto p : small_odd_primes) {
+        if (n % p == 0u) {
+            return false;
         }
-        return std::make_pair(true, retval);
     }
-    // Conversion to unsigned ints, excluding bool.
-    template <typename T,
-              enable_if_t<conjunction<std::is_integral<T>, std::is_unsigned<T>, negation<std::is_same<bool, T>>>::value,
-                          int> = 0>
-    std::pair<bool, T> dispatch_conversion() const
-    {
-        // Handle zero.
-        if (!m_int.m_st._mp_size) {
-            return std::make_pair(true, T(0));
+    const dlimb_mont m(n);
+    // Strong probable prime test to base 2.
+    auto d = n - 1u;
+    unsigned s = 0;
+    for (; !(d & 1u); d >>= 1) {
+        ++s;
+    }
+    if (!mont_sprp(m, m.to_mont(2u), d, s)) {
+        return false;
+    }
+    // Strong Lucas probable prime test, with the parameters selected via Selfridge's method A.
+    // NOTE: n is odd and larger than any D we can reach, thus a zero Jacobi symbol signals a proper factor.
+    const std::array<::mp_limb_t, 2> limbs{{lo, hi}};
+    ::mp_limb_t abs_d = 5;
+    bool d_neg = false;
+    while (true) {
+        const auto dmod = d_neg ? n - abs_d : dlimb_t(abs_d);
+        const auto j = uint_jacobi(dmod, n);
+        if (j == -1) {
+            break;
         }
-        // Handle negative value.
-        if (m_int.m_st._mp_size < 0) {
-            return std::make_pair(false, T(0));
+        if (j == 0) {
+            return false;
         }
-        return convert_to_unsigned<T, true>();
-    }
-    // Conversion to signed ints.
-    //
-    // NOTE: the implementation of conversion to signed at the moment is split into 2 branches:
-    // a specialised implementation for T not larger than the limb type, and a slower implementation
-    // for T larger than the limb type. The slower implementation is based on the conversion
-    // to the unsigned counterpart of T, and it can probably be improved performance-wise.
-    //
-    // Helper type trait to detect conversion to small signed integers (i.e., the absolute values of T fit
-    // into a limb). We need this instead of just typedeffing an std::integral_constant because MSVC
-    // chokes on constexpr functions in a SFINAE context.
-    template <typename T>
-    struct sconv_is_small {
-        static const bool value = c_max(static_cast<make_unsigned_t<T>>(std::numeric_limits<T>::max()),
-                                        nint_abs(std::numeric_limits<T>::min()))
-                                  <= GMP_NUMB_MAX;
-    };
-    // Overload if the all the absolute values of T fit into a limb.
-    template <typename T, enable_if_t<sconv_is_small<T>::value, int> = 0>
-    std::pair<bool, T> convert_to_signed() const
-    {
-        static_assert(std::is_integral<T>::value && std::is_signed<T>::value, "Invalid type.");
-        assert(size());
-        // Cache for convenience.
-        constexpr auto Tmax = static_cast<make_unsigned_t<T>>(std::numeric_limits<T>::max());
-        if (m_int.m_st._mp_size != 1 && m_int.m_st._mp_size != -1) {
-            // this consists of more than 1 limb, the conversion is not possible.
-            return std::make_pair(false, T(0));
+        // If no suitable D shows up quickly, n may be a perfect square (for which
+        // such a D does not exist).
+        if (abs_d == 17u && ::mpn_perfect_square_p(limbs.data(), 2)) {
+            return false;
         }
-        // Get the pointer to the limbs.
-        const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
-        // The candidate output value.
-        const ::mp_limb_t candidate = ptr[0] & GMP_NUMB_MASK;
-        // Branch out on the sign.
-        if (m_int.m_st._mp_size > 0) {
-            // This is positive, it needs to fit within max().
-            if (candidate <= Tmax) {
-                return std::make_pair(true, static_cast<T>(candidate));
-            }
-            return std::make_pair(false, T(0));
-        } else {
-            return unsigned_to_nsigned<T>(candidate);
+        abs_d += 2u;
+        d_neg = !d_neg;
+    }
+    // P = 1, Q = (1 - D) / 4.
+    const auto dm = m.to_mont(d_neg ? n - abs_d : dlimb_t(abs_d));
+    // NOTE: for negative D, Q = (1 + |D|) / 4 > 0, otherwise Q = -(|D| - 1) / 4.
+    const auto qm = m.to_mont(d_neg ? dlimb_t((abs_d + 1u) / 4u) : n - (abs_d - 1u) / 4u);
+    // n + 1 = d * 2**s. NOTE: n + 1 cannot overflow, as 2**128 - 1 is a multiple of 3.
+    d = n + 1u;
+    s = 0;
+    for (; !(d & 1u); d >>= 1) {
+        ++s;
+    }
+    // Compute U_d, V_d and Q**d via the binary expansion of d, starting from U_1 = 1, V_1 = P = 1.
+    auto um = m.one(), vm = m.one(), qk = qm;
+    int bit = 127;
+    for (; !((d >> bit) & 1u); --bit) {
+    }
+    for (--bit; bit >= 0; --bit) {
+        // Doubling.
+        um = m.mul(um, vm);
+        vm = m.sub(m.mul(vm, vm), m.add(qk, qk));
+        qk = m.mul(qk, qk);
+        if ((d >> bit) & 1u) {
+            // Increment by one.
+            const auto new_u = m.half(m.add(um, vm));
+            vm = m.half(m.add(m.mul(dm, um), vm));
+            um = new_u;
+            qk = m.mul(qk, qm);
         }
     }
-    // Overload if not all the absolute values of T fit into a limb.
-    template <typename T, enable_if_t<!sconv_is_small<T>::value, int> = 0>
-    std::pair<bool, T> convert_to_signed() const
-    {
-        // Cache for convenience.
-        constexpr auto Tmax = static_cast<make_unsigned_t<T>>(std::numeric_limits<T>::max());
-        // Branch out depending on the sign of this.
-        if (m_int.m_st._mp_size > 0) {
-            // Attempt conversion to the unsigned counterpart.
-            const auto candidate = convert_to_unsigned<make_unsigned_t<T>, true>();
-            if (candidate.first && candidate.second <= Tmax) {
-                // The conversion to unsigned was successful, and the result fits in
-                // the positive range of T. Return the result.
-                return std::make_pair(true, static_cast<T>(candidate.second));
-            }
-            // The conversion to unsigned failed, or the result does not fit.
-            return std::make_pair(false, T(0));
-        } else {
-            // Attempt conversion to the unsigned counterpart.
-            const auto candidate = convert_to_unsigned<make_unsigned_t<T>, false>();
-            if (candidate.first) {
-                // The converstion to unsigned was successful, try to negate now.
-                return unsigned_to_nsigned<T>(candidate.second);
-            }
-            // The conversion to unsigned failed.
-            return std::make_pair(false, T(0));
-        }
+    if (!um || !vm) {
+        return true;
     }
-    template <typename T, enable_if_t<conjunction<std::is_integral<T>, std::is_signed<T>>::value, int> = 0>
-    std::pair<bool, T> dispatch_conversion() const
-    {
-        // Handle zero.
-        if (!m_int.m_st._mp_size) {
-            return std::make_pair(true, T(0));
+    for (unsigned r = 1; r < s; ++r) {
+        vm = m.sub(m.mul(vm, vm), m.add(qk, qk));
+        if (!vm) {
+            return true;
         }
-        return convert_to_signed<T>();
+        qk = m.mul(qk, qk);
     }
-    // Implementation of the conversion to floating-point through GMP/MPFR routines.
-    template <typename T, enable_if_t<disjunction<std::is_same<T, float>, std::is_same<T, double>>::value, int> = 0>
-    static std::pair<bool, T> mpz_float_conversion(const mpz_struct_t &m)
-    {
-        return std::make_pair(true, static_cast<T>(::mpz_get_d(&m)));
+    return false;
+}
+
+// Primality test for static integers with at most 2 limbs. The return value has the same meaning as in
+// mpz_probab_prime_p(), a value of -1 signals that the fast path could not be taken.
+template <std::size_t SSize>
+inline int static_probab_prime_p(const static_int<SSize> &n)
+{
+    switch (n._mp_size) {
+        case 0:
+            return 0;
+        case 1:
+            // NOTE: the test is deterministic for single-limb values.
+            return limb_is_prime(n.m_limbs[0]) ? 2 : 0;
+        case 2:
+            return dlimb_is_bpsw_prime(n.m_limbs[0], n.m_limbs[1]) ? 1 : 0;
     }
-#if defined(MPPP_WITH_MPFR)
-    template <typename T, enable_if_t<std::is_same<T, long double>::value, int> = 0>
-    static std::pair<bool, T> mpz_float_conversion(const mpz_struct_t &m)
-    {
-        constexpr int d2 = std::numeric_limits<long double>::max_digits10 * 4;
-        MPPP_MAYBE_TLS mpfr_raii mpfr(static_cast<::mpfr_prec_t>(d2));
-        ::mpfr_set_z(&mpfr.m_mpfr, &m, MPFR_RNDN);
-        return std::make_pair(true, ::mpfr_get_ld(&mpfr.m_mpfr, MPFR_RNDN));
+    return -1;
+}
+
+// Compute the next prime after the nonnegative static value n, if it fits in 2 limbs (and in SSize limbs).
+// Returns false if the fast path could not be taken.
+template <std::size_t SSize>
+inline bool static_nextprime(static_int<SSize> &rop, const static_int<SSize> &n)
+{
+    using dlimb_t = MPPP_UINT128;
+    if (n._mp_size > 2) {
+        return false;
     }
-#endif
-    // Conversion to floating-point.
-    template <typename T, enable_if_t<std::is_floating_point<T>::value, int> = 0>
-    std::pair<bool, T> dispatch_conversion() const
-    {
-        // Handle zero.
-        if (!m_int.m_st._mp_size) {
-            return std::make_pair(true, T(0));
+    // NOTE: negative values are handled by the caller.
+    assert(n._mp_size >= 0);
+    const auto asize = n._mp_size;
+    const auto lo = asize >= 1 ? n.m_limbs[0] : ::mp_limb_t(0), hi = asize == 2 ? n.m_limbs[1] : ::mp_limb_t(0);
+    const auto max = SSize == 1u ? dlimb_t(GMP_NUMB_MAX) : ~dlimb_t(0);
+    auto c = (dlimb_t(hi) << 64) | lo;
+    if (c < 2u) {
+        c = 2u;
+    } else {
+        // Smallest odd number greater than c.
+        if (c >= max - 1u) {
+            return false;
         }
-        if (std::numeric_limits<T>::is_iec559) {
-            // Optimization for single-limb integers.
-            //
-            // NOTE: the reasoning here is as follows. If the floating-point type has infinity,
-            // then its "range" is the whole real line. The C++ standard guarantees that:
-            // """
-            // A prvalue of an integer type or of an unscoped enumeration type can be converted to a prvalue of a
-            // floating point type. The result is exact if possible. If the value being converted is in the range
-            // of values that can be represented but the value cannot be represented exactly,
-            // it is an implementation-defined choice of either the next lower or higher representable value. If the
-            // value being converted is outside the range of values that can be represented, the behavior is undefined.
-            // """
-            // This seems to indicate that if the limb value "overflows" the finite range of the floating-point type, we
-            // will get either the max/min finite value or +-inf. Additionally, the IEEE standard seems to indicate
-            // that an overflowing conversion will produce infinity:
-            // http://stackoverflow.com/questions/40694384/integer-to-float-conversions-with-ieee-fp
-            //
-            // Get the pointer to the limbs.
-            const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
-            if (m_int.m_st._mp_size == 1) {
-                return std::make_pair(true, static_cast<T>(ptr[0] & GMP_NUMB_MASK));
-            }
-            if (m_int.m_st._mp_size == -1) {
-                return std::make_pair(true, -static_cast<T>(ptr[0] & GMP_NUMB_MASK));
+        c = (c + 1u) | 1u;
+        while (c >> 64 ? !dlimb_is_bpsw_prime(static_cast<::mp_limb_t>(c), static_cast<::mp_limb_t>(c >> 64))
+                       : !limb_is_prime(static_cast<::mp_limb_t>(c))) {
+            if (c >= max - 1u) {
+                return false;
             }
+            c += 2u;
         }
-        // For all the other cases, just delegate to the GMP/MPFR routines.
-        return mpz_float_conversion<T>(*static_cast<const mpz_struct_t *>(get_mpz_view()));
     }
+    rop.m_limbs[0] = static_cast<::mp_limb_t>(c);
+    if (c >> 64) {
+        // NOTE: SSize must be at least 2 here, as we checked against max. The conditional
+        // index just avoids spurious out-of-bounds warnings when SSize is 1.
+        rop.m_limbs[SSize > 1u ? 1u : 0u] = static_cast<::mp_limb_t>(c >> 64);
+        rop._mp_size = 2;
+    } else {
+        rop._mp_size = 1;
+    }
+    rop.zero_unused_limbs();
+    return true;
+}
 
-public:
-/// Generic conversion operator.
-/**
- * \rststar
- * This operator will convert ``this`` to a :cpp:concept:`~mppp::CppInteroperable` type.
- * Conversion to ``bool`` yields ``false`` if ``this`` is zero,
- * ``true`` otherwise. Conversion to other integral types yields the exact result, if representable by the target
- * :cpp:concept:`~mppp::CppInteroperable` type. Conversion to floating-point types might yield inexact values and
- * infinities.
- * \endrststar
- *
- * @return \p this converted to the target type.
- *
- * @throws std::overflow_error if the target type is an integral type and the value of ``this`` cannot be represented by
- * it.
- */
-#if defined(MPPP_HAVE_CONCEPTS)
-    template <CppInteroperable T>
-#else
-    template <typename T, cpp_interoperable_enabler<T> = 0>
-#endif
-    explicit operator T() const
-    {
-        auto retval = dispatch_conversion<T>();
-        if (mppp_unlikely(!retval.first)) {
-            throw std::overflow_error("Conversion of the integer " + to_string() + " to the type " + typeid(T).name()
-                                      + " results in overflow");
-        }
-        return std::move(retval.second);
+// Integer square root of a single limb, via a floating-point estimate and a correction step.
+inline ::mp_limb_t limb_isqrt(::mp_limb_t n)
+{
+    auto r = static_cast<::mp_limb_t>(std::sqrt(static_cast<double>(n)));
+    // NOTE: fix the floating-point estimate, taking care of not overflowing.
+    while (r > 4294967295ull || r * r > n) {
+        --r;
     }
-        /// Generic conversion method.
-        /**
-         * \rststar
-         * This method, similarly to the conversion operator, will convert ``this`` to a
-         * :cpp:concept:`~mppp::CppInteroperable` type, storing the result of the conversion into ``rop``. Differently
-         * from the conversion operator, this method does not raise any exception: if the conversion is successful, the
-         * method will return ``true``, otherwise the method will return ``false``. If the conversion fails,
-         * ``rop`` will not be altered.
-         * \endrststar
-         *
-         * @param rop the variable which will store the result of the conversion.
-         *
-         * @return ``true`` if the conversion succeeded, ``false`` otherwise. The conversion can fail only if ``rop`` is
-         * a C++ integral which cannot represent the value of ``this``.
-         */
-#if defined(MPPP_HAVE_CONCEPTS)
-    template <CppInteroperable T>
-#else
-    template <typename T, cpp_interoperable_enabler<T> = 0>
-#endif
-    bool get(T &rop) const
-    {
-        auto retval = dispatch_conversion<T>();
-        if (retval.first) {
-            rop = std::move(retval.second);
-            return true;
-        }
-        return false;
+    while (r < 4294967295ull && (r + 1u) * (r + 1u) <= n) {
+        ++r;
     }
-    /// Promote to dynamic storage.
-    /**
-     * This method will promote the storage type of \p this from static to dynamic.
-     *
-     * @return \p false if the storage type of \p this is already dynamic and no promotion takes place, \p true
-     * otherwise.
-     */
-    bool promote()
-    {
-        if (is_static()) {
-            m_int.promote();
-            return true;
+    return r;
+}
+
+// Integer square root of a 2-limb value.
+inline ::mp_limb_t dlimb_isqrt(MPPP_UINT128 n)
+{
+    using dlimb_t = MPPP_UINT128;
+    assert(n >> 64);
+    // NOTE: the relative error of the floating-point estimate is about 2**-52, thus the absolute
+    // error can be a few thousands. A single Newton iteration brings it down to at most a unit.
+    const auto est = std::sqrt(static_cast<double>(n));
+    auto r = est >= 18446744073709551616. ? dlimb_t(GMP_NUMB_MAX) : static_cast<dlimb_t>(est);
+    r = (r + n / r) / 2u;
+    auto s = r > GMP_NUMB_MAX ? GMP_NUMB_MAX : static_cast<::mp_limb_t>(r);
+    while (dlimb_t(s) * s > n) {
+        --s;
+    }
+    while (s < GMP_NUMB_MAX && dlimb_t(s + 1u) * (s + 1u) <= n) {
+        ++s;
+    }
+    return s;
+}
+
+// Check if r**k <= n, for single-limb values.
+inline bool limb_pow_leq(::mp_limb_t r, unsigned long k, ::mp_limb_t n)
+{
+    ::mp_limb_t acc = 1;
+    for (unsigned long i = 0; i < k; ++i) {
+        if (r && acc > n / r) {
+            return false;
         }
+        acc *= r;
+    }
+    return true;
+}
+
+// Integer k-th root of a single limb, k >= 1.
+inline ::mp_limb_t limb_iroot(::mp_limb_t n, unsigned long k)
+{
+    assert(k);
+    if (k == 1u || n < 2u) {
+        return n;
+    }
+    if (k >= unsigned(GMP_NUMB_BITS)) {
+        return 1u;
+    }
+    if (k == 2u) {
+        return limb_isqrt(n);
+    }
+    auto r = static_cast<::mp_limb_t>(std::pow(static_cast<double>(n), 1. / static_cast<double>(k)));
+    while (!limb_pow_leq(r, k, n)) {
+        --r;
+    }
+    while (limb_pow_leq(r + 1u, k, n)) {
+        ++r;
+    }
+    return r;
+}
+
+// Square root with remainder for nonnegative static integers with at most 2 limbs. The remainder
+// is written into rem, if not null. Returns false if the fast path could not be taken.
+template <std::size_t SSize>
+inline bool static_sqrtrem(static_int<SSize> &rop, static_int<SSize> *rem, const static_int<SSize> &n)
+{
+    using dlimb_t = MPPP_UINT128;
+    const auto size = n._mp_size;
+    assert(size >= 0);
+    if (size > 2) {
         return false;
     }
-    /// Demote to static storage.
-    /**
-     * This method will demote the storage type of \p this from dynamic to static.
-     *
-     * @return \p false if the storage type of \p this is already static and no demotion takes place, or if the current
-     * value of \p this does not fit in static storage, \p true otherwise.
-     */
-    bool demote()
-    {
-        if (is_dynamic()) {
-            return m_int.demote();
+    // NOTE: read n completely before writing into rop and rem, which might overlap with it.
+    const auto v = size == 2 ? (dlimb_t(n.m_limbs[1]) << 64) | n.m_limbs[0] : dlimb_t(size ? n.m_limbs[0] : 0u);
+    const auto s = size == 2 ? dlimb_isqrt(v) : limb_isqrt(static_cast<::mp_limb_t>(v));
+    const auto r = v - dlimb_t(s) * s;
+    rop._mp_size = s ? 1 : 0;
+    rop.m_limbs[0] = s;
+    rop.zero_unused_limbs();
+    if (rem) {
+        rem->m_limbs[0] = static_cast<::mp_limb_t>(r);
+        if (r >> 64) {
+            // NOTE: this can happen only if n has 2 limbs, so SSize is at least 2. The conditional
+            // index just avoids spurious out-of-bounds warnings when SSize is 1.
+            rem->m_limbs[SSize > 1u ? 1u : 0u] = static_cast<::mp_limb_t>(r >> 64);
+            rem->_mp_size = 2;
+        } else {
+            rem->_mp_size = r ? 1 : 0;
         }
+        rem->zero_unused_limbs();
+    }
+    return true;
+}
+
+// k-th root with remainder for static integers with at most 1 limb. The remainder is written into rem,
+// if not null. Returns false if the fast path could not be taken.
+template <std::size_t SSize>
+inline bool static_rootrem(static_int<SSize> &rop, static_int<SSize> *rem, const static_int<SSize> &n,
+                           unsigned long k)
+{
+    const auto size = n._mp_size;
+    if (size > 1 || size < -1) {
         return false;
     }
-    /// Size in bits.
-    /**
-     * @return the number of bits needed to represent \p this. If \p this is zero, zero will be returned.
-     *
-     * @throws std::overflow_error if the size in bits of \p this is larger than an implementation-defined value.
-     */
-    std::size_t nbits() const
-    {
-#if defined(__clang__) || defined(__GNUC__)
-        const std::size_t ls = size();
-        const ::mp_limb_t *lptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
-        if (ls) {
-            // LCOV_EXCL_START
-            if (mppp_unlikely(ls > std::numeric_limits<std::size_t>::max() / unsigned(GMP_NUMB_BITS))) {
-                throw std::overflow_error("Overflow in the computation of the number of bits required to represent an "
-                                          "integer - the limb size is "
-                                          + std::to_string(ls));
-            }
-            // LCOV_EXCL_STOP
-            // Index of the most significant limb.
-            const std::size_t idx = ls - 1u;
-            // The most significant limb.
-            const ::mp_limb_t msl = lptr[idx] & GMP_NUMB_MASK;
-            // NOTE: here we need std::numeric_limits<::mp_limb_t>::digits (instead of GMP_NUMB_BITS) because
-            // builtin_clz() counts zeroes also in the nail bits.
-            return static_cast<std::size_t>(idx * unsigned(GMP_NUMB_BITS)
-                                            + (unsigned(std::numeric_limits<::mp_limb_t>::digits) - builtin_clz(msl)));
+    const auto m = size ? n.m_limbs[0] : ::mp_limb_t(0);
+    const auto r = limb_iroot(m, k);
+    // NOTE: r**k cannot overflow, as it is not greater than m. If r > 1, then k is small.
+    auto rk = r;
+    if (r > 1u) {
+        for (unsigned long i = 1; i < k; ++i) {
+            rk *= r;
         }
-        return 0;
-#else
-        return m_int.m_st._mp_size ? ::mpz_sizeinbase(get_mpz_view(), 2) : 0u;
-#endif
     }
-    /// Size in limbs.
-    /**
-     * @return the number of limbs needed to represent \p this. If \p this is zero, zero will be returned.
-     */
-    std::size_t size() const
-    {
-        return (m_int.m_st._mp_size) >= 0 ? static_cast<std::size_t>(m_int.m_st._mp_size)
-                                          : static_cast<std::size_t>(nint_abs(m_int.m_st._mp_size));
+    // NOTE: negative values are allowed only for odd k, the root and the remainder
+    // have then the sign of n.
+    rop._mp_size = r ? size : 0;
+    rop.m_limbs[0] = r;
+    rop.zero_unused_limbs();
+    if (rem) {
+        rem->_mp_size = m != rk ? size : 0;
+        rem->m_limbs[0] = m - rk;
+        rem->zero_unused_limbs();
     }
-    /// Sign.
-    /**
-     * @return 0 if \p this is zero, 1 if \p this is positive, -1 if \p this is negative.
-     */
-    int sgn() const
-    {
-        // NOTE: size is part of the common initial sequence.
-        if (m_int.m_st._mp_size != 0) {
-            return m_int.m_st._mp_size > 0 ? 1 : -1;
-        } else {
-            return 0;
+    return true;
+}
+
+// Test if the 1-limb value n is a perfect power, that is, if n == r**k with k > 1.
+// If neg is true, only odd exponents are considered.
+inline bool limb_perfect_power_p(::mp_limb_t n, bool neg)
+{
+    if (n < 2u) {
+        return true;
+    }
+    if (!neg && limb_square_filter(n, ::mp_limb_t(n % 21483u))) {
+        const auto r = limb_isqrt(n);
+        if (r * r == n) {
+            return true;
         }
     }
-    /// Get an \p mpz_t view.
-    /**
-     * This method will return an object of an unspecified type \p mpz_view which is implicitly convertible
-     * to a const pointer to an \p mpz_t struct (and which can thus be used as a <tt>const mpz_t</tt>
-     * parameter in GMP functions). In addition to the implicit conversion operator, the <tt>const mpz_t</tt>
-     * object can also be retrieved via the <tt>get()</tt> method of the \p mpz_view class.
-     * The view provides a read-only GMP-compatible representation of the integer stored in \p this.
-     *
-     * \rststar
-     * .. note::
-     *
-     *   It is important to keep in mind the following facts about the returned ``mpz_view`` object:
-     *
-     *   * ``mpz_view`` objects are strictly read-only: it is impossible to alter ``this`` through an ``mpz_view``, and
-     *     ``mpz_view`` objects can be used in the GMP API only where a ``const mpz_t`` parameter is expected;
-     *   * ``mpz_view`` objects can only be move-constructed (the other constructors and the assignment operators
-     *     are disabled);
-     *   * the returned object and the pointer returned by its ``get()`` method might reference internal data
-     *     belonging to ``this``, and they can thus be used safely only during the lifetime of ``this``;
-     *   * the lifetime of the pointer returned by the ``get()`` method is tied to the lifetime of the ``mpz_view``
-     *     object (that is, if the ``mpz_view`` object is destroyed, any pointer previously returned by ``get()``
-     *     becomes invalid);
-     *   * any modification to ``this`` will also invalidate the view and the pointer.
-     * \endrststar
-     *
-     * @return an \p mpz view of \p this.
-     */
-    mpz_view get_mpz_view() const
-    {
-        return mpz_view(*this);
+    // NOTE: a perfect k-th power is also a perfect p-th power for all the primes p dividing k,
+    // thus only the prime exponents need to be checked.
+    for (unsigned long k : {3ul, 5ul, 7ul, 11ul, 13ul, 17ul, 19ul, 23ul, 29ul, 31ul, 37ul, 41ul, 43ul, 47ul, 53ul,
+                            59ul, 61ul}) {
+        if ((n >> k) == 0u) {
+            // 2**k > n, thus the k-th root of n is 1.
+            break;
+        }
+        const auto r = limb_iroot(n, k);
+        // NOTE: r**k cannot overflow, as it is not greater than n.
+        auto rk = r;
+        for (unsigned long i = 1; i < k; ++i) {
+            rk *= r;
+        }
+        if (rk == n) {
+            return true;
+        }
     }
-    /// Negate in-place.
-    /**
-     * This method will set \p this to <tt>-this</tt>.
-     *
-     * @return a reference to \p this.
-     */
-    integer &neg()
-    {
-        m_int.neg();
-        return *this;
+    return false;
+}
+
+// Perfect power test for static integers with at most 1 limb. Returns -1 if the fast path could not be taken.
+template <std::size_t SSize>
+inline int static_perfect_power_p(const static_int<SSize> &n)
+{
+    if (n._mp_size > 1 || n._mp_size < -1) {
+        return -1;
     }
-    /// In-place absolute value.
-    /**
-     * This method will set \p this to its absolute value.
-     *
-     * @return a reference to \p this.
-     */
-    integer &abs()
+    return limb_perfect_power_p(n._mp_size ? n.m_limbs[0] : ::mp_limb_t(0), n._mp_size < 0) ? 1 : 0;
+}
+
+#else
+
+template <std::size_t SSize>
+inline int static_probab_prime_p(const static_int<SSize> &)
+{
+    return -1;
+}
+
+template <std::size_t SSize>
+inline bool static_nextprime(static_int<SSize> &, const static_int<SSize> &)
+{
+    return false;
+}
+
+template <std::size_t SSize>
+inline bool static_sqrtrem(static_int<SSize> &, static_int<SSize> *, const static_int<SSize> &)
+{
+    return false;
+}
+
+template <std::size_t SSize>
+inline bool static_rootrem(static_int<SSize> &, static_int<SSize> *, const static_int<SSize> &, unsigned long)
+{
+    return false;
+}
+
+template <std::size_t SSize>
+inline int static_perfect_power_p(const static_int<SSize> &)
+{
+    return -1;
+}
+
+#endif
+
+}
+
+// Fwd declaration.
+template <std::size_t SSize>
+integer<SSize> &sqrt(integer<SSize> &, const integer<SSize> &);
+
+#if defined(MPPP_ENABLE_EXPRESSION_TEMPLATES)
+
+inline namespace detail
+{
+
+// Fwd declaration of the expression types.
+template <std::size_t SSize>
+class integer_mul_expr;
+
+template <std::size_t SSize>
+class integer_fma_expr;
+}
+
+#endif
+
+// NOTE: a few misc things:
+// - re-visit at one point the issue of the estimators when we need to promote from static to dynamic
+//   in arithmetic ops. Currently they are not 100% optimal since they rely on the information coming out
+//   of the static implementation rather than computing the estimated size of rop themselves, for performance
+//   reasons (see comments);
+// - maybe the lshift/rshift optimisation for 2 limbs could use dlimb types if available?
+// - it seems like it might be possible to re-implement a bare-bone mpz api on top of the mpn primitives,
+//   with the goal of providing some form of error recovery in case of memory errors (e.g., throw instead
+//   of aborting). This is probably not an immediate concern though.
+// - pow() can probably benefit for some specialised static implementation, especially in conjunction with
+//   mpn_sqr().
+// - gcd() can be improved (see notes).
+// - functions still to be de-branched: all the mpn implementations, if worth it.
+//   Probably better to wait for benchmarks before moving.
+// - performance improvements for the assignment operators to integrals, at least (maybe floats as well?): avoid
+//   cting temporary.
+// - performance improvements for arithmetic with C++ integrals? (e.g., use add_ui() and similar rather than cting
+//   temporary).
+
+/// Multiprecision integer class.
+/**
+ * \rststar
+ * This class represents arbitrary-precision signed integers. It acts as a wrapper around the GMP ``mpz_t`` type, with
+ * a small value optimisation: integers whose size is up to ``SSize`` limbs are stored directly in the storage
+ * occupied by the :cpp:class:`~mppp::integer` object, without resorting to dynamic memory allocation. The value of
+ * ``SSize`` must be at least 1 and less than an implementation-defined upper limit. On most modern architectures,
+ * a limb contains either 32 or 64 bits of data. Thus, for instance, is ``SSize`` is set to 2 on a 64-bit system,
+ * the small value optimisation will be employed for all integral values less than :math:`2^{64 \times 2} = 2^{128}`.
+ *
+ * When the value of an :cpp:class:`~mppp::integer` is stored directly within the object, the *storage type* of the
+ * integer is said to be *static*. When the limb size of the integer exceeds the maximum value ``SSize``, the storage
+ * type becomes *dynamic*. The transition from static to dynamic storage happens transparently whenever the integer
+ * value becomes large enough. The demotion from dynamic to static storage usually needs to be requested explicitly.
+ * For values of ``SSize`` of 1 and 2, optimised implementations of basic arithmetic operations are employed,
+ * if supported by the target architecture and if the storage type is static. For larger values of ``SSize``,
+ * the ``mpn_`` low-level functions of the GMP API are used if the storage type is static. If the storage type is
+ * dynamic, the usual ``mpz_`` functions from the GMP API are used.
+ *
+ * This class has the look and feel of a C++ builtin type: it can interact with most of C++'s integral and
+ * floating-point primitive types (see the :cpp:concept:`~mppp::CppInteroperable` concept for the full list),
+ * and it provides overloaded :ref:`operators <integer_operators>`. Differently from the builtin types,
+ * however, this class does not allow any implicit conversion to/from other types (apart from ``bool``): construction
+ * from and conversion to primitive types must always be requested explicitly. As a side effect, syntax such as
+ *
+ * .. code-block:: c++
+ *
+ *    integer<1> n = 5;
+ *    int m = n;
+ *
+ * will not work, and direct initialization and explicit casting should be used instead:
+ *
+ * .. code-block:: c++
+ *
+ *    integer<1> n{5};
+ *    int m = static_cast<int>(n);
+ *
+ * Most of the functionality is exposed via plain :ref:`functions <integer_functions>`, with the
+ * general convention that the functions are named after the corresponding GMP functions minus the leading ``mpz_``
+ * prefix. For instance, the GMP call
+ *
+ * .. code-block:: c++
+ *
+ *    mpz_add(rop,a,b);
+ *
+ * that writes the result of ``a + b`` into ``rop`` becomes simply
+ *
+ * .. code-block:: c++
+ *
+ *    add(rop,a,b);
+ *
+ * where the ``add()`` function is resolved via argument-dependent lookup. Function calls with overlapping arguments
+ * are allowed, unless noted otherwise.
+ *
+ * Multiple overloads of the same functionality are often available.
+ * Binary functions in GMP are usually implemented via three-arguments functions, in which the first
+ * argument is a reference to the return value. The exponentiation function ``mpz_pow_ui()``, for instance,
+ * takes three arguments: the return value, the base and the exponent. There are two overloads of the corresponding
+ * :ref:`exponentiation <integer_exponentiation>` function:
+ *
+ * * a ternary overload semantically equivalent to ``mpz_pow_ui()``,
+ * * a binary overload taking as inputs the base and the exponent, and returning the result
+ *   of the exponentiation.
+ *
+ * This allows to avoid having to set up a return value for one-off invocations of ``pow_ui()`` (the binary overload
+ * will do it for you). For example:
+ *
+ * .. code-block:: c++
+ *
+ *    integer<1> r1, r2, n{3};
+ *    pow_ui(r1,n,2);   // Ternary pow_ui(): computes n**2 and stores
+ *                      // the result in r1.
+ *    r2 = pow_ui(n,2); // Binary pow_ui(): returns n**2, which is then
+ *                      // assigned to r2.
+ *
+ * In case of unary functions, there are often three overloads available:
+ *
+ * * a binary overload taking as first parameter a reference to the return value (GMP style),
+ * * a unary overload returning the result of the operation,
+ * * a nullary member function that modifies the calling object in-place.
+ *
+ * For instance, here are three possible ways of computing the absolute value:
+ *
+ * .. code-block:: c++
+ *
+ *    integer<1> r1, r2, n{-5};
+ *    abs(r1,n);   // Binary abs(): computes and stores the absolute value
+ *                 // of n into r1.
+ *    r2 = abs(n); // Unary abs(): returns the absolute value of n, which is
+ *                 // then assigned to r2.
+ *    n.abs();     // Member function abs(): replaces the value of n with its
+ *                 // absolute value.
+ *
+ * Note that at this time only a small subset of the GMP API has been wrapped by :cpp:class:`~mppp::integer`.
+ *
+ * Various :ref:`overloaded operators <integer_operators>` are provided.
+ * For the common arithmetic operations (``+``, ``-``, ``*`` and ``/``), the type promotion
+ * rules are a natural extension of the corresponding rules for native C++ types: if the other argument
+ * is a C++ integral, the result will be of type :cpp:class:`~mppp::integer`, if the other argument is a C++
+ * floating-point the result will be of the same floating-point type. For example:
+ *
+ * .. code-block:: c++
+ *
+ *    integer<1> n1{1}, n2{2};
+ *    auto res1 = n1 + n2; // res1 is an integer
+ *    auto res2 = n1 * 2; // res2 is an integer
+ *    auto res3 = 2 - n2; // res3 is an integer
+ *    auto res4 = n1 / 2.f; // res4 is a float
+ *    auto res5 = 12. / n1; // res5 is a double
+ *
+ * The modulo operator ``%`` accepts only :cpp:class:`~mppp::integer` and :cpp:concept:`~mppp::CppInteroperable`
+ * integral types as arguments,
+ * and it always returns :cpp:class:`~mppp::integer` as result. The bit shifting operators ``<<`` and ``>>`` accept
+ * only :cpp:concept:`~mppp::CppInteroperable` integral types as shift arguments, and they always return
+ * :cpp:class:`~mppp::integer` as result.
+ *
+ * The relational operators, ``==``, ``!=``, ``<``, ``>``, ``<=`` and ``>=`` will promote the arguments to a common type
+ * before comparing them. The promotion rules are the same as in the arithmetic operators (that is, both arguments are
+ * promoted to :cpp:class:`~mppp::integer` if they are both integral types, otherwise they are promoted to the type
+ * of the floating-point argument).
+ *
+ * Several facilities for interfacing with the GMP library are provided. Specifically, :cpp:class:`~mppp::integer`
+ * features:
+ *
+ * * a constructor and an assignment operator from the GMP integer type ``mpz_t``,
+ * * a :cpp:func:`~mppp::integer::get_mpz_t()` method that promotes ``this`` to dynamic
+ *   storage and returns a pointer to the internal ``mpz_t`` instance,
+ * * an ``mpz_view`` class, an instance of which can be requested via the :cpp:func:`~mppp::integer::get_mpz_view()`
+ *   method, which allows to use :cpp:class:`~mppp::integer` in the GMP API as a drop-in replacement for
+ *   ``const mpz_t`` function arguments.
+ *
+ * The ``mpz_view`` class represent a read-only view of an integer object which is implicitly convertible to the type
+ * ``const mpz_t`` and which is thus usable as an argument to GMP functions. For example:
+ *
+ * .. code-block:: c++
+ *
+ *    mpz_t m;
+ *    mpz_init_set_si(m,1); // Create an mpz_t with the value 1.
+ *    integer<1> n{1}; // Initialize an integer with the value 1.
+ *    mpz_add(m,m,n.get_mpz_view()); // Compute the result of n + m and store
+ *                                   // it in m using the GMP API.
+ *
+ * See the documentation of :cpp:func:`~mppp::integer::get_mpz_view()` for more details about the ``mpz_view`` class.
+ * Via the GMP interfacing facilities, it is thus possible to use directly the GMP C API with
+ * :cpp:class:`~mppp::integer` objects whenever necessary (e.g., if a GMP function has not been wrapped yet by mp++).
+ * \endrststar
+ */
+template <std::size_t SSize>
+class integer
+{
+    // Typedefs for ease of use.
+    using s_storage = static_int<SSize>;
+    using d_storage = mpz_struct_t;
+    // The underlying static int.
+    using s_int = s_storage;
+    // mpz view class.
+    // NOTE: this class looks more complicated than it seemingly should be - it looks like
+    // it should be enough to shallow-copy around an mpz_struct_t with the limbs pointing
+    // either to a static integer or a dynamic one. This option, however, has a problem:
+    // in case of a dynamic integer, one can get 2 different mpz_struct_t instances, one
+    // via m_int.g_dy(), the other via the view class, which internally point to the same
+    // limbs vector. Having 2 *distinct* mpz_t point to the same limbs vector is not
+    // something which is supported by the GMP API, at least when one mpz_t is being written into.
+    // This happens for instance when using arithmetic functions
+    // in which the return object is the same as one of the operands (GMP supports aliasing
+    // if multiple mpz_t are the same object, but in this case they are distinct objects.)
+    //
+    // In the current implementation, mixing dynamic views with mpz_t objects in the GMP
+    // API is fine, as dynamic views point to unique mpz_t objects within the integers.
+    // We still however have potential for aliasing when using the static views: these
+    // do not point to "real" mpz_t objects, they are mpz_t objects internally pointing
+    // to the limbs of static integers. So, for instance, in an add() operation with
+    // rop dynamic, and op1 and op2 statics and the same object, we create two separate
+    // static views pointing to the same limbs internally, and feed them to the GMP API.
+    //
+    // This seems to work however: the data in the static views is strictly read-only and
+    // it cannot be modified by a modification to a rop, as this needs to be a real mpz_t
+    // in order to be used in the GMP API (views are convertible to const mpz_t only,
+    // not mutable mpz_t). That is, static views and rops can only point to distinct
+    // limbs vectors.
+    //
+    // The bottom line is that, in practice, the GMP API does not seem to be bothered by the fact
+    // that const arguments might overlap behind its back. If this ever becomes a problem,
+    // we can consider a "true" static view which does not simply point to an existing
+    // static integer but actually copies it as a data member.
+    struct mpz_view {
+        explicit mpz_view(const integer &n)
+            // NOTE: explicitly initialize mpz_struct_t() in order to avoid reading from
+            // uninited memory in the move constructor, in case of a dynamic view.
+            : m_static_view(n.is_static() ? n.m_int.g_st().get_mpz_view() : mpz_struct_t()),
+              m_ptr(n.is_static() ? &m_static_view : &(n.m_int.g_dy()))
+        {
+        }
+        mpz_view(const mpz_view &) = delete;
+        mpz_view(mpz_view &&other)
+            : m_static_view(other.m_static_view),
+              // NOTE: we need to re-init ptr here if other is a static view, because in that case
+              // other.m_ptr will be pointing to an mpz_struct_t in other and we want it to point to
+              // the struct in this now.
+              m_ptr((other.m_ptr == &other.m_static_view) ? &m_static_view : other.m_ptr)
+        {
+        }
+        mpz_view &operator=(const mpz_view &) = delete;
+        mpz_view &operator=(mpz_view &&) = delete;
+        operator const mpz_struct_t *() const
+        {
+            return get();
+        }
+        const mpz_struct_t *get() const
+        {
+            return m_ptr;
+        }
+        mpz_struct_t m_static_view;
+        const mpz_struct_t *m_ptr;
+    };
+    // Make friends with rational.
+    template <std::size_t>
+    friend class rational;
+
+public:
+    /// Alias for the template parameter \p SSize.
+    static constexpr std::size_t ssize = SSize;
+    /// Default constructor.
+    /**
+     * The default constructor initialises an integer with static storage type and value 0.
+     */
+    integer() = default;
+    /// Copy constructor.
+    /**
+     * The copy constructor deep-copies \p other into \p this, copying the original storage type as well.
+     *
+     * @param other the object that will be copied into \p this.
+     */
+    integer(const integer &other) = default;
+    /// Move constructor.
+    /**
+     * The move constructor will leave \p other in an unspecified but valid state. The storage type
+     * of \p this will be the same as <tt>other</tt>'s.
+     *
+     * @param other the object that will be moved into \p this.
+     */
+    integer(integer &&other) = default;
+/// Generic constructor.
+/**
+ * This constructor will initialize an integer with the value of \p x. The initialization is always
+ * successful if \p x is an integral value (construction from \p bool yields 1 for \p true, 0 for \p false).
+ * If \p x is a floating-point value, the construction will fail if \p x is not finite. Construction from a
+ * floating-point type yields the truncated counterpart of the input value.
+ *
+ * @param x value that will be used to initialize \p this.
+ *
+ * @throws std::domain_error if \p x is a non-finite floating-point value.
+ */
+#if defined(MPPP_HAVE_CONCEPTS)
+    explicit integer(const CppInteroperable &x)
+#else
+    template <typename T, cpp_interoperable_enabler<T> = 0>
+    explicit integer(const T &x)
+#endif
+        : m_int(x)
+    {
+    }
+#if defined(MPPP_HAVE_INT128_INTEROP)
+    /// Constructor from 128-bit integral types.
+    /**
+     * \rststar
+     * This constructor is enabled only if ``T`` is either ``__int128_t`` or ``__uint128_t``. It is
+     * available only if the compiler supports 128-bit integers and GMP uses 64-bit limbs, in which
+     * case the ``MPPP_HAVE_INT128_INTEROP`` macro is defined. The 128-bit integral types are supported
+     * also in the arithmetic and comparison operators of :cpp:class:`~mppp::integer`.
+     * \endrststar
+     *
+     * @param n value that will be used to initialize \p this.
+     */
+    template <typename T, enable_if_t<is_integer_int128<T>::value, int> = 0>
+    explicit integer(const T &n) : m_int(n)
+    {
+    }
+#endif
+
+private:
+    // A tag to call private ctors.
+    struct ptag {
+    };
+    explicit integer(const ptag &, const char *s, int base) : m_int(s, base) {}
+    explicit integer(const ptag &, const std::string &s, int base) : integer(s.c_str(), base) {}
+#if MPPP_CPLUSPLUS >= 201703L
+    explicit integer(const ptag &, const std::string_view &s, int base) : integer(s.data(), s.data() + s.size(), base)
+    {
+    }
+#endif
+public:
+    /// Constructor from string.
+    /**
+     * \rststar
+     * This constructor will initialize ``this`` from the :cpp:concept:`~mppp::StringType` ``s``, which must represent
+     * an integer value in base ``base``. The expected format is the same as specified by the ``mpz_set_str()``
+     * GMP function. ``base`` may vary from 2 to 62, or be zero. In the latter case, the base is inferred
+     * from the leading characters of the string.
+     * \endrststar
+     *
+     * @param s the input string.
+     * @param base the base used in the string representation.
+     *
+     * @throws std::invalid_argument if the \p base parameter is invalid or if \p s is not a valid string representation
+     * of an integer in the specified base.
+     * @throws unspecified any exception thrown by memory errors in standard containers.
+     *
+     * \rststar
+     * .. seealso::
+     *
+     *    https://gmplib.org/manual/Assigning-Integers.html
+     * \endrststar
+     */
+#if defined(MPPP_HAVE_CONCEPTS)
+    explicit integer(const StringType &s,
+#else
+    template <typename T, string_type_enabler<T> = 0>
+    explicit integer(const T &s,
+#endif
+                     int base = 10)
+        : integer(ptag{}, s, base)
+    {
+    }
+    /// Constructor from range of characters.
+    /**
+     * This constructor will initialise \p this from the content of the input half-open range,
+     * which is interpreted as the string representation of an integer in base \p base.
+     *
+     * Internally, the constructor will copy the content of the range to a local buffer, add a
+     * string terminator, and invoke the constructor from string.
+     *
+     * @param begin the begin of the input range.
+     * @param end the end of the input range.
+     * @param base the base used in the string representation.
+     *
+     * @throws unspecified any exception thrown by the constructor from string, or by memory
+     * allocation errors in standard containers.
+     */
+    explicit integer(const char *begin, const char *end, int base = 10) : m_int(begin, end, base) {}
+    /// Copy constructor from \p mpz_t.
+    /**
+     * This constructor will initialize \p this with the value of the GMP integer \p n. The storage type of \p this
+     * will be static if \p n fits in the static storage, otherwise it will be dynamic.
+     *
+     * \rststar
+     * .. warning::
+     *
+     *    It is the user's responsibility to ensure that ``n`` has been correctly initialized. Calling this constructor
+     *    with an uninitialized ``n`` results in undefined behaviour.
+     * \endrststar
+     *
+     * @param n the input GMP integer.
+     */
+    explicit integer(const ::mpz_t n) : m_int(n) {}
+#if !defined(_MSC_VER)
+    /// Move constructor from \p mpz_t.
+    /**
+     * This constructor will initialize \p this with the value of the GMP integer \p n, transferring the state
+     * of \p n into \p this. The storage type of \p this
+     * will be static if \p n fits in the static storage, otherwise it will be dynamic.
+     *
+     * \rststar
+     * .. warning::
+     *
+     *    It is the user's responsibility to ensure that ``n`` has been correctly initialized. Calling this constructor
+     *    with an uninitialized ``n`` results in undefined behaviour.
+     *
+     *    Additionally, the user must ensure that, after construction, ``mpz_clear()`` is never
+     *    called on ``n``: the resources previously owned by ``n`` are now owned by ``this``, which
+     *    will take care of releasing them when the destructor is called.
+     *
+     * .. note::
+     *
+     *    Due to a compiler bug, this constructor is not available on Microsoft Visual Studio.
+     * \endrststar
+     *
+     * @param n the input GMP integer.
+     */
+    explicit integer(::mpz_t &&n) : m_int(std::move(n)) {}
+#endif
+    /// Copy assignment operator.
+    /**
+     * This operator will perform a deep copy of \p other, copying its storage type as well.
+     *
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     */
+    integer &operator=(const integer &other) = default;
+    /// Move assignment operator.
+    /**
+     * After the move, \p other will be in an unspecified but valid state, and the storage type of \p this will be
+     * <tt>other</tt>'s original storage type.
+     *
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     */
+    integer &operator=(integer &&other) = default;
+#if defined(MPPP_ENABLE_EXPRESSION_TEMPLATES)
+    /// Assignment from a product expression.
+    /**
+     * \rststar
+     * This operator is available only if the ``MPPP_ENABLE_EXPRESSION_TEMPLATES`` macro is defined. It will
+     * compute the product ``a * b`` directly into ``this``, via :cpp:func:`~mppp::mul()`.
+     * \endrststar
+     *
+     * @param e the product expression.
+     *
+     * @return a reference to \p this.
+     */
+    integer &operator=(const integer_mul_expr<SSize> &e)
+    {
+        e.eval(*this);
+        return *this;
+    }
+    /// Assignment from a fused multiply-add expression.
+    /**
+     * \rststar
+     * This operator is available only if the ``MPPP_ENABLE_EXPRESSION_TEMPLATES`` macro is defined. Expressions such
+     * as ``a * b + c`` or ``a * b - c * d`` are evaluated directly into ``this``, via :cpp:func:`~mppp::mul()`,
+     * :cpp:func:`~mppp::addmul()` and :cpp:func:`~mppp::submul()`.
+     * \endrststar
+     *
+     * @param e the fused multiply-add expression.
+     *
+     * @return a reference to \p this.
+     */
+    integer &operator=(const integer_fma_expr<SSize> &e)
+    {
+        e.eval(*this);
+        return *this;
+    }
+#endif
+/// Generic assignment operator.
+/**
+ * \rststar
+ * The body of this operator is equivalent to:
+ *
+ * .. code-block:: c++
+ *
+ *    return *this = integer{x};
+ *
+ * That is, a temporary integer is constructed from ``x`` and it is then move-assigned to ``this``.
+ * \endrststar
+ *
+ * @param x the assignment argument.
+ *
+ * @return a reference to \p this.
+ *
+ * @throws unspecified any exception thrown by the generic constructor.
+ */
+#if defined(MPPP_HAVE_CONCEPTS)
+    integer &operator=(const CppInteroperable &x)
+#else
+    template <typename T, cpp_interoperable_enabler<T> = 0>
+    integer &operator=(const T &x)
+#endif
+    {
+        return *this = integer{x};
+    }
+        /// Assignment from string.
+        /**
+         * \rststar
+         * The body of this operator is equivalent to:
+         *
+         * .. code-block:: c++
+         *
+         *    return *this = integer{s};
+         *
+         * That is, a temporary integer is constructed from the :cpp:concept:`~mppp::StringType`
+         * ``s`` and it is then move-assigned to ``this``.
+         * \endrststar
+         *
+         * @param s the string that will be used for the assignment.
+         *
+         * @return a reference to \p this.
+         *
+         * @throws unspecified any exception thrown by the constructor from string.
+         */
+#if defined(MPPP_HAVE_CONCEPTS)
+    integer &operator=(const StringType &s)
+#else
+    template <typename T, string_type_enabler<T> = 0>
+    integer &operator=(const T &s)
+#endif
+    {
+        return *this = integer{s};
+    }
+    /// Copy assignment from \p mpz_t.
+    /**
+     * This assignment operator will copy into \p this the value of the GMP integer \p n. The storage type of \p this
+     * after the assignment will be static if \p n fits in the static storage, otherwise it will be dynamic.
+     *
+     * \rststar
+     * .. warning::
+     *
+     *    It is the user's responsibility to ensure that ``n`` has been correctly initialized. Calling this operator
+     *    with an uninitialized ``n`` results in undefined behaviour. Also, no aliasing is allowed: the data in ``n``
+     *    must be completely distinct from the data in ``this`` (e.g., if ``n`` is an ``mpz_view`` of ``this`` then
+     *    it might point to internal data of ``this``, and the behaviour of this operator will thus be undefined).
+     * \endrststar
+     *
+     * @param n the input GMP integer.
+     *
+     * @return a reference to \p this.
+     */
+    integer &operator=(const ::mpz_t n)
+    {
+        const auto asize = get_mpz_size(n);
+        const auto s = is_static();
+        if (s && asize <= SSize) {
+            // this is static, n fits into static. Copy over.
+            m_int.g_st()._mp_size = n->_mp_size;
+            copy_limbs_no(n->_mp_d, n->_mp_d + asize, m_int.g_st().m_limbs.data());
+            if (SSize <= static_int<SSize>::opt_size) {
+                // Zero the non-copied limbs, but only if the static size is not greater than
+                // the size for which special optimisations kick in. See the documentation
+                // of zero_unused_limbs().
+                std::fill(m_int.g_st().m_limbs.begin() + asize, m_int.g_st().m_limbs.end(), ::mp_limb_t(0));
+            }
+        } else if (!s && asize > SSize) {
+            // Dynamic to dynamic.
+            ::mpz_set(&m_int.m_dy, n);
+        } else if (s && asize > SSize) {
+            // this is static, n is too big. Promote and assign.
+            // Destroy static.
+            m_int.g_st().~s_storage();
+            // Init dynamic.
+            ::new (static_cast<void *>(&m_int.m_dy)) d_storage;
+            mpz_init_set_nlimbs(m_int.m_dy, *n);
+        } else {
+            // This is dynamic and n fits into static.
+            assert(!s && asize <= SSize);
+            // Destroy the dynamic storage.
+            m_int.destroy_dynamic();
+            // Init a static with the content from n.
+            ::new (static_cast<void *>(&m_int.m_st)) s_storage{n->_mp_size, n->_mp_d, asize};
+        }
+        return *this;
+    }
+#if !defined(_MSC_VER)
+    /// Move assignment from \p mpz_t.
+    /**
+     * This assignment operator will move into \p this the GMP integer \p n. The storage type of \p this
+     * after the assignment will be static if \p n fits in the static storage, otherwise it will be dynamic.
+     *
+     * \rststar
+     * .. warning::
+     *
+     *    It is the user's responsibility to ensure that ``n`` has been correctly initialized. Calling this operator
+     *    with an uninitialized ``n`` results in undefined behaviour. Also, no aliasing is allowed: the data in ``n``
+     *    must be completely distinct from the data in ``this`` (e.g., if ``n`` is an ``mpz_view`` of ``this`` then
+     *    it might point to internal data of ``this``, and the behaviour of this operator will thus be undefined).
+     *
+     *    Additionally, the user must ensure that, after the assignment, ``mpz_clear()`` is never
+     *    called on ``n``: the resources previously owned by ``n`` are now owned by ``this``, which
+     *    will take care of releasing them when the destructor is called.
+     *
+     * .. note::
+     *
+     *    Due to a compiler bug, this operator is not available on Microsoft Visual Studio.
+     * \endrststar
+     *
+     * @param n the input GMP integer.
+     *
+     * @return a reference to \p this.
+     */
+    integer &operator=(::mpz_t &&n)
+    {
+        const auto asize = get_mpz_size(n);
+        const auto s = is_static();
+        if (s && asize <= SSize) {
+            // this is static, n fits into static. Copy over.
+            m_int.g_st()._mp_size = n->_mp_size;
+            copy_limbs_no(n->_mp_d, n->_mp_d + asize, m_int.g_st().m_limbs.data());
+            if (SSize <= static_int<SSize>::opt_size) {
+                // Zero the non-copied limbs, but only if the static size is not greater than
+                // the size for which special optimisations kick in. See the documentation
+                // of zero_unused_limbs().
+                std::fill(m_int.g_st().m_limbs.begin() + asize, m_int.g_st().m_limbs.end(), ::mp_limb_t(0));
+            }
+            // Clear out n.
+            mpz_clear_wrap(*n);
+        } else if (!s && asize > SSize) {
+            // Dynamic to dynamic: clear this, shallow copy n.
+            mpz_clear_wrap(m_int.m_dy);
+            m_int.m_dy = *n;
+        } else if (s && asize > SSize) {
+            // this is static, n is too big. Promote and assign.
+            // Destroy static.
+            m_int.g_st().~s_storage();
+            // Init dynamic with a shallow copy.
+            ::new (static_cast<void *>(&m_int.m_dy)) d_storage(*n);
+        } else {
+            // This is dynamic and n fits into static.
+            assert(!s && asize <= SSize);
+            // Destroy the dynamic storage.
+            m_int.destroy_dynamic();
+            // Init a static with the content from n.
+            ::new (static_cast<void *>(&m_int.m_st)) s_storage{n->_mp_size, n->_mp_d, asize};
+            // Clear out n.
+            mpz_clear_wrap(*n);
+        }
+        return *this;
+    }
+#endif
+    /// Set to zero.
+    /**
+     * After calling this method, the storage type of \p this will be static and its value will be zero.
+     *
+     * \rststar
+     * .. note::
+     *
+     *   This is a specialised higher-performance alternative to the assignment operator.
+     * \endrststar
+     *
+     * @return a reference to \p this.
+     */
+    integer &set_zero()
+    {
+        if (is_static()) {
+            m_int.g_st()._mp_size = 0;
+            // Zero out the whole limbs array (equivalent to the def ctor of static int).
+            std::fill(m_int.g_st().m_limbs.begin(), m_int.g_st().m_limbs.end(), ::mp_limb_t(0));
+        } else {
+            m_int.destroy_dynamic();
+            // Def construction of static results in zero.
+            ::new (static_cast<void *>(&m_int.m_st)) s_storage();
+        }
+        return *this;
+    }
+
+private:
+    template <bool PlusOrMinus>
+    integer &set_one_impl()
+    {
+        if (is_static()) {
+            m_int.g_st()._mp_size = PlusOrMinus ? 1 : -1;
+            m_int.g_st().m_limbs[0] = 1;
+            // Zero the unused limbs, for the usual reason that optimised implementations
+            // expect zeroes in unused limbs.
+            std::fill(m_int.g_st().m_limbs.begin() + 1, m_int.g_st().m_limbs.end(), ::mp_limb_t(0));
+        } else {
+            m_int.destroy_dynamic();
+            // Construct from a single limb the static. This will zero any unused limb.
+            ::new (static_cast<void *>(&m_int.m_st)) s_storage{PlusOrMinus ? 1 : -1, 1u};
+        }
+        return *this;
+    }
+
+public:
+    /// Set to one.
+    /**
+     * After calling this method, the storage type of \p this will be static and its value will be one.
+     *
+     * \rststar
+     * .. note::
+     *
+     *   This is a specialised higher-performance alternative to the assignment operator.
+     * \endrststar
+     *
+     * @return a reference to \p this.
+     */
+    integer &set_one()
+    {
+        return set_one_impl<true>();
+    }
+    /// Set to minus one.
+    /**
+     * After calling this method, the storage type of \p this will be static and its value will be minus one.
+     *
+     * \rststar
+     * .. note::
+     *
+     *   This is a specialised higher-performance alternative to the assignment operator.
+     * \endrststar
+     *
+     * @return a reference to \p this.
+     */
+    integer &set_negative_one()
+    {
+        return set_one_impl<false>();
+    }
+    /// Test for static storage.
+    /**
+     * @return \p true if the storage type is static, \p false otherwise.
+     */
+    bool is_static() const
+    {
+        return m_int.is_static();
+    }
+    /// Check for dynamic storage.
+    /**
+     * @return \p true if the storage type is dynamic, \p false otherwise.
+     */
+    bool is_dynamic() const
+    {
+        return m_int.is_dynamic();
+    }
+    /// Conversion to string.
+    /**
+     * This method will convert \p this into a string in base \p base using the GMP function \p mpz_get_str().
+     *
+     * @param base the desired base.
+     *
+     * @return a string representation of \p this.
+     *
+     * @throws std::invalid_argument if \p base is smaller than 2 or greater than 62.
+     *
+     * \rststar
+     * .. seealso::
+     *
+     *    https://gmplib.org/manual/Converting-Integers.html
+     * \endrststar
+     */
+    std::string to_string(int base = 10) const
+    {
+        if (mppp_unlikely(base < 2 || base > 62)) {
+            throw std::invalid_argument("Invalid base for string conversion: the base must be between "
+                                        "2 and 62, but a value of "
+                                        + std::to_string(base) + " was provided instead");
+        }
+        return mpz_to_str(get_mpz_view(), base);
+    }
+    // NOTE: maybe provide a method to access the lower-level str conversion that writes to
+    // std::vector<char>?
+
+private:
+    // Conversion to bool.
+    template <typename T, enable_if_t<std::is_same<bool, T>::value, int> = 0>
+    std::pair<bool, T> dispatch_conversion() const
+    {
+        return std::make_pair(true, m_int.m_st._mp_size != 0);
+    }
+    // Implementation of the conversion to unsigned types which fit in a limb.
+    template <typename T, bool Sign, enable_if_t<(std::numeric_limits<T>::digits <= GMP_NUMB_BITS), int> = 0>
+    std::pair<bool, T> convert_to_unsigned() const
+    {
+        static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "Invalid type.");
+        assert((Sign && m_int.m_st._mp_size > 0) || (!Sign && m_int.m_st._mp_size < 0));
+        if ((Sign && m_int.m_st._mp_size != 1) || (!Sign && m_int.m_st._mp_size != -1)) {
+            // If the asize is not 1, the conversion will fail.
+            return std::make_pair(false, T(0));
+        }
+        // Get the pointer to the limbs.
+        const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
+        if ((ptr[0] & GMP_NUMB_MASK) > std::numeric_limits<T>::max()) {
+            // The only limb has a value which exceeds the limit of T.
+            return std::make_pair(false, T(0));
+        }
+        // There's a single limb and the result fits.
+        return std::make_pair(true, static_cast<T>(ptr[0] & GMP_NUMB_MASK));
+    }
+    // Implementation of the conversion to unsigned types which do not fit in a limb.
+    template <typename T, bool Sign, enable_if_t<(std::numeric_limits<T>::digits > GMP_NUMB_BITS), int> = 0>
+    std::pair<bool, T> convert_to_unsigned() const
+    {
+        static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "Invalid type.");
+        assert((Sign && m_int.m_st._mp_size > 0) || (!Sign && m_int.m_st._mp_size < 0));
+        const auto asize = Sign ? static_cast<std::size_t>(m_int.m_st._mp_size)
+                                : static_cast<std::size_t>(nint_abs(m_int.m_st._mp_size));
+        // Get the pointer to the limbs.
+        const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
+        // Init the retval with the first limb. This is safe as T has more bits than the limb type.
+        auto retval = static_cast<T>(ptr[0] & GMP_NUMB_MASK);
+        // Add the other limbs, if any.
+        constexpr unsigned u_bits = std::numeric_limits<T>::digits;
+        unsigned shift(GMP_NUMB_BITS);
+        for (std::size_t i = 1u; i < asize; ++i, shift += unsigned(GMP_NUMB_BITS)) {
+            if (shift >= u_bits) {
+                // We need to shift left the current limb. If the shift is too large, we run into UB
+                // and it also means that the value does not fit in T.
+                return std::make_pair(false, T(0));
+            }
+            // Get the current limb. Safe as T has more bits than the limb type.
+            const auto l = static_cast<T>(ptr[i] & GMP_NUMB_MASK);
+            // LCOV_EXCL_START
+            if (l >> (u_bits - shift)) {
+                // Left-shifting the current limb is well-defined from the point of view of the language, but the result
+                // overflows: the value does not fit in T.
+                // NOTE: I suspect this branch can be triggered on common architectures only with nail builds.
+                return std::make_pair(false, T(0));
+            }
+            // LCOV_EXCL_STOP
+            // This will not overflow, as there is no carry from retval and l << shift is fine.
+            retval = static_cast<T>(retval + (l << shift));
+        }
+        return std::make_pair(true, retval);
+    }
+    // Conversion to unsigned ints, excluding bool.
+    template <typename T,
+              enable_if_t<conjunction<std::is_integral<T>, std::is_unsigned<T>, negation<std::is_same<bool, T>>>::value,
+                          int> = 0>
+    std::pair<bool, T> dispatch_conversion() const
+    {
+        // Handle zero.
+        if (!m_int.m_st._mp_size) {
+            return std::make_pair(true, T(0));
+        }
+        // Handle negative value.
+        if (m_int.m_st._mp_size < 0) {
+            return std::make_pair(false, T(0));
+        }
+        return convert_to_unsigned<T, true>();
+    }
+    // Conversion to signed ints.
+    //
+    // NOTE: the implementation of conversion to signed at the moment is split into 2 branches:
+    // a specialised implementation for T not larger than the limb type, and a slower implementation
+    // for T larger than the limb type. The slower implementation is based on the conversion
+    // to the unsigned counterpart of T, and it can probably be improved performance-wise.
+    //
+    // Helper type trait to detect conversion to small signed integers (i.e., the absolute values of T fit
+    // into a limb). We need this instead of just typedeffing an std::integral_constant because MSVC
+    // chokes on constexpr functions in a SFINAE context.
+    template <typename T>
+    struct sconv_is_small {
+        static const bool value = c_max(static_cast<make_unsigned_t<T>>(std::numeric_limits<T>::max()),
+                                        nint_abs(std::numeric_limits<T>::min()))
+                                  <= GMP_NUMB_MAX;
+    };
+    // Overload if the all the absolute values of T fit into a limb.
+    template <typename T, enable_if_t<sconv_is_small<T>::value, int> = 0>
+    std::pair<bool, T> convert_to_signed() const
+    {
+        static_assert(std::is_integral<T>::value && std::is_signed<T>::value, "Invalid type.");
+        assert(size());
+        // Cache for convenience.
+        constexpr auto Tmax = static_cast<make_unsigned_t<T>>(std::numeric_limits<T>::max());
+        if (m_int.m_st._mp_size != 1 && m_int.m_st._mp_size != -1) {
+            // this consists of more than 1 limb, the conversion is not possible.
+            return std::make_pair(false, T(0));
+        }
+        // Get the pointer to the limbs.
+        const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
+        // The candidate output value.
+        const ::mp_limb_t candidate = ptr[0] & GMP_NUMB_MASK;
+        // Branch out on the sign.
+        if (m_int.m_st._mp_size > 0) {
+            // This is positive, it needs to fit within max().
+            if (candidate <= Tmax) {
+                return std::make_pair(true, static_cast<T>(candidate));
+            }
+            return std::make_pair(false, T(0));
+        } else {
+            return unsigned_to_nsigned<T>(candidate);
+        }
+    }
+    // Overload if not all the absolute values of T fit into a limb.
+    template <typename T, enable_if_t<!sconv_is_small<T>::value, int> = 0>
+    std::pair<bool, T> convert_to_signed() const
+    {
+        // Cache for convenience.
+        constexpr auto Tmax = static_cast<make_unsigned_t<T>>(std::numeric_limits<T>::max());
+        // Branch out depending on the sign of this.
+        if (m_int.m_st._mp_size > 0) {
+            // Attempt conversion to the unsigned counterpart.
+            const auto candidate = convert_to_unsigned<make_unsigned_t<T>, true>();
+            if (candidate.first && candidate.second <= Tmax) {
+                // The conversion to unsigned was successful, and the result fits in
+                // the positive range of T. Return the result.
+                return std::make_pair(true, static_cast<T>(candidate.second));
+            }
+            // The conversion to unsigned failed, or the result does not fit.
+            return std::make_pair(false, T(0));
+        } else {
+            // Attempt conversion to the unsigned counterpart.
+            const auto candidate = convert_to_unsigned<make_unsigned_t<T>, false>();
+            if (candidate.first) {
+                // The converstion to unsigned was successful, try to negate now.
+                return unsigned_to_nsigned<T>(candidate.second);
+            }
+            // The conversion to unsigned failed.
+            return std::make_pair(false, T(0));
+        }
+    }
+    template <typename T, enable_if_t<conjunction<std::is_integral<T>, std::is_signed<T>>::value, int> = 0>
+    std::pair<bool, T> dispatch_conversion() const
+    {
+        // Handle zero.
+        if (!m_int.m_st._mp_size) {
+            return std::make_pair(true, T(0));
+        }
+        return convert_to_signed<T>();
+    }
+    // Implementation of the conversion to floating-point through GMP/MPFR routines.
+    template <typename T, enable_if_t<disjunction<std::is_same<T, float>, std::is_same<T, double>>::value, int> = 0>
+    static std::pair<bool, T> mpz_float_conversion(const mpz_struct_t &m)
+    {
+        return std::make_pair(true, static_cast<T>(::mpz_get_d(&m)));
+    }
+#if defined(MPPP_WITH_MPFR)
+    template <typename T, enable_if_t<std::is_same<T, long double>::value, int> = 0>
+    static std::pair<bool, T> mpz_float_conversion(const mpz_struct_t &m)
+    {
+        constexpr int d2 = std::numeric_limits<long double>::max_digits10 * 4;
+        MPPP_MAYBE_TLS mpfr_raii mpfr(static_cast<::mpfr_prec_t>(d2));
+        ::mpfr_set_z(&mpfr.m_mpfr, &m, MPFR_RNDN);
+        return std::make_pair(true, ::mpfr_get_ld(&mpfr.m_mpfr, MPFR_RNDN));
+    }
+#endif
+    // Conversion to floating-point.
+    template <typename T, enable_if_t<std::is_floating_point<T>::value, int> = 0>
+    std::pair<bool, T> dispatch_conversion() const
+    {
+        // Handle zero.
+        if (!m_int.m_st._mp_size) {
+            return std::make_pair(true, T(0));
+        }
+        if (std::numeric_limits<T>::is_iec559) {
+            // Optimization for single-limb integers.
+            //
+            // NOTE: the reasoning here is as follows. If the floating-point type has infinity,
+            // then its "range" is the whole real line. The C++ standard guarantees that:
+            // """
+            // A prvalue of an integer type or of an unscoped enumeration type can be converted to a prvalue of a
+            // floating point type. The result is exact if possible. If the value being converted is in the range
+            // of values that can be represented but the value cannot be represented exactly,
+            // it is an implementation-defined choice of either the next lower or higher representable value. If the
+            // value being converted is outside the range of values that can be represented, the behavior is undefined.
+            // """
+            // This seems to indicate that if the limb value "overflows" the finite range of the floating-point type, we
+            // will get either the max/min finite value or +-inf. Additionally, the IEEE standard seems to indicate
+            // that an overflowing conversion will produce infinity:
+            // http://stackoverflow.com/questions/40694384/integer-to-float-conversions-with-ieee-fp
+            //
+            // Get the pointer to the limbs.
+            const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
+            if (m_int.m_st._mp_size == 1) {
+                return std::make_pair(true, static_cast<T>(ptr[0] & GMP_NUMB_MASK));
+            }
+            if (m_int.m_st._mp_size == -1) {
+                return std::make_pair(true, -static_cast<T>(ptr[0] & GMP_NUMB_MASK));
+            }
+        }
+        // For all the other cases, just delegate to the GMP/MPFR routines.
+        return mpz_float_conversion<T>(*static_cast<const mpz_struct_t *>(get_mpz_view()));
+    }
+
+public:
+/// Generic conversion operator.
+/**
+ * \rststar
+ * This operator will convert ``this`` to a :cpp:concept:`~mppp::CppInteroperable` type.
+ * Conversion to ``bool`` yields ``false`` if ``this`` is zero,
+ * ``true`` otherwise. Conversion to other integral types yields the exact result, if representable by the target
+ * :cpp:concept:`~mppp::CppInteroperable` type. Conversion to floating-point types might yield inexact values and
+ * infinities.
+ * \endrststar
+ *
+ * @return \p this converted to the target type.
+ *
+ * @throws std::overflow_error if the target type is an integral type and the value of ``this`` cannot be represented by
+ * it.
+ */
+#if defined(MPPP_HAVE_CONCEPTS)
+    template <CppInteroperable T>
+#else
+    template <typename T, cpp_interoperable_enabler<T> = 0>
+#endif
+    explicit operator T() const
+    {
+        auto retval = dispatch_conversion<T>();
+        if (mppp_unlikely(!retval.first)) {
+            throw std::overflow_error("Conversion of the integer " + to_string() + " to the type " + typeid(T).name()
+                                      + " results in overflow");
+        }
+        return std::move(retval.second);
+    }
+#if defined(MPPP_HAVE_INT128_INTEROP)
+
+private:
+    // The absolute value of this as a 128-bit unsigned integer. Only the two least significant
+    // limbs are considered.
+    MPPP_UINT128 int128_abs_value() const
+    {
+        const auto asize = size();
+        const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
+        return asize ? ((asize > 1u ? static_cast<MPPP_UINT128>(ptr[1]) << 64 : MPPP_UINT128(0)) | ptr[0])
+                     : MPPP_UINT128(0);
+    }
+    // Conversion to the 128-bit integral types: a single check on the size, then the limbs
+    // are read back directly.
+    template <typename T, enable_if_t<std::is_same<T, MPPP_UINT128>::value, int> = 0>
+    std::pair<bool, T> dispatch_int128_conversion() const
+    {
+        const auto size = m_int.m_st._mp_size;
+        if (size < 0 || size > 2) {
+            return std::make_pair(false, T(0));
+        }
+        return std::make_pair(true, int128_abs_value());
+    }
+    template <typename T, enable_if_t<std::is_same<T, MPPP_INT128>::value, int> = 0>
+    std::pair<bool, T> dispatch_int128_conversion() const
+    {
+        const auto size = m_int.m_st._mp_size;
+        if (size < -2 || size > 2) {
+            return std::make_pair(false, T(0));
+        }
+        // The largest positive value is 2**127 - 1, the largest absolute value of a negative value is 2**127.
+        constexpr auto int128_max = static_cast<MPPP_UINT128>(-1) >> 1;
+        const auto u = int128_abs_value();
+        if (size >= 0) {
+            return u > int128_max ? std::make_pair(false, T(0)) : std::make_pair(true, static_cast<T>(u));
+        }
+        return u > int128_max + 1u ? std::make_pair(false, T(0))
+                                   : std::make_pair(true, static_cast<T>(-static_cast<T>(u - 1u) - 1));
+    }
+
+public:
+    /// Conversion operator to 128-bit integral types.
+    /**
+     * This operator is enabled only if \p T is either \p __int128_t or \p __uint128_t. It is available
+     * only if the \p MPPP_HAVE_INT128_INTEROP macro is defined.
+     *
+     * @return \p this converted to \p T.
+     *
+     * @throws std::overflow_error if the value of \p this cannot be represented by \p T.
+     */
+    template <typename T, enable_if_t<is_integer_int128<T>::value, int> = 0>
+    explicit operator T() const
+    {
+        const auto retval = dispatch_int128_conversion<T>();
+        if (mppp_unlikely(!retval.first)) {
+            throw std::overflow_error("Conversion of the integer " + to_string() + " to the type " + typeid(T).name()
+                                      + " results in overflow");
+        }
+        return retval.second;
+    }
+#endif
+        /// Generic conversion method.
+        /**
+         * \rststar
+         * This method, similarly to the conversion operator, will convert ``this`` to a
+         * :cpp:concept:`~mppp::CppInteroperable` type, storing the result of the conversion into ``rop``. Differently
+         * from the conversion operator, this method does not raise any exception: if the conversion is successful, the
+         * method will return ``true``, otherwise the method will return ``false``. If the conversion fails,
+         * ``rop`` will not be altered.
+         * \endrststar
+         *
+         * @param rop the variable which will store the result of the conversion.
+         *
+         * @return ``true`` if the conversion succeeded, ``false`` otherwise. The conversion can fail only if ``rop`` is
+         * a C++ integral which cannot represent the value of ``this``.
+         */
+#if defined(MPPP_HAVE_CONCEPTS)
+    template <CppInteroperable T>
+#else
+    template <typename T, cpp_interoperable_enabler<T> = 0>
+#endif
+    bool get(T &rop) const
+    {
+        auto retval = dispatch_conversion<T>();
+        if (retval.first) {
+            rop = std::move(retval.second);
+            return true;
+        }
+        return false;
+    }
+    /// Promote to dynamic storage.
+    /**
+     * This method will promote the storage type of \p this from static to dynamic.
+     *
+     * @return \p false if the storage type of \p this is already dynamic and no promotion takes place, \p true
+     * otherwise.
+     */
+    bool promote()
+    {
+        if (is_static()) {
+            m_int.promote();
+            return true;
+        }
+        return false;
+    }
+    /// Demote to static storage.
+    /**
+     * This method will demote the storage type of \p this from dynamic to static.
+     *
+     * @return \p false if the storage type of \p this is already static and no demotion takes place, or if the current
+     * value of \p this does not fit in static storage, \p true otherwise.
+     */
+    bool demote()
+    {
+        if (is_dynamic()) {
+            return m_int.demote();
+        }
+        return false;
+    }
+    /// Reserve storage.
+    /**
+     * This method will make sure that \p this can hold values of at least \p nbits bits without further
+     * memory allocations. If \p nbits exceeds the capacity of the static storage, \p this will be promoted
+     * to dynamic storage. If \p this is already dynamic, its storage will be enlarged if needed.
+     * The value of \p this is never altered, and the storage is never shrunk.
+     *
+     * @param nbits the number of bits to reserve.
+     *
+     * @throws std::overflow_error if \p nbits is larger than an implementation-defined value.
+     */
+    void reserve(std::size_t nbits)
+    {
+        const auto nlimbs
+            = nbits / unsigned(GMP_NUMB_BITS) + static_cast<std::size_t>(nbits % unsigned(GMP_NUMB_BITS) != 0u);
+        if (mppp_unlikely(nlimbs > static_cast<make_unsigned_t<mpz_size_t>>(std::numeric_limits<mpz_size_t>::max())
+                          || nbits > std::numeric_limits<::mp_bitcnt_t>::max())) {
+            throw std::overflow_error("Cannot reserve " + std::to_string(nbits) + " bits of storage for an integer");
+        }
+        if (is_static()) {
+            if (nlimbs > SSize) {
+                m_int.promote(nlimbs);
+            }
+        } else if (nlimbs > static_cast<std::size_t>(m_int.g_dy()._mp_alloc)) {
+            ::mpz_realloc2(&m_int.g_dy(), static_cast<::mp_bitcnt_t>(nlimbs * unsigned(GMP_NUMB_BITS)));
+        }
+    }
+    /// Storage capacity.
+    /**
+     * @return the number of bits that \p this can hold without further memory allocations. For static
+     * storage, this is the size in bits of the static storage.
+     */
+    std::size_t capacity() const
+    {
+        return (is_static() ? SSize : static_cast<std::size_t>(m_int.g_dy()._mp_alloc)) * unsigned(GMP_NUMB_BITS);
+    }
+    /// Release unused storage.
+    /**
+     * If \p this is dynamic, this method will shrink its storage to the minimum number of limbs needed to
+     * represent its current value. The storage type of \p this is not changed (see demote() for the
+     * conversion to static storage). If \p this is static, this method has no effect.
+     */
+    void shrink_to_fit()
+    {
+        if (is_dynamic()) {
+            // NOTE: mpz_realloc2() always allocates at least one limb.
+            const auto asize = size();
+            if (static_cast<std::size_t>(m_int.g_dy()._mp_alloc) > (asize ? asize : 1u)) {
+                ::mpz_realloc2(&m_int.g_dy(), static_cast<::mp_bitcnt_t>(asize * unsigned(GMP_NUMB_BITS)));
+            }
+        }
+    }
+    /// Size in bits.
+    /**
+     * @return the number of bits needed to represent \p this. If \p this is zero, zero will be returned.
+     *
+     * @throws std::overflow_error if the size in bits of \p this is larger than an implementation-defined value.
+     */
+    std::size_t nbits() const
+    {
+#if defined(__clang__) || defined(__GNUC__)
+        const std::size_t ls = size();
+        const ::mp_limb_t *lptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
+        if (ls) {
+            // LCOV_EXCL_START
+            if (mppp_unlikely(ls > std::numeric_limits<std::size_t>::max() / unsigned(GMP_NUMB_BITS))) {
+                throw std::overflow_error("Overflow in the computation of the number of bits required to represent an "
+                                          "integer - the limb size is "
+                                          + std::to_string(ls));
+            }
+            // LCOV_EXCL_STOP
+            // Index of the most significant limb.
+            const std::size_t idx = ls - 1u;
+            // The most significant limb.
+            const ::mp_limb_t msl = lptr[idx] & GMP_NUMB_MASK;
+            // NOTE: here we need std::numeric_limits<::mp_limb_t>::digits (instead of GMP_NUMB_BITS) because
+            // builtin_clz() counts zeroes also in the nail bits.
+            return static_cast<std::size_t>(idx * unsigned(GMP_NUMB_BITS)
+                                            + (unsigned(std::numeric_limits<::mp_limb_t>::digits) - builtin_clz(msl)));
+        }
+        return 0;
+#else
+        return m_int.m_st._mp_size ? ::mpz_sizeinbase(get_mpz_view(), 2) : 0u;
+#endif
+    }
+    /// Size in limbs.
+    /**
+     * @return the number of limbs needed to represent \p this. If \p this is zero, zero will be returned.
+     */
+    std::size_t size() const
+    {
+        return (m_int.m_st._mp_size) >= 0 ? static_cast<std::size_t>(m_int.m_st._mp_size)
+                                          : static_cast<std::size_t>(nint_abs(m_int.m_st._mp_size));
+    }
+    /// Sign.
+    /**
+     * @return 0 if \p this is zero, 1 if \p this is positive, -1 if \p this is negative.
+     */
+    int sgn() const
+    {
+        // NOTE: size is part of the common initial sequence.
+        if (m_int.m_st._mp_size != 0) {
+            return m_int.m_st._mp_size > 0 ? 1 : -1;
+        } else {
+            return 0;
+        }
+    }
+    /// Get an \p mpz_t view.
+    /**
+     * This method will return an object of an unspecified type \p mpz_view which is implicitly convertible
+     * to a const pointer to an \p mpz_t struct (and which can thus be used as a <tt>const mpz_t</tt>
+     * parameter in GMP functions). In addition to the implicit conversion operator, the <tt>const mpz_t</tt>
+     * object can also be retrieved via the <tt>get()</tt> method of the \p mpz_view class.
+     * The view provides a read-only GMP-compatible representation of the integer stored in \p this.
+     *
+     * \rststar
+     * .. note::
+     *
+     *   It is important to keep in mind the following facts about the returned ``mpz_view`` object:
+     *
+     *   * ``mpz_view`` objects are strictly read-only: it is impossible to alter ``this`` through an ``mpz_view``, and
+     *     ``mpz_view`` objects can be used in the GMP API only where a ``const mpz_t`` parameter is expected;
+     *   * ``mpz_view`` objects can only be move-constructed (the other constructors and the assignment operators
+     *     are disabled);
+     *   * the returned object and the pointer returned by its ``get()`` method might reference internal data
+     *     belonging to ``this``, and they can thus be used safely only during the lifetime of ``this``;
+     *   * the lifetime of the pointer returned by the ``get()`` method is tied to the lifetime of the ``mpz_view``
+     *     object (that is, if the ``mpz_view`` object is destroyed, any pointer previously returned by ``get()``
+     *     becomes invalid);
+     *   * any modification to ``this`` will also invalidate the view and the pointer.
+     * \endrststar
+     *
+     * @return an \p mpz view of \p this.
+     */
+    mpz_view get_mpz_view() const
+    {
+        return mpz_view(*this);
+    }
+    /// Negate in-place.
+    /**
+     * This method will set \p this to <tt>-this</tt>.
+     *
+     * @return a reference to \p this.
+     */
+    integer &neg()
+    {
+        m_int.neg();
+        return *this;
+    }
+    /// In-place absolute value.
+    /**
+     * This method will set \p this to its absolute value.
+     *
+     * @return a reference to \p this.
+     */
+    integer &abs()
     {
         if (is_static()) {
             if (m_int.g_st()._mp_size < 0) {
                 m_int.g_st()._mp_size = -m_int.g_st()._mp_size;
             }
         } else {
-            ::mpz_abs(&m_int.g_dy(), &m_int.g_dy());
+            ::mpz_abs(&m_int.g_dy(), &m_int.g_dy());
+        }
+        return *this;
+    }
+    /// Compute next prime number (in-place version).
+    /**
+     * This method will set \p this to the first prime number greater than the current value.
+     *
+     * @return a reference to \p this.
+     */
+    integer &nextprime()
+    {
+        nextprime_impl(*this, *this);
+        return *this;
+    }
+    /// Test primality.
+    /**
+     * This method will run a series of probabilistic tests to determine if \p this is a prime number.
+     * It will return \p 2 if \p this is definitely a prime, \p 1 if \p this is probably a prime and \p 0 if \p this
+     * is definitely not-prime.
+     *
+     * \rststar
+     * If the storage type is static and the value fits in 2 limbs, an optimised implementation is used on 64-bit
+     * architectures supporting 128-bit integers: single-limb values are tested deterministically (via trial division
+     * and a Miller-Rabin test with a fixed set of bases), while 2-limb values undergo trial division and the
+     * Baillie-PSW test. In these cases, ``reps`` is ignored.
+     * \endrststar
+     *
+     * @param reps the number of tests to run.
+     *
+     * @return an integer indicating if \p this is a prime.
+     *
+     * @throws std::invalid_argument if \p reps is less than 1 or if \p this is negative.
+     */
+    int probab_prime_p(int reps = 25) const
+    {
+        if (mppp_unlikely(reps < 1)) {
+            throw std::invalid_argument("The number of primality tests must be at least 1, but a value of "
+                                        + std::to_string(reps) + " was provided instead");
+        }
+        if (mppp_unlikely(sgn() < 0)) {
+            throw std::invalid_argument("Cannot run primality tests on the negative number " + to_string());
+        }
+        if (is_static()) {
+            const auto ret = static_probab_prime_p(m_int.g_st());
+            if (ret >= 0) {
+                return ret;
+            }
+        }
+        return ::mpz_probab_prime_p(get_mpz_view(), reps);
+    }
+    /// Integer square root (in-place version).
+    /**
+     * This method will set \p this to its integer square root.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws std::domain_error if \p this is negative.
+     */
+    integer &sqrt()
+    {
+        mppp::sqrt(*this, *this);
+        return *this;
+    }
+    /// Test if value is odd.
+    /**
+     * @return \p true if \p this is odd, \p false otherwise.
+     */
+    bool odd_p() const
+    {
+        if (is_static()) {
+            // NOTE: as usual we assume that a zero static integer has all limbs set to zero.
+            return (m_int.g_st().m_limbs[0] & GMP_NUMB_MASK) & ::mp_limb_t(1);
+        }
+        return mpz_odd_p(&m_int.g_dy());
+    }
+    /// Test if value is even.
+    /**
+     * @return \p true if \p this is even, \p false otherwise.
+     */
+    bool even_p() const
+    {
+        return !odd_p();
+    }
+    /// Return a reference to the internal union.
+    /**
+     * This method returns a reference to the union used internally to implement the integer class.
+     *
+     * @return a reference to the internal union member.
+     */
+    integer_union<SSize> &_get_union()
+    {
+        return m_int;
+    }
+    /// Return a const reference to the internal union.
+    /**
+     * This method returns a const reference to the union used internally to implement the integer class.
+     *
+     * @return a const reference to the internal union member.
+     */
+    const integer_union<SSize> &_get_union() const
+    {
+        return m_int;
+    }
+    /// Get a pointer to the dynamic storage.
+    /**
+     * This method will first promote \p this to dynamic storage (if \p this is not already employing dynamic storage),
+     * and it will then return a pointer to the internal \p mpz_t structure. The returned pointer can be used as an
+     * argument for the functions of the GMP API.
+     *
+     * \rststar
+     * .. note::
+     *
+     *    The returned pointer is a raw, non-owning pointer tied to the lifetime of ``this``. Calling
+     *    :cpp:func:`~mppp::integer::demote()` or
+     *    assigning an :cpp:class:`~mppp::integer` with static storage to ``this`` will invalidate the returned
+     *    pointer.
+     * \endrststar
+     *
+     * @return a pointer to the internal \p mpz_t structure.
+     */
+    std::remove_extent<::mpz_t>::type *get_mpz_t()
+    {
+        promote();
+        return &m_int.g_dy();
+    }
+    /// Test if the value is zero.
+    /**
+     * @return \p true if the value represented by \p this is zero, \p false otherwise.
+     */
+    bool is_zero() const
+    {
+        return m_int.m_st._mp_size == 0;
+    }
+
+private:
+    // Implementation of is_one()/is_negative_one().
+    template <int One>
+    bool is_one_impl() const
+    {
+        if (m_int.m_st._mp_size != One) {
+            return false;
+        }
+        // Get the pointer to the limbs.
+        const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
+        return (ptr[0] & GMP_NUMB_MASK) == 1u;
+    }
+
+public:
+    /// Test if the value is equal to one.
+    /**
+     * @return \p true if the value represented by \p this is 1, \p false otherwise.
+     */
+    bool is_one() const
+    {
+        return is_one_impl<1>();
+    }
+    /// Test if the value is equal to minus one.
+    /**
+     * @return \p true if the value represented by \p this is -1, \p false otherwise.
+     */
+    bool is_negative_one() const
+    {
+        return is_one_impl<-1>();
+    }
+
+private:
+    integer_union<SSize> m_int;
+};
+
+#if MPPP_CPLUSPLUS < 201703L
+
+// NOTE: from C++17 static constexpr members are implicitly inline, and it's not necessary
+// any more (actually, it's deprecated) to re-declare them outside the class.
+// https://stackoverflow.com/questions/39646958/constexpr-static-member-before-after-c17
+
+template <std::size_t SSize>
+constexpr std::size_t integer<SSize>::ssize;
+
+#endif
+
+/** @defgroup integer_assignment integer_assignment
+ *  @{
+ */
+
+/// Set to zero.
+/**
+ * After calling this function, the storage type of \p n will be static and its value will be zero.
+ *
+ * \rststar
+ * .. note::
+ *
+ *   This is a specialised higher-performance alternative to the assignment operator.
+ * \endrststar
+ *
+ * @param n the assignment argument.
+ *
+ * @return a reference to \p n.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &set_zero(integer<SSize> &n)
+{
+    return n.set_zero();
+}
+
+/// Set to one.
+/**
+ * After calling this function, the storage type of \p n will be static and its value will be one.
+ *
+ * \rststar
+ * .. note::
+ *
+ *   This is a specialised higher-performance alternative to the assignment operator.
+ * \endrststar
+ *
+ * @param n the assignment argument.
+ *
+ * @return a reference to \p n.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &set_one(integer<SSize> &n)
+{
+    return n.set_one();
+}
+
+/// Set to minus one.
+/**
+ * After calling this function, the storage type of \p n will be static and its value will be minus one.
+ *
+ * \rststar
+ * .. note::
+ *
+ *   This is a specialised higher-performance alternative to the assignment operator.
+ * \endrststar
+ *
+ * @param n the assignment argument.
+ *
+ * @return a reference to \p n.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &set_negative_one(integer<SSize> &n)
+{
+    return n.set_negative_one();
+}
+
+/** @} */
+
+/** @defgroup integer_conversion integer_conversion
+ *  @{
+ */
+
+/// Generic conversion function for \link mppp::integer integer\endlink.
+/**
+ * \rststar
+ * This function will convert the input :cpp:class:`~mppp::integer` ``n`` to a
+ * :cpp:concept:`~mppp::CppInteroperable` type, storing the result of the conversion into ``rop``.
+ * If the conversion is successful, the function
+ * will return ``true``, otherwise the function will return ``false``. If the conversion fails, ``rop`` will
+ * not be altered.
+ * \endrststar
+ *
+ * @param rop the variable which will store the result of the conversion.
+ * @param n the input \link mppp::integer integer\endlink.
+ *
+ * @return ``true`` if the conversion succeeded, ``false`` otherwise. The conversion can fail only if ``rop`` is
+ * a C++ integral which cannot represent the value of ``n``.
+ */
+#if defined(MPPP_HAVE_CONCEPTS)
+template <std::size_t SSize>
+inline bool get(CppInteroperable &rop, const integer<SSize> &n)
+#else
+template <typename T, std::size_t SSize, cpp_interoperable_enabler<T> = 0>
+inline bool get(T &rop, const integer<SSize> &n)
+#endif
+{
+    return n.get(rop);
+}
+
+/** @} */
+
+inline namespace detail
+{
+
+// Machinery for the determination of the result of a binary operation involving integer.
+// Default is empty for SFINAE.
+template <typename, typename, typename = void>
+struct integer_common_type {
+};
+
+template <std::size_t SSize>
+struct integer_common_type<integer<SSize>, integer<SSize>> {
+    using type = integer<SSize>;
+};
+
+template <std::size_t SSize, typename U>
+struct integer_common_type<integer<SSize>, U, enable_if_t<is_supported_integral<U>::value>> {
+    using type = integer<SSize>;
+};
+
+template <std::size_t SSize, typename T>
+struct integer_common_type<T, integer<SSize>, enable_if_t<is_supported_integral<T>::value>> {
+    using type = integer<SSize>;
+};
+
+template <std::size_t SSize, typename U>
+struct integer_common_type<integer<SSize>, U, enable_if_t<is_integer_int128<U>::value>> {
+    using type = integer<SSize>;
+};
+
+template <std::size_t SSize, typename T>
+struct integer_common_type<T, integer<SSize>, enable_if_t<is_integer_int128<T>::value>> {
+    using type = integer<SSize>;
+};
+
+template <std::size_t SSize, typename U>
+struct integer_common_type<integer<SSize>, U, enable_if_t<is_supported_float<U>::value>> {
+    using type = U;
+};
+
+template <std::size_t SSize, typename T>
+struct integer_common_type<T, integer<SSize>, enable_if_t<is_supported_float<T>::value>> {
+    using type = T;
+};
+
+template <typename T, typename U>
+using integer_common_t = typename integer_common_type<T, U>::type;
+
+// Various utilities, concepts, enablers used in both the operators and the functions.
+template <typename T, typename U>
+struct is_same_ssize_integer : std::false_type {
+};
+
+template <std::size_t SSize>
+struct is_same_ssize_integer<integer<SSize>, integer<SSize>> : std::true_type {
+};
+
+template <typename T>
+struct is_integer : std::false_type {
+};
+
+template <std::size_t SSize>
+struct is_integer<integer<SSize>> : std::true_type {
+};
+}
+
+template <typename T, typename U>
+#if defined(MPPP_HAVE_CONCEPTS)
+concept bool IntegerOpTypes = is_same_ssize_integer<T, U>::value
+                              || (is_integer<T>::value && is_integer_op_interoperable<U>::value)
+                              || (is_integer<U>::value && is_integer_op_interoperable<T>::value);
+#else
+using integer_op_types_enabler = enable_if_t<
+    disjunction<is_same_ssize_integer<T, U>, conjunction<is_integer<T>, is_integer_op_interoperable<U>>,
+                conjunction<is_integer<U>, is_integer_op_interoperable<T>>>::value,
+    int>;
+#endif
+
+template <typename T, typename U>
+#if defined(MPPP_HAVE_CONCEPTS)
+concept bool IntegerIntegralOpTypes = is_same_ssize_integer<T, U>::value
+                                      || (is_integer<T>::value && is_integer_op_integral<U>::value)
+                                      || (is_integer<U>::value && is_integer_op_integral<T>::value);
+#else
+using integer_integral_op_types_enabler
+    = enable_if_t<disjunction<is_same_ssize_integer<T, U>, conjunction<is_integer<T>, is_integer_op_integral<U>>,
+                              conjunction<is_integer<U>, is_integer_op_integral<T>>>::value,
+                  int>;
+#endif
+
+inline namespace detail
+{
+
+// Enabler for the operators which compute their result into the storage of an rvalue
+// integer<SSize> operand. The other operand must be an integer<SSize> or an integral type.
+template <typename T, std::size_t SSize>
+using integer_rvalue_op_enabler
+    = enable_if_t<disjunction<std::is_same<T, integer<SSize>>, is_integer_op_integral<T>>::value, int>;
+}
+
+/** @defgroup integer_arithmetic integer_arithmetic
+ *  @{
+ */
+
+inline namespace detail
+{
+
+// Metaprogramming for selecting the algorithm for static addition. The selection happens via
+// an std::integral_constant with 3 possible values:
+// - 0 (default case): use the GMP mpn functions,
+// - 1: selected when there are no nail bits and the static size is 1,
+// - 2: selected when there are no nail bits and the static size is 2.
+template <typename SInt>
+using integer_static_add_algo = std::integral_constant<
+    int, (!GMP_NAIL_BITS && SInt::s_size == 1) ? 1 : ((!GMP_NAIL_BITS && SInt::s_size == 2) ? 2 : 0)>;
+
+// General implementation via mpn.
+// Small helper to compute the size after subtraction via mpn. s is a strictly positive size.
+inline mpz_size_t integer_sub_compute_size(const ::mp_limb_t *rdata, mpz_size_t s)
+{
+    assert(s > 0);
+    mpz_size_t cur_idx = s - 1;
+    for (; cur_idx >= 0; --cur_idx) {
+        if (rdata[cur_idx] & GMP_NUMB_MASK) {
+            break;
+        }
+    }
+    return cur_idx + 1;
+}
+
+// NOTE: this function (and its other overloads) will return true in case of success, false in case of failure
+// (i.e., the addition overflows and the static size is not enough).
+template <std::size_t SSize>
+inline bool static_add_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                            const std::integral_constant<int, 0> &)
+{
+    auto rdata = &rop.m_limbs[0];
+    auto data1 = &op1.m_limbs[0], data2 = &op2.m_limbs[0];
+    const auto size1 = op1._mp_size;
+    // NOTE: cannot trust the size member from op2, as op2 could've been negated if
+    // we are actually subtracting.
+    const auto size2 = (sign2 >= 0) ? asize2 : -asize2;
+    // mpn functions require nonzero arguments.
+    if (mppp_unlikely(!sign2)) {
+        rop._mp_size = size1;
+        copy_limbs(data1, data1 + asize1, rdata);
+        return true;
+    }
+    if (mppp_unlikely(!sign1)) {
+        rop._mp_size = size2;
+        copy_limbs(data2, data2 + asize2, rdata);
+        return true;
+    }
+    // Check, for op1 and op2, whether:
+    // - the asize is the max static size, and, if yes,
+    // - the highest bit in the highest limb is set.
+    // If this condition holds for op1 and op2, we return failure, as the computation might require
+    // an extra limb.
+    // NOTE: the reason we check this is that we do not want to run into the situation in which we have written
+    // something into rop (via the mpn functions below), only to realize later that the computation overflows.
+    // This would be bad because, in case of overlapping arguments, it would destroy one or two operands without
+    // possibility of recovering. The alternative would be to do the computation in some local buffer and then
+    // copy it out, but that is rather costly. Note that this means that in principle a computation that could fit in
+    // static storage ends up triggering a promotion.
+    const bool c1 = std::size_t(asize1) == SSize && ((data1[asize1 - 1] & GMP_NUMB_MASK) >> (GMP_NUMB_BITS - 1));
+    const bool c2 = std::size_t(asize2) == SSize && ((data2[asize2 - 1] & GMP_NUMB_MASK) >> (GMP_NUMB_BITS - 1));
+    if (mppp_unlikely(c1 || c2)) {
+        return false;
+    }
+    if (sign1 == sign2) {
+        // Same sign.
+        if (asize1 >= asize2) {
+            // The number of limbs of op1 >= op2.
+            ::mp_limb_t cy;
+            if (asize2 == 1) {
+                // NOTE: we are not masking data2[0] with GMP_NUMB_MASK, I am assuming the mpn function
+                // is able to deal with a limb with a nail.
+                cy = ::mpn_add_1(rdata, data1, static_cast<::mp_size_t>(asize1), data2[0]);
+            } else if (asize1 == asize2) {
+                cy = ::mpn_add_n(rdata, data1, data2, static_cast<::mp_size_t>(asize1));
+            } else {
+                cy = ::mpn_add(rdata, data1, static_cast<::mp_size_t>(asize1), data2, static_cast<::mp_size_t>(asize2));
+            }
+            if (cy) {
+                assert(asize1 < static_int<SSize>::s_size);
+                rop._mp_size = size1 + sign1;
+                // NOTE: there should be no need to use GMP_NUMB_MASK here.
+                rdata[asize1] = 1u;
+            } else {
+                // Without carry, the size is unchanged.
+                rop._mp_size = size1;
+            }
+        } else {
+            // The number of limbs of op2 > op1.
+            ::mp_limb_t cy;
+            if (asize1 == 1) {
+                cy = ::mpn_add_1(rdata, data2, static_cast<::mp_size_t>(asize2), data1[0]);
+            } else {
+                cy = ::mpn_add(rdata, data2, static_cast<::mp_size_t>(asize2), data1, static_cast<::mp_size_t>(asize1));
+            }
+            if (cy) {
+                assert(asize2 < static_int<SSize>::s_size);
+                rop._mp_size = size2 + sign2;
+                rdata[asize2] = 1u;
+            } else {
+                rop._mp_size = size2;
+            }
+        }
+    } else {
+        if (asize1 > asize2 || (asize1 == asize2 && ::mpn_cmp(data1, data2, static_cast<::mp_size_t>(asize1)) >= 0)) {
+            // abs(op1) >= abs(op2).
+            ::mp_limb_t br;
+            if (asize2 == 1) {
+                br = ::mpn_sub_1(rdata, data1, static_cast<::mp_size_t>(asize1), data2[0]);
+            } else if (asize1 == asize2) {
+                br = ::mpn_sub_n(rdata, data1, data2, static_cast<::mp_size_t>(asize1));
+            } else {
+                br = ::mpn_sub(rdata, data1, static_cast<::mp_size_t>(asize1), data2, static_cast<::mp_size_t>(asize2));
+            }
+            assert(!br);
+            rop._mp_size = integer_sub_compute_size(rdata, asize1);
+            if (sign1 != 1) {
+                rop._mp_size = -rop._mp_size;
+            }
+        } else {
+            // abs(op2) > abs(op1).
+            ::mp_limb_t br;
+            if (asize1 == 1) {
+                br = ::mpn_sub_1(rdata, data2, static_cast<::mp_size_t>(asize2), data1[0]);
+            } else {
+                br = ::mpn_sub(rdata, data2, static_cast<::mp_size_t>(asize2), data1, static_cast<::mp_size_t>(asize1));
+            }
+            assert(!br);
+            rop._mp_size = integer_sub_compute_size(rdata, asize2);
+            if (sign2 != 1) {
+                rop._mp_size = -rop._mp_size;
+            }
+        }
+    }
+    return true;
+}
+
+// Optimization for single-limb statics with no nails.
+template <std::size_t SSize>
+inline bool static_add_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                            const std::integral_constant<int, 1> &)
+{
+    auto rdata = &rop.m_limbs[0];
+    auto data1 = &op1.m_limbs[0], data2 = &op2.m_limbs[0];
+    // NOTE: both asizes have to be 0 or 1 here.
+    assert((asize1 == 1 && data1[0] != 0u) || (asize1 == 0 && data1[0] == 0u));
+    assert((asize2 == 1 && data2[0] != 0u) || (asize2 == 0 && data2[0] == 0u));
+    ::mp_limb_t tmp;
+    if (sign1 == sign2) {
+        // When the signs are identical, we can implement addition as a true addition.
+        if (mppp_unlikely(limb_add_overflow(data1[0], data2[0], &tmp))) {
+            return false;
+        }
+        // Assign the output. asize can be zero (sign1 == sign2 == 0) or 1.
+        rop._mp_size = sign1;
+        rdata[0] = tmp;
+    } else {
+        // When the signs differ, we need to implement addition as a subtraction.
+        // NOTE: this also includes the case in which only one of the operands is zero.
+        if (data1[0] >= data2[0]) {
+            // op1 is not smaller than op2.
+            tmp = data1[0] - data2[0];
+            // asize is either 1 or 0 (0 iff abs(op1) == abs(op2)).
+            rop._mp_size = sign1 * static_cast<int>(tmp != 0u);
+            rdata[0] = tmp;
+        } else {
+            // NOTE: this has to be one, as data2[0] and data1[0] cannot be equal.
+            rop._mp_size = sign2;
+            rdata[0] = data2[0] - data1[0];
+        }
+    }
+    return true;
+}
+
+// Optimization for two-limbs statics with no nails.
+// Small helper to compare two statics of equal asize 1 or 2.
+inline int integer_compare_limbs_2(const ::mp_limb_t *data1, const ::mp_limb_t *data2, mpz_size_t asize)
+{
+    // NOTE: this requires no nail bits.
+    assert(!GMP_NAIL_BITS);
+    assert(asize == 1 || asize == 2);
+    // Start comparing from the top.
+    auto cmp_idx = asize - 1;
+    if (data1[cmp_idx] != data2[cmp_idx]) {
+        return data1[cmp_idx] > data2[cmp_idx] ? 1 : -1;
+    }
+    // The top limbs are equal, move down one limb.
+    // If we are already at the bottom limb, it means the two numbers are equal.
+    if (!cmp_idx) {
+        return 0;
+    }
+    --cmp_idx;
+    if (data1[cmp_idx] != data2[cmp_idx]) {
+        return data1[cmp_idx] > data2[cmp_idx] ? 1 : -1;
+    }
+    return 0;
+}
+
+template <std::size_t SSize>
+inline bool static_add_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                            const std::integral_constant<int, 2> &)
+{
+    auto rdata = &rop.m_limbs[0];
+    auto data1 = &op1.m_limbs[0], data2 = &op2.m_limbs[0];
+    if (sign1 == sign2) {
+        // NOTE: this handles the case in which the numbers have the same sign, including 0 + 0.
+        //
+        // NOTE: this is the implementation for 2 limbs, even if potentially the operands have 1 limb.
+        // The idea here is that it's better to do a few computations more rather than paying the branching
+        // cost. 1-limb operands will have the upper limb set to zero from the zero-initialization of
+        // the limbs of static ints.
+        //
+        // NOTE: the rop hi limb might spill over either from the addition of the hi limbs
+        // of op1 and op2, or by the addition of carry coming over from the addition of
+        // the lo limbs of op1 and op2.
+        //
+        // Add the hi and lo limbs.
+        const auto a = data1[0], b = data2[0], c = data1[1], d = data2[1];
+        ::mp_limb_t lo, hi1, hi2;
+        const ::mp_limb_t cy_lo = limb_add_overflow(a, b, &lo), cy_hi1 = limb_add_overflow(c, d, &hi1),
+                          cy_hi2 = limb_add_overflow(hi1, cy_lo, &hi2);
+        // The result will overflow if we have any carry relating to the high limb.
+        if (mppp_unlikely(cy_hi1 || cy_hi2)) {
+            return false;
+        }
+        // For the size compuation:
+        // - if sign1 == 0, size is zero,
+        // - if sign1 == +-1, then the size is either +-1 or +-2: asize is 2 if the result
+        //   has a nonzero 2nd limb, otherwise asize is 1.
+        rop._mp_size = sign1 * (static_cast<int>(hi2 != 0u) + 1);
+        rdata[0] = lo;
+        rdata[1] = hi2;
+    } else {
+        // When the signs differ, we need to implement addition as a subtraction.
+        // NOTE: this also includes the case in which only one of the operands is zero.
+        if (asize1 > asize2 || (asize1 == asize2 && integer_compare_limbs_2(data1, data2, asize1) >= 0)) {
+            // op1 is >= op2 in absolute value.
+            const auto lo = data1[0] - data2[0];
+            // If there's a borrow, then hi1 > hi2, otherwise we would have a negative result.
+            assert(data1[0] >= data2[0] || data1[1] > data2[1]);
+            // This can never wrap around, at most it goes to zero.
+            const auto hi = data1[1] - data2[1] - static_cast<::mp_limb_t>(data1[0] < data2[0]);
+            // asize can be 0, 1 or 2.
+            // NOTE: this contraption ensures the correct result. The possibilities for hi/lo
+            // nonzero are:
+            // hi | lo | asize
+            // ---------------
+            //  1 |  1 |     2
+            //  1 |  0 |     2
+            //  0 |  1 |     1
+            //  0 |  0 |     0
+            // The sign1 (which cannot be zero due to the branch we are in) takes care of the sign of the size.
+            // Use '|' instead of '||' as we don't need to short circuit on this.
+            rop._mp_size = sign1 * static_cast<int>((lo != 0u) | (hi != 0u)) * (static_cast<int>(hi != 0u) + 1);
+            rdata[0] = lo;
+            rdata[1] = hi;
+        } else {
+            // op2 is > op1 in absolute value.
+            const auto lo = data2[0] - data1[0];
+            assert(data2[0] >= data1[0] || data2[1] > data1[1]);
+            const auto hi = data2[1] - data1[1] - static_cast<::mp_limb_t>(data2[0] < data1[0]);
+            // asize can be 1 or 2, but not zero as we know abs(op1) != abs(op2). Same idea as above.
+            rop._mp_size = sign2 * (static_cast<int>(hi != 0u) + 1);
+            rdata[0] = lo;
+            rdata[1] = hi;
+        }
+    }
+    return true;
+}
+
+template <bool AddOrSub, std::size_t SSize>
+inline bool static_addsub(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+{
+    // NOTE: effectively negate op2 if we are subtracting.
+    mpz_size_t asize1 = op1._mp_size, asize2 = AddOrSub ? op2._mp_size : -op2._mp_size;
+    int sign1 = asize1 != 0, sign2 = asize2 != 0;
+    if (asize1 < 0) {
+        asize1 = -asize1;
+        sign1 = -1;
+    }
+    if (asize2 < 0) {
+        asize2 = -asize2;
+        sign2 = -1;
+    }
+    const bool retval
+        = static_add_impl(rop, op1, op2, asize1, asize2, sign1, sign2, integer_static_add_algo<static_int<SSize>>{});
+    if (integer_static_add_algo<static_int<SSize>>::value == 0 && retval) {
+        // If we used the mpn functions and we actually wrote into rop, then
+        // make sure we zero out the unused limbs.
+        rop.zero_unused_limbs();
+    }
+    return retval;
+}
+}
+
+/// Ternary addition.
+/**
+ * This function will set \p rop to <tt>op1 + op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &add(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    const bool s1 = op1.is_static(), s2 = op2.is_static();
+    const bool sr = rop.is_static();
+    if (mppp_likely(s1 && s2)) {
+        // If both op1 and op2 are static, we will try to do the statid add.
+        // We might need to downgrade rop to static.
+        if (!sr) {
+            // NOTE: here we are sure rop is distinct from op1/op2, as
+            // rop is dynamic and op1/op2 are both static.
+            rop.set_zero();
+        }
+        if (mppp_likely(
+                static_addsub<true>(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st()))) {
+            return rop;
+        }
+    }
+    rop._get_union().grow(std::max(op1.size(), op2.size()) + 1u);
+    ::mpz_add(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    return rop;
+}
+
+inline namespace detail
+{
+
+// Metaprogramming for selecting the algorithm for static add/sub with ui. The selection happens via
+// an std::integral_constant with 3 possible values:
+// - 0 (default case): use the GMP mpn functions,
+// - 1: selected when there are no nail bits and the static size is 1,
+// - 2: selected when there are no nail bits and the static size is 2.
+template <typename SInt>
+using integer_static_addsub_ui_algo = std::integral_constant<
+    int, (!GMP_NAIL_BITS && SInt::s_size == 1) ? 1 : ((!GMP_NAIL_BITS && SInt::s_size == 2) ? 2 : 0)>;
+
+// mpn implementation.
+template <bool AddOrSub, std::size_t SSize>
+inline bool static_addsub_ui_impl(static_int<SSize> &rop, const static_int<SSize> &op1, mpz_size_t asize1, int sign1,
+                                  unsigned long op2, const std::integral_constant<int, 0> &)
+{
+    auto rdata = &rop.m_limbs[0];
+    auto data1 = &op1.m_limbs[0];
+    const auto size1 = op1._mp_size;
+    const auto l2 = static_cast<::mp_limb_t>(op2);
+    // mpn functions require nonzero arguments.
+    if (mppp_unlikely(!l2)) {
+        rop._mp_size = size1;
+        copy_limbs(data1, data1 + asize1, rdata);
+        return true;
+    }
+    // We now know l2 is not zero, so its "sign" must be either 1 or -1.
+    constexpr int sign2 = AddOrSub ? 1 : -1;
+    if (mppp_unlikely(!sign1)) {
+        // NOTE: this has to be +-1 because l2 == 0 is handled above.
+        rop._mp_size = sign2;
+        rdata[0] = l2;
+        return true;
+    }
+    // This is the same overflow check as in static_addsub(). As in static_addsub(), this is not as tight/precise
+    // as it could be.
+    const bool c1 = std::size_t(asize1) == SSize && ((data1[asize1 - 1] & GMP_NUMB_MASK) >> (GMP_NUMB_BITS - 1));
+    const bool c2 = SSize == 1u && (l2 >> (GMP_NUMB_BITS - 1));
+    if (mppp_unlikely(c1 || c2)) {
+        return false;
+    }
+    if (sign1 == sign2) {
+        // op1 and op2 have the same sign. Implement as a true addition.
+        if (::mpn_add_1(rdata, data1, static_cast<::mp_size_t>(asize1), l2)) {
+            assert(asize1 < static_int<SSize>::s_size);
+            // New size is old size + 1 if old size was positive, old size - 1 otherwise.
+            rop._mp_size = size1 + sign2;
+            // NOTE: there should be no need to use GMP_NUMB_MASK here.
+            rdata[asize1] = 1u;
+        } else {
+            // Without carry, the size is unchanged.
+            rop._mp_size = size1;
+        }
+    } else {
+        // op1 and op2 have different signs. Implement as a subtraction.
+        if (asize1 > 1 || (asize1 == 1 && (data1[0] & GMP_NUMB_MASK) >= l2)) {
+            // abs(op1) >= abs(op2).
+            const auto br = ::mpn_sub_1(rdata, data1, static_cast<::mp_size_t>(asize1), l2);
+            (void)br;
+            assert(!br);
+            // The asize can be the original one or original - 1 (we subtracted a limb). If size1 was positive,
+            // sign2 has to be negative and we potentially subtract 1, if size1 was negative then sign2 has to be
+            // positive and we potentially add 1.
+            rop._mp_size = size1 + sign2 * !(rdata[asize1 - 1] & GMP_NUMB_MASK);
+        } else {
+            // abs(op2) > abs(op1).
+            const auto br = ::mpn_sub_1(rdata, &l2, 1, data1[0]);
+            (void)br;
+            assert(!br);
+            // The size must be +-1, as abs(op2) == abs(op1) is handled above.
+            assert((rdata[0] & GMP_NUMB_MASK));
+            rop._mp_size = sign2;
+        }
+    }
+    return true;
+}
+
+// 1-limb optimisation (no nails).
+template <bool AddOrSub, std::size_t SSize>
+inline bool static_addsub_ui_impl(static_int<SSize> &rop, const static_int<SSize> &op1, mpz_size_t, int sign1,
+                                  unsigned long op2, const std::integral_constant<int, 1> &)
+{
+    const auto l1 = op1.m_limbs[0];
+    const auto l2 = static_cast<::mp_limb_t>(op2);
+    ::mp_limb_t tmp;
+    if ((sign1 >= 0 && AddOrSub) || (sign1 <= 0 && !AddOrSub)) {
+        // op1 non-negative and addition, or op1 non-positive and subtraction. Implement
+        // as a true addition.
+        if (mppp_unlikely(limb_add_overflow(l1, l2, &tmp))) {
+            return false;
+        }
+        // The size is 1 for addition, -1 for subtraction, unless
+        // the result is zero.
+        rop._mp_size = (AddOrSub ? 1 : -1) * (tmp != 0u);
+        rop.m_limbs[0] = tmp;
+    } else {
+        // op1 negative and addition, or op1 positive and subtraction. Implement
+        // as a subtraction.
+        if (l1 >= l2) {
+            // op1 has larger or equal abs.
+            tmp = l1 - l2;
+            // asize is 1 or 0, 0 iff l1 == l2. Sign is negative for add, positive for sub.
+            rop._mp_size = (AddOrSub ? -1 : 1) * (tmp != 0u);
+            rop.m_limbs[0] = tmp;
+        } else {
+            // op1 has smaller abs. The result will be positive for add, negative
+            // for sub (cannot be zero as it is handled above).
+            rop._mp_size = AddOrSub ? 1 : -1;
+            rop.m_limbs[0] = l2 - l1;
+        }
+    }
+    return true;
+}
+
+// 2-limb optimisation (no nails).
+template <bool AddOrSub, std::size_t SSize>
+inline bool static_addsub_ui_impl(static_int<SSize> &rop, const static_int<SSize> &op1, mpz_size_t asize1, int sign1,
+                                  unsigned long op2, const std::integral_constant<int, 2> &)
+{
+    auto rdata = &rop.m_limbs[0];
+    auto data1 = &op1.m_limbs[0];
+    const auto l2 = static_cast<::mp_limb_t>(op2);
+    if ((sign1 >= 0 && AddOrSub) || (sign1 <= 0 && !AddOrSub)) {
+        // op1 non-negative and addition, or op1 non-positive and subtraction. Implement
+        // as a true addition.
+        // These two limbs will contain the result.
+        ::mp_limb_t lo, hi;
+        // Add l2 to the low limb, placing the result in lo.
+        const ::mp_limb_t cy_lo = limb_add_overflow(data1[0], l2, &lo);
+        // Add the carry from the low addition to the high limb, placing the result in hi.
+        const ::mp_limb_t cy_hi = limb_add_overflow(data1[1], cy_lo, &hi);
+        if (mppp_unlikely(cy_hi)) {
+            return false;
+        }
+        // Compute the new asize. It can be 0, 1 or 2.
+        // NOTE: see the comments in the 2-limb specialisation for addition.
+        rop._mp_size
+            = (AddOrSub ? 1 : -1) * static_cast<int>((lo != 0u) | (hi != 0u)) * (static_cast<int>(hi != 0u) + 1);
+        // Write out.
+        rdata[0] = lo;
+        rdata[1] = hi;
+    } else {
+        // op1 negative and addition, or op1 positive and subtraction. Implement
+        // as a subtraction.
+        // Compare their absolute values.
+        if (asize1 == 2 || data1[0] >= l2) {
+            // op1 is >= op2 in absolute value.
+            const auto lo = data1[0] - l2;
+            // Sub from hi the borrow.
+            const auto hi = data1[1] - static_cast<::mp_limb_t>(data1[0] < l2);
+            // The final asize can be 2, 1 or 0. Sign is negative for add, positive for sub.
+            rop._mp_size
+                = (AddOrSub ? -1 : 1) * (static_cast<int>((lo != 0u) | (hi != 0u)) * (static_cast<int>(hi != 0u) + 1));
+            rdata[0] = lo;
+            rdata[1] = hi;
+        } else {
+            // op2 > op1 in absolute value.
+            // Size has to be +-1.
+            rop._mp_size = AddOrSub ? 1 : -1;
+            rdata[0] = l2 - data1[0];
+            rdata[1] = 0u;
+        }
+    }
+    return true;
+}
+
+template <bool AddOrSub, std::size_t SSize>
+inline bool static_addsub_ui(static_int<SSize> &rop, const static_int<SSize> &op1, unsigned long op2)
+{
+    mpz_size_t asize1 = op1._mp_size;
+    int sign1 = asize1 != 0;
+    if (asize1 < 0) {
+        asize1 = -asize1;
+        sign1 = -1;
+    }
+    const bool retval = static_addsub_ui_impl<AddOrSub>(rop, op1, asize1, sign1, op2,
+                                                        integer_static_addsub_ui_algo<static_int<SSize>>{});
+    if (integer_static_addsub_ui_algo<static_int<SSize>>::value == 0 && retval) {
+        // If we used the mpn functions and we actually wrote into rop, then
+        // make sure we zero out the unused limbs.
+        rop.zero_unused_limbs();
+    }
+    return retval;
+}
+}
+
+/// Ternary addition with <tt>unsigned long</tt>.
+/**
+ * This function will set \p rop to <tt>op1 + op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &add_ui(integer<SSize> &rop, const integer<SSize> &op1, unsigned long op2)
+{
+    // LCOV_EXCL_START
+    if (std::numeric_limits<unsigned long>::max() > GMP_NUMB_MASK) {
+        // For the optimised version below to kick in we need to be sure we can safely convert
+        // unsigned long to an ::mp_limb_t, modulo nail bits. This because in the optimised version
+        // we cast forcibly op2 to ::mp_limb_t. Otherwise, we just call add() after converting op2 to an
+        // integer.
+        // NOTE: it does not look like this can be hit on any modern setup.
+        add(rop, op1, integer<SSize>{op2});
+        return rop;
+    }
+    // LCOV_EXCL_STOP
+    const bool s1 = op1.is_static();
+    const bool sr = rop.is_static();
+    if (mppp_likely(s1)) {
+        if (!sr) {
+            rop.set_zero();
+        }
+        if (mppp_likely(static_addsub_ui<true>(rop._get_union().g_st(), op1._get_union().g_st(), op2))) {
+            return rop;
+        }
+    }
+    rop._get_union().grow(op1.size() + 1u);
+    ::mpz_add_ui(&rop._get_union().g_dy(), op1.get_mpz_view(), op2);
+    return rop;
+}
+
+/// Ternary subtraction with <tt>unsigned long</tt>.
+/**
+ * This function will set \p rop to <tt>op1 - op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &sub_ui(integer<SSize> &rop, const integer<SSize> &op1, unsigned long op2)
+{
+    // LCOV_EXCL_START
+    if (std::numeric_limits<unsigned long>::max() > GMP_NUMB_MASK) {
+        sub(rop, op1, integer<SSize>{op2});
+        return rop;
+    }
+    // LCOV_EXCL_STOP
+    const bool s1 = op1.is_static();
+    const bool sr = rop.is_static();
+    if (mppp_likely(s1)) {
+        if (!sr) {
+            rop.set_zero();
+        }
+        if (mppp_likely(static_addsub_ui<false>(rop._get_union().g_st(), op1._get_union().g_st(), op2))) {
+            return rop;
+        }
+    }
+    rop._get_union().grow(op1.size() + 1u);
+    ::mpz_sub_ui(&rop._get_union().g_dy(), op1.get_mpz_view(), op2);
+    return rop;
+}
+
+/// Ternary subtraction.
+/**
+ * This function will set \p rop to <tt>op1 - op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &sub(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    const bool s1 = op1.is_static(), s2 = op2.is_static();
+    const bool sr = rop.is_static();
+    if (mppp_likely(s1 && s2)) {
+        if (!sr) {
+            rop.set_zero();
+        }
+        if (mppp_likely(
+                static_addsub<false>(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st()))) {
+            return rop;
+        }
+    }
+    rop._get_union().grow(std::max(op1.size(), op2.size()) + 1u);
+    ::mpz_sub(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    return rop;
+}
+
+inline namespace detail
+{
+
+// The double limb multiplication optimization is available in the following cases:
+// - no nails, we are on a 64bit MSVC build, the limb type has exactly 64 bits and GMP_NUMB_BITS is 64,
+// - no nails, we have a 128bit unsigned available, the limb type has exactly 64 bits and GMP_NUMB_BITS is 64,
+// - no nails, the smallest 64 bit unsigned type has exactly 64 bits, the limb type has exactly 32 bits and
+//   GMP_NUMB_BITS is 32.
+// NOTE: here we are checking that GMP_NUMB_BITS is the same as the limits ::digits property, which is probably
+// rather redundant on any conceivable architecture.
+using integer_have_dlimb_mul = std::integral_constant<bool,
+#if (defined(_MSC_VER) && defined(_WIN64) && (GMP_NUMB_BITS == 64)) || (defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64))
+                                                      !GMP_NAIL_BITS && std::numeric_limits<::mp_limb_t>::digits == 64
+#elif GMP_NUMB_BITS == 32
+                                                      !GMP_NAIL_BITS
+                                                          && std::numeric_limits<std::uint_least64_t>::digits == 64
+                                                          && std::numeric_limits<::mp_limb_t>::digits == 32
+#else
+                                                      false
+#endif
+                                                      >;
+
+template <typename SInt>
+using integer_static_mul_algo
+    = std::integral_constant<int, (SInt::s_size == 1 && integer_have_dlimb_mul::value)
+                                      ? 1
+                                      : ((SInt::s_size == 2 && integer_have_dlimb_mul::value) ? 2 : 0)>;
+
+// mpn implementation.
+// NOTE: this function (and the other overloads) returns 0 in case of success, otherwise it returns a hint
+// about the size in limbs of the result.
+template <std::size_t SSize>
+inline std::size_t static_mul_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                   mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                                   const std::integral_constant<int, 0> &)
+{
+    // Handle zeroes.
+    if (mppp_unlikely(!sign1 || !sign2)) {
+        rop._mp_size = 0;
+        return 0u;
+    }
+    auto rdata = &rop.m_limbs[0];
+    auto data1 = &op1.m_limbs[0], data2 = &op2.m_limbs[0];
+    const auto max_asize = std::size_t(asize1 + asize2);
+    // Temporary storage, to be used if we cannot write into rop.
+    std::array<::mp_limb_t, SSize * 2u> res;
+    // We can write directly into rop if these conditions hold:
+    // - rop does not overlap with op1 and op2,
+    // - SSize is large enough to hold the max size of the result.
+    ::mp_limb_t *MPPP_RESTRICT res_data = (rdata != data1 && rdata != data2 && max_asize <= SSize) ? rdata : res.data();
+    // Proceed to the multiplication.
+    ::mp_limb_t hi;
+    if (asize2 == 1) {
+        // NOTE: the 1-limb versions do not write the hi limb, we have to write it ourselves.
+        hi = ::mpn_mul_1(res_data, data1, static_cast<::mp_size_t>(asize1), data2[0]);
+        res_data[asize1] = hi;
+    } else if (asize1 == 1) {
+        hi = ::mpn_mul_1(res_data, data2, static_cast<::mp_size_t>(asize2), data1[0]);
+        res_data[asize2] = hi;
+    } else if (asize1 == asize2) {
+        ::mpn_mul_n(res_data, data1, data2, static_cast<::mp_size_t>(asize1));
+        hi = res_data[2 * asize1 - 1];
+    } else if (asize1 >= asize2) {
+        hi = ::mpn_mul(res_data, data1, static_cast<::mp_size_t>(asize1), data2, static_cast<::mp_size_t>(asize2));
+    } else {
+        hi = ::mpn_mul(res_data, data2, static_cast<::mp_size_t>(asize2), data1, static_cast<::mp_size_t>(asize1));
+    }
+    // The actual size.
+    const std::size_t asize = max_asize - unsigned(hi == 0u);
+    if (res_data == rdata) {
+        // If we wrote directly into rop, it means that we had enough storage in it to begin with.
+        rop._mp_size = mpz_size_t(asize);
+        if (sign1 != sign2) {
+            rop._mp_size = -rop._mp_size;
+        }
+        return 0u;
+    }
+    // If we used the temporary storage, we need to check if we can write into rop.
+    if (asize > SSize) {
+        // Not enough space, return the size.
+        return asize;
+    }
+    // Enough space, set size and copy limbs.
+    rop._mp_size = mpz_size_t(asize);
+    if (sign1 != sign2) {
+        rop._mp_size = -rop._mp_size;
+    }
+    // NOTE: here we are sure that res_data != rdata, as we checked it earlier.
+    copy_limbs_no(res_data, res_data + asize, rdata);
+    return 0u;
+}
+
+#if defined(_MSC_VER) && defined(_WIN64) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
+inline ::mp_limb_t dlimb_mul(::mp_limb_t op1, ::mp_limb_t op2, ::mp_limb_t *hi)
+{
+    return ::UnsignedMultiply128(op1, op2, hi);
+}
+#elif defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
+inline ::mp_limb_t dlimb_mul(::mp_limb_t op1, ::mp_limb_t op2, ::mp_limb_t *hi)
+{
+    using dlimb_t = MPPP_UINT128;
+    const dlimb_t res = dlimb_t(op1) * op2;
+    *hi = static_cast<::mp_limb_t>(res >> 64);
+    return static_cast<::mp_limb_t>(res);
+}
+#elif GMP_NUMB_BITS == 32 && !GMP_NAIL_BITS
+inline ::mp_limb_t dlimb_mul(::mp_limb_t op1, ::mp_limb_t op2, ::mp_limb_t *hi)
+{
+    using dlimb_t = std::uint_least64_t;
+    const dlimb_t res = dlimb_t(op1) * op2;
+    *hi = static_cast<::mp_limb_t>(res >> 32);
+    return static_cast<::mp_limb_t>(res);
+}
+#endif
+
+// 1-limb optimization via dlimb.
+template <std::size_t SSize>
+inline std::size_t static_mul_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                   mpz_size_t, mpz_size_t, int, int, const std::integral_constant<int, 1> &)
+{
+    ::mp_limb_t hi;
+    const ::mp_limb_t lo = dlimb_mul(op1.m_limbs[0], op2.m_limbs[0], &hi);
+    if (mppp_unlikely(hi)) {
+        return 2u;
+    }
+    // The size will be zero if at least one operand is zero, otherwise +-1
+    // depending on the signs of the operands.
+    rop._mp_size = op1._mp_size * op2._mp_size;
+    rop.m_limbs[0] = lo;
+    return 0u;
+}
+
+// 2-limb optimization via dlimb.
+template <std::size_t SSize>
+inline std::size_t static_mul_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                   mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                                   const std::integral_constant<int, 2> &)
+{
+    if (asize1 <= 1 && asize2 <= 1) {
+        // NOTE: this handles zeroes as well: we know that the limbs are all zeroes in such
+        // a case (as we always guarantee unused limbs are zeroed), and the sign1 * sign2 multiplication takes care of
+        // the size.
+        rop.m_limbs[0] = dlimb_mul(op1.m_limbs[0], op2.m_limbs[0], &rop.m_limbs[1]);
+        rop._mp_size = sign1 * sign2 * static_cast<mpz_size_t>(2 - (rop.m_limbs[1] == 0u));
+        return 0u;
+    }
+    if (asize1 != asize2) {
+        // The only possibility of success is 2limbs x 1limb.
+        //
+        //             b      a X
+        //                    c
+        // --------------------
+        // tmp[2] tmp[1] tmp[0]
+        //
+        ::mp_limb_t a = op1.m_limbs[0], b = op1.m_limbs[1], c = op2.m_limbs[0];
+        if (asize1 < asize2) {
+            // Switch them around if needed.
+            a = op2.m_limbs[0], b = op2.m_limbs[1], c = op1.m_limbs[0];
+        }
+        ::mp_limb_t ca_lo, ca_hi, cb_lo, cb_hi, tmp0, tmp1, tmp2;
+        ca_lo = dlimb_mul(c, a, &ca_hi);
+        cb_lo = dlimb_mul(c, b, &cb_hi);
+        tmp0 = ca_lo;
+        const auto cy = limb_add_overflow(cb_lo, ca_hi, &tmp1);
+        tmp2 = cb_hi + cy;
+        // Now determine the size. asize must be at least 2.
+        const mpz_size_t asize = 2 + mpz_size_t(tmp2 != 0u);
+        if (asize == 2) {
+            // Size is good, write out the result.
+            rop._mp_size = sign1 * sign2 * asize;
+            rop.m_limbs[0] = tmp0;
+            rop.m_limbs[1] = tmp1;
+            return 0u;
+        }
+    }
+    // Return 4 as a size hint. Real size could be 3, but GMP will require 4 limbs
+    // of storage to perform the operation anyway.
+    return 4u;
+}
+
+template <std::size_t SSize>
+inline std::size_t static_mul(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+{
+    // Cache a few quantities, detect signs.
+    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
+    int sign1 = asize1 != 0, sign2 = asize2 != 0;
+    if (asize1 < 0) {
+        asize1 = -asize1;
+        sign1 = -1;
+    }
+    if (asize2 < 0) {
+        asize2 = -asize2;
+        sign2 = -1;
+    }
+    const std::size_t retval
+        = static_mul_impl(rop, op1, op2, asize1, asize2, sign1, sign2, integer_static_mul_algo<static_int<SSize>>{});
+    if (integer_static_mul_algo<static_int<SSize>>::value == 0 && retval == 0u) {
+        rop.zero_unused_limbs();
+    }
+    return retval;
+}
+}
+
+/// Ternary multiplication.
+/**
+ * This function will set \p rop to <tt>op1 * op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &mul(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    const bool s1 = op1.is_static(), s2 = op2.is_static();
+    bool sr = rop.is_static();
+    std::size_t size_hint = 0u;
+    if (mppp_likely(s1 && s2)) {
+        if (!sr) {
+            rop.set_zero();
+            sr = true;
+        }
+        size_hint = static_mul(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
+        if (mppp_likely(size_hint == 0u)) {
+            return rop;
+        }
+    }
+    if (sr) {
+        // We use the size hint from the static_mul if available, otherwise a normal promotion will take place.
+        // NOTE: here the best way of proceeding would be to calculate the max size of the result based on
+        // the op1/op2 sizes, but for whatever reason this computation has disastrous performance consequences
+        // on micro-benchmarks. We need to understand if that's the case in real-world scenarios as well, and
+        // revisit this.
+        rop._get_union().promote(size_hint);
+    } else {
+        // Grow geometrically the storage of a dynamic rop (see mpz_grow_nlimbs()).
+        mpz_grow_nlimbs(rop._get_union().g_dy(), op1.size() + op2.size());
+    }
+    ::mpz_mul(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    return rop;
+}
+
+inline namespace detail
+{
+
+// Selection of the algorithm for addmul: if optimised algorithms exist for both add and mul, then use the
+// optimised addmul algos. Otherwise, use the mpn one.
+template <typename SInt>
+using integer_static_addmul_algo = std::integral_constant<
+    int, (integer_static_add_algo<SInt>::value == 2 && integer_static_mul_algo<SInt>::value == 2)
+             ? 2
+             : ((integer_static_add_algo<SInt>::value == 1 && integer_static_mul_algo<SInt>::value == 1) ? 1 : 0)>;
+
+// NOTE: same return value as mul: 0 for success, otherwise a hint for the size of the result.
+template <std::size_t SSize>
+inline std::size_t static_addmul_impl(static_int<SSize> &rop, const static_int<SSize> &op1,
+                                      const static_int<SSize> &op2, mpz_size_t asizer, mpz_size_t asize1,
+                                      mpz_size_t asize2, int signr, int sign1, int sign2,
+                                      const std::integral_constant<int, 0> &)
+{
+    // First try to do the static prod, if it does not work it's a failure.
+    static_int<SSize> prod;
+    if (mppp_unlikely(
+            static_mul_impl(prod, op1, op2, asize1, asize2, sign1, sign2, std::integral_constant<int, 0>{}))) {
+        // This is the maximum size a static addmul can have.
+        return SSize * 2u + 1u;
+    }
+    // Determine sign and asize of the product.
+    mpz_size_t asize_prod = prod._mp_size;
+    int sign_prod = (asize_prod != 0);
+    if (asize_prod < 0) {
+        asize_prod = -asize_prod;
+        sign_prod = -1;
+    }
+    // Try to do the add.
+    if (mppp_unlikely(
+            !static_add_impl(rop, rop, prod, asizer, asize_prod, signr, sign_prod, std::integral_constant<int, 0>{}))) {
+        return SSize + 1u;
+    }
+    return 0u;
+}
+
+template <std::size_t SSize>
+inline std::size_t static_addmul_impl(static_int<SSize> &rop, const static_int<SSize> &op1,
+                                      const static_int<SSize> &op2, mpz_size_t, mpz_size_t, mpz_size_t, int signr,
+                                      int sign1, int sign2, const std::integral_constant<int, 1> &)
+{
+    // First we do op1 * op2.
+    ::mp_limb_t tmp;
+    const ::mp_limb_t prod = dlimb_mul(op1.m_limbs[0], op2.m_limbs[0], &tmp);
+    if (mppp_unlikely(tmp)) {
+        return 3u;
+    }
+    // Determine the sign of the product: 0, 1 or -1.
+    const int sign_prod = sign1 * sign2;
+    // Now add/sub.
+    if (signr == sign_prod) {
+        // Same sign, do addition with overflow check.
+        if (mppp_unlikely(limb_add_overflow(rop.m_limbs[0], prod, &tmp))) {
+            return 2u;
+        }
+        // Assign the output.
+        rop._mp_size = signr;
+        rop.m_limbs[0] = tmp;
+    } else {
+        // When the signs differ, we need to implement addition as a subtraction.
+        if (rop.m_limbs[0] >= prod) {
+            // abs(rop) >= abs(prod).
+            tmp = rop.m_limbs[0] - prod;
+            // asize is either 1 or 0 (0 iff rop == prod).
+            rop._mp_size = signr * static_cast<int>(tmp != 0u);
+            rop.m_limbs[0] = tmp;
+        } else {
+            // NOTE: this cannot be zero, as rop and prod cannot be equal.
+            rop._mp_size = sign_prod;
+            rop.m_limbs[0] = prod - rop.m_limbs[0];
+        }
+    }
+    return 0u;
+}
+
+template <std::size_t SSize>
+inline std::size_t static_addmul_impl(static_int<SSize> &rop, const static_int<SSize> &op1,
+                                      const static_int<SSize> &op2, mpz_size_t asizer, mpz_size_t asize1,
+                                      mpz_size_t asize2, int signr, int sign1, int sign2,
+                                      const std::integral_constant<int, 2> &)
+{
+    if (mppp_unlikely(!asize1 || !asize2)) {
+        // If op1 or op2 are zero, rop will be unchanged.
+        return 0u;
+    }
+    // Handle op1 * op2.
+    std::array<::mp_limb_t, 2> prod;
+    const int sign_prod = sign1 * sign2;
+    mpz_size_t asize_prod;
+    if (asize1 == 1 && asize2 == 1) {
+        prod[0] = dlimb_mul(op1.m_limbs[0], op2.m_limbs[0], &prod[1]);
+        asize_prod = (asize1 + asize2) - (prod[1] == 0u);
+    } else {
+        // The only possibility of success is 2limbs x 1limb.
+        //
+        //       b       a X
+        //               c
+        // ---------------
+        // prod[1] prod[0]
+        //
+        if (mppp_unlikely(asize1 == asize2)) {
+            // This means that both sizes are 2.
+            return 5u;
+        }
+        ::mp_limb_t a = op1.m_limbs[0], b = op1.m_limbs[1], c = op2.m_limbs[0];
+        if (asize1 < asize2) {
+            // Switch them around if needed.
+            a = op2.m_limbs[0], b = op2.m_limbs[1], c = op1.m_limbs[0];
+        }
+        ::mp_limb_t ca_hi, cb_hi;
+        // These are the three operations that build the result, two mults, one add.
+        prod[0] = dlimb_mul(c, a, &ca_hi);
+        prod[1] = dlimb_mul(c, b, &cb_hi);
+        // NOTE: we can use this with overlapping arguments because the first two
+        // are passed as copies.
+        const auto cy = limb_add_overflow(prod[1], ca_hi, &prod[1]);
+        // Check if the third limb exists, if so we return failure.
+        if (mppp_unlikely(cb_hi || cy)) {
+            return 4u;
+        }
+        asize_prod = 2;
+    }
+    // Proceed to the addition.
+    if (signr == sign_prod) {
+        // Add the hi and lo limbs.
+        ::mp_limb_t lo, hi1, hi2;
+        const ::mp_limb_t cy_lo = limb_add_overflow(rop.m_limbs[0], prod[0], &lo),
+                          cy_hi1 = limb_add_overflow(rop.m_limbs[1], prod[1], &hi1),
+                          cy_hi2 = limb_add_overflow(hi1, cy_lo, &hi2);
+        // The result will overflow if we have any carry relating to the high limb.
+        if (mppp_unlikely(cy_hi1 || cy_hi2)) {
+            return 3u;
+        }
+        // For the size compuation:
+        // - cannot be zero, as prod is not zero,
+        // - if signr == +-1, then the size is either +-1 or +-2: asize is 2 if the result
+        //   has a nonzero 2nd limb, otherwise asize is 1.
+        rop._mp_size = signr * (static_cast<int>(hi2 != 0u) + 1);
+        rop.m_limbs[0] = lo;
+        rop.m_limbs[1] = hi2;
+    } else {
+        // When the signs differ, we need to implement addition as a subtraction.
+        if (asizer > asize_prod
+            || (asizer == asize_prod && integer_compare_limbs_2(&rop.m_limbs[0], &prod[0], asizer) >= 0)) {
+            // rop >= prod in absolute value.
+            const auto lo = rop.m_limbs[0] - prod[0];
+            // If there's a borrow, then hi1 > hi2, otherwise we would have a negative result.
+            assert(rop.m_limbs[0] >= prod[0] || rop.m_limbs[1] > prod[1]);
+            // This can never wrap around, at most it goes to zero.
+            const auto hi = rop.m_limbs[1] - prod[1] - static_cast<::mp_limb_t>(rop.m_limbs[0] < prod[0]);
+            // asize can be 0, 1 or 2.
+            // NOTE: see the comments in the 2-limb specialisation for addition.
+            rop._mp_size = signr * static_cast<int>((lo != 0u) | (hi != 0u)) * (static_cast<int>(hi != 0u) + 1);
+            rop.m_limbs[0] = lo;
+            rop.m_limbs[1] = hi;
+        } else {
+            // prod > rop in absolute value.
+            const auto lo = prod[0] - rop.m_limbs[0];
+            assert(prod[0] >= rop.m_limbs[0] || prod[1] > rop.m_limbs[1]);
+            const auto hi = prod[1] - rop.m_limbs[1] - static_cast<::mp_limb_t>(prod[0] < rop.m_limbs[0]);
+            // asize can be 1 or 2, but not zero as we know abs(prod) != abs(rop).
+            rop._mp_size = sign_prod * (static_cast<int>(hi != 0u) + 1);
+            rop.m_limbs[0] = lo;
+            rop.m_limbs[1] = hi;
+        }
+    }
+    return 0u;
+}
+
+template <bool AddOrSub, std::size_t SSize>
+inline std::size_t static_addsubmul(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+{
+    // NOTE: negate op2 in case we are doing a submul.
+    mpz_size_t asizer = rop._mp_size, asize1 = op1._mp_size, asize2 = AddOrSub ? op2._mp_size : -op2._mp_size;
+    int signr = asizer != 0, sign1 = asize1 != 0, sign2 = asize2 != 0;
+    if (asizer < 0) {
+        asizer = -asizer;
+        signr = -1;
+    }
+    if (asize1 < 0) {
+        asize1 = -asize1;
+        sign1 = -1;
+    }
+    if (asize2 < 0) {
+        asize2 = -asize2;
+        sign2 = -1;
+    }
+    const std::size_t retval = static_addmul_impl(rop, op1, op2, asizer, asize1, asize2, signr, sign1, sign2,
+                                                  integer_static_addmul_algo<static_int<SSize>>{});
+    if (integer_static_addmul_algo<static_int<SSize>>::value == 0 && retval == 0u) {
+        rop.zero_unused_limbs();
+    }
+    return retval;
+}
+}
+
+/// Ternary multiply–add.
+/**
+ * This function will set \p rop to <tt>rop + op1 * op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &addmul(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
+    std::size_t size_hint = 0u;
+    if (mppp_likely(sr && s1 && s2)) {
+        size_hint = static_addsubmul<true>(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
+        if (mppp_likely(size_hint == 0u)) {
+            return rop;
+        }
+    }
+    if (sr) {
+        rop._get_union().promote(size_hint);
+    }
+    ::mpz_addmul(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    return rop;
+}
+
+/// Ternary multiply–sub.
+/**
+ * This function will set \p rop to <tt>rop - op1 * op2</tt>.
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &submul(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+{
+    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
+    std::size_t size_hint = 0u;
+    if (mppp_likely(sr && s1 && s2)) {
+        size_hint = static_addsubmul<false>(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
+        if (mppp_likely(size_hint == 0u)) {
+            return rop;
         }
-        return *this;
     }
-    /// Compute next prime number (in-place version).
-    /**
-     * This method will set \p this to the first prime number greater than the current value.
-     *
-     * @return a reference to \p this.
-     */
-    integer &nextprime()
-    {
-        nextprime_impl(*this, *this);
-        return *this;
+    if (sr) {
+        rop._get_union().promote(size_hint);
     }
-    /// Test primality.
-    /**
-     * This method will run a series of probabilistic tests to determine if \p this is a prime number.
-     * It will return \p 2 if \p this is definitely a prime, \p 1 if \p this is probably a prime and \p 0 if \p this
-     * is definitely not-prime.
-     *
-     * @param reps the number of tests to run.
-     *
-     * @return an integer indicating if \p this is a prime.
-     *
-     * @throws std::invalid_argument if \p reps is less than 1 or if \p this is negative.
-     */
-    int probab_prime_p(int reps = 25) const
-    {
-        if (mppp_unlikely(reps < 1)) {
-            throw std::invalid_argument("The number of primality tests must be at least 1, but a value of "
-                                        + std::to_string(reps) + " was provided instead");
-        }
-        if (mppp_unlikely(sgn() < 0)) {
-            throw std::invalid_argument("Cannot run primality tests on the negative number " + to_string());
-        }
-        return ::mpz_probab_prime_p(get_mpz_view(), reps);
+    ::mpz_submul(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    return rop;
+}
+
+inline namespace detail
+{
+
+// Selection of the algorithm for static mul_2exp.
+template <typename SInt>
+using integer_static_mul_2exp_algo = std::integral_constant<int, (SInt::s_size > 2) ? 0 : SInt::s_size>;
+
+// mpn implementation.
+template <std::size_t SSize>
+inline std::size_t static_mul_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, std::size_t s,
+                                        const std::integral_constant<int, 0> &)
+{
+    mpz_size_t asize = n._mp_size;
+    if (s == 0u || asize == 0) {
+        // If shift is zero, or the operand is zero, write n into rop and return success.
+        rop = n;
+        return 0u;
     }
-    /// Integer square root (in-place version).
-    /**
-     * This method will set \p this to its integer square root.
-     *
-     * @return a reference to \p this.
-     *
-     * @throws std::domain_error if \p this is negative.
-     */
-    integer &sqrt()
-    {
-        mppp::sqrt(*this, *this);
-        return *this;
+    // Finish setting up asize and sign.
+    int sign = 1;
+    if (asize < 0) {
+        asize = -asize;
+        sign = -1;
     }
-    /// Test if value is odd.
-    /**
-     * @return \p true if \p this is odd, \p false otherwise.
-     */
-    bool odd_p() const
-    {
-        if (is_static()) {
-            // NOTE: as usual we assume that a zero static integer has all limbs set to zero.
-            return (m_int.g_st().m_limbs[0] & GMP_NUMB_MASK) & ::mp_limb_t(1);
+    // ls: number of entire limbs shifted.
+    // rs: effective shift that will be passed to the mpn function.
+    const std::size_t ls = s / unsigned(GMP_NUMB_BITS), rs = s % unsigned(GMP_NUMB_BITS);
+    // At the very minimum, the new asize will be the old asize plus ls.
+    // Check if we can represent it first.
+    // NOTE: use >= because we may need to increase by 1 new_asize at the end, as a size hint.
+    // LCOV_EXCL_START
+    if (mppp_unlikely(ls >= std::numeric_limits<std::size_t>::max() - static_cast<std::size_t>(asize))) {
+        // NOTE: don't think this can be hit on any setup currently.
+        throw std::overflow_error("A left bitshift value of " + std::to_string(s) + " is too large");
+    }
+    // LCOV_EXCL_STOP
+    const std::size_t new_asize = static_cast<std::size_t>(asize) + ls;
+    if (new_asize < SSize) {
+        // In this case the operation will always succeed, and we can write directly into rop.
+        ::mp_limb_t ret = 0u;
+        if (rs) {
+            // Perform the shift via the mpn function, if we are effectively shifting at least 1 bit.
+            // Overlapping is fine, as it is guaranteed that rop.m_limbs.data() + ls >= n.m_limbs.data().
+            ret = ::mpn_lshift(rop.m_limbs.data() + ls, n.m_limbs.data(), static_cast<::mp_size_t>(asize),
+                               unsigned(rs));
+            // Write bits spilling out.
+            rop.m_limbs[new_asize] = ret;
+        } else {
+            // Otherwise, just copy over (the mpn function requires the shift to be at least 1).
+            // NOTE: we have to use move_backward here because the ranges may be overlapping but not
+            // starting at the same pointer (in which case we could've used copy_limbs()). Here we know ls is not
+            // zero: we don't have a remainder, and s == 0 was already handled above. Hence, new_asize > asize.
+            assert(new_asize > static_cast<std::size_t>(asize));
+            std::move_backward(n.m_limbs.begin(), n.m_limbs.begin() + asize, rop.m_limbs.begin() + new_asize);
         }
-        return mpz_odd_p(&m_int.g_dy());
+        // Zero the lower limbs vacated by the shift. We need to do this as we don't know
+        // the state of rop.
+        std::fill(rop.m_limbs.data(), rop.m_limbs.data() + ls, ::mp_limb_t(0));
+        // Set the size.
+        rop._mp_size = sign * (static_cast<mpz_size_t>(new_asize) + (ret != 0u));
+        return 0u;
     }
-    /// Test if value is even.
-    /**
-     * @return \p true if \p this is even, \p false otherwise.
-     */
-    bool even_p() const
-    {
-        return !odd_p();
+    if (new_asize == SSize) {
+        if (rs) {
+            // In this case the operation may fail, so we need to write to temporary storage.
+            std::array<::mp_limb_t, SSize> tmp;
+            if (::mpn_lshift(tmp.data(), n.m_limbs.data(), static_cast<::mp_size_t>(asize), unsigned(rs))) {
+                return SSize + 1u;
+            }
+            // The shift was successful without spill over, copy the content from the tmp
+            // storage into rop.
+            copy_limbs_no(tmp.data(), tmp.data() + asize, rop.m_limbs.data() + ls);
+        } else {
+            // If we shifted by a multiple of the limb size, then we can write directly to rop.
+            assert(new_asize > static_cast<std::size_t>(asize));
+            std::move_backward(n.m_limbs.begin(), n.m_limbs.begin() + asize, rop.m_limbs.begin() + new_asize);
+        }
+        // Zero the lower limbs vacated by the shift.
+        std::fill(rop.m_limbs.data(), rop.m_limbs.data() + ls, ::mp_limb_t(0));
+        // Set the size.
+        rop._mp_size = sign * static_cast<mpz_size_t>(new_asize);
+        return 0u;
     }
-    /// Return a reference to the internal union.
-    /**
-     * This method returns a reference to the union used internally to implement the integer class.
-     *
-     * @return a reference to the internal union member.
-     */
-    integer_union<SSize> &_get_union()
-    {
-        return m_int;
+    // Shift is too much, the size will overflow the static limit. Return a hint for the size of the result.
+    // We checked above we can compute this safely.
+    return new_asize + 1u;
+}
+
+// 1-limb optimisation.
+template <std::size_t SSize>
+inline std::size_t static_mul_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, std::size_t s,
+                                        const std::integral_constant<int, 1> &)
+{
+    const ::mp_limb_t l = n.m_limbs[0] & GMP_NUMB_MASK;
+    if (s == 0u || l == 0u) {
+        // If shift is zero, or the operand is zero, write n into rop and return success.
+        rop = n;
+        return 0u;
     }
-    /// Return a const reference to the internal union.
-    /**
-     * This method returns a const reference to the union used internally to implement the integer class.
-     *
-     * @return a const reference to the internal union member.
-     */
-    const integer_union<SSize> &_get_union() const
-    {
-        return m_int;
+    if (mppp_unlikely(s >= unsigned(GMP_NUMB_BITS) || (l >> (unsigned(GMP_NUMB_BITS) - s)))) {
+        // The two conditions:
+        // - if the shift is >= number of data bits, the operation will certainly
+        //   fail (as the operand is nonzero);
+        // - shifting by s would overflow  the single limb.
+        // NOTE: s is at least 1, so in the right shift above we never risk UB due to too much shift.
+        // NOTE: for the size hint: s / nbits is the number of entire limbs shifted, +1 because the shifted
+        // limbs add to the current size (1), +1 because another limb might be needed.
+        // NOTE: paranoia static assert to make sure there's no chance of overflowing.
+        static_assert(GMP_NUMB_BITS > 1, "Invalid number of bits.");
+        return s / unsigned(GMP_NUMB_BITS) + 2u;
     }
-    /// Get a pointer to the dynamic storage.
-    /**
-     * This method will first promote \p this to dynamic storage (if \p this is not already employing dynamic storage),
-     * and it will then return a pointer to the internal \p mpz_t structure. The returned pointer can be used as an
-     * argument for the functions of the GMP API.
-     *
-     * \rststar
-     * .. note::
-     *
-     *    The returned pointer is a raw, non-owning pointer tied to the lifetime of ``this``. Calling
-     *    :cpp:func:`~mppp::integer::demote()` or
-     *    assigning an :cpp:class:`~mppp::integer` with static storage to ``this`` will invalidate the returned
-     *    pointer.
-     * \endrststar
-     *
-     * @return a pointer to the internal \p mpz_t structure.
-     */
-    std::remove_extent<::mpz_t>::type *get_mpz_t()
-    {
-        promote();
-        return &m_int.g_dy();
+    // Write out.
+    rop.m_limbs[0] = l << s;
+    // Size is the same as the input value.
+    rop._mp_size = n._mp_size;
+    return 0u;
+}
+
+// 2-limb optimisation.
+template <std::size_t SSize>
+inline std::size_t static_mul_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, std::size_t s,
+                                        const std::integral_constant<int, 2> &)
+{
+    mpz_size_t asize = n._mp_size;
+    if (s == 0u || asize == 0) {
+        rop = n;
+        return 0u;
     }
-    /// Test if the value is zero.
-    /**
-     * @return \p true if the value represented by \p this is zero, \p false otherwise.
-     */
-    bool is_zero() const
-    {
-        return m_int.m_st._mp_size == 0;
+    int sign = 1;
+    if (asize < 0) {
+        asize = -asize;
+        sign = -1;
     }
-
-private:
-    // Implementation of is_one()/is_negative_one().
-    template <int One>
-    bool is_one_impl() const
-    {
-        if (m_int.m_st._mp_size != One) {
-            return false;
+    // Too much shift, this can never work on a nonzero value.
+    static_assert(unsigned(GMP_NUMB_BITS) <= std::numeric_limits<unsigned>::max() / 2u, "Overflow error.");
+    if (mppp_unlikely(s >= 2u * unsigned(GMP_NUMB_BITS))) {
+        // NOTE: this is the generic formula to estimate the final size.
+        // NOTE: paranoia static assert to make sure there's no chance of overflowing.
+        static_assert(GMP_NUMB_BITS > 1, "Invalid number of bits.");
+        // NOTE: asize is 2 at most, no need to check for overflow.
+        return s / unsigned(GMP_NUMB_BITS) + 1u + static_cast<std::size_t>(asize);
+    }
+    if (s == unsigned(GMP_NUMB_BITS)) {
+        // This case can be dealt with moving lo into hi, but only if asize is 1.
+        if (mppp_unlikely(asize == 2)) {
+            // asize is 2, shift is too much.
+            return 3u;
         }
-        // Get the pointer to the limbs.
-        const ::mp_limb_t *ptr = is_static() ? m_int.g_st().m_limbs.data() : m_int.g_dy()._mp_d;
-        return (ptr[0] & GMP_NUMB_MASK) == 1u;
+        rop.m_limbs[1u] = n.m_limbs[0u];
+        rop.m_limbs[0u] = 0u;
+        // The asize has to be 2.
+        rop._mp_size = 2 * sign;
+        return 0u;
     }
-
-public:
-    /// Test if the value is equal to one.
-    /**
-     * @return \p true if the value represented by \p this is 1, \p false otherwise.
-     */
-    bool is_one() const
-    {
-        return is_one_impl<1>();
+    // Temp hi lo limbs to store the result that will eventually go into rop.
+    ::mp_limb_t lo = n.m_limbs[0u], hi = n.m_limbs[1u];
+    if (s > unsigned(GMP_NUMB_BITS)) {
+        if (mppp_unlikely(asize == 2)) {
+            return s / unsigned(GMP_NUMB_BITS) + 1u + static_cast<std::size_t>(asize);
+        }
+        // Move lo to hi and set lo to zero.
+        hi = n.m_limbs[0u];
+        lo = 0u;
+        // Update the shift.
+        s = static_cast<std::size_t>(s - unsigned(GMP_NUMB_BITS));
     }
-    /// Test if the value is equal to minus one.
-    /**
-     * @return \p true if the value represented by \p this is -1, \p false otherwise.
-     */
-    bool is_negative_one() const
-    {
-        return is_one_impl<-1>();
+    // Check that hi will not be shifted too much. Note that
+    // here and below s can never be zero, so we never shift too much.
+    assert(s > 0u && s < unsigned(GMP_NUMB_BITS));
+    if (mppp_unlikely((hi & GMP_NUMB_MASK) >> (unsigned(GMP_NUMB_BITS) - s))) {
+        return 3u;
     }
-
-private:
-    integer_union<SSize> m_int;
-};
-
-#if MPPP_CPLUSPLUS < 201703L
-
-// NOTE: from C++17 static constexpr members are implicitly inline, and it's not necessary
-// any more (actually, it's deprecated) to re-declare them outside the class.
-// https://stackoverflow.com/questions/39646958/constexpr-static-member-before-after-c17
+    // Shift hi and lo. hi gets the carry over from lo.
+    hi = ((hi & GMP_NUMB_MASK) << s) + ((lo & GMP_NUMB_MASK) >> (unsigned(GMP_NUMB_BITS) - s));
+    // NOTE: here the result needs to be masked as well as the shift could
+    // end up writing in nail bits.
+    lo = ((lo & GMP_NUMB_MASK) << s) & GMP_NUMB_MASK;
+    // Write rop.
+    rop.m_limbs[0u] = lo;
+    rop.m_limbs[1u] = hi;
+    // asize is at least 1.
+    rop._mp_size = sign * (1 + (hi != 0u));
+    return 0u;
+}
 
 template <std::size_t SSize>
-constexpr std::size_t integer<SSize>::ssize;
-
-#endif
-
-/** @defgroup integer_assignment integer_assignment
- *  @{
- */
+inline std::size_t static_mul_2exp(static_int<SSize> &rop, const static_int<SSize> &n, std::size_t s)
+{
+    const std::size_t retval = static_mul_2exp_impl(rop, n, s, integer_static_mul_2exp_algo<static_int<SSize>>{});
+    if (integer_static_mul_2exp_algo<static_int<SSize>>::value == 0 && retval == 0u) {
+        rop.zero_unused_limbs();
+    }
+    return retval;
+}
+}
 
-/// Set to zero.
+/// Ternary left shift.
 /**
- * After calling this function, the storage type of \p n will be static and its value will be zero.
- *
- * \rststar
- * .. note::
+ * This function will set \p rop to \p n multiplied by <tt>2**s</tt>.
  *
- *   This is a specialised higher-performance alternative to the assignment operator.
- * \endrststar
+ * @param rop the return value.
+ * @param n the multiplicand.
+ * @param s the bit shift value.
  *
- * @param n the assignment argument.
+ * @return a reference to \p rop.
  *
- * @return a reference to \p n.
+ * @throws std::overflow_error if \p s is larger than an implementation-defined limit.
  */
 template <std::size_t SSize>
-inline integer<SSize> &set_zero(integer<SSize> &n)
+inline integer<SSize> &mul_2exp(integer<SSize> &rop, const integer<SSize> &n, ::mp_bitcnt_t s)
 {
-    return n.set_zero();
+    const bool sn = n.is_static();
+    bool sr = rop.is_static();
+    std::size_t size_hint = 0u;
+    if (mppp_likely(sn)) {
+        // NOTE: we cast to size_t because it's more convenient for reasoning about number of limbs
+        // in the implementation functions.
+        // NOTE: do it before touching rop, for exception safety.
+        const auto s_size = safe_cast<std::size_t>(s);
+        if (!sr) {
+            rop.set_zero();
+            sr = true;
+        }
+        size_hint = static_mul_2exp(rop._get_union().g_st(), n._get_union().g_st(), s_size);
+        if (mppp_likely(size_hint == 0u)) {
+            return rop;
+        }
+    }
+    if (sr) {
+        rop._get_union().promote(size_hint);
+    }
+    ::mpz_mul_2exp(&rop._get_union().g_dy(), n.get_mpz_view(), s);
+    return rop;
 }
 
-/// Set to one.
+/// Binary negation.
 /**
- * After calling this function, the storage type of \p n will be static and its value will be one.
- *
- * \rststar
- * .. note::
- *
- *   This is a specialised higher-performance alternative to the assignment operator.
- * \endrststar
+ * This method will set \p rop to <tt>-n</tt>.
  *
- * @param n the assignment argument.
+ * @param rop the return value.
+ * @param n the integer that will be negated.
  *
- * @return a reference to \p n.
+ * @return a reference to \p rop.
  */
 template <std::size_t SSize>
-inline integer<SSize> &set_one(integer<SSize> &n)
+inline integer<SSize> &neg(integer<SSize> &rop, const integer<SSize> &n)
 {
-    return n.set_one();
+    rop = n;
+    return rop.neg();
 }
 
-/// Set to minus one.
+/// Unary negation.
 /**
- * After calling this function, the storage type of \p n will be static and its value will be minus one.
- *
- * \rststar
- * .. note::
- *
- *   This is a specialised higher-performance alternative to the assignment operator.
- * \endrststar
- *
- * @param n the assignment argument.
+ * @param n the integer that will be negated.
  *
- * @return a reference to \p n.
+ * @return <tt>-n</tt>.
  */
 template <std::size_t SSize>
-inline integer<SSize> &set_negative_one(integer<SSize> &n)
+inline integer<SSize> neg(const integer<SSize> &n)
 {
-    return n.set_negative_one();
+    integer<SSize> ret(n);
+    ret.neg();
+    return ret;
 }
 
-/** @} */
-
-/** @defgroup integer_conversion integer_conversion
- *  @{
- */
-
-/// Generic conversion function for \link mppp::integer integer\endlink.
+/// Binary absolute value.
 /**
- * \rststar
- * This function will convert the input :cpp:class:`~mppp::integer` ``n`` to a
- * :cpp:concept:`~mppp::CppInteroperable` type, storing the result of the conversion into ``rop``.
- * If the conversion is successful, the function
- * will return ``true``, otherwise the function will return ``false``. If the conversion fails, ``rop`` will
- * not be altered.
- * \endrststar
+ * This function will set \p rop to the absolute value of \p n.
  *
- * @param rop the variable which will store the result of the conversion.
- * @param n the input \link mppp::integer integer\endlink.
+ * @param rop the return value.
+ * @param n the argument.
  *
- * @return ``true`` if the conversion succeeded, ``false`` otherwise. The conversion can fail only if ``rop`` is
- * a C++ integral which cannot represent the value of ``n``.
+ * @return a reference to \p rop.
  */
-#if defined(MPPP_HAVE_CONCEPTS)
 template <std::size_t SSize>
-inline bool get(CppInteroperable &rop, const integer<SSize> &n)
-#else
-template <typename T, std::size_t SSize, cpp_interoperable_enabler<T> = 0>
-inline bool get(T &rop, const integer<SSize> &n)
-#endif
-{
-    return n.get(rop);
-}
-
-/** @} */
-
-inline namespace detail
+inline integer<SSize> &abs(integer<SSize> &rop, const integer<SSize> &n)
 {
+    rop = n;
+    return rop.abs();
+}
 
-// Machinery for the determination of the result of a binary operation involving integer.
-// Default is empty for SFINAE.
-template <typename, typename, typename = void>
-struct integer_common_type {
-};
-
-template <std::size_t SSize>
-struct integer_common_type<integer<SSize>, integer<SSize>> {
-    using type = integer<SSize>;
-};
-
-template <std::size_t SSize, typename U>
-struct integer_common_type<integer<SSize>, U, enable_if_t<is_supported_integral<U>::value>> {
-    using type = integer<SSize>;
-};
-
-template <std::size_t SSize, typename T>
-struct integer_common_type<T, integer<SSize>, enable_if_t<is_supported_integral<T>::value>> {
-    using type = integer<SSize>;
-};
-
-template <std::size_t SSize, typename U>
-struct integer_common_type<integer<SSize>, U, enable_if_t<is_supported_float<U>::value>> {
-    using type = U;
-};
-
-template <std::size_t SSize, typename T>
-struct integer_common_type<T, integer<SSize>, enable_if_t<is_supported_float<T>::value>> {
-    using type = T;
-};
-
-template <typename T, typename U>
-using integer_common_t = typename integer_common_type<T, U>::type;
-
-// Various utilities, concepts, enablers used in both the operators and the functions.
-template <typename T, typename U>
-struct is_same_ssize_integer : std::false_type {
-};
-
-template <std::size_t SSize>
-struct is_same_ssize_integer<integer<SSize>, integer<SSize>> : std::true_type {
-};
-
-template <typename T>
-struct is_integer : std::false_type {
-};
-
+/// Unary absolute value.
+/**
+ * @param n the argument.
+ *
+ * @return the absolute value of \p n.
+ */
 template <std::size_t SSize>
-struct is_integer<integer<SSize>> : std::true_type {
-};
+inline integer<SSize> abs(const integer<SSize> &n)
+{
+    integer<SSize> ret(n);
+    ret.abs();
+    return ret;
 }
 
-template <typename T, typename U>
-#if defined(MPPP_HAVE_CONCEPTS)
-concept bool IntegerOpTypes
-    = is_same_ssize_integer<T, U>::value
-      || (is_integer<T>::value && CppInteroperable<U>) || (is_integer<U>::value && CppInteroperable<T>);
-#else
-using integer_op_types_enabler
-    = enable_if_t<disjunction<is_same_ssize_integer<T, U>, conjunction<is_integer<T>, is_cpp_interoperable<U>>,
-                              conjunction<is_integer<U>, is_cpp_interoperable<T>>>::value,
-                  int>;
-#endif
-
-template <typename T, typename U>
-#if defined(MPPP_HAVE_CONCEPTS)
-concept bool IntegerIntegralOpTypes
-    = is_same_ssize_integer<T, U>::value || (is_integer<T>::value && CppInteroperable<U> && std::is_integral<U>::value)
-      || (is_integer<U>::value && CppInteroperable<T> && std::is_integral<T>::value);
-#else
-using integer_integral_op_types_enabler = enable_if_t<
-    disjunction<is_same_ssize_integer<T, U>, conjunction<is_integer<T>, is_cpp_interoperable<U>, std::is_integral<U>>,
-                conjunction<is_integer<U>, is_cpp_interoperable<T>, std::is_integral<T>>>::value,
-    int>;
-#endif
+/** @} */
 
-/** @defgroup integer_arithmetic integer_arithmetic
+/** @defgroup integer_division integer_division
  *  @{
  */
 
 inline namespace detail
 {
 
-// Metaprogramming for selecting the algorithm for static addition. The selection happens via
-// an std::integral_constant with 3 possible values:
-// - 0 (default case): use the GMP mpn functions,
-// - 1: selected when there are no nail bits and the static size is 1,
-// - 2: selected when there are no nail bits and the static size is 2.
-template <typename SInt>
-using integer_static_add_algo = std::integral_constant<
-    int, (!GMP_NAIL_BITS && SInt::s_size == 1) ? 1 : ((!GMP_NAIL_BITS && SInt::s_size == 2) ? 2 : 0)>;
+// Detect the presence of dual-limb division. This is currently possible only if:
+// - we are on a 32bit build (with the usual constraints that the types have exactly 32/64 bits and no nails),
+// - we are on a 64bit build and we have the 128bit int type available (plus usual constraints).
+// MSVC currently does not provide any primitive for 128bit division.
+using integer_have_dlimb_div = std::integral_constant<bool,
+#if defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64)
+                                                      !GMP_NAIL_BITS && std::numeric_limits<::mp_limb_t>::digits == 64
+#elif GMP_NUMB_BITS == 32
+                                                      !GMP_NAIL_BITS
+                                                          && std::numeric_limits<std::uint_least64_t>::digits == 64
+                                                          && std::numeric_limits<::mp_limb_t>::digits == 32
+#else
+                                                      false
+#endif
+                                                      >;
 
-// General implementation via mpn.
-// Small helper to compute the size after subtraction via mpn. s is a strictly positive size.
-inline mpz_size_t integer_sub_compute_size(const ::mp_limb_t *rdata, mpz_size_t s)
-{
-    assert(s > 0);
-    mpz_size_t cur_idx = s - 1;
-    for (; cur_idx >= 0; --cur_idx) {
-        if (rdata[cur_idx] & GMP_NUMB_MASK) {
-            break;
-        }
-    }
-    return cur_idx + 1;
-}
+// Selection of algorithm for static division:
+// - for 1 limb, we can always do static division,
+// - for 2 limbs, we need the dual limb division if avaiable,
+// - otherwise we just use the mpn functions.
+template <typename SInt>
+using integer_static_div_algo
+    = std::integral_constant<int,
+                             SInt::s_size == 1 ? 1 : ((SInt::s_size == 2 && integer_have_dlimb_div::value) ? 2 : 0)>;
 
-// NOTE: this function (and its other overloads) will return true in case of success, false in case of failure
-// (i.e., the addition overflows and the static size is not enough).
+// mpn implementation.
 template <std::size_t SSize>
-inline bool static_add_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+inline void static_div_impl(static_int<SSize> &q, static_int<SSize> &r, const static_int<SSize> &op1,
+                            const static_int<SSize> &op2, mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
                             const std::integral_constant<int, 0> &)
 {
-    auto rdata = &rop.m_limbs[0];
-    auto data1 = &op1.m_limbs[0], data2 = &op2.m_limbs[0];
-    const auto size1 = op1._mp_size;
-    // NOTE: cannot trust the size member from op2, as op2 could've been negated if
-    // we are actually subtracting.
-    const auto size2 = (sign2 >= 0) ? asize2 : -asize2;
-    // mpn functions require nonzero arguments.
-    if (mppp_unlikely(!sign2)) {
-        rop._mp_size = size1;
-        copy_limbs(data1, data1 + asize1, rdata);
-        return true;
+    // First we check if the divisor is larger than the dividend (in abs limb size), as the mpn function
+    // requires asize1 >= asize2.
+    if (asize2 > asize1) {
+        // Copy op1 into the remainder.
+        r = op1;
+        // Zero out q.
+        q._mp_size = 0;
+        return;
     }
-    if (mppp_unlikely(!sign1)) {
-        rop._mp_size = size2;
-        copy_limbs(data2, data2 + asize2, rdata);
-        return true;
+    // We need to take care of potentially overlapping arguments. We know that q and r are distinct, but op1
+    // could overlap with q or r, and op2 could overlap with op1, q or r.
+    std::array<::mp_limb_t, SSize> op1_alt, op2_alt;
+    const ::mp_limb_t *data1 = op1.m_limbs.data();
+    const ::mp_limb_t *data2 = op2.m_limbs.data();
+    if (&op1 == &q || &op1 == &r) {
+        copy_limbs_no(data1, data1 + asize1, op1_alt.data());
+        data1 = op1_alt.data();
     }
-    // Check, for op1 and op2, whether:
-    // - the asize is the max static size, and, if yes,
-    // - the highest bit in the highest limb is set.
-    // If this condition holds for op1 and op2, we return failure, as the computation might require
-    // an extra limb.
-    // NOTE: the reason we check this is that we do not want to run into the situation in which we have written
-    // something into rop (via the mpn functions below), only to realize later that the computation overflows.
-    // This would be bad because, in case of overlapping arguments, it would destroy one or two operands without
-    // possibility of recovering. The alternative would be to do the computation in some local buffer and then
-    // copy it out, but that is rather costly. Note that this means that in principle a computation that could fit in
-    // static storage ends up triggering a promotion.
-    const bool c1 = std::size_t(asize1) == SSize && ((data1[asize1 - 1] & GMP_NUMB_MASK) >> (GMP_NUMB_BITS - 1));
-    const bool c2 = std::size_t(asize2) == SSize && ((data2[asize2 - 1] & GMP_NUMB_MASK) >> (GMP_NUMB_BITS - 1));
-    if (mppp_unlikely(c1 || c2)) {
-        return false;
+    if (&op2 == &q || &op2 == &r || &op1 == &op2) {
+        copy_limbs_no(data2, data2 + asize2, op2_alt.data());
+        data2 = op2_alt.data();
     }
-    if (sign1 == sign2) {
-        // Same sign.
-        if (asize1 >= asize2) {
-            // The number of limbs of op1 >= op2.
-            ::mp_limb_t cy;
-            if (asize2 == 1) {
-                // NOTE: we are not masking data2[0] with GMP_NUMB_MASK, I am assuming the mpn function
-                // is able to deal with a limb with a nail.
-                cy = ::mpn_add_1(rdata, data1, static_cast<::mp_size_t>(asize1), data2[0]);
-            } else if (asize1 == asize2) {
-                cy = ::mpn_add_n(rdata, data1, data2, static_cast<::mp_size_t>(asize1));
-            } else {
-                cy = ::mpn_add(rdata, data1, static_cast<::mp_size_t>(asize1), data2, static_cast<::mp_size_t>(asize2));
-            }
-            if (cy) {
-                assert(asize1 < static_int<SSize>::s_size);
-                rop._mp_size = size1 + sign1;
-                // NOTE: there should be no need to use GMP_NUMB_MASK here.
-                rdata[asize1] = 1u;
-            } else {
-                // Without carry, the size is unchanged.
-                rop._mp_size = size1;
-            }
-        } else {
-            // The number of limbs of op2 > op1.
-            ::mp_limb_t cy;
-            if (asize1 == 1) {
-                cy = ::mpn_add_1(rdata, data2, static_cast<::mp_size_t>(asize2), data1[0]);
-            } else {
-                cy = ::mpn_add(rdata, data2, static_cast<::mp_size_t>(asize2), data1, static_cast<::mp_size_t>(asize1));
-            }
-            if (cy) {
-                assert(asize2 < static_int<SSize>::s_size);
-                rop._mp_size = size2 + sign2;
-                rdata[asize2] = 1u;
-            } else {
-                rop._mp_size = size2;
-            }
-        }
+    // Small helper function to verify that all pointers are distinct. Used exclusively for debugging purposes.
+    auto distinct_op = [&q, &r, data1, data2]() -> bool {
+        const ::mp_limb_t *ptrs[] = {q.m_limbs.data(), r.m_limbs.data(), data1, data2};
+        std::sort(ptrs, ptrs + 4, std::less<const ::mp_limb_t *>());
+        return std::unique(ptrs, ptrs + 4) == (ptrs + 4);
+    };
+    (void)distinct_op;
+    assert(distinct_op());
+    // Proceed to the division.
+    if (asize2 == 1) {
+        // Optimization when the divisor has 1 limb.
+        r.m_limbs[0]
+            = ::mpn_divrem_1(q.m_limbs.data(), ::mp_size_t(0), data1, static_cast<::mp_size_t>(asize1), data2[0]);
     } else {
-        if (asize1 > asize2 || (asize1 == asize2 && ::mpn_cmp(data1, data2, static_cast<::mp_size_t>(asize1)) >= 0)) {
-            // abs(op1) >= abs(op2).
-            ::mp_limb_t br;
-            if (asize2 == 1) {
-                br = ::mpn_sub_1(rdata, data1, static_cast<::mp_size_t>(asize1), data2[0]);
-            } else if (asize1 == asize2) {
-                br = ::mpn_sub_n(rdata, data1, data2, static_cast<::mp_size_t>(asize1));
-            } else {
-                br = ::mpn_sub(rdata, data1, static_cast<::mp_size_t>(asize1), data2, static_cast<::mp_size_t>(asize2));
-            }
-            assert(!br);
-            rop._mp_size = integer_sub_compute_size(rdata, asize1);
-            if (sign1 != 1) {
-                rop._mp_size = -rop._mp_size;
-            }
-        } else {
-            // abs(op2) > abs(op1).
-            ::mp_limb_t br;
-            if (asize1 == 1) {
-                br = ::mpn_sub_1(rdata, data2, static_cast<::mp_size_t>(asize2), data1[0]);
-            } else {
-                br = ::mpn_sub(rdata, data2, static_cast<::mp_size_t>(asize2), data1, static_cast<::mp_size_t>(asize1));
-            }
-            assert(!br);
-            rop._mp_size = integer_sub_compute_size(rdata, asize2);
-            if (sign2 != 1) {
-                rop._mp_size = -rop._mp_size;
-            }
-        }
+        // General implementation.
+        ::mpn_tdiv_qr(q.m_limbs.data(), r.m_limbs.data(), ::mp_size_t(0), data1, static_cast<::mp_size_t>(asize1),
+                      data2, static_cast<::mp_size_t>(asize2));
     }
-    return true;
+    // Complete the quotient: compute size and sign.
+    q._mp_size = asize1 - asize2 + 1;
+    while (q._mp_size && !(q.m_limbs[static_cast<std::size_t>(q._mp_size - 1)] & GMP_NUMB_MASK)) {
+        --q._mp_size;
+    }
+    if (sign1 != sign2) {
+        q._mp_size = -q._mp_size;
+    }
+    // Complete the remainder.
+    r._mp_size = asize2;
+    while (r._mp_size && !(r.m_limbs[static_cast<std::size_t>(r._mp_size - 1)] & GMP_NUMB_MASK)) {
+        --r._mp_size;
+    }
+    if (sign1 == -1) {
+        r._mp_size = -r._mp_size;
+    }
+}
+
+// 1-limb optimisation.
+template <std::size_t SSize>
+inline void static_div_impl(static_int<SSize> &q, static_int<SSize> &r, const static_int<SSize> &op1,
+                            const static_int<SSize> &op2, mpz_size_t, mpz_size_t, int sign1, int sign2,
+                            const std::integral_constant<int, 1> &)
+{
+    // NOTE: here we have to use GMP_NUMB_MASK because if s_size is 1 this implementation is *always*
+    // called, even if we have nail bits (whereas the optimisation for other operations currently kicks in
+    // only without nail bits). Thus, we need to discard from m_limbs[0] the nail bits before doing the
+    // division.
+    const ::mp_limb_t q_ = (op1.m_limbs[0] & GMP_NUMB_MASK) / (op2.m_limbs[0] & GMP_NUMB_MASK),
+                      r_ = (op1.m_limbs[0] & GMP_NUMB_MASK) % (op2.m_limbs[0] & GMP_NUMB_MASK);
+    // Write q.
+    q._mp_size = sign1 * sign2 * (q_ != 0u);
+    // NOTE: there should be no need here to mask.
+    q.m_limbs[0] = q_;
+    // Write r.
+    // Following C++11, the sign of r is the sign of op1:
+    // http://stackoverflow.com/questions/13100711/operator-modulo-change-in-c-11
+    r._mp_size = sign1 * (r_ != 0u);
+    r.m_limbs[0] = r_;
+}
+
+#if defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
+inline void dlimb_div(::mp_limb_t op11, ::mp_limb_t op12, ::mp_limb_t op21, ::mp_limb_t op22,
+                      ::mp_limb_t *MPPP_RESTRICT q1, ::mp_limb_t *MPPP_RESTRICT q2, ::mp_limb_t *MPPP_RESTRICT r1,
+                      ::mp_limb_t *MPPP_RESTRICT r2)
+{
+    using dlimb_t = MPPP_UINT128;
+    const auto op1 = op11 + (dlimb_t(op12) << 64);
+    const auto op2 = op21 + (dlimb_t(op22) << 64);
+    const auto q = op1 / op2, r = op1 % op2;
+    *q1 = static_cast<::mp_limb_t>(q & ::mp_limb_t(-1));
+    *q2 = static_cast<::mp_limb_t>(q >> 64);
+    *r1 = static_cast<::mp_limb_t>(r & ::mp_limb_t(-1));
+    *r2 = static_cast<::mp_limb_t>(r >> 64);
 }
 
-// Optimization for single-limb statics with no nails.
+// Without remainder.
+inline void dlimb_div(::mp_limb_t op11, ::mp_limb_t op12, ::mp_limb_t op21, ::mp_limb_t op22,
+                      ::mp_limb_t *MPPP_RESTRICT q1, ::mp_limb_t *MPPP_RESTRICT q2)
+{
+    using dlimb_t = MPPP_UINT128;
+    const auto op1 = op11 + (dlimb_t(op12) << 64);
+    const auto op2 = op21 + (dlimb_t(op22) << 64);
+    const auto q = op1 / op2;
+    *q1 = static_cast<::mp_limb_t>(q & ::mp_limb_t(-1));
+    *q2 = static_cast<::mp_limb_t>(q >> 64);
+}
+
+#elif GMP_NUMB_BITS == 32 && !GMP_NAIL_BITS
+
+inline void dlimb_div(::mp_limb_t op11, ::mp_limb_t op12, ::mp_limb_t op21, ::mp_limb_t op22,
+                      ::mp_limb_t *MPPP_RESTRICT q1, ::mp_limb_t *MPPP_RESTRICT q2, ::mp_limb_t *MPPP_RESTRICT r1,
+                      ::mp_limb_t *MPPP_RESTRICT r2)
+{
+    using dlimb_t = std::uint_least64_t;
+    const auto op1 = op11 + (dlimb_t(op12) << 32);
+    const auto op2 = op21 + (dlimb_t(op22) << 32);
+    const auto q = op1 / op2, r = op1 % op2;
+    *q1 = static_cast<::mp_limb_t>(q & ::mp_limb_t(-1));
+    *q2 = static_cast<::mp_limb_t>(q >> 32);
+    *r1 = static_cast<::mp_limb_t>(r & ::mp_limb_t(-1));
+    *r2 = static_cast<::mp_limb_t>(r >> 32);
+}
+
+inline void dlimb_div(::mp_limb_t op11, ::mp_limb_t op12, ::mp_limb_t op21, ::mp_limb_t op22,
+                      ::mp_limb_t *MPPP_RESTRICT q1, ::mp_limb_t *MPPP_RESTRICT q2)
+{
+    using dlimb_t = std::uint_least64_t;
+    const auto op1 = op11 + (dlimb_t(op12) << 32);
+    const auto op2 = op21 + (dlimb_t(op22) << 32);
+    const auto q = op1 / op2;
+    *q1 = static_cast<::mp_limb_t>(q & ::mp_limb_t(-1));
+    *q2 = static_cast<::mp_limb_t>(q >> 32);
+}
+
+#endif
+
+// 2-limbs optimisation.
 template <std::size_t SSize>
-inline bool static_add_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                            const std::integral_constant<int, 1> &)
+inline void static_div_impl(static_int<SSize> &q, static_int<SSize> &r, const static_int<SSize> &op1,
+                            const static_int<SSize> &op2, mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                            const std::integral_constant<int, 2> &)
 {
-    auto rdata = &rop.m_limbs[0];
-    auto data1 = &op1.m_limbs[0], data2 = &op2.m_limbs[0];
-    // NOTE: both asizes have to be 0 or 1 here.
-    assert((asize1 == 1 && data1[0] != 0u) || (asize1 == 0 && data1[0] == 0u));
-    assert((asize2 == 1 && data2[0] != 0u) || (asize2 == 0 && data2[0] == 0u));
-    ::mp_limb_t tmp;
-    if (sign1 == sign2) {
-        // When the signs are identical, we can implement addition as a true addition.
-        if (mppp_unlikely(limb_add_overflow(data1[0], data2[0], &tmp))) {
-            return false;
-        }
-        // Assign the output. asize can be zero (sign1 == sign2 == 0) or 1.
-        rop._mp_size = sign1;
-        rdata[0] = tmp;
-    } else {
-        // When the signs differ, we need to implement addition as a subtraction.
-        // NOTE: this also includes the case in which only one of the operands is zero.
-        if (data1[0] >= data2[0]) {
-            // op1 is not smaller than op2.
-            tmp = data1[0] - data2[0];
-            // asize is either 1 or 0 (0 iff abs(op1) == abs(op2)).
-            rop._mp_size = sign1 * static_cast<int>(tmp != 0u);
-            rdata[0] = tmp;
-        } else {
-            // NOTE: this has to be one, as data2[0] and data1[0] cannot be equal.
-            rop._mp_size = sign2;
-            rdata[0] = data2[0] - data1[0];
-        }
+    if (asize1 < 2 && asize2 < 2) {
+        // NOTE: testing indicates that it pays off to optimize the case in which the operands have
+        // fewer than 2 limbs. This a slightly modified version of the 1-limb division from above,
+        // without the need to mask as this function is called only if there are no nail bits.
+        const ::mp_limb_t q_ = op1.m_limbs[0] / op2.m_limbs[0], r_ = op1.m_limbs[0] % op2.m_limbs[0];
+        q._mp_size = sign1 * sign2 * (q_ != 0u);
+        q.m_limbs[0] = q_;
+        q.m_limbs[1] = 0u;
+        r._mp_size = sign1 * (r_ != 0u);
+        r.m_limbs[0] = r_;
+        r.m_limbs[1] = 0u;
+        return;
     }
-    return true;
+    // Perform the division.
+    ::mp_limb_t q1, q2, r1, r2;
+    dlimb_div(op1.m_limbs[0], op1.m_limbs[1], op2.m_limbs[0], op2.m_limbs[1], &q1, &q2, &r1, &r2);
+    // Write out.
+    q._mp_size = sign1 * sign2 * (q2 ? 2 : (q1 ? 1 : 0));
+    q.m_limbs[0] = q1;
+    q.m_limbs[1] = q2;
+    r._mp_size = sign1 * (r2 ? 2 : (r1 ? 1 : 0));
+    r.m_limbs[0] = r1;
+    r.m_limbs[1] = r2;
 }
 
-// Optimization for two-limbs statics with no nails.
-// Small helper to compare two statics of equal asize 1 or 2.
-inline int integer_compare_limbs_2(const ::mp_limb_t *data1, const ::mp_limb_t *data2, mpz_size_t asize)
+template <std::size_t SSize>
+inline void static_div(static_int<SSize> &q, static_int<SSize> &r, const static_int<SSize> &op1,
+                       const static_int<SSize> &op2)
 {
-    // NOTE: this requires no nail bits.
-    assert(!GMP_NAIL_BITS);
-    assert(asize == 1 || asize == 2);
-    // Start comparing from the top.
-    auto cmp_idx = asize - 1;
-    if (data1[cmp_idx] != data2[cmp_idx]) {
-        return data1[cmp_idx] > data2[cmp_idx] ? 1 : -1;
+    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
+    int sign1 = asize1 != 0, sign2 = asize2 != 0;
+    if (asize1 < 0) {
+        asize1 = -asize1;
+        sign1 = -1;
     }
-    // The top limbs are equal, move down one limb.
-    // If we are already at the bottom limb, it means the two numbers are equal.
-    if (!cmp_idx) {
-        return 0;
+    if (asize2 < 0) {
+        asize2 = -asize2;
+        sign2 = -1;
     }
-    --cmp_idx;
-    if (data1[cmp_idx] != data2[cmp_idx]) {
-        return data1[cmp_idx] > data2[cmp_idx] ? 1 : -1;
+    static_div_impl(q, r, op1, op2, asize1, asize2, sign1, sign2, integer_static_div_algo<static_int<SSize>>{});
+    if (integer_static_div_algo<static_int<SSize>>::value == 0) {
+        q.zero_unused_limbs();
+        r.zero_unused_limbs();
     }
-    return 0;
 }
 
+// Exact division.
+// mpn implementation.
 template <std::size_t SSize>
-inline bool static_add_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                            mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                            const std::integral_constant<int, 2> &)
+inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                 mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                                 const std::integral_constant<int, 0> &)
 {
-    auto rdata = &rop.m_limbs[0];
-    auto data1 = &op1.m_limbs[0], data2 = &op2.m_limbs[0];
-    if (sign1 == sign2) {
-        // NOTE: this handles the case in which the numbers have the same sign, including 0 + 0.
-        //
-        // NOTE: this is the implementation for 2 limbs, even if potentially the operands have 1 limb.
-        // The idea here is that it's better to do a few computations more rather than paying the branching
-        // cost. 1-limb operands will have the upper limb set to zero from the zero-initialization of
-        // the limbs of static ints.
-        //
-        // NOTE: the rop hi limb might spill over either from the addition of the hi limbs
-        // of op1 and op2, or by the addition of carry coming over from the addition of
-        // the lo limbs of op1 and op2.
-        //
-        // Add the hi and lo limbs.
-        const auto a = data1[0], b = data2[0], c = data1[1], d = data2[1];
-        ::mp_limb_t lo, hi1, hi2;
-        const ::mp_limb_t cy_lo = limb_add_overflow(a, b, &lo), cy_hi1 = limb_add_overflow(c, d, &hi1),
-                          cy_hi2 = limb_add_overflow(hi1, cy_lo, &hi2);
-        // The result will overflow if we have any carry relating to the high limb.
-        if (mppp_unlikely(cy_hi1 || cy_hi2)) {
-            return false;
+    if (asize1 == 0) {
+        // Special casing if the numerator is zero (the mpn functions do not work with zero operands).
+        q._mp_size = 0;
+        return;
+    }
+#if __GNU_MP_VERSION > 6 || (__GNU_MP_VERSION == 6 && __GNU_MP_VERSION_MINOR >= 1)
+    // NOTE: mpn_divexact_1() is available since GMP 6.1.0.
+    if (asize2 == 1) {
+        // Optimisation in case the dividend has only 1 limb.
+        // NOTE: overlapping arguments are fine here.
+        ::mpn_divexact_1(q.m_limbs.data(), op1.m_limbs.data(), static_cast<::mp_size_t>(asize1), op2.m_limbs[0]);
+        // Complete the quotient: compute size and sign.
+        q._mp_size = asize1 - asize2 + 1;
+        while (q._mp_size && !(q.m_limbs[static_cast<std::size_t>(q._mp_size - 1)] & GMP_NUMB_MASK)) {
+            --q._mp_size;
         }
-        // For the size compuation:
-        // - if sign1 == 0, size is zero,
-        // - if sign1 == +-1, then the size is either +-1 or +-2: asize is 2 if the result
-        //   has a nonzero 2nd limb, otherwise asize is 1.
-        rop._mp_size = sign1 * (static_cast<int>(hi2 != 0u) + 1);
-        rdata[0] = lo;
-        rdata[1] = hi2;
-    } else {
-        // When the signs differ, we need to implement addition as a subtraction.
-        // NOTE: this also includes the case in which only one of the operands is zero.
-        if (asize1 > asize2 || (asize1 == asize2 && integer_compare_limbs_2(data1, data2, asize1) >= 0)) {
-            // op1 is >= op2 in absolute value.
-            const auto lo = data1[0] - data2[0];
-            // If there's a borrow, then hi1 > hi2, otherwise we would have a negative result.
-            assert(data1[0] >= data2[0] || data1[1] > data2[1]);
-            // This can never wrap around, at most it goes to zero.
-            const auto hi = data1[1] - data2[1] - static_cast<::mp_limb_t>(data1[0] < data2[0]);
-            // asize can be 0, 1 or 2.
-            // NOTE: this contraption ensures the correct result. The possibilities for hi/lo
-            // nonzero are:
-            // hi | lo | asize
-            // ---------------
-            //  1 |  1 |     2
-            //  1 |  0 |     2
-            //  0 |  1 |     1
-            //  0 |  0 |     0
-            // The sign1 (which cannot be zero due to the branch we are in) takes care of the sign of the size.
-            // Use '|' instead of '||' as we don't need to short circuit on this.
-            rop._mp_size = sign1 * static_cast<int>((lo != 0u) | (hi != 0u)) * (static_cast<int>(hi != 0u) + 1);
-            rdata[0] = lo;
-            rdata[1] = hi;
-        } else {
-            // op2 is > op1 in absolute value.
-            const auto lo = data2[0] - data1[0];
-            assert(data2[0] >= data1[0] || data2[1] > data1[1]);
-            const auto hi = data2[1] - data1[1] - static_cast<::mp_limb_t>(data2[0] < data1[0]);
-            // asize can be 1 or 2, but not zero as we know abs(op1) != abs(op2). Same idea as above.
-            rop._mp_size = sign2 * (static_cast<int>(hi != 0u) + 1);
-            rdata[0] = lo;
-            rdata[1] = hi;
+        if (sign1 != sign2) {
+            q._mp_size = -q._mp_size;
         }
+        return;
+    }
+#else
+    // Avoid compiler warnings for unused parameters.
+    (void)sign1;
+    (void)sign2;
+    (void)asize2;
+#endif
+    // General implementation (via the mpz function).
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    const auto v1 = op1.get_mpz_view();
+    const auto v2 = op2.get_mpz_view();
+    ::mpz_divexact(&tmp.m_mpz, &v1, &v2);
+    // Copy over from the tmp struct into q.
+    q._mp_size = tmp.m_mpz._mp_size;
+    copy_limbs_no(tmp.m_mpz._mp_d, tmp.m_mpz._mp_d + (q._mp_size >= 0 ? q._mp_size : -q._mp_size), q.m_limbs.data());
+}
+
+// 1-limb optimisation.
+template <std::size_t SSize>
+inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                 mpz_size_t, mpz_size_t, int sign1, int sign2, const std::integral_constant<int, 1> &)
+{
+    const ::mp_limb_t q_ = (op1.m_limbs[0] & GMP_NUMB_MASK) / (op2.m_limbs[0] & GMP_NUMB_MASK);
+    // Write q.
+    q._mp_size = sign1 * sign2 * (q_ != 0u);
+    q.m_limbs[0] = q_;
+}
+
+// 2-limbs optimisation.
+template <std::size_t SSize>
+inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
+                                 mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
+                                 const std::integral_constant<int, 2> &)
+{
+    if (asize1 < 2 && asize2 < 2) {
+        // 1-limb optimisation.
+        const ::mp_limb_t q_ = op1.m_limbs[0] / op2.m_limbs[0];
+        q._mp_size = sign1 * sign2 * (q_ != 0u);
+        q.m_limbs[0] = q_;
+        q.m_limbs[1] = 0u;
+        return;
     }
-    return true;
+    // General case.
+    ::mp_limb_t q1, q2;
+    dlimb_div(op1.m_limbs[0], op1.m_limbs[1], op2.m_limbs[0], op2.m_limbs[1], &q1, &q2);
+    q._mp_size = sign1 * sign2 * (q2 ? 2 : (q1 ? 1 : 0));
+    q.m_limbs[0] = q1;
+    q.m_limbs[1] = q2;
 }
 
-template <bool AddOrSub, std::size_t SSize>
-inline bool static_addsub(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+template <std::size_t SSize>
+inline void static_divexact(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2)
 {
-    // NOTE: effectively negate op2 if we are subtracting.
-    mpz_size_t asize1 = op1._mp_size, asize2 = AddOrSub ? op2._mp_size : -op2._mp_size;
+    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
     int sign1 = asize1 != 0, sign2 = asize2 != 0;
     if (asize1 < 0) {
         asize1 = -asize1;
@@ -2623,2636 +5161,2609 @@ inline bool static_addsub(static_int<SSize> &rop, const static_int<SSize> &op1,
         asize2 = -asize2;
         sign2 = -1;
     }
-    const bool retval
-        = static_add_impl(rop, op1, op2, asize1, asize2, sign1, sign2, integer_static_add_algo<static_int<SSize>>{});
-    if (integer_static_add_algo<static_int<SSize>>::value == 0 && retval) {
-        // If we used the mpn functions and we actually wrote into rop, then
-        // make sure we zero out the unused limbs.
-        rop.zero_unused_limbs();
+    assert(asize1 == 0 || asize2 <= asize1);
+    // NOTE: use integer_static_div_algo for the algorithm selection.
+    static_divexact_impl(q, op1, op2, asize1, asize2, sign1, sign2, integer_static_div_algo<static_int<SSize>>{});
+    if (integer_static_div_algo<static_int<SSize>>::value == 0) {
+        q.zero_unused_limbs();
     }
-    return retval;
 }
 }
 
-/// Ternary addition.
+/// Ternary truncated division.
 /**
- * This function will set \p rop to <tt>op1 + op2</tt>.
+ * This function will set \p q to the truncated quotient <tt>n / d</tt> and \p r to
+ * <tt>n % d</tt>. The remainder \p r has the same sign as \p n. \p q and \p r must be two distinct objects.
  *
- * @param rop the return value.
- * @param op1 the first argument.
- * @param op2 the second argument.
+ * @param q the quotient.
+ * @param r the remainder.
+ * @param n the dividend.
+ * @param d the divisor.
  *
- * @return a reference to \p rop.
+ * @throws std::invalid_argument if \p q and \p r are the same object.
+ * @throws zero_division_error if \p d is zero.
  */
 template <std::size_t SSize>
-inline integer<SSize> &add(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
-{
-    const bool s1 = op1.is_static(), s2 = op2.is_static();
-    bool sr = rop.is_static();
-    if (mppp_likely(s1 && s2)) {
-        // If both op1 and op2 are static, we will try to do the statid add.
-        // We might need to downgrade rop to static.
-        if (!sr) {
-            // NOTE: here we are sure rop is distinct from op1/op2, as
-            // rop is dynamic and op1/op2 are both static.
-            rop.set_zero();
-            sr = true;
-        }
-        if (mppp_likely(
-                static_addsub<true>(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st()))) {
-            return rop;
-        }
-    }
-    if (sr) {
-        rop._get_union().promote(SSize + 1u);
-    }
-    ::mpz_add(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
-    return rop;
-}
-
-inline namespace detail
-{
-
-// Metaprogramming for selecting the algorithm for static add/sub with ui. The selection happens via
-// an std::integral_constant with 3 possible values:
-// - 0 (default case): use the GMP mpn functions,
-// - 1: selected when there are no nail bits and the static size is 1,
-// - 2: selected when there are no nail bits and the static size is 2.
-template <typename SInt>
-using integer_static_addsub_ui_algo = std::integral_constant<
-    int, (!GMP_NAIL_BITS && SInt::s_size == 1) ? 1 : ((!GMP_NAIL_BITS && SInt::s_size == 2) ? 2 : 0)>;
-
-// mpn implementation.
-template <bool AddOrSub, std::size_t SSize>
-inline bool static_addsub_ui_impl(static_int<SSize> &rop, const static_int<SSize> &op1, mpz_size_t asize1, int sign1,
-                                  unsigned long op2, const std::integral_constant<int, 0> &)
+inline void tdiv_qr(integer<SSize> &q, integer<SSize> &r, const integer<SSize> &n, const integer<SSize> &d)
 {
-    auto rdata = &rop.m_limbs[0];
-    auto data1 = &op1.m_limbs[0];
-    const auto size1 = op1._mp_size;
-    const auto l2 = static_cast<::mp_limb_t>(op2);
-    // mpn functions require nonzero arguments.
-    if (mppp_unlikely(!l2)) {
-        rop._mp_size = size1;
-        copy_limbs(data1, data1 + asize1, rdata);
-        return true;
-    }
-    // We now know l2 is not zero, so its "sign" must be either 1 or -1.
-    constexpr int sign2 = AddOrSub ? 1 : -1;
-    if (mppp_unlikely(!sign1)) {
-        // NOTE: this has to be +-1 because l2 == 0 is handled above.
-        rop._mp_size = sign2;
-        rdata[0] = l2;
-        return true;
-    }
-    // This is the same overflow check as in static_addsub(). As in static_addsub(), this is not as tight/precise
-    // as it could be.
-    const bool c1 = std::size_t(asize1) == SSize && ((data1[asize1 - 1] & GMP_NUMB_MASK) >> (GMP_NUMB_BITS - 1));
-    const bool c2 = SSize == 1u && (l2 >> (GMP_NUMB_BITS - 1));
-    if (mppp_unlikely(c1 || c2)) {
-        return false;
-    }
-    if (sign1 == sign2) {
-        // op1 and op2 have the same sign. Implement as a true addition.
-        if (::mpn_add_1(rdata, data1, static_cast<::mp_size_t>(asize1), l2)) {
-            assert(asize1 < static_int<SSize>::s_size);
-            // New size is old size + 1 if old size was positive, old size - 1 otherwise.
-            rop._mp_size = size1 + sign2;
-            // NOTE: there should be no need to use GMP_NUMB_MASK here.
-            rdata[asize1] = 1u;
-        } else {
-            // Without carry, the size is unchanged.
-            rop._mp_size = size1;
-        }
-    } else {
-        // op1 and op2 have different signs. Implement as a subtraction.
-        if (asize1 > 1 || (asize1 == 1 && (data1[0] & GMP_NUMB_MASK) >= l2)) {
-            // abs(op1) >= abs(op2).
-            const auto br = ::mpn_sub_1(rdata, data1, static_cast<::mp_size_t>(asize1), l2);
-            (void)br;
-            assert(!br);
-            // The asize can be the original one or original - 1 (we subtracted a limb). If size1 was positive,
-            // sign2 has to be negative and we potentially subtract 1, if size1 was negative then sign2 has to be
-            // positive and we potentially add 1.
-            rop._mp_size = size1 + sign2 * !(rdata[asize1 - 1] & GMP_NUMB_MASK);
-        } else {
-            // abs(op2) > abs(op1).
-            const auto br = ::mpn_sub_1(rdata, &l2, 1, data1[0]);
-            (void)br;
-            assert(!br);
-            // The size must be +-1, as abs(op2) == abs(op1) is handled above.
-            assert((rdata[0] & GMP_NUMB_MASK));
-            rop._mp_size = sign2;
-        }
+    if (mppp_unlikely(&q == &r)) {
+        throw std::invalid_argument("When performing a division with remainder, the quotient 'q' and the "
+                                    "remainder 'r' must be distinct objects");
     }
-    return true;
-}
-
-// 1-limb optimisation (no nails).
-template <bool AddOrSub, std::size_t SSize>
-inline bool static_addsub_ui_impl(static_int<SSize> &rop, const static_int<SSize> &op1, mpz_size_t, int sign1,
-                                  unsigned long op2, const std::integral_constant<int, 1> &)
-{
-    const auto l1 = op1.m_limbs[0];
-    const auto l2 = static_cast<::mp_limb_t>(op2);
-    ::mp_limb_t tmp;
-    if ((sign1 >= 0 && AddOrSub) || (sign1 <= 0 && !AddOrSub)) {
-        // op1 non-negative and addition, or op1 non-positive and subtraction. Implement
-        // as a true addition.
-        if (mppp_unlikely(limb_add_overflow(l1, l2, &tmp))) {
-            return false;
-        }
-        // The size is 1 for addition, -1 for subtraction, unless
-        // the result is zero.
-        rop._mp_size = (AddOrSub ? 1 : -1) * (tmp != 0u);
-        rop.m_limbs[0] = tmp;
-    } else {
-        // op1 negative and addition, or op1 positive and subtraction. Implement
-        // as a subtraction.
-        if (l1 >= l2) {
-            // op1 has larger or equal abs.
-            tmp = l1 - l2;
-            // asize is 1 or 0, 0 iff l1 == l2. Sign is negative for add, positive for sub.
-            rop._mp_size = (AddOrSub ? -1 : 1) * (tmp != 0u);
-            rop.m_limbs[0] = tmp;
-        } else {
-            // op1 has smaller abs. The result will be positive for add, negative
-            // for sub (cannot be zero as it is handled above).
-            rop._mp_size = AddOrSub ? 1 : -1;
-            rop.m_limbs[0] = l2 - l1;
-        }
+    if (mppp_unlikely(d.sgn() == 0)) {
+        throw zero_division_error("Integer division by zero");
     }
-    return true;
-}
-
-// 2-limb optimisation (no nails).
-template <bool AddOrSub, std::size_t SSize>
-inline bool static_addsub_ui_impl(static_int<SSize> &rop, const static_int<SSize> &op1, mpz_size_t asize1, int sign1,
-                                  unsigned long op2, const std::integral_constant<int, 2> &)
-{
-    auto rdata = &rop.m_limbs[0];
-    auto data1 = &op1.m_limbs[0];
-    const auto l2 = static_cast<::mp_limb_t>(op2);
-    if ((sign1 >= 0 && AddOrSub) || (sign1 <= 0 && !AddOrSub)) {
-        // op1 non-negative and addition, or op1 non-positive and subtraction. Implement
-        // as a true addition.
-        // These two limbs will contain the result.
-        ::mp_limb_t lo, hi;
-        // Add l2 to the low limb, placing the result in lo.
-        const ::mp_limb_t cy_lo = limb_add_overflow(data1[0], l2, &lo);
-        // Add the carry from the low addition to the high limb, placing the result in hi.
-        const ::mp_limb_t cy_hi = limb_add_overflow(data1[1], cy_lo, &hi);
-        if (mppp_unlikely(cy_hi)) {
-            return false;
+    const bool sq = q.is_static(), sr = r.is_static(), s1 = n.is_static(), s2 = d.is_static();
+    if (mppp_likely(s1 && s2)) {
+        if (!sq) {
+            q.set_zero();
         }
-        // Compute the new asize. It can be 0, 1 or 2.
-        // NOTE: see the comments in the 2-limb specialisation for addition.
-        rop._mp_size
-            = (AddOrSub ? 1 : -1) * static_cast<int>((lo != 0u) | (hi != 0u)) * (static_cast<int>(hi != 0u) + 1);
-        // Write out.
-        rdata[0] = lo;
-        rdata[1] = hi;
-    } else {
-        // op1 negative and addition, or op1 positive and subtraction. Implement
-        // as a subtraction.
-        // Compare their absolute values.
-        if (asize1 == 2 || data1[0] >= l2) {
-            // op1 is >= op2 in absolute value.
-            const auto lo = data1[0] - l2;
-            // Sub from hi the borrow.
-            const auto hi = data1[1] - static_cast<::mp_limb_t>(data1[0] < l2);
-            // The final asize can be 2, 1 or 0. Sign is negative for add, positive for sub.
-            rop._mp_size
-                = (AddOrSub ? -1 : 1) * (static_cast<int>((lo != 0u) | (hi != 0u)) * (static_cast<int>(hi != 0u) + 1));
-            rdata[0] = lo;
-            rdata[1] = hi;
-        } else {
-            // op2 > op1 in absolute value.
-            // Size has to be +-1.
-            rop._mp_size = AddOrSub ? 1 : -1;
-            rdata[0] = l2 - data1[0];
-            rdata[1] = 0u;
+        if (!sr) {
+            r.set_zero();
         }
+        static_div(q._get_union().g_st(), r._get_union().g_st(), n._get_union().g_st(), d._get_union().g_st());
+        // Division can never fail.
+        return;
     }
-    return true;
-}
-
-template <bool AddOrSub, std::size_t SSize>
-inline bool static_addsub_ui(static_int<SSize> &rop, const static_int<SSize> &op1, unsigned long op2)
-{
-    mpz_size_t asize1 = op1._mp_size;
-    int sign1 = asize1 != 0;
-    if (asize1 < 0) {
-        asize1 = -asize1;
-        sign1 = -1;
+    if (sq) {
+        q._get_union().promote();
     }
-    const bool retval = static_addsub_ui_impl<AddOrSub>(rop, op1, asize1, sign1, op2,
-                                                        integer_static_addsub_ui_algo<static_int<SSize>>{});
-    if (integer_static_addsub_ui_algo<static_int<SSize>>::value == 0 && retval) {
-        // If we used the mpn functions and we actually wrote into rop, then
-        // make sure we zero out the unused limbs.
-        rop.zero_unused_limbs();
+    if (sr) {
+        r._get_union().promote();
     }
-    return retval;
-}
+    ::mpz_tdiv_qr(&q._get_union().g_dy(), &r._get_union().g_dy(), n.get_mpz_view(), d.get_mpz_view());
 }
 
-/// Ternary addition with <tt>unsigned long</tt>.
+/// Exact division (ternary version).
 /**
- * This function will set \p rop to <tt>op1 + op2</tt>.
+ * This function will set \p rop to the quotient of \p n and \p d.
+ *
+ * \rststar
+ * .. warning::
+ *
+ *    If ``d`` does not divide ``n`` exactly, the behaviour will be undefined.
+ * \endrststar
  *
  * @param rop the return value.
- * @param op1 the first argument.
- * @param op2 the second argument.
+ * @param n the dividend.
+ * @param d the divisor.
  *
  * @return a reference to \p rop.
  */
 template <std::size_t SSize>
-inline integer<SSize> &add_ui(integer<SSize> &rop, const integer<SSize> &op1, unsigned long op2)
+inline integer<SSize> &divexact(integer<SSize> &rop, const integer<SSize> &n, const integer<SSize> &d)
 {
-    // LCOV_EXCL_START
-    if (std::numeric_limits<unsigned long>::max() > GMP_NUMB_MASK) {
-        // For the optimised version below to kick in we need to be sure we can safely convert
-        // unsigned long to an ::mp_limb_t, modulo nail bits. This because in the optimised version
-        // we cast forcibly op2 to ::mp_limb_t. Otherwise, we just call add() after converting op2 to an
-        // integer.
-        // NOTE: it does not look like this can be hit on any modern setup.
-        add(rop, op1, integer<SSize>{op2});
-        return rop;
-    }
-    // LCOV_EXCL_STOP
-    const bool s1 = op1.is_static();
-    bool sr = rop.is_static();
-    if (mppp_likely(s1)) {
+    const bool sr = rop.is_static(), s1 = n.is_static(), s2 = d.is_static();
+    if (mppp_likely(s1 && s2)) {
         if (!sr) {
             rop.set_zero();
-            sr = true;
-        }
-        if (mppp_likely(static_addsub_ui<true>(rop._get_union().g_st(), op1._get_union().g_st(), op2))) {
-            return rop;
         }
+        static_divexact(rop._get_union().g_st(), n._get_union().g_st(), d._get_union().g_st());
+        // Division can never fail.
+        return rop;
     }
     if (sr) {
-        rop._get_union().promote(SSize + 1u);
+        rop._get_union().promote();
     }
-    ::mpz_add_ui(&rop._get_union().g_dy(), op1.get_mpz_view(), op2);
+    ::mpz_divexact(&rop._get_union().g_dy(), n.get_mpz_view(), d.get_mpz_view());
     return rop;
 }
 
-/// Ternary subtraction with <tt>unsigned long</tt>.
+/// Exact division (binary version).
 /**
- * This function will set \p rop to <tt>op1 - op2</tt>.
+ * \rststar
+ * .. warning::
  *
- * @param rop the return value.
- * @param op1 the first argument.
- * @param op2 the second argument.
+ *    If ``d`` does not divide ``n`` exactly, the behaviour will be undefined.
+ * \endrststar
  *
- * @return a reference to \p rop.
+ * @param n the dividend.
+ * @param d the divisor.
+ *
+ * @return the quotient of \p n and \p d.
  */
 template <std::size_t SSize>
-inline integer<SSize> &sub_ui(integer<SSize> &rop, const integer<SSize> &op1, unsigned long op2)
+inline integer<SSize> divexact(const integer<SSize> &n, const integer<SSize> &d)
 {
-    // LCOV_EXCL_START
-    if (std::numeric_limits<unsigned long>::max() > GMP_NUMB_MASK) {
-        sub(rop, op1, integer<SSize>{op2});
-        return rop;
+    integer<SSize> retval;
+    divexact(retval, n, d);
+    return retval;
+}
+
+inline namespace detail
+{
+
+// Selection of the algorithm for static tdiv_q_2exp.
+template <typename SInt>
+using integer_static_tdiv_q_2exp_algo = std::integral_constant<int, (SInt::s_size > 2) ? 0 : SInt::s_size>;
+
+// mpn implementation.
+template <std::size_t SSize>
+inline void static_tdiv_q_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s,
+                                    const std::integral_constant<int, 0> &)
+{
+    mpz_size_t asize = n._mp_size;
+    if (s == 0u || asize == 0) {
+        // If shift is zero, or the operand is zero, write n into rop and return.
+        rop = n;
+        return;
     }
-    // LCOV_EXCL_STOP
-    const bool s1 = op1.is_static();
-    bool sr = rop.is_static();
-    if (mppp_likely(s1)) {
-        if (!sr) {
-            rop.set_zero();
-            sr = true;
-        }
-        if (mppp_likely(static_addsub_ui<false>(rop._get_union().g_st(), op1._get_union().g_st(), op2))) {
-            return rop;
-        }
+    // Finish setting up asize and sign.
+    int sign = 1;
+    if (asize < 0) {
+        asize = -asize;
+        sign = -1;
     }
-    if (sr) {
-        rop._get_union().promote(SSize + 1u);
+    // ls: number of entire limbs shifted.
+    // rs: effective shift that will be passed to the mpn function.
+    const auto ls = s / unsigned(GMP_NUMB_BITS), rs = s % unsigned(GMP_NUMB_BITS);
+    if (ls >= static_cast<std::size_t>(asize)) {
+        // If we shift by a number of entire limbs equal to or larger than the asize,
+        // the result will be zero.
+        rop._mp_size = 0;
+        return;
     }
-    ::mpz_sub_ui(&rop._get_union().g_dy(), op1.get_mpz_view(), op2);
-    return rop;
+    // The maximum new asize will be the old asize minus ls.
+    const mpz_size_t new_asize = asize - static_cast<mpz_size_t>(ls);
+    if (rs) {
+        // Perform the shift via the mpn function, if we are effectively shifting at least 1 bit.
+        // Overlapping is fine, as it is guaranteed that rop.m_limbs.data() <= n.m_limbs.data() + ls.
+        ::mpn_rshift(rop.m_limbs.data(), n.m_limbs.data() + ls, static_cast<::mp_size_t>(new_asize), unsigned(rs));
+    } else {
+        // Otherwise, just copy over (the mpn function requires the shift to be at least 1).
+        // NOTE: std::move requires that the destination iterator is not within the input range.
+        // Here we are sure that ls > 0 because we don't have a remainder, and the zero shift case
+        // was already handled above.
+        assert(ls);
+        std::move(n.m_limbs.begin() + ls, n.m_limbs.begin() + asize, rop.m_limbs.begin());
+    }
+    // Set the size. We need to check if the top limb is zero.
+    rop._mp_size = sign * (new_asize - ((rop.m_limbs[static_cast<std::size_t>(new_asize - 1)] & GMP_NUMB_MASK) == 0u));
 }
 
-/// Ternary subtraction.
+// 1-limb optimisation.
+template <std::size_t SSize>
+inline void static_tdiv_q_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s,
+                                    const std::integral_constant<int, 1> &)
+{
+    const ::mp_limb_t l = n.m_limbs[0] & GMP_NUMB_MASK;
+    if (s == 0u || l == 0u) {
+        rop = n;
+        return;
+    }
+    if (s >= unsigned(GMP_NUMB_BITS)) {
+        // We are shifting by the limb's bit size or greater, the result will be zero.
+        rop._mp_size = 0;
+        rop.m_limbs[0] = 0u;
+        return;
+    }
+    // Compute the result.
+    const auto res = l >> s;
+    // Size is the original one or zero.
+    rop._mp_size = static_cast<int>(res != 0u) * n._mp_size;
+    rop.m_limbs[0] = res;
+}
+
+// 2-limb optimisation.
+template <std::size_t SSize>
+inline void static_tdiv_q_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s,
+                                    const std::integral_constant<int, 2> &)
+{
+    mpz_size_t asize = n._mp_size;
+    if (s == 0u || asize == 0) {
+        rop = n;
+        return;
+    }
+    int sign = 1;
+    if (asize < 0) {
+        asize = -asize;
+        sign = -1;
+    }
+    // If shift is too large, zero the result and return.
+    static_assert(unsigned(GMP_NUMB_BITS) <= std::numeric_limits<unsigned>::max() / 2u, "Overflow error.");
+    if (s >= 2u * unsigned(GMP_NUMB_BITS)) {
+        rop._mp_size = 0;
+        rop.m_limbs[0u] = 0u;
+        rop.m_limbs[1u] = 0u;
+        return;
+    }
+    if (s >= unsigned(GMP_NUMB_BITS)) {
+        // NOTE: here the effective shift < GMP_NUMB_BITS, otherwise it would have been caught
+        // in the check above.
+        const auto lo = (n.m_limbs[1u] & GMP_NUMB_MASK) >> (s - unsigned(GMP_NUMB_BITS));
+        // The size could be zero or +-1, depending
+        // on the new content of m_limbs[0] and the previous
+        // sign of _mp_size.
+        rop._mp_size = static_cast<int>(lo != 0u) * sign;
+        rop.m_limbs[0u] = lo;
+        rop.m_limbs[1u] = 0u;
+        return;
+    }
+    assert(s > 0u && s < unsigned(GMP_NUMB_BITS));
+    // This represents the bits in hi that will be shifted down into lo.
+    // We move them up so we can add tmp to the new lo to account for them.
+    // NOTE: mask the final result to avoid spillover into potential nail bits.
+    const auto tmp = ((n.m_limbs[1u] & GMP_NUMB_MASK) << (unsigned(GMP_NUMB_BITS) - s)) & GMP_NUMB_MASK;
+    rop.m_limbs[0u] = ((n.m_limbs[0u] & GMP_NUMB_MASK) >> s) + tmp;
+    rop.m_limbs[1u] = (n.m_limbs[1u] & GMP_NUMB_MASK) >> s;
+    // The effective shift was less than 1 entire limb. The new asize must be the old one,
+    // or one less than that.
+    rop._mp_size = sign * (asize - ((rop.m_limbs[std::size_t(asize - 1)] & GMP_NUMB_MASK) == 0u));
+}
+
+template <std::size_t SSize>
+inline void static_tdiv_q_2exp(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s)
+{
+    static_tdiv_q_2exp_impl(rop, n, s, integer_static_tdiv_q_2exp_algo<static_int<SSize>>{});
+    if (integer_static_tdiv_q_2exp_algo<static_int<SSize>>::value == 0) {
+        rop.zero_unused_limbs();
+    }
+}
+}
+
+/// Ternary right shift.
 /**
- * This function will set \p rop to <tt>op1 - op2</tt>.
+ * This function will set \p rop to \p n divided by <tt>2**s</tt>. \p rop will be the truncated result of the
+ * division.
  *
  * @param rop the return value.
- * @param op1 the first argument.
- * @param op2 the second argument.
+ * @param n the dividend.
+ * @param s the bit shift value.
  *
  * @return a reference to \p rop.
  */
 template <std::size_t SSize>
-inline integer<SSize> &sub(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> &tdiv_q_2exp(integer<SSize> &rop, const integer<SSize> &n, ::mp_bitcnt_t s)
 {
-    const bool s1 = op1.is_static(), s2 = op2.is_static();
+    const bool sn = n.is_static();
     bool sr = rop.is_static();
-    if (mppp_likely(s1 && s2)) {
+    if (mppp_likely(sn)) {
         if (!sr) {
             rop.set_zero();
             sr = true;
         }
-        if (mppp_likely(
-                static_addsub<false>(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st()))) {
-            return rop;
-        }
+        static_tdiv_q_2exp(rop._get_union().g_st(), n._get_union().g_st(), s);
+        return rop;
     }
     if (sr) {
-        rop._get_union().promote(SSize + 1u);
+        rop._get_union().promote();
     }
-    ::mpz_sub(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    ::mpz_tdiv_q_2exp(&rop._get_union().g_dy(), n.get_mpz_view(), s);
     return rop;
 }
 
+/** @} */
+
+/** @defgroup integer_comparison integer_comparison
+ *  @{
+ */
+
 inline namespace detail
 {
 
-// The double limb multiplication optimization is available in the following cases:
-// - no nails, we are on a 64bit MSVC build, the limb type has exactly 64 bits and GMP_NUMB_BITS is 64,
-// - no nails, we have a 128bit unsigned available, the limb type has exactly 64 bits and GMP_NUMB_BITS is 64,
-// - no nails, the smallest 64 bit unsigned type has exactly 64 bits, the limb type has exactly 32 bits and
-//   GMP_NUMB_BITS is 32.
-// NOTE: here we are checking that GMP_NUMB_BITS is the same as the limits ::digits property, which is probably
-// rather redundant on any conceivable architecture.
-using integer_have_dlimb_mul = std::integral_constant<bool,
-#if (defined(_MSC_VER) && defined(_WIN64) && (GMP_NUMB_BITS == 64)) || (defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64))
-                                                      !GMP_NAIL_BITS && std::numeric_limits<::mp_limb_t>::digits == 64
-#elif GMP_NUMB_BITS == 32
-                                                      !GMP_NAIL_BITS
-                                                          && std::numeric_limits<std::uint_least64_t>::digits == 64
-                                                          && std::numeric_limits<::mp_limb_t>::digits == 32
-#else
-                                                      false
-#endif
-                                                      >;
-
+// Selection of the algorithm for static cmp.
 template <typename SInt>
-using integer_static_mul_algo
-    = std::integral_constant<int, (SInt::s_size == 1 && integer_have_dlimb_mul::value)
-                                      ? 1
-                                      : ((SInt::s_size == 2 && integer_have_dlimb_mul::value) ? 2 : 0)>;
+using integer_static_cmp_algo = std::integral_constant<int, SInt::s_size == 1 ? 1 : (SInt::s_size == 2 ? 2 : 0)>;
 
 // mpn implementation.
-// NOTE: this function (and the other overloads) returns 0 in case of success, otherwise it returns a hint
-// about the size in limbs of the result.
 template <std::size_t SSize>
-inline std::size_t static_mul_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                                   mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                                   const std::integral_constant<int, 0> &)
+inline int static_cmp(const static_int<SSize> &n1, const static_int<SSize> &n2, const std::integral_constant<int, 0> &)
 {
-    // Handle zeroes.
-    if (mppp_unlikely(!sign1 || !sign2)) {
-        rop._mp_size = 0;
-        return 0u;
+    if (n1._mp_size < n2._mp_size) {
+        return -1;
     }
-    auto rdata = &rop.m_limbs[0];
-    auto data1 = &op1.m_limbs[0], data2 = &op2.m_limbs[0];
-    const auto max_asize = std::size_t(asize1 + asize2);
-    // Temporary storage, to be used if we cannot write into rop.
-    std::array<::mp_limb_t, SSize * 2u> res;
-    // We can write directly into rop if these conditions hold:
-    // - rop does not overlap with op1 and op2,
-    // - SSize is large enough to hold the max size of the result.
-    ::mp_limb_t *MPPP_RESTRICT res_data = (rdata != data1 && rdata != data2 && max_asize <= SSize) ? rdata : res.data();
-    // Proceed to the multiplication.
-    ::mp_limb_t hi;
-    if (asize2 == 1) {
-        // NOTE: the 1-limb versions do not write the hi limb, we have to write it ourselves.
-        hi = ::mpn_mul_1(res_data, data1, static_cast<::mp_size_t>(asize1), data2[0]);
-        res_data[asize1] = hi;
-    } else if (asize1 == 1) {
-        hi = ::mpn_mul_1(res_data, data2, static_cast<::mp_size_t>(asize2), data1[0]);
-        res_data[asize2] = hi;
-    } else if (asize1 == asize2) {
-        ::mpn_mul_n(res_data, data1, data2, static_cast<::mp_size_t>(asize1));
-        hi = res_data[2 * asize1 - 1];
-    } else if (asize1 >= asize2) {
-        hi = ::mpn_mul(res_data, data1, static_cast<::mp_size_t>(asize1), data2, static_cast<::mp_size_t>(asize2));
-    } else {
-        hi = ::mpn_mul(res_data, data2, static_cast<::mp_size_t>(asize2), data1, static_cast<::mp_size_t>(asize1));
+    if (n2._mp_size < n1._mp_size) {
+        return 1;
     }
-    // The actual size.
-    const std::size_t asize = max_asize - unsigned(hi == 0u);
-    if (res_data == rdata) {
-        // If we wrote directly into rop, it means that we had enough storage in it to begin with.
-        rop._mp_size = mpz_size_t(asize);
-        if (sign1 != sign2) {
-            rop._mp_size = -rop._mp_size;
-        }
-        return 0u;
+    // The two sizes are equal, compare the absolute values.
+    const auto asize = n1._mp_size >= 0 ? n1._mp_size : -n1._mp_size;
+    if (asize == 0) {
+        // Both operands are zero.
+        // NOTE: we do this special casing in order to avoid calling mpn_cmp() on zero operands. It seems to
+        // work, but the official GMP docs say one is not supposed to call mpn functions on zero operands.
+        return 0;
     }
-    // If we used the temporary storage, we need to check if we can write into rop.
-    if (asize > SSize) {
-        // Not enough space, return the size.
-        return asize;
+    const int cmp_abs = ::mpn_cmp(n1.m_limbs.data(), n2.m_limbs.data(), static_cast<::mp_size_t>(asize));
+    // If the values are non-negative, return the comparison of the absolute values, otherwise invert it.
+    return (n1._mp_size >= 0) ? cmp_abs : -cmp_abs;
+}
+
+// 1-limb optimisation.
+template <std::size_t SSize>
+inline int static_cmp(const static_int<SSize> &n1, const static_int<SSize> &n2, const std::integral_constant<int, 1> &)
+{
+    if (n1._mp_size < n2._mp_size) {
+        return -1;
     }
-    // Enough space, set size and copy limbs.
-    rop._mp_size = mpz_size_t(asize);
-    if (sign1 != sign2) {
-        rop._mp_size = -rop._mp_size;
+    if (n2._mp_size < n1._mp_size) {
+        return 1;
     }
-    // NOTE: here we are sure that res_data != rdata, as we checked it earlier.
-    copy_limbs_no(res_data, res_data + asize, rdata);
-    return 0u;
+    int cmp_abs = (n1.m_limbs[0u] & GMP_NUMB_MASK) > (n2.m_limbs[0u] & GMP_NUMB_MASK);
+    if (!cmp_abs) {
+        cmp_abs = -static_cast<int>((n1.m_limbs[0u] & GMP_NUMB_MASK) < (n2.m_limbs[0u] & GMP_NUMB_MASK));
+    }
+    return (n1._mp_size >= 0) ? cmp_abs : -cmp_abs;
 }
 
-#if defined(_MSC_VER) && defined(_WIN64) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
-inline ::mp_limb_t dlimb_mul(::mp_limb_t op1, ::mp_limb_t op2, ::mp_limb_t *hi)
+// 2-limb optimisation.
+template <std::size_t SSize>
+inline int static_cmp(const static_int<SSize> &n1, const static_int<SSize> &n2, const std::integral_constant<int, 2> &)
 {
-    return ::UnsignedMultiply128(op1, op2, hi);
+    if (n1._mp_size < n2._mp_size) {
+        return -1;
+    }
+    if (n2._mp_size < n1._mp_size) {
+        return 1;
+    }
+    auto asize = n1._mp_size >= 0 ? n1._mp_size : -n1._mp_size;
+    while (asize != 0) {
+        --asize;
+        if ((n1.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK) > (n2.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK)) {
+            return (n1._mp_size >= 0) ? 1 : -1;
+        }
+        if ((n1.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK) < (n2.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK)) {
+            return (n1._mp_size >= 0) ? -1 : 1;
+        }
+    }
+    return 0;
 }
-#elif defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
-inline ::mp_limb_t dlimb_mul(::mp_limb_t op1, ::mp_limb_t op2, ::mp_limb_t *hi)
+}
+
+/// Comparison function for integer.
+/**
+ * @param op1 first argument.
+ * @param op2 second argument.
+ *
+ * @return \p 0 if <tt>op1 == op2</tt>, a negative value if <tt>op1 < op2</tt>, a positive value if
+ * <tt>op1 > op2</tt>.
+ */
+template <std::size_t SSize>
+inline int cmp(const integer<SSize> &op1, const integer<SSize> &op2)
 {
-    using dlimb_t = MPPP_UINT128;
-    const dlimb_t res = dlimb_t(op1) * op2;
-    *hi = static_cast<::mp_limb_t>(res >> 64);
-    return static_cast<::mp_limb_t>(res);
+    const bool s1 = op1.is_static(), s2 = op2.is_static();
+    if (mppp_likely(s1 && s2)) {
+        return static_cmp(op1._get_union().g_st(), op2._get_union().g_st(),
+                          integer_static_cmp_algo<static_int<SSize>>{});
+    }
+    return ::mpz_cmp(op1.get_mpz_view(), op2.get_mpz_view());
 }
-#elif GMP_NUMB_BITS == 32 && !GMP_NAIL_BITS
-inline ::mp_limb_t dlimb_mul(::mp_limb_t op1, ::mp_limb_t op2, ::mp_limb_t *hi)
+
+/// Sign function.
+/**
+ * @param n the integer whose sign will be computed.
+ *
+ * @return 0 if \p n is zero, 1 if \p n is positive, -1 if \p n is negative.
+ */
+template <std::size_t SSize>
+inline int sgn(const integer<SSize> &n)
 {
-    using dlimb_t = std::uint_least64_t;
-    const dlimb_t res = dlimb_t(op1) * op2;
-    *hi = static_cast<::mp_limb_t>(res >> 32);
-    return static_cast<::mp_limb_t>(res);
+    return n.sgn();
 }
-#endif
 
-// 1-limb optimization via dlimb.
+/// Test if integer is odd.
+/**
+ * @param n the argument.
+ *
+ * @return \p true if \p n is odd, \p false otherwise.
+ */
 template <std::size_t SSize>
-inline std::size_t static_mul_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                                   mpz_size_t, mpz_size_t, int, int, const std::integral_constant<int, 1> &)
+inline bool odd_p(const integer<SSize> &n)
 {
-    ::mp_limb_t hi;
-    const ::mp_limb_t lo = dlimb_mul(op1.m_limbs[0], op2.m_limbs[0], &hi);
-    if (mppp_unlikely(hi)) {
-        return 2u;
-    }
-    // The size will be zero if at least one operand is zero, otherwise +-1
-    // depending on the signs of the operands.
-    rop._mp_size = op1._mp_size * op2._mp_size;
-    rop.m_limbs[0] = lo;
-    return 0u;
+    return n.odd_p();
 }
 
-// 2-limb optimization via dlimb.
+/// Test if integer is even.
+/**
+ * @param n the argument.
+ *
+ * @return \p true if \p n is even, \p false otherwise.
+ */
 template <std::size_t SSize>
-inline std::size_t static_mul_impl(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                                   mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                                   const std::integral_constant<int, 2> &)
+inline bool even_p(const integer<SSize> &n)
 {
-    if (asize1 <= 1 && asize2 <= 1) {
-        // NOTE: this handles zeroes as well: we know that the limbs are all zeroes in such
-        // a case (as we always guarantee unused limbs are zeroed), and the sign1 * sign2 multiplication takes care of
-        // the size.
-        rop.m_limbs[0] = dlimb_mul(op1.m_limbs[0], op2.m_limbs[0], &rop.m_limbs[1]);
-        rop._mp_size = sign1 * sign2 * static_cast<mpz_size_t>(2 - (rop.m_limbs[1] == 0u));
-        return 0u;
-    }
-    if (asize1 != asize2) {
-        // The only possibility of success is 2limbs x 1limb.
-        //
-        //             b      a X
-        //                    c
-        // --------------------
-        // tmp[2] tmp[1] tmp[0]
-        //
-        ::mp_limb_t a = op1.m_limbs[0], b = op1.m_limbs[1], c = op2.m_limbs[0];
-        if (asize1 < asize2) {
-            // Switch them around if needed.
-            a = op2.m_limbs[0], b = op2.m_limbs[1], c = op1.m_limbs[0];
-        }
-        ::mp_limb_t ca_lo, ca_hi, cb_lo, cb_hi, tmp0, tmp1, tmp2;
-        ca_lo = dlimb_mul(c, a, &ca_hi);
-        cb_lo = dlimb_mul(c, b, &cb_hi);
-        tmp0 = ca_lo;
-        const auto cy = limb_add_overflow(cb_lo, ca_hi, &tmp1);
-        tmp2 = cb_hi + cy;
-        // Now determine the size. asize must be at least 2.
-        const mpz_size_t asize = 2 + mpz_size_t(tmp2 != 0u);
-        if (asize == 2) {
-            // Size is good, write out the result.
-            rop._mp_size = sign1 * sign2 * asize;
-            rop.m_limbs[0] = tmp0;
-            rop.m_limbs[1] = tmp1;
-            return 0u;
-        }
-    }
-    // Return 4 as a size hint. Real size could be 3, but GMP will require 4 limbs
-    // of storage to perform the operation anyway.
-    return 4u;
+    return n.even_p();
+}
+
+/// Test if an integer is zero.
+/**
+ * @param n the integer to be tested.
+ *
+ * @return \p true if \p n is zero, \p false otherwise.
+ */
+template <std::size_t SSize>
+inline bool is_zero(const integer<SSize> &n)
+{
+    return n.is_zero();
 }
 
+/// Test if an integer is equal to one.
+/**
+ * @param n the integer to be tested.
+ *
+ * @return \p true if \p n is equal to 1, \p false otherwise.
+ */
 template <std::size_t SSize>
-inline std::size_t static_mul(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+inline bool is_one(const integer<SSize> &n)
+{
+    return n.is_one();
+}
+
+/// Test if an integer is equal to minus one.
+/**
+ * @param n the integer to be tested.
+ *
+ * @return \p true if \p n is equal to -1, \p false otherwise.
+ */
+template <std::size_t SSize>
+inline bool is_negative_one(const integer<SSize> &n)
+{
+    return n.is_negative_one();
+}
+
+/** @} */
+
+/** @defgroup integer_ntheory integer_ntheory
+ *  @{
+ */
+
+inline namespace detail
+{
+
+template <std::size_t SSize>
+inline void static_gcd(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
 {
-    // Cache a few quantities, detect signs.
     mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
-    int sign1 = asize1 != 0, sign2 = asize2 != 0;
     if (asize1 < 0) {
         asize1 = -asize1;
-        sign1 = -1;
     }
     if (asize2 < 0) {
         asize2 = -asize2;
-        sign2 = -1;
     }
-    const std::size_t retval
-        = static_mul_impl(rop, op1, op2, asize1, asize2, sign1, sign2, integer_static_mul_algo<static_int<SSize>>{});
-    if (integer_static_mul_algo<static_int<SSize>>::value == 0 && retval == 0u) {
-        rop.zero_unused_limbs();
+    // Handle zeroes.
+    if (!asize1) {
+        rop._mp_size = asize2;
+        rop.m_limbs = op2.m_limbs;
+        return;
     }
-    return retval;
+    if (!asize2) {
+        rop._mp_size = asize1;
+        rop.m_limbs = op1.m_limbs;
+        return;
+    }
+    // Special casing if an operand has asize 1.
+    if (asize1 == 1) {
+        rop._mp_size = 1;
+        rop.m_limbs[0] = ::mpn_gcd_1(op2.m_limbs.data(), static_cast<::mp_size_t>(asize2), op1.m_limbs[0]);
+        return;
+    }
+    if (asize2 == 1) {
+        rop._mp_size = 1;
+        rop.m_limbs[0] = ::mpn_gcd_1(op1.m_limbs.data(), static_cast<::mp_size_t>(asize1), op2.m_limbs[0]);
+        return;
+    }
+    // General case, via mpz.
+    // NOTE: there is an mpn_gcd() function, but it seems difficult to use. Apparently, and contrary to
+    // what stated in the latest documentation, the mpn function requires odd operands and bit size
+    // (not only limb size!) of the second operand not greater than the first. See for instance the old
+    // documentation:
+    // ftp://ftp.gnu.org/old-gnu/Manuals/gmp-3.1.1/html_chapter/gmp_9.html
+    // Indeed, compiling GMP in debug mode and then trying to use the mpn function without respecting the above
+    // results in assertion failures. For now let's keep it like this, the small operand cases are handled above
+    // (partially) via mpn_gcd_1(), and in the future we can also think about binary GCD for 1/2 limbs optimisation.
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    const auto v1 = op1.get_mpz_view();
+    const auto v2 = op2.get_mpz_view();
+    ::mpz_gcd(&tmp.m_mpz, &v1, &v2);
+    // Copy over.
+    rop._mp_size = tmp.m_mpz._mp_size;
+    assert(rop._mp_size > 0);
+    copy_limbs_no(tmp.m_mpz._mp_d, tmp.m_mpz._mp_d + rop._mp_size, rop.m_limbs.data());
 }
 }
 
-/// Ternary multiplication.
+/// GCD (ternary version).
 /**
- * This function will set \p rop to <tt>op1 * op2</tt>.
+ * This function will set \p rop to the GCD of \p op1 and \p op2. The result is always positive.
+ * If both operands are zero, zero is returned.
  *
  * @param rop the return value.
- * @param op1 the first argument.
- * @param op2 the second argument.
+ * @param op1 the first operand.
+ * @param op2 the second operand.
  *
  * @return a reference to \p rop.
  */
 template <std::size_t SSize>
-inline integer<SSize> &mul(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> &gcd(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
 {
-    const bool s1 = op1.is_static(), s2 = op2.is_static();
-    bool sr = rop.is_static();
-    std::size_t size_hint = 0u;
+    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
     if (mppp_likely(s1 && s2)) {
         if (!sr) {
             rop.set_zero();
-            sr = true;
-        }
-        size_hint = static_mul(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
-        if (mppp_likely(size_hint == 0u)) {
-            return rop;
         }
+        static_gcd(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
+        rop._get_union().g_st().zero_unused_limbs();
+        return rop;
     }
     if (sr) {
-        // We use the size hint from the static_mul if available, otherwise a normal promotion will take place.
-        // NOTE: here the best way of proceeding would be to calculate the max size of the result based on
-        // the op1/op2 sizes, but for whatever reason this computation has disastrous performance consequences
-        // on micro-benchmarks. We need to understand if that's the case in real-world scenarios as well, and
-        // revisit this.
-        rop._get_union().promote(size_hint);
+        rop._get_union().promote();
     }
-    ::mpz_mul(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
+    ::mpz_gcd(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
     return rop;
 }
 
-inline namespace detail
-{
-
-// Selection of the algorithm for addmul: if optimised algorithms exist for both add and mul, then use the
-// optimised addmul algos. Otherwise, use the mpn one.
-template <typename SInt>
-using integer_static_addmul_algo = std::integral_constant<
-    int, (integer_static_add_algo<SInt>::value == 2 && integer_static_mul_algo<SInt>::value == 2)
-             ? 2
-             : ((integer_static_add_algo<SInt>::value == 1 && integer_static_mul_algo<SInt>::value == 1) ? 1 : 0)>;
-
-// NOTE: same return value as mul: 0 for success, otherwise a hint for the size of the result.
+/// GCD (binary version).
+/**
+ * @param op1 the first operand.
+ * @param op2 the second operand.
+ *
+ * @return the GCD of \p op1 and \p op2.
+ */
 template <std::size_t SSize>
-inline std::size_t static_addmul_impl(static_int<SSize> &rop, const static_int<SSize> &op1,
-                                      const static_int<SSize> &op2, mpz_size_t asizer, mpz_size_t asize1,
-                                      mpz_size_t asize2, int signr, int sign1, int sign2,
-                                      const std::integral_constant<int, 0> &)
+inline integer<SSize> gcd(const integer<SSize> &op1, const integer<SSize> &op2)
 {
-    // First try to do the static prod, if it does not work it's a failure.
-    static_int<SSize> prod;
-    if (mppp_unlikely(
-            static_mul_impl(prod, op1, op2, asize1, asize2, sign1, sign2, std::integral_constant<int, 0>{}))) {
-        // This is the maximum size a static addmul can have.
-        return SSize * 2u + 1u;
-    }
-    // Determine sign and asize of the product.
-    mpz_size_t asize_prod = prod._mp_size;
-    int sign_prod = (asize_prod != 0);
-    if (asize_prod < 0) {
-        asize_prod = -asize_prod;
-        sign_prod = -1;
-    }
-    // Try to do the add.
-    if (mppp_unlikely(
-            !static_add_impl(rop, rop, prod, asizer, asize_prod, signr, sign_prod, std::integral_constant<int, 0>{}))) {
-        return SSize + 1u;
-    }
-    return 0u;
+    integer<SSize> retval;
+    gcd(retval, op1, op2);
+    return retval;
 }
 
-template <std::size_t SSize>
-inline std::size_t static_addmul_impl(static_int<SSize> &rop, const static_int<SSize> &op1,
-                                      const static_int<SSize> &op2, mpz_size_t, mpz_size_t, mpz_size_t, int signr,
-                                      int sign1, int sign2, const std::integral_constant<int, 1> &)
+inline namespace detail
 {
-    // First we do op1 * op2.
-    ::mp_limb_t tmp;
-    const ::mp_limb_t prod = dlimb_mul(op1.m_limbs[0], op2.m_limbs[0], &tmp);
-    if (mppp_unlikely(tmp)) {
-        return 3u;
-    }
-    // Determine the sign of the product: 0, 1 or -1.
-    const int sign_prod = sign1 * sign2;
-    // Now add/sub.
-    if (signr == sign_prod) {
-        // Same sign, do addition with overflow check.
-        if (mppp_unlikely(limb_add_overflow(rop.m_limbs[0], prod, &tmp))) {
-            return 2u;
-        }
-        // Assign the output.
-        rop._mp_size = signr;
-        rop.m_limbs[0] = tmp;
-    } else {
-        // When the signs differ, we need to implement addition as a subtraction.
-        if (rop.m_limbs[0] >= prod) {
-            // abs(rop) >= abs(prod).
-            tmp = rop.m_limbs[0] - prod;
-            // asize is either 1 or 0 (0 iff rop == prod).
-            rop._mp_size = signr * static_cast<int>(tmp != 0u);
-            rop.m_limbs[0] = tmp;
-        } else {
-            // NOTE: this cannot be zero, as rop and prod cannot be equal.
-            rop._mp_size = sign_prod;
-            rop.m_limbs[0] = prod - rop.m_limbs[0];
-        }
-    }
-    return 0u;
-}
 
-template <std::size_t SSize>
-inline std::size_t static_addmul_impl(static_int<SSize> &rop, const static_int<SSize> &op1,
-                                      const static_int<SSize> &op2, mpz_size_t asizer, mpz_size_t asize1,
-                                      mpz_size_t asize2, int signr, int sign1, int sign2,
-                                      const std::integral_constant<int, 2> &)
+// Thread-safe cache for the factorials and the binomial coefficients of small arguments, grown lazily
+// on demand. The values are all positive and they are stored as arrays of limbs, so that the cache
+// can be shared by integers of any static size.
+class comb_cache
 {
-    if (mppp_unlikely(!asize1 || !asize2)) {
-        // If op1 or op2 are zero, rop will be unchanged.
-        return 0u;
-    }
-    // Handle op1 * op2.
-    std::array<::mp_limb_t, 2> prod;
-    const int sign_prod = sign1 * sign2;
-    mpz_size_t asize_prod;
-    if (asize1 == 1 && asize2 == 1) {
-        prod[0] = dlimb_mul(op1.m_limbs[0], op2.m_limbs[0], &prod[1]);
-        asize_prod = (asize1 + asize2) - (prod[1] == 0u);
-    } else {
-        // The only possibility of success is 2limbs x 1limb.
-        //
-        //       b       a X
-        //               c
-        // ---------------
-        // prod[1] prod[0]
-        //
-        if (mppp_unlikely(asize1 == asize2)) {
-            // This means that both sizes are 2.
-            return 5u;
-        }
-        ::mp_limb_t a = op1.m_limbs[0], b = op1.m_limbs[1], c = op2.m_limbs[0];
-        if (asize1 < asize2) {
-            // Switch them around if needed.
-            a = op2.m_limbs[0], b = op2.m_limbs[1], c = op1.m_limbs[0];
+public:
+    using entry = std::vector<::mp_limb_t>;
+    // The largest n for which n! is cached.
+    static constexpr unsigned long fac_max = 256;
+    // The largest n for which the binomial coefficients (n, k) are cached.
+    static constexpr unsigned long bin_max = 128;
+    comb_cache() : m_fac_size(0), m_bin_size(0) {}
+    comb_cache(const comb_cache &) = delete;
+    comb_cache &operator=(const comb_cache &) = delete;
+    // NOTE: the entries are written only once, under the lock, before the corresponding size is
+    // published. Hence the readers need to take the lock only if they have to grow the cache.
+    const entry &fac(unsigned long n)
+    {
+        assert(n <= fac_max);
+        if (n >= m_fac_size.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto size = m_fac_size.load(std::memory_order_relaxed); size <= n; ++size) {
+                m_fac[size] = size ? mul_1(m_fac[size - 1u], static_cast<::mp_limb_t>(size)) : entry(1u, 1u);
+                m_fac_size.store(size + 1u, std::memory_order_release);
+            }
         }
-        ::mp_limb_t ca_hi, cb_hi;
-        // These are the three operations that build the result, two mults, one add.
-        prod[0] = dlimb_mul(c, a, &ca_hi);
-        prod[1] = dlimb_mul(c, b, &cb_hi);
-        // NOTE: we can use this with overlapping arguments because the first two
-        // are passed as copies.
-        const auto cy = limb_add_overflow(prod[1], ca_hi, &prod[1]);
-        // Check if the third limb exists, if so we return failure.
-        if (mppp_unlikely(cb_hi || cy)) {
-            return 4u;
+        return m_fac[n];
+    }
+    const entry &bin(unsigned long n, unsigned long k)
+    {
+        assert(n <= bin_max && k <= n);
+        if (n >= m_bin_size.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto size = m_bin_size.load(std::memory_order_relaxed); size <= n; ++size) {
+                // Build the row of Pascal's triangle from the previous one.
+                auto &row = m_bin[size];
+                row.reserve(size + 1u);
+                row.emplace_back(1u, 1u);
+                for (std::size_t i = 1; i < size; ++i) {
+                    row.push_back(add(m_bin[size - 1u][i - 1u], m_bin[size - 1u][i]));
+                }
+                if (size) {
+                    row.emplace_back(1u, 1u);
+                }
+                m_bin_size.store(size + 1u, std::memory_order_release);
+            }
         }
-        asize_prod = 2;
+        return m_bin[n][k];
     }
-    // Proceed to the addition.
-    if (signr == sign_prod) {
-        // Add the hi and lo limbs.
-        ::mp_limb_t lo, hi1, hi2;
-        const ::mp_limb_t cy_lo = limb_add_overflow(rop.m_limbs[0], prod[0], &lo),
-                          cy_hi1 = limb_add_overflow(rop.m_limbs[1], prod[1], &hi1),
-                          cy_hi2 = limb_add_overflow(hi1, cy_lo, &hi2);
-        // The result will overflow if we have any carry relating to the high limb.
-        if (mppp_unlikely(cy_hi1 || cy_hi2)) {
-            return 3u;
+    // Read-only mpz view of an entry.
+    static mpz_struct_t view(const entry &e)
+    {
+        const auto size = safe_cast<mpz_size_t>(e.size());
+        return {size, size, const_cast<::mp_limb_t *>(e.data())};
+    }
+
+private:
+    static entry mul_1(const entry &a, ::mp_limb_t b)
+    {
+        entry retval(a.size() + 1u);
+        retval.back() = ::mpn_mul_1(retval.data(), a.data(), static_cast<::mp_size_t>(a.size()), b);
+        if (!retval.back()) {
+            retval.pop_back();
         }
-        // For the size compuation:
-        // - cannot be zero, as prod is not zero,
-        // - if signr == +-1, then the size is either +-1 or +-2: asize is 2 if the result
-        //   has a nonzero 2nd limb, otherwise asize is 1.
-        rop._mp_size = signr * (static_cast<int>(hi2 != 0u) + 1);
-        rop.m_limbs[0] = lo;
-        rop.m_limbs[1] = hi2;
-    } else {
-        // When the signs differ, we need to implement addition as a subtraction.
-        if (asizer > asize_prod
-            || (asizer == asize_prod && integer_compare_limbs_2(&rop.m_limbs[0], &prod[0], asizer) >= 0)) {
-            // rop >= prod in absolute value.
-            const auto lo = rop.m_limbs[0] - prod[0];
-            // If there's a borrow, then hi1 > hi2, otherwise we would have a negative result.
-            assert(rop.m_limbs[0] >= prod[0] || rop.m_limbs[1] > prod[1]);
-            // This can never wrap around, at most it goes to zero.
-            const auto hi = rop.m_limbs[1] - prod[1] - static_cast<::mp_limb_t>(rop.m_limbs[0] < prod[0]);
-            // asize can be 0, 1 or 2.
-            // NOTE: see the comments in the 2-limb specialisation for addition.
-            rop._mp_size = signr * static_cast<int>((lo != 0u) | (hi != 0u)) * (static_cast<int>(hi != 0u) + 1);
-            rop.m_limbs[0] = lo;
-            rop.m_limbs[1] = hi;
-        } else {
-            // prod > rop in absolute value.
-            const auto lo = prod[0] - rop.m_limbs[0];
-            assert(prod[0] >= rop.m_limbs[0] || prod[1] > rop.m_limbs[1]);
-            const auto hi = prod[1] - rop.m_limbs[1] - static_cast<::mp_limb_t>(prod[0] < rop.m_limbs[0]);
-            // asize can be 1 or 2, but not zero as we know abs(prod) != abs(rop).
-            rop._mp_size = sign_prod * (static_cast<int>(hi != 0u) + 1);
-            rop.m_limbs[0] = lo;
-            rop.m_limbs[1] = hi;
+        return retval;
+    }
+    static entry add(const entry &a, const entry &b)
+    {
+        // NOTE: mpn_add() requires the first operand to be at least as large as the second one.
+        const auto &x = a.size() >= b.size() ? a : b;
+        const auto &y = a.size() >= b.size() ? b : a;
+        entry retval(x.size() + 1u);
+        retval.back() = ::mpn_add(retval.data(), x.data(), static_cast<::mp_size_t>(x.size()), y.data(),
+                                  static_cast<::mp_size_t>(y.size()));
+        if (!retval.back()) {
+            retval.pop_back();
         }
+        return retval;
     }
-    return 0u;
+    std::mutex m_mutex;
+    std::array<entry, fac_max + 1u> m_fac;
+    std::array<std::vector<entry>, bin_max + 1u> m_bin;
+    std::atomic<std::size_t> m_fac_size;
+    std::atomic<std::size_t> m_bin_size;
+};
+
+inline comb_cache &get_comb_cache()
+{
+    static comb_cache cache;
+    return cache;
 }
 
-template <bool AddOrSub, std::size_t SSize>
-inline std::size_t static_addsubmul(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
+// If n is a non-negative value small enough to be in the binomial cache, write it into out and return true.
+template <std::size_t SSize>
+inline bool comb_cache_bin_arg(const integer<SSize> &n, unsigned long &out)
 {
-    // NOTE: negate op2 in case we are doing a submul.
-    mpz_size_t asizer = rop._mp_size, asize1 = op1._mp_size, asize2 = AddOrSub ? op2._mp_size : -op2._mp_size;
-    int signr = asizer != 0, sign1 = asize1 != 0, sign2 = asize2 != 0;
-    if (asizer < 0) {
-        asizer = -asizer;
-        signr = -1;
-    }
-    if (asize1 < 0) {
-        asize1 = -asize1;
-        sign1 = -1;
+    if (!n.is_static()) {
+        return false;
     }
-    if (asize2 < 0) {
-        asize2 = -asize2;
-        sign2 = -1;
+    const auto &st = n._get_union().g_st();
+    if (st._mp_size < 0 || st._mp_size > 1 || (st._mp_size && st.m_limbs[0] > comb_cache::bin_max)) {
+        return false;
     }
-    const std::size_t retval = static_addmul_impl(rop, op1, op2, asizer, asize1, asize2, signr, sign1, sign2,
-                                                  integer_static_addmul_algo<static_int<SSize>>{});
-    if (integer_static_addmul_algo<static_int<SSize>>::value == 0 && retval == 0u) {
-        rop.zero_unused_limbs();
+    out = st._mp_size ? static_cast<unsigned long>(st.m_limbs[0]) : 0ul;
+    return true;
+}
+
+// NOTE: we put a limit on the argument of the factorial because the GMP function just crashes and burns
+// if n is too large, and n does not even need to be that large.
+constexpr unsigned long long fac_ui_max = 1000000ull;
+
+inline void fac_ui_check(unsigned long n)
+{
+    if (mppp_unlikely(n > fac_ui_max)) {
+        throw std::invalid_argument(
+            "The value " + std::to_string(n)
+            + " is too large to be used as input for the factorial function (the maximum allowed value is "
+            + std::to_string(fac_ui_max) + ")");
     }
-    return retval;
 }
 }
 
-/// Ternary multiply–add.
+/// Factorial.
 /**
- * This function will set \p rop to <tt>rop + op1 * op2</tt>.
+ * This function will set \p rop to the factorial of \p n. The factorials of small values of \p n
+ * are cached.
  *
  * @param rop the return value.
- * @param op1 the first argument.
- * @param op2 the second argument.
+ * @param n the argument for the factorial.
  *
  * @return a reference to \p rop.
+ *
+ * @throws std::invalid_argument if \p n is larger than an implementation-defined limit.
  */
 template <std::size_t SSize>
-inline integer<SSize> &addmul(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> &fac_ui(integer<SSize> &rop, unsigned long n)
 {
-    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
-    std::size_t size_hint = 0u;
-    if (mppp_likely(sr && s1 && s2)) {
-        size_hint = static_addsubmul<true>(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
-        if (mppp_likely(size_hint == 0u)) {
-            return rop;
-        }
+    fac_ui_check(n);
+    if (n <= comb_cache::fac_max) {
+        const auto v = comb_cache::view(get_comb_cache().fac(n));
+        return rop = &v;
     }
-    if (sr) {
-        rop._get_union().promote(size_hint);
+    // NOTE: let's get through a static temporary and then assign it to the rop,
+    // so that rop will be static/dynamic according to the size of tmp.
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    ::mpz_fac_ui(&tmp.m_mpz, n);
+    return rop = &tmp.m_mpz;
+}
+
+/// Factorials over a range.
+/**
+ * \rststar
+ * This function will return a vector containing the factorials :math:`n!` for :math:`\mathrm{nmin} \leq n <
+ * \mathrm{nmax}`. The first factorial is computed via :cpp:func:`~mppp::fac_ui()`, the others are computed
+ * incrementally from the previous one.
+ * \endrststar
+ *
+ * @param nmin the lower bound (included).
+ * @param nmax the upper bound (excluded).
+ *
+ * @return the factorials in the \f$\left[ \mathrm{nmin}, \mathrm{nmax} \right)\f$ range.
+ *
+ * @throws std::invalid_argument if <tt>nmax - 1</tt> is larger than the implementation-defined limit of
+ * fac_ui().
+ * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+ */
+template <std::size_t SSize>
+inline std::vector<integer<SSize>> fac_ui_range(unsigned long nmin, unsigned long nmax)
+{
+    std::vector<integer<SSize>> retval;
+    if (nmin >= nmax) {
+        return retval;
     }
-    ::mpz_addmul(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
-    return rop;
+    fac_ui_check(nmax - 1u);
+    retval.reserve(static_cast<typename std::vector<integer<SSize>>::size_type>(nmax - nmin));
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    for (auto n = nmin; n != nmax; ++n) {
+        if (n <= comb_cache::fac_max) {
+            const auto v = comb_cache::view(get_comb_cache().fac(n));
+            retval.emplace_back(&v);
+        } else if (retval.empty()) {
+            ::mpz_fac_ui(&tmp.m_mpz, n);
+            retval.emplace_back(&tmp.m_mpz);
+        } else {
+            // NOTE: no reallocation can happen in the vector, as we reserved enough space.
+            const auto prev = retval.back().get_mpz_view();
+            ::mpz_mul_ui(&tmp.m_mpz, prev, n);
+            retval.emplace_back(&tmp.m_mpz);
+        }
+    }
+    return retval;
 }
 
-/// Ternary multiply–sub.
+/// Binomial coefficient (ternary version).
 /**
- * This function will set \p rop to <tt>rop - op1 * op2</tt>.
+ * This function will set \p rop to the binomial coefficient of \p n and \p k. Negative values of \p n are
+ * supported. The binomial coefficients of small non-negative values of \p n are cached.
  *
  * @param rop the return value.
- * @param op1 the first argument.
- * @param op2 the second argument.
+ * @param n the top argument.
+ * @param k the bottom argument.
  *
  * @return a reference to \p rop.
  */
 template <std::size_t SSize>
-inline integer<SSize> &submul(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> &bin_ui(integer<SSize> &rop, const integer<SSize> &n, unsigned long k)
 {
-    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
-    std::size_t size_hint = 0u;
-    if (mppp_likely(sr && s1 && s2)) {
-        size_hint = static_addsubmul<false>(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
-        if (mppp_likely(size_hint == 0u)) {
-            return rop;
+    unsigned long nu;
+    if (comb_cache_bin_arg(n, nu)) {
+        if (k > nu) {
+            return rop.set_zero();
         }
+        const auto v = comb_cache::view(get_comb_cache().bin(nu, k));
+        return rop = &v;
     }
-    if (sr) {
-        rop._get_union().promote(size_hint);
-    }
-    ::mpz_submul(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
-    return rop;
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    ::mpz_bin_ui(&tmp.m_mpz, n.get_mpz_view(), k);
+    return rop = &tmp.m_mpz;
 }
 
-inline namespace detail
+/// Binomial coefficient (binary version).
+/**
+ * @param n the top argument.
+ * @param k the bottom argument.
+ *
+ * @return the binomial coefficient of \p n and \p k.
+ */
+template <std::size_t SSize>
+inline integer<SSize> bin_ui(const integer<SSize> &n, unsigned long k)
 {
+    integer<SSize> retval;
+    bin_ui(retval, n, k);
+    return retval;
+}
 
-// Selection of the algorithm for static mul_2exp.
-template <typename SInt>
-using integer_static_mul_2exp_algo = std::integral_constant<int, (SInt::s_size > 2) ? 0 : SInt::s_size>;
-
-// mpn implementation.
+/// Binomial coefficients over a range.
+/**
+ * \rststar
+ * This function will return a vector containing the binomial coefficients :math:`{{n}\choose{k}}` for
+ * :math:`\mathrm{kmin} \leq k < \mathrm{kmax}`. Negative values of ``n`` are supported. The first coefficient
+ * is computed via :cpp:func:`~mppp::bin_ui()`, the others are computed incrementally via the recurrence
+ *
+ * .. math::
+ *
+ *    {{n}\choose{k}} = {{n}\choose{k-1}}\frac{n-k+1}{k},
+ *
+ * which is much faster than computing each coefficient separately.
+ * \endrststar
+ *
+ * @param n the top argument.
+ * @param kmin the lower bound for the bottom argument (included).
+ * @param kmax the upper bound for the bottom argument (excluded).
+ *
+ * @return the binomial coefficients of \p n and \f$ k \in \left[ \mathrm{kmin}, \mathrm{kmax} \right) \f$.
+ *
+ * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+ */
 template <std::size_t SSize>
-inline std::size_t static_mul_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, std::size_t s,
-                                        const std::integral_constant<int, 0> &)
+inline std::vector<integer<SSize>> bin_ui_range(const integer<SSize> &n, unsigned long kmin, unsigned long kmax)
 {
-    mpz_size_t asize = n._mp_size;
-    if (s == 0u || asize == 0) {
-        // If shift is zero, or the operand is zero, write n into rop and return success.
-        rop = n;
-        return 0u;
-    }
-    // Finish setting up asize and sign.
-    int sign = 1;
-    if (asize < 0) {
-        asize = -asize;
-        sign = -1;
-    }
-    // ls: number of entire limbs shifted.
-    // rs: effective shift that will be passed to the mpn function.
-    const std::size_t ls = s / unsigned(GMP_NUMB_BITS), rs = s % unsigned(GMP_NUMB_BITS);
-    // At the very minimum, the new asize will be the old asize plus ls.
-    // Check if we can represent it first.
-    // NOTE: use >= because we may need to increase by 1 new_asize at the end, as a size hint.
-    // LCOV_EXCL_START
-    if (mppp_unlikely(ls >= std::numeric_limits<std::size_t>::max() - static_cast<std::size_t>(asize))) {
-        // NOTE: don't think this can be hit on any setup currently.
-        throw std::overflow_error("A left bitshift value of " + std::to_string(s) + " is too large");
+    std::vector<integer<SSize>> retval;
+    if (kmin >= kmax) {
+        return retval;
     }
-    // LCOV_EXCL_STOP
-    const std::size_t new_asize = static_cast<std::size_t>(asize) + ls;
-    if (new_asize < SSize) {
-        // In this case the operation will always succeed, and we can write directly into rop.
-        ::mp_limb_t ret = 0u;
-        if (rs) {
-            // Perform the shift via the mpn function, if we are effectively shifting at least 1 bit.
-            // Overlapping is fine, as it is guaranteed that rop.m_limbs.data() + ls >= n.m_limbs.data().
-            ret = ::mpn_lshift(rop.m_limbs.data() + ls, n.m_limbs.data(), static_cast<::mp_size_t>(asize),
-                               unsigned(rs));
-            // Write bits spilling out.
-            rop.m_limbs[new_asize] = ret;
-        } else {
-            // Otherwise, just copy over (the mpn function requires the shift to be at least 1).
-            // NOTE: we have to use move_backward here because the ranges may be overlapping but not
-            // starting at the same pointer (in which case we could've used copy_limbs()). Here we know ls is not
-            // zero: we don't have a remainder, and s == 0 was already handled above. Hence, new_asize > asize.
-            assert(new_asize > static_cast<std::size_t>(asize));
-            std::move_backward(n.m_limbs.begin(), n.m_limbs.begin() + asize, rop.m_limbs.begin() + new_asize);
+    retval.reserve(static_cast<typename std::vector<integer<SSize>>::size_type>(kmax - kmin));
+    unsigned long nu;
+    if (comb_cache_bin_arg(n, nu)) {
+        auto &cache = get_comb_cache();
+        for (auto k = kmin; k != kmax && k <= nu; ++k) {
+            const auto v = comb_cache::view(cache.bin(nu, k));
+            retval.emplace_back(&v);
         }
-        // Zero the lower limbs vacated by the shift. We need to do this as we don't know
-        // the state of rop.
-        std::fill(rop.m_limbs.data(), rop.m_limbs.data() + ls, ::mp_limb_t(0));
-        // Set the size.
-        rop._mp_size = sign * (static_cast<mpz_size_t>(new_asize) + (ret != 0u));
-        return 0u;
+        retval.resize(static_cast<typename std::vector<integer<SSize>>::size_type>(kmax - kmin));
+        return retval;
     }
-    if (new_asize == SSize) {
-        if (rs) {
-            // In this case the operation may fail, so we need to write to temporary storage.
-            std::array<::mp_limb_t, SSize> tmp;
-            if (::mpn_lshift(tmp.data(), n.m_limbs.data(), static_cast<::mp_size_t>(asize), unsigned(rs))) {
-                return SSize + 1u;
-            }
-            // The shift was successful without spill over, copy the content from the tmp
-            // storage into rop.
-            copy_limbs_no(tmp.data(), tmp.data() + asize, rop.m_limbs.data() + ls);
-        } else {
-            // If we shifted by a multiple of the limb size, then we can write directly to rop.
-            assert(new_asize > static_cast<std::size_t>(asize));
-            std::move_backward(n.m_limbs.begin(), n.m_limbs.begin() + asize, rop.m_limbs.begin() + new_asize);
-        }
-        // Zero the lower limbs vacated by the shift.
-        std::fill(rop.m_limbs.data(), rop.m_limbs.data() + ls, ::mp_limb_t(0));
-        // Set the size.
-        rop._mp_size = sign * static_cast<mpz_size_t>(new_asize);
-        return 0u;
+    MPPP_MAYBE_TLS mpz_raii acc, nmk;
+    const auto nv = n.get_mpz_view();
+    ::mpz_bin_ui(&acc.m_mpz, nv, kmin);
+    // NOTE: nmk will contain n - k + 1.
+    ::mpz_sub_ui(&nmk.m_mpz, nv, kmin);
+    for (auto k = kmin;;) {
+        retval.emplace_back(&acc.m_mpz);
+        if (++k == kmax) {
+            break;
+        }
+        if (::mpz_fits_slong_p(&nmk.m_mpz)) {
+            ::mpz_mul_si(&acc.m_mpz, &acc.m_mpz, ::mpz_get_si(&nmk.m_mpz));
+        } else {
+            ::mpz_mul(&acc.m_mpz, &acc.m_mpz, &nmk.m_mpz);
+        }
+        ::mpz_divexact_ui(&acc.m_mpz, &acc.m_mpz, k);
+        ::mpz_sub_ui(&nmk.m_mpz, &nmk.m_mpz, 1u);
     }
-    // Shift is too much, the size will overflow the static limit. Return a hint for the size of the result.
-    // We checked above we can compute this safely.
-    return new_asize + 1u;
+    return retval;
 }
 
-// 1-limb optimisation.
-template <std::size_t SSize>
-inline std::size_t static_mul_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, std::size_t s,
-                                        const std::integral_constant<int, 1> &)
+inline namespace detail
 {
-    const ::mp_limb_t l = n.m_limbs[0] & GMP_NUMB_MASK;
-    if (s == 0u || l == 0u) {
-        // If shift is zero, or the operand is zero, write n into rop and return success.
-        rop = n;
-        return 0u;
-    }
-    if (mppp_unlikely(s >= unsigned(GMP_NUMB_BITS) || (l >> (unsigned(GMP_NUMB_BITS) - s)))) {
-        // The two conditions:
-        // - if the shift is >= number of data bits, the operation will certainly
-        //   fail (as the operand is nonzero);
-        // - shifting by s would overflow  the single limb.
-        // NOTE: s is at least 1, so in the right shift above we never risk UB due to too much shift.
-        // NOTE: for the size hint: s / nbits is the number of entire limbs shifted, +1 because the shifted
-        // limbs add to the current size (1), +1 because another limb might be needed.
-        // NOTE: paranoia static assert to make sure there's no chance of overflowing.
-        static_assert(GMP_NUMB_BITS > 1, "Invalid number of bits.");
-        return s / unsigned(GMP_NUMB_BITS) + 2u;
+
+// These helpers are used here and in pow() as well.
+template <typename T, enable_if_t<std::is_integral<T>::value, int> = 0>
+inline unsigned long integer_exp_to_ulong(const T &exp)
+{
+#if !defined(__INTEL_COMPILER)
+    assert(exp >= T(0));
+#endif
+    // NOTE: make_unsigned_t<T> is T if T is already unsigned.
+    if (mppp_unlikely(static_cast<make_unsigned_t<T>>(exp) > std::numeric_limits<unsigned long>::max())) {
+        throw std::overflow_error("Cannot convert the integral value " + std::to_string(exp)
+                                  + " to unsigned long: the value is too large.");
     }
-    // Write out.
-    rop.m_limbs[0] = l << s;
-    // Size is the same as the input value.
-    rop._mp_size = n._mp_size;
-    return 0u;
+    return static_cast<unsigned long>(exp);
 }
 
-// 2-limb optimisation.
 template <std::size_t SSize>
-inline std::size_t static_mul_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, std::size_t s,
-                                        const std::integral_constant<int, 2> &)
+inline unsigned long integer_exp_to_ulong(const integer<SSize> &exp)
 {
-    mpz_size_t asize = n._mp_size;
-    if (s == 0u || asize == 0) {
-        rop = n;
-        return 0u;
-    }
-    int sign = 1;
-    if (asize < 0) {
-        asize = -asize;
-        sign = -1;
+    try {
+        return static_cast<unsigned long>(exp);
+    } catch (const std::overflow_error &) {
+        // Rewrite the error message.
+        throw std::overflow_error("Cannot convert the integral value " + exp.to_string()
+                                  + " to unsigned long: the value is too large.");
     }
-    // Too much shift, this can never work on a nonzero value.
-    static_assert(unsigned(GMP_NUMB_BITS) <= std::numeric_limits<unsigned>::max() / 2u, "Overflow error.");
-    if (mppp_unlikely(s >= 2u * unsigned(GMP_NUMB_BITS))) {
-        // NOTE: this is the generic formula to estimate the final size.
-        // NOTE: paranoia static assert to make sure there's no chance of overflowing.
-        static_assert(GMP_NUMB_BITS > 1, "Invalid number of bits.");
-        // NOTE: asize is 2 at most, no need to check for overflow.
-        return s / unsigned(GMP_NUMB_BITS) + 1u + static_cast<std::size_t>(asize);
+}
+
+template <typename T, std::size_t SSize, enable_if_t<!is_integer_int128<T>::value, int> = 0>
+inline integer<SSize> binomial_impl(const integer<SSize> &n, const T &k)
+{
+    // NOTE: here we re-use some helper methods used in the implementation of pow().
+    if (sgn(k) >= 0) {
+        return bin_ui(n, integer_exp_to_ulong(k));
     }
-    if (s == unsigned(GMP_NUMB_BITS)) {
-        // This case can be dealt with moving lo into hi, but only if asize is 1.
-        if (mppp_unlikely(asize == 2)) {
-            // asize is 2, shift is too much.
-            return 3u;
-        }
-        rop.m_limbs[1u] = n.m_limbs[0u];
-        rop.m_limbs[0u] = 0u;
-        // The asize has to be 2.
-        rop._mp_size = 2 * sign;
-        return 0u;
+    // This is the case k < 0, handled according to:
+    // http://arxiv.org/abs/1105.3689/
+    if (n.sgn() >= 0) {
+        // n >= 0, k < 0.
+        return integer<SSize>{};
     }
-    // Temp hi lo limbs to store the result that will eventually go into rop.
-    ::mp_limb_t lo = n.m_limbs[0u], hi = n.m_limbs[1u];
-    if (s > unsigned(GMP_NUMB_BITS)) {
-        if (mppp_unlikely(asize == 2)) {
-            return s / unsigned(GMP_NUMB_BITS) + 1u + static_cast<std::size_t>(asize);
+    // n < 0, k < 0.
+    if (k <= n) {
+        // The formula is: (-1)**(n-k) * binomial(-k-1,n-k).
+        // Cache n-k.
+        const integer<SSize> nmk{n - k};
+        integer<SSize> tmp{k};
+        ++tmp;
+        tmp.neg();
+        auto retval = bin_ui(tmp, integer_exp_to_ulong(nmk));
+        if (nmk.odd_p()) {
+            retval.neg();
         }
-        // Move lo to hi and set lo to zero.
-        hi = n.m_limbs[0u];
-        lo = 0u;
-        // Update the shift.
-        s = static_cast<std::size_t>(s - unsigned(GMP_NUMB_BITS));
-    }
-    // Check that hi will not be shifted too much. Note that
-    // here and below s can never be zero, so we never shift too much.
-    assert(s > 0u && s < unsigned(GMP_NUMB_BITS));
-    if (mppp_unlikely((hi & GMP_NUMB_MASK) >> (unsigned(GMP_NUMB_BITS) - s))) {
-        return 3u;
+        return retval;
     }
-    // Shift hi and lo. hi gets the carry over from lo.
-    hi = ((hi & GMP_NUMB_MASK) << s) + ((lo & GMP_NUMB_MASK) >> (unsigned(GMP_NUMB_BITS) - s));
-    // NOTE: here the result needs to be masked as well as the shift could
-    // end up writing in nail bits.
-    lo = ((lo & GMP_NUMB_MASK) << s) & GMP_NUMB_MASK;
-    // Write rop.
-    rop.m_limbs[0u] = lo;
-    rop.m_limbs[1u] = hi;
-    // asize is at least 1.
-    rop._mp_size = sign * (1 + (hi != 0u));
-    return 0u;
+    return integer<SSize>{};
 }
 
-template <std::size_t SSize>
-inline std::size_t static_mul_2exp(static_int<SSize> &rop, const static_int<SSize> &n, std::size_t s)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> binomial_impl(const T &n, const integer<SSize> &k)
 {
-    const std::size_t retval = static_mul_2exp_impl(rop, n, s, integer_static_mul_2exp_algo<static_int<SSize>>{});
-    if (integer_static_mul_2exp_algo<static_int<SSize>>::value == 0 && retval == 0u) {
-        rop.zero_unused_limbs();
-    }
-    return retval;
+    return binomial_impl(integer<SSize>{n}, k);
+}
+
+template <typename T, std::size_t SSize, enable_if_t<is_integer_int128<T>::value, int> = 0>
+inline integer<SSize> binomial_impl(const integer<SSize> &n, const T &k)
+{
+    return binomial_impl(n, integer<SSize>{k});
 }
 }
 
-/// Ternary left shift.
+/// Generic binomial coefficient.
 /**
- * This function will set \p rop to \p n multiplied by <tt>2**s</tt>.
+ * \rststar
+ * This function is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerIntegralOpTypes`.
+ * The return type is :cpp:class:`~mppp::integer`.
  *
- * @param rop the return value.
- * @param n the multiplicand.
- * @param s the bit shift value.
+ * This function will compute the binomial coefficient :math:`{{n}\choose{k}}`, supporting integral input values.
+ * The implementation can handle positive and negative values for both the top and the bottom argument.
  *
- * @return a reference to \p rop.
+ * .. seealso::
  *
- * @throws std::overflow_error if \p s is larger than an implementation-defined limit.
+ *    http://arxiv.org/abs/1105.3689/
+ *
+ * \endrststar
+ *
+ * @param n the top argument.
+ * @param k the bottom argument.
+ *
+ * @return \f$ {{n}\choose{k}} \f$.
+ *
+ * @throws std::overflow_error if \p k is outside an implementation-defined range.
  */
+#if defined(MPPP_HAVE_CONCEPTS)
+template <typename T, typename U>
+#if !defined(MPPP_DOXYGEN_INVOKED)
+requires IntegerIntegralOpTypes<T, U>
+#endif
+#else
+template <typename T, typename U, integer_integral_op_types_enabler<T, U> = 0>
+#endif
+    inline integer_common_t<T, U> binomial(const T &n, const U &k)
+{
+    return binomial_impl(n, k);
+}
+
+inline namespace detail
+{
+
 template <std::size_t SSize>
-inline integer<SSize> &mul_2exp(integer<SSize> &rop, const integer<SSize> &n, ::mp_bitcnt_t s)
+inline void nextprime_impl(integer<SSize> &rop, const integer<SSize> &n)
 {
-    const bool sn = n.is_static();
-    bool sr = rop.is_static();
-    std::size_t size_hint = 0u;
-    if (mppp_likely(sn)) {
-        // NOTE: we cast to size_t because it's more convenient for reasoning about number of limbs
-        // in the implementation functions.
-        // NOTE: do it before touching rop, for exception safety.
-        const auto s_size = safe_cast<std::size_t>(s);
-        if (!sr) {
-            rop.set_zero();
-            sr = true;
-        }
-        size_hint = static_mul_2exp(rop._get_union().g_st(), n._get_union().g_st(), s_size);
-        if (mppp_likely(size_hint == 0u)) {
-            return rop;
+    if (n.is_static() && n.sgn() >= 0) {
+        if (rop.is_static()) {
+            if (static_nextprime(rop._get_union().g_st(), n._get_union().g_st())) {
+                return;
+            }
+        } else {
+            static_int<SSize> tmp;
+            if (static_nextprime(tmp, n._get_union().g_st())) {
+                const auto v = tmp.get_mpz_view();
+                rop = &v;
+                return;
+            }
         }
     }
-    if (sr) {
-        rop._get_union().promote(size_hint);
-    }
-    ::mpz_mul_2exp(&rop._get_union().g_dy(), n.get_mpz_view(), s);
-    return rop;
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    ::mpz_nextprime(&tmp.m_mpz, n.get_mpz_view());
+    rop = &tmp.m_mpz;
+}
 }
 
-/// Binary negation.
+/// Compute next prime number (binary version).
 /**
- * This method will set \p rop to <tt>-n</tt>.
+ * This function will set \p rop to the first prime number greater than \p n.
+ * Note that for negative values of \p n this function always returns 2.
  *
  * @param rop the return value.
- * @param n the integer that will be negated.
+ * @param n the integer argument.
  *
  * @return a reference to \p rop.
  */
 template <std::size_t SSize>
-inline integer<SSize> &neg(integer<SSize> &rop, const integer<SSize> &n)
-{
-    rop = n;
-    return rop.neg();
-}
-
-/// Unary negation.
-/**
- * @param n the integer that will be negated.
- *
- * @return <tt>-n</tt>.
- */
-template <std::size_t SSize>
-inline integer<SSize> neg(const integer<SSize> &n)
+inline integer<SSize> &nextprime(integer<SSize> &rop, const integer<SSize> &n)
 {
-    integer<SSize> ret(n);
-    ret.neg();
-    return ret;
+    // NOTE: nextprime on negative numbers always returns 2.
+    nextprime_impl(rop, n);
+    return rop;
 }
-
-/// Binary absolute value.
-/**
- * This function will set \p rop to the absolute value of \p n.
- *
- * @param rop the return value.
- * @param n the argument.
+
+/// Compute next prime number (unary version).
+/**
+ * @param n the integer argument.
  *
- * @return a reference to \p rop.
+ * @return the first prime number greater than \p n.
  */
 template <std::size_t SSize>
-inline integer<SSize> &abs(integer<SSize> &rop, const integer<SSize> &n)
+inline integer<SSize> nextprime(const integer<SSize> &n)
 {
-    rop = n;
-    return rop.abs();
+    integer<SSize> retval;
+    nextprime_impl(retval, n);
+    return retval;
 }
 
-/// Unary absolute value.
+/// Test primality.
 /**
- * @param n the argument.
+ * \rststar
+ * This is the free-function version of :cpp:func:`mppp::integer::probab_prime_p()`.
+ * \endrststar
  *
- * @return the absolute value of \p n.
+ * @param n the integer whose primality will be tested.
+ * @param reps the number of tests to run.
+ *
+ * @return an integer indicating if \p n is a prime.
+ *
+ * @throws unspecified any exception thrown by integer::probab_prime_p().
  */
 template <std::size_t SSize>
-inline integer<SSize> abs(const integer<SSize> &n)
+inline int probab_prime_p(const integer<SSize> &n, int reps = 25)
 {
-    integer<SSize> ret(n);
-    ret.abs();
-    return ret;
+    return n.probab_prime_p(reps);
 }
 
-/** @} */
-
-/** @defgroup integer_division integer_division
- *  @{
- */
-
 inline namespace detail
 {
 
-// Detect the presence of dual-limb division. This is currently possible only if:
-// - we are on a 32bit build (with the usual constraints that the types have exactly 32/64 bits and no nails),
-// - we are on a 64bit build and we have the 128bit int type available (plus usual constraints).
-// MSVC currently does not provide any primitive for 128bit division.
-using integer_have_dlimb_div = std::integral_constant<bool,
-#if defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64)
-                                                      !GMP_NAIL_BITS && std::numeric_limits<::mp_limb_t>::digits == 64
-#elif GMP_NUMB_BITS == 32
-                                                      !GMP_NAIL_BITS
-                                                          && std::numeric_limits<std::uint_least64_t>::digits == 64
-                                                          && std::numeric_limits<::mp_limb_t>::digits == 32
-#else
-                                                      false
-#endif
-                                                      >;
-
-// Selection of algorithm for static division:
-// - for 1 limb, we can always do static division,
-// - for 2 limbs, we need the dual limb division if avaiable,
-// - otherwise we just use the mpn functions.
-template <typename SInt>
-using integer_static_div_algo
-    = std::integral_constant<int,
-                             SInt::s_size == 1 ? 1 : ((SInt::s_size == 2 && integer_have_dlimb_div::value) ? 2 : 0)>;
+// Bound for the trial division in factor().
+constexpr unsigned long factor_trial_bound = 1024u;
 
-// mpn implementation.
-template <std::size_t SSize>
-inline void static_div_impl(static_int<SSize> &q, static_int<SSize> &r, const static_int<SSize> &op1,
-                            const static_int<SSize> &op2, mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                            const std::integral_constant<int, 0> &)
+// Euclidean GCD on unsigned integral values.
+template <typename T>
+inline T uint_gcd(T a, T b)
 {
-    // First we check if the divisor is larger than the dividend (in abs limb size), as the mpn function
-    // requires asize1 >= asize2.
-    if (asize2 > asize1) {
-        // Copy op1 into the remainder.
-        r = op1;
-        // Zero out q.
-        q._mp_size = 0;
-        return;
-    }
-    // We need to take care of potentially overlapping arguments. We know that q and r are distinct, but op1
-    // could overlap with q or r, and op2 could overlap with op1, q or r.
-    std::array<::mp_limb_t, SSize> op1_alt, op2_alt;
-    const ::mp_limb_t *data1 = op1.m_limbs.data();
-    const ::mp_limb_t *data2 = op2.m_limbs.data();
-    if (&op1 == &q || &op1 == &r) {
-        copy_limbs_no(data1, data1 + asize1, op1_alt.data());
-        data1 = op1_alt.data();
-    }
-    if (&op2 == &q || &op2 == &r || &op1 == &op2) {
-        copy_limbs_no(data2, data2 + asize2, op2_alt.data());
-        data2 = op2_alt.data();
-    }
-    // Small helper function to verify that all pointers are distinct. Used exclusively for debugging purposes.
-    auto distinct_op = [&q, &r, data1, data2]() -> bool {
-        const ::mp_limb_t *ptrs[] = {q.m_limbs.data(), r.m_limbs.data(), data1, data2};
-        std::sort(ptrs, ptrs + 4, std::less<const ::mp_limb_t *>());
-        return std::unique(ptrs, ptrs + 4) == (ptrs + 4);
-    };
-    (void)distinct_op;
-    assert(distinct_op());
-    // Proceed to the division.
-    if (asize2 == 1) {
-        // Optimization when the divisor has 1 limb.
-        r.m_limbs[0]
-            = ::mpn_divrem_1(q.m_limbs.data(), ::mp_size_t(0), data1, static_cast<::mp_size_t>(asize1), data2[0]);
-    } else {
-        // General implementation.
-        ::mpn_tdiv_qr(q.m_limbs.data(), r.m_limbs.data(), ::mp_size_t(0), data1, static_cast<::mp_size_t>(asize1),
-                      data2, static_cast<::mp_size_t>(asize2));
-    }
-    // Complete the quotient: compute size and sign.
-    q._mp_size = asize1 - asize2 + 1;
-    while (q._mp_size && !(q.m_limbs[static_cast<std::size_t>(q._mp_size - 1)] & GMP_NUMB_MASK)) {
-        --q._mp_size;
-    }
-    if (sign1 != sign2) {
-        q._mp_size = -q._mp_size;
-    }
-    // Complete the remainder.
-    r._mp_size = asize2;
-    while (r._mp_size && !(r.m_limbs[static_cast<std::size_t>(r._mp_size - 1)] & GMP_NUMB_MASK)) {
-        --r._mp_size;
-    }
-    if (sign1 == -1) {
-        r._mp_size = -r._mp_size;
+    while (b) {
+        const auto r = a % b;
+        a = b;
+        b = r;
     }
+    return a;
 }
 
-// 1-limb optimisation.
-template <std::size_t SSize>
-inline void static_div_impl(static_int<SSize> &q, static_int<SSize> &r, const static_int<SSize> &op1,
-                            const static_int<SSize> &op2, mpz_size_t, mpz_size_t, int sign1, int sign2,
-                            const std::integral_constant<int, 1> &)
+#if defined(__clang__) || defined(__GNUC__)
+
+// Binary GCD on limbs, which avoids the divisions of the Euclidean algorithm.
+inline ::mp_limb_t uint_gcd(::mp_limb_t u, ::mp_limb_t v)
 {
-    // NOTE: here we have to use GMP_NUMB_MASK because if s_size is 1 this implementation is *always*
-    // called, even if we have nail bits (whereas the optimisation for other operations currently kicks in
-    // only without nail bits). Thus, we need to discard from m_limbs[0] the nail bits before doing the
-    // division.
-    const ::mp_limb_t q_ = (op1.m_limbs[0] & GMP_NUMB_MASK) / (op2.m_limbs[0] & GMP_NUMB_MASK),
-                      r_ = (op1.m_limbs[0] & GMP_NUMB_MASK) % (op2.m_limbs[0] & GMP_NUMB_MASK);
-    // Write q.
-    q._mp_size = sign1 * sign2 * (q_ != 0u);
-    // NOTE: there should be no need here to mask.
-    q.m_limbs[0] = q_;
-    // Write r.
-    // Following C++11, the sign of r is the sign of op1:
-    // http://stackoverflow.com/questions/13100711/operator-modulo-change-in-c-11
-    r._mp_size = sign1 * (r_ != 0u);
-    r.m_limbs[0] = r_;
+    if (!u) {
+        return v;
+    }
+    if (!v) {
+        return u;
+    }
+    const auto shift = builtin_ctz(u | v);
+    u >>= builtin_ctz(u);
+    do {
+        v >>= builtin_ctz(v);
+        if (u > v) {
+            std::swap(u, v);
+        }
+        v -= u;
+    } while (v);
+    return u << shift;
 }
 
+#endif
+
 #if defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
-inline void dlimb_div(::mp_limb_t op11, ::mp_limb_t op12, ::mp_limb_t op21, ::mp_limb_t op22,
-                      ::mp_limb_t *MPPP_RESTRICT q1, ::mp_limb_t *MPPP_RESTRICT q2, ::mp_limb_t *MPPP_RESTRICT r1,
-                      ::mp_limb_t *MPPP_RESTRICT r2)
-{
-    using dlimb_t = MPPP_UINT128;
-    const auto op1 = op11 + (dlimb_t(op12) << 64);
-    const auto op2 = op21 + (dlimb_t(op22) << 64);
-    const auto q = op1 / op2, r = op1 % op2;
-    *q1 = static_cast<::mp_limb_t>(q & ::mp_limb_t(-1));
-    *q2 = static_cast<::mp_limb_t>(q >> 64);
-    *r1 = static_cast<::mp_limb_t>(r & ::mp_limb_t(-1));
-    *r2 = static_cast<::mp_limb_t>(r >> 64);
+
+// Pollard's rho method with Brent's cycle detection, on the odd composite n, using the iteration x -> x**2 + c
+// in Montgomery arithmetic. The products of the differences are accumulated in blocks, so that only one GCD
+// per block needs to be computed. Returns a proper factor of n, n itself if the method failed (in which case
+// it can be retried with a different c), or zero if the maximum cycle length max_r was exceeded.
+template <typename Mont, typename T>
+inline T mont_pollard_brent(const Mont &m, T n, T c, T max_r)
+{
+    constexpr T block_size = 128u;
+    const auto cm = m.to_mont(c);
+    const auto f = [&m, cm](T x) { return m.add(m.mul(x, x), cm); };
+    const auto diff = [](T a, T b) { return a > b ? a - b : b - a; };
+    T x = 0, ys = 0, y = m.to_mont(2u), q = m.one(), g = 1u;
+    for (T r = 1u; g == 1u; r <<= 1) {
+        if (r > max_r) {
+            return 0u;
+        }
+        x = y;
+        for (T i = 0; i < r; ++i) {
+            y = f(y);
+        }
+        for (T k = 0; k < r && g == 1u; k += block_size) {
+            ys = y;
+            const auto lim = r - k < block_size ? r - k : block_size;
+            for (T i = 0; i < lim; ++i) {
+                y = f(y);
+                q = m.mul(q, diff(x, y));
+            }
+            // NOTE: q is in Montgomery form, but R is coprime with n and thus
+            // it does not change the GCD.
+            g = uint_gcd(q, n);
+        }
+    }
+    if (g == n) {
+        // The accumulated product hit a multiple of n: backtrack
+        // from the beginning of the last block, one step at a time.
+        do {
+            ys = f(ys);
+            g = uint_gcd(diff(x, ys), n);
+        } while (g == 1u);
+    }
+    return g;
 }
 
-// Without remainder.
-inline void dlimb_div(::mp_limb_t op11, ::mp_limb_t op12, ::mp_limb_t op21, ::mp_limb_t op22,
-                      ::mp_limb_t *MPPP_RESTRICT q1, ::mp_limb_t *MPPP_RESTRICT q2)
+// Shanks' square forms factorisation of the odd composite n, trying a few multipliers.
+// Returns a proper factor of n, or zero if the method failed.
+inline ::mp_limb_t limb_squfof(::mp_limb_t n)
 {
-    using dlimb_t = MPPP_UINT128;
-    const auto op1 = op11 + (dlimb_t(op12) << 64);
-    const auto op2 = op21 + (dlimb_t(op22) << 64);
-    const auto q = op1 / op2;
-    *q1 = static_cast<::mp_limb_t>(q & ::mp_limb_t(-1));
-    *q2 = static_cast<::mp_limb_t>(q >> 64);
+    using sl_t = long long;
+    for (::mp_limb_t k : {1ull, 3ull, 5ull, 7ull, 11ull, 15ull, 21ull, 33ull, 35ull, 55ull, 77ull, 105ull, 165ull,
+                          231ull, 385ull, 1155ull}) {
+        if (n > GMP_NUMB_MAX / k) {
+            break;
+        }
+        const auto kn = k * n;
+        const auto s = limb_isqrt(kn);
+        if (s * s == kn) {
+            const auto g = uint_gcd(n, s);
+            if (g != 1u && g != n) {
+                return g;
+            }
+            continue;
+        }
+        // Forward cycle, looking for a square form.
+        const auto p0 = static_cast<sl_t>(s);
+        sl_t p_prev = p0, p = p0, q_prev = 1, q = static_cast<sl_t>(kn - s * s), r = 0;
+        const auto bound = static_cast<sl_t>(6u * limb_isqrt(2u * s));
+        sl_t i = 2;
+        for (; i < bound; ++i) {
+            const auto b = (p0 + p) / q;
+            p = b * q - p;
+            const auto q_cur = q;
+            q = q_prev + b * (p_prev - p);
+            r = static_cast<sl_t>(limb_isqrt(static_cast<::mp_limb_t>(q)));
+            if (!(i & 1) && r * r == q) {
+                break;
+            }
+            q_prev = q_cur;
+            p_prev = p;
+        }
+        if (i >= bound) {
+            continue;
+        }
+        // Reverse cycle, looking for the symmetry point.
+        const auto b0 = (p0 - p) / r;
+        p_prev = p = b0 * r + p;
+        q_prev = r;
+        q = static_cast<sl_t>((kn - static_cast<::mp_limb_t>(p_prev) * static_cast<::mp_limb_t>(p_prev))
+                              / static_cast<::mp_limb_t>(q_prev));
+        for (sl_t j = 0; j < bound; ++j) {
+            const auto b = (p0 + p) / q;
+            p_prev = p;
+            p = b * q - p;
+            const auto q_cur = q;
+            q = q_prev + b * (p_prev - p);
+            q_prev = q_cur;
+            if (p == p_prev) {
+                break;
+            }
+        }
+        const auto g = uint_gcd(n, static_cast<::mp_limb_t>(q_prev));
+        if (g != 1u && g != n) {
+            return g;
+        }
+    }
+    return 0u;
 }
 
-#elif GMP_NUMB_BITS == 32 && !GMP_NAIL_BITS
-
-inline void dlimb_div(::mp_limb_t op11, ::mp_limb_t op12, ::mp_limb_t op21, ::mp_limb_t op22,
-                      ::mp_limb_t *MPPP_RESTRICT q1, ::mp_limb_t *MPPP_RESTRICT q2, ::mp_limb_t *MPPP_RESTRICT r1,
-                      ::mp_limb_t *MPPP_RESTRICT r2)
+// Factor the single-limb value n, which must be odd and larger than 1, appending the prime factors to out.
+inline void limb_factor(::mp_limb_t n, std::vector<::mp_limb_t> &out)
 {
-    using dlimb_t = std::uint_least64_t;
-    const auto op1 = op11 + (dlimb_t(op12) << 32);
-    const auto op2 = op21 + (dlimb_t(op22) << 32);
-    const auto q = op1 / op2, r = op1 % op2;
-    *q1 = static_cast<::mp_limb_t>(q & ::mp_limb_t(-1));
-    *q2 = static_cast<::mp_limb_t>(q >> 32);
-    *r1 = static_cast<::mp_limb_t>(r & ::mp_limb_t(-1));
-    *r2 = static_cast<::mp_limb_t>(r >> 32);
+    assert(n > 1u && (n & 1u));
+    if (limb_is_prime(n)) {
+        out.push_back(n);
+        return;
+    }
+    const limb_mont m(n);
+    ::mp_limb_t d, c = 1;
+    // Pollard-Brent with a cycle length large enough for any 64-bit value with high probability,
+    // then SQUFOF and finally Pollard-Brent with no limits.
+    while ((d = mont_pollard_brent(m, n, c, ::mp_limb_t(1) << 22)) == n) {
+        ++c;
+    }
+    if (!d) {
+        d = limb_squfof(n);
+    }
+    while (!d || d == n) {
+        d = mont_pollard_brent(m, n, ++c, GMP_NUMB_MAX);
+    }
+    limb_factor(d, out);
+    limb_factor(n / d, out);
 }
 
-inline void dlimb_div(::mp_limb_t op11, ::mp_limb_t op12, ::mp_limb_t op21, ::mp_limb_t op22,
-                      ::mp_limb_t *MPPP_RESTRICT q1, ::mp_limb_t *MPPP_RESTRICT q2)
+// Try to factor the 2-limb value n, which must be odd and not a prime, via Pollard-Brent. Returns a proper
+// factor or zero if the method failed within a fixed number of iterations.
+inline MPPP_UINT128 dlimb_pollard_brent(MPPP_UINT128 n)
 {
-    using dlimb_t = std::uint_least64_t;
-    const auto op1 = op11 + (dlimb_t(op12) << 32);
-    const auto op2 = op21 + (dlimb_t(op22) << 32);
-    const auto q = op1 / op2;
-    *q1 = static_cast<::mp_limb_t>(q & ::mp_limb_t(-1));
-    *q2 = static_cast<::mp_limb_t>(q >> 32);
+    using dlimb_t = MPPP_UINT128;
+    const dlimb_mont m(n);
+    dlimb_t d, c = 1;
+    while ((d = mont_pollard_brent(m, n, c, dlimb_t(1) << 22)) == n) {
+        ++c;
+    }
+    return d;
 }
 
 #endif
 
-// 2-limbs optimisation.
-template <std::size_t SSize>
-inline void static_div_impl(static_int<SSize> &q, static_int<SSize> &r, const static_int<SSize> &op1,
-                            const static_int<SSize> &op2, mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                            const std::integral_constant<int, 2> &)
+// Elliptic curve method, stage 1 only, using Montgomery curves with Suyama's parametrisation and the
+// Montgomery ladder on the X and Z projective coordinates. n must be odd, composite and not a perfect power.
+// On success, rop is set to a proper factor of n and true is returned.
+class ecm_stage1
 {
-    if (asize1 < 2 && asize2 < 2) {
-        // NOTE: testing indicates that it pays off to optimize the case in which the operands have
-        // fewer than 2 limbs. This a slightly modified version of the 1-limb division from above,
-        // without the need to mask as this function is called only if there are no nail bits.
-        const ::mp_limb_t q_ = op1.m_limbs[0] / op2.m_limbs[0], r_ = op1.m_limbs[0] % op2.m_limbs[0];
-        q._mp_size = sign1 * sign2 * (q_ != 0u);
-        q.m_limbs[0] = q_;
-        q.m_limbs[1] = 0u;
-        r._mp_size = sign1 * (r_ != 0u);
-        r.m_limbs[0] = r_;
-        r.m_limbs[1] = 0u;
-        return;
+public:
+    explicit ecm_stage1(const ::mpz_t n) : m_n(n) {}
+    bool run(::mpz_t rop, unsigned long sigma, unsigned long B1)
+    {
+        // Curve and starting point:
+        // u = sigma**2 - 5, v = 4 * sigma, x0 = u**3, z0 = v**3,
+        // (A + 2) / 4 = (v - u)**3 * (3 * u + v) / (16 * u**3 * v).
+        auto &u = m_t[0].m_mpz, &v = m_t[1].m_mpz, &t = m_t[2].m_mpz, &t2 = m_t[3].m_mpz;
+        ::mpz_set_ui(&u, sigma);
+        ::mpz_mul_ui(&u, &u, sigma);
+        ::mpz_sub_ui(&u, &u, 5u);
+        ::mpz_set_ui(&v, sigma);
+        ::mpz_mul_ui(&v, &v, 4u);
+        ::mpz_powm_ui(&m_x.m_mpz, &u, 3u, m_n);
+        ::mpz_powm_ui(&m_z.m_mpz, &v, 3u, m_n);
+        ::mpz_sub(&t, &v, &u);
+        ::mpz_powm_ui(&t, &t, 3u, m_n);
+        ::mpz_mul_ui(&t2, &u, 3u);
+        ::mpz_add(&t2, &t2, &v);
+        ::mpz_mul(&t, &t, &t2);
+        ::mpz_mod(&t, &t, m_n);
+        ::mpz_mul_ui(&t2, &m_x.m_mpz, 16u);
+        ::mpz_mul(&t2, &t2, &v);
+        ::mpz_mod(&t2, &t2, m_n);
+        if (check_factor(rop, &t2)) {
+            // The denominator is not invertible and we found a factor.
+            return true;
+        }
+        if (!::mpz_invert(&t2, &t2, m_n)) {
+            return false;
+        }
+        ::mpz_mul(&m_a24.m_mpz, &t, &t2);
+        ::mpz_mod(&m_a24.m_mpz, &m_a24.m_mpz, m_n);
+        // Multiply the point by all the prime powers up to B1.
+        mpz_raii p;
+        ::mpz_set_ui(&p.m_mpz, 2u);
+        for (; mpz_cmp_ui(&p.m_mpz, B1) <= 0; ::mpz_nextprime(&p.m_mpz, &p.m_mpz)) {
+            const auto pi = ::mpz_get_ui(&p.m_mpz);
+            for (unsigned long q = pi; q <= B1 / pi; q *= pi) {
+                ladder(pi);
+            }
+            ladder(pi);
+        }
+        return check_factor(rop, &m_z.m_mpz);
+    }
+
+private:
+    bool check_factor(::mpz_t rop, const ::mpz_t z)
+    {
+        ::mpz_gcd(rop, z, m_n);
+        return mpz_cmp_ui(rop, 1u) != 0 && ::mpz_cmp(rop, m_n) != 0;
+    }
+    void mulmod(::mpz_t rop, const ::mpz_t a, const ::mpz_t b)
+    {
+        ::mpz_mul(rop, a, b);
+        ::mpz_mod(rop, rop, m_n);
+    }
+    // (x2, z2) = 2 * (x, z).
+    void dbl(::mpz_t x2, ::mpz_t z2, const ::mpz_t x, const ::mpz_t z)
+    {
+        auto &s = m_t[0].m_mpz, &d = m_t[1].m_mpz, &t = m_t[2].m_mpz;
+        ::mpz_add(&s, x, z);
+        mulmod(&s, &s, &s);
+        ::mpz_sub(&d, x, z);
+        mulmod(&d, &d, &d);
+        ::mpz_sub(&t, &s, &d);
+        mulmod(x2, &s, &d);
+        mulmod(z2, &m_a24.m_mpz, &t);
+        ::mpz_add(z2, z2, &d);
+        mulmod(z2, z2, &t);
+    }
+    // (x3, z3) = (x1, z1) + (x2, z2), given the difference (xd, zd).
+    void add(::mpz_t x3, ::mpz_t z3, const ::mpz_t x1, const ::mpz_t z1, const ::mpz_t x2, const ::mpz_t z2,
+             const ::mpz_t xd, const ::mpz_t zd)
+    {
+        auto &a = m_t[0].m_mpz, &b = m_t[1].m_mpz, &t = m_t[2].m_mpz;
+        ::mpz_sub(&a, x1, z1);
+        ::mpz_add(&t, x2, z2);
+        mulmod(&a, &a, &t);
+        ::mpz_add(&b, x1, z1);
+        ::mpz_sub(&t, x2, z2);
+        mulmod(&b, &b, &t);
+        ::mpz_add(&t, &a, &b);
+        mulmod(&t, &t, &t);
+        ::mpz_sub(&b, &a, &b);
+        mulmod(&b, &b, &b);
+        // NOTE: x3/z3 might overlap with x1/z1, which are not needed anymore at this point.
+        mulmod(x3, zd, &t);
+        mulmod(z3, xd, &b);
+    }
+    // Multiply the current point by k via the Montgomery ladder.
+    void ladder(unsigned long k)
+    {
+        auto &x0 = m_l[0].m_mpz, &z0 = m_l[1].m_mpz, &x1 = m_l[2].m_mpz, &z1 = m_l[3].m_mpz;
+        ::mpz_set(&x0, &m_x.m_mpz);
+        ::mpz_set(&z0, &m_z.m_mpz);
+        dbl(&x1, &z1, &x0, &z0);
+        unsigned nbits = 0;
+        for (auto tmp = k; tmp; tmp >>= 1) {
+            ++nbits;
+        }
+        for (auto i = static_cast<int>(nbits) - 2; i >= 0; --i) {
+            if ((k >> i) & 1u) {
+                add(&x0, &z0, &x0, &z0, &x1, &z1, &m_x.m_mpz, &m_z.m_mpz);
+                dbl(&x1, &z1, &x1, &z1);
+            } else {
+                add(&x1, &z1, &x0, &z0, &x1, &z1, &m_x.m_mpz, &m_z.m_mpz);
+                dbl(&x0, &z0, &x0, &z0);
+            }
+        }
+        ::mpz_swap(&m_x.m_mpz, &x0);
+        ::mpz_swap(&m_z.m_mpz, &z0);
     }
-    // Perform the division.
-    ::mp_limb_t q1, q2, r1, r2;
-    dlimb_div(op1.m_limbs[0], op1.m_limbs[1], op2.m_limbs[0], op2.m_limbs[1], &q1, &q2, &r1, &r2);
-    // Write out.
-    q._mp_size = sign1 * sign2 * (q2 ? 2 : (q1 ? 1 : 0));
-    q.m_limbs[0] = q1;
-    q.m_limbs[1] = q2;
-    r._mp_size = sign1 * (r2 ? 2 : (r1 ? 1 : 0));
-    r.m_limbs[0] = r1;
-    r.m_limbs[1] = r2;
-}
 
+    const mpz_struct_t *m_n;
+    mpz_raii m_x, m_z, m_a24;
+    std::array<mpz_raii, 4> m_t, m_l;
+};
+
+// Append the prime p to out, if not present already.
 template <std::size_t SSize>
-inline void static_div(static_int<SSize> &q, static_int<SSize> &r, const static_int<SSize> &op1,
-                       const static_int<SSize> &op2)
+inline void factor_add_prime(std::vector<integer<SSize>> &out, const integer<SSize> &p)
 {
-    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
-    int sign1 = asize1 != 0, sign2 = asize2 != 0;
-    if (asize1 < 0) {
-        asize1 = -asize1;
-        sign1 = -1;
-    }
-    if (asize2 < 0) {
-        asize2 = -asize2;
-        sign2 = -1;
-    }
-    static_div_impl(q, r, op1, op2, asize1, asize2, sign1, sign2, integer_static_div_algo<static_int<SSize>>{});
-    if (integer_static_div_algo<static_int<SSize>>::value == 0) {
-        q.zero_unused_limbs();
-        r.zero_unused_limbs();
+    if (std::find(out.begin(), out.end(), p) == out.end()) {
+        out.push_back(p);
     }
 }
 
-// Exact division.
-// mpn implementation.
+// Factor the positive value n, appending to out the distinct prime factors of n which are not in out already.
 template <std::size_t SSize>
-inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                                 mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                                 const std::integral_constant<int, 0> &)
+inline void factor_split(const integer<SSize> &n, std::vector<integer<SSize>> &out)
 {
-    if (asize1 == 0) {
-        // Special casing if the numerator is zero (the mpn functions do not work with zero operands).
-        q._mp_size = 0;
+    if (n == 1) {
         return;
     }
-#if __GNU_MP_VERSION > 6 || (__GNU_MP_VERSION == 6 && __GNU_MP_VERSION_MINOR >= 1)
-    // NOTE: mpn_divexact_1() is available since GMP 6.1.0.
-    if (asize2 == 1) {
-        // Optimisation in case the dividend has only 1 limb.
-        // NOTE: overlapping arguments are fine here.
-        ::mpn_divexact_1(q.m_limbs.data(), op1.m_limbs.data(), static_cast<::mp_size_t>(asize1), op2.m_limbs[0]);
-        // Complete the quotient: compute size and sign.
-        q._mp_size = asize1 - asize2 + 1;
-        while (q._mp_size && !(q.m_limbs[static_cast<std::size_t>(q._mp_size - 1)] & GMP_NUMB_MASK)) {
-            --q._mp_size;
-        }
-        if (sign1 != sign2) {
-            q._mp_size = -q._mp_size;
+    const auto nv = n.get_mpz_view();
+#if defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
+    using dlimb_t = MPPP_UINT128;
+    const auto v = nv.get();
+    if (v->_mp_size == 1) {
+        // Single-limb values are factored completely with native arithmetic.
+        std::vector<::mp_limb_t> tmp;
+        limb_factor(v->_mp_d[0], tmp);
+        for (auto f : tmp) {
+            factor_add_prime(out, integer<SSize>{f});
         }
         return;
     }
-#else
-    // Avoid compiler warnings for unused parameters.
-    (void)sign1;
-    (void)sign2;
-    (void)asize2;
 #endif
-    // General implementation (via the mpz function).
+    if (n.probab_prime_p()) {
+        factor_add_prime(out, n);
+        return;
+    }
     MPPP_MAYBE_TLS mpz_raii tmp;
-    const auto v1 = op1.get_mpz_view();
-    const auto v2 = op2.get_mpz_view();
-    ::mpz_divexact(&tmp.m_mpz, &v1, &v2);
-    // Copy over from the tmp struct into q.
-    q._mp_size = tmp.m_mpz._mp_size;
-    copy_limbs_no(tmp.m_mpz._mp_d, tmp.m_mpz._mp_d + (q._mp_size >= 0 ? q._mp_size : -q._mp_size), q.m_limbs.data());
+    if (::mpz_perfect_power_p(nv)) {
+        // Find the smallest exponent k such that n is a k-th power, and factor the root.
+        for (unsigned long k = 2;; ++k) {
+            if (::mpz_root(&tmp.m_mpz, nv, k)) {
+                factor_split(integer<SSize>{&tmp.m_mpz}, out);
+                return;
+            }
+        }
+    }
+    integer<SSize> d;
+#if defined(MPPP_UINT128) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
+    if (v->_mp_size == 2) {
+        const auto dd = dlimb_pollard_brent((dlimb_t(v->_mp_d[1]) << 64) | v->_mp_d[0]);
+        if (dd) {
+            d = static_cast<::mp_limb_t>(dd >> 64);
+            d <<= 64;
+            d += static_cast<::mp_limb_t>(dd);
+        }
+    }
+#endif
+    if (d.is_zero()) {
+        ecm_stage1 ecm(nv);
+        // Run curves with increasing values of B1, until a factor is found.
+        unsigned long B1 = 2000, sigma = 6;
+        for (unsigned i = 1u; !ecm.run(&tmp.m_mpz, sigma, B1); ++i, ++sigma) {
+            if (i % 16u == 0u) {
+                B1 = B1 * 5u / 2u;
+            }
+        }
+        d = &tmp.m_mpz;
+    }
+    factor_split(d, out);
+    factor_split(divexact(n, d), out);
 }
-
-// 1-limb optimisation.
-template <std::size_t SSize>
-inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                                 mpz_size_t, mpz_size_t, int sign1, int sign2, const std::integral_constant<int, 1> &)
-{
-    const ::mp_limb_t q_ = (op1.m_limbs[0] & GMP_NUMB_MASK) / (op2.m_limbs[0] & GMP_NUMB_MASK);
-    // Write q.
-    q._mp_size = sign1 * sign2 * (q_ != 0u);
-    q.m_limbs[0] = q_;
 }
 
-// 2-limbs optimisation.
+/// Integer factorisation.
+/**
+ * \rststar
+ * This function will return the prime factorisation of the absolute value of ``n``, as a vector of
+ * (prime, multiplicity) pairs sorted by increasing primes. The factorisation of 1 is an empty vector.
+ *
+ * The factors are found via trial division, followed, for values fitting in a single limb, by
+ * Pollard's rho method with Brent's cycle detection and Shanks' square forms factorisation (SQUFOF),
+ * using native Montgomery arithmetic. For 2-limb values, Pollard-Brent is run for a limited number of iterations,
+ * and larger values (or 2-limb values for which Pollard-Brent failed) are attacked with the first stage of the
+ * elliptic curve method (ECM). The native implementations are available on 64-bit architectures supporting 128-bit
+ * integers, otherwise ECM is used for all the values which survive trial division.
+ *
+ * Note that no specialised method is employed for values having two or more large prime factors: the running
+ * time grows quickly with the size of the second largest prime factor.
+ * \endrststar
+ *
+ * @param n the integer to be factored.
+ *
+ * @return the prime factorisation of \p n.
+ *
+ * @throws std::invalid_argument if \p n is zero.
+ * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+ */
 template <std::size_t SSize>
-inline void static_divexact_impl(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2,
-                                 mpz_size_t asize1, mpz_size_t asize2, int sign1, int sign2,
-                                 const std::integral_constant<int, 2> &)
-{
-    if (asize1 < 2 && asize2 < 2) {
-        // 1-limb optimisation.
-        const ::mp_limb_t q_ = op1.m_limbs[0] / op2.m_limbs[0];
-        q._mp_size = sign1 * sign2 * (q_ != 0u);
-        q.m_limbs[0] = q_;
-        q.m_limbs[1] = 0u;
-        return;
+inline std::vector<std::pair<integer<SSize>, unsigned long>> factor(const integer<SSize> &n)
+{
+    if (mppp_unlikely(n.is_zero())) {
+        throw std::invalid_argument("Cannot factor zero");
+    }
+    std::vector<std::pair<integer<SSize>, unsigned long>> retval;
+    auto m = abs(n);
+    // Factors of 2.
+    const auto twos = ::mpz_scan1(m.get_mpz_view(), 0);
+    if (twos) {
+        retval.emplace_back(2, static_cast<unsigned long>(twos));
+        tdiv_q_2exp(m, m, twos);
+    }
+    // Trial division by odd values. NOTE: the composite values will not divide m, as their
+    // prime factors have been removed already.
+    for (unsigned long d = 3; d < factor_trial_bound; d += 2u) {
+        unsigned long mult = 0;
+        while (!::mpz_fdiv_ui(m.get_mpz_view(), d)) {
+            m /= d;
+            ++mult;
+        }
+        if (mult) {
+            retval.emplace_back(d, mult);
+        }
+        if (m < d * d) {
+            break;
+        }
     }
-    // General case.
-    ::mp_limb_t q1, q2;
-    dlimb_div(op1.m_limbs[0], op1.m_limbs[1], op2.m_limbs[0], op2.m_limbs[1], &q1, &q2);
-    q._mp_size = sign1 * sign2 * (q2 ? 2 : (q1 ? 1 : 0));
-    q.m_limbs[0] = q1;
-    q.m_limbs[1] = q2;
+    // Find the distinct prime factors of the remaining cofactor, and divide them out
+    // of it, counting their multiplicities. NOTE: all these primes are larger than
+    // the ones found via trial division, thus retval will end up sorted.
+    std::vector<integer<SSize>> primes;
+    factor_split(m, primes);
+    std::sort(primes.begin(), primes.end());
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    for (const auto &p : primes) {
+        const auto mult = ::mpz_remove(&tmp.m_mpz, m.get_mpz_view(), p.get_mpz_view());
+        assert(mult > 0u);
+        m = &tmp.m_mpz;
+        retval.emplace_back(p, static_cast<unsigned long>(mult));
+    }
+    assert(m == 1);
+    return retval;
 }
 
+/** @} */
+
+/** @defgroup integer_exponentiation integer_exponentiation
+ *  @{
+ */
+
+inline namespace detail
+{
+
+// Exponentiation by squaring on static integers. nbits is the bit size of base. It will return
+// false if the result does not fit in static storage, in which case rop is left untouched.
 template <std::size_t SSize>
-inline void static_divexact(static_int<SSize> &q, const static_int<SSize> &op1, const static_int<SSize> &op2)
+inline bool static_pow_ui(static_int<SSize> &rop, const static_int<SSize> &base, std::size_t nbits, unsigned long exp)
 {
-    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
-    int sign1 = asize1 != 0, sign2 = asize2 != 0;
-    if (asize1 < 0) {
-        asize1 = -asize1;
-        sign1 = -1;
-    }
-    if (asize2 < 0) {
-        asize2 = -asize2;
-        sign2 = -1;
+    // A base with nbits bits raised to exp has at least (nbits - 1) * exp + 1 bits. Give up
+    // immediately if we already know that the result will not fit.
+    if (nbits > 1u && exp > (SSize * unsigned(GMP_NUMB_BITS) - 1u) / (nbits - 1u)) {
+        return false;
     }
-    assert(asize1 == 0 || asize2 <= asize1);
-    // NOTE: use integer_static_div_algo for the algorithm selection.
-    static_divexact_impl(q, op1, op2, asize1, asize2, sign1, sign2, integer_static_div_algo<static_int<SSize>>{});
-    if (integer_static_div_algo<static_int<SSize>>::value == 0) {
-        q.zero_unused_limbs();
+    // NOTE: work on local copies, as rop might overlap with base.
+    static_int<SSize> b(base), r(1, ::mp_limb_t(1));
+    while (true) {
+        if (exp & 1ul) {
+            if (static_mul(r, r, b)) {
+                return false;
+            }
+        }
+        exp >>= 1;
+        if (!exp) {
+            break;
+        }
+        // NOTE: abs(b) >= 2 at this point, so if the squaring overflows
+        // then the final result would overflow as well.
+        if (static_mul(b, b, b)) {
+            return false;
+        }
     }
+    rop = r;
+    return true;
 }
 }
 
-/// Ternary truncated division.
+/// Ternary integer exponentiation.
 /**
- * This function will set \p q to the truncated quotient <tt>n / d</tt> and \p r to
- * <tt>n % d</tt>. The remainder \p r has the same sign as \p n. \p q and \p r must be two distinct objects.
+ * This function will set \p rop to <tt>base**exp</tt>. If \p base is stored in static storage
+ * and the result fits in static storage, the computation is performed without
+ * resorting to the GMP API.
  *
- * @param q the quotient.
- * @param r the remainder.
- * @param n the dividend.
- * @param d the divisor.
+ * @param rop the return value.
+ * @param base the base.
+ * @param exp the exponent.
  *
- * @throws std::invalid_argument if \p q and \p r are the same object.
- * @throws zero_division_error if \p d is zero.
+ * @return a reference to \p rop.
  */
 template <std::size_t SSize>
-inline void tdiv_qr(integer<SSize> &q, integer<SSize> &r, const integer<SSize> &n, const integer<SSize> &d)
+inline integer<SSize> &pow_ui(integer<SSize> &rop, const integer<SSize> &base, unsigned long exp)
 {
-    if (mppp_unlikely(&q == &r)) {
-        throw std::invalid_argument("When performing a division with remainder, the quotient 'q' and the "
-                                    "remainder 'r' must be distinct objects");
-    }
-    if (mppp_unlikely(d.sgn() == 0)) {
-        throw zero_division_error("Integer division by zero");
-    }
-    const bool sq = q.is_static(), sr = r.is_static(), s1 = n.is_static(), s2 = d.is_static();
-    if (mppp_likely(s1 && s2)) {
-        if (!sq) {
-            q.set_zero();
-        }
-        if (!sr) {
-            r.set_zero();
+    if (base.is_static()) {
+        static_int<SSize> r;
+        if (static_pow_ui(r, base._get_union().g_st(), base.nbits(), exp)) {
+            if (!rop.is_static()) {
+                rop.set_zero();
+            }
+            rop._get_union().g_st() = r;
+            return rop;
         }
-        static_div(q._get_union().g_st(), r._get_union().g_st(), n._get_union().g_st(), d._get_union().g_st());
-        // Division can never fail.
-        return;
-    }
-    if (sq) {
-        q._get_union().promote();
-    }
-    if (sr) {
-        r._get_union().promote();
     }
-    ::mpz_tdiv_qr(&q._get_union().g_dy(), &r._get_union().g_dy(), n.get_mpz_view(), d.get_mpz_view());
+    MPPP_MAYBE_TLS mpz_raii tmp;
+    ::mpz_pow_ui(&tmp.m_mpz, base.get_mpz_view(), exp);
+    return rop = &tmp.m_mpz;
 }
 
-/// Exact division (ternary version).
+/// Binary integer exponentiation.
 /**
- * This function will set \p rop to the quotient of \p n and \p d.
- *
- * \rststar
- * .. warning::
- *
- *    If ``d`` does not divide ``n`` exactly, the behaviour will be undefined.
- * \endrststar
- *
- * @param rop the return value.
- * @param n the dividend.
- * @param d the divisor.
+ * @param base the base.
+ * @param exp the exponent.
  *
- * @return a reference to \p rop.
+ * @return <tt>base**exp</tt>.
  */
 template <std::size_t SSize>
-inline integer<SSize> &divexact(integer<SSize> &rop, const integer<SSize> &n, const integer<SSize> &d)
+inline integer<SSize> pow_ui(const integer<SSize> &base, unsigned long exp)
 {
-    const bool sr = rop.is_static(), s1 = n.is_static(), s2 = d.is_static();
-    if (mppp_likely(s1 && s2)) {
-        if (!sr) {
-            rop.set_zero();
+    integer<SSize> retval;
+    pow_ui(retval, base, exp);
+    return retval;
+}
+
+inline namespace detail
+{
+
+// Various helpers for the implementation of pow().
+template <typename T, enable_if_t<std::is_integral<T>::value, int> = 0>
+inline bool integer_exp_is_odd(const T &exp)
+{
+    return (exp % T(2)) != T(0);
+}
+
+template <std::size_t SSize>
+inline bool integer_exp_is_odd(const integer<SSize> &exp)
+{
+    return exp.odd_p();
+}
+
+// Implementation of pow().
+// integer -- integral overload.
+template <typename T, std::size_t SSize,
+          enable_if_t<disjunction<std::is_same<T, integer<SSize>>, std::is_integral<T>>::value, int> = 0>
+inline integer<SSize> pow_impl(const integer<SSize> &base, const T &exp)
+{
+    integer<SSize> rop;
+    if (sgn(exp) >= 0) {
+        pow_ui(rop, base, integer_exp_to_ulong(exp));
+    } else if (mppp_unlikely(is_zero(base))) {
+        // 0**-n is a division by zero.
+        throw zero_division_error("Cannot raise zero to the negative power " + to_string(exp));
+    } else if (base.is_one()) {
+        // 1**n == 1.
+        rop = 1;
+    } else if (base.is_negative_one()) {
+        if (integer_exp_is_odd(exp)) {
+            // 1**(-2n-1) == -1.
+            rop = -1;
+        } else {
+            // 1**(-2n) == 1.
+            rop = 1;
         }
-        static_divexact(rop._get_union().g_st(), n._get_union().g_st(), d._get_union().g_st());
-        // Division can never fail.
-        return rop;
-    }
-    if (sr) {
-        rop._get_union().promote();
+    } else {
+        // m**-n == 1 / m**n == 0.
+        rop = 0;
     }
-    ::mpz_divexact(&rop._get_union().g_dy(), n.get_mpz_view(), d.get_mpz_view());
     return rop;
 }
 
-/// Exact division (binary version).
+// C++ integral -- integer overload.
+template <typename T, std::size_t SSize, enable_if_t<std::is_integral<T>::value, int> = 0>
+inline integer<SSize> pow_impl(const T &base, const integer<SSize> &exp)
+{
+    return pow_impl(integer<SSize>{base}, exp);
+}
+
+// integer -- FP overload.
+template <typename T, std::size_t SSize, enable_if_t<std::is_floating_point<T>::value, int> = 0>
+inline T pow_impl(const integer<SSize> &base, const T &exp)
+{
+    return std::pow(static_cast<T>(base), exp);
+}
+
+// FP -- integer overload.
+template <typename T, std::size_t SSize, enable_if_t<std::is_floating_point<T>::value, int> = 0>
+inline T pow_impl(const T &base, const integer<SSize> &exp)
+{
+    return std::pow(base, static_cast<T>(exp));
+}
+}
+
+/// Binary exponentiation.
 /**
  * \rststar
- * .. warning::
+ * This function is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerOpTypes`.
+ * The return type is determined as follows:
  *
- *    If ``d`` does not divide ``n`` exactly, the behaviour will be undefined.
+ * * if the non-:cpp:class:`~mppp::integer` argument is a floating-point type ``F``, then the
+ *   type of the result is ``F``; otherwise,
+ * * the type of the result is :cpp:class:`~mppp::integer`.
+ *
+ * This function will raise ``base`` to the power ``exp``, and return the result. If one of the arguments
+ * is a floating-point value, then the result will be computed via ``std::pow()`` and it will also be a
+ * floating-point value. Otherwise, the result will be an :cpp:class:`~mppp::integer`.
+ * In case of a negative integral exponent and integral base, the result will be zero unless
+ * the absolute value of ``base`` is 1.
  * \endrststar
  *
- * @param n the dividend.
- * @param d the divisor.
+ * @param base the base.
+ * @param exp the exponent.
  *
- * @return the quotient of \p n and \p d.
+ * @return <tt>base**exp</tt>.
+ *
+ * @throws std::overflow_error if \p base and \p exp are integrals and \p exp is non-negative and outside the range
+ * of <tt>unsigned long</tt>.
+ * @throws zero_division_error if \p base and \p exp are integrals and \p base is zero and \p exp is negative.
  */
-template <std::size_t SSize>
-inline integer<SSize> divexact(const integer<SSize> &n, const integer<SSize> &d)
+template <typename T, typename U>
+inline integer_common_t<T, U> pow(const T &base, const U &exp)
 {
-    integer<SSize> retval;
-    divexact(retval, n, d);
-    return retval;
+    return pow_impl(base, exp);
 }
 
-inline namespace detail
-{
-
-// Selection of the algorithm for static tdiv_q_2exp.
-template <typename SInt>
-using integer_static_tdiv_q_2exp_algo = std::integral_constant<int, (SInt::s_size > 2) ? 0 : SInt::s_size>;
+/** @} */
 
-// mpn implementation.
-template <std::size_t SSize>
-inline void static_tdiv_q_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s,
-                                    const std::integral_constant<int, 0> &)
-{
-    mpz_size_t asize = n._mp_size;
-    if (s == 0u || asize == 0) {
-        // If shift is zero, or the operand is zero, write n into rop and return.
-        rop = n;
-        return;
-    }
-    // Finish setting up asize and sign.
-    int sign = 1;
-    if (asize < 0) {
-        asize = -asize;
-        sign = -1;
-    }
-    // ls: number of entire limbs shifted.
-    // rs: effective shift that will be passed to the mpn function.
-    const auto ls = s / unsigned(GMP_NUMB_BITS), rs = s % unsigned(GMP_NUMB_BITS);
-    if (ls >= static_cast<std::size_t>(asize)) {
-        // If we shift by a number of entire limbs equal to or larger than the asize,
-        // the result will be zero.
-        rop._mp_size = 0;
-        return;
-    }
-    // The maximum new asize will be the old asize minus ls.
-    const mpz_size_t new_asize = asize - static_cast<mpz_size_t>(ls);
-    if (rs) {
-        // Perform the shift via the mpn function, if we are effectively shifting at least 1 bit.
-        // Overlapping is fine, as it is guaranteed that rop.m_limbs.data() <= n.m_limbs.data() + ls.
-        ::mpn_rshift(rop.m_limbs.data(), n.m_limbs.data() + ls, static_cast<::mp_size_t>(new_asize), unsigned(rs));
-    } else {
-        // Otherwise, just copy over (the mpn function requires the shift to be at least 1).
-        // NOTE: std::move requires that the destination iterator is not within the input range.
-        // Here we are sure that ls > 0 because we don't have a remainder, and the zero shift case
-        // was already handled above.
-        assert(ls);
-        std::move(n.m_limbs.begin() + ls, n.m_limbs.begin() + asize, rop.m_limbs.begin());
-    }
-    // Set the size. We need to check if the top limb is zero.
-    rop._mp_size = sign * (new_asize - ((rop.m_limbs[static_cast<std::size_t>(new_asize - 1)] & GMP_NUMB_MASK) == 0u));
-}
+/** @defgroup integer_roots integer_roots
+ *  @{
+ */
 
-// 1-limb optimisation.
-template <std::size_t SSize>
-inline void static_tdiv_q_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s,
-                                    const std::integral_constant<int, 1> &)
+inline namespace detail
 {
-    const ::mp_limb_t l = n.m_limbs[0] & GMP_NUMB_MASK;
-    if (s == 0u || l == 0u) {
-        rop = n;
-        return;
-    }
-    if (s >= unsigned(GMP_NUMB_BITS)) {
-        // We are shifting by the limb's bit size or greater, the result will be zero.
-        rop._mp_size = 0;
-        rop.m_limbs[0] = 0u;
-        return;
-    }
-    // Compute the result.
-    const auto res = l >> s;
-    // Size is the original one or zero.
-    rop._mp_size = static_cast<int>(res != 0u) * n._mp_size;
-    rop.m_limbs[0] = res;
-}
 
-// 2-limb optimisation.
 template <std::size_t SSize>
-inline void static_tdiv_q_2exp_impl(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s,
-                                    const std::integral_constant<int, 2> &)
+inline void sqrt_impl(integer<SSize> &rop, const integer<SSize> &n)
 {
-    mpz_size_t asize = n._mp_size;
-    if (s == 0u || asize == 0) {
-        rop = n;
-        return;
-    }
-    int sign = 1;
-    if (asize < 0) {
-        asize = -asize;
-        sign = -1;
+    if (mppp_unlikely(n._get_union().m_st._mp_size < 0)) {
+        throw std::domain_error("Cannot compute the square root of the negative number " + n.to_string());
     }
-    // If shift is too large, zero the result and return.
-    static_assert(unsigned(GMP_NUMB_BITS) <= std::numeric_limits<unsigned>::max() / 2u, "Overflow error.");
-    if (s >= 2u * unsigned(GMP_NUMB_BITS)) {
-        rop._mp_size = 0;
-        rop.m_limbs[0u] = 0u;
-        rop.m_limbs[1u] = 0u;
+    const bool sr = rop.is_static(), sn = n.is_static();
+    if (mppp_likely(sn)) {
+        if (!sr) {
+            rop.set_zero();
+        }
+        static_int<SSize> &rs = rop._get_union().g_st();
+        const static_int<SSize> &ns = n._get_union().g_st();
+        // NOTE: we know this is not negative, from the check above.
+        const mpz_size_t size = ns._mp_size;
+        if (!size) {
+            // Special casing for zero.
+            rs._mp_size = 0;
+            rs.zero_unused_limbs();
+            return;
+        }
+        // Fast path for 1 and 2 limbs, if available.
+        if (static_sqrtrem(rs, static_cast<static_int<SSize> *>(nullptr), ns)) {
+            return;
+        }
+        // In case of overlap we need to go through a tmp variable.
+        std::array<::mp_limb_t, SSize> tmp;
+        const bool overlap = (&rs == &ns);
+        auto out_ptr = overlap ? tmp.data() : rs.m_limbs.data();
+        ::mpn_sqrtrem(out_ptr, nullptr, ns.m_limbs.data(), static_cast<::mp_size_t>(size));
+        // Compute the size of the output (which is ceil(size / 2)).
+        const mpz_size_t new_size = size / 2 + size % 2;
+        assert(!new_size || (out_ptr[new_size - 1] & GMP_NUMB_MASK));
+        // Write out the result.
+        rs._mp_size = new_size;
+        if (overlap) {
+            copy_limbs_no(out_ptr, out_ptr + new_size, rs.m_limbs.data());
+        }
+        // Clear out unused limbs.
+        rs.zero_unused_limbs();
         return;
     }
-    if (s >= unsigned(GMP_NUMB_BITS)) {
-        // NOTE: here the effective shift < GMP_NUMB_BITS, otherwise it would have been caught
-        // in the check above.
-        const auto lo = (n.m_limbs[1u] & GMP_NUMB_MASK) >> (s - unsigned(GMP_NUMB_BITS));
-        // The size could be zero or +-1, depending
-        // on the new content of m_limbs[0] and the previous
-        // sign of _mp_size.
-        rop._mp_size = static_cast<int>(lo != 0u) * sign;
-        rop.m_limbs[0u] = lo;
-        rop.m_limbs[1u] = 0u;
-        return;
+    if (sr) {
+        rop.promote();
     }
-    assert(s > 0u && s < unsigned(GMP_NUMB_BITS));
-    // This represents the bits in hi that will be shifted down into lo.
-    // We move them up so we can add tmp to the new lo to account for them.
-    // NOTE: mask the final result to avoid spillover into potential nail bits.
-    const auto tmp = ((n.m_limbs[1u] & GMP_NUMB_MASK) << (unsigned(GMP_NUMB_BITS) - s)) & GMP_NUMB_MASK;
-    rop.m_limbs[0u] = ((n.m_limbs[0u] & GMP_NUMB_MASK) >> s) + tmp;
-    rop.m_limbs[1u] = (n.m_limbs[1u] & GMP_NUMB_MASK) >> s;
-    // The effective shift was less than 1 entire limb. The new asize must be the old one,
-    // or one less than that.
-    rop._mp_size = sign * (asize - ((rop.m_limbs[std::size_t(asize - 1)] & GMP_NUMB_MASK) == 0u));
+    ::mpz_sqrt(&rop._get_union().g_dy(), n.get_mpz_view());
+}
 }
 
+/// Integer square root (binary version).
+/**
+ * This method will set \p rop to the integer square root of \p n.
+ *
+ * @param rop the return value.
+ * @param n the integer whose integer square root will be computed.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::domain_error if \p n is negative.
+ */
 template <std::size_t SSize>
-inline void static_tdiv_q_2exp(static_int<SSize> &rop, const static_int<SSize> &n, ::mp_bitcnt_t s)
+inline integer<SSize> &sqrt(integer<SSize> &rop, const integer<SSize> &n)
 {
-    static_tdiv_q_2exp_impl(rop, n, s, integer_static_tdiv_q_2exp_algo<static_int<SSize>>{});
-    if (integer_static_tdiv_q_2exp_algo<static_int<SSize>>::value == 0) {
-        rop.zero_unused_limbs();
-    }
-}
+    sqrt_impl(rop, n);
+    return rop;
 }
 
-/// Ternary right shift.
+/// Integer square root (unary version).
 /**
- * This function will set \p rop to \p n divided by <tt>2**s</tt>. \p rop will be the truncated result of the
- * division.
- *
- * @param rop the return value.
- * @param n the dividend.
- * @param s the bit shift value.
+ * @param n the integer whose integer square root will be computed.
  *
- * @return a reference to \p rop.
+ * @return the integer square root of \p n.
+ *
+ * @throws std::domain_error if \p n is negative.
  */
 template <std::size_t SSize>
-inline integer<SSize> &tdiv_q_2exp(integer<SSize> &rop, const integer<SSize> &n, ::mp_bitcnt_t s)
+inline integer<SSize> sqrt(const integer<SSize> &n)
 {
-    const bool sn = n.is_static();
-    bool sr = rop.is_static();
-    if (mppp_likely(sn)) {
-        if (!sr) {
-            rop.set_zero();
-            sr = true;
-        }
-        static_tdiv_q_2exp(rop._get_union().g_st(), n._get_union().g_st(), s);
-        return rop;
-    }
-    if (sr) {
-        rop._get_union().promote();
-    }
-    ::mpz_tdiv_q_2exp(&rop._get_union().g_dy(), n.get_mpz_view(), s);
-    return rop;
+    integer<SSize> retval;
+    sqrt_impl(retval, n);
+    return retval;
 }
 
-/** @} */
-
-/** @defgroup integer_comparison integer_comparison
- *  @{
- */
-
 inline namespace detail
 {
 
-// Selection of the algorithm for static cmp.
-template <typename SInt>
-using integer_static_cmp_algo = std::integral_constant<int, SInt::s_size == 1 ? 1 : (SInt::s_size == 2 ? 2 : 0)>;
-
-// mpn implementation.
 template <std::size_t SSize>
-inline int static_cmp(const static_int<SSize> &n1, const static_int<SSize> &n2, const std::integral_constant<int, 0> &)
+inline void sqrtrem_impl(integer<SSize> &rop, integer<SSize> &rem, const integer<SSize> &n)
 {
-    if (n1._mp_size < n2._mp_size) {
-        return -1;
+    if (mppp_unlikely(&rop == &rem)) {
+        throw std::invalid_argument("When performing an integer square root with remainder, the result 'rop' and the "
+                                    "remainder 'rem' must be distinct objects");
     }
-    if (n2._mp_size < n1._mp_size) {
-        return 1;
+    if (mppp_unlikely(n.sgn() < 0)) {
+        throw std::domain_error("Cannot compute the square root of the negative number " + n.to_string());
     }
-    // The two sizes are equal, compare the absolute values.
-    const auto asize = n1._mp_size >= 0 ? n1._mp_size : -n1._mp_size;
-    if (asize == 0) {
-        // Both operands are zero.
-        // NOTE: we do this special casing in order to avoid calling mpn_cmp() on zero operands. It seems to
-        // work, but the official GMP docs say one is not supposed to call mpn functions on zero operands.
-        return 0;
+    if (n.is_static()) {
+        // NOTE: the result and the remainder are never larger than n, thus they can
+        // always be stored in static storage.
+        if (!rop.is_static()) {
+            rop.set_zero();
+        }
+        if (!rem.is_static()) {
+            rem.set_zero();
+        }
+        if (static_sqrtrem(rop._get_union().g_st(), &rem._get_union().g_st(), n._get_union().g_st())) {
+            return;
+        }
     }
-    const int cmp_abs = ::mpn_cmp(n1.m_limbs.data(), n2.m_limbs.data(), static_cast<::mp_size_t>(asize));
-    // If the values are non-negative, return the comparison of the absolute values, otherwise invert it.
-    return (n1._mp_size >= 0) ? cmp_abs : -cmp_abs;
+    MPPP_MAYBE_TLS mpz_raii s, r;
+    ::mpz_sqrtrem(&s.m_mpz, &r.m_mpz, n.get_mpz_view());
+    rop = &s.m_mpz;
+    rem = &r.m_mpz;
 }
 
-// 1-limb optimisation.
 template <std::size_t SSize>
-inline int static_cmp(const static_int<SSize> &n1, const static_int<SSize> &n2, const std::integral_constant<int, 1> &)
+inline void root_check(const integer<SSize> &n, unsigned long k)
 {
-    if (n1._mp_size < n2._mp_size) {
-        return -1;
-    }
-    if (n2._mp_size < n1._mp_size) {
-        return 1;
+    if (mppp_unlikely(!k)) {
+        throw std::domain_error("Cannot compute the integer root of degree zero of " + n.to_string());
     }
-    int cmp_abs = (n1.m_limbs[0u] & GMP_NUMB_MASK) > (n2.m_limbs[0u] & GMP_NUMB_MASK);
-    if (!cmp_abs) {
-        cmp_abs = -static_cast<int>((n1.m_limbs[0u] & GMP_NUMB_MASK) < (n2.m_limbs[0u] & GMP_NUMB_MASK));
+    if (mppp_unlikely(!(k % 2u) && n.sgn() < 0)) {
+        throw std::domain_error("Cannot compute the integer root of even degree " + std::to_string(k)
+                                + " of the negative number " + n.to_string());
     }
-    return (n1._mp_size >= 0) ? cmp_abs : -cmp_abs;
 }
 
-// 2-limb optimisation.
 template <std::size_t SSize>
-inline int static_cmp(const static_int<SSize> &n1, const static_int<SSize> &n2, const std::integral_constant<int, 2> &)
+inline bool root_impl(integer<SSize> &rop, const integer<SSize> &n, unsigned long k)
 {
-    if (n1._mp_size < n2._mp_size) {
-        return -1;
+    root_check(n, k);
+    if (n.is_static()) {
+        if (!rop.is_static()) {
+            rop.set_zero();
+        }
+        static_int<SSize> rem;
+        if (static_rootrem(rop._get_union().g_st(), &rem, n._get_union().g_st(), k)) {
+            return !rem._mp_size;
+        }
     }
-    if (n2._mp_size < n1._mp_size) {
-        return 1;
+    MPPP_MAYBE_TLS mpz_raii r;
+    const bool retval = ::mpz_root(&r.m_mpz, n.get_mpz_view(), k) != 0;
+    rop = &r.m_mpz;
+    return retval;
+}
+
+template <std::size_t SSize>
+inline void rootrem_impl(integer<SSize> &rop, integer<SSize> &rem, const integer<SSize> &n, unsigned long k)
+{
+    if (mppp_unlikely(&rop == &rem)) {
+        throw std::invalid_argument("When performing an integer root with remainder, the result 'rop' and the "
+                                    "remainder 'rem' must be distinct objects");
     }
-    auto asize = n1._mp_size >= 0 ? n1._mp_size : -n1._mp_size;
-    while (asize != 0) {
-        --asize;
-        if ((n1.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK) > (n2.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK)) {
-            return (n1._mp_size >= 0) ? 1 : -1;
+    root_check(n, k);
+    if (n.is_static()) {
+        if (!rop.is_static()) {
+            rop.set_zero();
         }
-        if ((n1.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK) < (n2.m_limbs[std::size_t(asize)] & GMP_NUMB_MASK)) {
-            return (n1._mp_size >= 0) ? -1 : 1;
+        if (!rem.is_static()) {
+            rem.set_zero();
+        }
+        if (static_rootrem(rop._get_union().g_st(), &rem._get_union().g_st(), n._get_union().g_st(), k)) {
+            return;
         }
     }
-    return 0;
-}
+    MPPP_MAYBE_TLS mpz_raii s, r;
+    ::mpz_rootrem(&s.m_mpz, &r.m_mpz, n.get_mpz_view(), k);
+    rop = &s.m_mpz;
+    rem = &r.m_mpz;
 }
 
-/// Comparison function for integer.
-/**
- * @param op1 first argument.
- * @param op2 second argument.
- *
- * @return \p 0 if <tt>op1 == op2</tt>, a negative value if <tt>op1 < op2</tt>, a positive value if
- * <tt>op1 > op2</tt>.
- */
 template <std::size_t SSize>
-inline int cmp(const integer<SSize> &op1, const integer<SSize> &op2)
+inline bool static_perfect_square_p(const static_int<SSize> &n)
 {
-    const bool s1 = op1.is_static(), s2 = op2.is_static();
-    if (mppp_likely(s1 && s2)) {
-        return static_cmp(op1._get_union().g_st(), op2._get_union().g_st(),
-                          integer_static_cmp_algo<static_int<SSize>>{});
+    const auto size = n._mp_size;
+    if (size <= 0) {
+        // Negative numbers are not squares, zero is.
+        return !size;
     }
-    return ::mpz_cmp(op1.get_mpz_view(), op2.get_mpz_view());
+    // Run the quadratic residue filters first.
+    if (!limb_square_filter(n.m_limbs[0], ::mpn_mod_1(n.m_limbs.data(), static_cast<::mp_size_t>(size), 21483u))) {
+        return false;
+    }
+    static_int<SSize> r, rem;
+    if (static_sqrtrem(r, &rem, n)) {
+        return !rem._mp_size;
+    }
+    return ::mpn_perfect_square_p(n.m_limbs.data(), static_cast<::mp_size_t>(size)) != 0;
+}
 }
 
-/// Sign function.
+/// Integer square root with remainder.
 /**
- * @param n the integer whose sign will be computed.
+ * This function will set \p rop to the integer square root of \p n, and \p rem to the remainder
+ * <tt>n - rop * rop</tt>.
  *
- * @return 0 if \p n is zero, 1 if \p n is positive, -1 if \p n is negative.
+ * @param rop the integer square root.
+ * @param rem the remainder.
+ * @param n the integer whose integer square root will be computed.
+ *
+ * @throws std::invalid_argument if \p rop and \p rem are the same object.
+ * @throws std::domain_error if \p n is negative.
  */
 template <std::size_t SSize>
-inline int sgn(const integer<SSize> &n)
+inline void sqrtrem(integer<SSize> &rop, integer<SSize> &rem, const integer<SSize> &n)
 {
-    return n.sgn();
+    sqrtrem_impl(rop, rem, n);
 }
 
-/// Test if integer is odd.
+/// Integer root (binary version).
 /**
- * @param n the argument.
+ * This function will set \p rop to the integer part of the <tt>k</tt>-th root of \p n, truncated towards zero.
  *
- * @return \p true if \p n is odd, \p false otherwise.
+ * @param rop the return value.
+ * @param n the integer whose root will be computed.
+ * @param k the degree of the root.
+ *
+ * @return \p true if the computation is exact, \p false otherwise.
+ *
+ * @throws std::domain_error if \p k is zero, or if \p k is even and \p n is negative.
  */
 template <std::size_t SSize>
-inline bool odd_p(const integer<SSize> &n)
+inline bool root(integer<SSize> &rop, const integer<SSize> &n, unsigned long k)
 {
-    return n.odd_p();
+    return root_impl(rop, n, k);
 }
 
-/// Test if integer is even.
+/// Integer root (unary version).
 /**
- * @param n the argument.
+ * @param n the integer whose root will be computed.
+ * @param k the degree of the root.
  *
- * @return \p true if \p n is even, \p false otherwise.
+ * @return the integer part of the <tt>k</tt>-th root of \p n, truncated towards zero.
+ *
+ * @throws std::domain_error if \p k is zero, or if \p k is even and \p n is negative.
  */
 template <std::size_t SSize>
-inline bool even_p(const integer<SSize> &n)
+inline integer<SSize> root(const integer<SSize> &n, unsigned long k)
 {
-    return n.even_p();
+    integer<SSize> retval;
+    root_impl(retval, n, k);
+    return retval;
 }
 
-/// Test if an integer is zero.
+/// Integer root with remainder.
 /**
- * @param n the integer to be tested.
+ * This function will set \p rop to the integer part of the <tt>k</tt>-th root of \p n, truncated towards zero,
+ * and \p rem to the remainder <tt>n - rop**k</tt>.
  *
- * @return \p true if \p n is zero, \p false otherwise.
+ * @param rop the integer root.
+ * @param rem the remainder.
+ * @param n the integer whose root will be computed.
+ * @param k the degree of the root.
+ *
+ * @throws std::invalid_argument if \p rop and \p rem are the same object.
+ * @throws std::domain_error if \p k is zero, or if \p k is even and \p n is negative.
  */
 template <std::size_t SSize>
-inline bool is_zero(const integer<SSize> &n)
+inline void rootrem(integer<SSize> &rop, integer<SSize> &rem, const integer<SSize> &n, unsigned long k)
 {
-    return n.is_zero();
+    rootrem_impl(rop, rem, n, k);
 }
 
-/// Test if an integer is equal to one.
+/// Perfect square test.
 /**
+ * \rststar
+ * For static values, quadratic residue filters are applied before computing the square root.
+ * \endrststar
+ *
  * @param n the integer to be tested.
  *
- * @return \p true if \p n is equal to 1, \p false otherwise.
+ * @return \p true if \p n is a perfect square (zero included), \p false otherwise.
  */
 template <std::size_t SSize>
-inline bool is_one(const integer<SSize> &n)
+inline bool perfect_square_p(const integer<SSize> &n)
 {
-    return n.is_one();
+    if (n.is_static()) {
+        return static_perfect_square_p(n._get_union().g_st());
+    }
+    return ::mpz_perfect_square_p(n.get_mpz_view()) != 0;
 }
 
-/// Test if an integer is equal to minus one.
+/// Perfect power test.
 /**
  * @param n the integer to be tested.
  *
- * @return \p true if \p n is equal to -1, \p false otherwise.
+ * @return \p true if \p n is a perfect power (that is, if there exist integers \f$ a \f$ and \f$ b > 1 \f$
+ * such that \f$ n = a^b \f$), \p false otherwise. 0 and 1 are considered perfect powers.
  */
 template <std::size_t SSize>
-inline bool is_negative_one(const integer<SSize> &n)
+inline bool perfect_power_p(const integer<SSize> &n)
 {
-    return n.is_negative_one();
+    if (n.is_static()) {
+        const auto ret = static_perfect_power_p(n._get_union().g_st());
+        if (ret >= 0) {
+            return ret != 0;
+        }
+    }
+    return ::mpz_perfect_power_p(n.get_mpz_view()) != 0;
 }
 
 /** @} */
 
-/** @defgroup integer_ntheory integer_ntheory
+/** @defgroup integer_io integer_io
  *  @{
  */
 
-inline namespace detail
-{
-
-template <std::size_t SSize>
-inline void static_gcd(static_int<SSize> &rop, const static_int<SSize> &op1, const static_int<SSize> &op2)
-{
-    mpz_size_t asize1 = op1._mp_size, asize2 = op2._mp_size;
-    if (asize1 < 0) {
-        asize1 = -asize1;
-    }
-    if (asize2 < 0) {
-        asize2 = -asize2;
-    }
-    // Handle zeroes.
-    if (!asize1) {
-        rop._mp_size = asize2;
-        rop.m_limbs = op2.m_limbs;
-        return;
-    }
-    if (!asize2) {
-        rop._mp_size = asize1;
-        rop.m_limbs = op1.m_limbs;
-        return;
-    }
-    // Special casing if an operand has asize 1.
-    if (asize1 == 1) {
-        rop._mp_size = 1;
-        rop.m_limbs[0] = ::mpn_gcd_1(op2.m_limbs.data(), static_cast<::mp_size_t>(asize2), op1.m_limbs[0]);
-        return;
-    }
-    if (asize2 == 1) {
-        rop._mp_size = 1;
-        rop.m_limbs[0] = ::mpn_gcd_1(op1.m_limbs.data(), static_cast<::mp_size_t>(asize1), op2.m_limbs[0]);
-        return;
-    }
-    // General case, via mpz.
-    // NOTE: there is an mpn_gcd() function, but it seems difficult to use. Apparently, and contrary to
-    // what stated in the latest documentation, the mpn function requires odd operands and bit size
-    // (not only limb size!) of the second operand not greater than the first. See for instance the old
-    // documentation:
-    // ftp://ftp.gnu.org/old-gnu/Manuals/gmp-3.1.1/html_chapter/gmp_9.html
-    // Indeed, compiling GMP in debug mode and then trying to use the mpn function without respecting the above
-    // results in assertion failures. For now let's keep it like this, the small operand cases are handled above
-    // (partially) via mpn_gcd_1(), and in the future we can also think about binary GCD for 1/2 limbs optimisation.
-    MPPP_MAYBE_TLS mpz_raii tmp;
-    const auto v1 = op1.get_mpz_view();
-    const auto v2 = op2.get_mpz_view();
-    ::mpz_gcd(&tmp.m_mpz, &v1, &v2);
-    // Copy over.
-    rop._mp_size = tmp.m_mpz._mp_size;
-    assert(rop._mp_size > 0);
-    copy_limbs_no(tmp.m_mpz._mp_d, tmp.m_mpz._mp_d + rop._mp_size, rop.m_limbs.data());
-}
-}
-
-/// GCD (ternary version).
+/// Output stream operator.
 /**
- * This function will set \p rop to the GCD of \p op1 and \p op2. The result is always positive.
- * If both operands are zero, zero is returned.
+ * \rststar
+ * This operator will print to the stream ``os`` the :cpp:class:`~mppp::integer` ``n`` in base 10. Internally it uses
+ * the :cpp:func:`mppp::integer::to_string()` method.
+ * \endrststar
  *
- * @param rop the return value.
- * @param op1 the first operand.
- * @param op2 the second operand.
+ * @param os the target stream.
+ * @param n the input integer.
  *
- * @return a reference to \p rop.
- */
-template <std::size_t SSize>
-inline integer<SSize> &gcd(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2)
-{
-    const bool sr = rop.is_static(), s1 = op1.is_static(), s2 = op2.is_static();
-    if (mppp_likely(s1 && s2)) {
-        if (!sr) {
-            rop.set_zero();
-        }
-        static_gcd(rop._get_union().g_st(), op1._get_union().g_st(), op2._get_union().g_st());
-        rop._get_union().g_st().zero_unused_limbs();
-        return rop;
-    }
-    if (sr) {
-        rop._get_union().promote();
-    }
-    ::mpz_gcd(&rop._get_union().g_dy(), op1.get_mpz_view(), op2.get_mpz_view());
-    return rop;
-}
-
-/// GCD (binary version).
-/**
- * @param op1 the first operand.
- * @param op2 the second operand.
+ * @return a reference to \p os.
  *
- * @return the GCD of \p op1 and \p op2.
+ * @throws unspecified any exception thrown by integer::to_string().
  */
 template <std::size_t SSize>
-inline integer<SSize> gcd(const integer<SSize> &op1, const integer<SSize> &op2)
+inline std::ostream &operator<<(std::ostream &os, const integer<SSize> &n)
 {
-    integer<SSize> retval;
-    gcd(retval, op1, op2);
-    return retval;
+    return os << n.to_string();
 }
 
-/// Factorial.
+/// Input stream operator.
 /**
- * This function will set \p rop to the factorial of \p n.
+ * \rststar
+ * This operator is equivalent to extracting a line from the stream and assigning it to ``n``.
+ * \endrststar
  *
- * @param rop the return value.
- * @param n the argument for the factorial.
+ * @param is the input stream.
+ * @param n the integer to which the string extracted from the stream will be assigned.
  *
- * @return a reference to \p rop.
+ * @return a reference to \p is.
  *
- * @throws std::invalid_argument if \p n is larger than an implementation-defined limit.
+ * @throws unspecified any exception thrown by \link mppp::integer integer\endlink's assignment operator from string.
  */
 template <std::size_t SSize>
-inline integer<SSize> &fac_ui(integer<SSize> &rop, unsigned long n)
+inline std::istream &operator>>(std::istream &is, integer<SSize> &n)
 {
-    // NOTE: we put a limit here because the GMP function just crashes and burns
-    // if n is too large, and n does not even need to be that large.
-    constexpr auto max_fac = 1000000ull;
-    if (mppp_unlikely(n > max_fac)) {
-        throw std::invalid_argument(
-            "The value " + std::to_string(n)
-            + " is too large to be used as input for the factorial function (the maximum allowed value is "
-            + std::to_string(max_fac) + ")");
-    }
-    // NOTE: let's get through a static temporary and then assign it to the rop,
-    // so that rop will be static/dynamic according to the size of tmp.
-    MPPP_MAYBE_TLS mpz_raii tmp;
-    ::mpz_fac_ui(&tmp.m_mpz, n);
-    return rop = &tmp.m_mpz;
+    MPPP_MAYBE_TLS std::string tmp_str;
+    std::getline(is, tmp_str);
+    n = tmp_str;
+    return is;
 }
 
-/// Binomial coefficient (ternary version).
+/** @} */
+
+/** @defgroup integer_other integer_other
+ *  @{
+ */
+
+/// Hash value.
 /**
- * This function will set \p rop to the binomial coefficient of \p n and \p k. Negative values of \p n are
- * supported.
+ * \rststar
+ * This function will return a hash value for ``n``. The hash value depends only on the value of ``n``
+ * (and *not* on its storage type).
  *
- * @param rop the return value.
- * @param n the top argument.
- * @param k the bottom argument.
+ * A specialisation of the standard ``std::hash`` functor is also provided, so that it is possible to use
+ * :cpp:class:`~mppp::integer` in standard unordered associative containers out of the box.
+ * \endrststar
  *
- * @return a reference to \p rop.
+ * @param n the integer whose hash value will be computed.
+ *
+ * @return a hash value for \p n.
  */
 template <std::size_t SSize>
-inline integer<SSize> &bin_ui(integer<SSize> &rop, const integer<SSize> &n, unsigned long k)
+inline std::size_t hash(const integer<SSize> &n)
 {
-    MPPP_MAYBE_TLS mpz_raii tmp;
-    ::mpz_bin_ui(&tmp.m_mpz, n.get_mpz_view(), k);
-    return rop = &tmp.m_mpz;
+    const mpz_size_t size = n._get_union().m_st._mp_size;
+    const std::size_t asize = size >= 0 ? static_cast<std::size_t>(size) : static_cast<std::size_t>(nint_abs(size));
+    const ::mp_limb_t *ptr
+        = n._get_union().is_static() ? n._get_union().g_st().m_limbs.data() : n._get_union().g_dy()._mp_d;
+    // Init the retval as the signed size.
+    auto retval = static_cast<std::size_t>(size);
+    // Combine the limbs.
+    for (std::size_t i = 0; i < asize; ++i) {
+        // The hash combiner. This is lifted directly from Boost. See also:
+        // http://www.open-std.org/jtc1/sc22/wg21/docs/papers/2014/n3876.pdf
+        retval ^= (ptr[i] & GMP_NUMB_MASK) + std::size_t(0x9e3779b9) + (retval << 6) + (retval >> 2);
+    }
+    return retval;
 }
 
-/// Binomial coefficient (binary version).
-/**
- * @param n the top argument.
- * @param k the bottom argument.
- *
- * @return the binomial coefficient of \p n and \p k.
+/** @} */
+
+/** @defgroup integer_operators integer_operators
+ *  @{
  */
+
+inline namespace detail
+{
+
+// Dispatching for the binary addition operator.
 template <std::size_t SSize>
-inline integer<SSize> bin_ui(const integer<SSize> &n, unsigned long k)
+inline integer<SSize> dispatch_binary_add(const integer<SSize> &op1, const integer<SSize> &op2)
 {
     integer<SSize> retval;
-    bin_ui(retval, n, k);
+    add(retval, op1, op2);
     return retval;
 }
 
-inline namespace detail
+template <std::size_t SSize, typename T, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_add(const integer<SSize> &op1, T n)
+{
+    integer<SSize> retval{n};
+    add(retval, retval, op1);
+    return retval;
+}
+
+template <std::size_t SSize, typename T, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_add(T n, const integer<SSize> &op2)
 {
+    return dispatch_binary_add(op2, n);
+}
 
-// These helpers are used here and in pow() as well.
-template <typename T, enable_if_t<std::is_integral<T>::value, int> = 0>
-inline unsigned long integer_exp_to_ulong(const T &exp)
+template <std::size_t SSize, typename T, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline T dispatch_binary_add(const integer<SSize> &op1, T x)
 {
-#if !defined(__INTEL_COMPILER)
-    assert(exp >= T(0));
-#endif
-    // NOTE: make_unsigned_t<T> is T if T is already unsigned.
-    if (mppp_unlikely(static_cast<make_unsigned_t<T>>(exp) > std::numeric_limits<unsigned long>::max())) {
-        throw std::overflow_error("Cannot convert the integral value " + std::to_string(exp)
-                                  + " to unsigned long: the value is too large.");
-    }
-    return static_cast<unsigned long>(exp);
+    return static_cast<T>(op1) + x;
+}
+
+template <std::size_t SSize, typename T, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline T dispatch_binary_add(T x, const integer<SSize> &op2)
+{
+    return dispatch_binary_add(op2, x);
 }
 
+// Dispatching for in-place add.
 template <std::size_t SSize>
-inline unsigned long integer_exp_to_ulong(const integer<SSize> &exp)
+inline void dispatch_in_place_add(integer<SSize> &retval, const integer<SSize> &n)
 {
-    try {
-        return static_cast<unsigned long>(exp);
-    } catch (const std::overflow_error &) {
-        // Rewrite the error message.
-        throw std::overflow_error("Cannot convert the integral value " + exp.to_string()
-                                  + " to unsigned long: the value is too large.");
-    }
+    add(retval, retval, n);
 }
 
-template <typename T, std::size_t SSize>
-inline integer<SSize> binomial_impl(const integer<SSize> &n, const T &k)
+template <std::size_t SSize, typename T, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline void dispatch_in_place_add(integer<SSize> &retval, const T &n)
 {
-    // NOTE: here we re-use some helper methods used in the implementation of pow().
-    if (sgn(k) >= 0) {
-        return bin_ui(n, integer_exp_to_ulong(k));
-    }
-    // This is the case k < 0, handled according to:
-    // http://arxiv.org/abs/1105.3689/
-    if (n.sgn() >= 0) {
-        // n >= 0, k < 0.
-        return integer<SSize>{};
-    }
-    // n < 0, k < 0.
-    if (k <= n) {
-        // The formula is: (-1)**(n-k) * binomial(-k-1,n-k).
-        // Cache n-k.
-        const integer<SSize> nmk{n - k};
-        integer<SSize> tmp{k};
-        ++tmp;
-        tmp.neg();
-        auto retval = bin_ui(tmp, integer_exp_to_ulong(nmk));
-        if (nmk.odd_p()) {
-            retval.neg();
-        }
-        return retval;
-    }
-    return integer<SSize>{};
+    add(retval, retval, integer<SSize>{n});
 }
 
-template <typename T, std::size_t SSize, enable_if_t<std::is_integral<T>::value, int> = 0>
-inline integer<SSize> binomial_impl(const T &n, const integer<SSize> &k)
+template <std::size_t SSize, typename T, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline void dispatch_in_place_add(integer<SSize> &retval, const T &x)
 {
-    return binomial_impl(integer<SSize>{n}, k);
+    retval = static_cast<T>(retval) + x;
+}
+
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_interoperable<T>::value, int> = 0>
+inline void dispatch_in_place_add(T &rop, const integer<SSize> &op)
+{
+    rop = static_cast<T>(rop + op);
 }
 }
 
-/// Generic binomial coefficient.
+/// Identity operator.
 /**
- * \rststar
- * This function is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerIntegralOpTypes`.
- * The return type is :cpp:class:`~mppp::integer`.
+ * @param n the integer that will be copied.
  *
- * This function will compute the binomial coefficient :math:`{{n}\choose{k}}`, supporting integral input values.
- * The implementation can handle positive and negative values for both the top and the bottom argument.
+ * @return a copy of \p n.
+ */
+template <std::size_t SSize>
+inline integer<SSize> operator+(const integer<SSize> &n)
+{
+    return n;
+}
+
+/// Identity operator for rvalues.
+/**
+ * @param n the integer that will be moved.
  *
- * .. seealso::
+ * @return \p n, moved.
+ */
+template <std::size_t SSize>
+inline integer<SSize> operator+(integer<SSize> &&n)
+{
+    return std::move(n);
+}
+
+/// Binary addition operator.
+/**
+ * \rststar
+ * This operator is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerOpTypes`.
+ * The return type is determined as follows:
  *
- *    http://arxiv.org/abs/1105.3689/
+ * * if the non-:cpp:class:`~mppp::integer` argument is a floating-point type ``F``, then the
+ *   type of the result is ``F``; otherwise,
+ * * the type of the result is :cpp:class:`~mppp::integer`.
  *
  * \endrststar
  *
- * @param n the top argument.
- * @param k the bottom argument.
- *
- * @return \f$ {{n}\choose{k}} \f$.
+ * @param op1 the first summand.
+ * @param op2 the second summand.
  *
- * @throws std::overflow_error if \p k is outside an implementation-defined range.
+ * @return <tt>op1 + op2</tt>.
  */
-#if defined(MPPP_HAVE_CONCEPTS)
 template <typename T, typename U>
-#if !defined(MPPP_DOXYGEN_INVOKED)
-requires IntegerIntegralOpTypes<T, U>
-#endif
-#else
-template <typename T, typename U, integer_integral_op_types_enabler<T, U> = 0>
-#endif
-    inline integer_common_t<T, U> binomial(const T &n, const U &k)
+inline integer_common_t<T, U> operator+(const T &op1, const U &op2)
 {
-    return binomial_impl(n, k);
+    return dispatch_binary_add(op1, op2);
 }
 
-inline namespace detail
-{
-
-template <std::size_t SSize>
-inline void nextprime_impl(integer<SSize> &rop, const integer<SSize> &n)
+/// Binary addition operator with rvalue first operand.
+/**
+ * \rststar
+ * This operator is enabled only if ``T`` is either :cpp:class:`~mppp::integer` with static size ``SSize``
+ * or an integral type. The result is computed directly into the storage of the rvalue operand, so that
+ * no new allocation is needed if the operand has dynamic storage.
+ * \endrststar
+ *
+ * @param op1 the first summand.
+ * @param op2 the second summand.
+ *
+ * @return <tt>op1 + op2</tt>.
+ */
+template <std::size_t SSize, typename T, integer_rvalue_op_enabler<T, SSize> = 0>
+inline integer<SSize> operator+(integer<SSize> &&op1, const T &op2)
 {
-    MPPP_MAYBE_TLS mpz_raii tmp;
-    ::mpz_nextprime(&tmp.m_mpz, n.get_mpz_view());
-    rop = &tmp.m_mpz;
-}
+    dispatch_in_place_add(op1, op2);
+    return std::move(op1);
 }
 
-/// Compute next prime number (binary version).
+/// Binary addition operator with rvalue second operand.
 /**
- * This function will set \p rop to the first prime number greater than \p n.
- * Note that for negative values of \p n this function always returns 2.
+ * \rststar
+ * This operator is enabled only if ``T`` is either :cpp:class:`~mppp::integer` with static size ``SSize``
+ * or an integral type. The result is computed directly into the storage of the rvalue operand, so that
+ * no new allocation is needed if the operand has dynamic storage.
+ * \endrststar
  *
- * @param rop the return value.
- * @param n the integer argument.
+ * @param op1 the first summand.
+ * @param op2 the second summand.
  *
- * @return a reference to \p rop.
+ * @return <tt>op1 + op2</tt>.
  */
-template <std::size_t SSize>
-inline integer<SSize> &nextprime(integer<SSize> &rop, const integer<SSize> &n)
+template <std::size_t SSize, typename T, integer_rvalue_op_enabler<T, SSize> = 0>
+inline integer<SSize> operator+(const T &op1, integer<SSize> &&op2)
 {
-    // NOTE: nextprime on negative numbers always returns 2.
-    nextprime_impl(rop, n);
-    return rop;
+    dispatch_in_place_add(op2, op1);
+    return std::move(op2);
 }
 
-/// Compute next prime number (unary version).
+/// Binary addition operator with rvalue operands.
 /**
- * @param n the integer argument.
+ * The result is computed into the storage of \p op1.
  *
- * @return the first prime number greater than \p n.
+ * @param op1 the first summand.
+ * @param op2 the second summand.
+ *
+ * @return <tt>op1 + op2</tt>.
  */
 template <std::size_t SSize>
-inline integer<SSize> nextprime(const integer<SSize> &n)
+inline integer<SSize> operator+(integer<SSize> &&op1, integer<SSize> &&op2)
 {
-    integer<SSize> retval;
-    nextprime_impl(retval, n);
-    return retval;
+    dispatch_in_place_add(op1, op2);
+    return std::move(op1);
 }
 
-/// Test primality.
+/// In-place addition operator.
 /**
- * \rststar
- * This is the free-function version of :cpp:func:`mppp::integer::probab_prime_p()`.
- * \endrststar
- *
- * @param n the integer whose primality will be tested.
- * @param reps the number of tests to run.
+ * @param rop the augend.
+ * @param op the addend.
  *
- * @return an integer indicating if \p n is a prime.
+ * @return a reference to \p rop.
  *
- * @throws unspecified any exception thrown by integer::probab_prime_p().
+ * @throws unspecified any exception thrown by the assignment of a floating-point value to \p rop or
+ * by the conversion operator of \link mppp::integer integer\endlink.
  */
-template <std::size_t SSize>
-inline int probab_prime_p(const integer<SSize> &n, int reps = 25)
+#if defined(MPPP_HAVE_CONCEPTS)
+template <typename T>
+inline T &operator+=(T &rop, const IntegerOpTypes<T> &op)
+#else
+template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
+inline T &operator+=(T &rop, const U &op)
+#endif
 {
-    return n.probab_prime_p(reps);
+    dispatch_in_place_add(rop, op);
+    return rop;
 }
 
-/** @} */
-
-/** @defgroup integer_exponentiation integer_exponentiation
- *  @{
- */
-
-/// Ternary integer exponentiation.
+/// Prefix increment.
 /**
- * This function will set \p rop to <tt>base**exp</tt>.
+ * This operator will increment \p n by one.
  *
- * @param rop the return value.
- * @param base the base.
- * @param exp the exponent.
+ * @param n the integer that will be increased.
  *
- * @return a reference to \p rop.
+ * @return a reference to \p n after the increment.
  */
 template <std::size_t SSize>
-inline integer<SSize> &pow_ui(integer<SSize> &rop, const integer<SSize> &base, unsigned long exp)
+inline integer<SSize> &operator++(integer<SSize> &n)
 {
-    MPPP_MAYBE_TLS mpz_raii tmp;
-    ::mpz_pow_ui(&tmp.m_mpz, base.get_mpz_view(), exp);
-    return rop = &tmp.m_mpz;
+    add_ui(n, n, 1u);
+    return n;
 }
 
-/// Binary integer exponentiation.
+/// Suffix increment.
 /**
- * @param base the base.
- * @param exp the exponent.
+ * This operator will increment \p n by one and return a copy of \p n as it was before the increment.
  *
- * @return <tt>base**exp</tt>.
+ * @param n the integer that will be increased.
+ *
+ * @return a copy of \p n before the increment.
  */
 template <std::size_t SSize>
-inline integer<SSize> pow_ui(const integer<SSize> &base, unsigned long exp)
+inline integer<SSize> operator++(integer<SSize> &n, int)
 {
-    integer<SSize> retval;
-    pow_ui(retval, base, exp);
+    auto retval(n);
+    ++n;
     return retval;
 }
 
 inline namespace detail
 {
 
-// Various helpers for the implementation of pow().
-template <typename T, enable_if_t<std::is_integral<T>::value, int> = 0>
-inline bool integer_exp_is_odd(const T &exp)
+// Dispatching for the binary subtraction operator.
+template <std::size_t SSize>
+inline integer<SSize> dispatch_binary_sub(const integer<SSize> &op1, const integer<SSize> &op2)
 {
-    return (exp % T(2)) != T(0);
+    integer<SSize> retval;
+    sub(retval, op1, op2);
+    return retval;
 }
 
-template <std::size_t SSize>
-inline bool integer_exp_is_odd(const integer<SSize> &exp)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_sub(const integer<SSize> &op1, T n)
 {
-    return exp.odd_p();
+    integer<SSize> retval{n};
+    sub(retval, retval, op1);
+    retval.neg();
+    return retval;
 }
 
-// Implementation of pow().
-// integer -- integral overload.
-template <typename T, std::size_t SSize,
-          enable_if_t<disjunction<std::is_same<T, integer<SSize>>, std::is_integral<T>>::value, int> = 0>
-inline integer<SSize> pow_impl(const integer<SSize> &base, const T &exp)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_sub(T n, const integer<SSize> &op2)
 {
-    integer<SSize> rop;
-    if (sgn(exp) >= 0) {
-        pow_ui(rop, base, integer_exp_to_ulong(exp));
-    } else if (mppp_unlikely(is_zero(base))) {
-        // 0**-n is a division by zero.
-        throw zero_division_error("Cannot raise zero to the negative power " + to_string(exp));
-    } else if (base.is_one()) {
-        // 1**n == 1.
-        rop = 1;
-    } else if (base.is_negative_one()) {
-        if (integer_exp_is_odd(exp)) {
-            // 1**(-2n-1) == -1.
-            rop = -1;
-        } else {
-            // 1**(-2n) == 1.
-            rop = 1;
-        }
-    } else {
-        // m**-n == 1 / m**n == 0.
-        rop = 0;
-    }
-    return rop;
+    auto retval = dispatch_binary_sub(op2, n);
+    retval.neg();
+    return retval;
 }
 
-// C++ integral -- integer overload.
-template <typename T, std::size_t SSize, enable_if_t<std::is_integral<T>::value, int> = 0>
-inline integer<SSize> pow_impl(const T &base, const integer<SSize> &exp)
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline T dispatch_binary_sub(const integer<SSize> &op1, T x)
 {
-    return pow_impl(integer<SSize>{base}, exp);
+    return static_cast<T>(op1) - x;
 }
 
-// integer -- FP overload.
-template <typename T, std::size_t SSize, enable_if_t<std::is_floating_point<T>::value, int> = 0>
-inline T pow_impl(const integer<SSize> &base, const T &exp)
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline T dispatch_binary_sub(T x, const integer<SSize> &op2)
 {
-    return std::pow(static_cast<T>(base), exp);
+    return -dispatch_binary_sub(op2, x);
 }
 
-// FP -- integer overload.
-template <typename T, std::size_t SSize, enable_if_t<std::is_floating_point<T>::value, int> = 0>
-inline T pow_impl(const T &base, const integer<SSize> &exp)
+// Dispatching for in-place sub.
+template <std::size_t SSize>
+inline void dispatch_in_place_sub(integer<SSize> &retval, const integer<SSize> &n)
 {
-    return std::pow(base, static_cast<T>(exp));
-}
+    sub(retval, retval, n);
 }
 
-/// Binary exponentiation.
-/**
- * \rststar
- * This function is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerOpTypes`.
- * The return type is determined as follows:
- *
- * * if the non-:cpp:class:`~mppp::integer` argument is a floating-point type ``F``, then the
- *   type of the result is ``F``; otherwise,
- * * the type of the result is :cpp:class:`~mppp::integer`.
- *
- * This function will raise ``base`` to the power ``exp``, and return the result. If one of the arguments
- * is a floating-point value, then the result will be computed via ``std::pow()`` and it will also be a
- * floating-point value. Otherwise, the result will be an :cpp:class:`~mppp::integer`.
- * In case of a negative integral exponent and integral base, the result will be zero unless
- * the absolute value of ``base`` is 1.
- * \endrststar
- *
- * @param base the base.
- * @param exp the exponent.
- *
- * @return <tt>base**exp</tt>.
- *
- * @throws std::overflow_error if \p base and \p exp are integrals and \p exp is non-negative and outside the range
- * of <tt>unsigned long</tt>.
- * @throws zero_division_error if \p base and \p exp are integrals and \p base is zero and \p exp is negative.
- */
-template <typename T, typename U>
-inline integer_common_t<T, U> pow(const T &base, const U &exp)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline void dispatch_in_place_sub(integer<SSize> &retval, const T &n)
 {
-    return pow_impl(base, exp);
+    sub(retval, retval, integer<SSize>{n});
 }
 
-/** @} */
-
-/** @defgroup integer_roots integer_roots
- *  @{
- */
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline void dispatch_in_place_sub(integer<SSize> &retval, const T &x)
+{
+    retval = static_cast<T>(retval) - x;
+}
 
-inline namespace detail
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_interoperable<T>::value, int> = 0>
+inline void dispatch_in_place_sub(T &rop, const integer<SSize> &op)
 {
+    rop = static_cast<T>(rop - op);
+}
 
+// Dispatching for in-place reverse sub (retval = n - retval). NOTE: sub() supports
+// aliasing, thus n can be retval itself.
 template <std::size_t SSize>
-inline void sqrt_impl(integer<SSize> &rop, const integer<SSize> &n)
+inline void dispatch_in_place_rsub(integer<SSize> &retval, const integer<SSize> &n)
 {
-    if (mppp_unlikely(n._get_union().m_st._mp_size < 0)) {
-        throw std::domain_error("Cannot compute the square root of the negative number " + n.to_string());
-    }
-    const bool sr = rop.is_static(), sn = n.is_static();
-    if (mppp_likely(sn)) {
-        if (!sr) {
-            rop.set_zero();
-        }
-        static_int<SSize> &rs = rop._get_union().g_st();
-        const static_int<SSize> &ns = n._get_union().g_st();
-        // NOTE: we know this is not negative, from the check above.
-        const mpz_size_t size = ns._mp_size;
-        if (!size) {
-            // Special casing for zero.
-            rs._mp_size = 0;
-            rs.zero_unused_limbs();
-            return;
-        }
-        // In case of overlap we need to go through a tmp variable.
-        std::array<::mp_limb_t, SSize> tmp;
-        const bool overlap = (&rs == &ns);
-        auto out_ptr = overlap ? tmp.data() : rs.m_limbs.data();
-        ::mpn_sqrtrem(out_ptr, nullptr, ns.m_limbs.data(), static_cast<::mp_size_t>(size));
-        // Compute the size of the output (which is ceil(size / 2)).
-        const mpz_size_t new_size = size / 2 + size % 2;
-        assert(!new_size || (out_ptr[new_size - 1] & GMP_NUMB_MASK));
-        // Write out the result.
-        rs._mp_size = new_size;
-        if (overlap) {
-            copy_limbs_no(out_ptr, out_ptr + new_size, rs.m_limbs.data());
-        }
-        // Clear out unused limbs.
-        rs.zero_unused_limbs();
-        return;
-    }
-    if (sr) {
-        rop.promote();
-    }
-    ::mpz_sqrt(&rop._get_union().g_dy(), n.get_mpz_view());
+    sub(retval, n, retval);
+}
+
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline void dispatch_in_place_rsub(integer<SSize> &retval, const T &n)
+{
+    sub(retval, integer<SSize>{n}, retval);
 }
 }
 
-/// Integer square root (binary version).
+/// Negated copy.
 /**
- * This method will set \p rop to the integer square root of \p n.
- *
- * @param rop the return value.
- * @param n the integer whose integer square root will be computed.
+ * @param n the integer that will be negated.
  *
- * @return a reference to \p rop.
+ * @return a negated copy of \p n.
+ */
+template <std::size_t SSize>
+integer<SSize> operator-(const integer<SSize> &n)
+{
+    auto retval(n);
+    retval.neg();
+    return retval;
+}
+
+/// Negated rvalue.
+/**
+ * @param n the integer that will be negated in place.
  *
- * @throws std::domain_error if \p n is negative.
+ * @return \p n, negated and moved.
  */
 template <std::size_t SSize>
-inline integer<SSize> &sqrt(integer<SSize> &rop, const integer<SSize> &n)
+inline integer<SSize> operator-(integer<SSize> &&n)
 {
-    sqrt_impl(rop, n);
-    return rop;
+    n.neg();
+    return std::move(n);
 }
 
-/// Integer square root (unary version).
+/// Binary subtraction operator.
 /**
- * @param n the integer whose integer square root will be computed.
+ * \rststar
+ * This operator is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerOpTypes`.
+ * The return type is determined as follows:
  *
- * @return the integer square root of \p n.
+ * * if the non-:cpp:class:`~mppp::integer` argument is a floating-point type ``F``, then the
+ *   type of the result is ``F``; otherwise,
+ * * the type of the result is :cpp:class:`~mppp::integer`.
  *
- * @throws std::domain_error if \p n is negative.
+ * \endrststar
+ *
+ * @param op1 the first operand.
+ * @param op2 the second operand.
+ *
+ * @return <tt>op1 - op2</tt>.
  */
-template <std::size_t SSize>
-inline integer<SSize> sqrt(const integer<SSize> &n)
+template <typename T, typename U>
+inline integer_common_t<T, U> operator-(const T &op1, const U &op2)
 {
-    integer<SSize> retval;
-    sqrt_impl(retval, n);
-    return retval;
+    return dispatch_binary_sub(op1, op2);
 }
 
-/** @} */
-
-/** @defgroup integer_io integer_io
- *  @{
- */
-
-/// Output stream operator.
+/// Binary subtraction operator with rvalue first operand.
 /**
  * \rststar
- * This operator will print to the stream ``os`` the :cpp:class:`~mppp::integer` ``n`` in base 10. Internally it uses
- * the :cpp:func:`mppp::integer::to_string()` method.
+ * This operator is enabled only if ``T`` is either :cpp:class:`~mppp::integer` with static size ``SSize``
+ * or an integral type. The result is computed directly into the storage of the rvalue operand, so that
+ * no new allocation is needed if the operand has dynamic storage.
  * \endrststar
  *
- * @param os the target stream.
- * @param n the input integer.
- *
- * @return a reference to \p os.
+ * @param op1 the first operand.
+ * @param op2 the second operand.
  *
- * @throws unspecified any exception thrown by integer::to_string().
+ * @return <tt>op1 - op2</tt>.
  */
-template <std::size_t SSize>
-inline std::ostream &operator<<(std::ostream &os, const integer<SSize> &n)
+template <std::size_t SSize, typename T, integer_rvalue_op_enabler<T, SSize> = 0>
+inline integer<SSize> operator-(integer<SSize> &&op1, const T &op2)
 {
-    return os << n.to_string();
+    dispatch_in_place_sub(op1, op2);
+    return std::move(op1);
 }
 
-/// Input stream operator.
+/// Binary subtraction operator with rvalue second operand.
 /**
  * \rststar
- * This operator is equivalent to extracting a line from the stream and assigning it to ``n``.
+ * This operator is enabled only if ``T`` is either :cpp:class:`~mppp::integer` with static size ``SSize``
+ * or an integral type. The result is computed directly into the storage of the rvalue operand, so that
+ * no new allocation is needed if the operand has dynamic storage.
  * \endrststar
  *
- * @param is the input stream.
- * @param n the integer to which the string extracted from the stream will be assigned.
+ * @param op1 the first operand.
+ * @param op2 the second operand.
  *
- * @return a reference to \p is.
+ * @return <tt>op1 - op2</tt>.
+ */
+template <std::size_t SSize, typename T, integer_rvalue_op_enabler<T, SSize> = 0>
+inline integer<SSize> operator-(const T &op1, integer<SSize> &&op2)
+{
+    dispatch_in_place_rsub(op2, op1);
+    return std::move(op2);
+}
+
+/// Binary subtraction operator with rvalue operands.
+/**
+ * The result is computed into the storage of \p op1.
  *
- * @throws unspecified any exception thrown by \link mppp::integer integer\endlink's assignment operator from string.
+ * @param op1 the first operand.
+ * @param op2 the second operand.
+ *
+ * @return <tt>op1 - op2</tt>.
  */
 template <std::size_t SSize>
-inline std::istream &operator>>(std::istream &is, integer<SSize> &n)
+inline integer<SSize> operator-(integer<SSize> &&op1, integer<SSize> &&op2)
 {
-    MPPP_MAYBE_TLS std::string tmp_str;
-    std::getline(is, tmp_str);
-    n = tmp_str;
-    return is;
+    dispatch_in_place_sub(op1, op2);
+    return std::move(op1);
 }
 
-/** @} */
-
-/** @defgroup integer_other integer_other
- *  @{
+/// In-place subtraction operator.
+/**
+ * @param rop the minuend.
+ * @param op the subtrahend.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws unspecified any exception thrown by the assignment of a floating-point value to \p rop or
+ * by the conversion operator of \link mppp::integer integer\endlink.
  */
+#if defined(MPPP_HAVE_CONCEPTS)
+template <typename T>
+inline T &operator-=(T &rop, const IntegerOpTypes<T> &op)
+#else
+template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
+inline T &operator-=(T &rop, const U &op)
+#endif
+{
+    dispatch_in_place_sub(rop, op);
+    return rop;
+}
 
-/// Hash value.
+/// Prefix decrement.
 /**
- * \rststar
- * This function will return a hash value for ``n``. The hash value depends only on the value of ``n``
- * (and *not* on its storage type).
- *
- * A specialisation of the standard ``std::hash`` functor is also provided, so that it is possible to use
- * :cpp:class:`~mppp::integer` in standard unordered associative containers out of the box.
- * \endrststar
+ * This operator will decrement \p n by one.
  *
- * @param n the integer whose hash value will be computed.
+ * @param n the integer that will be decreased.
  *
- * @return a hash value for \p n.
+ * @return a reference to \p n after the decrement.
  */
 template <std::size_t SSize>
-inline std::size_t hash(const integer<SSize> &n)
+inline integer<SSize> &operator--(integer<SSize> &n)
 {
-    const mpz_size_t size = n._get_union().m_st._mp_size;
-    const std::size_t asize = size >= 0 ? static_cast<std::size_t>(size) : static_cast<std::size_t>(nint_abs(size));
-    const ::mp_limb_t *ptr
-        = n._get_union().is_static() ? n._get_union().g_st().m_limbs.data() : n._get_union().g_dy()._mp_d;
-    // Init the retval as the signed size.
-    auto retval = static_cast<std::size_t>(size);
-    // Combine the limbs.
-    for (std::size_t i = 0; i < asize; ++i) {
-        // The hash combiner. This is lifted directly from Boost. See also:
-        // http://www.open-std.org/jtc1/sc22/wg21/docs/papers/2014/n3876.pdf
-        retval ^= (ptr[i] & GMP_NUMB_MASK) + std::size_t(0x9e3779b9) + (retval << 6) + (retval >> 2);
-    }
-    return retval;
+    sub_ui(n, n, 1u);
+    return n;
 }
 
-/** @} */
-
-/** @defgroup integer_operators integer_operators
- *  @{
+/// Suffix decrement.
+/**
+ * This operator will decrement \p n by one and return a copy of \p n as it was before the decrement.
+ *
+ * @param n the integer that will be decreased.
+ *
+ * @return a copy of \p n before the decrement.
  */
+template <std::size_t SSize>
+inline integer<SSize> operator--(integer<SSize> &n, int)
+{
+    auto retval(n);
+    --n;
+    return retval;
+}
 
 inline namespace detail
 {
 
-// Dispatching for the binary addition operator.
+// Dispatching for the binary multiplication operator.
 template <std::size_t SSize>
-inline integer<SSize> dispatch_binary_add(const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> dispatch_binary_mul(const integer<SSize> &op1, const integer<SSize> &op2)
 {
     integer<SSize> retval;
-    add(retval, op1, op2);
+    mul(retval, op1, op2);
     return retval;
 }
 
-template <std::size_t SSize, typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_add(const integer<SSize> &op1, T n)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_mul(const integer<SSize> &op1, T n)
 {
-    integer<SSize> retval{n};
-    add(retval, retval, op1);
+    // NOTE: with respect to addition, here we separate the retval
+    // from the operands. Having a separate destination is generally better
+    // for multiplication.
+    integer<SSize> retval;
+    mul(retval, op1, integer<SSize>{n});
     return retval;
 }
 
-template <std::size_t SSize, typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_add(T n, const integer<SSize> &op2)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_mul(T n, const integer<SSize> &op2)
 {
-    return dispatch_binary_add(op2, n);
+    return dispatch_binary_mul(op2, n);
 }
 
-template <std::size_t SSize, typename T, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline T dispatch_binary_add(const integer<SSize> &op1, T x)
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline T dispatch_binary_mul(const integer<SSize> &op1, T x)
 {
-    return static_cast<T>(op1) + x;
+    return static_cast<T>(op1) * x;
 }
 
-template <std::size_t SSize, typename T, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline T dispatch_binary_add(T x, const integer<SSize> &op2)
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline T dispatch_binary_mul(T x, const integer<SSize> &op2)
 {
-    return dispatch_binary_add(op2, x);
+    return dispatch_binary_mul(op2, x);
 }
 
-// Dispatching for in-place add.
+// Dispatching for in-place multiplication.
 template <std::size_t SSize>
-inline void dispatch_in_place_add(integer<SSize> &retval, const integer<SSize> &n)
+inline void dispatch_in_place_mul(integer<SSize> &retval, const integer<SSize> &n)
 {
-    add(retval, retval, n);
+    mul(retval, retval, n);
 }
 
-template <std::size_t SSize, typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline void dispatch_in_place_add(integer<SSize> &retval, const T &n)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline void dispatch_in_place_mul(integer<SSize> &retval, const T &n)
 {
-    add(retval, retval, integer<SSize>{n});
+    mul(retval, retval, integer<SSize>{n});
 }
 
-template <std::size_t SSize, typename T, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline void dispatch_in_place_add(integer<SSize> &retval, const T &x)
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline void dispatch_in_place_mul(integer<SSize> &retval, const T &x)
 {
-    retval = static_cast<T>(retval) + x;
+    retval = static_cast<T>(retval) * x;
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_cpp_interoperable<T>::value, int> = 0>
-inline void dispatch_in_place_add(T &rop, const integer<SSize> &op)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_interoperable<T>::value, int> = 0>
+inline void dispatch_in_place_mul(T &rop, const integer<SSize> &op)
 {
-    rop = static_cast<T>(rop + op);
-}
+    rop = static_cast<T>(rop * op);
 }
-
-/// Identity operator.
-/**
- * @param n the integer that will be copied.
- *
- * @return a copy of \p n.
- */
-template <std::size_t SSize>
-inline integer<SSize> operator+(const integer<SSize> &n)
-{
-    // NOTE: here potentially we could avoid a copy via either
-    // a universal reference or maybe passing by copy n and then
-    // moving in. Not sure how critical this is. Same in the negated
-    // copy operator.
-    return n;
 }
 
-/// Binary addition operator.
+/// Binary multiplication operator.
 /**
  * \rststar
  * This operator is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerOpTypes`.
@@ -5264,152 +7775,210 @@ inline integer<SSize> operator+(const integer<SSize> &n)
  *
  * \endrststar
  *
- * @param op1 the first summand.
- * @param op2 the second summand.
+ * @param op1 the first factor.
+ * @param op2 the second factor.
  *
- * @return <tt>op1 + op2</tt>.
+ * @return <tt>op1 * op2</tt>.
  */
 template <typename T, typename U>
-inline integer_common_t<T, U> operator+(const T &op1, const U &op2)
+inline integer_common_t<T, U> operator*(const T &op1, const U &op2)
 {
-    return dispatch_binary_add(op1, op2);
+    return dispatch_binary_mul(op1, op2);
 }
 
-/// In-place addition operator.
+/// Binary multiplication operator with rvalue first operand.
 /**
- * @param rop the augend.
- * @param op the addend.
+ * \rststar
+ * This operator is enabled only if ``T`` is either :cpp:class:`~mppp::integer` with static size ``SSize``
+ * or an integral type. The result is computed directly into the storage of the rvalue operand, so that
+ * no new allocation is needed if the operand has dynamic storage.
+ * \endrststar
  *
- * @return a reference to \p rop.
+ * @param op1 the first factor.
+ * @param op2 the second factor.
  *
- * @throws unspecified any exception thrown by the assignment of a floating-point value to \p rop or
- * by the conversion operator of \link mppp::integer integer\endlink.
+ * @return <tt>op1 * op2</tt>.
  */
-#if defined(MPPP_HAVE_CONCEPTS)
-template <typename T>
-inline T &operator+=(T &rop, const IntegerOpTypes<T> &op)
-#else
-template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline T &operator+=(T &rop, const U &op)
-#endif
+template <std::size_t SSize, typename T, integer_rvalue_op_enabler<T, SSize> = 0>
+inline integer<SSize> operator*(integer<SSize> &&op1, const T &op2)
 {
-    dispatch_in_place_add(rop, op);
-    return rop;
+    dispatch_in_place_mul(op1, op2);
+    return std::move(op1);
 }
 
-/// Prefix increment.
+/// Binary multiplication operator with rvalue second operand.
 /**
- * This operator will increment \p n by one.
+ * \rststar
+ * This operator is enabled only if ``T`` is either :cpp:class:`~mppp::integer` with static size ``SSize``
+ * or an integral type. The result is computed directly into the storage of the rvalue operand, so that
+ * no new allocation is needed if the operand has dynamic storage.
+ * \endrststar
  *
- * @param n the integer that will be increased.
+ * @param op1 the first factor.
+ * @param op2 the second factor.
+ *
+ * @return <tt>op1 * op2</tt>.
+ */
+template <std::size_t SSize, typename T, integer_rvalue_op_enabler<T, SSize> = 0>
+inline integer<SSize> operator*(const T &op1, integer<SSize> &&op2)
+{
+    dispatch_in_place_mul(op2, op1);
+    return std::move(op2);
+}
+
+/// Binary multiplication operator with rvalue operands.
+/**
+ * The result is computed into the storage of \p op1.
+ *
+ * @param op1 the first factor.
+ * @param op2 the second factor.
  *
- * @return a reference to \p n after the increment.
+ * @return <tt>op1 * op2</tt>.
  */
 template <std::size_t SSize>
-inline integer<SSize> &operator++(integer<SSize> &n)
+inline integer<SSize> operator*(integer<SSize> &&op1, integer<SSize> &&op2)
 {
-    add_ui(n, n, 1u);
-    return n;
+    dispatch_in_place_mul(op1, op2);
+    return std::move(op1);
 }
 
-/// Suffix increment.
+/// In-place multiplication operator.
 /**
- * This operator will increment \p n by one and return a copy of \p n as it was before the increment.
+ * @param rop the multiplicand.
+ * @param op the multiplicator.
  *
- * @param n the integer that will be increased.
+ * @return a reference to \p rop.
  *
- * @return a copy of \p n before the increment.
+ * @throws unspecified any exception thrown by the assignment of a floating-point value to \p rop or
+ * by the conversion operator of \link mppp::integer integer\endlink.
  */
-template <std::size_t SSize>
-inline integer<SSize> operator++(integer<SSize> &n, int)
+#if defined(MPPP_HAVE_CONCEPTS)
+template <typename T>
+inline T &operator*=(T &rop, const IntegerOpTypes<T> &op)
+#else
+template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
+inline T &operator*=(T &rop, const U &op)
+#endif
 {
-    auto retval(n);
-    ++n;
-    return retval;
+    dispatch_in_place_mul(rop, op);
+    return rop;
 }
 
 inline namespace detail
 {
 
-// Dispatching for the binary subtraction operator.
+// Dispatching for the binary division operator.
 template <std::size_t SSize>
-inline integer<SSize> dispatch_binary_sub(const integer<SSize> &op1, const integer<SSize> &op2)
+inline integer<SSize> dispatch_binary_div(const integer<SSize> &op1, const integer<SSize> &op2)
 {
-    integer<SSize> retval;
-    sub(retval, op1, op2);
+    integer<SSize> retval, r;
+    tdiv_qr(retval, r, op1, op2);
     return retval;
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_sub(const integer<SSize> &op1, T n)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_div(const integer<SSize> &op1, T n)
 {
-    integer<SSize> retval{n};
-    sub(retval, retval, op1);
-    retval.neg();
+    integer<SSize> retval, r;
+    tdiv_qr(retval, r, op1, integer<SSize>{n});
     return retval;
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_sub(T n, const integer<SSize> &op2)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_div(T n, const integer<SSize> &op2)
 {
-    auto retval = dispatch_binary_sub(op2, n);
-    retval.neg();
+    integer<SSize> retval, r;
+    tdiv_qr(retval, r, integer<SSize>{n}, op2);
     return retval;
 }
 
 template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline T dispatch_binary_sub(const integer<SSize> &op1, T x)
+inline T dispatch_binary_div(const integer<SSize> &op1, T x)
 {
-    return static_cast<T>(op1) - x;
+    return static_cast<T>(op1) / x;
 }
 
 template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline T dispatch_binary_sub(T x, const integer<SSize> &op2)
+inline T dispatch_binary_div(T x, const integer<SSize> &op2)
 {
-    return -dispatch_binary_sub(op2, x);
+    return x / static_cast<T>(op2);
 }
 
-// Dispatching for in-place sub.
+// Dispatching for in-place div.
 template <std::size_t SSize>
-inline void dispatch_in_place_sub(integer<SSize> &retval, const integer<SSize> &n)
+inline void dispatch_in_place_div(integer<SSize> &retval, const integer<SSize> &n)
 {
-    sub(retval, retval, n);
+    integer<SSize> r;
+    tdiv_qr(retval, r, retval, n);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline void dispatch_in_place_sub(integer<SSize> &retval, const T &n)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline void dispatch_in_place_div(integer<SSize> &retval, const T &n)
 {
-    sub(retval, retval, integer<SSize>{n});
+    integer<SSize> r;
+    tdiv_qr(retval, r, retval, integer<SSize>{n});
 }
 
 template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline void dispatch_in_place_sub(integer<SSize> &retval, const T &x)
+inline void dispatch_in_place_div(integer<SSize> &retval, const T &x)
 {
-    retval = static_cast<T>(retval) - x;
+    retval = static_cast<T>(retval) / x;
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_cpp_interoperable<T>::value, int> = 0>
-inline void dispatch_in_place_sub(T &rop, const integer<SSize> &op)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_interoperable<T>::value, int> = 0>
+inline void dispatch_in_place_div(T &rop, const integer<SSize> &op)
 {
-    rop = static_cast<T>(rop - op);
-}
+    rop = static_cast<T>(rop / op);
 }
 
-/// Negated copy.
-/**
- * @param n the integer that will be negated.
- *
- * @return a negated copy of \p n.
- */
+// Dispatching for the binary modulo operator.
 template <std::size_t SSize>
-integer<SSize> operator-(const integer<SSize> &n)
+inline integer<SSize> dispatch_binary_mod(const integer<SSize> &op1, const integer<SSize> &op2)
 {
-    auto retval(n);
-    retval.neg();
+    integer<SSize> q, retval;
+    tdiv_qr(q, retval, op1, op2);
     return retval;
 }
 
-/// Binary subtraction operator.
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_mod(const integer<SSize> &op1, T n)
+{
+    integer<SSize> q, retval;
+    tdiv_qr(q, retval, op1, integer<SSize>{n});
+    return retval;
+}
+
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline integer<SSize> dispatch_binary_mod(T n, const integer<SSize> &op2)
+{
+    integer<SSize> q, retval;
+    tdiv_qr(q, retval, integer<SSize>{n}, op2);
+    return retval;
+}
+
+// Dispatching for in-place mod.
+template <std::size_t SSize>
+inline void dispatch_in_place_mod(integer<SSize> &retval, const integer<SSize> &n)
+{
+    integer<SSize> q;
+    tdiv_qr(q, retval, retval, n);
+}
+
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline void dispatch_in_place_mod(integer<SSize> &retval, const T &n)
+{
+    integer<SSize> q;
+    tdiv_qr(q, retval, retval, integer<SSize>{n});
+}
+
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline void dispatch_in_place_mod(T &rop, const integer<SSize> &op)
+{
+    rop = static_cast<T>(rop % op);
+}
+}
+
+/// Binary division operator.
 /**
  * \rststar
  * This operator is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerOpTypes`.
@@ -5421,715 +7990,1127 @@ integer<SSize> operator-(const integer<SSize> &n)
  *
  * \endrststar
  *
- * @param op1 the first operand.
- * @param op2 the second operand.
+ * @param n the dividend.
+ * @param d the divisor.
  *
- * @return <tt>op1 - op2</tt>.
+ * @return <tt>n / d</tt>.
+ *
+ * @throws zero_division_error if \p d is zero and only integral types are involved in the division.
  */
 template <typename T, typename U>
-inline integer_common_t<T, U> operator-(const T &op1, const U &op2)
+inline integer_common_t<T, U> operator/(const T &n, const U &d)
 {
-    return dispatch_binary_sub(op1, op2);
+    return dispatch_binary_div(n, d);
 }
 
-/// In-place subtraction operator.
+/// Binary division operator with rvalue first operand.
 /**
- * @param rop the minuend.
- * @param op the subtrahend.
+ * \rststar
+ * This operator is enabled only if ``T`` is either :cpp:class:`~mppp::integer` with static size ``SSize``
+ * or an integral type. The result is computed directly into the storage of the rvalue operand, so that
+ * no new allocation is needed if the operand has dynamic storage.
+ * \endrststar
+ *
+ * @param n the dividend.
+ * @param d the divisor.
+ *
+ * @return <tt>n / d</tt>.
+ *
+ * @throws zero_division_error if \p d is zero.
+ */
+template <std::size_t SSize, typename T, integer_rvalue_op_enabler<T, SSize> = 0>
+inline integer<SSize> operator/(integer<SSize> &&n, const T &d)
+{
+    dispatch_in_place_div(n, d);
+    return std::move(n);
+}
+
+/// In-place division operator.
+/**
+ * @param rop the dividend.
+ * @param op the divisor.
  *
  * @return a reference to \p rop.
  *
+ * @throws zero_division_error if \p op is zero and only integral types are involved in the division.
  * @throws unspecified any exception thrown by the assignment of a floating-point value to \p rop or
  * by the conversion operator of \link mppp::integer integer\endlink.
  */
 #if defined(MPPP_HAVE_CONCEPTS)
 template <typename T>
-inline T &operator-=(T &rop, const IntegerOpTypes<T> &op)
+inline T &operator/=(T &rop, const IntegerOpTypes<T> &op)
 #else
 template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline T &operator-=(T &rop, const U &op)
+inline T &operator/=(T &rop, const U &op)
 #endif
 {
-    dispatch_in_place_sub(rop, op);
+    dispatch_in_place_div(rop, op);
     return rop;
 }
 
-/// Prefix decrement.
+/// Binary modulo operator.
 /**
- * This operator will decrement \p n by one.
+ * \rststar
+ * This operator is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerIntegralOpTypes`.
+ * The return type is :cpp:class:`~mppp::integer`.
+ * \endrststar
  *
- * @param n the integer that will be decreased.
+ * @param n the dividend.
+ * @param d the divisor.
  *
- * @return a reference to \p n after the decrement.
+ * @return <tt>n % d</tt>.
+ *
+ * @throws zero_division_error if \p d is zero.
  */
-template <std::size_t SSize>
-inline integer<SSize> &operator--(integer<SSize> &n)
+#if defined(MPPP_HAVE_CONCEPTS)
+template <typename T, typename U>
+#if !defined(MPPP_DOXYGEN_INVOKED)
+requires IntegerIntegralOpTypes<T, U>
+#endif
+#else
+template <typename T, typename U, integer_integral_op_types_enabler<T, U> = 0>
+#endif
+    inline integer_common_t<T, U> operator%(const T &n, const U &d)
 {
-    sub_ui(n, n, 1u);
-    return n;
+    return dispatch_binary_mod(n, d);
 }
 
-/// Suffix decrement.
+/// Binary modulo operator with rvalue first operand.
 /**
- * This operator will decrement \p n by one and return a copy of \p n as it was before the decrement.
+ * \rststar
+ * This operator is enabled only if ``T`` is either :cpp:class:`~mppp::integer` with static size ``SSize``
+ * or an integral type. The result is computed directly into the storage of the rvalue operand, so that
+ * no new allocation is needed if the operand has dynamic storage.
+ * \endrststar
  *
- * @param n the integer that will be decreased.
+ * @param n the dividend.
+ * @param d the divisor.
  *
- * @return a copy of \p n before the decrement.
+ * @return <tt>n % d</tt>.
+ *
+ * @throws zero_division_error if \p d is zero.
  */
-template <std::size_t SSize>
-inline integer<SSize> operator--(integer<SSize> &n, int)
-{
-    auto retval(n);
-    --n;
-    return retval;
-}
-
-inline namespace detail
-{
-
-// Dispatching for the binary multiplication operator.
-template <std::size_t SSize>
-inline integer<SSize> dispatch_binary_mul(const integer<SSize> &op1, const integer<SSize> &op2)
-{
-    integer<SSize> retval;
-    mul(retval, op1, op2);
-    return retval;
-}
-
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_mul(const integer<SSize> &op1, T n)
-{
-    // NOTE: with respect to addition, here we separate the retval
-    // from the operands. Having a separate destination is generally better
-    // for multiplication.
-    integer<SSize> retval;
-    mul(retval, op1, integer<SSize>{n});
-    return retval;
-}
-
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_mul(T n, const integer<SSize> &op2)
+template <std::size_t SSize, typename T, integer_rvalue_op_enabler<T, SSize> = 0>
+inline integer<SSize> operator%(integer<SSize> &&n, const T &d)
 {
-    return dispatch_binary_mul(op2, n);
+    dispatch_in_place_mod(n, d);
+    return std::move(n);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline T dispatch_binary_mul(const integer<SSize> &op1, T x)
+/// In-place modulo operator.
+/**
+ * @param rop the dividend.
+ * @param op the divisor.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws zero_division_error if \p op is zero.
+ * @throws unspecified any exception thrown by the conversion operator of \link mppp::integer integer\endlink.
+ */
+#if defined(MPPP_HAVE_CONCEPTS)
+template <typename T>
+inline T &operator%=(T &rop, const IntegerIntegralOpTypes<T> &op)
+#else
+template <typename T, typename U, integer_integral_op_types_enabler<T, U> = 0>
+inline T &operator%=(T &rop, const U &op)
+#endif
 {
-    return static_cast<T>(op1) * x;
+    dispatch_in_place_mod(rop, op);
+    return rop;
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline T dispatch_binary_mul(T x, const integer<SSize> &op2)
-{
-    return dispatch_binary_mul(op2, x);
-}
+#if !defined(MPPP_DOXYGEN_INVOKED)
 
-// Dispatching for in-place multiplication.
-template <std::size_t SSize>
-inline void dispatch_in_place_mul(integer<SSize> &retval, const integer<SSize> &n)
-{
-    mul(retval, retval, n);
-}
+template <typename T>
+#if defined(MPPP_HAVE_CONCEPTS)
+concept bool IntegerShiftType = CppInteroperable<T> &&std::is_integral<T>::value;
+#else
+using integer_shift_type_enabler = enable_if_t<conjunction<is_cpp_interoperable<T>, std::is_integral<T>>::value, int>;
+#endif
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline void dispatch_in_place_mul(integer<SSize> &retval, const T &n)
-{
-    mul(retval, retval, integer<SSize>{n});
-}
+#endif
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline void dispatch_in_place_mul(integer<SSize> &retval, const T &x)
+/// Binary left shift operator.
+/**
+ * @param n the multiplicand.
+ * @param s the bit shift value.
+ *
+ * @return \p n times <tt>2**s</tt>.
+ *
+ * @throws std::overflow_error if \p s is negative or larger than an implementation-defined value.
+ */
+#if defined(MPPP_HAVE_CONCEPTS)
+template <std::size_t SSize>
+inline integer<SSize> operator<<(const integer<SSize> &n, IntegerShiftType s)
+#else
+template <typename T, std::size_t SSize, integer_shift_type_enabler<T> = 0>
+inline integer<SSize> operator<<(const integer<SSize> &n, T s)
+#endif
 {
-    retval = static_cast<T>(retval) * x;
+    integer<SSize> retval;
+    mul_2exp(retval, n, safe_cast<::mp_bitcnt_t>(s));
+    return retval;
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_cpp_interoperable<T>::value, int> = 0>
-inline void dispatch_in_place_mul(T &rop, const integer<SSize> &op)
+/// In-place left shift operator.
+/**
+ * @param rop the multiplicand.
+ * @param s the bit shift value.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws std::overflow_error if \p s is negative or larger than an implementation-defined value.
+ */
+#if defined(MPPP_HAVE_CONCEPTS)
+template <std::size_t SSize>
+inline integer<SSize> &operator<<=(integer<SSize> &rop, IntegerShiftType s)
+#else
+template <typename T, std::size_t SSize, integer_shift_type_enabler<T> = 0>
+inline integer<SSize> &operator<<=(integer<SSize> &rop, T s)
+#endif
 {
-    rop = static_cast<T>(rop * op);
-}
+    mul_2exp(rop, rop, safe_cast<::mp_bitcnt_t>(s));
+    return rop;
 }
 
-/// Binary multiplication operator.
+/// Binary right shift operator.
 /**
- * \rststar
- * This operator is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerOpTypes`.
- * The return type is determined as follows:
- *
- * * if the non-:cpp:class:`~mppp::integer` argument is a floating-point type ``F``, then the
- *   type of the result is ``F``; otherwise,
- * * the type of the result is :cpp:class:`~mppp::integer`.
- *
- * \endrststar
+ * @param n the dividend.
+ * @param s the bit shift value.
  *
- * @param op1 the first factor.
- * @param op2 the second factor.
+ * @return \p n divided <tt>2**s</tt>.
  *
- * @return <tt>op1 * op2</tt>.
+ * @throws std::overflow_error if \p s is negative or larger than an implementation-defined value.
  */
-template <typename T, typename U>
-inline integer_common_t<T, U> operator*(const T &op1, const U &op2)
+#if defined(MPPP_HAVE_CONCEPTS)
+template <std::size_t SSize>
+inline integer<SSize> operator>>(const integer<SSize> &n, IntegerShiftType s)
+#else
+template <typename T, std::size_t SSize, integer_shift_type_enabler<T> = 0>
+inline integer<SSize> operator>>(const integer<SSize> &n, T s)
+#endif
 {
-    return dispatch_binary_mul(op1, op2);
+    integer<SSize> retval;
+    tdiv_q_2exp(retval, n, safe_cast<::mp_bitcnt_t>(s));
+    return retval;
 }
 
-/// In-place multiplication operator.
+/// In-place right shift operator.
 /**
- * @param rop the multiplicand.
- * @param op the multiplicator.
+ * @param rop the dividend.
+ * @param s the bit shift value.
  *
  * @return a reference to \p rop.
  *
- * @throws unspecified any exception thrown by the assignment of a floating-point value to \p rop or
- * by the conversion operator of \link mppp::integer integer\endlink.
+ * @throws std::overflow_error if \p s is negative or larger than an implementation-defined value.
  */
 #if defined(MPPP_HAVE_CONCEPTS)
-template <typename T>
-inline T &operator*=(T &rop, const IntegerOpTypes<T> &op)
+template <std::size_t SSize>
+inline integer<SSize> &operator>>=(integer<SSize> &rop, IntegerShiftType s)
 #else
-template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline T &operator*=(T &rop, const U &op)
+template <typename T, std::size_t SSize, integer_shift_type_enabler<T> = 0>
+inline integer<SSize> &operator>>=(integer<SSize> &rop, T s)
 #endif
 {
-    dispatch_in_place_mul(rop, op);
+    tdiv_q_2exp(rop, rop, safe_cast<::mp_bitcnt_t>(s));
     return rop;
 }
 
 inline namespace detail
 {
 
-// Dispatching for the binary division operator.
+// Equality operator.
+// NOTE: special implementation instead of using cmp, this should be faster.
 template <std::size_t SSize>
-inline integer<SSize> dispatch_binary_div(const integer<SSize> &op1, const integer<SSize> &op2)
+inline bool dispatch_equality(const integer<SSize> &a, const integer<SSize> &b)
 {
-    integer<SSize> retval, r;
-    tdiv_qr(retval, r, op1, op2);
-    return retval;
+    const mp_size_t size_a = a._get_union().m_st._mp_size, size_b = b._get_union().m_st._mp_size;
+    if (size_a != size_b) {
+        return false;
+    }
+    const std::size_t asize
+        = size_a >= 0 ? static_cast<std::size_t>(size_a) : static_cast<std::size_t>(nint_abs(size_a));
+    const ::mp_limb_t *ptr_a = a.is_static() ? a._get_union().g_st().m_limbs.data() : a._get_union().g_dy()._mp_d;
+    const ::mp_limb_t *ptr_b = b.is_static() ? b._get_union().g_st().m_limbs.data() : b._get_union().g_dy()._mp_d;
+    auto limb_cmp
+        = [](const ::mp_limb_t &l1, const ::mp_limb_t &l2) { return (l1 & GMP_NUMB_MASK) == (l2 & GMP_NUMB_MASK); };
+#if defined(_MSC_VER)
+    return std::equal(stdext::make_checked_array_iterator(ptr_a, asize),
+                      stdext::make_checked_array_iterator(ptr_a, asize, asize),
+                      stdext::make_checked_array_iterator(ptr_b, asize), limb_cmp);
+#else
+    return std::equal(ptr_a, ptr_a + asize, ptr_b, limb_cmp);
+#endif
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_div(const integer<SSize> &op1, T n)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline bool dispatch_equality(const integer<SSize> &a, T n)
 {
-    integer<SSize> retval, r;
-    tdiv_qr(retval, r, op1, integer<SSize>{n});
-    return retval;
+    return dispatch_equality(a, integer<SSize>{n});
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_div(T n, const integer<SSize> &op2)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline bool dispatch_equality(T n, const integer<SSize> &a)
 {
-    integer<SSize> retval, r;
-    tdiv_qr(retval, r, integer<SSize>{n}, op2);
-    return retval;
+    return dispatch_equality(a, n);
 }
 
 template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline T dispatch_binary_div(const integer<SSize> &op1, T x)
+inline bool dispatch_equality(const integer<SSize> &a, T x)
 {
-    return static_cast<T>(op1) / x;
+    return static_cast<T>(a) == x;
 }
 
 template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline T dispatch_binary_div(T x, const integer<SSize> &op2)
+inline bool dispatch_equality(T x, const integer<SSize> &a)
 {
-    return x / static_cast<T>(op2);
+    return dispatch_equality(a, x);
 }
 
-// Dispatching for in-place div.
+// Less-than operator.
 template <std::size_t SSize>
-inline void dispatch_in_place_div(integer<SSize> &retval, const integer<SSize> &n)
-{
-    integer<SSize> r;
-    tdiv_qr(retval, r, retval, n);
-}
-
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline void dispatch_in_place_div(integer<SSize> &retval, const T &n)
+inline bool dispatch_less_than(const integer<SSize> &a, const integer<SSize> &b)
 {
-    integer<SSize> r;
-    tdiv_qr(retval, r, retval, integer<SSize>{n});
+    return cmp(a, b) < 0;
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline void dispatch_in_place_div(integer<SSize> &retval, const T &x)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline bool dispatch_less_than(const integer<SSize> &a, T n)
 {
-    retval = static_cast<T>(retval) / x;
+    return dispatch_less_than(a, integer<SSize>{n});
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_cpp_interoperable<T>::value, int> = 0>
-inline void dispatch_in_place_div(T &rop, const integer<SSize> &op)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline bool dispatch_less_than(T n, const integer<SSize> &a)
 {
-    rop = static_cast<T>(rop / op);
+    return dispatch_greater_than(a, integer<SSize>{n});
 }
 
-// Dispatching for the binary modulo operator.
-template <std::size_t SSize>
-inline integer<SSize> dispatch_binary_mod(const integer<SSize> &op1, const integer<SSize> &op2)
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline bool dispatch_less_than(const integer<SSize> &a, T x)
 {
-    integer<SSize> q, retval;
-    tdiv_qr(q, retval, op1, op2);
-    return retval;
+    return static_cast<T>(a) < x;
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_mod(const integer<SSize> &op1, T n)
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline bool dispatch_less_than(T x, const integer<SSize> &a)
 {
-    integer<SSize> q, retval;
-    tdiv_qr(q, retval, op1, integer<SSize>{n});
-    return retval;
+    return dispatch_greater_than(a, x);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline integer<SSize> dispatch_binary_mod(T n, const integer<SSize> &op2)
+// Greater-than operator.
+template <std::size_t SSize>
+inline bool dispatch_greater_than(const integer<SSize> &a, const integer<SSize> &b)
 {
-    integer<SSize> q, retval;
-    tdiv_qr(q, retval, integer<SSize>{n}, op2);
-    return retval;
+    return cmp(a, b) > 0;
 }
 
-// Dispatching for in-place mod.
-template <std::size_t SSize>
-inline void dispatch_in_place_mod(integer<SSize> &retval, const integer<SSize> &n)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline bool dispatch_greater_than(const integer<SSize> &a, T n)
 {
-    integer<SSize> q;
-    tdiv_qr(q, retval, retval, n);
+    return dispatch_greater_than(a, integer<SSize>{n});
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline void dispatch_in_place_mod(integer<SSize> &retval, const T &n)
+template <typename T, std::size_t SSize, enable_if_t<is_integer_op_integral<T>::value, int> = 0>
+inline bool dispatch_greater_than(T n, const integer<SSize> &a)
 {
-    integer<SSize> q;
-    tdiv_qr(q, retval, retval, integer<SSize>{n});
+    return dispatch_less_than(a, integer<SSize>{n});
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline void dispatch_in_place_mod(T &rop, const integer<SSize> &op)
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline bool dispatch_greater_than(const integer<SSize> &a, T x)
 {
-    rop = static_cast<T>(rop % op);
-}
+    return static_cast<T>(a) > x;
 }
 
-/// Binary division operator.
-/**
- * \rststar
- * This operator is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerOpTypes`.
- * The return type is determined as follows:
- *
- * * if the non-:cpp:class:`~mppp::integer` argument is a floating-point type ``F``, then the
- *   type of the result is ``F``; otherwise,
- * * the type of the result is :cpp:class:`~mppp::integer`.
- *
- * \endrststar
- *
- * @param n the dividend.
- * @param d the divisor.
- *
- * @return <tt>n / d</tt>.
- *
- * @throws zero_division_error if \p d is zero and only integral types are involved in the division.
- */
-template <typename T, typename U>
-inline integer_common_t<T, U> operator/(const T &n, const U &d)
+template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
+inline bool dispatch_greater_than(T x, const integer<SSize> &a)
 {
-    return dispatch_binary_div(n, d);
+    return dispatch_less_than(a, x);
+}
 }
 
-/// In-place division operator.
+/// Equality operator.
 /**
- * @param rop the dividend.
- * @param op the divisor.
- *
- * @return a reference to \p rop.
+ * @param op1 first argument.
+ * @param op2 second argument.
  *
- * @throws zero_division_error if \p op is zero and only integral types are involved in the division.
- * @throws unspecified any exception thrown by the assignment of a floating-point value to \p rop or
- * by the conversion operator of \link mppp::integer integer\endlink.
+ * @return \p true if <tt>op1 == op2</tt>, \p false otherwise.
  */
 #if defined(MPPP_HAVE_CONCEPTS)
 template <typename T>
-inline T &operator/=(T &rop, const IntegerOpTypes<T> &op)
+inline bool operator==(const T &op1, const IntegerOpTypes<T> &op2)
 #else
 template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline T &operator/=(T &rop, const U &op)
+inline bool operator==(const T &op1, const U &op2)
 #endif
 {
-    dispatch_in_place_div(rop, op);
-    return rop;
+    return dispatch_equality(op1, op2);
 }
 
-/// Binary modulo operator.
+/// Inequality operator.
 /**
- * \rststar
- * This operator is enabled only if ``T`` and ``U`` satisfy :cpp:concept:`~mppp::IntegerIntegralOpTypes`.
- * The return type is :cpp:class:`~mppp::integer`.
- * \endrststar
- *
- * @param n the dividend.
- * @param d the divisor.
- *
- * @return <tt>n % d</tt>.
+ * @param op1 first argument.
+ * @param op2 second argument.
  *
- * @throws zero_division_error if \p d is zero.
+ * @return \p true if <tt>op1 != op2</tt>, \p false otherwise.
  */
 #if defined(MPPP_HAVE_CONCEPTS)
-template <typename T, typename U>
-#if !defined(MPPP_DOXYGEN_INVOKED)
-requires IntegerIntegralOpTypes<T, U>
-#endif
+template <typename T>
+inline bool operator!=(const T &op1, const IntegerOpTypes<T> &op2)
 #else
-template <typename T, typename U, integer_integral_op_types_enabler<T, U> = 0>
+template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
+inline bool operator!=(const T &op1, const U &op2)
 #endif
-    inline integer_common_t<T, U> operator%(const T &n, const U &d)
 {
-    return dispatch_binary_mod(n, d);
+    return !(op1 == op2);
 }
 
-/// In-place modulo operator.
+/// Less-than operator.
 /**
- * @param rop the dividend.
- * @param op the divisor.
- *
- * @return a reference to \p rop.
+ * @param op1 first argument.
+ * @param op2 second argument.
  *
- * @throws zero_division_error if \p op is zero.
- * @throws unspecified any exception thrown by the conversion operator of \link mppp::integer integer\endlink.
+ * @return \p true if <tt>op1 < op2</tt>, \p false otherwise.
  */
 #if defined(MPPP_HAVE_CONCEPTS)
 template <typename T>
-inline T &operator%=(T &rop, const IntegerIntegralOpTypes<T> &op)
+inline bool operator<(const T &op1, const IntegerOpTypes<T> &op2)
 #else
-template <typename T, typename U, integer_integral_op_types_enabler<T, U> = 0>
-inline T &operator%=(T &rop, const U &op)
+template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
+inline bool operator<(const T &op1, const U &op2)
 #endif
 {
-    dispatch_in_place_mod(rop, op);
-    return rop;
+    return dispatch_less_than(op1, op2);
 }
 
-#if !defined(MPPP_DOXYGEN_INVOKED)
-
-template <typename T>
-#if defined(MPPP_HAVE_CONCEPTS)
-concept bool IntegerShiftType = CppInteroperable<T> &&std::is_integral<T>::value;
-#else
-using integer_shift_type_enabler = enable_if_t<conjunction<is_cpp_interoperable<T>, std::is_integral<T>>::value, int>;
-#endif
-
-#endif
-
-/// Binary left shift operator.
+/// Less-than or equal operator.
 /**
- * @param n the multiplicand.
- * @param s the bit shift value.
- *
- * @return \p n times <tt>2**s</tt>.
+ * @param op1 first argument.
+ * @param op2 second argument.
  *
- * @throws std::overflow_error if \p s is negative or larger than an implementation-defined value.
+ * @return \p true if <tt>op1 <= op2</tt>, \p false otherwise.
  */
 #if defined(MPPP_HAVE_CONCEPTS)
-template <std::size_t SSize>
-inline integer<SSize> operator<<(const integer<SSize> &n, IntegerShiftType s)
+template <typename T>
+inline bool operator<=(const T &op1, const IntegerOpTypes<T> &op2)
 #else
-template <typename T, std::size_t SSize, integer_shift_type_enabler<T> = 0>
-inline integer<SSize> operator<<(const integer<SSize> &n, T s)
+template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
+inline bool operator<=(const T &op1, const U &op2)
 #endif
 {
-    integer<SSize> retval;
-    mul_2exp(retval, n, safe_cast<::mp_bitcnt_t>(s));
-    return retval;
+    return !(op1 > op2);
 }
 
-/// In-place left shift operator.
+/// Greater-than operator.
 /**
- * @param rop the multiplicand.
- * @param s the bit shift value.
- *
- * @return a reference to \p rop.
+ * @param op1 first argument.
+ * @param op2 second argument.
  *
- * @throws std::overflow_error if \p s is negative or larger than an implementation-defined value.
+ * @return \p true if <tt>op1 > op2</tt>, \p false otherwise.
  */
 #if defined(MPPP_HAVE_CONCEPTS)
-template <std::size_t SSize>
-inline integer<SSize> &operator<<=(integer<SSize> &rop, IntegerShiftType s)
+template <typename T>
+inline bool operator>(const T &op1, const IntegerOpTypes<T> &op2)
 #else
-template <typename T, std::size_t SSize, integer_shift_type_enabler<T> = 0>
-inline integer<SSize> &operator<<=(integer<SSize> &rop, T s)
+template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
+inline bool operator>(const T &op1, const U &op2)
 #endif
 {
-    mul_2exp(rop, rop, safe_cast<::mp_bitcnt_t>(s));
-    return rop;
+    return dispatch_greater_than(op1, op2);
 }
 
-/// Binary right shift operator.
+/// Greater-than or equal operator.
 /**
- * @param n the dividend.
- * @param s the bit shift value.
- *
- * @return \p n divided <tt>2**s</tt>.
+ * @param op1 first argument.
+ * @param op2 second argument.
  *
- * @throws std::overflow_error if \p s is negative or larger than an implementation-defined value.
+ * @return \p true if <tt>op1 >= op2</tt>, \p false otherwise.
  */
 #if defined(MPPP_HAVE_CONCEPTS)
-template <std::size_t SSize>
-inline integer<SSize> operator>>(const integer<SSize> &n, IntegerShiftType s)
+template <typename T>
+inline bool operator>=(const T &op1, const IntegerOpTypes<T> &op2)
 #else
-template <typename T, std::size_t SSize, integer_shift_type_enabler<T> = 0>
-inline integer<SSize> operator>>(const integer<SSize> &n, T s)
+template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
+inline bool operator>=(const T &op1, const U &op2)
 #endif
 {
-    integer<SSize> retval;
-    tdiv_q_2exp(retval, n, safe_cast<::mp_bitcnt_t>(s));
-    return retval;
+    return !(op1 < op2);
 }
 
-/// In-place right shift operator.
-/**
- * @param rop the dividend.
- * @param s the bit shift value.
- *
- * @return a reference to \p rop.
- *
- * @throws std::overflow_error if \p s is negative or larger than an implementation-defined value.
+/** @} */
+
+#if defined(MPPP_ENABLE_EXPRESSION_TEMPLATES)
+
+/** @defgroup integer_expressions integer_expressions
+ *  @{
  */
-#if defined(MPPP_HAVE_CONCEPTS)
+
+inline namespace detail
+{
+
+// Lazy product of two integers.
 template <std::size_t SSize>
-inline integer<SSize> &operator>>=(integer<SSize> &rop, IntegerShiftType s)
-#else
-template <typename T, std::size_t SSize, integer_shift_type_enabler<T> = 0>
-inline integer<SSize> &operator>>=(integer<SSize> &rop, T s)
-#endif
+class integer_mul_expr
+{
+public:
+    explicit integer_mul_expr(const integer<SSize> &a, const integer<SSize> &b) : m_a(a), m_b(b) {}
+    // Evaluation into rop. NOTE: mul() supports aliasing between rop and the operands.
+    void eval(integer<SSize> &rop) const
+    {
+        mul(rop, m_a, m_b);
+    }
+    operator integer<SSize>() const
+    {
+        integer<SSize> retval;
+        eval(retval);
+        return retval;
+    }
+    const integer<SSize> &m_a;
+    const integer<SSize> &m_b;
+};
+
+// Lazy evaluation of c + a1 * b1 + a2 * b2, where each term can be negated. A null
+// m_c or m_a2 signals that the corresponding term is absent.
+template <std::size_t SSize>
+class integer_fma_expr
+{
+    static void apply(integer<SSize> &rop, const integer<SSize> &a, const integer<SSize> &b, bool neg)
+    {
+        if (neg) {
+            submul(rop, a, b);
+        } else {
+            addmul(rop, a, b);
+        }
+    }
+
+public:
+    explicit integer_fma_expr(const integer<SSize> *c, bool c_neg, const integer_mul_expr<SSize> &p1, bool p1_neg)
+        : m_c(c), m_c_neg(c_neg), m_a1(&p1.m_a), m_b1(&p1.m_b), m_p1_neg(p1_neg), m_a2(nullptr), m_b2(nullptr),
+          m_p2_neg(false)
+    {
+    }
+    explicit integer_fma_expr(const integer_mul_expr<SSize> &p1, const integer_mul_expr<SSize> &p2, bool p2_neg)
+        : m_c(nullptr), m_c_neg(false), m_a1(&p1.m_a), m_b1(&p1.m_b), m_p1_neg(false), m_a2(&p2.m_a),
+          m_b2(&p2.m_b), m_p2_neg(p2_neg)
+    {
+    }
+    void eval(integer<SSize> &rop) const
+    {
+        if (&rop == m_a1 || &rop == m_b1 || &rop == m_a2 || &rop == m_b2) {
+            // rop is one of the factors, it cannot be overwritten before the
+            // products are computed: go through a temporary.
+            rop = static_cast<integer<SSize>>(*this);
+            return;
+        }
+        if (m_c) {
+            if (rop.is_static()) {
+                rop = *m_c;
+            } else {
+                // NOTE: set the dynamic rop in place, so that its storage is reused by
+                // addmul()/submul(). mpz_set() is fine if rop is the addend.
+                ::mpz_set(&rop._get_union().g_dy(), m_c->get_mpz_view());
+            }
+            if (m_c_neg) {
+                rop.neg();
+            }
+            apply(rop, *m_a1, *m_b1, m_p1_neg);
+        } else {
+            mul(rop, *m_a1, *m_b1);
+            if (m_p1_neg) {
+                rop.neg();
+            }
+        }
+        if (m_a2) {
+            apply(rop, *m_a2, *m_b2, m_p2_neg);
+        }
+    }
+    operator integer<SSize>() const
+    {
+        integer<SSize> retval;
+        eval(retval);
+        return retval;
+    }
+
+private:
+    const integer<SSize> *m_c;
+    bool m_c_neg;
+    const integer<SSize> *m_a1, *m_b1;
+    bool m_p1_neg;
+    const integer<SSize> *m_a2, *m_b2;
+    bool m_p2_neg;
+};
+
+template <typename T>
+struct is_integer_expr : std::false_type {
+};
+
+template <std::size_t SSize>
+struct is_integer_expr<integer_mul_expr<SSize>> : std::true_type {
+};
+
+template <std::size_t SSize>
+struct is_integer_expr<integer_fma_expr<SSize>> : std::true_type {
+};
+
+// Materialise an expression into an integer, pass through anything else.
+template <typename T>
+inline const T &integer_expr_value(const T &x)
+{
+    return x;
+}
+
+template <std::size_t SSize>
+inline integer<SSize> integer_expr_value(const integer_mul_expr<SSize> &e)
+{
+    return e;
+}
+
+template <std::size_t SSize>
+inline integer<SSize> integer_expr_value(const integer_fma_expr<SSize> &e)
+{
+    return e;
+}
+
+template <typename T, typename U>
+using integer_expr_enabler = enable_if_t<disjunction<is_integer_expr<T>, is_integer_expr<U>>::value, int>;
+
+// The fallback operators: the expressions which cannot be fused are materialised into
+// integers, and the regular operators are then invoked.
+template <typename T, integer_expr_enabler<T, T> = 0>
+inline auto operator+(const T &e) -> decltype(+integer_expr_value(e))
+{
+    return +integer_expr_value(e);
+}
+
+template <typename T, integer_expr_enabler<T, T> = 0>
+inline auto operator-(const T &e) -> decltype(-integer_expr_value(e))
+{
+    return -integer_expr_value(e);
+}
+
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator+(const T &x, const U &y) -> decltype(integer_expr_value(x) + integer_expr_value(y))
+{
+    return integer_expr_value(x) + integer_expr_value(y);
+}
+
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator-(const T &x, const U &y) -> decltype(integer_expr_value(x) - integer_expr_value(y))
+{
+    return integer_expr_value(x) - integer_expr_value(y);
+}
+
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator*(const T &x, const U &y) -> decltype(integer_expr_value(x) * integer_expr_value(y))
+{
+    return integer_expr_value(x) * integer_expr_value(y);
+}
+
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator/(const T &x, const U &y) -> decltype(integer_expr_value(x) / integer_expr_value(y))
+{
+    return integer_expr_value(x) / integer_expr_value(y);
+}
+
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator%(const T &x, const U &y) -> decltype(integer_expr_value(x) % integer_expr_value(y))
+{
+    return integer_expr_value(x) % integer_expr_value(y);
+}
+
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator<<(const T &x, const U &y) -> decltype(integer_expr_value(x) << integer_expr_value(y))
+{
+    return integer_expr_value(x) << integer_expr_value(y);
+}
+
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator>>(const T &x, const U &y) -> decltype(integer_expr_value(x) >> integer_expr_value(y))
+{
+    return integer_expr_value(x) >> integer_expr_value(y);
+}
+
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator==(const T &x, const U &y) -> decltype(integer_expr_value(x) == integer_expr_value(y))
+{
+    return integer_expr_value(x) == integer_expr_value(y);
+}
+
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator!=(const T &x, const U &y) -> decltype(integer_expr_value(x) != integer_expr_value(y))
 {
-    tdiv_q_2exp(rop, rop, safe_cast<::mp_bitcnt_t>(s));
-    return rop;
+    return integer_expr_value(x) != integer_expr_value(y);
 }
 
-inline namespace detail
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator<(const T &x, const U &y) -> decltype(integer_expr_value(x) < integer_expr_value(y))
 {
+    return integer_expr_value(x) < integer_expr_value(y);
+}
 
-// Equality operator.
-// NOTE: special implementation instead of using cmp, this should be faster.
-template <std::size_t SSize>
-inline bool dispatch_equality(const integer<SSize> &a, const integer<SSize> &b)
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator<=(const T &x, const U &y) -> decltype(integer_expr_value(x) <= integer_expr_value(y))
 {
-    const mp_size_t size_a = a._get_union().m_st._mp_size, size_b = b._get_union().m_st._mp_size;
-    if (size_a != size_b) {
-        return false;
-    }
-    const std::size_t asize
-        = size_a >= 0 ? static_cast<std::size_t>(size_a) : static_cast<std::size_t>(nint_abs(size_a));
-    const ::mp_limb_t *ptr_a = a.is_static() ? a._get_union().g_st().m_limbs.data() : a._get_union().g_dy()._mp_d;
-    const ::mp_limb_t *ptr_b = b.is_static() ? b._get_union().g_st().m_limbs.data() : b._get_union().g_dy()._mp_d;
-    auto limb_cmp
-        = [](const ::mp_limb_t &l1, const ::mp_limb_t &l2) { return (l1 & GMP_NUMB_MASK) == (l2 & GMP_NUMB_MASK); };
-#if defined(_MSC_VER)
-    return std::equal(stdext::make_checked_array_iterator(ptr_a, asize),
-                      stdext::make_checked_array_iterator(ptr_a, asize, asize),
-                      stdext::make_checked_array_iterator(ptr_b, asize), limb_cmp);
-#else
-    return std::equal(ptr_a, ptr_a + asize, ptr_b, limb_cmp);
-#endif
+    return integer_expr_value(x) <= integer_expr_value(y);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline bool dispatch_equality(const integer<SSize> &a, T n)
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator>(const T &x, const U &y) -> decltype(integer_expr_value(x) > integer_expr_value(y))
 {
-    return dispatch_equality(a, integer<SSize>{n});
+    return integer_expr_value(x) > integer_expr_value(y);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline bool dispatch_equality(T n, const integer<SSize> &a)
+template <typename T, typename U, integer_expr_enabler<T, U> = 0>
+inline auto operator>=(const T &x, const U &y) -> decltype(integer_expr_value(x) >= integer_expr_value(y))
 {
-    return dispatch_equality(a, n);
+    return integer_expr_value(x) >= integer_expr_value(y);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline bool dispatch_equality(const integer<SSize> &a, T x)
+template <typename T, typename U, enable_if_t<is_integer_expr<U>::value, int> = 0>
+inline auto operator+=(T &rop, const U &e) -> decltype(rop += integer_expr_value(e))
 {
-    return static_cast<T>(a) == x;
+    return rop += integer_expr_value(e);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline bool dispatch_equality(T x, const integer<SSize> &a)
+template <typename T, typename U, enable_if_t<is_integer_expr<U>::value, int> = 0>
+inline auto operator-=(T &rop, const U &e) -> decltype(rop -= integer_expr_value(e))
 {
-    return dispatch_equality(a, x);
+    return rop -= integer_expr_value(e);
 }
 
-// Less-than operator.
-template <std::size_t SSize>
-inline bool dispatch_less_than(const integer<SSize> &a, const integer<SSize> &b)
+template <typename T, typename U, enable_if_t<is_integer_expr<U>::value, int> = 0>
+inline auto operator*=(T &rop, const U &e) -> decltype(rop *= integer_expr_value(e))
 {
-    return cmp(a, b) < 0;
+    return rop *= integer_expr_value(e);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline bool dispatch_less_than(const integer<SSize> &a, T n)
+template <typename T, typename U, enable_if_t<is_integer_expr<U>::value, int> = 0>
+inline auto operator/=(T &rop, const U &e) -> decltype(rop /= integer_expr_value(e))
 {
-    return dispatch_less_than(a, integer<SSize>{n});
+    return rop /= integer_expr_value(e);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline bool dispatch_less_than(T n, const integer<SSize> &a)
+template <typename T, typename U, enable_if_t<is_integer_expr<U>::value, int> = 0>
+inline auto operator%=(T &rop, const U &e) -> decltype(rop %= integer_expr_value(e))
 {
-    return dispatch_greater_than(a, integer<SSize>{n});
+    return rop %= integer_expr_value(e);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline bool dispatch_less_than(const integer<SSize> &a, T x)
+template <typename T, enable_if_t<is_integer_expr<T>::value, int> = 0>
+inline std::ostream &operator<<(std::ostream &os, const T &e)
 {
-    return static_cast<T>(a) < x;
+    return os << integer_expr_value(e);
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline bool dispatch_less_than(T x, const integer<SSize> &a)
+// Materialise an expression into an integer, perfectly forward anything else.
+template <typename T, enable_if_t<negation<is_integer_expr<uncvref_t<T>>>::value, int> = 0>
+inline T &&integer_expr_fwd(T &&x)
 {
-    return dispatch_greater_than(a, x);
+    return std::forward<T>(x);
 }
 
-// Greater-than operator.
 template <std::size_t SSize>
-inline bool dispatch_greater_than(const integer<SSize> &a, const integer<SSize> &b)
+inline integer<SSize> integer_expr_fwd(const integer_mul_expr<SSize> &e)
 {
-    return cmp(a, b) > 0;
+    return e;
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline bool dispatch_greater_than(const integer<SSize> &a, T n)
+template <std::size_t SSize>
+inline integer<SSize> integer_expr_fwd(const integer_fma_expr<SSize> &e)
+{
+    return e;
+}
+
+// The functions of the integer API cannot deduce SSize from an expression. These overloads,
+// found via ADL, are enabled if at least one argument is an expression: the expressions are
+// materialised into integers, and the regular function is then invoked. Expressions passed in place
+// of return values are materialised into rvalues, and thus they will not match any overload.
+#define MPPP_INTEGER_EXPR_FUNCTION(name)                                                                               \
+    template <typename... Args, enable_if_t<disjunction<is_integer_expr<uncvref_t<Args>>...>::value, int> = 0>         \
+    inline auto name(Args &&... args)                                                                                  \
+        ->decltype(name(integer_expr_fwd(std::forward<Args>(args))...))                                                \
+    {                                                                                                                  \
+        return name(integer_expr_fwd(std::forward<Args>(args))...);                                                    \
+    }
+
+MPPP_INTEGER_EXPR_FUNCTION(get)
+MPPP_INTEGER_EXPR_FUNCTION(add)
+MPPP_INTEGER_EXPR_FUNCTION(sub)
+MPPP_INTEGER_EXPR_FUNCTION(add_ui)
+MPPP_INTEGER_EXPR_FUNCTION(sub_ui)
+MPPP_INTEGER_EXPR_FUNCTION(mul)
+MPPP_INTEGER_EXPR_FUNCTION(addmul)
+MPPP_INTEGER_EXPR_FUNCTION(submul)
+MPPP_INTEGER_EXPR_FUNCTION(mul_2exp)
+MPPP_INTEGER_EXPR_FUNCTION(neg)
+MPPP_INTEGER_EXPR_FUNCTION(abs)
+MPPP_INTEGER_EXPR_FUNCTION(tdiv_qr)
+MPPP_INTEGER_EXPR_FUNCTION(divexact)
+MPPP_INTEGER_EXPR_FUNCTION(tdiv_q_2exp)
+MPPP_INTEGER_EXPR_FUNCTION(cmp)
+MPPP_INTEGER_EXPR_FUNCTION(sgn)
+MPPP_INTEGER_EXPR_FUNCTION(odd_p)
+MPPP_INTEGER_EXPR_FUNCTION(even_p)
+MPPP_INTEGER_EXPR_FUNCTION(is_zero)
+MPPP_INTEGER_EXPR_FUNCTION(is_one)
+MPPP_INTEGER_EXPR_FUNCTION(is_negative_one)
+MPPP_INTEGER_EXPR_FUNCTION(gcd)
+MPPP_INTEGER_EXPR_FUNCTION(bin_ui)
+MPPP_INTEGER_EXPR_FUNCTION(bin_ui_range)
+MPPP_INTEGER_EXPR_FUNCTION(binomial)
+MPPP_INTEGER_EXPR_FUNCTION(nextprime)
+MPPP_INTEGER_EXPR_FUNCTION(probab_prime_p)
+MPPP_INTEGER_EXPR_FUNCTION(factor)
+MPPP_INTEGER_EXPR_FUNCTION(pow_ui)
+MPPP_INTEGER_EXPR_FUNCTION(pow)
+MPPP_INTEGER_EXPR_FUNCTION(sqrt)
+MPPP_INTEGER_EXPR_FUNCTION(sqrtrem)
+MPPP_INTEGER_EXPR_FUNCTION(root)
+MPPP_INTEGER_EXPR_FUNCTION(rootrem)
+MPPP_INTEGER_EXPR_FUNCTION(perfect_square_p)
+MPPP_INTEGER_EXPR_FUNCTION(perfect_power_p)
+MPPP_INTEGER_EXPR_FUNCTION(hash)
+
+#undef MPPP_INTEGER_EXPR_FUNCTION
+}
+
+/// Lazy multiplication operator.
+/**
+ * \rststar
+ * This operator is available only if the ``MPPP_ENABLE_EXPRESSION_TEMPLATES`` macro is defined. It returns an
+ * expression object storing references to ``op1`` and ``op2``, which is implicitly convertible to
+ * :cpp:class:`~mppp::integer`. The product is computed only when the expression is assigned or converted,
+ * and it can be fused with an addition or a subtraction (see the :ref:`expression templates <integer_expressions>`
+ * section).
+ * \endrststar
+ *
+ * @param op1 the first factor.
+ * @param op2 the second factor.
+ *
+ * @return an expression representing <tt>op1 * op2</tt>.
+ */
+template <std::size_t SSize>
+inline integer_mul_expr<SSize> operator*(const integer<SSize> &op1, const integer<SSize> &op2)
 {
-    return dispatch_greater_than(a, integer<SSize>{n});
+    return integer_mul_expr<SSize>{op1, op2};
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_integral<T>::value, int> = 0>
-inline bool dispatch_greater_than(T n, const integer<SSize> &a)
+/// Fused multiply-add expression.
+/**
+ * @param p a product expression.
+ * @param c the addend.
+ *
+ * @return an expression representing <tt>p + c</tt>.
+ */
+template <std::size_t SSize>
+inline integer_fma_expr<SSize> operator+(const integer_mul_expr<SSize> &p, const integer<SSize> &c)
 {
-    return dispatch_less_than(a, integer<SSize>{n});
+    return integer_fma_expr<SSize>{&c, false, p, false};
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline bool dispatch_greater_than(const integer<SSize> &a, T x)
+/// Fused multiply-add expression.
+/**
+ * @param c the addend.
+ * @param p a product expression.
+ *
+ * @return an expression representing <tt>c + p</tt>.
+ */
+template <std::size_t SSize>
+inline integer_fma_expr<SSize> operator+(const integer<SSize> &c, const integer_mul_expr<SSize> &p)
 {
-    return static_cast<T>(a) > x;
+    return integer_fma_expr<SSize>{&c, false, p, false};
 }
 
-template <typename T, std::size_t SSize, enable_if_t<is_supported_float<T>::value, int> = 0>
-inline bool dispatch_greater_than(T x, const integer<SSize> &a)
+/// Fused multiply-sub expression.
+/**
+ * @param p a product expression.
+ * @param c the subtrahend.
+ *
+ * @return an expression representing <tt>p - c</tt>.
+ */
+template <std::size_t SSize>
+inline integer_fma_expr<SSize> operator-(const integer_mul_expr<SSize> &p, const integer<SSize> &c)
 {
-    return dispatch_less_than(a, x);
-}
+    return integer_fma_expr<SSize>{&c, true, p, false};
 }
 
-/// Equality operator.
+/// Fused multiply-sub expression.
 /**
- * @param op1 first argument.
- * @param op2 second argument.
+ * @param c the minuend.
+ * @param p a product expression.
  *
- * @return \p true if <tt>op1 == op2</tt>, \p false otherwise.
+ * @return an expression representing <tt>c - p</tt>.
  */
-#if defined(MPPP_HAVE_CONCEPTS)
-template <typename T>
-inline bool operator==(const T &op1, const IntegerOpTypes<T> &op2)
-#else
-template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline bool operator==(const T &op1, const U &op2)
-#endif
+template <std::size_t SSize>
+inline integer_fma_expr<SSize> operator-(const integer<SSize> &c, const integer_mul_expr<SSize> &p)
 {
-    return dispatch_equality(op1, op2);
+    return integer_fma_expr<SSize>{&c, false, p, true};
 }
 
-/// Inequality operator.
+/// Fused sum of products.
 /**
- * @param op1 first argument.
- * @param op2 second argument.
+ * @param p1 the first product expression.
+ * @param p2 the second product expression.
  *
- * @return \p true if <tt>op1 != op2</tt>, \p false otherwise.
+ * @return an expression representing <tt>p1 + p2</tt>.
  */
-#if defined(MPPP_HAVE_CONCEPTS)
-template <typename T>
-inline bool operator!=(const T &op1, const IntegerOpTypes<T> &op2)
-#else
-template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline bool operator!=(const T &op1, const U &op2)
-#endif
+template <std::size_t SSize>
+inline integer_fma_expr<SSize> operator+(const integer_mul_expr<SSize> &p1, const integer_mul_expr<SSize> &p2)
 {
-    return !(op1 == op2);
+    return integer_fma_expr<SSize>{p1, p2, false};
 }
 
-/// Less-than operator.
+/// Fused difference of products.
 /**
- * @param op1 first argument.
- * @param op2 second argument.
+ * @param p1 the first product expression.
+ * @param p2 the second product expression.
  *
- * @return \p true if <tt>op1 < op2</tt>, \p false otherwise.
+ * @return an expression representing <tt>p1 - p2</tt>.
  */
-#if defined(MPPP_HAVE_CONCEPTS)
-template <typename T>
-inline bool operator<(const T &op1, const IntegerOpTypes<T> &op2)
-#else
-template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline bool operator<(const T &op1, const U &op2)
-#endif
+template <std::size_t SSize>
+inline integer_fma_expr<SSize> operator-(const integer_mul_expr<SSize> &p1, const integer_mul_expr<SSize> &p2)
 {
-    return dispatch_less_than(op1, op2);
+    return integer_fma_expr<SSize>{p1, p2, true};
 }
 
-/// Less-than or equal operator.
+/// In-place fused multiply-add.
 /**
- * @param op1 first argument.
- * @param op2 second argument.
+ * \rststar
+ * Equivalent to ``addmul(rop, a, b)``, where ``a * b`` is the product expression ``p``.
+ * \endrststar
  *
- * @return \p true if <tt>op1 <= op2</tt>, \p false otherwise.
+ * @param rop the augend.
+ * @param p a product expression.
+ *
+ * @return a reference to \p rop.
  */
-#if defined(MPPP_HAVE_CONCEPTS)
-template <typename T>
-inline bool operator<=(const T &op1, const IntegerOpTypes<T> &op2)
-#else
-template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline bool operator<=(const T &op1, const U &op2)
-#endif
+template <std::size_t SSize>
+inline integer<SSize> &operator+=(integer<SSize> &rop, const integer_mul_expr<SSize> &p)
 {
-    return !(op1 > op2);
+    return addmul(rop, p.m_a, p.m_b);
 }
 
-/// Greater-than operator.
+/// In-place fused multiply-sub.
 /**
- * @param op1 first argument.
- * @param op2 second argument.
+ * \rststar
+ * Equivalent to ``submul(rop, a, b)``, where ``a * b`` is the product expression ``p``.
+ * \endrststar
  *
- * @return \p true if <tt>op1 > op2</tt>, \p false otherwise.
+ * @param rop the minuend.
+ * @param p a product expression.
+ *
+ * @return a reference to \p rop.
  */
-#if defined(MPPP_HAVE_CONCEPTS)
-template <typename T>
-inline bool operator>(const T &op1, const IntegerOpTypes<T> &op2)
-#else
-template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline bool operator>(const T &op1, const U &op2)
+template <std::size_t SSize>
+inline integer<SSize> &operator-=(integer<SSize> &rop, const integer_mul_expr<SSize> &p)
+{
+    return submul(rop, p.m_a, p.m_b);
+}
+
+/** @} */
+
 #endif
+
+// NOTE: the literals require the relaxed constexpr rules of C++14, as the digits are parsed
+// into limbs in a constexpr function.
+#if MPPP_CPLUSPLUS >= 201402L
+
+inline namespace detail
 {
-    return dispatch_greater_than(op1, op2);
+
+// The limbs of an integer literal, as computed at compile time.
+template <std::size_t N>
+struct integer_literal_repr {
+    mpz_size_t m_size;
+    ::mp_limb_t m_limbs[N];
+};
+
+// Base of an integer literal, deduced from its prefix (following the C++ rules).
+constexpr int integer_literal_base(const char *str, std::size_t n)
+{
+    if (n < 2u || str[0] != '0') {
+        return 10;
+    }
+    if (str[1] == 'x' || str[1] == 'X') {
+        return 16;
+    }
+    if (str[1] == 'b' || str[1] == 'B') {
+        return 2;
+    }
+    return 8;
 }
 
-/// Greater-than or equal operator.
+// Index of the first digit of an integer literal.
+constexpr std::size_t integer_literal_start(int base)
+{
+    return base == 16 || base == 2 ? 2u : (base == 8 ? 1u : 0u);
+}
+
+// Value of the digit c in base base. Returns -1 if c is not a valid digit.
+constexpr int integer_literal_digit(char c, int base)
+{
+    return (c >= '0' && c <= '9' && c - '0' < base)
+               ? c - '0'
+               : ((base == 16 && c >= 'a' && c <= 'f') ? c - 'a' + 10
+                                                       : ((base == 16 && c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1));
+}
+
+// Check that the characters of a literal form a valid integer literal.
+// NOTE: floating-point literals are also passed to the literal operators, they will be rejected here.
+template <char... Chars>
+constexpr bool integer_literal_check()
+{
+    const char str[] = {Chars...};
+    constexpr std::size_t n = sizeof...(Chars);
+    const int base = integer_literal_base(str, n);
+    const auto start = integer_literal_start(base);
+    // Require at least one digit after the 0x and 0b prefixes.
+    if (start == n && base != 8) {
+        return false;
+    }
+    for (auto i = start; i < n; ++i) {
+        if (str[i] != '\'' && integer_literal_digit(str[i], base) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Number of limbs sufficient to represent a literal with the given number of characters.
+// NOTE: each digit needs at most 4 bits.
+constexpr std::size_t integer_literal_nlimbs(std::size_t n)
+{
+    return n * 4u / unsigned(GMP_NUMB_BITS) + 1u;
+}
+
+// Parse an integer literal into limbs.
+template <std::size_t N, char... Chars>
+constexpr integer_literal_repr<N> integer_literal_parse()
+{
+    const char str[] = {Chars...};
+    constexpr std::size_t n = sizeof...(Chars);
+    // NOTE: the multiplication of a limb by the base is done in two parts, so that no intermediate
+    // result overflows a limb.
+    constexpr unsigned lo_bits = unsigned(GMP_NUMB_BITS) / 2u, hi_bits = unsigned(GMP_NUMB_BITS) - lo_bits;
+    constexpr ::mp_limb_t lo_mask = (::mp_limb_t(1) << lo_bits) - 1u;
+    const int base = integer_literal_base(str, n);
+    integer_literal_repr<N> retval{0, {}};
+    std::size_t size = 0;
+    for (auto i = integer_literal_start(base); i < n; ++i) {
+        if (str[i] == '\'') {
+            // Skip the digit separators.
+            continue;
+        }
+        // Multiply the current value by base and add the digit.
+        auto carry = static_cast<::mp_limb_t>(integer_literal_digit(str[i], base));
+        for (std::size_t j = 0; j < size; ++j) {
+            const auto l = retval.m_limbs[j];
+            const ::mp_limb_t lo = (l & lo_mask) * unsigned(base) + carry;
+            const ::mp_limb_t hi = (l >> lo_bits) * unsigned(base) + (lo >> lo_bits);
+            retval.m_limbs[j] = ((hi << lo_bits) | (lo & lo_mask)) & GMP_NUMB_MASK;
+            carry = hi >> hi_bits;
+        }
+        if (carry) {
+            retval.m_limbs[size++] = carry;
+        }
+    }
+    retval.m_size = static_cast<mpz_size_t>(size);
+    return retval;
+}
+
+// The limbs of the integer literal represented by Chars, stored in the binary.
+template <char... Chars>
+struct integer_literal {
+    static constexpr std::size_t nlimbs = integer_literal_nlimbs(sizeof...(Chars));
+    static constexpr integer_literal_repr<nlimbs> value = integer_literal_parse<nlimbs, Chars...>();
+    // Read-only mpz view on the limbs.
+    static mpz_struct_t get_mpz_view()
+    {
+        return {static_cast<mpz_alloc_t>(nlimbs), value.m_size, const_cast<::mp_limb_t *>(value.m_limbs)};
+    }
+};
+
+#if MPPP_CPLUSPLUS < 201703L
+
+template <char... Chars>
+constexpr std::size_t integer_literal<Chars...>::nlimbs;
+
+template <char... Chars>
+constexpr integer_literal_repr<integer_literal<Chars...>::nlimbs> integer_literal<Chars...>::value;
+
+#endif
+
+template <std::size_t SSize, char... Chars>
+inline integer<SSize> integer_literal_impl()
+{
+    static_assert(integer_literal_check<Chars...>(), "Invalid integer literal.");
+    const auto v = integer_literal<Chars...>::get_mpz_view();
+    // NOTE: this will result in a static integer if the value fits, otherwise the limbs
+    // are copied into dynamic storage.
+    return integer<SSize>{&v};
+}
+}
+
+inline namespace literals
+{
+
+/** @defgroup integer_literals integer_literals
+ *  @{
+ */
+
+/// Literal for \link mppp::integer integer\endlink with 1 static limb.
 /**
- * @param op1 first argument.
- * @param op2 second argument.
+ * \rststar
+ * The digits of the literal are parsed into limbs at compile time, so that at runtime the construction
+ * of the return value amounts to a limb copy. Decimal, hexadecimal (``0x`` prefix), binary (``0b``
+ * prefix) and octal (``0`` prefix) literals are supported, and digit separators are allowed:
  *
- * @return \p true if <tt>op1 >= op2</tt>, \p false otherwise.
+ * .. code-block:: c++
+ *
+ *    using namespace mppp::literals;
+ *    auto n = 123456789012345678901234567890_z1;
+ *    auto m = -0xffff'ffff'ffff'ffff'ffff_z2;
+ *
+ * Literals which do not represent integral values (e.g., ``1.5_z1``) are rejected at compile time.
+ *
+ * The integer literals are available only from C++14 onwards.
+ * \endrststar
+ *
+ * @return the integer represented by the literal.
  */
-#if defined(MPPP_HAVE_CONCEPTS)
-template <typename T>
-inline bool operator>=(const T &op1, const IntegerOpTypes<T> &op2)
-#else
-template <typename T, typename U, integer_op_types_enabler<T, U> = 0>
-inline bool operator>=(const T &op1, const U &op2)
-#endif
+template <char... Chars>
+inline integer<1> operator"" _z1()
 {
-    return !(op1 < op2);
+    return integer_literal_impl<1, Chars...>();
+}
+
+/// Literal for \link mppp::integer integer\endlink with 2 static limbs.
+/**
+ * @return the integer represented by the literal.
+ */
+template <char... Chars>
+inline integer<2> operator"" _z2()
+{
+    return integer_literal_impl<2, Chars...>();
+}
+
+/// Literal for \link mppp::integer integer\endlink with 3 static limbs.
+/**
+ * @return the integer represented by the literal.
+ */
+template <char... Chars>
+inline integer<3> operator"" _z3()
+{
+    return integer_literal_impl<3, Chars...>();
 }
 
 /** @} */
 }
 
+#endif
+}
+
 namespace std
 {
 
@@ -6168,4 +9149,10 @@ struct hash<mppp::integer<SSize>> {
 
 #endif
 
+#if defined(MPPP_INT128)
+
+#undef MPPP_INT128
+
+#endif
+
 #endif
@@ -0,0 +1,258 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_INTERNING_POOL_HPP
+#define MPPP_INTERNING_POOL_HPP
+
+#include <mp++/config.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
+namespace mppp
+{
+
+template <typename T>
+class interning_pool;
+
+inline namespace detail
+{
+
+// A value stored in an interning pool, together with its hash.
+template <typename T>
+struct interning_pool_node {
+    T value;
+    std::size_t hash;
+};
+}
+
+/// Handle to an interned value.
+/**
+ * \rststar
+ * An ``interned`` handle refers to a value stored in an :cpp:class:`~mppp::interning_pool`. The handle is
+ * as small as a pointer and cheap to copy. Since the pool stores a single copy of each distinct value,
+ * two handles from the same pool compare equal if and only if they refer to the same value, and the
+ * comparison is performed in constant time. The hash of the value is computed once, when the value
+ * is added to the pool.
+ *
+ * Handles remain valid as long as the pool they originate from is alive and has not been cleared.
+ * Comparing handles originating from different pools is not meaningful.
+ * \endrststar
+ */
+template <typename T>
+class interned
+{
+    friend class interning_pool<T>;
+    explicit interned(const interning_pool_node<T> *node) : m_node(node)
+    {
+    }
+
+public:
+    /// Value accessor.
+    /**
+     * @return a const reference to the interned value.
+     */
+    const T &get() const
+    {
+        return m_node->value;
+    }
+    /// Hash value.
+    /**
+     * @return the hash of the interned value, as computed by mppp::hash().
+     */
+    std::size_t hash() const noexcept
+    {
+        return m_node->hash;
+    }
+    /// Equality operator.
+    /**
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return \p true if \p a and \p b refer to the same value, \p false otherwise.
+     */
+    friend bool operator==(const interned &a, const interned &b)
+    {
+        return a.m_node == b.m_node;
+    }
+    /// Inequality operator.
+    /**
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return \p true if \p a and \p b refer to different values, \p false otherwise.
+     */
+    friend bool operator!=(const interned &a, const interned &b)
+    {
+        return a.m_node != b.m_node;
+    }
+
+private:
+    const interning_pool_node<T> *m_node;
+};
+
+/// Interning pool.
+/**
+ * \rststar
+ * An interning pool stores a single copy of each distinct :cpp:class:`~mppp::integer` or
+ * :cpp:class:`~mppp::rational` value added to it via :cpp:func:`~mppp::interning_pool::intern()`,
+ * and hands out :cpp:class:`~mppp::interned` handles to the stored values. Repeated values thus
+ * occupy memory only once, and equality checks and hashing on the handles are constant-time operations.
+ *
+ * The stored values are never moved or removed, except by :cpp:func:`~mppp::interning_pool::clear()`,
+ * and the handles to them are stable. The member functions of the pool can be called concurrently
+ * from multiple threads.
+ * \endrststar
+ */
+template <typename T>
+class interning_pool
+{
+    static_assert(disjunction<is_integer<T>, is_rational<T>>::value,
+                  "An interning pool can only store integer or rational values.");
+    using node_t = interning_pool_node<T>;
+    template <typename U>
+    interned<T> intern_impl(U &&x)
+    {
+        const auto h = mppp::hash(x);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto range = m_index.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->value == x) {
+                return interned<T>{it->second};
+            }
+        }
+        m_storage.push_back(node_t{std::forward<U>(x), h});
+        const auto node = &m_storage.back();
+        try {
+            m_index.emplace(h, node);
+        } catch (...) {
+            m_storage.pop_back();
+            throw;
+        }
+        return interned<T>{node};
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The pool is initially empty.
+     */
+    interning_pool() = default;
+    /// Deleted copy constructor.
+    interning_pool(const interning_pool &) = delete;
+    /// Deleted copy assignment operator.
+    interning_pool &operator=(const interning_pool &) = delete;
+    /// Intern a value.
+    /**
+     * If a value equal to \p x is already in the pool, a handle to it is returned. Otherwise, a copy of \p x is
+     * added to the pool.
+     *
+     * @param x the value to be interned.
+     *
+     * @return a handle to the value in the pool equal to \p x.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors.
+     */
+    interned<T> intern(const T &x)
+    {
+        return intern_impl(x);
+    }
+    /// Intern a value (move overload).
+    /**
+     * Identical to the other overload, except that \p x is moved into the pool if it is not
+     * already present.
+     *
+     * @param x the value to be interned.
+     *
+     * @return a handle to the value in the pool equal to \p x.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors.
+     */
+    interned<T> intern(T &&x)
+    {
+        return intern_impl(std::move(x));
+    }
+    /// Size.
+    /**
+     * @return the number of distinct values in the pool.
+     */
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_storage.size();
+    }
+    /// Clear the pool.
+    /**
+     * All the values are removed from the pool, and all the handles to them are invalidated.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_index.clear();
+        m_storage.clear();
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    // NOTE: std::deque does not move its elements when growing at the back,
+    // so the handles remain valid.
+    std::deque<node_t> m_storage;
+    // NOTE: index the values by hash, so that lookups do not need
+    // to copy the value being interned.
+    std::unordered_multimap<std::size_t, const node_t *> m_index;
+};
+
+/// Hash value of an interned handle.
+/**
+ * @param x the argument.
+ *
+ * @return the precomputed hash of the value referred to by \p x.
+ */
+template <typename T>
+inline std::size_t hash(const interned<T> &x)
+{
+    return x.hash();
+}
+}
+
+namespace std
+{
+
+/// Specialisation of \p std::hash for mppp::interned.
+template <typename T>
+struct hash<mppp::interned<T>> {
+// NOTE: these typedefs have been deprecated in C++17.
+#if MPPP_CPLUSPLUS < 201703L
+    /// The argument type.
+    typedef mppp::interned<T> argument_type;
+    /// The result type.
+    typedef size_t result_type;
+#endif
+    /// Call operator.
+    /**
+     * @param x the handle whose hash will be returned.
+     *
+     * @return the precomputed hash of the value referred to by \p x.
+     */
+    size_t operator()(const mppp::interned<T> &x) const noexcept
+    {
+        return x.hash();
+    }
+};
+}
+
+#endif
@@ -9,10 +9,18 @@
 #ifndef MPPP_MPPP_HPP
 #define MPPP_MPPP_HPP
 
+#include <mp++/compact_integer.hpp>
 #include <mp++/config.hpp>
 #include <mp++/exceptions.hpp>
+#include <mp++/fixed_integer.hpp>
 #include <mp++/integer.hpp>
+#include <mp++/interning_pool.hpp>
+#include <mp++/parallel.hpp>
 #include <mp++/rational.hpp>
+#include <mp++/rational_accumulator.hpp>
+#include <mp++/relocating_vector.hpp>
+#include <mp++/rns.hpp>
+#include <mp++/shared_integer.hpp>
 #if defined(MPPP_WITH_QUADMATH)
 #include <mp++/real128.hpp>
 #endif
@@ -0,0 +1,690 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_PARALLEL_HPP
+#define MPPP_PARALLEL_HPP
+
+#include <mp++/config.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/detail/parallel.hpp>
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/detail/utils.hpp>
+#include <mp++/integer.hpp>
+
+namespace mppp
+{
+
+/** @defgroup parallel parallel
+ *  @{
+ */
+
+inline namespace detail
+{
+
+// The minimum size (in limbs) of the operands of the sub-products in the parallel multiplication.
+// Below this size, the overhead of thread creation and of the extra additions is not worth it.
+constexpr std::size_t parallel_mul_min_limbs = 4096;
+
+// Construct a read-only mpz view of the (non-negative) value represented by the n limbs starting at ptr.
+inline mpz_struct_t mpz_limbs_view(const ::mp_limb_t *ptr, std::size_t n)
+{
+    // Strip the leading zero limbs.
+    for (; n && !(ptr[n - 1u] & GMP_NUMB_MASK); --n) {
+    }
+    const auto size = safe_cast<mpz_size_t>(n);
+    return {size, size, const_cast<::mp_limb_t *>(ptr)};
+}
+
+// Multiply the non-negative values a and b, and write the result into rop, using up to nthreads threads.
+// rop must be distinct from a and b. The parallelisation is achieved via a top-level Karatsuba split
+// (or a plain split of the larger operand, if the operands are unbalanced), applied recursively
+// while there are threads available and the operands are large enough. The leaves are computed with mpz_mul().
+inline void parallel_mpz_mul(mpz_struct_t *rop, const mpz_struct_t *a, const mpz_struct_t *b, unsigned nthreads)
+{
+    assert(a->_mp_size >= 0 && b->_mp_size >= 0);
+    assert(rop != a && rop != b);
+    if (a->_mp_size < b->_mp_size) {
+        std::swap(a, b);
+    }
+    const auto asize = static_cast<std::size_t>(a->_mp_size), bsize = static_cast<std::size_t>(b->_mp_size);
+    if (nthreads < 2u || bsize < 2u * parallel_mul_min_limbs) {
+        ::mpz_mul(rop, a, b);
+        return;
+    }
+    // Split point, in limbs.
+    const auto k = asize - asize / 2u;
+    // NOTE: k * GMP_NUMB_BITS cannot overflow, as GMP would not be able to represent the operands otherwise.
+    const auto shift = static_cast<::mp_bitcnt_t>(k) * unsigned(GMP_NUMB_BITS);
+    const auto a0 = mpz_limbs_view(a->_mp_d, k), a1 = mpz_limbs_view(a->_mp_d + k, asize - k);
+    if (bsize <= k) {
+        // Unbalanced operands: a = a1 * B**k + a0, and a * b = (a1 * b) * B**k + a0 * b.
+        mpz_raii z0, z1;
+        parallel_run(2u, [&](unsigned i) {
+            const auto c = parallel_chunk(nthreads, 2u, i);
+            parallel_mpz_mul(i ? &z1.m_mpz : &z0.m_mpz, i ? &a1 : &a0, b, static_cast<unsigned>(c.second - c.first));
+        });
+        ::mpz_mul_2exp(rop, &z1.m_mpz, shift);
+        ::mpz_add(rop, rop, &z0.m_mpz);
+        return;
+    }
+    // Karatsuba: with a = a1 * B**k + a0 and b = b1 * B**k + b0,
+    // a * b = z2 * B**2k + (z1 - z2 - z0) * B**k + z0, where z0 = a0 * b0, z2 = a1 * b1
+    // and z1 = (a0 + a1) * (b0 + b1).
+    const auto b0 = mpz_limbs_view(b->_mp_d, k), b1 = mpz_limbs_view(b->_mp_d + k, bsize - k);
+    mpz_raii z0, z1, z2, sa, sb;
+    ::mpz_add(&sa.m_mpz, &a0, &a1);
+    ::mpz_add(&sb.m_mpz, &b0, &b1);
+    if (nthreads == 2u) {
+        // NOTE: do not start more threads than requested: compute z0 and z2 concurrently,
+        // and then z1 with both threads.
+        parallel_run(2u, [&](unsigned i) {
+            parallel_mpz_mul(i ? &z2.m_mpz : &z0.m_mpz, i ? &a1 : &a0, i ? &b1 : &b0, 1u);
+        });
+        parallel_mpz_mul(&z1.m_mpz, &sa.m_mpz, &sb.m_mpz, 2u);
+    } else {
+        parallel_run(3u, [&](unsigned i) {
+            const auto c = parallel_chunk(nthreads, 3u, i);
+            const auto sub_nt = static_cast<unsigned>(c.second - c.first);
+            switch (i) {
+                case 0u:
+                    parallel_mpz_mul(&z0.m_mpz, &a0, &b0, sub_nt);
+                    break;
+                case 1u:
+                    parallel_mpz_mul(&z2.m_mpz, &a1, &b1, sub_nt);
+                    break;
+                default:
+                    parallel_mpz_mul(&z1.m_mpz, &sa.m_mpz, &sb.m_mpz, sub_nt);
+            }
+        });
+    }
+    ::mpz_sub(&z1.m_mpz, &z1.m_mpz, &z0.m_mpz);
+    ::mpz_sub(&z1.m_mpz, &z1.m_mpz, &z2.m_mpz);
+    assert(mpz_sgn(&z1.m_mpz) >= 0);
+    ::mpz_mul_2exp(rop, &z2.m_mpz, shift);
+    ::mpz_add(rop, rop, &z1.m_mpz);
+    ::mpz_mul_2exp(rop, rop, shift);
+    ::mpz_add(rop, rop, &z0.m_mpz);
+}
+}
+
+/// Parallel multiplication (ternary version).
+/**
+ * \rststar
+ * This function will set ``rop`` to ``op1 * op2``, using up to ``nthreads`` threads
+ * (if ``nthreads`` is zero, the number of threads will be deduced from the hardware concurrency).
+ *
+ * The multiplication is parallelised by splitting the operands at the top level
+ * (via the Karatsuba decomposition, applied recursively while there are threads available), and by computing
+ * the resulting sub-products concurrently. This is beneficial only for very large operands (hundreds of thousands
+ * of limbs): for smaller operands, or if only one thread is available, this function is equivalent to
+ * :cpp:func:`~mppp::mul()`.
+ * \endrststar
+ *
+ * @param rop the return value.
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ * @param nthreads the maximum number of threads to use (0 to let the implementation decide).
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws unspecified any exception raised by the creation of the worker threads.
+ */
+template <std::size_t SSize>
+inline integer<SSize> &parallel_mul(integer<SSize> &rop, const integer<SSize> &op1, const integer<SSize> &op2,
+                                    unsigned nthreads = 0)
+{
+    if (op1.is_static() || op2.is_static()) {
+        return mul(rop, op1, op2);
+    }
+    const auto &d1 = op1._get_union().g_dy(), &d2 = op2._get_union().g_dy();
+    const auto size1 = get_mpz_size(&d1), size2 = get_mpz_size(&d2);
+    const auto nt = parallel_nthreads(size1 < size2 ? size1 : size2, 2u * parallel_mul_min_limbs, nthreads);
+    if (nt == 1u) {
+        return mul(rop, op1, op2);
+    }
+    // Work on the absolute values.
+    const auto a = mpz_limbs_view(d1._mp_d, size1), b = mpz_limbs_view(d2._mp_d, size2);
+    const bool neg = (d1._mp_size < 0) != (d2._mp_size < 0);
+    if (rop.is_static()) {
+        rop._get_union().promote(size1 + size2);
+    }
+    if (&rop == &op1 || &rop == &op2) {
+        // Overlapping arguments, go through a temporary.
+        mpz_raii tmp;
+        parallel_mpz_mul(&tmp.m_mpz, &a, &b, nt);
+        ::mpz_swap(&rop._get_union().g_dy(), &tmp.m_mpz);
+    } else {
+        parallel_mpz_mul(&rop._get_union().g_dy(), &a, &b, nt);
+    }
+    if (neg) {
+        rop.neg();
+    }
+    return rop;
+}
+
+/// Parallel multiplication (binary version).
+/**
+ * \rststar
+ * See the ternary version of :cpp:func:`~mppp::parallel_mul()`.
+ * \endrststar
+ *
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ * @param nthreads the maximum number of threads to use (0 to let the implementation decide).
+ *
+ * @return <tt>op1 * op2</tt>.
+ *
+ * @throws unspecified any exception raised by the creation of the worker threads.
+ */
+template <std::size_t SSize>
+inline integer<SSize> parallel_mul(const integer<SSize> &op1, const integer<SSize> &op2, unsigned nthreads = 0)
+{
+    integer<SSize> retval;
+    parallel_mul(retval, op1, op2, nthreads);
+    return retval;
+}
+
+inline namespace detail
+{
+
+// Detect forward iterators over integer objects.
+template <typename It>
+using is_integer_forward_iterator = conjunction<
+    std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>,
+    is_integer<typename std::iterator_traits<It>::value_type>>;
+
+template <typename It>
+using integer_iterator_value_t
+    = enable_if_t<is_integer_forward_iterator<It>::value, typename std::iterator_traits<It>::value_type>;
+
+// Multiply the n integers starting at first, and write the result into rop, using a balanced product tree.
+// The leaves of the tree are small chunks of values which are multiplied sequentially, so that the large
+// multiplications at the top of the tree always involve operands of similar size.
+template <std::size_t SSize, typename It>
+inline void tree_product(integer<SSize> &rop, It first, std::size_t n)
+{
+    // Chunks up to this size are multiplied with a plain left fold.
+    constexpr std::size_t leaf_size = 8;
+    if (n <= leaf_size) {
+        rop.set_one();
+        for (std::size_t i = 0; i < n; ++i, ++first) {
+            mul(rop, rop, *first);
+        }
+        return;
+    }
+    const auto h = n / 2u;
+    auto mid = first;
+    std::advance(mid, h);
+    integer<SSize> tmp;
+    tree_product(rop, first, h);
+    tree_product(tmp, mid, n - h);
+    mul(rop, rop, tmp);
+}
+
+// Reduce in place the partial results in v by combining them pairwise with the function f, with each
+// round of combinations run in parallel. The final result will be stored in v[0]. The last argument
+// passed to f is the number of threads that f can use for each combination (which increases as the number
+// of pairs decreases in the later rounds, so that the threads budget is never exceeded).
+template <std::size_t SSize, typename F>
+inline void parallel_pairwise_reduce(std::vector<integer<SSize>> &v, const F &f)
+{
+    assert(!v.empty());
+    const auto nthreads = v.size();
+    for (std::size_t stride = 1; stride < v.size(); stride *= 2u) {
+        // The number of pairs to be combined in this round.
+        const auto npairs = (v.size() - stride - 1u) / (stride * 2u) + 1u;
+        const auto sub_nt = static_cast<unsigned>(nthreads / npairs);
+        parallel_run(static_cast<unsigned>(npairs), [&v, &f, stride, sub_nt](unsigned i) {
+            const auto idx = i * stride * 2u;
+            f(v[idx], v[idx], v[idx + stride], sub_nt);
+        });
+    }
+}
+}
+
+/// Parallel product.
+/**
+ * \rststar
+ * This function will compute the product of the :cpp:class:`~mppp::integer` objects in the input
+ * range ``[first, last)``. The input range is split into chunks which are processed concurrently by
+ * ``nthreads`` threads (if ``nthreads`` is zero, the number of threads will be deduced from
+ * the hardware concurrency, and in any case small ranges will be processed by fewer threads).
+ *
+ * Each chunk is reduced via a balanced product tree, and the partial results are then combined pairwise.
+ * In this way the large multiplications always involve operands of similar size, which is much faster
+ * than a left fold over the range (whose cost is quadratic in the size of the accumulator). The product
+ * of an empty range is 1.
+ *
+ * This function is enabled only if ``It`` is a forward iterator whose value type is an
+ * :cpp:class:`~mppp::integer`. The input range must not be modified while the function is running.
+ * \endrststar
+ *
+ * @param first the beginning of the input range.
+ * @param last the end of the input range.
+ * @param nthreads the maximum number of threads to use (0 to let the implementation decide).
+ *
+ * @return the product of the values in the input range.
+ *
+ * @throws unspecified any exception raised by the creation of the worker threads, or by memory errors
+ * in standard containers.
+ */
+template <typename It>
+inline integer_iterator_value_t<It> parallel_product(It first, It last, unsigned nthreads = 0)
+{
+    using int_t = integer_iterator_value_t<It>;
+    // The minimum number of values to be processed by each thread.
+    constexpr std::size_t min_items = 1024;
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    const auto nt = parallel_nthreads(n, min_items, nthreads);
+    int_t retval;
+    if (nt == 1u) {
+        tree_product(retval, first, n);
+        return retval;
+    }
+    // Locate the beginning of each chunk.
+    std::vector<It> begins;
+    begins.reserve(nt);
+    for (unsigned i = 0; i < nt; ++i) {
+        const auto c = parallel_chunk(n, nt, i);
+        begins.push_back(first);
+        std::advance(first, c.second - c.first);
+    }
+    std::vector<int_t> partials(nt);
+    parallel_run(nt, [&begins, &partials, n, nt](unsigned i) {
+        const auto c = parallel_chunk(n, nt, i);
+        tree_product(partials[i], begins[i], c.second - c.first);
+    });
+    parallel_pairwise_reduce(
+        partials, [](int_t &rop, const int_t &a, const int_t &b, unsigned sub_nt) { parallel_mul(rop, a, b, sub_nt); });
+    retval = std::move(partials[0]);
+    return retval;
+}
+
+/// Parallel sum.
+/**
+ * \rststar
+ * This function will compute the sum of the :cpp:class:`~mppp::integer` objects in the input
+ * range ``[first, last)``. The input range is split into chunks which are summed concurrently by
+ * ``nthreads`` threads (if ``nthreads`` is zero, the number of threads will be deduced from
+ * the hardware concurrency, and in any case small ranges will be processed by fewer threads).
+ * The partial sums are then combined pairwise. The sum of an empty range is 0.
+ *
+ * This function is enabled only if ``It`` is a forward iterator whose value type is an
+ * :cpp:class:`~mppp::integer`. The input range must not be modified while the function is running.
+ * \endrststar
+ *
+ * @param first the beginning of the input range.
+ * @param last the end of the input range.
+ * @param nthreads the maximum number of threads to use (0 to let the implementation decide).
+ *
+ * @return the sum of the values in the input range.
+ *
+ * @throws unspecified any exception raised by the creation of the worker threads, or by memory errors
+ * in standard containers.
+ */
+template <typename It>
+inline integer_iterator_value_t<It> parallel_sum(It first, It last, unsigned nthreads = 0)
+{
+    using int_t = integer_iterator_value_t<It>;
+    // NOTE: additions are cheap, use larger chunks than in the product.
+    constexpr std::size_t min_items = 4096;
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    const auto nt = parallel_nthreads(n, min_items, nthreads);
+    auto sum_range = [](int_t &rop, It it, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i, ++it) {
+            add(rop, rop, *it);
+        }
+    };
+    int_t retval;
+    if (nt == 1u) {
+        sum_range(retval, first, n);
+        return retval;
+    }
+    std::vector<It> begins;
+    begins.reserve(nt);
+    for (unsigned i = 0; i < nt; ++i) {
+        const auto c = parallel_chunk(n, nt, i);
+        begins.push_back(first);
+        std::advance(first, c.second - c.first);
+    }
+    std::vector<int_t> partials(nt);
+    parallel_run(nt, [&begins, &partials, &sum_range, n, nt](unsigned i) {
+        const auto c = parallel_chunk(n, nt, i);
+        sum_range(partials[i], begins[i], c.second - c.first);
+    });
+    parallel_pairwise_reduce(partials,
+                             [](int_t &rop, const int_t &a, const int_t &b, unsigned) { add(rop, a, b); });
+    retval = std::move(partials[0]);
+    return retval;
+}
+
+/// Batch GCD.
+/**
+ * \rststar
+ * This function will compute, for each value :math:`x_i` in the input range ``[first, last)``, the GCD of
+ * :math:`x_i` and of the product of all the other values in the range. The results are returned in a vector, in the
+ * same order as the input values.
+ *
+ * The computation uses Bernstein's product tree/remainder tree algorithm, which is quasi-linear in the total size of
+ * the input (whereas computing the pairwise GCDs has a quadratic cost). Each level of the trees is processed
+ * concurrently by up to ``nthreads`` threads (if ``nthreads`` is zero, the number of threads will be deduced from
+ * the hardware concurrency). The results are always non-negative. The input values can be zero, and the product
+ * of an empty set of values is considered to be 1.
+ *
+ * This function is enabled only if ``It`` is a forward iterator whose value type is an
+ * :cpp:class:`~mppp::integer`. The input range must not be modified while the function is running.
+ * \endrststar
+ *
+ * @param first the beginning of the input range.
+ * @param last the end of the input range.
+ * @param nthreads the maximum number of threads to use (0 to let the implementation decide).
+ *
+ * @return a vector containing the batch GCDs of the values in the input range.
+ *
+ * @throws unspecified any exception raised by the creation of the worker threads, or by memory errors
+ * in standard containers.
+ */
+template <typename It>
+inline std::vector<integer_iterator_value_t<It>> batch_gcd(It first, It last, unsigned nthreads = 0)
+{
+    using int_t = integer_iterator_value_t<It>;
+    // The minimum number of tree nodes to be processed by each thread.
+    constexpr std::size_t min_items = 16;
+    // Level 0 of the product tree: the absolute values of the inputs.
+    std::vector<std::vector<int_t>> ptree(1u);
+    for (; first != last; ++first) {
+        ptree[0].push_back(abs(*first));
+    }
+    const auto n = ptree[0].size();
+    std::vector<int_t> retval(n);
+    if (n < 2u) {
+        // The GCD with the empty product (i.e., 1) is 1.
+        if (n) {
+            retval[0].set_one();
+        }
+        return retval;
+    }
+    // Handle zeroes: if there is a single zero in the input, its batch GCD is the product
+    // of the other values, while the batch GCD of the other values is their absolute value.
+    // If there are multiple zeroes, the batch GCD of each value is its absolute value.
+    const auto nzeroes = static_cast<std::size_t>(
+        std::count_if(ptree[0].begin(), ptree[0].end(), [](const int_t &x) { return x.is_zero(); }));
+    if (nzeroes) {
+        std::vector<int_t> nonzero;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (ptree[0][i].is_zero()) {
+                retval[i].set_zero();
+            } else {
+                retval[i] = ptree[0][i];
+                nonzero.push_back(ptree[0][i]);
+            }
+        }
+        if (nzeroes == 1u) {
+            const auto idx = static_cast<std::size_t>(std::find_if(ptree[0].begin(), ptree[0].end(),
+                                                                   [](const int_t &x) { return x.is_zero(); })
+                                                      - ptree[0].begin());
+            retval[idx] = parallel_product(nonzero.begin(), nonzero.end(), nthreads);
+        }
+        return retval;
+    }
+    // Build the product tree. The last level contains only the product of all the values.
+    while (ptree.back().size() > 1u) {
+        const auto &cur = ptree.back();
+        std::vector<int_t> next((cur.size() + 1u) / 2u);
+        parallel_for(parallel_nthreads(next.size(), min_items, nthreads), next.size(),
+                     [&cur, &next](std::size_t begin, std::size_t end) {
+                         for (auto i = begin; i < end; ++i) {
+                             if (2u * i + 1u < cur.size()) {
+                                 mul(next[i], cur[2u * i], cur[2u * i + 1u]);
+                             } else {
+                                 next[i] = cur[2u * i];
+                             }
+                         }
+                     });
+        ptree.push_back(std::move(next));
+    }
+    // Descend the remainder tree: each node is replaced by the remainder of the
+    // division of its parent by the square of the node.
+    for (auto lvl = ptree.size() - 1u; lvl > 1u; --lvl) {
+        const auto &parent = ptree[lvl];
+        auto &cur = ptree[lvl - 1u];
+        parallel_for(parallel_nthreads(cur.size(), min_items, nthreads), cur.size(),
+                     [&parent, &cur](std::size_t begin, std::size_t end) {
+                         int_t sq, q;
+                         for (auto i = begin; i < end; ++i) {
+                             mul(sq, cur[i], cur[i]);
+                             tdiv_qr(q, cur[i], parent[i / 2u], sq);
+                         }
+                     });
+    }
+    // On the last level, with r_i = P mod x_i**2 (where P is the product of all the values),
+    // the batch GCD is gcd(r_i / x_i, x_i).
+    const auto &parent = ptree[1], &leaves = ptree[0];
+    parallel_for(parallel_nthreads(n, min_items, nthreads), n,
+                 [&parent, &leaves, &retval](std::size_t begin, std::size_t end) {
+                     int_t sq, q, r;
+                     for (auto i = begin; i < end; ++i) {
+                         mul(sq, leaves[i], leaves[i]);
+                         tdiv_qr(q, r, parent[i / 2u], sq);
+                         divexact(r, r, leaves[i]);
+                         gcd(retval[i], r, leaves[i]);
+                     }
+                 });
+    return retval;
+}
+
+inline namespace detail
+{
+
+// Size in bytes of the blocks processed by the segmented sieve in prime_range(). Each byte
+// represents an odd number, the value is chosen so that a block fits comfortably in the L1 cache.
+constexpr std::size_t prime_sieve_block_size = 32768u;
+
+// Minimum value of the largest prime used for sieving in prime_range().
+constexpr unsigned long long prime_sieve_min_limit = 65536u;
+
+// The odd primes up to and including n, computed via a plain sieve of Eratosthenes on the odd numbers.
+inline std::vector<unsigned long long> small_odd_primes_up_to(unsigned long long n)
+{
+    std::vector<unsigned long long> retval;
+    if (n < 3u) {
+        return retval;
+    }
+    // The i-th element represents 2 * i + 1.
+    std::vector<char> sieve(safe_cast<std::size_t>(n / 2u + 1u), 1);
+    for (unsigned long long i = 1u; i < sieve.size(); ++i) {
+        if (sieve[i]) {
+            const auto p = 2u * i + 1u;
+            retval.push_back(p);
+            for (auto j = p * p / 2u; j < sieve.size(); j += p) {
+                sieve[j] = 0;
+            }
+        }
+    }
+    return retval;
+}
+
+// Sieve the odd numbers in the [first, first + 2 * block.size()) range, with first odd, and append
+// the primes to out. If complete is true, base contains all the odd primes whose square is less than the
+// end of the range, otherwise the values surviving the sieve undergo a primality test.
+inline void prime_sieve_block(std::vector<unsigned long long> &out, std::vector<char> &block,
+                              unsigned long long first, const std::vector<unsigned long long> &base, bool complete)
+{
+    assert(first & 1u);
+    std::fill(block.begin(), block.end(), char(1));
+    const auto size = block.size();
+    for (auto p : base) {
+        // Index of the first odd multiple of p not less than max(first, p * p).
+        unsigned long long idx;
+        if (p * p >= first) {
+            idx = (p * p - first) / 2u;
+        } else {
+            const auto r = first % p;
+            auto off = r ? p - r : 0u;
+            if (off & 1u) {
+                // first + off is even, move to the next multiple.
+                off += p;
+            }
+            idx = off / 2u;
+        }
+        for (; idx < size; idx += p) {
+            block[static_cast<std::size_t>(idx)] = 0;
+        }
+    }
+    // NOTE: 1 is not a prime, and it can only show up in the first position of a block.
+    if (first == 1u) {
+        block[0] = 0;
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        if (block[i] && (complete || integer<1>{first + 2u * i}.probab_prime_p())) {
+            out.push_back(first + 2u * i);
+        }
+    }
+}
+
+// Compute the primes in the [lo, hi) range.
+inline std::vector<unsigned long long> prime_range_impl(unsigned long long lo, unsigned long long hi,
+                                                        unsigned nthreads)
+{
+    std::vector<unsigned long long> retval;
+    if (hi <= lo || hi <= 2u) {
+        return retval;
+    }
+    if (lo <= 2u) {
+        retval.push_back(2u);
+    }
+    // The odd numbers to be sieved are in the [first, hi) range.
+    const auto first = lo <= 1u ? 1ull : (lo | 1u);
+    if (first >= hi) {
+        return retval;
+    }
+    // Number of odd values in the range.
+    const auto n_odd = (hi - first - 1u) / 2u + 1u;
+    // Base primes: all the odd primes up to the integer square root of hi - 1.
+    auto sqrt_hi = static_cast<unsigned long long>(std::sqrt(static_cast<double>(hi - 1u)));
+    // NOTE: fix the floating-point estimate.
+    while (sqrt_hi * sqrt_hi > hi - 1u) {
+        --sqrt_hi;
+    }
+    while (sqrt_hi < 4294967295ull && (sqrt_hi + 1u) * (sqrt_hi + 1u) <= hi - 1u) {
+        ++sqrt_hi;
+    }
+    // NOTE: if the range is narrow with respect to its square root, most of the base primes would
+    // cross out at most one value. In this case, sieve only with the primes up to a smaller limit,
+    // and run a primality test on the survivors.
+    const auto limit = std::min(sqrt_hi, std::max(prime_sieve_min_limit, hi - first));
+    const auto base = small_odd_primes_up_to(limit);
+    // Split the range into blocks, and the blocks among the threads.
+    const auto nblocks = safe_cast<std::size_t>((n_odd - 1u) / prime_sieve_block_size + 1u);
+    const auto nt = parallel_nthreads(nblocks, 4u, nthreads);
+    std::vector<std::vector<unsigned long long>> partial(nt);
+    parallel_run(nt, [&](unsigned i) {
+        const auto c = parallel_chunk(nblocks, nt, i);
+        std::vector<char> block;
+        for (auto b = c.first; b < c.second; ++b) {
+            const auto offset = static_cast<unsigned long long>(b) * prime_sieve_block_size;
+            block.resize(
+                static_cast<std::size_t>(std::min<unsigned long long>(prime_sieve_block_size, n_odd - offset)));
+            prime_sieve_block(partial[i], block, first + 2u * offset, base, limit == sqrt_hi);
+        }
+    });
+    for (const auto &v : partial) {
+        retval.insert(retval.end(), v.begin(), v.end());
+    }
+    return retval;
+}
+
+template <typename T>
+using prime_range_enabler = enable_if_t<
+    disjunction<is_integer<T>, conjunction<is_cpp_interoperable<T>, std::is_integral<T>,
+                                           negation<std::is_same<T, bool>>>>::value,
+    int>;
+
+template <typename T, enable_if_t<std::is_integral<T>::value, int> = 0>
+inline unsigned long long prime_range_bound(const T &n)
+{
+    return n > T(0) ? static_cast<unsigned long long>(n) : 0u;
+}
+
+template <std::size_t SSize>
+inline unsigned long long prime_range_bound(const integer<SSize> &n)
+{
+    // NOTE: the conversion operator throws if n is too large.
+    return n.sgn() > 0 ? static_cast<unsigned long long>(n) : 0u;
+}
+}
+
+/// Generate the primes in a range.
+/**
+ * \rststar
+ * This function will return a vector containing, in ascending order, all the prime numbers :math:`p` such that
+ * :math:`\mathrm{lo} \leq p < \mathrm{hi}`. ``T`` can be either an :cpp:class:`~mppp::integer` or a C++ integral
+ * type (excluding ``bool``).
+ *
+ * The primes are computed via a segmented sieve of Eratosthenes: the range is split into blocks small enough to
+ * fit in the L1 cache, and the blocks are distributed among ``nthreads`` threads. If ``nthreads`` is zero,
+ * the number of threads will be deduced from the hardware concurrency. For ranges which are narrow with respect
+ * to the magnitude of their values, the sieve is run only with the smallest primes and the surviving values undergo
+ * a primality test. This is much faster than iterating with :cpp:func:`~mppp::nextprime()` if the range contains
+ * many primes.
+ * \endrststar
+ *
+ * @param lo the lower bound (included).
+ * @param hi the upper bound (excluded).
+ * @param nthreads the number of threads to use.
+ *
+ * @return the primes in the \f$\left[ \mathrm{lo}, \mathrm{hi} \right)\f$ range.
+ *
+ * @throws std::overflow_error if \p lo or \p hi are greater than the maximum value representable by
+ * <tt>unsigned long long</tt>.
+ * @throws unspecified any exception thrown by memory allocation errors in standard containers or
+ * by threading primitives.
+ */
+template <typename T, prime_range_enabler<T> = 0>
+inline std::vector<T> prime_range(const T &lo, const T &hi, unsigned nthreads = 0)
+{
+    const auto primes = prime_range_impl(prime_range_bound(lo), prime_range_bound(hi), nthreads);
+    std::vector<T> retval;
+    retval.reserve(primes.size());
+    for (auto p : primes) {
+        // NOTE: all the primes are less than hi, hence representable by T.
+        retval.emplace_back(static_cast<T>(p));
+    }
+    return retval;
+}
+
+/** @} */
+
+#if defined(MPPP_ENABLE_EXPRESSION_TEMPLATES)
+
+inline namespace detail
+{
+
+// Overload of parallel_mul() accepting expressions, see MPPP_INTEGER_EXPR_FUNCTION in integer.hpp.
+template <typename... Args, enable_if_t<disjunction<is_integer_expr<uncvref_t<Args>>...>::value, int> = 0>
+inline auto parallel_mul(Args &&... args) -> decltype(parallel_mul(integer_expr_fwd(std::forward<Args>(args))...))
+{
+    return parallel_mul(integer_expr_fwd(std::forward<Args>(args))...);
+}
+}
+
+#endif
+}
+
+#endif
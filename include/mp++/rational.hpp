@@ -64,6 +64,19 @@ template <typename T, std::size_t SSize>
 using is_rational_cvr_integral_interoperable
     = conjunction<is_rational_cvr_interoperable<T, SSize>, negation<std::is_floating_point<uncvref_t<T>>>>;
 
+#if defined(MPPP_ENABLE_EXPRESSION_TEMPLATES)
+
+inline namespace detail
+{
+
+// Detect the integer expressions which can be used to construct a rational<SSize>.
+template <typename T, std::size_t SSize>
+using is_rational_integer_expr = disjunction<std::is_same<uncvref_t<T>, integer_mul_expr<SSize>>,
+                                             std::is_same<uncvref_t<T>, integer_fma_expr<SSize>>>;
+}
+
+#endif
+
 template <typename T, std::size_t SSize>
 #if defined(MPPP_HAVE_CONCEPTS)
 concept bool RationalCvrIntegralInteroperable = is_rational_cvr_integral_interoperable<T, SSize>::value;
@@ -99,6 +112,203 @@ struct is_rational<rational<SSize>> : std::true_type {
 // (due to the use of const_cast() within the mpz view machinery).
 template <std::size_t SSize>
 mpq_struct_t get_mpq_view(const rational<SSize> &);
+
+// Divide n exactly by d in place. Dynamic storage is re-used, static values are
+// divided via a TLS scratch variable.
+template <std::size_t SSize>
+inline void rational_divexact_scratch(integer<SSize> &n, const mpz_struct_t *d)
+{
+    if (n.is_dynamic()) {
+        ::mpz_divexact(&n._get_union().g_dy(), &n._get_union().g_dy(), d);
+    } else {
+        MPPP_MAYBE_TLS mpz_raii tmp;
+        {
+            const auto v = n.get_mpz_view();
+            ::mpz_divexact(&tmp.m_mpz, v, d);
+        }
+        n = &tmp.m_mpz;
+    }
+}
+
+#if defined(MPPP_HAVE_INT128_INTEROP)
+
+// Fast paths for rationals whose numerator and denominator are static and consist of at most one limb.
+// The intermediate values are computed with double-limb arithmetic, and common factors are removed
+// via uint_gcd(), thus avoiding the creation of integer temporaries.
+
+// Absolute value and sign of an integer, if it is static and it consists of at most one limb.
+template <std::size_t SSize>
+inline bool rational_get_limb(::mp_limb_t &abs, bool &neg, const integer<SSize> &n)
+{
+    if (!n.is_static()) {
+        return false;
+    }
+    const auto &st = n._get_union().g_st();
+    if (st._mp_size > 1 || st._mp_size < -1) {
+        return false;
+    }
+    abs = st._mp_size ? st.m_limbs[0] : ::mp_limb_t(0);
+    neg = st._mp_size < 0;
+    return true;
+}
+
+// Numerator and denominator of a rational, unpacked into limbs.
+struct rational_limbs {
+    ::mp_limb_t num;
+    ::mp_limb_t den;
+    bool neg;
+    bool den_neg;
+};
+
+template <std::size_t SSize>
+inline bool rational_get_limbs(rational_limbs &r, const rational<SSize> &q)
+{
+    return rational_get_limb(r.num, r.neg, q.get_num()) && rational_get_limb(r.den, r.den_neg, q.get_den());
+}
+
+// Set n to the value with absolute value abs and sign neg.
+template <std::size_t SSize>
+inline void rational_set_dlimb(integer<SSize> &n, dlimb_t abs, bool neg)
+{
+    if (!(abs >> 64) && n.is_static()) {
+        const auto l = static_cast<::mp_limb_t>(abs);
+        n._get_union().g_st() = static_int<SSize>{l ? (neg ? -1 : 1) : 0, l};
+    } else {
+        n = integer<SSize>{abs};
+        if (neg) {
+            n.neg();
+        }
+    }
+}
+
+// Set q to abs_num/abs_den, with the sign neg. The fraction must be canonical.
+template <std::size_t SSize>
+inline void rational_set_dlimbs(rational<SSize> &q, dlimb_t abs_num, dlimb_t abs_den, bool neg)
+{
+    rational_set_dlimb(q._get_num(), abs_num, neg);
+    rational_set_dlimb(q._get_den(), abs_den, false);
+}
+
+template <bool AddOrSub, std::size_t SSize>
+inline bool rational_addsub_limbs(rational<SSize> &rop, const rational<SSize> &op1, const rational<SSize> &op2)
+{
+    rational_limbs a, b;
+    if (!rational_get_limbs(a, op1) || !rational_get_limbs(b, op2)) {
+        return false;
+    }
+    if (!AddOrSub) {
+        b.neg = !b.neg;
+    }
+    // a/(g*d1) + b/(g*d2) = (a*d2 + b*d1)/(g*d1*d2).
+    const auto g = uint_gcd(a.den, b.den);
+    const auto d1 = a.den / g, d2 = b.den / g;
+    const auto t1 = static_cast<dlimb_t>(a.num) * d2, t2 = static_cast<dlimb_t>(b.num) * d1;
+    dlimb_t num;
+    bool neg;
+    if (a.neg == b.neg) {
+        num = t1 + t2;
+        if (num < t1) {
+            // The numerator does not fit in a double limb, let the general algorithm deal with it.
+            return false;
+        }
+        neg = a.neg;
+    } else if (t1 >= t2) {
+        num = t1 - t2;
+        neg = a.neg;
+    } else {
+        num = t2 - t1;
+        neg = b.neg;
+    }
+    if (!num) {
+        rop._get_num().set_zero();
+        rop._get_den().set_one();
+        return true;
+    }
+    // NOTE: as in the general algorithm, the numerator is coprime with d1 and d2, thus
+    // it is sufficient to remove its common factors with g.
+    const auto g2 = g == 1u ? g : uint_gcd(static_cast<::mp_limb_t>(num % g), g);
+    if (g2 != 1u) {
+        num /= g2;
+    }
+    rational_set_dlimbs(rop, num, static_cast<dlimb_t>(a.den / g2) * d2, neg);
+    return true;
+}
+
+template <std::size_t SSize>
+inline bool rational_mul_limbs(rational<SSize> &rop, const rational<SSize> &op1, const rational<SSize> &op2)
+{
+    rational_limbs a, b;
+    if (!rational_get_limbs(a, op1) || !rational_get_limbs(b, op2)) {
+        return false;
+    }
+    if (!a.num || !b.num) {
+        rop._get_num().set_zero();
+        rop._get_den().set_one();
+        return true;
+    }
+    // Remove the common factors between nums and dens before multiplying.
+    const auto g1 = uint_gcd(a.num, b.den), g2 = uint_gcd(a.den, b.num);
+    rational_set_dlimbs(rop, static_cast<dlimb_t>(a.num / g1) * (b.num / g2),
+                        static_cast<dlimb_t>(a.den / g2) * (b.den / g1), a.neg != b.neg);
+    return true;
+}
+
+// NOTE: op2 must be nonzero.
+template <std::size_t SSize>
+inline bool rational_div_limbs(rational<SSize> &rop, const rational<SSize> &op1, const rational<SSize> &op2)
+{
+    rational_limbs a, b;
+    if (!rational_get_limbs(a, op1) || !rational_get_limbs(b, op2)) {
+        return false;
+    }
+    assert(b.num);
+    if (!a.num) {
+        rop._get_num().set_zero();
+        rop._get_den().set_one();
+        return true;
+    }
+    // (a/b) / (c/d) -> a/b * d/c.
+    const auto g1 = uint_gcd(a.num, b.num), g2 = uint_gcd(a.den, b.den);
+    rational_set_dlimbs(rop, static_cast<dlimb_t>(a.num / g1) * (b.den / g2),
+                        static_cast<dlimb_t>(a.den / g2) * (b.num / g1), a.neg != b.neg);
+    return true;
+}
+
+template <std::size_t SSize>
+inline bool rational_cmp_limbs(int &retval, const rational<SSize> &op1, const rational<SSize> &op2)
+{
+    rational_limbs a, b;
+    if (!rational_get_limbs(a, op1) || !rational_get_limbs(b, op2)) {
+        return false;
+    }
+    const int s1 = a.num ? (a.neg ? -1 : 1) : 0, s2 = b.num ? (b.neg ? -1 : 1) : 0;
+    if (s1 != s2 || !s1) {
+        retval = (s1 > s2) - (s1 < s2);
+        return true;
+    }
+    // Same nonzero sign: compare the cross products of the absolute values.
+    const auto l = static_cast<dlimb_t>(a.num) * b.den, r = static_cast<dlimb_t>(b.num) * a.den;
+    const int c = (l > r) - (l < r);
+    retval = s1 > 0 ? c : -c;
+    return true;
+}
+
+// NOTE: q's den must be nonzero, but q does not need to be canonical.
+template <std::size_t SSize>
+inline bool rational_canonicalise_limbs(rational<SSize> &q)
+{
+    rational_limbs a;
+    if (!rational_get_limbs(a, q)) {
+        return false;
+    }
+    assert(a.den);
+    const auto g = uint_gcd(a.num, a.den);
+    // NOTE: if num is zero, g is the den and the result is 0/1.
+    rational_set_dlimbs(q, a.num / g, a.den / g, a.neg != a.den_neg);
+    return true;
+}
+
+#endif
 }
 
 /// Multiprecision rational class.
@@ -354,6 +564,50 @@ public:
             canonicalise();
         }
     }
+#if defined(MPPP_ENABLE_EXPRESSION_TEMPLATES)
+    /// Constructor from an integer expression.
+    /**
+     * \rststar
+     * This constructor is available only if the ``MPPP_ENABLE_EXPRESSION_TEMPLATES`` macro is defined. The
+     * expression is evaluated into an :cpp:class:`~mppp::integer`, which is then used to initialise ``this``.
+     * \endrststar
+     *
+     * @param e the integer expression.
+     */
+    template <typename T, enable_if_t<is_rational_integer_expr<T, SSize>::value, int> = 0>
+    explicit rational(const T &e) : rational(integer<SSize>(e))
+    {
+    }
+    /// Constructor from numerator and denominator, at least one of which is an integer expression.
+    /**
+     * \rststar
+     * This constructor is available only if the ``MPPP_ENABLE_EXPRESSION_TEMPLATES`` macro is defined. Each
+     * of ``n`` and ``d`` must be either an integer expression or a type satisfying the
+     * :cpp:concept:`~mppp::RationalCvrIntegralInteroperable` concept. The expressions are evaluated into
+     * :cpp:class:`~mppp::integer` values, and the construction then proceeds as in the constructor from
+     * numerator and denominator.
+     * \endrststar
+     *
+     * @param n the numerator.
+     * @param d the denominator.
+     * @param make_canonical if \p true, the rational will be canonicalised after the construction
+     * of numerator and denominator.
+     *
+     * @throws unspecified any exception thrown by the constructor from numerator and denominator.
+     */
+    template <typename T, typename U,
+              enable_if_t<
+                  conjunction<disjunction<is_rational_integer_expr<T, SSize>, is_rational_integer_expr<U, SSize>>,
+                              disjunction<is_rational_integer_expr<T, SSize>,
+                                          is_rational_cvr_integral_interoperable<T, SSize>>,
+                              disjunction<is_rational_integer_expr<U, SSize>,
+                                          is_rational_cvr_integral_interoperable<U, SSize>>>::value,
+                  int> = 0>
+    explicit rational(T &&n, U &&d, bool make_canonical = true)
+        : rational(integer_expr_fwd(std::forward<T>(n)), integer_expr_fwd(std::forward<U>(d)), make_canonical)
+    {
+    }
+#endif
 
 private:
     // Implementation of the constructor from C string. Requires a def-cted object.
@@ -896,23 +1150,40 @@ public:
      */
     rational &canonicalise()
     {
+#if defined(MPPP_HAVE_INT128_INTEROP)
+        if (rational_canonicalise_limbs(*this)) {
+            return *this;
+        }
+#endif
         if (m_num.is_zero()) {
             m_den = 1;
             return *this;
         }
-        // NOTE: this is best in case of small m_num/m_den.
-        // For dynamically allocated num/den, it would be better
-        // to have a TLS integer and re-use that accross calls to
-        // canonicalise. Eventually, we could consider branching
-        // this bit out depending on whether num/den are static
-        // or not. Let's keep it simple for now.
-        // NOTE: gcd() always gets a positive value.
-        const auto g = gcd(m_num, m_den);
-        // This can be zero only if both num and den are zero.
-        assert(!g.is_zero());
-        if (!g.is_one()) {
-            divexact(m_num, m_num, g);
-            divexact(m_den, m_den, g);
+        if (m_num.is_static() && m_den.is_static()) {
+            // NOTE: with static num/den, the gcd is static as well
+            // and no allocation takes place.
+            // NOTE: gcd() always gets a positive value.
+            const auto g = gcd(m_num, m_den);
+            // This can be zero only if both num and den are zero.
+            assert(!g.is_zero());
+            if (!g.is_one()) {
+                divexact(m_num, m_num, g);
+                divexact(m_den, m_den, g);
+            }
+        } else {
+            // With dynamic num/den, compute the gcd into a TLS scratch
+            // variable, so that its storage is re-used across calls.
+            MPPP_MAYBE_TLS mpz_raii g;
+            {
+                const auto vn = m_num.get_mpz_view();
+                const auto vd = m_den.get_mpz_view();
+                ::mpz_gcd(&g.m_mpz, vn, vd);
+            }
+            assert(mpz_sgn(&g.m_mpz) != 0);
+            if (mpz_cmp_ui(&g.m_mpz, 1u) != 0) {
+                rational_divexact_scratch(m_num, &g.m_mpz);
+                rational_divexact_scratch(m_den, &g.m_mpz);
+            }
         }
         // Fix mismatch in signs.
         fix_den_sign(*this);
@@ -1146,6 +1417,11 @@ template <bool AddOrSub, bool NewRop, std::size_t SSize>
 inline void addsub_impl(rational<SSize> &rop, const rational<SSize> &op1, const rational<SSize> &op2)
 {
     assert(!NewRop || (rop.is_zero() && &rop != &op1 && &rop != &op2));
+#if defined(MPPP_HAVE_INT128_INTEROP)
+    if (rational_addsub_limbs<AddOrSub>(rop, op1, op2)) {
+        return;
+    }
+#endif
     const bool u1 = op1.get_den().is_one(), u2 = op2.get_den().is_one();
     // NOTE: it's important here to take care about overlapping arguments: we cannot use
     // rop as a "temporary" storage space, because if it overlaps with op1/op2 we will be
@@ -1204,6 +1480,40 @@ inline void addsub_impl(rational<SSize> &rop, const rational<SSize> &op1, const
         // Set rop's den to the common den.
         rop._get_den() = op1.get_den();
         rop.canonicalise();
+    } else if (!op1.get_num().is_static() || !op1.get_den().is_static() || !op2.get_num().is_static()
+               || !op2.get_den().is_static()) {
+        // Same algorithm as below, operating on TLS scratch variables via the mpz API. This avoids
+        // allocating and freeing the intermediate values at every call when the operands are large.
+        MPPP_MAYBE_TLS mpz_raii g, t, tmp1, tmp2;
+        {
+            const auto n1 = op1.get_num().get_mpz_view(), d1 = op1.get_den().get_mpz_view();
+            const auto n2 = op2.get_num().get_mpz_view(), d2 = op2.get_den().get_mpz_view();
+            ::mpz_gcd(&g.m_mpz, d1, d2);
+            if (mpz_cmp_ui(&g.m_mpz, 1u) == 0) {
+                ::mpz_mul(&tmp1.m_mpz, n1, d2);
+                ::mpz_mul(&tmp2.m_mpz, n2, d1);
+                AddOrSub ? ::mpz_add(&t.m_mpz, &tmp1.m_mpz, &tmp2.m_mpz)
+                         : ::mpz_sub(&t.m_mpz, &tmp1.m_mpz, &tmp2.m_mpz);
+                ::mpz_mul(&tmp1.m_mpz, d1, d2);
+            } else {
+                ::mpz_divexact(&t.m_mpz, d2, &g.m_mpz);
+                ::mpz_divexact(&tmp2.m_mpz, d1, &g.m_mpz);
+                ::mpz_mul(&tmp1.m_mpz, n1, &t.m_mpz);
+                ::mpz_mul(&t.m_mpz, n2, &tmp2.m_mpz);
+                AddOrSub ? ::mpz_add(&t.m_mpz, &tmp1.m_mpz, &t.m_mpz) : ::mpz_sub(&t.m_mpz, &tmp1.m_mpz, &t.m_mpz);
+                ::mpz_gcd(&g.m_mpz, &t.m_mpz, &g.m_mpz);
+                if (mpz_cmp_ui(&g.m_mpz, 1u) == 0) {
+                    ::mpz_mul(&tmp1.m_mpz, d2, &tmp2.m_mpz);
+                } else {
+                    ::mpz_divexact(&t.m_mpz, &t.m_mpz, &g.m_mpz);
+                    ::mpz_divexact(&tmp1.m_mpz, d2, &g.m_mpz);
+                    ::mpz_mul(&tmp1.m_mpz, &tmp1.m_mpz, &tmp2.m_mpz);
+                }
+            }
+        }
+        // NOTE: rop might overlap with op1/op2, write it only after the views are gone.
+        rop._get_num() = &t.m_mpz;
+        rop._get_den() = &tmp1.m_mpz;
     } else {
         // NOTE: the algorithm here is taken from GMP's aors.c for mpq. The idea
         // is, as usual, to avoid large canonicalisations and to try to keep
@@ -1215,8 +1525,12 @@ inline void addsub_impl(rational<SSize> &rop, const rational<SSize> &op1, const
         auto g = gcd(op1.get_den(), op2.get_den());
         if (g.is_one()) {
             // This is the case in which the two dens are coprime.
-            AddOrSub ? add(rop._get_num(), op1.get_num() * op2.get_den(), op2.get_num() * op1.get_den())
-                     : sub(rop._get_num(), op1.get_num() * op2.get_den(), op2.get_num() * op1.get_den());
+            // NOTE: use mul() rather than the binary operator, which might return an expression
+            // object if MPPP_ENABLE_EXPRESSION_TEMPLATES is defined.
+            integer<SSize> tmp1, tmp2;
+            mul(tmp1, op1.get_num(), op2.get_den());
+            mul(tmp2, op2.get_num(), op1.get_den());
+            AddOrSub ? add(rop._get_num(), tmp1, tmp2) : sub(rop._get_num(), tmp1, tmp2);
             mul(rop._get_den(), op1.get_den(), op2.get_den());
         } else {
             // Eliminate common factors between the dens.
@@ -1224,7 +1538,8 @@ inline void addsub_impl(rational<SSize> &rop, const rational<SSize> &op1, const
             auto tmp2 = divexact(op1.get_den(), g);
 
             // Compute the numerator (will be t).
-            auto tmp1 = op1.get_num() * t;
+            integer<SSize> tmp1;
+            mul(tmp1, op1.get_num(), t);
             mul(t, op2.get_num(), tmp2);
             AddOrSub ? add(t, tmp1, t) : sub(t, tmp1, t);
 
@@ -1331,6 +1646,11 @@ template <bool NewRop, std::size_t SSize>
 inline void mul_impl(rational<SSize> &rop, const rational<SSize> &op1, const rational<SSize> &op2)
 {
     assert(!NewRop || rop.is_zero());
+#if defined(MPPP_HAVE_INT128_INTEROP)
+    if (rational_mul_limbs(rop, op1, op2)) {
+        return;
+    }
+#endif
     const bool u1 = op1.get_den().is_one(), u2 = op2.get_den().is_one();
     // NOTE: it's important here to take care about overlapping arguments: we cannot use
     // rop as a "temporary" storage space, because if it overlaps with op1/op2 we will be
@@ -1432,6 +1752,13 @@ inline rational<SSize> &div(rational<SSize> &rop, const rational<SSize> &op1, co
     if (mppp_unlikely(op2.is_zero())) {
         throw zero_division_error("Zero divisor in rational division");
     }
+#if defined(MPPP_HAVE_INT128_INTEROP)
+    // NOTE: the fast path reads the operands before writing into rop,
+    // thus it is fine with overlapping arguments.
+    if (rational_div_limbs(rop, op1, op2)) {
+        return rop;
+    }
+#endif
     if (mppp_unlikely(&rop == &op2)) {
         // Following the GMP algorithm, special case in which rop and op2 are the same object.
         // This allows us to use op2.get_num() safely later, even after setting rop's num, as
@@ -2594,6 +2921,12 @@ inline int cmp(const rational<SSize> &op1, const rational<SSize> &op2)
     // - try to see if the limb/bit sizes of nums and dens can tell use immediately which
     //   number is larger,
     // - otherwise, do the two multiplications and compare.
+#if defined(MPPP_HAVE_INT128_INTEROP)
+    int retval;
+    if (rational_cmp_limbs(retval, op1, op2)) {
+        return retval;
+    }
+#endif
     const auto v1 = get_mpq_view(op1);
     const auto v2 = get_mpq_view(op2);
     return ::mpq_cmp(&v1, &v2);
@@ -2846,6 +3179,75 @@ inline std::size_t hash(const rational<SSize> &q)
 }
 
 /** @} */
+
+#if MPPP_CPLUSPLUS >= 201402L
+
+inline namespace detail
+{
+
+template <std::size_t SSize, char... Chars>
+inline rational<SSize> rational_literal_impl()
+{
+    static_assert(integer_literal_check<Chars...>(), "Invalid rational literal.");
+    const auto v = integer_literal<Chars...>::get_mpz_view();
+    return rational<SSize>{&v};
+}
+}
+
+inline namespace literals
+{
+
+/** @defgroup rational_literals rational_literals
+ *  @{
+ */
+
+/// Literal for \link mppp::rational rational\endlink with 1 static limb.
+/**
+ * \rststar
+ * The literal is parsed at compile time with the same rules as :cpp:func:`~mppp::literals::operator""_z1()`.
+ * A rational literal represents an integral value, but, thanks to the arithmetic operators,
+ * fractions can be written in a natural way:
+ *
+ * .. code-block:: c++
+ *
+ *    using namespace mppp::literals;
+ *    auto q = 3/7_q1;    // Equivalent to 3 / rational<1>{7}.
+ *
+ * The rational literals are available only from C++14 onwards.
+ * \endrststar
+ *
+ * @return the rational represented by the literal.
+ */
+template <char... Chars>
+inline rational<1> operator"" _q1()
+{
+    return rational_literal_impl<1, Chars...>();
+}
+
+/// Literal for \link mppp::rational rational\endlink with 2 static limbs.
+/**
+ * @return the rational represented by the literal.
+ */
+template <char... Chars>
+inline rational<2> operator"" _q2()
+{
+    return rational_literal_impl<2, Chars...>();
+}
+
+/// Literal for \link mppp::rational rational\endlink with 3 static limbs.
+/**
+ * @return the rational represented by the literal.
+ */
+template <char... Chars>
+inline rational<3> operator"" _q3()
+{
+    return rational_literal_impl<3, Chars...>();
+}
+
+/** @} */
+}
+
+#endif
 }
 
 namespace std
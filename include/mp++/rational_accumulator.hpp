@@ -0,0 +1,195 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_RATIONAL_ACCUMULATOR_HPP
+#define MPPP_RATIONAL_ACCUMULATOR_HPP
+
+#include <mp++/config.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/concepts.hpp>
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
+namespace mppp
+{
+
+inline namespace detail
+{
+
+// The types that can be accumulated: rational and integer with the same static size, and C++ integral types.
+template <typename T, std::size_t SSize>
+using is_rational_accumulator_operand
+    = disjunction<std::is_same<T, rational<SSize>>, std::is_same<T, integer<SSize>>, is_supported_integral<T>>;
+}
+
+/// Rational accumulator.
+/**
+ * \rststar
+ * This class computes the sum of a sequence of :cpp:class:`~mppp::rational` values with deferred
+ * canonicalisation. The accumulator keeps a numerator and a denominator which, differently from
+ * :cpp:class:`~mppp::rational`, are not required to be coprime. The denominator is kept equal to the
+ * least common multiple of the denominators of the accumulated values, so that adding a value whose
+ * denominator divides the current one costs only a GCD, an exact division and a multiply-add. The sum is
+ * canonicalised only once, when it is extracted via :cpp:func:`~mppp::rational_accumulator::finalize()`.
+ *
+ * When summing many values, this avoids the GCDs and exact divisions that the addition operators of
+ * :cpp:class:`~mppp::rational` perform at every step in order to keep the result canonical. The intermediate
+ * values are stored in the accumulator, and their storage is re-used across additions.
+ *
+ * .. code-block:: c++
+ *
+ *    rational_accumulator<1> acc;
+ *    for (const auto &q : values) {
+ *        acc += q;
+ *    }
+ *    auto sum = acc.finalize();
+ * \endrststar
+ */
+template <std::size_t SSize>
+class rational_accumulator
+{
+    // Add (or subtract) n/d to the accumulator. d must be positive.
+    template <bool AddOrSub>
+    void accumulate(const integer<SSize> &n, const integer<SSize> &d)
+    {
+        if (d.is_one()) {
+            // Integral value: N/D + n = (N + n*D)/D.
+            AddOrSub ? addmul(m_num, n, m_den) : submul(m_num, n, m_den);
+            return;
+        }
+        // NOTE: lcm(D, d) = D * (d / g), with g = gcd(D, d).
+        gcd(m_g, m_den, d);
+        divexact(m_t, d, m_g);
+        if (m_t.is_one()) {
+            // d divides D: N/D + n/d = (N + n*(D/d))/D.
+            divexact(m_t, m_den, d);
+            AddOrSub ? addmul(m_num, n, m_t) : submul(m_num, n, m_t);
+        } else {
+            // N/D + n/d = (N*(d/g) + n*(D/g))/(D*(d/g)).
+            mul(m_num, m_num, m_t);
+            divexact(m_g, m_den, m_g);
+            AddOrSub ? addmul(m_num, n, m_g) : submul(m_num, n, m_g);
+            mul(m_den, m_den, m_t);
+        }
+    }
+    template <bool AddOrSub>
+    void accumulate_dispatch(const rational<SSize> &q)
+    {
+        accumulate<AddOrSub>(q.get_num(), q.get_den());
+    }
+    template <bool AddOrSub>
+    void accumulate_dispatch(const integer<SSize> &n)
+    {
+        AddOrSub ? addmul(m_num, n, m_den) : submul(m_num, n, m_den);
+    }
+    template <bool AddOrSub, typename T, enable_if_t<is_supported_integral<T>::value, int> = 0>
+    void accumulate_dispatch(const T &n)
+    {
+        m_t = n;
+        accumulate_dispatch<AddOrSub>(m_t);
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The accumulator is initialised to zero.
+     */
+    rational_accumulator() : m_den(1)
+    {
+    }
+    /// In-place addition.
+    /**
+     * \rststar
+     * This operator is enabled only if ``T`` is :cpp:class:`~mppp::rational` or :cpp:class:`~mppp::integer` with
+     * static size ``SSize``, or a C++ integral type.
+     * \endrststar
+     *
+     * @param x the value that will be added to the accumulator.
+     *
+     * @return a reference to \p this.
+     */
+    template <typename T, enable_if_t<is_rational_accumulator_operand<T, SSize>::value, int> = 0>
+    rational_accumulator &operator+=(const T &x)
+    {
+        accumulate_dispatch<true>(x);
+        return *this;
+    }
+    /// In-place subtraction.
+    /**
+     * \rststar
+     * This operator is enabled only if ``T`` is :cpp:class:`~mppp::rational` or :cpp:class:`~mppp::integer` with
+     * static size ``SSize``, or a C++ integral type.
+     * \endrststar
+     *
+     * @param x the value that will be subtracted from the accumulator.
+     *
+     * @return a reference to \p this.
+     */
+    template <typename T, enable_if_t<is_rational_accumulator_operand<T, SSize>::value, int> = 0>
+    rational_accumulator &operator-=(const T &x)
+    {
+        accumulate_dispatch<false>(x);
+        return *this;
+    }
+    /// Get the numerator.
+    /**
+     * @return a const reference to the numerator of the accumulated sum, which is not necessarily
+     * coprime with the denominator.
+     */
+    const integer<SSize> &get_num() const
+    {
+        return m_num;
+    }
+    /// Get the denominator.
+    /**
+     * @return a const reference to the (strictly positive) denominator of the accumulated sum.
+     */
+    const integer<SSize> &get_den() const
+    {
+        return m_den;
+    }
+    /// Extract the sum.
+    /**
+     * This method will canonicalise the accumulated sum and return it. The accumulator is then reset to zero.
+     *
+     * @return the accumulated sum.
+     */
+    rational<SSize> finalize()
+    {
+        rational<SSize> retval;
+        retval._get_num() = std::move(m_num);
+        retval._get_den() = std::move(m_den);
+        retval.canonicalise();
+        reset();
+        return retval;
+    }
+    /// Reset the accumulator.
+    /**
+     * The accumulator is set to zero.
+     */
+    void reset()
+    {
+        m_num.set_zero();
+        m_den.set_one();
+    }
+
+private:
+    integer<SSize> m_num;
+    integer<SSize> m_den;
+    // Scratch values, re-used across the additions.
+    integer<SSize> m_g;
+    integer<SSize> m_t;
+};
+}
+
+#endif
@@ -0,0 +1,647 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_RELOCATING_VECTOR_HPP
+#define MPPP_RELOCATING_VECTOR_HPP
+
+#include <mp++/config.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/detail/fwd_decl.hpp>
+
+namespace mppp
+{
+
+/// Detect trivially relocatable types.
+/**
+ * \rststar
+ * A type ``T`` is trivially relocatable if moving an object of type ``T`` to a new memory location, and then
+ * ending the lifetime of the original object, is equivalent to copying the bytes of the object.
+ * :cpp:class:`~mppp::integer` and :cpp:class:`~mppp::rational` are trivially relocatable, as their storage
+ * never points back into the object itself. By default, trivial types are trivially relocatable as well.
+ *
+ * This trait can be specialised for user-defined types.
+ * \endrststar
+ */
+// NOTE: std::is_trivially_copyable would be the natural default, but it is not available in GCC 4.8.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivial<T> {
+};
+
+/// Specialisation of \link mppp::is_trivially_relocatable is_trivially_relocatable\endlink for
+/// \link mppp::integer integer\endlink.
+template <std::size_t SSize>
+struct is_trivially_relocatable<integer<SSize>> : std::true_type {
+};
+
+/// Specialisation of \link mppp::is_trivially_relocatable is_trivially_relocatable\endlink for
+/// \link mppp::rational rational\endlink.
+template <std::size_t SSize>
+struct is_trivially_relocatable<rational<SSize>> : std::true_type {
+};
+
+inline namespace detail
+{
+
+template <typename T>
+inline T *uninitialized_relocate_impl(T *first, T *last, T *d_first, const std::true_type &)
+{
+    const auto n = static_cast<std::size_t>(last - first);
+    if (n) {
+        // NOTE: the casts to void pointers silence warnings about memcpy() on non-trivial types.
+        std::memcpy(static_cast<void *>(d_first), static_cast<const void *>(first), n * sizeof(T));
+    }
+    return d_first + n;
+}
+
+template <typename T>
+inline T *uninitialized_relocate_impl(T *first, T *last, T *d_first, const std::false_type &)
+{
+    T *cur = d_first;
+    try {
+        for (auto it = first; it != last; ++it, ++cur) {
+            ::new (static_cast<void *>(cur)) T(std::move_if_noexcept(*it));
+        }
+    } catch (...) {
+        // Roll back: the source range is left untouched.
+        for (auto it = d_first; it != cur; ++it) {
+            it->~T();
+        }
+        throw;
+    }
+    for (auto it = first; it != last; ++it) {
+        it->~T();
+    }
+    return cur;
+}
+}
+
+/// Relocate a range of objects.
+/**
+ * \rststar
+ * This function will relocate the objects in the range [``first``, ``last``) into the uninitialised memory
+ * starting at ``d_first``. After the relocation, the lifetime of the objects in the source range has ended,
+ * and the source range must be treated as uninitialised memory. The source and destination ranges must not overlap.
+ *
+ * If ``T`` is :cpp:class:`trivially relocatable <mppp::is_trivially_relocatable>`, the objects are
+ * relocated with a single ``std::memcpy()``. Otherwise, each object is move-constructed (or copy-constructed,
+ * if its move constructor can throw) into the destination range, and the original is then destroyed.
+ * \endrststar
+ *
+ * @param first the beginning of the source range.
+ * @param last the end of the source range.
+ * @param d_first the beginning of the destination range.
+ *
+ * @return a pointer to the end of the destination range.
+ *
+ * @throws unspecified any exception thrown by the constructors of \p T. In such case, the source range is
+ * left unchanged and the destination range is left uninitialised.
+ */
+template <typename T>
+inline T *uninitialized_relocate(T *first, T *last, T *d_first)
+{
+    return uninitialized_relocate_impl(first, last, d_first,
+                                       std::integral_constant<bool, is_trivially_relocatable<T>::value>{});
+}
+
+/// Contiguous container with relocation on growth.
+/**
+ * \rststar
+ * This is a simplified version of ``std::vector`` which uses :cpp:func:`~mppp::uninitialized_relocate()`
+ * when the storage is reallocated. For :cpp:class:`trivially relocatable <mppp::is_trivially_relocatable>`
+ * types, such as :cpp:class:`~mppp::integer` and :cpp:class:`~mppp::rational`, growing the container thus
+ * amounts to a ``std::memcpy()`` of the existing elements, rather than to a move construction and a destruction
+ * per element.
+ *
+ * The storage grows geometrically in :cpp:func:`~mppp::relocating_vector::push_back()` and
+ * :cpp:func:`~mppp::relocating_vector::emplace_back()`. The elements are allocated via the global
+ * ``operator new()``, thus ``T`` must not be over-aligned.
+ *
+ * .. note::
+ *
+ *    The container is named ``relocating_vector`` rather than ``vector`` in order to avoid ambiguities
+ *    with ``std::vector`` in code that uses both the ``mppp`` and ``std`` namespaces.
+ * \endrststar
+ */
+template <typename T>
+class relocating_vector
+{
+    static_assert(!std::is_const<T>::value && !std::is_reference<T>::value && std::is_destructible<T>::value,
+                  "The value type of a relocating_vector must be a non-const destructible object type.");
+
+public:
+    /// Value type.
+    using value_type = T;
+    /// Size type.
+    using size_type = std::size_t;
+    /// Iterator type.
+    using iterator = T *;
+    /// Const iterator type.
+    using const_iterator = const T *;
+    /// Default constructor.
+    /**
+     * The default constructor creates an empty container without allocating memory.
+     */
+    relocating_vector() noexcept : m_data(nullptr), m_size(0u), m_capacity(0u)
+    {
+    }
+    /// Constructor from size.
+    /**
+     * @param n the number of value-initialised elements in the container.
+     *
+     * @throws unspecified any exception thrown by resize().
+     */
+    explicit relocating_vector(size_type n) : relocating_vector()
+    {
+        resize(n);
+    }
+    /// Constructor from size and value.
+    /**
+     * @param n the number of elements in the container.
+     * @param x the value of the elements.
+     *
+     * @throws unspecified any exception thrown by resize().
+     */
+    explicit relocating_vector(size_type n, const T &x) : relocating_vector()
+    {
+        resize(n, x);
+    }
+    /// Constructor from initializer list.
+    /**
+     * @param l the list of values which will be copied into the container.
+     *
+     * @throws unspecified any exception thrown by reserve() or by the copy constructor of \p T.
+     */
+    relocating_vector(std::initializer_list<T> l) : relocating_vector()
+    {
+        append_copies(l.begin(), l.end());
+    }
+    /// Copy constructor.
+    /**
+     * @param other the container that will be copied.
+     *
+     * @throws unspecified any exception thrown by reserve() or by the copy constructor of \p T.
+     */
+    relocating_vector(const relocating_vector &other) : relocating_vector()
+    {
+        append_copies(other.begin(), other.end());
+    }
+    /// Move constructor.
+    /**
+     * @param other the container that will be moved. After the move, \p other will be empty.
+     */
+    relocating_vector(relocating_vector &&other) noexcept : m_data(other.m_data),
+                                                            m_size(other.m_size),
+                                                            m_capacity(other.m_capacity)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0u;
+        other.m_capacity = 0u;
+    }
+    /// Copy assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    relocating_vector &operator=(const relocating_vector &other)
+    {
+        if (mppp_likely(this != &other)) {
+            relocating_vector tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+    /// Move assignment operator.
+    /**
+     * @param other the assignment argument. After the move, \p other will be empty.
+     *
+     * @return a reference to \p this.
+     */
+    relocating_vector &operator=(relocating_vector &&other) noexcept
+    {
+        if (mppp_likely(this != &other)) {
+            relocating_vector tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+    /// Destructor.
+    ~relocating_vector()
+    {
+        clear();
+        deallocate(m_data);
+    }
+    /// Number of elements.
+    /**
+     * @return the number of elements in the container.
+     */
+    size_type size() const noexcept
+    {
+        return m_size;
+    }
+    /// Capacity.
+    /**
+     * @return the number of elements that the container can hold without reallocating its storage.
+     */
+    size_type capacity() const noexcept
+    {
+        return m_capacity;
+    }
+    /// Test for emptiness.
+    /**
+     * @return \p true if the container has no elements, \p false otherwise.
+     */
+    bool empty() const noexcept
+    {
+        return m_size == 0u;
+    }
+    /// Reserve storage.
+    /**
+     * This method will reallocate the storage of the container, if needed, so that it can hold at
+     * least \p n elements. The storage is never shrunk.
+     *
+     * @param n the number of elements to reserve storage for.
+     *
+     * @throws std::overflow_error if \p n is larger than an implementation-defined value.
+     * @throws unspecified any exception thrown by memory allocation errors or by
+     * mppp::uninitialized_relocate().
+     */
+    void reserve(size_type n)
+    {
+        if (n > m_capacity) {
+            reallocate(n);
+        }
+    }
+    /// Release unused storage.
+    /**
+     * This method will reallocate the storage of the container so that its capacity matches its size.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors or by
+     * mppp::uninitialized_relocate().
+     */
+    void shrink_to_fit()
+    {
+        if (m_capacity > m_size) {
+            reallocate(m_size);
+        }
+    }
+    /// Resize.
+    /**
+     * If \p n is smaller than the current size, the trailing elements are destroyed. Otherwise,
+     * value-initialised elements are appended to the container.
+     *
+     * @param n the new size.
+     *
+     * @throws unspecified any exception thrown by reserve() or by the default constructor of \p T.
+     * In such case, the size of the container is left unchanged.
+     */
+    void resize(size_type n)
+    {
+        resize_impl(n, [](T *p) { ::new (static_cast<void *>(p)) T(); });
+    }
+    /// Resize with value.
+    /**
+     * If \p n is smaller than the current size, the trailing elements are destroyed. Otherwise,
+     * copies of \p x are appended to the container.
+     *
+     * @param n the new size.
+     * @param x the value of the appended elements.
+     *
+     * @throws unspecified any exception thrown by reserve() or by the copy constructor of \p T.
+     * In such case, the size of the container is left unchanged.
+     */
+    void resize(size_type n, const T &x)
+    {
+        if (n > m_size && n > m_capacity && &x >= begin() && &x < end()) {
+            // NOTE: x is an element of this, and it would not survive the reallocation.
+            const T tmp(x);
+            resize(n, tmp);
+            return;
+        }
+        resize_impl(n, [&x](T *p) { ::new (static_cast<void *>(p)) T(x); });
+    }
+    /// Construct an element at the end of the container.
+    /**
+     * @param args the arguments that will be forwarded to the constructor of the new element.
+     *
+     * @return a reference to the new element.
+     *
+     * @throws std::overflow_error if the size of the container would become larger than an
+     * implementation-defined value.
+     * @throws unspecified any exception thrown by memory allocation errors, by mppp::uninitialized_relocate()
+     * or by the constructor of \p T. In such case, the container is left unchanged.
+     */
+    template <typename... Args>
+    T &emplace_back(Args &&... args)
+    {
+        if (m_size < m_capacity) {
+            ::new (static_cast<void *>(m_data + m_size)) T(std::forward<Args>(args)...);
+        } else {
+            // NOTE: the new element is constructed before relocating the existing ones, as the arguments
+            // might refer to elements of this.
+            const auto new_capacity = grown_capacity();
+            T *new_data = allocate(new_capacity);
+            try {
+                ::new (static_cast<void *>(new_data + m_size)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(new_data);
+                throw;
+            }
+            try {
+                uninitialized_relocate(m_data, m_data + m_size, new_data);
+            } catch (...) {
+                new_data[m_size].~T();
+                deallocate(new_data);
+                throw;
+            }
+            deallocate(m_data);
+            m_data = new_data;
+            m_capacity = new_capacity;
+        }
+        return m_data[m_size++];
+    }
+    /// Append a copy of an element.
+    /**
+     * @param x the element that will be copied at the end of the container.
+     *
+     * @throws unspecified any exception thrown by emplace_back().
+     */
+    void push_back(const T &x)
+    {
+        emplace_back(x);
+    }
+    /// Append an element via move.
+    /**
+     * @param x the element that will be moved at the end of the container.
+     *
+     * @throws unspecified any exception thrown by emplace_back().
+     */
+    void push_back(T &&x)
+    {
+        emplace_back(std::move(x));
+    }
+    /// Remove the last element.
+    /**
+     * The container must not be empty.
+     */
+    void pop_back()
+    {
+        assert(m_size);
+        m_data[--m_size].~T();
+    }
+    /// Remove all the elements.
+    /**
+     * The capacity of the container is not changed.
+     */
+    void clear() noexcept
+    {
+        destroy_range(m_data, m_data + m_size);
+        m_size = 0u;
+    }
+    /// Swap.
+    /**
+     * @param other the container that will be swapped with \p this.
+     */
+    void swap(relocating_vector &other) noexcept
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+    }
+    /// Element access.
+    /**
+     * @param i the index of the element.
+     *
+     * @return a reference to the element at index \p i, which must be smaller than size().
+     */
+    T &operator[](size_type i)
+    {
+        assert(i < m_size);
+        return m_data[i];
+    }
+    /// Const element access.
+    /**
+     * @param i the index of the element.
+     *
+     * @return a const reference to the element at index \p i, which must be smaller than size().
+     */
+    const T &operator[](size_type i) const
+    {
+        assert(i < m_size);
+        return m_data[i];
+    }
+    /// Checked element access.
+    /**
+     * @param i the index of the element.
+     *
+     * @return a reference to the element at index \p i.
+     *
+     * @throws std::out_of_range if \p i is not smaller than size().
+     */
+    T &at(size_type i)
+    {
+        check_index(i);
+        return m_data[i];
+    }
+    /// Checked const element access.
+    /**
+     * @param i the index of the element.
+     *
+     * @return a const reference to the element at index \p i.
+     *
+     * @throws std::out_of_range if \p i is not smaller than size().
+     */
+    const T &at(size_type i) const
+    {
+        check_index(i);
+        return m_data[i];
+    }
+    /// First element.
+    /**
+     * @return a reference to the first element of the container, which must not be empty.
+     */
+    T &front()
+    {
+        assert(m_size);
+        return m_data[0];
+    }
+    /// Const first element.
+    /**
+     * @return a const reference to the first element of the container, which must not be empty.
+     */
+    const T &front() const
+    {
+        assert(m_size);
+        return m_data[0];
+    }
+    /// Last element.
+    /**
+     * @return a reference to the last element of the container, which must not be empty.
+     */
+    T &back()
+    {
+        assert(m_size);
+        return m_data[m_size - 1u];
+    }
+    /// Const last element.
+    /**
+     * @return a const reference to the last element of the container, which must not be empty.
+     */
+    const T &back() const
+    {
+        assert(m_size);
+        return m_data[m_size - 1u];
+    }
+    /// Pointer to the data.
+    /**
+     * @return a pointer to the first element of the container.
+     */
+    T *data() noexcept
+    {
+        return m_data;
+    }
+    /// Const pointer to the data.
+    /**
+     * @return a const pointer to the first element of the container.
+     */
+    const T *data() const noexcept
+    {
+        return m_data;
+    }
+    /// Begin iterator.
+    /**
+     * @return an iterator to the first element of the container.
+     */
+    iterator begin() noexcept
+    {
+        return m_data;
+    }
+    /// End iterator.
+    /**
+     * @return an iterator one past the last element of the container.
+     */
+    iterator end() noexcept
+    {
+        return m_data + m_size;
+    }
+    /// Const begin iterator.
+    /**
+     * @return a const iterator to the first element of the container.
+     */
+    const_iterator begin() const noexcept
+    {
+        return m_data;
+    }
+    /// Const end iterator.
+    /**
+     * @return a const iterator one past the last element of the container.
+     */
+    const_iterator end() const noexcept
+    {
+        return m_data + m_size;
+    }
+
+private:
+    static T *allocate(size_type n)
+    {
+        if (mppp_unlikely(n > std::numeric_limits<size_type>::max() / sizeof(T))) {
+            throw std::overflow_error("Cannot allocate storage for " + std::to_string(n)
+                                      + " elements in a relocating_vector");
+        }
+        return n ? static_cast<T *>(::operator new(n * sizeof(T))) : nullptr;
+    }
+    static void deallocate(T *p) noexcept
+    {
+        ::operator delete(static_cast<void *>(p));
+    }
+    static void destroy_range(T *first, T *last) noexcept
+    {
+        for (; first != last; ++first) {
+            first->~T();
+        }
+    }
+    void reallocate(size_type new_capacity)
+    {
+        assert(new_capacity >= m_size);
+        T *new_data = allocate(new_capacity);
+        try {
+            uninitialized_relocate(m_data, m_data + m_size, new_data);
+        } catch (...) {
+            deallocate(new_data);
+            throw;
+        }
+        deallocate(m_data);
+        m_data = new_data;
+        m_capacity = new_capacity;
+    }
+    // Capacity after a geometric growth step.
+    size_type grown_capacity() const
+    {
+        if (mppp_unlikely(m_capacity > std::numeric_limits<size_type>::max() / 2u)) {
+            throw std::overflow_error("The capacity of a relocating_vector cannot be increased beyond "
+                                      + std::to_string(m_capacity) + " elements");
+        }
+        return m_capacity ? m_capacity * 2u : 1u;
+    }
+    template <typename F>
+    void resize_impl(size_type n, const F &construct)
+    {
+        if (n <= m_size) {
+            destroy_range(m_data + n, m_data + m_size);
+            m_size = n;
+            return;
+        }
+        reserve(n);
+        auto cur = m_data + m_size;
+        try {
+            for (; cur != m_data + n; ++cur) {
+                construct(cur);
+            }
+        } catch (...) {
+            destroy_range(m_data + m_size, cur);
+            throw;
+        }
+        m_size = n;
+    }
+    template <typename It>
+    void append_copies(It first, It last)
+    {
+        reserve(m_size + static_cast<size_type>(last - first));
+        for (; first != last; ++first) {
+            ::new (static_cast<void *>(m_data + m_size)) T(*first);
+            ++m_size;
+        }
+    }
+    void check_index(size_type i) const
+    {
+        if (mppp_unlikely(i >= m_size)) {
+            throw std::out_of_range("Cannot access the element at index " + std::to_string(i)
+                                    + " in a relocating_vector of size " + std::to_string(m_size));
+        }
+    }
+
+    T *m_data;
+    size_type m_size;
+    size_type m_capacity;
+};
+}
+
+#endif
@@ -0,0 +1,492 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_RNS_HPP
+#define MPPP_RNS_HPP
+
+#include <mp++/config.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <mp++/detail/gmp.hpp>
+#include <mp++/integer.hpp>
+
+namespace mppp
+{
+
+template <std::size_t SSize>
+class rns_integer;
+
+/// Residue number system basis.
+/**
+ * \rststar
+ * This class represents a basis of pairwise coprime word-sized moduli (specifically, distinct primes
+ * smaller than :math:`2^{b-1}`, where :math:`b` is the number of bits in a limb), which can be used to represent
+ * :cpp:class:`~mppp::integer` values in a residue number system (RNS) via the :cpp:class:`~mppp::rns_integer` class.
+ *
+ * A basis is constructed from the number of bits :math:`n` of the values to be represented: the product :math:`M`
+ * of the primes in the basis is guaranteed to be larger than :math:`2^{n+1}`, so that any value :math:`x` such that
+ * :math:`\left| x \right| < 2^n` can be represented exactly. More precisely, values in the symmetric
+ * range :math:`\left[ -\left\lfloor M/2 \right\rfloor, M - \left\lfloor M/2 \right\rfloor - 1 \right]` are
+ * represented exactly.
+ *
+ * The basis also stores the data needed for the reconstruction of an :cpp:class:`~mppp::integer` from its residues
+ * via the Chinese remainder theorem. The reconstruction uses Garner's mixed-radix algorithm, which requires only
+ * a linear amount of precomputed data in the number of primes.
+ * \endrststar
+ */
+template <std::size_t SSize>
+class rns_basis
+{
+    friend class rns_integer<SSize>;
+
+public:
+    /// Underlying integral type.
+    using int_t = integer<SSize>;
+    /// Constructor.
+    /**
+     * @param nbits the number of bits of the values to be represented.
+     *
+     * @throws std::invalid_argument if \p nbits is zero or too large.
+     * @throws unspecified any exception raised by memory errors in standard containers.
+     */
+    explicit rns_basis(std::size_t nbits) : m_nbits(nbits)
+    {
+        if (mppp_unlikely(!nbits || nbits > std::numeric_limits<std::size_t>::max() - 2u)) {
+            throw std::invalid_argument("Cannot construct an RNS basis for values with " + std::to_string(nbits)
+                                        + " bits");
+        }
+        // Select primes in decreasing order, starting from the largest candidate smaller than 2**(b-1).
+        ::mp_limb_t cand = (::mp_limb_t(1) << (GMP_NUMB_BITS - 1)) - 1u;
+        m_modulus.set_one();
+        // NOTE: we need M > 2**(nbits + 1), that is, at least nbits + 2 bits in M.
+        while (m_modulus.nbits() < nbits + 2u) {
+            for (; !int_t{cand}.probab_prime_p(); cand -= 2u) {
+            }
+            // Inverse of the product of the previous primes, modulo the new prime.
+            ::mp_limb_t prod = 1u;
+            for (const auto &p : m_primes) {
+                prod = limb_mulmod(prod, p % cand, cand);
+            }
+            m_primes.push_back(cand);
+#if defined(MPPP_HAVE_LIMB_MONT)
+            m_mont.emplace_back(cand);
+            // NOTE: store the inverse in Montgomery form, so that a single Montgomery
+            // multiplication by a value in standard form yields a result in standard form.
+            m_garner_inv.push_back(m_mont.back().to_mont(limb_invmod(prod, cand)));
+#else
+            m_garner_inv.push_back(limb_invmod(prod, cand));
+#endif
+            m_modulus *= int_t{cand};
+            cand -= 2u;
+        }
+        m_half_modulus = m_modulus;
+        m_half_modulus >>= 1u;
+    }
+    /// Size of the basis.
+    /**
+     * @return the number of primes in the basis.
+     */
+    std::size_t size() const
+    {
+        return m_primes.size();
+    }
+    /// Number of bits.
+    /**
+     * @return the number of bits used in the construction of the basis.
+     */
+    std::size_t get_nbits() const
+    {
+        return m_nbits;
+    }
+    /// Get the primes.
+    /**
+     * @return a const reference to the primes in the basis.
+     */
+    const std::vector<::mp_limb_t> &get_primes() const
+    {
+        return m_primes;
+    }
+    /// Get the modulus.
+    /**
+     * @return a const reference to the product of the primes in the basis.
+     */
+    const int_t &get_modulus() const
+    {
+        return m_modulus;
+    }
+
+private:
+    // Product of the residues a and b modulo the i-th prime.
+    ::mp_limb_t mulmod(::mp_limb_t a, ::mp_limb_t b, std::size_t i) const
+    {
+#if defined(MPPP_HAVE_LIMB_MONT)
+        return m_mont[i].mulmod(a, b);
+#else
+        return limb_mulmod(a, b, m_primes[i]);
+#endif
+    }
+    // Write into out the residues of n.
+    void reduce(std::vector<::mp_limb_t> &out, const int_t &n) const
+    {
+        assert(out.size() == m_primes.size());
+        const auto v = n.get_mpz_view();
+        const mpz_struct_t *ptr = v.get();
+        const auto asize = static_cast<::mp_size_t>(get_mpz_size(ptr));
+        const bool neg = ptr->_mp_size < 0;
+        for (decltype(m_primes.size()) i = 0; i < m_primes.size(); ++i) {
+            const auto r = asize ? ::mpn_mod_1(ptr->_mp_d, asize, m_primes[i]) : ::mp_limb_t(0);
+            out[i] = (neg && r) ? m_primes[i] - r : r;
+        }
+    }
+    // Reconstruct an integer from its residues, via Garner's algorithm.
+    int_t reconstruct(const std::vector<::mp_limb_t> &res) const
+    {
+        assert(res.size() == m_primes.size());
+        const auto size = m_primes.size();
+        // Compute the mixed-radix digits v_i, so that
+        // x = v_0 + v_1 * m_0 + v_2 * m_0 * m_1 + ...
+        MPPP_MAYBE_TLS std::vector<::mp_limb_t> digits;
+        digits.resize(size);
+        for (decltype(m_primes.size()) j = 0; j < size; ++j) {
+            const auto mj = m_primes[j];
+            // Evaluate (v_0 + v_1 * m_0 + ... + v_{j-1} * m_0 * ... * m_{j-2}) mod m_j via Horner's scheme.
+            // NOTE: the primes are in decreasing order and larger than 2**(b-2) (reaching 2**(b-2)
+            // would require a basis with an astronomical number of primes), thus both the previous
+            // primes and the digits (which are smaller than the previous primes) are smaller
+            // than 2 * m_j, and a conditional subtraction replaces the division.
+            assert(mj > (::mp_limb_t(1) << (GMP_NUMB_BITS - 2)));
+            const auto red = [mj](::mp_limb_t x) { return x >= mj ? x - mj : x; };
+            ::mp_limb_t acc = 0;
+            for (auto i = j; i > 0u; --i) {
+                acc = limb_addmod(mulmod(acc, red(m_primes[i - 1u]), j), red(digits[i - 1u]), mj);
+            }
+#if defined(MPPP_HAVE_LIMB_MONT)
+            digits[j] = m_mont[j].mul(limb_submod(res[j], acc, mj), m_garner_inv[j]);
+#else
+            digits[j] = limb_mulmod(limb_submod(res[j], acc, mj), m_garner_inv[j], mj);
+#endif
+        }
+        // Assemble the result, again via Horner's scheme.
+        int_t retval;
+        for (auto j = size; j > 0u; --j) {
+            retval *= m_primes[j - 1u];
+            retval += digits[j - 1u];
+        }
+        // Move to the symmetric range.
+        if (retval > m_half_modulus) {
+            retval -= m_modulus;
+        }
+        return retval;
+    }
+
+private:
+    std::size_t m_nbits;
+    std::vector<::mp_limb_t> m_primes;
+#if defined(MPPP_HAVE_LIMB_MONT)
+    // The Montgomery arithmetic data for each prime.
+    std::vector<limb_mont> m_mont;
+#endif
+    // The inverses of m_0 * ... * m_{j-1} modulo m_j (in Montgomery form, if available).
+    std::vector<::mp_limb_t> m_garner_inv;
+    int_t m_modulus;
+    int_t m_half_modulus;
+};
+
+/// Integer in residue number system representation.
+/**
+ * \rststar
+ * This class represents an integer via its residues modulo the primes of an :cpp:class:`~mppp::rns_basis`.
+ * Additions, subtractions and multiplications are performed independently on each residue, using word-sized
+ * modular arithmetic. The conversion back to :cpp:class:`~mppp::integer` (which requires the reconstruction via the
+ * Chinese remainder theorem) is performed only on demand, via :cpp:func:`~mppp::rns_integer::to_integer()`.
+ *
+ * All the arithmetic operations are performed modulo the product :math:`M` of the primes in the basis: if the
+ * exact result of a computation is outside the range of values representable by the basis (see the documentation
+ * of :cpp:class:`~mppp::rns_basis`), the reconstructed value will be congruent to the exact result modulo :math:`M`.
+ *
+ * An :cpp:class:`~mppp::rns_integer` stores a pointer to its basis: it is the user's responsibility to ensure
+ * that the basis outlives the :cpp:class:`~mppp::rns_integer` objects constructed from it. The operands of binary
+ * operations must use the same basis (or identical copies of it).
+ * \endrststar
+ */
+template <std::size_t SSize>
+class rns_integer
+{
+public:
+    /// Underlying integral type.
+    using int_t = integer<SSize>;
+    /// Constructor.
+    /**
+     * This constructor will initialise \p this to zero.
+     *
+     * @param b the RNS basis.
+     *
+     * @throws unspecified any exception raised by memory errors in standard containers.
+     */
+    explicit rns_integer(const rns_basis<SSize> &b) : m_basis(&b), m_res(b.size()) {}
+    /// Constructor from integer.
+    /**
+     * @param b the RNS basis.
+     * @param n the value that will be represented by \p this.
+     *
+     * @throws unspecified any exception raised by memory errors in standard containers.
+     */
+    explicit rns_integer(const rns_basis<SSize> &b, const int_t &n) : rns_integer(b)
+    {
+        m_basis->reduce(m_res, n);
+    }
+    /// Get the basis.
+    /**
+     * @return a const reference to the basis of \p this.
+     */
+    const rns_basis<SSize> &get_basis() const
+    {
+        return *m_basis;
+    }
+    /// Get the residues.
+    /**
+     * @return a const reference to the residues of \p this, in the same order as the primes in the basis.
+     */
+    const std::vector<::mp_limb_t> &get_residues() const
+    {
+        return m_res;
+    }
+    /// Convert to integer.
+    /**
+     * @return the value represented by \p this, in the symmetric range of the basis.
+     *
+     * @throws unspecified any exception raised by memory errors in standard containers.
+     */
+    int_t to_integer() const
+    {
+        return m_basis->reconstruct(m_res);
+    }
+    /// Negate in-place.
+    /**
+     * @return a reference to \p this.
+     */
+    rns_integer &neg()
+    {
+        const auto &primes = m_basis->m_primes;
+        for (decltype(m_res.size()) i = 0; i < m_res.size(); ++i) {
+            m_res[i] = limb_submod(0u, m_res[i], primes[i]);
+        }
+        return *this;
+    }
+    /// In-place addition.
+    /**
+     * @param other the addend.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws std::invalid_argument if \p this and \p other have different bases.
+     */
+    rns_integer &operator+=(const rns_integer &other)
+    {
+        return add(*this, *this, other);
+    }
+    /// In-place subtraction.
+    /**
+     * @param other the subtrahend.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws std::invalid_argument if \p this and \p other have different bases.
+     */
+    rns_integer &operator-=(const rns_integer &other)
+    {
+        return sub(*this, *this, other);
+    }
+    /// In-place multiplication.
+    /**
+     * @param other the multiplicand.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws std::invalid_argument if \p this and \p other have different bases.
+     */
+    rns_integer &operator*=(const rns_integer &other)
+    {
+        return mul(*this, *this, other);
+    }
+
+private:
+    // Check that a and b have compatible bases.
+    static void check_bases(const rns_integer &a, const rns_integer &b)
+    {
+        if (mppp_unlikely(a.m_basis != b.m_basis && a.m_basis->m_primes != b.m_basis->m_primes)) {
+            throw std::invalid_argument("Cannot operate on RNS integers with different bases");
+        }
+    }
+    // Implementation of the binary operations: set rop's residues to f(a_i, b_i, m_i).
+    template <typename F>
+    static rns_integer &binary_op(rns_integer &rop, const rns_integer &a, const rns_integer &b, const F &f)
+    {
+        check_bases(a, b);
+        rop.m_basis = a.m_basis;
+        rop.m_res.resize(a.m_res.size());
+        const auto &primes = a.m_basis->m_primes;
+        for (decltype(a.m_res.size()) i = 0; i < a.m_res.size(); ++i) {
+            rop.m_res[i] = f(a.m_res[i], b.m_res[i], primes[i]);
+        }
+        return rop;
+    }
+    // Implementation of the multiplication. NOTE: this does not go through binary_op(), as the
+    // modular multiplication uses the per-prime data stored in the basis.
+    static rns_integer &mul_impl(rns_integer &rop, const rns_integer &a, const rns_integer &b)
+    {
+        check_bases(a, b);
+        rop.m_basis = a.m_basis;
+        rop.m_res.resize(a.m_res.size());
+        for (decltype(a.m_res.size()) i = 0; i < a.m_res.size(); ++i) {
+            rop.m_res[i] = a.m_basis->mulmod(a.m_res[i], b.m_res[i], i);
+        }
+        return rop;
+    }
+
+public:
+    /// Ternary addition.
+    /**
+     * @param rop the return value.
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return a reference to \p rop.
+     *
+     * @throws std::invalid_argument if \p a and \p b have different bases.
+     */
+    friend rns_integer &add(rns_integer &rop, const rns_integer &a, const rns_integer &b)
+    {
+        return binary_op(rop, a, b, limb_addmod);
+    }
+    /// Ternary subtraction.
+    /**
+     * @param rop the return value.
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return a reference to \p rop.
+     *
+     * @throws std::invalid_argument if \p a and \p b have different bases.
+     */
+    friend rns_integer &sub(rns_integer &rop, const rns_integer &a, const rns_integer &b)
+    {
+        return binary_op(rop, a, b, limb_submod);
+    }
+    /// Ternary multiplication.
+    /**
+     * @param rop the return value.
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return a reference to \p rop.
+     *
+     * @throws std::invalid_argument if \p a and \p b have different bases.
+     */
+    friend rns_integer &mul(rns_integer &rop, const rns_integer &a, const rns_integer &b)
+    {
+        return mul_impl(rop, a, b);
+    }
+    /// Binary addition operator.
+    /**
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return <tt>a + b</tt>.
+     *
+     * @throws std::invalid_argument if \p a and \p b have different bases.
+     */
+    friend rns_integer operator+(const rns_integer &a, const rns_integer &b)
+    {
+        rns_integer retval(*a.m_basis);
+        add(retval, a, b);
+        return retval;
+    }
+    /// Binary subtraction operator.
+    /**
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return <tt>a - b</tt>.
+     *
+     * @throws std::invalid_argument if \p a and \p b have different bases.
+     */
+    friend rns_integer operator-(const rns_integer &a, const rns_integer &b)
+    {
+        rns_integer retval(*a.m_basis);
+        sub(retval, a, b);
+        return retval;
+    }
+    /// Binary multiplication operator.
+    /**
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return <tt>a * b</tt>.
+     *
+     * @throws std::invalid_argument if \p a and \p b have different bases.
+     */
+    friend rns_integer operator*(const rns_integer &a, const rns_integer &b)
+    {
+        rns_integer retval(*a.m_basis);
+        mul(retval, a, b);
+        return retval;
+    }
+    /// Negated copy.
+    /**
+     * @param a the argument.
+     *
+     * @return <tt>-a</tt>.
+     */
+    friend rns_integer operator-(const rns_integer &a)
+    {
+        rns_integer retval(a);
+        retval.neg();
+        return retval;
+    }
+    /// Equality operator.
+    /**
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return \p true if \p a and \p b represent the same value, \p false otherwise.
+     *
+     * @throws std::invalid_argument if \p a and \p b have different bases.
+     */
+    friend bool operator==(const rns_integer &a, const rns_integer &b)
+    {
+        check_bases(a, b);
+        return a.m_res == b.m_res;
+    }
+    /// Inequality operator.
+    /**
+     * @param a the first argument.
+     * @param b the second argument.
+     *
+     * @return \p true if \p a and \p b represent different values, \p false otherwise.
+     *
+     * @throws std::invalid_argument if \p a and \p b have different bases.
+     */
+    friend bool operator!=(const rns_integer &a, const rns_integer &b)
+    {
+        return !(a == b);
+    }
+
+private:
+    const rns_basis<SSize> *m_basis;
+    std::vector<::mp_limb_t> m_res;
+};
+}
+
+#endif
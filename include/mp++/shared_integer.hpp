@@ -0,0 +1,563 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef MPPP_SHARED_INTEGER_HPP
+#define MPPP_SHARED_INTEGER_HPP
+
+#include <mp++/config.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/concepts.hpp>
+#include <mp++/detail/type_traits.hpp>
+#include <mp++/integer.hpp>
+
+namespace mppp
+{
+
+template <std::size_t SSize>
+class shared_integer;
+
+inline namespace detail
+{
+
+// The type resulting from a binary operation involving shared_integer. The operands can be
+// two shared_integer with the same static size, a shared_integer and an integer with the same
+// static size, or a shared_integer and a C++ integral type.
+template <typename T, typename U, typename = void>
+struct shared_integer_common_type {
+};
+
+template <std::size_t SSize>
+struct shared_integer_common_type<shared_integer<SSize>, shared_integer<SSize>> {
+    using type = shared_integer<SSize>;
+};
+
+template <std::size_t SSize>
+struct shared_integer_common_type<shared_integer<SSize>, integer<SSize>> {
+    using type = shared_integer<SSize>;
+};
+
+template <std::size_t SSize>
+struct shared_integer_common_type<integer<SSize>, shared_integer<SSize>> {
+    using type = shared_integer<SSize>;
+};
+
+template <std::size_t SSize, typename U>
+struct shared_integer_common_type<shared_integer<SSize>, U, enable_if_t<is_supported_integral<U>::value>> {
+    using type = shared_integer<SSize>;
+};
+
+template <std::size_t SSize, typename T>
+struct shared_integer_common_type<T, shared_integer<SSize>, enable_if_t<is_supported_integral<T>::value>> {
+    using type = shared_integer<SSize>;
+};
+
+template <typename T, typename U>
+using shared_integer_common_t = typename shared_integer_common_type<T, U>::type;
+
+// Enabler for the in-place operators.
+template <typename T, std::size_t SSize>
+using shared_integer_in_place_enabler = enable_if_t<
+    std::is_same<shared_integer_common_t<shared_integer<SSize>, T>, shared_integer<SSize>>::value, int>;
+
+// Extract the operand of a binary shared_integer operation: shared_integer is replaced
+// by the integer it refers to, all the other types are passed through.
+template <std::size_t SSize>
+inline const integer<SSize> &shared_integer_operand(const shared_integer<SSize> &n)
+{
+    return n.get();
+}
+
+template <typename T>
+inline const T &shared_integer_operand(const T &n)
+{
+    return n;
+}
+}
+
+/// Copy-on-write multiprecision integer.
+/**
+ * \rststar
+ * This class is a handle to a reference-counted :cpp:class:`~mppp::integer`. Copying a ``shared_integer``
+ * does not copy the value: the copies share the same :cpp:class:`~mppp::integer` until one of them is
+ * modified, at which point the modified handle acquires a private copy of the value (copy-on-write).
+ * This makes copies of very large integers cheap both in time and in memory, at the price of a heap
+ * allocation per distinct value and of an extra indirection on every access. ``shared_integer`` is thus
+ * intended for large values which are copied frequently but rarely modified; for small values,
+ * :cpp:class:`~mppp::integer` remains the better choice.
+ *
+ * The value can be read via :cpp:func:`~mppp::shared_integer::get()`. Any modification must go through
+ * :cpp:func:`~mppp::shared_integer::get_mutable()`, which detaches the handle from the other copies
+ * if needed. The arithmetic and comparison operators accept ``shared_integer`` operands with the same
+ * static size, in mixed mode with :cpp:class:`~mppp::integer` and with C++ integral types.
+ *
+ * The reference counting is thread-safe: distinct handles sharing the same value can be used concurrently
+ * from different threads. As with :cpp:class:`~mppp::integer`, concurrent accesses to the same handle require
+ * external synchronisation if one of them is a modification.
+ * \endrststar
+ */
+template <std::size_t SSize>
+class shared_integer
+{
+public:
+    /// Alias for the underlying integer type.
+    using int_t = integer<SSize>;
+    /// Default constructor.
+    /**
+     * The value is initialised to zero. No memory is allocated.
+     */
+    shared_integer() = default;
+    /// Copy constructor.
+    /**
+     * The new object shares the value of \p other.
+     */
+    shared_integer(const shared_integer &) = default;
+    /// Move constructor.
+    /**
+     * After the move, \p other will be zero.
+     */
+    shared_integer(shared_integer &&) = default;
+    /// Constructor from integer.
+    /**
+     * @param n the value that will be used to initialise \p this.
+     *
+     * @throws std::bad_alloc if the allocation of the shared value fails.
+     */
+    explicit shared_integer(const int_t &n) : m_ptr(std::make_shared<int_t>(n))
+    {
+    }
+    /// Move constructor from integer.
+    /**
+     * @param n the value that will be moved into \p this.
+     *
+     * @throws std::bad_alloc if the allocation of the shared value fails.
+     */
+    explicit shared_integer(int_t &&n) : m_ptr(std::make_shared<int_t>(std::move(n)))
+    {
+    }
+    /// Generic constructor.
+    /**
+     * \rststar
+     * This constructor is enabled only if ``T`` is a :cpp:concept:`~mppp::CppInteroperable` type.
+     * The value is constructed via the corresponding constructor of :cpp:class:`~mppp::integer`.
+     * \endrststar
+     *
+     * @param x the value that will be used to initialise \p this.
+     *
+     * @throws unspecified any exception thrown by the generic constructor of \link mppp::integer integer\endlink.
+     */
+#if defined(MPPP_HAVE_CONCEPTS)
+    explicit shared_integer(const CppInteroperable &x)
+#else
+    template <typename T, cpp_interoperable_enabler<T> = 0>
+    explicit shared_integer(const T &x)
+#endif
+        : shared_integer(int_t{x})
+    {
+    }
+    /// Constructor from string.
+    /**
+     * @param s the input string.
+     * @param base the base used in the string representation.
+     *
+     * @throws unspecified any exception thrown by the constructor of \link mppp::integer integer\endlink from
+     * string.
+     */
+    explicit shared_integer(const std::string &s, int base = 10) : shared_integer(int_t{s, base})
+    {
+    }
+    /// Copy assignment operator.
+    /**
+     * After the assignment, \p this shares the value of the argument.
+     *
+     * @return a reference to \p this.
+     */
+    shared_integer &operator=(const shared_integer &) = default;
+    /// Move assignment operator.
+    /**
+     * @return a reference to \p this.
+     */
+    shared_integer &operator=(shared_integer &&) = default;
+    /// Const accessor.
+    /**
+     * @return a const reference to the value of \p this.
+     */
+    const int_t &get() const
+    {
+        if (m_ptr) {
+            return *m_ptr;
+        }
+        static const int_t zero;
+        return zero;
+    }
+    /// Mutable accessor.
+    /**
+     * If the value of \p this is shared with other handles, \p this will first acquire a private copy of the
+     * value. The returned reference is valid until \p this is copied, assigned or destroyed.
+     *
+     * @return a mutable reference to the value of \p this.
+     *
+     * @throws std::bad_alloc if the allocation of the private copy fails.
+     */
+    int_t &get_mutable()
+    {
+        if (!m_ptr) {
+            m_ptr = std::make_shared<int_t>();
+        } else if (m_ptr.use_count() > 1) {
+            m_ptr = std::make_shared<int_t>(*m_ptr);
+        } else {
+            // NOTE: use_count() is a relaxed load. If another thread has just released its
+            // handle, its reads of the value must happen before our writes. The release
+            // of a shared_ptr decrements the count with release semantics, and this fence
+            // pairs with it.
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *m_ptr;
+    }
+    /// Number of handles sharing the value.
+    /**
+     * @return the number of \link mppp::shared_integer shared_integer\endlink objects sharing the value of
+     * \p this, or 0 if \p this holds the zero value created by the default constructor.
+     */
+    long use_count() const
+    {
+        return m_ptr.use_count();
+    }
+    /// Conversion to integer.
+    /**
+     * @return a copy of the value of \p this.
+     */
+    explicit operator int_t() const
+    {
+        return get();
+    }
+    /// Generic conversion operator.
+    /**
+     * \rststar
+     * This operator is enabled only if ``T`` is a :cpp:concept:`~mppp::CppInteroperable` type.
+     * \endrststar
+     *
+     * @return the value of \p this converted to \p T.
+     *
+     * @throws unspecified any exception thrown by the conversion operator of \link mppp::integer integer\endlink.
+     */
+#if defined(MPPP_HAVE_CONCEPTS)
+    template <CppInteroperable T>
+#else
+    template <typename T, cpp_interoperable_enabler<T> = 0>
+#endif
+    explicit operator T() const
+    {
+        return static_cast<T>(get());
+    }
+    /// Conversion to string.
+    /**
+     * @param base the desired base.
+     *
+     * @return a string representation of \p this.
+     *
+     * @throws std::invalid_argument if \p base is not between 2 and 62.
+     */
+    std::string to_string(int base = 10) const
+    {
+        return get().to_string(base);
+    }
+    /// Sign.
+    /**
+     * @return 0 if \p this is zero, 1 if \p this is positive, -1 if \p this is negative.
+     */
+    int sgn() const
+    {
+        return get().sgn();
+    }
+
+private:
+    std::shared_ptr<int_t> m_ptr;
+};
+
+/** @defgroup shared_integer_operators shared_integer_operators
+ *  @{
+ */
+
+/// Output stream operator.
+/**
+ * @param os the target stream.
+ * @param n the input value.
+ *
+ * @return a reference to \p os.
+ */
+template <std::size_t SSize>
+inline std::ostream &operator<<(std::ostream &os, const shared_integer<SSize> &n)
+{
+    return os << n.get();
+}
+
+/// Identity operator.
+/**
+ * @param n the argument.
+ *
+ * @return a copy of \p n, sharing its value.
+ */
+template <std::size_t SSize>
+inline shared_integer<SSize> operator+(const shared_integer<SSize> &n)
+{
+    return n;
+}
+
+/// Negation operator.
+/**
+ * @param n the argument.
+ *
+ * @return <tt>-n</tt>.
+ */
+template <std::size_t SSize>
+inline shared_integer<SSize> operator-(const shared_integer<SSize> &n)
+{
+    return shared_integer<SSize>{-n.get()};
+}
+
+/// Binary addition operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return <tt>op1 + op2</tt>.
+ */
+template <typename T, typename U>
+inline shared_integer_common_t<T, U> operator+(const T &op1, const U &op2)
+{
+    return shared_integer_common_t<T, U>{shared_integer_operand(op1) + shared_integer_operand(op2)};
+}
+
+/// Binary subtraction operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return <tt>op1 - op2</tt>.
+ */
+template <typename T, typename U>
+inline shared_integer_common_t<T, U> operator-(const T &op1, const U &op2)
+{
+    return shared_integer_common_t<T, U>{shared_integer_operand(op1) - shared_integer_operand(op2)};
+}
+
+/// Binary multiplication operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return <tt>op1 * op2</tt>.
+ */
+template <typename T, typename U>
+inline shared_integer_common_t<T, U> operator*(const T &op1, const U &op2)
+{
+    return shared_integer_common_t<T, U>{shared_integer_operand(op1) * shared_integer_operand(op2)};
+}
+
+/// Binary division operator.
+/**
+ * @param n the dividend.
+ * @param d the divisor.
+ *
+ * @return <tt>n / d</tt>, truncated.
+ *
+ * @throws zero_division_error if \p d is zero.
+ */
+template <typename T, typename U>
+inline shared_integer_common_t<T, U> operator/(const T &n, const U &d)
+{
+    return shared_integer_common_t<T, U>{shared_integer_operand(n) / shared_integer_operand(d)};
+}
+
+/// Binary modulo operator.
+/**
+ * @param n the dividend.
+ * @param d the divisor.
+ *
+ * @return <tt>n % d</tt>, with the sign of \p n.
+ *
+ * @throws zero_division_error if \p d is zero.
+ */
+template <typename T, typename U>
+inline shared_integer_common_t<T, U> operator%(const T &n, const U &d)
+{
+    return shared_integer_common_t<T, U>{shared_integer_operand(n) % shared_integer_operand(d)};
+}
+
+// NOTE: the in-place operators detach rop from the other copies only once, and then operate
+// directly on the private value, so that its storage is reused.
+
+/// In-place addition operator.
+/**
+ * @param rop the augend.
+ * @param op the addend.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize, typename T, shared_integer_in_place_enabler<T, SSize> = 0>
+inline shared_integer<SSize> &operator+=(shared_integer<SSize> &rop, const T &op)
+{
+    const auto &o = shared_integer_operand(op);
+    rop.get_mutable() += o;
+    return rop;
+}
+
+/// In-place subtraction operator.
+/**
+ * @param rop the minuend.
+ * @param op the subtrahend.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize, typename T, shared_integer_in_place_enabler<T, SSize> = 0>
+inline shared_integer<SSize> &operator-=(shared_integer<SSize> &rop, const T &op)
+{
+    const auto &o = shared_integer_operand(op);
+    rop.get_mutable() -= o;
+    return rop;
+}
+
+/// In-place multiplication operator.
+/**
+ * @param rop the multiplicand.
+ * @param op the multiplicator.
+ *
+ * @return a reference to \p rop.
+ */
+template <std::size_t SSize, typename T, shared_integer_in_place_enabler<T, SSize> = 0>
+inline shared_integer<SSize> &operator*=(shared_integer<SSize> &rop, const T &op)
+{
+    const auto &o = shared_integer_operand(op);
+    rop.get_mutable() *= o;
+    return rop;
+}
+
+/// In-place division operator.
+/**
+ * @param rop the dividend.
+ * @param op the divisor.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws zero_division_error if \p op is zero.
+ */
+template <std::size_t SSize, typename T, shared_integer_in_place_enabler<T, SSize> = 0>
+inline shared_integer<SSize> &operator/=(shared_integer<SSize> &rop, const T &op)
+{
+    const auto &o = shared_integer_operand(op);
+    rop.get_mutable() /= o;
+    return rop;
+}
+
+/// In-place modulo operator.
+/**
+ * @param rop the dividend.
+ * @param op the divisor.
+ *
+ * @return a reference to \p rop.
+ *
+ * @throws zero_division_error if \p op is zero.
+ */
+template <std::size_t SSize, typename T, shared_integer_in_place_enabler<T, SSize> = 0>
+inline shared_integer<SSize> &operator%=(shared_integer<SSize> &rop, const T &op)
+{
+    const auto &o = shared_integer_operand(op);
+    rop.get_mutable() %= o;
+    return rop;
+}
+
+/// Equality operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 == op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, enable_if_t<is_detected<shared_integer_common_t, T, U>::value, int> = 0>
+inline bool operator==(const T &op1, const U &op2)
+{
+    return shared_integer_operand(op1) == shared_integer_operand(op2);
+}
+
+/// Inequality operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 != op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, enable_if_t<is_detected<shared_integer_common_t, T, U>::value, int> = 0>
+inline bool operator!=(const T &op1, const U &op2)
+{
+    return shared_integer_operand(op1) != shared_integer_operand(op2);
+}
+
+/// Less-than operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 < op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, enable_if_t<is_detected<shared_integer_common_t, T, U>::value, int> = 0>
+inline bool operator<(const T &op1, const U &op2)
+{
+    return shared_integer_operand(op1) < shared_integer_operand(op2);
+}
+
+/// Less-than or equal operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 <= op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, enable_if_t<is_detected<shared_integer_common_t, T, U>::value, int> = 0>
+inline bool operator<=(const T &op1, const U &op2)
+{
+    return shared_integer_operand(op1) <= shared_integer_operand(op2);
+}
+
+/// Greater-than operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 > op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, enable_if_t<is_detected<shared_integer_common_t, T, U>::value, int> = 0>
+inline bool operator>(const T &op1, const U &op2)
+{
+    return shared_integer_operand(op1) > shared_integer_operand(op2);
+}
+
+/// Greater-than or equal operator.
+/**
+ * @param op1 the first argument.
+ * @param op2 the second argument.
+ *
+ * @return \p true if <tt>op1 >= op2</tt>, \p false otherwise.
+ */
+template <typename T, typename U, enable_if_t<is_detected<shared_integer_common_t, T, U>::value, int> = 0>
+inline bool operator>=(const T &op1, const U &op2)
+{
+    return shared_integer_operand(op1) >= shared_integer_operand(op2);
+}
+
+/** @} */
+}
+
+#endif
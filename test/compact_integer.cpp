@@ -0,0 +1,259 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mp++/compact_integer.hpp>
+#include <mp++/exceptions.hpp>
+#include <mp++/integer.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace mppp;
+
+using int_t = integer<1>;
+
+static std::mt19937 rng;
+
+static const int ntries = 1000;
+
+static const unsigned ibits = unsigned(std::numeric_limits<std::uintptr_t>::digits) - 2u;
+
+// Values around the boundary between inline and heap storage.
+static std::vector<int_t> boundary_values()
+{
+    std::vector<int_t> retval;
+    const auto lim = int_t{1} << ibits;
+    for (int i = -3; i <= 3; ++i) {
+        retval.push_back(lim + i);
+        retval.push_back(-lim + i);
+    }
+    for (int i = -3; i <= 3; ++i) {
+        retval.emplace_back(i);
+    }
+    retval.push_back(lim * lim);
+    retval.push_back(-lim * lim - 1);
+    return retval;
+}
+
+static int_t random_int()
+{
+    std::uniform_int_distribution<unsigned> bdist(0u, ibits * 2u);
+    std::uniform_int_distribution<int> sdist(0, 1);
+    const auto nbits = bdist(rng);
+    int_t retval;
+    for (unsigned i = 0; i < nbits; ++i) {
+        retval <<= 1;
+        retval += sdist(rng);
+    }
+    return sdist(rng) ? -retval : retval;
+}
+
+static void check_canonical(const compact_integer &c)
+{
+    const auto n = static_cast<int_t>(c);
+    REQUIRE(c.is_inline() == (n.nbits() <= ibits));
+}
+
+TEST_CASE("compact_integer basic")
+{
+    REQUIRE(sizeof(compact_integer) == sizeof(void *));
+    compact_integer c;
+    REQUIRE(c.is_inline());
+    REQUIRE(c.sgn() == 0);
+    REQUIRE(static_cast<int_t>(c) == 0);
+    REQUIRE(c.to_string() == "0");
+    REQUIRE(compact_integer{42}.to_string() == "42");
+    REQUIRE(compact_integer{-42}.to_string() == "-42");
+    REQUIRE(compact_integer{-42}.sgn() == -1);
+    REQUIRE(compact_integer{42}.sgn() == 1);
+    REQUIRE(compact_integer{true} == 1);
+    REQUIRE(compact_integer{std::numeric_limits<long long>::min()}.to_string()
+            == std::to_string(std::numeric_limits<long long>::min()));
+    REQUIRE(compact_integer{std::numeric_limits<unsigned long long>::max()}.to_string()
+            == std::to_string(std::numeric_limits<unsigned long long>::max()));
+    REQUIRE(compact_integer{std::numeric_limits<unsigned char>::max()} == 255);
+    REQUIRE(compact_integer{"-123456789012345678901234567890"}.to_string() == "-123456789012345678901234567890");
+    REQUIRE(!compact_integer{"-123456789012345678901234567890"}.is_inline());
+    REQUIRE((compact_integer{"ff", 16} == 255));
+    REQUIRE_THROWS_AS(compact_integer{"abc"}, std::invalid_argument &);
+    // Conversions.
+    REQUIRE(static_cast<int>(compact_integer{-42}) == -42);
+    REQUIRE(static_cast<unsigned long long>(compact_integer{std::numeric_limits<unsigned long long>::max()})
+            == std::numeric_limits<unsigned long long>::max());
+    REQUIRE(static_cast<long long>(compact_integer{std::numeric_limits<long long>::min()})
+            == std::numeric_limits<long long>::min());
+    REQUIRE_THROWS_AS(static_cast<unsigned>(compact_integer{-1}), std::overflow_error &);
+    REQUIRE_THROWS_AS(static_cast<int>(compact_integer{"123456789012345678901234567890"}), std::overflow_error &);
+    REQUIRE(static_cast<integer<3>>(compact_integer{"-123456789012345678901234567890"})
+            == integer<3>{"-123456789012345678901234567890"});
+    // Stream.
+    std::ostringstream oss;
+    oss << compact_integer{-7};
+    REQUIRE(oss.str() == "-7");
+    for (const auto &n : boundary_values()) {
+        compact_integer c1{n};
+        REQUIRE(static_cast<int_t>(c1) == n);
+        REQUIRE(c1.to_string() == n.to_string());
+        REQUIRE(c1.sgn() == n.sgn());
+        check_canonical(c1);
+        // Copy and move semantics.
+        compact_integer c2{c1};
+        REQUIRE(static_cast<int_t>(c2) == n);
+        compact_integer c3{std::move(c2)};
+        REQUIRE(static_cast<int_t>(c3) == n);
+        REQUIRE(c2.is_inline());
+        REQUIRE(c2 == 0);
+        for (const auto &m : boundary_values()) {
+            compact_integer c4{m};
+            c4 = c1;
+            REQUIRE(static_cast<int_t>(c4) == n);
+            check_canonical(c4);
+            compact_integer c5{m};
+            c5 = std::move(c4);
+            REQUIRE(static_cast<int_t>(c5) == n);
+        }
+        // Self assignment.
+        c3 = *&c3;
+        REQUIRE(static_cast<int_t>(c3) == n);
+        c3 = std::move(c3);
+        REQUIRE(static_cast<int_t>(c3) == n);
+    }
+}
+
+TEST_CASE("compact_integer arithmetic")
+{
+    auto check = [](const int_t &a, const int_t &b) {
+        const compact_integer ca{a}, cb{b};
+        REQUIRE(static_cast<int_t>(ca + cb) == a + b);
+        check_canonical(ca + cb);
+        REQUIRE(static_cast<int_t>(ca - cb) == a - b);
+        check_canonical(ca - cb);
+        REQUIRE(static_cast<int_t>(ca * cb) == a * b);
+        check_canonical(ca * cb);
+        REQUIRE(static_cast<int_t>(-ca) == -a);
+        check_canonical(-ca);
+        if (b.sgn()) {
+            REQUIRE(static_cast<int_t>(ca / cb) == a / b);
+            check_canonical(ca / cb);
+            REQUIRE(static_cast<int_t>(ca % cb) == a % b);
+            check_canonical(ca % cb);
+        } else {
+            REQUIRE_THROWS_PREDICATE(ca / cb, zero_division_error, [](const zero_division_error &ex) {
+                return std::string(ex.what()) == "Integer division by zero";
+            });
+            REQUIRE_THROWS_AS(ca % cb, zero_division_error &);
+        }
+        REQUIRE((ca == cb) == (a == b));
+        REQUIRE((ca != cb) == (a != b));
+        REQUIRE((ca < cb) == (a < b));
+        REQUIRE((ca <= cb) == (a <= b));
+        REQUIRE((ca > cb) == (a > b));
+        REQUIRE((ca >= cb) == (a >= b));
+        // In-place operators, including aliasing.
+        auto c = ca;
+        c += cb;
+        REQUIRE(static_cast<int_t>(c) == a + b);
+        c -= cb;
+        REQUIRE(static_cast<int_t>(c) == a);
+        c *= cb;
+        REQUIRE(static_cast<int_t>(c) == a * b);
+        check_canonical(c);
+        c = ca;
+        c *= c;
+        REQUIRE(static_cast<int_t>(c) == a * a);
+        c = ca;
+        c -= c;
+        REQUIRE(c.is_inline());
+        REQUIRE(c == 0);
+        if (b.sgn()) {
+            c = ca;
+            c /= cb;
+            REQUIRE(static_cast<int_t>(c) == a / b);
+            check_canonical(c);
+            c = ca;
+            c %= cb;
+            REQUIRE(static_cast<int_t>(c) == a % b);
+            check_canonical(c);
+        } else {
+            c = ca;
+            REQUIRE_THROWS_AS(c /= cb, zero_division_error &);
+            REQUIRE_THROWS_AS(c %= cb, zero_division_error &);
+            REQUIRE(c == ca);
+        }
+        if (a.sgn()) {
+            c = ca;
+            c /= c;
+            REQUIRE(c == 1);
+            REQUIRE(c.is_inline());
+            c = ca;
+            c %= c;
+            REQUIRE(c == 0);
+            REQUIRE(c.is_inline());
+        }
+    };
+    const auto bv = boundary_values();
+    for (const auto &a : bv) {
+        for (const auto &b : bv) {
+            check(a, b);
+        }
+    }
+    for (int i = 0; i < ntries; ++i) {
+        check(random_int(), random_int());
+    }
+}
+
+TEST_CASE("compact_integer mixed")
+{
+    compact_integer c{10};
+    REQUIRE(c + 5 == 15);
+    REQUIRE(5 + c == 15);
+    REQUIRE(c - 15 == -5);
+    REQUIRE(15u - c == 5);
+    REQUIRE(c * -3 == -30);
+    REQUIRE(-3ll * c == -30);
+    REQUIRE(c / 3 == 3);
+    REQUIRE(-31 / c == -3);
+    REQUIRE(c % 3 == 1);
+    REQUIRE(-31 % c == -1);
+    REQUIRE(c == 10);
+    REQUIRE(10 == c);
+    REQUIRE(c != 11);
+    REQUIRE(c < 11ull);
+    REQUIRE(9 < c);
+    REQUIRE(c <= 10);
+    REQUIRE(c > -1);
+    REQUIRE(c >= 10);
+    c += 5;
+    REQUIRE(c == 15);
+    c -= 20;
+    REQUIRE(c == -5);
+    c *= std::numeric_limits<long long>::min();
+    REQUIRE(!c.is_inline());
+    REQUIRE(static_cast<int_t>(c) == int_t{std::numeric_limits<long long>::min()} * -5);
+    REQUIRE_THROWS_AS(c / 0, zero_division_error &);
+    c /= -5;
+    REQUIRE(c == std::numeric_limits<long long>::min());
+    c /= 1ll << 62;
+    REQUIRE(c == -2);
+    REQUIRE(c.is_inline());
+    c = compact_integer{-31};
+    c %= 10u;
+    REQUIRE(c == -1);
+    REQUIRE_THROWS_AS(c %= 0, zero_division_error &);
+}
@@ -0,0 +1,364 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <functional>
+#include <gmp.h>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include <mp++/config.hpp>
+#include <mp++/fixed_integer.hpp>
+#include <mp++/integer.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+static int ntries = 1000;
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static std::mt19937 rng;
+
+template <typename T, typename U>
+using add_t = decltype(std::declval<const T &>() + std::declval<const U &>());
+
+template <typename T, typename U, typename = void>
+struct has_add : std::false_type {
+};
+
+template <typename T, typename U>
+struct has_add<T, U, decltype(void(std::declval<const T &>() + std::declval<const U &>()))> : std::true_type {
+};
+
+struct basic_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using fint = fixed_integer<S::value>;
+        using integer = integer<S::value>;
+        fint n;
+        REQUIRE(n.is_zero());
+        REQUIRE(n.sgn() == 0);
+        REQUIRE(n.size() == 0u);
+        REQUIRE(n.to_string() == "0");
+        REQUIRE(fint{42}.to_string() == "42");
+        REQUIRE(fint{-42}.to_string() == "-42");
+        REQUIRE(fint{"-123"}.to_string() == "-123");
+        REQUIRE(fint{std::string("255")}.to_string(16) == "ff");
+        REQUIRE(fint{integer{-7}}.to_string() == "-7");
+        REQUIRE(fint{1.5}.to_string() == "1");
+        REQUIRE(static_cast<int>(fint{-42}) == -42);
+        REQUIRE(static_cast<double>(fint{-42}) == -42.);
+        REQUIRE(static_cast<bool>(fint{3}));
+        REQUIRE(!static_cast<bool>(fint{}));
+        REQUIRE(static_cast<integer>(fint{-42}) == -42);
+        REQUIRE(fint{-42}.to_integer().is_static());
+        REQUIRE(fint{true}.to_string() == "1");
+        REQUIRE(fint{false}.is_zero());
+        REQUIRE(fint{'a'}.to_string() == std::to_string(int('a')));
+        REQUIRE(fint{std::numeric_limits<long long>::min()}.to_string()
+                == std::to_string(std::numeric_limits<long long>::min()));
+        REQUIRE(fint{std::numeric_limits<unsigned long long>::max()}.to_string()
+                == std::to_string(std::numeric_limits<unsigned long long>::max()));
+        REQUIRE(fint{static_cast<signed char>(-128)}.to_string() == "-128");
+        REQUIRE(fint{-42}.sgn() == -1);
+        REQUIRE(sgn(fint{42}) == 1);
+        REQUIRE(fint{-42}.abs() == 42);
+        REQUIRE(abs(fint{-42}) == 42);
+        REQUIRE(neg(fint{-42}) == 42);
+        REQUIRE(fint{-42}.neg() == 42);
+        REQUIRE(-fint{42} == -42);
+        REQUIRE(+fint{42} == 42);
+        std::ostringstream oss;
+        oss << fint{-1234};
+        REQUIRE(oss.str() == "-1234");
+        // Largest representable value.
+        integer max_val{1};
+        max_val <<= S::value * unsigned(GMP_NUMB_BITS);
+        --max_val;
+        REQUIRE(fint{max_val}.to_integer() == max_val);
+        REQUIRE(fint{max_val}.to_integer().is_static());
+        REQUIRE(fint{-max_val}.to_integer() == -max_val);
+        REQUIRE(fint{max_val}.size() == S::value);
+        // Size queries.
+        REQUIRE(fint{}.nbits() == 0u);
+        REQUIRE(fint{-1}.nbits() == 1u);
+        REQUIRE(fint{255}.nbits() == 8u);
+        REQUIRE(fint{max_val}.nbits() == S::value * unsigned(GMP_NUMB_BITS));
+        REQUIRE(fint{}.to_string_size() == 1u);
+        REQUIRE(fint{-1}.to_string_size() == 2u);
+        for (int base = 2; base <= 62; ++base) {
+            REQUIRE(fint{max_val}.to_string_size(base) == max_val.to_string(base).size());
+            REQUIRE(fint{-max_val}.to_string_size(base) == (-max_val).to_string(base).size());
+        }
+        REQUIRE_THROWS_PREDICATE(fint{}.to_string_size(1), std::invalid_argument, [](const std::invalid_argument &ia) {
+            return ia.what()
+                   == std::string("Invalid base for string conversion: the base must be between 2 and 62, but a value "
+                                  "of 1 was provided instead");
+        });
+        REQUIRE_THROWS_PREDICATE(fint{}.to_string_size(63), std::invalid_argument,
+                                 [](const std::invalid_argument &) { return true; });
+        REQUIRE_THROWS_PREDICATE(fint{max_val + 1}, std::overflow_error, [&max_val](const std::overflow_error &oe) {
+            return oe.what()
+                   == "The value " + (max_val + 1).to_string() + " does not fit in a fixed_integer with "
+                          + std::to_string(S::value) + " limb(s)";
+        });
+        REQUIRE_THROWS_PREDICATE(fint{(max_val + 1).to_string()}, std::overflow_error,
+                                 [](const std::overflow_error &) { return true; });
+        REQUIRE_THROWS_PREDICATE(static_cast<int>(fint{max_val}), std::overflow_error,
+                                 [](const std::overflow_error &) { return true; });
+        // Type traits.
+        REQUIRE((!std::is_constructible<fint, fixed_integer<S::value + 1u>>::value));
+        REQUIRE((!std::is_convertible<int, fint>::value));
+        REQUIRE((!std::is_convertible<fint, int>::value));
+        REQUIRE((has_add<fint, fint>::value));
+        REQUIRE((has_add<fint, int>::value));
+        REQUIRE((has_add<unsigned long long, fint>::value));
+        REQUIRE((!has_add<fint, double>::value));
+        REQUIRE((!has_add<fint, integer>::value));
+        REQUIRE((!has_add<fint, fixed_integer<S::value + 1u>>::value));
+        REQUIRE((std::is_same<add_t<fint, char>, fint>::value));
+    }
+};
+
+TEST_CASE("fixed_integer basic")
+{
+    tuple_for_each(sizes{}, basic_tester{});
+}
+
+struct arith_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using fint = fixed_integer<S::value>;
+        using integer = integer<S::value>;
+        integer max_val{1};
+        max_val <<= S::value * unsigned(GMP_NUMB_BITS);
+        --max_val;
+        const fint fmax{max_val};
+        // Overflow reporting.
+        fint r{5};
+        REQUIRE_THROWS_PREDICATE(add(r, fmax, fint{1}), std::overflow_error, [](const std::overflow_error &oe) {
+            return oe.what()
+                   == "Overflow in the addition of fixed_integer values: the result does not fit in "
+                          + std::to_string(S::value) + " limb(s)";
+        });
+        REQUIRE(r.is_zero());
+        REQUIRE_THROWS_PREDICATE(fmax - (-fmax), std::overflow_error, [](const std::overflow_error &oe) {
+            return oe.what()
+                   == "Overflow in the subtraction of fixed_integer values: the result does not fit in "
+                          + std::to_string(S::value) + " limb(s)";
+        });
+        REQUIRE_THROWS_PREDICATE(fmax * 2, std::overflow_error, [](const std::overflow_error &oe) {
+            return oe.what()
+                   == "Overflow in the multiplication of fixed_integer values: the result does not fit in "
+                          + std::to_string(S::value) + " limb(s)";
+        });
+        REQUIRE_THROWS_PREDICATE(fmax << 1, std::overflow_error, [](const std::overflow_error &oe) {
+            return oe.what()
+                   == "Overflow in the left shift of fixed_integer values: the result does not fit in "
+                          + std::to_string(S::value) + " limb(s)";
+        });
+        r = fint{3};
+        REQUIRE_THROWS_PREDICATE(r *= fmax, std::overflow_error, [](const std::overflow_error &) { return true; });
+        REQUIRE(r.is_zero());
+        REQUIRE_THROWS_PREDICATE(fint{1} << -1, std::overflow_error, [](const std::overflow_error &) { return true; });
+        REQUIRE((fint{} << std::numeric_limits<unsigned long>::max()).is_zero());
+        REQUIRE(fmax + (-fmax) == 0);
+        REQUIRE(fmax - fmax == 0);
+        REQUIRE(fmax * 1 == fmax);
+        REQUIRE((fmax >> 1) << 1 == fmax - 1);
+        REQUIRE(fmax / fmax == 1);
+        REQUIRE(fmax % 2 == 1);
+        // Division errors.
+        REQUIRE_THROWS_PREDICATE(fmax / 0, zero_division_error, [](const zero_division_error &zde) {
+            return zde.what() == std::string("Integer division by zero");
+        });
+        REQUIRE_THROWS_PREDICATE(tdiv_qr(r, r, fmax, fmax), std::invalid_argument,
+                                 [](const std::invalid_argument &ia) {
+                                     return ia.what()
+                                            == std::string("When performing a division with remainder, the quotient "
+                                                           "'q' and the remainder 'r' must be distinct objects");
+                                 });
+        // Mixed-mode operators and comparisons.
+        r = fint{10};
+        r += 5;
+        REQUIRE(r == 15);
+        r -= 20;
+        REQUIRE(r == -5);
+        r *= -3;
+        REQUIRE(r == 15);
+        r /= 4;
+        REQUIRE(r == 3);
+        r = fint{-17};
+        r %= 5;
+        REQUIRE(r == -2);
+        r <<= 10;
+        REQUIRE(r == -2048);
+        r >>= 3;
+        REQUIRE(r == -256);
+        REQUIRE(3 + fint{4} == 7);
+        REQUIRE(3 - fint{4} == -1);
+        REQUIRE(3 * fint{4} == 12);
+        REQUIRE(13 / fint{4} == 3);
+        REQUIRE(13 % fint{4} == 1);
+        REQUIRE(fint{4} != 3);
+        REQUIRE(3 != fint{4});
+        REQUIRE(3 < fint{4});
+        REQUIRE(fint{4} <= 4);
+        REQUIRE(fint{5} > 4u);
+        REQUIRE(4ll >= fint{4});
+        REQUIRE(cmp(fint{-4}, fint{4}) < 0);
+        // Random testing against integer.
+        std::uniform_int_distribution<int> sdist(0, 1);
+        std::uniform_int_distribution<unsigned> shdist(0, unsigned(GMP_NUMB_BITS) * 2u);
+        std::uniform_int_distribution<int> bdist(2, 62);
+        mpz_raii tmp;
+        fint f1, f2, f3, f4;
+        auto check = [&](const integer &res, const std::function<void()> &f) {
+            if (res.size() <= S::value) {
+                f();
+                REQUIRE(f3.to_integer() == res);
+            } else {
+                REQUIRE_THROWS_PREDICATE(f(), std::overflow_error, [](const std::overflow_error &) { return true; });
+                REQUIRE(f3.is_zero());
+            }
+        };
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+        // The kernels used in constant expressions can be called at runtime as well,
+        // check them against integer.
+        static_int<S::value> st;
+        auto check_ce = [&st](const integer &res, bool ok) {
+            if (res.size() <= S::value) {
+                REQUIRE(ok);
+                const auto v = st.get_mpz_view();
+                REQUIRE(integer{&v} == res);
+                REQUIRE(st.dtor_checks());
+            } else {
+                REQUIRE(!ok);
+            }
+        };
+#endif
+        auto random_xy = [&](unsigned x, unsigned y) {
+            for (int i = 0; i < ntries; ++i) {
+                random_integer(tmp, x, rng);
+                integer n1{mpz_to_str(&tmp.m_mpz)};
+                random_integer(tmp, y, rng);
+                integer n2{mpz_to_str(&tmp.m_mpz)};
+                if (sdist(rng)) {
+                    n1.neg();
+                }
+                if (sdist(rng)) {
+                    n2.neg();
+                }
+                f1 = fint{n1};
+                f2 = fint{n2};
+                check(n1 + n2, [&]() { add(f3, f1, f2); });
+                check(n1 - n2, [&]() { sub(f3, f1, f2); });
+                check(n1 * n2, [&]() { mul(f3, f1, f2); });
+                const auto s = shdist(rng);
+                check(n1 << s, [&]() { mul_2exp(f3, f1, s); });
+                tdiv_q_2exp(f3, f1, s);
+                REQUIRE(f3.to_integer() == n1 >> s);
+                if (n2.sgn()) {
+                    tdiv_qr(f3, f4, f1, f2);
+                    REQUIRE(f3.to_integer() == n1 / n2);
+                    REQUIRE(f4.to_integer() == n1 % n2);
+                }
+                const auto base = bdist(rng);
+                REQUIRE(f1.to_string_size(base) == n1.to_string(base).size());
+                REQUIRE(f1.nbits() == n1.nbits());
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+                check_ce(n1 + n2, fixed_integer_ce_addsub<true>(st, f1._get_static_int(), f2._get_static_int()));
+                check_ce(n1 - n2, fixed_integer_ce_addsub<false>(st, f1._get_static_int(), f2._get_static_int()));
+                check_ce(n1 * n2, fixed_integer_ce_mul(st, f1._get_static_int(), f2._get_static_int()));
+                check_ce(n1 << s, fixed_integer_ce_mul_2exp(st, f1._get_static_int(), s));
+                fixed_integer_ce_tdiv_q_2exp(st, f1._get_static_int(), s);
+                check_ce(n1 >> s, true);
+                REQUIRE(fixed_integer_ce_cmp(f1._get_static_int(), f2._get_static_int()) == cmp(n1, n2));
+                check_ce(n1 + n1, fixed_integer_ce_addsub<true>(st, f1._get_static_int(), f1._get_static_int()));
+#endif
+                REQUIRE((f1 < f2) == (n1 < n2));
+                REQUIRE((f1 == f2) == (n1 == n2));
+                REQUIRE(cmp(f1, f2) == cmp(n1, n2));
+                // Overlapping arguments.
+                f3 = f1;
+                check(n1 + n1, [&]() { add(f3, f3, f3); });
+                f3 = f1;
+                check(n1 * n1, [&]() { mul(f3, f3, f3); });
+            }
+        };
+        for (unsigned x = 0; x <= S::value; ++x) {
+            for (unsigned y = 0; y <= S::value; ++y) {
+                random_xy(x, y);
+            }
+        }
+    }
+};
+
+TEST_CASE("fixed_integer arith")
+{
+    tuple_for_each(sizes{}, arith_tester{});
+}
+
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+
+// Constants computed at compile time.
+constexpr auto m127 = (fixed_integer<2>{1} << 127) - 1;
+
+static_assert(m127.nbits() == 127u, "");
+static_assert(m127.to_string_size() == 39u, "");
+static_assert(m127.to_string_size(2) == 127u, "");
+static_assert((-m127).to_string_size(16) == 33u, "");
+static_assert(m127 > 0 && -m127 < 0 && m127 != -m127, "");
+static_assert(m127 - m127 == 0, "");
+static_assert(m127 + (-m127) == 0, "");
+static_assert((m127 + 1) >> 127 == 1, "");
+static_assert((m127 >> 100) == (1 << 27) - 1, "");
+static_assert(-m127 >> 126 == -1, "");
+static_assert(cmp(m127, m127 - 1) > 0, "");
+
+static constexpr fixed_integer<2> test_constexpr_pow()
+{
+    fixed_integer<2> retval{1};
+    for (int i = 0; i < 80; ++i) {
+        retval *= 3;
+    }
+    return retval;
+}
+
+constexpr auto p3_80 = test_constexpr_pow();
+
+static_assert(p3_80 < m127, "");
+static_assert(p3_80.to_string_size() == 39u, "");
+static_assert(p3_80 * -1 == -p3_80, "");
+
+#endif
+
+TEST_CASE("fixed_integer constexpr")
+{
+#if defined(MPPP_HAVE_CONSTEXPR_FIXED_INTEGER)
+    REQUIRE(m127.to_integer() == (integer<2>{1} << 127) - 1);
+    REQUIRE(m127.to_string() == "170141183460469231731687303715884105727");
+    REQUIRE(p3_80.to_string() == "147808829414345923316083210206383297601");
+    REQUIRE(p3_80.to_integer().is_static());
+#endif
+}
@@ -378,7 +378,12 @@ struct mul_tester {
         using integer = integer<S::value>;
         integer n1{1}, n2{-2};
         REQUIRE((lex_cast(n1 * n2) == "-2"));
+#if defined(MPPP_ENABLE_EXPRESSION_TEMPLATES)
+        // The product of two lvalues is lazy.
+        REQUIRE((std::is_same<decltype(n1 * n2), integer_mul_expr<S::value>>::value));
+#else
         REQUIRE((std::is_same<decltype(n1 * n2), integer>::value));
+#endif
         REQUIRE((lex_cast(n1 * char(4)) == "4"));
         REQUIRE((lex_cast(char(4) * n2) == "-8"));
         REQUIRE((std::is_same<decltype(n1 * char(4)), integer>::value));
@@ -813,6 +818,82 @@ TEST_CASE("mod")
     tuple_for_each(sizes{}, mod_tester{});
 }
 
+struct rvalue_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        // Operators with rvalue operands.
+        const integer big{"123456789012345678901234567890123456789012345678901234567890"}, n{-42};
+        REQUIRE((std::is_same<decltype(integer{} + integer{}), integer>::value));
+        REQUIRE((std::is_same<decltype(integer{} + 1), integer>::value));
+        REQUIRE((std::is_same<decltype(1 - integer{}), integer>::value));
+        REQUIRE((std::is_same<decltype(integer{} * 1.), double>::value));
+        REQUIRE((std::is_same<decltype(-integer{}), integer>::value));
+        REQUIRE(integer{big} + n == big + n);
+        REQUIRE(n + integer{big} == big + n);
+        REQUIRE(integer{big} + integer{n} == big + n);
+        REQUIRE(integer{big} + 1 == big + 1);
+        REQUIRE(1ull + integer{big} == big + 1);
+        REQUIRE(integer{big} + 1. == static_cast<double>(big) + 1.);
+        REQUIRE(integer{big} - n == big - n);
+        REQUIRE(n - integer{big} == n - big);
+        REQUIRE(integer{big} - integer{n} == big - n);
+        REQUIRE(integer{n} - integer{big} == n - big);
+        REQUIRE(integer{big} - 1 == big - 1);
+        REQUIRE(1 - integer{big} == 1 - big);
+        REQUIRE(integer{big} * n == big * n);
+        REQUIRE(n * integer{big} == big * n);
+        REQUIRE(integer{big} * integer{n} == big * n);
+        REQUIRE(integer{big} * -3 == big * -3);
+        REQUIRE(-3 * integer{big} == big * -3);
+        REQUIRE(integer{big} / n == big / n);
+        REQUIRE(integer{big} / integer{n} == big / n);
+        REQUIRE(integer{big} / 7u == big / 7u);
+        REQUIRE(integer{big} % n == big % n);
+        REQUIRE(integer{big} % integer{n} == big % n);
+        REQUIRE(integer{big} % 7 == big % 7);
+        REQUIRE(-integer{big} == -big);
+        REQUIRE(+integer{big} == big);
+        REQUIRE(big * n + n * big - big == 2 * big * n - big);
+        REQUIRE_THROWS_PREDICATE(integer{big} / 0, zero_division_error, [](const zero_division_error &ex) {
+            return std::string(ex.what()) == "Integer division by zero";
+        });
+        REQUIRE_THROWS_PREDICATE(integer{big} % integer{}, zero_division_error,
+                                 [](const zero_division_error &ex) {
+                                     return std::string(ex.what()) == "Integer division by zero";
+                                 });
+        // The storage of the rvalue operand is reused.
+        integer tmp{big};
+        tmp.promote();
+        const auto ptr = tmp._get_union().g_dy()._mp_d;
+        auto res = -std::move(tmp);
+        REQUIRE(res == -big);
+        REQUIRE(!res.is_static());
+        REQUIRE(res._get_union().g_dy()._mp_d == ptr);
+        res = +std::move(res);
+        REQUIRE(res._get_union().g_dy()._mp_d == ptr);
+        res = 1 - std::move(res);
+        REQUIRE(res == big + 1);
+        // Aliasing between the operands.
+        integer c{7};
+        REQUIRE(c - std::move(c) == 0);
+        c = big;
+        REQUIRE(c - std::move(c) == 0);
+        c = big;
+        REQUIRE(std::move(c) - c == 0);
+        c = big;
+        REQUIRE(c + std::move(c) == 2 * big);
+        c = big;
+        REQUIRE(c * std::move(c) == big * big);
+    }
+};
+
+TEST_CASE("rvalue")
+{
+    tuple_for_each(sizes{}, rvalue_tester{});
+}
+
 struct rel_tester {
     template <typename S>
     void operator()(const S &) const
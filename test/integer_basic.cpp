@@ -198,6 +198,44 @@ struct fp_ctor_tester {
             t3.join();
             REQUIRE(!fail.load());
             mt_rng_seed += 4u;
+            check_large_values<Float>();
+        }
+        // Check construction from large and tiny values against mpz_set_d().
+        template <typename Float, enable_if_t<!std::is_same<Float, long double>::value, int> = 0>
+        void check_large_values() const
+        {
+            using integer = integer<S::value>;
+            mpz_raii m;
+            auto cmp_mpz = [&m](Float x) {
+                ::mpz_set_d(&m.m_mpz, static_cast<double>(x));
+                return lex_cast(integer{x}) == mpz_to_str(&m.m_mpz);
+            };
+            REQUIRE(lex_cast(integer{std::numeric_limits<Float>::denorm_min()}) == "0");
+            REQUIRE(lex_cast(integer{-std::numeric_limits<Float>::min()}) == "0");
+            REQUIRE(lex_cast(integer{Float(-0.)}) == "0");
+            REQUIRE(lex_cast(integer{Float(0.999)}) == "0");
+            REQUIRE(lex_cast(integer{Float(-0.999)}) == "0");
+            REQUIRE(cmp_mpz(std::numeric_limits<Float>::max()));
+            REQUIRE(cmp_mpz(std::numeric_limits<Float>::lowest()));
+            // Powers of two and neighbouring values, crossing the limb boundaries.
+            for (int e = 0; e < std::numeric_limits<Float>::max_exponent; ++e) {
+                const auto p2 = std::ldexp(Float(1), e);
+                REQUIRE(cmp_mpz(p2));
+                REQUIRE(cmp_mpz(-p2));
+                REQUIRE(cmp_mpz(std::nextafter(p2, Float(0))));
+                REQUIRE(cmp_mpz(-std::nextafter(p2, Float(0))));
+                REQUIRE(cmp_mpz(p2 * Float(1.75)));
+            }
+            // Random values with random exponents.
+            std::uniform_real_distribution<Float> dist(Float(-1), Float(1));
+            std::uniform_int_distribution<int> edist(0, std::numeric_limits<Float>::max_exponent - 1);
+            for (auto i = 0; i < ntries; ++i) {
+                REQUIRE(cmp_mpz(std::ldexp(dist(rng), edist(rng))));
+            }
+        }
+        template <typename Float, enable_if_t<std::is_same<Float, long double>::value, int> = 0>
+        void check_large_values() const
+        {
         }
     };
     template <typename S>
@@ -1021,6 +1059,64 @@ struct fp_convert_tester {
             t3.join();
             REQUIRE(!fail.load());
             mt_rng_seed += 4u;
+            check_large_values<Float>();
+        }
+        // Check conversion of large values to Float against mpz_get_d().
+        template <typename Float, enable_if_t<!std::is_same<Float, long double>::value, int> = 0>
+        void check_large_values() const
+        {
+            using integer = integer<S::value>;
+            mpz_raii m;
+            // Check that n converts exactly to x.
+            auto exact = [](const integer &n, Float x) {
+                Float rop(0);
+                return static_cast<Float>(n) == x && get(rop, n) && rop == x && n.get(rop) && rop == x;
+            };
+            // Check the conversion of n against the conversion performed by GMP. Single-limb values
+            // are converted directly from the limb.
+            auto cmp_mpz = [&m](const integer &n) {
+                ::mpz_set_str(&m.m_mpz, lex_cast(n).c_str(), 10);
+                auto ref = static_cast<Float>(::mpz_get_d(&m.m_mpz));
+                if (std::numeric_limits<Float>::is_iec559 && ::mpz_size(&m.m_mpz) == 1u) {
+                    ref = static_cast<Float>(::mpz_getlimbn(&m.m_mpz, 0) & GMP_NUMB_MASK);
+                    ref = mpz_sgn(&m.m_mpz) < 0 ? -ref : ref;
+                }
+                Float rop(0);
+                return static_cast<Float>(n) == ref && get(rop, n) && rop == ref;
+            };
+            REQUIRE(exact(integer{std::numeric_limits<Float>::max()}, std::numeric_limits<Float>::max()));
+            REQUIRE(exact(integer{std::numeric_limits<Float>::lowest()}, std::numeric_limits<Float>::lowest()));
+            REQUIRE(cmp_mpz(integer{std::numeric_limits<Float>::max()} - 1));
+            REQUIRE(cmp_mpz(integer{std::numeric_limits<Float>::lowest()} + 1));
+            // Powers of two and neighbouring values, crossing the limb boundaries.
+            for (int e = 0; e < std::numeric_limits<Float>::max_exponent; ++e) {
+                const auto p2 = std::ldexp(Float(1), e);
+                REQUIRE(exact(integer{p2}, p2));
+                REQUIRE(exact(integer{-p2}, -p2));
+                if (e >= std::numeric_limits<Float>::digits) {
+                    REQUIRE(exact(integer{std::nextafter(p2, Float(0))}, std::nextafter(p2, Float(0))));
+                    REQUIRE(exact(integer{p2 * Float(1.75)}, p2 * Float(1.75)));
+                }
+                // Values which are not representable exactly.
+                REQUIRE(cmp_mpz(integer{p2} + 1));
+                REQUIRE(cmp_mpz(integer{p2} - 1));
+                REQUIRE(cmp_mpz(-integer{p2} - 1));
+            }
+            // Random values with random bit sizes, up to the largest finite power of two.
+            const auto nlimbs = static_cast<unsigned>(std::numeric_limits<Float>::max_exponent / GMP_NUMB_BITS + 1);
+            std::uniform_int_distribution<int> edist(1, std::numeric_limits<Float>::max_exponent - 1);
+            mpz_raii r;
+            for (auto i = 0; i < ntries; ++i) {
+                random_integer(r, nlimbs, rng);
+                ::mpz_fdiv_r_2exp(&r.m_mpz, &r.m_mpz, static_cast<::mp_bitcnt_t>(edist(rng)));
+                const integer n{&r.m_mpz};
+                REQUIRE(cmp_mpz(n));
+                REQUIRE(cmp_mpz(-n));
+            }
+        }
+        template <typename Float, enable_if_t<std::is_same<Float, long double>::value, int> = 0>
+        void check_large_values() const
+        {
         }
     };
     template <typename S>
@@ -11,8 +11,11 @@
 #include <limits>
 #include <random>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include <mp++/integer.hpp>
 
@@ -70,9 +73,84 @@ struct bin_tester {
             REQUIRE((lex_cast(n1) == lex_cast(m1)));
             REQUIRE((lex_cast(bin_ui(n2, k)) == lex_cast(m1)));
         }
+        // Around the size of the cache.
+        for (long n = -3; n < 135; ++n) {
+            ::mpz_set_si(&m2.m_mpz, n);
+            n2 = integer(n);
+            for (unsigned long k = 0; k < 140u; ++k) {
+                ::mpz_bin_ui(&m1.m_mpz, &m2.m_mpz, k);
+                bin_ui(n1, n2, k);
+                REQUIRE((lex_cast(n1) == lex_cast(m1)));
+                REQUIRE(n1.is_static() == (::mpz_size(&m1.m_mpz) <= S::value));
+            }
+        }
+        // Ranges.
+        REQUIRE(bin_ui_range(integer{10}, 0, 0).empty());
+        REQUIRE(bin_ui_range(integer{-10}, 4, 4).empty());
+        REQUIRE(bin_ui_range(integer{10}, 6, 3).empty());
+        auto check_range = [&m1, &m2](const integer &n, unsigned long kmin, unsigned long kmax) {
+            const auto r = bin_ui_range(n, kmin, kmax);
+            REQUIRE(r.size() == kmax - kmin);
+            ::mpz_set_str(&m2.m_mpz, n.to_string().c_str(), 10);
+            for (auto k = kmin; k != kmax; ++k) {
+                ::mpz_bin_ui(&m1.m_mpz, &m2.m_mpz, k);
+                REQUIRE((lex_cast(r[k - kmin]) == lex_cast(m1)));
+            }
+        };
+        check_range(integer{}, 0, 5);
+        check_range(integer{1}, 0, 5);
+        check_range(integer{20}, 0, 25);
+        check_range(integer{128}, 60, 135);
+        check_range(integer{129}, 0, 135);
+        check_range(integer{-1}, 0, 10);
+        check_range(integer{-20}, 3, 40);
+        check_range(integer{1000}, 0, 1001);
+        check_range(integer{1000}, 990, 1010);
+        check_range(integer{"123456789012345678901234567890"}, 0, 50);
+        check_range(integer{"-123456789012345678901234567890"}, 7, 50);
+        mpz_raii tmp;
+        for (int i = 0; i < ntries / 10; ++i) {
+            random_integer(tmp, static_cast<unsigned>(sdist(rng) + 1), rng);
+            auto n = integer(mpz_to_str(&tmp.m_mpz));
+            if (sdist(rng)) {
+                n.neg();
+            }
+            const auto kmin = kdist(rng);
+            check_range(n, kmin, kmin + kdist(rng));
+        }
     }
 };
 
+TEST_CASE("bin threads")
+{
+    // Grow the cache concurrently from several threads.
+    std::vector<std::thread> threads;
+    std::vector<int> ok(4, 0);
+    for (unsigned i = 0; i < 4u; ++i) {
+        threads.emplace_back([i, &ok]() {
+            mpz_raii m1, m2;
+            integer<2> n1;
+            bool res = true;
+            for (long j = 0; j < 130; ++j) {
+                const auto n = (i % 2u) ? j : 129 - j;
+                ::mpz_set_si(&m2.m_mpz, n);
+                for (unsigned long k = 0; k <= static_cast<unsigned long>(n); ++k) {
+                    ::mpz_bin_ui(&m1.m_mpz, &m2.m_mpz, k);
+                    bin_ui(n1, integer<2>{n}, k);
+                    res = res && lex_cast(n1) == lex_cast(m1);
+                }
+            }
+            ok[i] = res;
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (auto o : ok) {
+        REQUIRE(o);
+    }
+}
+
 TEST_CASE("bin")
 {
     tuple_for_each(sizes{}, bin_tester{});
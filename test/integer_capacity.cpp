@@ -0,0 +1,160 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <gmp.h>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include <mp++/integer.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static const std::size_t nb = unsigned(GMP_NUMB_BITS);
+
+struct capacity_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        integer n;
+        REQUIRE(n.capacity() == S::value * nb);
+        // Reserving within the static capacity does nothing.
+        n.reserve(0);
+        n.reserve(S::value * nb);
+        REQUIRE(n.is_static());
+        REQUIRE(n.capacity() == S::value * nb);
+        n = -42;
+        n.reserve(S::value * nb + 1u);
+        REQUIRE(n.is_dynamic());
+        REQUIRE(n == -42);
+        REQUIRE(n.capacity() >= (S::value + 1u) * nb);
+        // Enlarge the dynamic storage.
+        n.reserve(100u * nb - 3u);
+        REQUIRE(n.capacity() >= 100u * nb);
+        REQUIRE(n == -42);
+        const auto cap = n.capacity();
+        const auto ptr = n.get_mpz_t()->_mp_d;
+        // No reallocation until the reserved capacity is exhausted.
+        for (int i = 0; i < 90; ++i) {
+            mul_2exp(n, n, static_cast<::mp_bitcnt_t>(nb));
+        }
+        REQUIRE(n.get_mpz_t()->_mp_d == ptr);
+        REQUIRE(n.capacity() == cap);
+        // Never shrink.
+        n.reserve(1);
+        REQUIRE(n.capacity() == cap);
+        // Shrink to fit.
+        n = integer{"123456789012345678901234567890123456789012345678901234567890"};
+        n.promote();
+        n.reserve(100u * nb);
+        n.shrink_to_fit();
+        REQUIRE(n.is_dynamic());
+        REQUIRE(n.capacity() == n.size() * nb);
+        REQUIRE(n == integer{"123456789012345678901234567890123456789012345678901234567890"});
+        n.set_zero();
+        REQUIRE(n.is_static());
+        n.promote();
+        n.reserve(10u * nb);
+        n.shrink_to_fit();
+        REQUIRE(n.is_dynamic());
+        REQUIRE(n.capacity() == nb);
+        REQUIRE(n == 0);
+        // Static integers are not affected.
+        integer m{123};
+        m.shrink_to_fit();
+        REQUIRE(m.is_static());
+        REQUIRE(m == 123);
+        REQUIRE_THROWS_PREDICATE(m.reserve(std::numeric_limits<std::size_t>::max()), std::overflow_error,
+                                 [](const std::overflow_error &ex) {
+                                     return std::string(ex.what()).find("Cannot reserve ") == 0u;
+                                 });
+        REQUIRE(m.is_static());
+    }
+};
+
+TEST_CASE("integer capacity")
+{
+    tuple_for_each(sizes{}, capacity_tester{});
+}
+
+struct growth_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        // Run nsteps times the in-place operation f on n, which starts in static storage, and return the number of
+        // reallocations. Check that the storage is not reallocated when it can hold the largest possible result.
+        auto count_reallocs = [](integer &n, int nsteps, std::size_t extra_limbs, void (*f)(integer &)) {
+            REQUIRE(n.is_static());
+            std::size_t retval = 0;
+            const ::mp_limb_t *ptr = nullptr;
+            std::size_t cap = 0;
+            for (int i = 0; i < nsteps; ++i) {
+                const auto s = n.size();
+                f(n);
+                REQUIRE(n.capacity() >= n.size() * nb);
+                if (n.is_static()) {
+                    continue;
+                }
+                const auto new_ptr = n.get_mpz_t()->_mp_d;
+                if (ptr && (s + extra_limbs) * nb <= cap) {
+                    REQUIRE(new_ptr == ptr);
+                    REQUIRE(n.capacity() == cap);
+                }
+                if (new_ptr != ptr || n.capacity() != cap) {
+                    ++retval;
+                    ptr = new_ptr;
+                    cap = n.capacity();
+                }
+            }
+            return retval;
+        };
+        // Accumulation via +=, with the result growing one bit at a time.
+        integer n{1};
+        mul_2exp(n, n, static_cast<::mp_bitcnt_t>(S::value * nb - 1u));
+        const int nsteps = static_cast<int>(32u * nb);
+        auto nr = count_reallocs(n, nsteps, 1u, [](integer &m) { m += m; });
+        REQUIRE(n.size() == S::value + 32u);
+        // The storage is at least doubled at every reallocation: with an exact growth
+        // policy, there would be one reallocation per limb.
+        REQUIRE(nr <= 6u);
+        integer cmp{1};
+        mul_2exp(cmp, cmp, static_cast<::mp_bitcnt_t>(S::value * nb - 1u + static_cast<std::size_t>(nsteps)));
+        REQUIRE(n == cmp);
+        // Same with negative values and subtraction.
+        n = -1;
+        mul_2exp(n, n, static_cast<::mp_bitcnt_t>(S::value * nb - 1u));
+        nr = count_reallocs(n, nsteps, 1u, [](integer &m) { m -= -m; });
+        REQUIRE(nr <= 6u);
+        REQUIRE(n == -cmp);
+        // Products via *=, with the result growing a limb every few steps.
+        n = 1;
+        nr = count_reallocs(n, nsteps, 1u, [](integer &m) { m *= 3; });
+        REQUIRE(nr <= 6u);
+        REQUIRE(n == pow_ui(integer{3}, static_cast<unsigned long>(nsteps)));
+    }
+};
+
+TEST_CASE("integer growth")
+{
+    tuple_for_each(sizes{}, growth_tester{});
+}
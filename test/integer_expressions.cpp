@@ -0,0 +1,259 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#if !defined(MPPP_ENABLE_EXPRESSION_TEMPLATES)
+#define MPPP_ENABLE_EXPRESSION_TEMPLATES
+#endif
+
+#include <cstddef>
+#include <functional>
+#include <gmp.h>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+
+#include <mp++/mp++.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>>;
+
+static std::mt19937 rng;
+
+static const int ntries = 1000;
+
+struct expr_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        const integer a{"-123456789012345678901234567890"}, b{"987654321098765432109876543210"},
+            c{"-55555555555555555555555555555555555555"}, d{42}, e{-7};
+        // The reference values are computed with rvalue operands, which are never lazy.
+        const integer ab = integer{a} * b, cd = integer{c} * d;
+        REQUIRE((!std::is_same<decltype(a * b), integer>::value));
+        REQUIRE((std::is_convertible<decltype(a * b), integer>::value));
+        REQUIRE((std::is_convertible<decltype(a * b + c), integer>::value));
+        REQUIRE((std::is_same<decltype(integer{a} * b), integer>::value));
+        REQUIRE((std::is_same<decltype(a * 2), integer>::value));
+        integer r{1};
+        r = a * b;
+        REQUIRE(r == ab);
+        r = a * b + c;
+        REQUIRE(r == ab + c);
+        r = c + a * b;
+        REQUIRE(r == ab + c);
+        r = a * b - c;
+        REQUIRE(r == ab - c);
+        r = c - a * b;
+        REQUIRE(r == c - ab);
+        r = a * b + c * d;
+        REQUIRE(r == ab + cd);
+        r = a * b - c * d;
+        REQUIRE(r == ab - cd);
+        r = d * e + d;
+        REQUIRE(r == -252);
+        r = d * e - e * e;
+        REQUIRE(r == -343);
+        r += a * b;
+        REQUIRE(r == ab - 343);
+        r -= c * d;
+        REQUIRE(r == ab - cd - 343);
+        integer r2 = a * b + c;
+        REQUIRE(r2 == ab + c);
+        // Aliasing.
+        r = a;
+        r = r * b + c;
+        REQUIRE(r == ab + c);
+        r = c;
+        r = a * b + r;
+        REQUIRE(r == ab + c);
+        r = c;
+        r = r - a * b;
+        REQUIRE(r == c - ab);
+        r = a;
+        r = r * r - r * b;
+        REQUIRE(r == integer{a} * a - ab);
+        r = d;
+        r += r * r;
+        REQUIRE(r == 42 + 42 * 42);
+        r -= r * e;
+        REQUIRE(r == 8 * (42 + 42 * 42));
+        // The expressions which cannot be fused are materialised.
+        REQUIRE(a * b == ab);
+        REQUIRE(ab == a * b);
+        REQUIRE(a * b != c);
+        REQUIRE(a * b < c * d);
+        REQUIRE(a * b + c <= c * d);
+        REQUIRE(a * b > ab - 1);
+        REQUIRE(a * b >= ab);
+        REQUIRE(-(a * b) == -ab);
+        REQUIRE(+(a * b) == ab);
+        REQUIRE(a * b * c == ab * c);
+        REQUIRE(a * b + c + d == ab + c + d);
+        REQUIRE(a * b + 1 == ab + 1);
+        REQUIRE(2 * (a * b) == 2 * ab);
+        REQUIRE((a * b) / d == ab / d);
+        REQUIRE((a * b) % d == ab % d);
+        REQUIRE((d * e) << 2 == -1176);
+        REQUIRE((d * d) >> 1 == 882);
+        REQUIRE((a * b + c * d) * e == (ab + cd) * e);
+        REQUIRE((rational<S::value>{1, 2} + d * e == rational<S::value>{-587, 2}));
+        r = d;
+        r *= d * e;
+        REQUIRE(r == 42 * 42 * -7);
+        r /= d * e;
+        REQUIRE(r == 42);
+        r %= d * d + e;
+        REQUIRE(r == 42);
+        r += a * b + c;
+        REQUIRE(r == ab + c + 42);
+        std::ostringstream oss;
+        oss << d * e;
+        REQUIRE(oss.str() == "-294");
+        // The storage of a dynamic result is reused.
+        integer x{a}, y{b}, z{c};
+        x.promote();
+        y.promote();
+        z.promote();
+        r = integer{1} << 1000;
+        const auto ptr = r._get_union().g_dy()._mp_d;
+        r = x * y + z;
+        REQUIRE(r == ab + c);
+        REQUIRE(r._get_union().g_dy()._mp_d == ptr);
+        r -= x * y;
+        REQUIRE(r == c);
+        REQUIRE(r._get_union().g_dy()._mp_d == ptr);
+    }
+};
+
+TEST_CASE("integer expressions")
+{
+    tuple_for_each(sizes{}, expr_tester{});
+}
+
+struct expr_api_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using rational = rational<S::value>;
+        const integer a{"-123456789012345678901234567890"}, b{"987654321098765432109876543210"}, d{42}, e{-7};
+        const integer ab = integer{a} * b;
+        // The functions of the integer API accept expressions.
+        REQUIRE(gcd(a * b, a) == abs(a));
+        REQUIRE(gcd(d, d * e) == 42);
+        REQUIRE(abs(a * b) == -ab);
+        REQUIRE(neg(a * b) == -ab);
+        REQUIRE(sgn(a * b) == -1);
+        REQUIRE(!is_zero(a * b));
+        REQUIRE(is_one(d * d - (d * d - 1)));
+        REQUIRE(cmp(a * b, ab) == 0);
+        REQUIRE(sqrt(d * d) == 42);
+        REQUIRE(perfect_square_p(a * a));
+        REQUIRE(pow_ui(d * e, 2u) == 294 * 294);
+        REQUIRE(pow(d * e, 2) == 294 * 294);
+        REQUIRE(binomial(d * d, 2) == 1764 * 1763 / 2);
+        REQUIRE(divexact(a * b, b) == a);
+        REQUIRE(hash(a * b) == hash(ab));
+        REQUIRE(hash(a * b) == std::hash<integer>{}(a * b));
+        long l = 0;
+        REQUIRE(get(l, d * e));
+        REQUIRE(l == -294);
+        integer r, s;
+        mul(r, a * b, e);
+        REQUIRE(r == ab * e);
+        add(r, a * b, d * e);
+        REQUIRE(r == ab - 294);
+        tdiv_qr(r, s, a * b, d);
+        REQUIRE(r == ab / d);
+        REQUIRE(s == ab % d);
+        // Construction of rationals from expressions.
+        REQUIRE(rational{d * e} == -294);
+        REQUIRE((rational{d * e, 4} == rational{-147, 2}));
+        REQUIRE((rational{1, d * e} == rational{-1, 294}));
+        REQUIRE((rational{a * b, a * e} == rational{b, -7}));
+        REQUIRE((rational{d * e + d, d * d, false}.get_num() == -252));
+        REQUIRE((rational{a * b, a * e} + d * e == rational{b + 2058, -7}));
+    }
+};
+
+TEST_CASE("integer expressions api")
+{
+    tuple_for_each(sizes{}, expr_api_tester{});
+}
+
+struct expr_rational_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using rational = rational<S::value>;
+        // Check the rational arithmetic against GMP when the expression templates are enabled.
+        // The denominators share a random common factor, so that both the coprime and the
+        // non-coprime code paths of the addition and subtraction are exercised.
+        mpq_raii tmp, m1, m2, m3;
+        mpz_raii c;
+        std::uniform_int_distribution<int> sdist(0, 1);
+        auto random_xy = [&](unsigned x, unsigned y) {
+            for (int i = 0; i < ntries; ++i) {
+                random_integer(c, 1u, rng);
+                ::mpz_add_ui(&c.m_mpz, &c.m_mpz, 1u);
+                const integer f{&c.m_mpz};
+                random_rational(tmp, x, rng);
+                const rational n1{integer{mpq_numref(&tmp.m_mpq)}, integer{mpq_denref(&tmp.m_mpq)} * f};
+                ::mpz_mul(mpq_denref(&tmp.m_mpq), mpq_denref(&tmp.m_mpq), &c.m_mpz);
+                ::mpq_canonicalize(&tmp.m_mpq);
+                ::mpq_set(&m1.m_mpq, &tmp.m_mpq);
+                random_rational(tmp, y, rng);
+                rational n2{integer{mpq_numref(&tmp.m_mpq)}, integer{mpq_denref(&tmp.m_mpq)} * f};
+                ::mpz_mul(mpq_denref(&tmp.m_mpq), mpq_denref(&tmp.m_mpq), &c.m_mpz);
+                ::mpq_canonicalize(&tmp.m_mpq);
+                ::mpq_set(&m2.m_mpq, &tmp.m_mpq);
+                if (sdist(rng)) {
+                    ::mpq_neg(&m2.m_mpq, &m2.m_mpq);
+                    n2.neg();
+                }
+                ::mpq_add(&m3.m_mpq, &m1.m_mpq, &m2.m_mpq);
+                REQUIRE(lex_cast(n1 + n2) == lex_cast(m3));
+                ::mpq_sub(&m3.m_mpq, &m1.m_mpq, &m2.m_mpq);
+                REQUIRE(lex_cast(n1 - n2) == lex_cast(m3));
+                ::mpq_mul(&m3.m_mpq, &m1.m_mpq, &m2.m_mpq);
+                REQUIRE(lex_cast(n1 * n2) == lex_cast(m3));
+                if (mpq_sgn(&m2.m_mpq)) {
+                    ::mpq_div(&m3.m_mpq, &m1.m_mpq, &m2.m_mpq);
+                    REQUIRE(lex_cast(n1 / n2) == lex_cast(m3));
+                }
+            }
+        };
+
+        random_xy(0, 0);
+        random_xy(1, 0);
+        random_xy(0, 1);
+        random_xy(1, 1);
+        random_xy(2, 1);
+        random_xy(1, 2);
+        random_xy(2, 2);
+        random_xy(3, 2);
+        random_xy(3, 3);
+        random_xy(4, 4);
+    }
+};
+
+TEST_CASE("rational expressions")
+{
+    tuple_for_each(sizes{}, expr_rational_tester{});
+}
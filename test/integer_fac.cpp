@@ -11,8 +11,10 @@
 #include <random>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include <mp++/integer.hpp>
 
@@ -91,9 +93,61 @@ struct fac_tester {
             fac_ui(n1, x);
             REQUIRE((lex_cast(n1) == lex_cast(m1)));
         }
+        // Ranges.
+        REQUIRE(fac_ui_range<S::value>(0, 0).empty());
+        REQUIRE(fac_ui_range<S::value>(5, 5).empty());
+        REQUIRE(fac_ui_range<S::value>(6, 3).empty());
+        auto check_range = [&m1](unsigned long nmin, unsigned long nmax) {
+            const auto r = fac_ui_range<S::value>(nmin, nmax);
+            REQUIRE(r.size() == nmax - nmin);
+            for (auto n = nmin; n != nmax; ++n) {
+                ::mpz_fac_ui(&m1.m_mpz, n);
+                REQUIRE(::mpz_cmp(r[n - nmin].get_mpz_view(), &m1.m_mpz) == 0);
+                REQUIRE(r[n - nmin].is_static() == (::mpz_size(&m1.m_mpz) <= S::value));
+            }
+        };
+        check_range(0, 1);
+        check_range(0, 300);
+        check_range(250, 270);
+        check_range(1000, 1010);
+        // NOTE: the factorials near the limit have millions of digits, check only the last two.
+        check_range(999999ul, 1000001ul);
+        REQUIRE_THROWS_PREDICATE(fac_ui_range<S::value>(0, 1000002ul), std::invalid_argument,
+                                 [](const std::invalid_argument &ex) {
+                                     return std::string(ex.what())
+                                            == "The value 1000001 is too large to be used as input for the factorial "
+                                               "function (the maximum allowed value is 1000000)";
+                                 });
     }
 };
 
+TEST_CASE("fac threads")
+{
+    // Grow the cache concurrently from several threads.
+    std::vector<std::thread> threads;
+    std::vector<int> ok(4, 0);
+    for (unsigned i = 0; i < 4u; ++i) {
+        threads.emplace_back([i, &ok]() {
+            mpz_raii m;
+            integer<1> n;
+            bool res = true;
+            for (unsigned long j = 0; j < 300u; ++j) {
+                const auto x = (i % 2u) ? j : 299u - j;
+                ::mpz_fac_ui(&m.m_mpz, x);
+                fac_ui(n, x);
+                res = res && lex_cast(n) == lex_cast(m);
+            }
+            ok[i] = res;
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (auto o : ok) {
+        REQUIRE(o);
+    }
+}
+
 TEST_CASE("fac")
 {
     tuple_for_each(sizes{}, fac_tester{});
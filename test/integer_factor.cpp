@@ -0,0 +1,133 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <gmp.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mp++/integer.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+static int ntries = 100;
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static std::mt19937 rng;
+
+// Check that f is a valid prime factorisation of n.
+template <typename Int>
+static bool check_factorisation(const Int &n, const std::vector<std::pair<Int, unsigned long>> &f)
+{
+    Int prod{1};
+    for (decltype(f.size()) i = 0; i < f.size(); ++i) {
+        if (!f[i].first.probab_prime_p() || !f[i].second || (i && f[i - 1u].first >= f[i].first)) {
+            return false;
+        }
+        prod *= pow_ui(f[i].first, f[i].second);
+    }
+    return prod == abs(n);
+}
+
+struct factor_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using f_type = std::vector<std::pair<integer, unsigned long>>;
+        REQUIRE((std::is_same<f_type, decltype(factor(integer{}))>::value));
+        REQUIRE_THROWS_PREDICATE(factor(integer{}), std::invalid_argument, [](const std::invalid_argument &ex) {
+            return std::string(ex.what()) == "Cannot factor zero";
+        });
+        REQUIRE(factor(integer{1}).empty());
+        REQUIRE(factor(integer{-1}).empty());
+        REQUIRE((factor(integer{2}) == f_type{{integer{2}, 1u}}));
+        REQUIRE((factor(integer{-12}) == f_type{{integer{2}, 2u}, {integer{3}, 1u}}));
+        REQUIRE((factor(integer{1024}) == f_type{{integer{2}, 10u}}));
+        REQUIRE((factor(integer{1009} * 1009) == f_type{{integer{1009}, 2u}}));
+        REQUIRE((factor(integer{3 * 5 * 7 * 1013}) == f_type{{integer{3}, 1u}, {integer{5}, 1u}, {integer{7}, 1u},
+                                                             {integer{1013}, 1u}}));
+        // Products of two primes of given sizes (in bits), with random multiplicities.
+        auto random_prime = [](unsigned bits) {
+            std::uniform_int_distribution<unsigned long long> dist(0u, (1ull << (bits - 1u)) - 1u);
+            return nextprime(integer{dist(rng) | (1ull << (bits - 1u))});
+        };
+        std::uniform_int_distribution<unsigned> mdist(1u, 3u);
+        for (auto bits : {std::make_pair(10u, 20u), std::make_pair(20u, 20u), std::make_pair(31u, 32u),
+                          std::make_pair(40u, 60u), std::make_pair(32u, 63u), std::make_pair(25u, 25u)}) {
+            for (int i = 0; i < ntries / 10; ++i) {
+                auto p = random_prime(bits.first), q = random_prime(bits.second);
+                const auto mp = mdist(rng), mq = mdist(rng);
+                const auto n = pow_ui(p, mp) * pow_ui(q, mq);
+                const auto f = factor(n);
+                REQUIRE(check_factorisation(n, f));
+                REQUIRE(f.size() == (p == q ? 1u : 2u));
+            }
+        }
+        // Random single-limb values.
+        mpz_raii tmp;
+        for (int i = 0; i < ntries; ++i) {
+            random_integer(tmp, 1, rng);
+            if (!mpz_sgn(&tmp.m_mpz)) {
+                continue;
+            }
+            integer n{&tmp.m_mpz};
+            if (i % 2) {
+                n.neg();
+            }
+            REQUIRE(check_factorisation(n, factor(n)));
+        }
+        // Larger values, with at most one large prime factor.
+        for (int i = 0; i < ntries / 20; ++i) {
+            integer n{1};
+            for (unsigned bits : {10u, 20u, 25u, 30u, 35u}) {
+                n *= random_prime(bits);
+            }
+            random_integer(tmp, 2, rng);
+            n *= nextprime(integer{&tmp.m_mpz});
+            REQUIRE(check_factorisation(n, factor(n)));
+        }
+        // Perfect powers.
+        const auto p = random_prime(50);
+        REQUIRE((factor(pow_ui(p, 3)) == f_type{{p, 3u}}));
+        REQUIRE((factor(pow_ui(p * 7, 2)) == f_type{{integer{7}, 2u}, {p, 2u}}));
+    }
+};
+
+TEST_CASE("factor")
+{
+    tuple_for_each(sizes{}, factor_tester{});
+}
+
+#if defined(__SIZEOF_INT128__) && (GMP_NUMB_BITS == 64) && !GMP_NAIL_BITS
+
+TEST_CASE("squfof")
+{
+    // Check the SQUFOF fallback directly, on products of two primes.
+    for (auto pq : {std::make_pair(1000003ull, 1000033ull), std::make_pair(4294967291ull, 4294967279ull),
+                    std::make_pair(65537ull, 2147483647ull), std::make_pair(11ull, 1000000007ull)}) {
+        const auto d = limb_squfof(pq.first * pq.second);
+        REQUIRE((d == pq.first || d == pq.second));
+    }
+}
+
+#endif
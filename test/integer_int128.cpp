@@ -0,0 +1,145 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <mp++/integer.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace mppp;
+
+#if defined(MPPP_HAVE_INT128_INTEROP)
+
+using i128 = __int128_t;
+using u128 = __uint128_t;
+
+static const u128 u128_max = ~u128(0);
+static const i128 i128_max = static_cast<i128>(u128_max >> 1);
+static const i128 i128_min = -i128_max - 1;
+
+TEST_CASE("integer int128 construction")
+{
+    REQUIRE((std::is_constructible<integer<1>, i128>::value));
+    REQUIRE((std::is_constructible<integer<1>, u128>::value));
+    REQUIRE((!std::is_convertible<i128, integer<1>>::value));
+    REQUIRE((integer<1>{i128(0)} == 0));
+    REQUIRE((integer<1>{i128(0)}.is_static()));
+    REQUIRE((integer<1>{u128(0)}.size() == 0u));
+    REQUIRE((integer<1>{i128(42)} == 42));
+    REQUIRE((integer<1>{i128(-42)} == -42));
+    REQUIRE((integer<1>{u128(42)} == 42));
+    REQUIRE((integer<1>{u128(1) << 64} == integer<1>{"18446744073709551616"}));
+    REQUIRE((!integer<1>{u128(1) << 64}.is_static()));
+    REQUIRE((integer<2>{u128(1) << 64}.is_static()));
+    REQUIRE((integer<1>{u128_max} == integer<1>{"340282366920938463463374607431768211455"}));
+    REQUIRE((integer<2>{u128_max} == integer<2>{"340282366920938463463374607431768211455"}));
+    REQUIRE((integer<1>{i128_max} == integer<1>{"170141183460469231731687303715884105727"}));
+    REQUIRE((integer<1>{i128_min} == integer<1>{"-170141183460469231731687303715884105728"}));
+    REQUIRE((integer<2>{i128_min} == integer<2>{"-170141183460469231731687303715884105728"}));
+    REQUIRE((integer<2>{i128_min}.is_static()));
+    REQUIRE((integer<3>{-(i128(1) << 64)} == integer<3>{"-18446744073709551616"}));
+    REQUIRE((integer<1>{-(i128(1) << 64)}.size() == 2u));
+}
+
+TEST_CASE("integer int128 conversion")
+{
+    REQUIRE((static_cast<i128>(integer<1>{}) == 0));
+    REQUIRE((static_cast<u128>(integer<1>{}) == 0u));
+    REQUIRE((static_cast<i128>(integer<1>{-42}) == -42));
+    REQUIRE((static_cast<u128>(integer<2>{42}) == 42u));
+    REQUIRE((static_cast<u128>(integer<1>{u128_max}) == u128_max));
+    REQUIRE((static_cast<u128>(integer<2>{u128_max}) == u128_max));
+    REQUIRE((static_cast<i128>(integer<1>{i128_max}) == i128_max));
+    REQUIRE((static_cast<i128>(integer<1>{i128_min}) == i128_min));
+    REQUIRE((static_cast<i128>(integer<2>{i128_min + 1}) == i128_min + 1));
+    REQUIRE((static_cast<i128>(integer<3>{-(i128(1) << 64)}) == -(i128(1) << 64)));
+    REQUIRE_THROWS_PREDICATE(static_cast<u128>(integer<1>{-1}), std::overflow_error, [](const std::overflow_error &ex) {
+        return std::string(ex.what()).find("Conversion of the integer -1 to the type") == 0u;
+    });
+    REQUIRE_THROWS_AS(static_cast<u128>(integer<1>{u128_max} + 1), std::overflow_error &);
+    REQUIRE_THROWS_AS(static_cast<i128>(integer<1>{i128_max} + 1), std::overflow_error &);
+    REQUIRE_THROWS_AS(static_cast<i128>(integer<2>{i128_min} - 1), std::overflow_error &);
+    REQUIRE_THROWS_AS(static_cast<i128>(integer<1>{u128_max}), std::overflow_error &);
+    REQUIRE_THROWS_AS(static_cast<i128>(-integer<1>{u128_max}), std::overflow_error &);
+}
+
+TEST_CASE("integer int128 comparison")
+{
+    REQUIRE((integer<1>{i128_min} == i128_min));
+    REQUIRE((i128_min == integer<1>{i128_min}));
+    REQUIRE((integer<1>{i128_min} != i128_max));
+    REQUIRE((integer<1>{i128_min} < i128_max));
+    REQUIRE((i128_min < integer<1>{i128_max}));
+    REQUIRE((integer<2>{u128_max} > i128_max));
+    REQUIRE((u128_max >= integer<2>{u128_max}));
+    REQUIRE((u128(1) <= integer<2>{u128_max}));
+    REQUIRE((integer<1>{-1} < u128(0)));
+}
+
+TEST_CASE("integer int128 arithmetic")
+{
+    REQUIRE((std::is_same<decltype(integer<1>{} + i128(0)), integer<1>>::value));
+    REQUIRE((std::is_same<decltype(u128(0) * integer<2>{}), integer<2>>::value));
+    REQUIRE((integer<1>{1} + u128_max == integer<1>{"340282366920938463463374607431768211456"}));
+    REQUIRE((u128_max + integer<1>{1} == integer<1>{"340282366920938463463374607431768211456"}));
+    REQUIRE((integer<1>{1} - i128_min == integer<1>{"170141183460469231731687303715884105729"}));
+    REQUIRE((i128_min - integer<1>{1} == integer<1>{"-170141183460469231731687303715884105729"}));
+    REQUIRE((integer<2>{2} * i128_min == integer<2>{"-340282366920938463463374607431768211456"}));
+    REQUIRE((i128_max * integer<2>{-1} == -i128_max));
+    REQUIRE((integer<1>{u128_max} / u128(1u << 16) == u128_max >> 16));
+    REQUIRE((u128_max / integer<1>{1 << 16} == u128_max >> 16));
+    REQUIRE((integer<1>{u128_max} % u128(10) == 5));
+    REQUIRE((i128_min % integer<1>{10} == -8));
+    integer<1> n{1};
+    n += u128_max;
+    REQUIRE((n == integer<1>{u128_max} + 1));
+    n -= i128_max;
+    REQUIRE((n == integer<1>{i128_max} + 2));
+    n *= i128(-2);
+    REQUIRE((n == -2 * (integer<1>{i128_max} + 2)));
+    n /= i128(-4);
+    REQUIRE((n == (integer<1>{i128_max} + 2) / 2));
+    n %= u128(1000);
+    REQUIRE((n == 864));
+    u128 u = 1;
+    u += integer<1>{41};
+    REQUIRE((u == 42u));
+    u *= integer<1>{u128(1) << 64};
+    REQUIRE((u == u128(42) << 64));
+    u /= integer<2>{u128(1) << 64};
+    REQUIRE((u == 42u));
+    u -= integer<1>{2};
+    REQUIRE((u == 40u));
+    u %= integer<1>{7};
+    REQUIRE((u == 5u));
+    i128 i = i128_min;
+    i += integer<1>{1};
+    REQUIRE((i == i128_min + 1));
+    REQUIRE_THROWS_AS(i -= integer<1>{2}, std::overflow_error &);
+    REQUIRE((i == i128_min + 1));
+    REQUIRE_THROWS_PREDICATE(integer<1>{1} / i128(0), zero_division_error, [](const zero_division_error &ex) {
+        return std::string(ex.what()) == "Integer division by zero";
+    });
+    REQUIRE((binomial(integer<1>{100}, u128(3)) == 161700));
+    REQUIRE((binomial(i128(100), integer<1>{3}) == 161700));
+}
+
+#else
+
+TEST_CASE("integer int128 unavailable")
+{
+    REQUIRE((true));
+}
+
+#endif
@@ -0,0 +1,75 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <string>
+#include <type_traits>
+
+#include <mp++/config.hpp>
+#include <mp++/integer.hpp>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace mppp;
+
+#if MPPP_CPLUSPLUS >= 201402L
+
+template <char... Chars>
+using check_t = std::integral_constant<bool, integer_literal_check<Chars...>()>;
+
+TEST_CASE("integer literals")
+{
+    using namespace mppp::literals;
+    REQUIRE((std::is_same<decltype(0_z1), integer<1>>::value));
+    REQUIRE((std::is_same<decltype(0_z2), integer<2>>::value));
+    REQUIRE((std::is_same<decltype(0_z3), integer<3>>::value));
+    REQUIRE(0_z1 == 0);
+    REQUIRE((0_z1).is_static());
+    REQUIRE(1_z1 == 1);
+    REQUIRE(-1_z1 == -1);
+    REQUIRE(123_z1 == 123);
+    REQUIRE(18446744073709551615_z1 == integer<1>{"18446744073709551615"});
+    REQUIRE(18446744073709551616_z1 == integer<1>{"18446744073709551616"});
+    REQUIRE(123456789012345678901234567890_z1 == integer<1>{"123456789012345678901234567890"});
+    REQUIRE(-123456789012345678901234567890_z2 == integer<2>{"-123456789012345678901234567890"});
+    REQUIRE(123456789012345678901234567890_z3 == integer<3>{"123456789012345678901234567890"});
+    REQUIRE((123456789012345678901234567890_z3).is_static());
+    // A large value, which will need dynamic storage.
+    const auto big
+        = 1234567890123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890_z1;
+    REQUIRE(big
+            == integer<1>{"12345678901234567890123456789012345678901234567890"
+                          "12345678901234567890123456789012345678901234567890"});
+    REQUIRE(big.is_dynamic());
+    // Other bases.
+    REQUIRE(0x0_z1 == 0);
+    REQUIRE(0xff_z1 == 255);
+    REQUIRE(0XFF_z1 == 255);
+    REQUIRE((0xaBcDeF0123456789abcdef_z2 == integer<2>{"aBcDeF0123456789abcdef", 16}));
+    REQUIRE(0b0_z1 == 0);
+    REQUIRE(0b101_z1 == 5);
+    REQUIRE((0B1111111111111111111111111111111111111111111111111111111111111111111111_z2
+             == integer<2>{"1111111111111111111111111111111111111111111111111111111111111111111111", 2}));
+    REQUIRE(00_z1 == 0);
+    REQUIRE(017_z1 == 15);
+    REQUIRE((0777777777777777777777777777777_z2 == integer<2>{"777777777777777777777777777777", 8}));
+    // Digit separators.
+    REQUIRE(1'000'000_z1 == 1000000);
+    REQUIRE((0xffff'ffff'ffff'ffff'ffff_z2 == integer<2>{"ffffffffffffffffffff", 16}));
+    // Invalid literals.
+    REQUIRE((check_t<'1', '2', '3'>::value));
+    REQUIRE((check_t<'0'>::value));
+    REQUIRE((!check_t<'1', '.', '5'>::value));
+    REQUIRE((!check_t<'1', 'e', '5'>::value));
+    REQUIRE((!check_t<'0', 'x'>::value));
+    REQUIRE((!check_t<'0', 'b', '2'>::value));
+    REQUIRE((!check_t<'0', '8'>::value));
+    REQUIRE((!check_t<'0', 'x', '1', 'p', '3'>::value));
+}
+
+#endif
@@ -83,6 +83,17 @@ struct nextprime_tester {
         random_xy(2);
         random_xy(3);
         random_xy(4);
+        // Values around the limb boundaries.
+        for (auto b : {GMP_NUMB_BITS, 2 * GMP_NUMB_BITS}) {
+            for (unsigned long delta = 0; delta < 400u; delta += 7u) {
+                ::mpz_set_ui(&m2.m_mpz, 1u);
+                ::mpz_mul_2exp(&m2.m_mpz, &m2.m_mpz, static_cast<::mp_bitcnt_t>(b));
+                ::mpz_sub_ui(&m2.m_mpz, &m2.m_mpz, delta);
+                n2 = integer(mpz_to_str(&m2.m_mpz));
+                ::mpz_nextprime(&m1.m_mpz, &m2.m_mpz);
+                REQUIRE((lex_cast(nextprime(n2)) == lex_cast(m1)));
+            }
+        }
     }
 };
 
@@ -0,0 +1,313 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <gmp.h>
+#include <limits>
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/integer.hpp>
+#include <mp++/parallel.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+static int ntries = 10;
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static std::mt19937 rng;
+
+TEST_CASE("parallel utils")
+{
+    REQUIRE(parallel_nthreads(0, 10, 4) == 1u);
+    REQUIRE(parallel_nthreads(9, 10, 4) == 1u);
+    REQUIRE(parallel_nthreads(25, 10, 4) == 2u);
+    REQUIRE(parallel_nthreads(1000, 10, 4) == 4u);
+    REQUIRE(parallel_nthreads(1000, 10, 0) >= 1u);
+    // Check that the chunks cover the range without overlaps.
+    for (std::size_t n = 0; n < 20u; ++n) {
+        for (unsigned nc = 1; nc < 7u; ++nc) {
+            std::size_t cur = 0;
+            for (unsigned i = 0; i < nc; ++i) {
+                const auto c = parallel_chunk(n, nc, i);
+                REQUIRE(c.first == cur);
+                REQUIRE(c.second >= c.first);
+                REQUIRE(c.second - c.first <= n / nc + 1u);
+                cur = c.second;
+            }
+            REQUIRE(cur == n);
+        }
+    }
+    // Exception transport.
+    std::vector<int> out(4);
+    parallel_run(4, [&out](unsigned i) { out[i] = static_cast<int>(i) + 1; });
+    REQUIRE((out == std::vector<int>{1, 2, 3, 4}));
+    REQUIRE_THROWS_PREDICATE(parallel_run(4,
+                                          [](unsigned i) {
+                                              if (i == 1u || i == 2u) {
+                                                  throw std::invalid_argument(std::to_string(i));
+                                              }
+                                          }),
+                             std::invalid_argument,
+                             [](const std::invalid_argument &ex) { return std::string(ex.what()) == "1"; });
+    parallel_run(0, [](unsigned) { throw std::invalid_argument(""); });
+}
+
+struct parallel_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        std::vector<integer> v;
+        // Empty ranges.
+        REQUIRE(parallel_product(v.begin(), v.end()) == 1);
+        REQUIRE(parallel_sum(v.begin(), v.end()) == 0);
+        REQUIRE((std::is_same<integer, decltype(parallel_product(v.begin(), v.end()))>::value));
+        REQUIRE((std::is_same<integer, decltype(parallel_sum(v.cbegin(), v.cend()))>::value));
+        v.emplace_back(-3);
+        REQUIRE(parallel_product(v.begin(), v.end()) == -3);
+        REQUIRE(parallel_sum(v.begin(), v.end()) == -3);
+        std::uniform_int_distribution<int> dist(-1000, 1000), sdist(0, 20000);
+        mpz_raii prod, sum;
+        for (int i = 0; i < ntries; ++i) {
+            v.clear();
+            ::mpz_set_ui(&prod.m_mpz, 1u);
+            ::mpz_set_ui(&sum.m_mpz, 0u);
+            const auto size = sdist(rng);
+            for (int j = 0; j < size; ++j) {
+                auto tmp = dist(rng);
+                // Avoid zero in the product.
+                tmp = tmp ? tmp : 1;
+                v.emplace_back(tmp);
+                ::mpz_mul_si(&prod.m_mpz, &prod.m_mpz, tmp);
+                ::mpz_add(&sum.m_mpz, &sum.m_mpz, v.back().get_mpz_view());
+            }
+            for (unsigned nt : {0u, 1u, 2u, 3u, 8u}) {
+                REQUIRE(lex_cast(parallel_product(v.begin(), v.end(), nt)) == lex_cast(prod));
+                REQUIRE(lex_cast(parallel_sum(v.begin(), v.end(), nt)) == lex_cast(sum));
+            }
+            // Try with a non random-access range.
+            std::list<integer> l(v.begin(), v.end());
+            REQUIRE(lex_cast(parallel_product(l.begin(), l.end(), 3)) == lex_cast(prod));
+            REQUIRE(lex_cast(parallel_sum(l.begin(), l.end(), 3)) == lex_cast(sum));
+        }
+    }
+};
+
+TEST_CASE("parallel_product_sum")
+{
+    tuple_for_each(sizes{}, parallel_tester{});
+}
+
+struct parallel_mul_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        ::gmp_randstate_t state;
+        ::gmp_randinit_default(state);
+        mpz_raii m1, m2, m3;
+        integer n1, n2, n3;
+        // Small operands, forwarding to mul().
+        n1 = 123;
+        n2 = -456;
+        REQUIRE(&parallel_mul(n3, n1, n2, 4) == &n3);
+        REQUIRE(n3 == -56088);
+        REQUIRE(parallel_mul(n1, n2) == -56088);
+        // Check the result against mpz_mul() for a few combinations of sizes (in bits) and numbers of threads.
+        auto check = [&](::mp_bitcnt_t b1, ::mp_bitcnt_t b2, int s1, int s2, unsigned nt) {
+            ::mpz_urandomb(&m1.m_mpz, state, b1);
+            ::mpz_urandomb(&m2.m_mpz, state, b2);
+            if (s1 < 0) {
+                ::mpz_neg(&m1.m_mpz, &m1.m_mpz);
+            }
+            if (s2 < 0) {
+                ::mpz_neg(&m2.m_mpz, &m2.m_mpz);
+            }
+            n1 = &m1.m_mpz;
+            n2 = &m2.m_mpz;
+            ::mpz_mul(&m3.m_mpz, &m1.m_mpz, &m2.m_mpz);
+            parallel_mul(n3, n1, n2, nt);
+            REQUIRE(n3 == integer{&m3.m_mpz});
+            REQUIRE(parallel_mul(n2, n1, nt) == integer{&m3.m_mpz});
+            // Overlapping arguments.
+            auto n1_copy(n1);
+            parallel_mul(n1_copy, n1_copy, n2, nt);
+            REQUIRE(n1_copy == integer{&m3.m_mpz});
+            auto n2_copy(n2);
+            parallel_mul(n2_copy, n1, n2_copy, nt);
+            REQUIRE(n2_copy == integer{&m3.m_mpz});
+            ::mpz_mul(&m3.m_mpz, &m1.m_mpz, &m1.m_mpz);
+            parallel_mul(n1, n1, n1, nt);
+            REQUIRE(n1 == integer{&m3.m_mpz});
+        };
+        const ::mp_bitcnt_t lb = GMP_NUMB_BITS;
+        for (unsigned nt : {0u, 1u, 2u, 3u, 5u, 9u}) {
+            check(lb * 20000u, lb * 20000u, 1, 1, nt);
+            check(lb * 20000u, lb * 17000u, -1, 1, nt);
+            check(lb * 9000u, lb * 40000u, 1, -1, nt);
+            check(lb * 50000u, lb * 9000u, -1, -1, nt);
+            check(lb * 300u, lb * 40000u, 1, 1, nt);
+        }
+        // Operands with large blocks of zero limbs.
+        ::mpz_setbit(&m1.m_mpz, lb * 30000u);
+        ::mpz_set_ui(&m2.m_mpz, 1u);
+        ::mpz_mul_2exp(&m2.m_mpz, &m2.m_mpz, lb * 25000u);
+        ::mpz_sub_ui(&m2.m_mpz, &m2.m_mpz, 1u);
+        n1 = &m1.m_mpz;
+        n2 = &m2.m_mpz;
+        ::mpz_mul(&m3.m_mpz, &m1.m_mpz, &m2.m_mpz);
+        REQUIRE(parallel_mul(n1, n2, 4) == integer{&m3.m_mpz});
+        ::mpz_set_ui(&m1.m_mpz, 0u);
+        ::mpz_setbit(&m1.m_mpz, lb * 30000u);
+        n1 = &m1.m_mpz;
+        ::mpz_mul(&m3.m_mpz, &m1.m_mpz, &m2.m_mpz);
+        REQUIRE(parallel_mul(n1, n2, 4) == integer{&m3.m_mpz});
+        ::gmp_randclear(state);
+    }
+};
+
+TEST_CASE("parallel_mul")
+{
+    tuple_for_each(sizes{}, parallel_mul_tester{});
+}
+
+struct batch_gcd_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        std::vector<integer> v;
+        REQUIRE(batch_gcd(v.begin(), v.end()).empty());
+        REQUIRE((std::is_same<std::vector<integer>, decltype(batch_gcd(v.cbegin(), v.cend()))>::value));
+        v.emplace_back(-6);
+        REQUIRE((batch_gcd(v.begin(), v.end()) == std::vector<integer>{integer{1}}));
+        v.emplace_back(-4);
+        REQUIRE((batch_gcd(v.begin(), v.end()) == std::vector<integer>{integer{2}, integer{2}}));
+        v.emplace_back(15);
+        REQUIRE((batch_gcd(v.begin(), v.end()) == std::vector<integer>{integer{6}, integer{2}, integer{3}}));
+        // Zeroes.
+        v.emplace_back(0);
+        REQUIRE((batch_gcd(v.begin(), v.end())
+                 == std::vector<integer>{integer{6}, integer{4}, integer{15}, integer{360}}));
+        v.emplace_back(0);
+        REQUIRE((batch_gcd(v.begin(), v.end())
+                 == std::vector<integer>{integer{6}, integer{4}, integer{15}, integer{0}, integer{0}}));
+        // Random testing against the naive algorithm. Use products of pairs of primes
+        // drawn from a small set, so that non-trivial GCDs show up.
+        std::vector<integer> primes;
+        integer p{1000};
+        for (int i = 0; i < 200; ++i) {
+            primes.push_back(p = nextprime(p));
+        }
+        integer big{1};
+        big <<= 150;
+        big = nextprime(big);
+        primes.push_back(big);
+        std::uniform_int_distribution<std::size_t> pdist(0u, primes.size() - 1u);
+        std::uniform_int_distribution<int> sdist(0, 300), sgn_dist(0, 1);
+        for (int i = 0; i < ntries; ++i) {
+            v.clear();
+            const auto size = sdist(rng);
+            for (int j = 0; j < size; ++j) {
+                v.push_back(primes[pdist(rng)] * primes[pdist(rng)]);
+                if (sgn_dist(rng)) {
+                    v.back().neg();
+                }
+            }
+            std::vector<integer> expected;
+            for (std::size_t j = 0; j < v.size(); ++j) {
+                integer prod{1};
+                for (std::size_t k = 0; k < v.size(); ++k) {
+                    if (k != j) {
+                        prod *= v[k];
+                    }
+                }
+                expected.push_back(gcd(v[j], prod));
+            }
+            for (unsigned nt : {0u, 1u, 3u, 8u}) {
+                REQUIRE(batch_gcd(v.begin(), v.end(), nt) == expected);
+            }
+        }
+    }
+};
+
+TEST_CASE("batch_gcd")
+{
+    tuple_for_each(sizes{}, batch_gcd_tester{});
+}
+
+// Naive computation of the primes in [lo, hi).
+template <typename T>
+static std::vector<T> naive_prime_range(unsigned long long lo, unsigned long long hi)
+{
+    std::vector<T> retval;
+    mpz_raii tmp;
+    for (auto n = lo; n < hi; ++n) {
+        ::mpz_set_str(&tmp.m_mpz, std::to_string(n).c_str(), 10);
+        if (::mpz_probab_prime_p(&tmp.m_mpz, 25)) {
+            retval.push_back(static_cast<T>(n));
+        }
+    }
+    return retval;
+}
+
+struct prime_range_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        REQUIRE((std::is_same<std::vector<integer>, decltype(prime_range(integer{}, integer{}))>::value));
+        REQUIRE(prime_range(integer{}, integer{}).empty());
+        REQUIRE(prime_range(integer{10}, integer{3}).empty());
+        REQUIRE(prime_range(integer{-10}, integer{2}).empty());
+        REQUIRE((prime_range(integer{-10}, integer{3}) == std::vector<integer>{integer{2}}));
+        REQUIRE((prime_range(integer{2}, integer{12}) == std::vector<integer>{integer{2}, integer{3}, integer{5},
+                                                                              integer{7}, integer{11}}));
+        REQUIRE((prime_range(integer{3}, integer{11}) == std::vector<integer>{integer{3}, integer{5}, integer{7}}));
+        const auto r1 = naive_prime_range<integer>(0, 200000), r2 = naive_prime_range<integer>(123457, 300001);
+        for (unsigned nt : {0u, 1u, 3u, 8u}) {
+            REQUIRE(prime_range(integer{0}, integer{200000}, nt) == r1);
+            REQUIRE(prime_range(integer{123457}, integer{300001}, nt) == r2);
+        }
+        // Large values, close to the upper limit.
+        const auto max = std::numeric_limits<unsigned long long>::max();
+        REQUIRE(prime_range(integer{max - 2000u}, integer{max}, 2) == naive_prime_range<integer>(max - 2000u, max));
+        REQUIRE(prime_range(integer{1000000000000ull}, integer{1000000020000ull}, 3)
+                == naive_prime_range<integer>(1000000000000ull, 1000000020000ull));
+        REQUIRE_THROWS_PREDICATE(prime_range(integer{0}, integer{max} + 1, 2), std::overflow_error,
+                                 [](const std::overflow_error &) { return true; });
+    }
+};
+
+TEST_CASE("prime_range")
+{
+    tuple_for_each(sizes{}, prime_range_tester{});
+    // Native integral types.
+    REQUIRE((std::is_same<std::vector<int>, decltype(prime_range(0, 0))>::value));
+    REQUIRE(prime_range(-100, 2).empty());
+    REQUIRE((prime_range(-100, 20) == std::vector<int>{2, 3, 5, 7, 11, 13, 17, 19}));
+    REQUIRE(prime_range(0, 200000, 4) == naive_prime_range<int>(0, 200000));
+    REQUIRE(prime_range(100000ull, 150000ull) == naive_prime_range<unsigned long long>(100000, 150000));
+    REQUIRE(prime_range(short(0), short(30000), 2) == naive_prime_range<short>(0, 30000));
+    REQUIRE(prime_range(char(0), char(100)) == naive_prime_range<char>(0, 100));
+}
@@ -85,6 +85,52 @@ struct pow_tester {
         random_xy(3);
         random_xy(4);
 
+        // Storage of the result around the static size limit.
+        const auto nb = static_cast<unsigned long>(S::value * unsigned(GMP_NUMB_BITS));
+        n2 = 2;
+        pow_ui(n1, n2, nb - 1u);
+        REQUIRE(n1.is_static());
+        REQUIRE(n1.nbits() == nb);
+        REQUIRE(n1 == integer{1} << (nb - 1u));
+        pow_ui(n1, n2, nb);
+        REQUIRE(!n1.is_static());
+        REQUIRE(n1 == integer{1} << nb);
+        n1.promote();
+        pow_ui(n1, n2, 3);
+        REQUIRE(n1.is_static());
+        REQUIRE(n1 == 8);
+        n2 = -3;
+        pow_ui(n1, n2, 0);
+        REQUIRE(n1 == 1);
+        pow_ui(n1, n2, 1);
+        REQUIRE(n1 == -3);
+        pow_ui(n1, n2, 41);
+        ::mpz_set_si(&m2.m_mpz, -3);
+        ::mpz_pow_ui(&m1.m_mpz, &m2.m_mpz, 41u);
+        REQUIRE((lex_cast(n1) == lex_cast(m1)));
+        REQUIRE(n1.is_static() == (n1.size() <= S::value));
+        pow_ui(n1, integer{1}, std::numeric_limits<unsigned long>::max());
+        REQUIRE(n1 == 1);
+        REQUIRE(n1.is_static());
+        pow_ui(n1, integer{-1}, std::numeric_limits<unsigned long>::max());
+        REQUIRE(n1 == -1);
+        pow_ui(n1, integer{}, std::numeric_limits<unsigned long>::max());
+        REQUIRE(n1 == 0);
+        REQUIRE(n1.is_static());
+        // Small bases with all exponents whose result fits in static storage.
+        for (int b = -12; b <= 12; ++b) {
+            ::mpz_set_si(&m2.m_mpz, b);
+            for (unsigned long e = 0; e < 3u * nb; ++e) {
+                ::mpz_pow_ui(&m1.m_mpz, &m2.m_mpz, e);
+                if (::mpz_size(&m1.m_mpz) > 2u * S::value) {
+                    break;
+                }
+                pow_ui(n1, integer{b}, e);
+                REQUIRE((lex_cast(n1) == lex_cast(m1)));
+                REQUIRE(n1.is_static() == (::mpz_size(&m1.m_mpz) <= S::value));
+            }
+        }
+
         // Tests for the convenience pow() overloads.
         REQUIRE(pow(integer{0}, 0) == 1);
         REQUIRE(pow(0, integer{0}) == 1);
@@ -8,6 +8,7 @@
 
 #include <cstddef>
 #include <gmp.h>
+#include <random>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -22,6 +23,8 @@
 
 static int ntries = 1000;
 
+static std::mt19937 rng;
+
 using namespace mppp;
 using namespace mppp_test;
 
@@ -50,6 +53,48 @@ struct probab_prime_p_tester {
         REQUIRE((probab_prime_p(integer{17}) != 0));
         REQUIRE((probab_prime_p(integer{49979687ll}) != 0));
         REQUIRE((probab_prime_p(integer{128}) == 0));
+        // Small values.
+        for (int i = 0; i < 3000; ++i) {
+            ::mpz_set_si(&m1.m_mpz, i);
+            REQUIRE((probab_prime_p(integer{i}) != 0) == (::mpz_probab_prime_p(&m1.m_mpz, 25) != 0));
+        }
+        // Carmichael numbers and strong pseudoprimes to several bases.
+        for (const auto &str :
+             {"561", "41041", "3215031751", "2152302898747", "3474749660383", "341550071728321",
+              "3825123056546413051", "318665857834031151167461", "3317044064679887385961981",
+              "18446744073709551557", "18446744073709551629", "340282366920938463463374607431768211297",
+              "340282366920938463463374607431768211455", "4611686014132420609"}) {
+            ::mpz_set_str(&m1.m_mpz, str, 10);
+            REQUIRE((probab_prime_p(integer{str}) != 0) == (::mpz_probab_prime_p(&m1.m_mpz, 25) != 0));
+        }
+        // Products of two primes of comparable size, and primes, with 1 and 2 limbs.
+        mpz_raii p1, p2, tmp;
+        for (auto b : {GMP_NUMB_BITS / 2, GMP_NUMB_BITS}) {
+            for (int i = 0; i < 100; ++i) {
+                random_integer(tmp, 1, rng);
+                ::mpz_tdiv_q_2exp(&tmp.m_mpz, &tmp.m_mpz, static_cast<::mp_bitcnt_t>(GMP_NUMB_BITS - b));
+                ::mpz_nextprime(&p1.m_mpz, &tmp.m_mpz);
+                random_integer(tmp, 1, rng);
+                ::mpz_tdiv_q_2exp(&tmp.m_mpz, &tmp.m_mpz, static_cast<::mp_bitcnt_t>(GMP_NUMB_BITS - b));
+                ::mpz_nextprime(&p2.m_mpz, &tmp.m_mpz);
+                REQUIRE(integer{mpz_to_str(&p1.m_mpz)}.probab_prime_p() != 0);
+                ::mpz_mul(&m1.m_mpz, &p1.m_mpz, &p2.m_mpz);
+                REQUIRE(integer{mpz_to_str(&m1.m_mpz)}.probab_prime_p() == 0);
+            }
+        }
+        // Random values.
+        for (unsigned x = 1; x <= 3u; ++x) {
+            for (int i = 0; i < ntries; ++i) {
+                random_integer(m1, x, rng);
+                integer n{mpz_to_str(&m1.m_mpz)};
+                if (n.is_static() && i % 2) {
+                    n.promote();
+                }
+                REQUIRE((n.probab_prime_p() != 0) == (::mpz_probab_prime_p(&m1.m_mpz, 25) != 0));
+                ::mpz_nextprime(&m1.m_mpz, &m1.m_mpz);
+                REQUIRE(integer{mpz_to_str(&m1.m_mpz)}.probab_prime_p() != 0);
+            }
+        }
         // Test errors.
         REQUIRE_THROWS_PREDICATE(probab_prime_p(n1, 0), std::invalid_argument, [](const std::invalid_argument &ex) {
             return std::string(ex.what())
@@ -151,3 +151,165 @@ TEST_CASE("sqrt")
 {
     tuple_for_each(sizes{}, sqrt_tester{});
 }
+
+struct sqrtrem_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        mpz_raii m1, m2, m3, tmp;
+        integer n1, n2, n3;
+        REQUIRE_THROWS_PREDICATE(sqrtrem(n1, n1, n2), std::invalid_argument, [](const std::invalid_argument &ex) {
+            return std::string(ex.what())
+                   == "When performing an integer square root with remainder, the result 'rop' and the "
+                      "remainder 'rem' must be distinct objects";
+        });
+        REQUIRE_THROWS_PREDICATE(sqrtrem(n1, n2, integer{-5}), std::domain_error, [](const std::domain_error &ex) {
+            return std::string(ex.what()) == "Cannot compute the square root of the negative number -5";
+        });
+        sqrtrem(n1, n2, integer{});
+        REQUIRE(n1 == 0);
+        REQUIRE(n2 == 0);
+        std::uniform_int_distribution<int> sdist(0, 1);
+        auto check = [&]() {
+            ::mpz_sqrtrem(&m1.m_mpz, &m2.m_mpz, &m3.m_mpz);
+            n3 = integer{&m3.m_mpz};
+            if (n3.is_static() && sdist(rng)) {
+                n3.promote();
+            }
+            if (sdist(rng)) {
+                // Make the return values dynamic sometimes.
+                n1 = integer{&m3.m_mpz};
+                n1.promote();
+                n2 = n1;
+            }
+            sqrtrem(n1, n2, n3);
+            REQUIRE((lex_cast(n1) == lex_cast(m1)));
+            REQUIRE((lex_cast(n2) == lex_cast(m2)));
+            REQUIRE(perfect_square_p(n3) == (::mpz_perfect_square_p(&m3.m_mpz) != 0));
+            // Overlapping arguments.
+            auto n3_copy(n3);
+            sqrtrem(n3_copy, n2, n3_copy);
+            REQUIRE((lex_cast(n3_copy) == lex_cast(m1)));
+            n3_copy = n3;
+            sqrtrem(n1, n3_copy, n3_copy);
+            REQUIRE((lex_cast(n3_copy) == lex_cast(m2)));
+        };
+        for (unsigned x = 1; x <= 4u; ++x) {
+            for (int i = 0; i < ntries; ++i) {
+                random_integer(m3, x, rng);
+                check();
+                // Squares and their neighbours.
+                random_integer(tmp, (x + 1u) / 2u, rng);
+                ::mpz_mul(&m3.m_mpz, &tmp.m_mpz, &tmp.m_mpz);
+                check();
+                ::mpz_add_ui(&m3.m_mpz, &m3.m_mpz, 1u);
+                check();
+                if (mpz_sgn(&tmp.m_mpz)) {
+                    ::mpz_sub_ui(&m3.m_mpz, &m3.m_mpz, 2u);
+                    check();
+                }
+            }
+        }
+        // Limb boundaries.
+        for (auto b : {GMP_NUMB_BITS, 2 * GMP_NUMB_BITS}) {
+            ::mpz_set_ui(&m3.m_mpz, 1u);
+            ::mpz_mul_2exp(&m3.m_mpz, &m3.m_mpz, static_cast<::mp_bitcnt_t>(b));
+            ::mpz_sub_ui(&m3.m_mpz, &m3.m_mpz, 1u);
+            check();
+        }
+        REQUIRE(!perfect_square_p(integer{-4}));
+        REQUIRE(perfect_square_p(integer{}));
+    }
+};
+
+TEST_CASE("sqrtrem")
+{
+    tuple_for_each(sizes{}, sqrtrem_tester{});
+}
+
+struct root_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        mpz_raii m1, m2, m3, tmp;
+        integer n1, n2, n3;
+        REQUIRE_THROWS_PREDICATE(root(n1, integer{8}, 0), std::domain_error, [](const std::domain_error &ex) {
+            return std::string(ex.what()) == "Cannot compute the integer root of degree zero of 8";
+        });
+        REQUIRE_THROWS_PREDICATE(root(integer{-8}, 4), std::domain_error, [](const std::domain_error &ex) {
+            return std::string(ex.what())
+                   == "Cannot compute the integer root of even degree 4 of the negative number -8";
+        });
+        REQUIRE_THROWS_PREDICATE(rootrem(n1, n1, integer{8}, 3), std::invalid_argument,
+                                 [](const std::invalid_argument &ex) {
+                                     return std::string(ex.what())
+                                            == "When performing an integer root with remainder, the result 'rop' and "
+                                               "the remainder 'rem' must be distinct objects";
+                                 });
+        REQUIRE(root(n1, integer{-27}, 3));
+        REQUIRE(n1 == -3);
+        REQUIRE(!root(n1, integer{-28}, 3));
+        REQUIRE(n1 == -3);
+        REQUIRE(root(integer{1}, 1000000ul) == 1);
+        REQUIRE(root(integer{12345}, 1) == 12345);
+        std::uniform_int_distribution<int> sdist(0, 1);
+        std::uniform_int_distribution<unsigned long> kdist(1, 70);
+        auto check = [&](unsigned long k) {
+            if (!(k % 2u) && mpz_sgn(&m3.m_mpz) < 0) {
+                ::mpz_neg(&m3.m_mpz, &m3.m_mpz);
+            }
+            const bool exact = ::mpz_root(&m1.m_mpz, &m3.m_mpz, k) != 0;
+            ::mpz_rootrem(&m1.m_mpz, &m2.m_mpz, &m3.m_mpz, k);
+            n3 = integer{&m3.m_mpz};
+            if (n3.is_static() && sdist(rng)) {
+                n3.promote();
+            }
+            if (sdist(rng)) {
+                n1 = integer{&m3.m_mpz};
+                n1.promote();
+                n2 = n1;
+            }
+            REQUIRE(root(n1, n3, k) == exact);
+            REQUIRE((lex_cast(n1) == lex_cast(m1)));
+            REQUIRE((lex_cast(root(n3, k)) == lex_cast(m1)));
+            rootrem(n1, n2, n3, k);
+            REQUIRE((lex_cast(n1) == lex_cast(m1)));
+            REQUIRE((lex_cast(n2) == lex_cast(m2)));
+            REQUIRE(perfect_power_p(n3) == (::mpz_perfect_power_p(&m3.m_mpz) != 0));
+        };
+        for (unsigned x = 0; x <= 3u; ++x) {
+            for (int i = 0; i < ntries; ++i) {
+                const auto k = kdist(rng);
+                random_integer(m3, x, rng);
+                if (sdist(rng)) {
+                    ::mpz_neg(&m3.m_mpz, &m3.m_mpz);
+                }
+                check(k);
+                // Exact powers and their neighbours.
+                random_integer(tmp, 1, rng);
+                ::mpz_tdiv_q_2exp(&tmp.m_mpz, &tmp.m_mpz,
+                                  static_cast<::mp_bitcnt_t>(GMP_NUMB_BITS - GMP_NUMB_BITS / k));
+                ::mpz_pow_ui(&m3.m_mpz, &tmp.m_mpz, k);
+                check(k);
+                ::mpz_add_ui(&m3.m_mpz, &m3.m_mpz, 1u);
+                check(k);
+                ::mpz_sub_ui(&m3.m_mpz, &m3.m_mpz, 2u);
+                check(k);
+            }
+        }
+        // Perfect powers.
+        for (long i = -300; i < 300; ++i) {
+            ::mpz_set_si(&m3.m_mpz, i);
+            REQUIRE(perfect_power_p(integer{i}) == (::mpz_perfect_power_p(&m3.m_mpz) != 0));
+        }
+        REQUIRE(perfect_power_p(integer{1} << (GMP_NUMB_BITS - 1)));
+        REQUIRE(perfect_power_p(-(integer{1} << (GMP_NUMB_BITS - 1))) == (GMP_NUMB_BITS % 2 == 0));
+    }
+};
+
+TEST_CASE("root")
+{
+    tuple_for_each(sizes{}, root_tester{});
+}
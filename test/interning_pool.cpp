@@ -0,0 +1,138 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <mp++/integer.hpp>
+#include <mp++/interning_pool.hpp>
+#include <mp++/rational.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static const std::string big = "-1234567890123456789012345678901234567890123456789012345678901234567890123456789012345";
+
+struct integer_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        interning_pool<integer> pool;
+        REQUIRE(pool.size() == 0u);
+        const integer n{big};
+        const auto a = pool.intern(n);
+        REQUIRE(pool.size() == 1u);
+        REQUIRE(a.get() == n);
+        REQUIRE(a.hash() == hash(n));
+        REQUIRE(hash(a) == hash(n));
+        REQUIRE(std::hash<interned<integer>>{}(a) == hash(n));
+        // Interning an equal value returns the same handle.
+        auto b = pool.intern(integer{big});
+        REQUIRE(pool.size() == 1u);
+        REQUIRE(a == b);
+        REQUIRE(!(a != b));
+        REQUIRE(&a.get() == &b.get());
+        const auto c = pool.intern(n + 1);
+        REQUIRE(pool.size() == 2u);
+        REQUIRE(a != c);
+        REQUIRE(!(a == c));
+        REQUIRE(c.get() == n + 1);
+        b = c;
+        REQUIRE(b == c);
+        // Handles are stable as the pool grows.
+        const auto ptr = &a.get();
+        std::vector<interned<integer>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(pool.intern(integer{i % 100}));
+        }
+        REQUIRE(pool.size() == 102u);
+        REQUIRE(&pool.intern(n).get() == ptr);
+        REQUIRE(a.get() == n);
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE(v[static_cast<std::size_t>(i)] == v[static_cast<std::size_t>(i % 100)]);
+            REQUIRE(v[static_cast<std::size_t>(i)].get() == i % 100);
+        }
+        std::unordered_set<interned<integer>> us(v.begin(), v.end());
+        REQUIRE(us.size() == 100u);
+        // Moving into the pool.
+        integer m{big};
+        m *= 2;
+        const auto d = pool.intern(std::move(m));
+        REQUIRE(d.get() == integer{big} * 2);
+        REQUIRE(pool.size() == 103u);
+        pool.clear();
+        REQUIRE(pool.size() == 0u);
+        REQUIRE(pool.intern(n).get() == n);
+    }
+};
+
+TEST_CASE("interning_pool integer")
+{
+    tuple_for_each(sizes{}, integer_tester{});
+}
+
+struct rational_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using rational = rational<S::value>;
+        interning_pool<rational> pool;
+        const auto a = pool.intern(rational{big + "/7"});
+        const auto b = pool.intern(rational{3, -6});
+        REQUIRE(pool.size() == 2u);
+        REQUIRE(a != b);
+        REQUIRE((b.get() == rational{-1, 2}));
+        REQUIRE((b.hash() == hash(rational{-1, 2})));
+        REQUIRE((pool.intern(rational{-2, 4}) == b));
+        REQUIRE(pool.intern(rational{big + "/7"}) == a);
+        REQUIRE(pool.size() == 2u);
+    }
+};
+
+TEST_CASE("interning_pool rational")
+{
+    tuple_for_each(sizes{}, rational_tester{});
+}
+
+TEST_CASE("interning_pool threading")
+{
+    interning_pool<integer<1>> pool;
+    std::vector<std::vector<interned<integer<1>>>> results(4u);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < 4u; ++t) {
+        threads.emplace_back([&pool, &results, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                results[t].push_back(pool.intern(integer<1>{big} + i));
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    REQUIRE(pool.size() == 1000u);
+    for (std::size_t t = 1; t < 4u; ++t) {
+        REQUIRE(results[t] == results[0]);
+    }
+}
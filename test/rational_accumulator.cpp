@@ -0,0 +1,117 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+#include <mp++/rational_accumulator.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+static int ntries = 1000;
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static std::mt19937 rng;
+
+template <typename T, typename U>
+using add_assign_t = decltype(std::declval<T &>() += std::declval<const U &>());
+
+struct accumulator_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using rational = rational<S::value>;
+        using integer = integer<S::value>;
+        using acc_t = rational_accumulator<S::value>;
+        REQUIRE((is_detected<add_assign_t, acc_t, rational>::value));
+        REQUIRE((is_detected<add_assign_t, acc_t, integer>::value));
+        REQUIRE((is_detected<add_assign_t, acc_t, int>::value));
+        REQUIRE((!is_detected<add_assign_t, acc_t, double>::value));
+        REQUIRE((!is_detected<add_assign_t, acc_t, rational_accumulator<S::value + 1u>>::value));
+        acc_t acc;
+        REQUIRE(acc.get_num() == 0);
+        REQUIRE(acc.get_den() == 1);
+        REQUIRE(acc.finalize() == 0);
+        // Simple values.
+        acc += rational{1, 2};
+        acc += rational{1, 3};
+        acc -= rational{1, 6};
+        REQUIRE(acc.get_den() == 6);
+        acc += 2;
+        acc -= integer{1};
+        acc += rational{1, 4};
+        REQUIRE(acc.get_den() == 12);
+        auto res = acc.finalize();
+        REQUIRE(res.is_canonical());
+        REQUIRE((res == rational{23, 12}));
+        REQUIRE(acc.get_num() == 0);
+        REQUIRE(acc.get_den() == 1);
+        // Result with a non-trivial final gcd.
+        acc += rational{1, 6};
+        acc += rational{1, 3};
+        REQUIRE(acc.get_den() == 6);
+        res = acc.finalize();
+        REQUIRE((res == rational{1, 2}));
+        REQUIRE(res.get_den() == 2);
+        // Sums cancelling to zero.
+        acc += rational{-5, 7};
+        acc += rational{5, 7};
+        res = acc.finalize();
+        REQUIRE(res.is_zero());
+        REQUIRE(res.get_den().is_one());
+        // Random values, compared with the plain sum.
+        std::uniform_int_distribution<int> sdist(0, 1), ndist(-1000, 1000), ddist(1, 60);
+        const integer big{"123456789012345678901234567890123456789012345678901234567890"};
+        for (int k = 0; k < 10; ++k) {
+            rational sum;
+            for (int i = 0; i < ntries / 10; ++i) {
+                rational q{ndist(rng), ddist(rng)};
+                if (sdist(rng)) {
+                    q *= big;
+                }
+                if (sdist(rng)) {
+                    acc += q;
+                    sum += q;
+                } else {
+                    acc -= q;
+                    sum -= q;
+                }
+                if (i % 7 == 0) {
+                    acc += i;
+                    sum += i;
+                }
+            }
+            // The denominator is the lcm of the accumulated denominators.
+            REQUIRE(acc.get_den().sgn() == 1);
+            REQUIRE(acc.get_den() <= integer{"9690712164777231700912800"});
+            res = acc.finalize();
+            REQUIRE(res.is_canonical());
+            REQUIRE(res == sum);
+        }
+    }
+};
+
+TEST_CASE("rational_accumulator")
+{
+    tuple_for_each(sizes{}, accumulator_tester{});
+}
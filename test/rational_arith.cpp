@@ -12,7 +12,9 @@
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
+#include <mp++/integer.hpp>
 #include <mp++/rational.hpp>
 
 #include "test_utils.hpp"
@@ -721,3 +723,100 @@ TEST_CASE("div")
 {
     tuple_for_each(sizes{}, div_tester{});
 }
+
+struct limb_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using rational = rational<S::value>;
+        using integer = integer<S::value>;
+        // Operands whose num and den are single limbs, including the extremal values.
+        const ::mp_limb_t max = GMP_NUMB_MAX;
+        std::vector<rational> values;
+        for (auto num : {::mp_limb_t(0), ::mp_limb_t(1), ::mp_limb_t(6), max - 1u, max, max / 2u}) {
+            for (auto den : {::mp_limb_t(1), ::mp_limb_t(2), ::mp_limb_t(9), max - 1u, max, max / 3u}) {
+                values.emplace_back(integer{num}, integer{den});
+                values.emplace_back(-integer{num}, integer{den});
+            }
+        }
+        std::uniform_int_distribution<::mp_limb_t> ldist(1u, max);
+        for (int i = 0; i < ntries / 5; ++i) {
+            const ::mp_limb_t num = ldist(rng) >> (ldist(rng) % 64u), den = ldist(rng) >> (ldist(rng) % 64u);
+            values.emplace_back(integer{num}, integer{den ? den : 1u});
+        }
+        mpq_raii m1, m2, m3;
+        auto set_mpq = [](mpq_raii &m, const rational &q) {
+            const auto v = get_mpq_view(q);
+            ::mpq_set(&m.m_mpq, &v);
+        };
+        for (const auto &q1 : values) {
+            set_mpq(m1, q1);
+            for (const auto &q2 : values) {
+                set_mpq(m2, q2);
+                rational r;
+                add(r, q1, q2);
+                ::mpq_add(&m3.m_mpq, &m1.m_mpq, &m2.m_mpq);
+                REQUIRE(r.is_canonical());
+                REQUIRE((lex_cast(r) == lex_cast(m3)));
+                sub(r, q1, q2);
+                ::mpq_sub(&m3.m_mpq, &m1.m_mpq, &m2.m_mpq);
+                REQUIRE(r.is_canonical());
+                REQUIRE((lex_cast(r) == lex_cast(m3)));
+                mul(r, q1, q2);
+                ::mpq_mul(&m3.m_mpq, &m1.m_mpq, &m2.m_mpq);
+                REQUIRE(r.is_canonical());
+                REQUIRE((lex_cast(r) == lex_cast(m3)));
+                if (!q2.is_zero()) {
+                    div(r, q1, q2);
+                    ::mpq_div(&m3.m_mpq, &m1.m_mpq, &m2.m_mpq);
+                    REQUIRE(r.is_canonical());
+                    REQUIRE((lex_cast(r) == lex_cast(m3)));
+                }
+                REQUIRE(cmp(q1, q2) == ::mpq_cmp(&m1.m_mpq, &m2.m_mpq));
+            }
+            // Overlapping arguments.
+            auto r = q1;
+            add(r, r, r);
+            ::mpq_add(&m3.m_mpq, &m1.m_mpq, &m1.m_mpq);
+            REQUIRE((lex_cast(r) == lex_cast(m3)));
+            r = q1;
+            mul(r, r, r);
+            ::mpq_mul(&m3.m_mpq, &m1.m_mpq, &m1.m_mpq);
+            REQUIRE((lex_cast(r) == lex_cast(m3)));
+            if (!q1.is_zero()) {
+                r = q1;
+                div(r, r, r);
+                REQUIRE(r == 1);
+            }
+            r = q1;
+            sub(r, r, q1);
+            REQUIRE(r.is_zero());
+            REQUIRE(r.get_den().is_one());
+        }
+        // Canonicalisation of single-limb values.
+        rational q{integer{12}, integer{-18}, false};
+        q.canonicalise();
+        REQUIRE((q == rational{-2, 3}));
+        q = rational{integer{0}, integer{-18}, false};
+        q.canonicalise();
+        REQUIRE(q.is_zero());
+        REQUIRE(q.get_den().is_one());
+        q = rational{integer{max}, integer{max}, false};
+        q.canonicalise();
+        REQUIRE(q == 1);
+        // Dynamic rop.
+        rational d{integer{"123456789012345678901234567890123456789012345678901234567890"}, integer{7}};
+        d._get_num().promote();
+        d._get_den().promote();
+        add(d, rational{1, 3}, rational{1, 6});
+        REQUIRE((d == rational{1, 2}));
+        mul(d, rational{integer{max}, integer{1}}, rational{integer{max}, integer{1}});
+        REQUIRE(d.get_num() == integer{max} * max);
+        REQUIRE(d.get_den() == 1);
+    }
+};
+
+TEST_CASE("single limb")
+{
+    tuple_for_each(sizes{}, limb_tester{});
+}
@@ -1265,6 +1265,40 @@ struct canonicalise_tester {
         canonicalise(q);
         REQUIRE(q.get_num() == -3);
         REQUIRE(q.get_den() == 7);
+        // Dynamic and mixed storage.
+        using integer = integer<S::value>;
+        const integer big{"1234567890123456789012345678901234567890123456789012345678901234567890123456789"};
+        for (int i = 0; i < 3; ++i) {
+            q._get_num() = big * 6;
+            q._get_den() = -big * 4;
+            if (i == 1) {
+                q._get_num() = 12;
+                q._get_den() = -18;
+                q._get_den().promote();
+                REQUIRE(q.get_den().is_dynamic());
+            } else if (i == 2) {
+                q._get_num() = -big * 35;
+                q._get_den() = 10;
+            }
+            canonicalise(q);
+            REQUIRE(q.is_canonical());
+            if (i == 0) {
+                REQUIRE(q.get_num() == -3);
+                REQUIRE(q.get_den() == 2);
+            } else if (i == 1) {
+                REQUIRE(q.get_num() == -2);
+                REQUIRE(q.get_den() == 3);
+            } else {
+                REQUIRE(q.get_num() == -big * 7);
+                REQUIRE(q.get_den() == 2);
+            }
+        }
+        q._get_num() = big * big * 3;
+        q._get_den() = big * 9;
+        canonicalise(q);
+        // NOTE: big is a multiple of 3.
+        REQUIRE(q.get_num() == big / 3);
+        REQUIRE(q.get_den() == 1);
     }
 };
 
@@ -1273,6 +1307,70 @@ TEST_CASE("canonicalise")
     tuple_for_each(sizes{}, canonicalise_tester{});
 }
 
+struct addsub_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using rational = rational<S::value>;
+        // Check q1 + q2 and q1 - q2, with rop distinct from and overlapping with the operands.
+        auto check = [](const rational &q1, const rational &q2, const rational &sum, const rational &diff) {
+            rational rop;
+            add(rop, q1, q2);
+            REQUIRE(rop == sum);
+            REQUIRE(rop.is_canonical());
+            sub(rop, q1, q2);
+            REQUIRE(rop == diff);
+            REQUIRE(rop.is_canonical());
+            REQUIRE(q1 + q2 == sum);
+            REQUIRE(q1 - q2 == diff);
+            auto tmp1 = q1;
+            add(tmp1, tmp1, q2);
+            REQUIRE(tmp1 == sum);
+            tmp1 = q1;
+            sub(tmp1, tmp1, q2);
+            REQUIRE(tmp1 == diff);
+            REQUIRE(tmp1.is_canonical());
+            auto tmp2 = q2;
+            add(tmp2, q1, tmp2);
+            REQUIRE(tmp2 == sum);
+            tmp2 = q2;
+            sub(tmp2, q1, tmp2);
+            REQUIRE(tmp2 == diff);
+            REQUIRE(tmp2.is_canonical());
+        };
+        // NOTE: big is odd, a multiple of 3 and not a multiple of 5.
+        const integer big{"1234567890123456789012345678901234567890123456789012345678901234567890123456789"};
+        // b has more limbs than the largest static size tested.
+        const integer b{big * big * big};
+        REQUIRE(b.is_dynamic());
+        // Coprime dens.
+        check(rational{1, b}, rational{1, b + 1}, rational{2 * b + 1, b * (b + 1)}, rational{1, b * (b + 1)});
+        // The dens have a common factor, which does not divide the resulting numerator.
+        check(rational{1, 2 * b}, rational{1, 3 * b}, rational{5, 6 * b}, rational{1, 6 * b});
+        check(rational{-b - 1, 2 * b}, rational{1, 3 * b}, rational{-3 * b - 1, 6 * b},
+              rational{-3 * b - 5, 6 * b});
+        // The dens have a common factor, which also divides the resulting numerator.
+        check(rational{1, 2 * b}, rational{1, 6 * b}, rational{2, 3 * b}, rational{1, 3 * b});
+        check(rational{-1, 2 * b}, rational{1, 6 * b}, rational{-1, 3 * b}, rational{-2, 3 * b});
+        // Small values in dynamic storage.
+        rational q1{1, 6}, q2{1, 10};
+        q1._get_den().promote();
+        q2._get_num().promote();
+        REQUIRE(q1.get_den().is_dynamic());
+        REQUIRE(q2.get_num().is_dynamic());
+        check(q1, q2, rational{4, 15}, rational{1, 15});
+        q1 = rational{1, 6};
+        q1._get_num().promote();
+        check(q1, rational{5, 9}, rational{13, 18}, rational{-7, 18});
+    }
+};
+
+TEST_CASE("addsub")
+{
+    tuple_for_each(sizes{}, addsub_tester{});
+}
+
 struct stream_tester {
     template <typename S>
     void operator()(const S &) const
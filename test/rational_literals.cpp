@@ -0,0 +1,38 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <type_traits>
+
+#include <mp++/config.hpp>
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace mppp;
+
+#if MPPP_CPLUSPLUS >= 201402L
+
+TEST_CASE("rational literals")
+{
+    using namespace mppp::literals;
+    REQUIRE((std::is_same<decltype(0_q1), rational<1>>::value));
+    REQUIRE((std::is_same<decltype(0_q2), rational<2>>::value));
+    REQUIRE((std::is_same<decltype(0_q3), rational<3>>::value));
+    REQUIRE(0_q1 == 0);
+    REQUIRE(-42_q1 == -42);
+    REQUIRE((3 / 7_q1 == rational<1>{3, 7}));
+    REQUIRE((-6 / 4_q2 == rational<2>{-3, 2}));
+    REQUIRE((1_q3 / 123456789012345678901234567890_z3 == rational<3>{"1/123456789012345678901234567890"}));
+    REQUIRE((0xff_q1).get_num() == 255);
+    REQUIRE((0xff_q1).get_den() == 1);
+    REQUIRE(123456789012345678901234567890_q1 == rational<1>{"123456789012345678901234567890"});
+}
+
+#endif
@@ -0,0 +1,193 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+#include <mp++/relocating_vector.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>>;
+
+// A type which is not trivially relocatable, and whose copy constructor can be made to throw.
+struct tracker {
+    static int n_alive;
+    static int throw_countdown;
+    tracker(int v = 0) : m_value(v), m_self(this)
+    {
+        ++n_alive;
+    }
+    tracker(const tracker &other) : m_value(other.m_value), m_self(this)
+    {
+        if (throw_countdown > 0 && --throw_countdown == 0) {
+            throw std::runtime_error("copy failure");
+        }
+        ++n_alive;
+    }
+    // NOTE: the move constructor can throw, thus relocation will use the copy constructor.
+    tracker(tracker &&other) : tracker(static_cast<const tracker &>(other))
+    {
+    }
+    tracker &operator=(const tracker &) = default;
+    ~tracker()
+    {
+        --n_alive;
+    }
+    bool ok() const
+    {
+        return m_self == this;
+    }
+    int m_value;
+    const tracker *m_self;
+};
+
+int tracker::n_alive = 0;
+int tracker::throw_countdown = 0;
+
+struct relocate_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using rational = rational<S::value>;
+        REQUIRE(is_trivially_relocatable<integer>::value);
+        REQUIRE(is_trivially_relocatable<rational>::value);
+        // Relocation of static and dynamic integers.
+        alignas(integer) unsigned char src_buf[3 * sizeof(integer)], dst_buf[3 * sizeof(integer)];
+        auto src = reinterpret_cast<integer *>(src_buf), dst = reinterpret_cast<integer *>(dst_buf);
+        ::new (static_cast<void *>(src)) integer{-42};
+        ::new (static_cast<void *>(src + 1)) integer{"123456789012345678901234567890123456789012345678901234567890"};
+        ::new (static_cast<void *>(src + 2)) integer{};
+        src[2].promote();
+        const auto ptr = src[1].get_mpz_t()->_mp_d;
+        REQUIRE(uninitialized_relocate(src, src + 3, dst) == dst + 3);
+        REQUIRE(dst[0] == -42);
+        REQUIRE(dst[1] == integer{"123456789012345678901234567890123456789012345678901234567890"});
+        REQUIRE(dst[1].get_mpz_t()->_mp_d == ptr);
+        REQUIRE(dst[2] == 0);
+        REQUIRE(dst[2].is_dynamic());
+        REQUIRE(uninitialized_relocate(src, src, dst) == dst);
+        for (auto i = 0; i < 3; ++i) {
+            dst[i].~integer();
+        }
+        // Container of integers.
+        relocating_vector<integer> v;
+        REQUIRE(v.empty());
+        REQUIRE(v.capacity() == 0u);
+        REQUIRE(v.data() == nullptr);
+        integer big{1};
+        big <<= 500;
+        for (int i = 0; i < 1000; ++i) {
+            if (i % 2) {
+                v.emplace_back(i);
+            } else {
+                v.push_back(big + i);
+            }
+        }
+        REQUIRE(v.size() == 1000u);
+        REQUIRE(v.capacity() == 1024u);
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE((v[static_cast<std::size_t>(i)] == (i % 2 ? integer{i} : big + i)));
+        }
+        // Pushing back an element of the container itself.
+        v.shrink_to_fit();
+        REQUIRE(v.capacity() == 1000u);
+        v.push_back(v[0]);
+        REQUIRE(v.back() == big);
+        REQUIRE(v.front() == big);
+        v.resize(2000u, v[0]);
+        REQUIRE(v.size() == 2000u);
+        REQUIRE(v[1999] == big);
+        v.resize(10u);
+        REQUIRE(v.size() == 10u);
+        v.resize(12u);
+        REQUIRE(v[11] == 0);
+        REQUIRE(v.at(1) == 1);
+        REQUIRE_THROWS_PREDICATE(v.at(12), std::out_of_range, [](const std::out_of_range &ex) {
+            return std::string(ex.what()) == "Cannot access the element at index 12 in a relocating_vector of size 12";
+        });
+        auto v2(v);
+        REQUIRE(v2.size() == 12u);
+        REQUIRE(v2[0] == big);
+        auto v3(std::move(v2));
+        REQUIRE(v2.empty());
+        REQUIRE(v3[0] == big);
+        v2 = v3;
+        REQUIRE(v2.size() == 12u);
+        v3 = std::move(v2);
+        REQUIRE(v3.size() == 12u);
+        v3.pop_back();
+        REQUIRE(v3.size() == 11u);
+        v3.clear();
+        REQUIRE(v3.empty());
+        REQUIRE(v3.capacity() == 12u);
+        relocating_vector<rational> vr{rational{1, 2}, rational{-3, 4}};
+        vr.emplace_back(5, 6);
+        REQUIRE(vr.size() == 3u);
+        REQUIRE((vr[2] == rational{5, 6}));
+        integer sum;
+        for (const auto &n : v) {
+            sum += n;
+        }
+        REQUIRE(sum == 5 * big + 45);
+    }
+};
+
+TEST_CASE("relocate")
+{
+    tuple_for_each(sizes{}, relocate_tester{});
+}
+
+TEST_CASE("relocating_vector non-relocatable")
+{
+    REQUIRE(is_trivially_relocatable<int>::value);
+    REQUIRE(!is_trivially_relocatable<std::string>::value);
+    REQUIRE(!is_trivially_relocatable<tracker>::value);
+    {
+        relocating_vector<tracker> v(3u, tracker{7});
+        REQUIRE(tracker::n_alive == 3);
+        for (int i = 0; i < 10; ++i) {
+            v.emplace_back(i);
+        }
+        REQUIRE(tracker::n_alive == 13);
+        for (const auto &t : v) {
+            REQUIRE(t.ok());
+        }
+        // Strong exception safety on reallocation.
+        v.shrink_to_fit();
+        tracker::throw_countdown = 5;
+        REQUIRE_THROWS_AS(v.emplace_back(42), std::runtime_error &);
+        REQUIRE(tracker::n_alive == 13);
+        REQUIRE(v.size() == 13u);
+        REQUIRE(v.capacity() == 13u);
+        REQUIRE(v[12].m_value == 9);
+        tracker::throw_countdown = 2;
+        REQUIRE_THROWS_AS(v.resize(20u, tracker{1}), std::runtime_error &);
+        REQUIRE(v.size() == 13u);
+        tracker::throw_countdown = 0;
+        relocating_vector<std::string> vs{"hello", "world"};
+        vs.push_back(vs[0]);
+        REQUIRE(vs[2] == "hello");
+    }
+    REQUIRE(tracker::n_alive == 0);
+}
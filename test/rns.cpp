@@ -0,0 +1,161 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <gmp.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include <mp++/integer.hpp>
+#include <mp++/rns.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+static int ntries = 1000;
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static std::mt19937 rng;
+
+TEST_CASE("limb modular arithmetic")
+{
+    mpz_raii a, b, m, r;
+    std::uniform_int_distribution<::mp_limb_t> dist(1u, GMP_NUMB_MAX);
+    for (int i = 0; i < ntries; ++i) {
+        const auto mod = dist(rng);
+        const auto x = dist(rng) % mod, y = dist(rng) % mod;
+        ::mpz_set_str(&a.m_mpz, lex_cast(x).c_str(), 10);
+        ::mpz_set_str(&b.m_mpz, lex_cast(y).c_str(), 10);
+        ::mpz_set_str(&m.m_mpz, lex_cast(mod).c_str(), 10);
+        ::mpz_add(&r.m_mpz, &a.m_mpz, &b.m_mpz);
+        ::mpz_mod(&r.m_mpz, &r.m_mpz, &m.m_mpz);
+        REQUIRE(lex_cast(limb_addmod(x, y, mod)) == lex_cast(r));
+        ::mpz_sub(&r.m_mpz, &a.m_mpz, &b.m_mpz);
+        ::mpz_mod(&r.m_mpz, &r.m_mpz, &m.m_mpz);
+        REQUIRE(lex_cast(limb_submod(x, y, mod)) == lex_cast(r));
+        ::mpz_mul(&r.m_mpz, &a.m_mpz, &b.m_mpz);
+        ::mpz_mod(&r.m_mpz, &r.m_mpz, &m.m_mpz);
+        REQUIRE(lex_cast(limb_mulmod(x, y, mod)) == lex_cast(r));
+        ::mpz_powm_ui(&r.m_mpz, &a.m_mpz, 12345ul, &m.m_mpz);
+        REQUIRE(lex_cast(limb_powmod(x, 12345ul, mod)) == lex_cast(r));
+        if (mod > 1u && ::mpz_invert(&r.m_mpz, &a.m_mpz, &m.m_mpz)) {
+            REQUIRE(lex_cast(limb_invmod(x, mod)) == lex_cast(r));
+        }
+    }
+    REQUIRE(limb_powmod(5u, 0u, 1u) == 0u);
+    REQUIRE(limb_powmod(0u, 0u, 7u) == 1u);
+    REQUIRE(limb_addmod(GMP_NUMB_MAX - 1u, GMP_NUMB_MAX - 1u, GMP_NUMB_MAX) == GMP_NUMB_MAX - 2u);
+}
+
+struct rns_tester {
+    template <typename S>
+    inline void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using basis = rns_basis<S::value>;
+        using rns = rns_integer<S::value>;
+        REQUIRE_THROWS_PREDICATE(basis{0}, std::invalid_argument, [](const std::invalid_argument &ex) {
+            return std::string(ex.what()) == "Cannot construct an RNS basis for values with 0 bits";
+        });
+        for (std::size_t nbits : {1u, 10u, 62u, 64u, 130u, 1000u}) {
+            basis b{nbits};
+            REQUIRE(b.get_nbits() == nbits);
+            REQUIRE(b.size() == b.get_primes().size());
+            REQUIRE(b.size() > 0u);
+            REQUIRE(b.get_modulus().nbits() >= nbits + 2u);
+            integer prod{1};
+            for (std::size_t i = 0; i < b.size(); ++i) {
+                REQUIRE(integer{b.get_primes()[i]}.probab_prime_p());
+                REQUIRE((b.get_primes()[i] >> (GMP_NUMB_BITS - 1)) == 0u);
+                if (i) {
+                    REQUIRE(b.get_primes()[i] < b.get_primes()[i - 1u]);
+                }
+                prod *= b.get_primes()[i];
+            }
+            REQUIRE(prod == b.get_modulus());
+            // Zero and simple values.
+            REQUIRE(rns{b}.to_integer() == 0);
+            REQUIRE(rns{b}.get_residues().size() == b.size());
+            REQUIRE(&rns{b}.get_basis() == &b);
+            REQUIRE(rns(b, integer{1}).to_integer() == 1);
+            REQUIRE(rns(b, integer{-1}).to_integer() == -1);
+            // Extremes of the representable range.
+            integer lim{1};
+            lim <<= nbits;
+            lim -= 1;
+            REQUIRE(rns(b, lim).to_integer() == lim);
+            REQUIRE(rns(b, -lim).to_integer() == -lim);
+            // Random testing of the arithmetic, keeping the exact results within the range.
+            mpz_raii tmp;
+            std::uniform_int_distribution<unsigned> ldist(0u, static_cast<unsigned>(nbits / 2u / GMP_NUMB_BITS));
+            std::uniform_int_distribution<int> sdist(0, 1);
+            integer half_lim{1};
+            half_lim <<= nbits / 2u;
+            for (int i = 0; i < ntries / 10; ++i) {
+                random_integer(tmp, ldist(rng), rng);
+                integer x{&tmp.m_mpz};
+                random_integer(tmp, ldist(rng), rng);
+                integer y{&tmp.m_mpz};
+                x %= half_lim;
+                y %= half_lim;
+                if (sdist(rng)) {
+                    x.neg();
+                }
+                if (sdist(rng)) {
+                    y.neg();
+                }
+                const rns rx(b, x), ry(b, y);
+                REQUIRE(rx.to_integer() == x);
+                REQUIRE((rx + ry).to_integer() == x + y);
+                REQUIRE((rx - ry).to_integer() == x - y);
+                REQUIRE((rx * ry).to_integer() == x * y);
+                REQUIRE((-rx).to_integer() == -x);
+                rns r(b);
+                REQUIRE(&add(r, rx, ry) == &r);
+                REQUIRE(r.to_integer() == x + y);
+                REQUIRE(&sub(r, rx, ry) == &r);
+                REQUIRE(r.to_integer() == x - y);
+                REQUIRE(&mul(r, rx, ry) == &r);
+                REQUIRE(r.to_integer() == x * y);
+                r = rx;
+                r += ry;
+                REQUIRE(r.to_integer() == x + y);
+                r -= ry;
+                REQUIRE(r == rx);
+                r *= ry;
+                REQUIRE(r.to_integer() == x * y);
+                REQUIRE((r != rx || x * y == x));
+            }
+            // Wrap-around modulo M.
+            REQUIRE((rns(b, b.get_modulus()) == rns{b}));
+            // Copies of the basis are compatible, different bases are not.
+            const basis b_copy(b);
+            REQUIRE((rns(b, integer{3}) + rns(b_copy, integer{4})).to_integer() == 7);
+            const basis other{nbits + 1000u};
+            REQUIRE_THROWS_PREDICATE(rns(b) + rns(other), std::invalid_argument, [](const std::invalid_argument &ex) {
+                return std::string(ex.what()) == "Cannot operate on RNS integers with different bases";
+            });
+        }
+    }
+};
+
+TEST_CASE("rns")
+{
+    tuple_for_each(sizes{}, rns_tester{});
+}
@@ -0,0 +1,184 @@
+// Copyright 2016-2017 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the mp++ library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/exceptions.hpp>
+#include <mp++/integer.hpp>
+#include <mp++/shared_integer.hpp>
+
+#include "test_utils.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using namespace mppp;
+using namespace mppp_test;
+
+using sizes = std::tuple<std::integral_constant<std::size_t, 1>, std::integral_constant<std::size_t, 2>,
+                         std::integral_constant<std::size_t, 3>, std::integral_constant<std::size_t, 6>,
+                         std::integral_constant<std::size_t, 10>>;
+
+static const std::string big = "-1234567890123456789012345678901234567890123456789012345678901234567890123456789012345";
+
+template <typename T, typename U>
+using add_t = decltype(std::declval<const T &>() + std::declval<const U &>());
+
+struct basic_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using shared = shared_integer<S::value>;
+        REQUIRE((std::is_same<typename shared::int_t, integer>::value));
+        shared a;
+        REQUIRE(a.use_count() == 0);
+        REQUIRE(a.get() == 0);
+        REQUIRE(a.sgn() == 0);
+        REQUIRE(a.to_string() == "0");
+        REQUIRE(shared{42}.get() == 42);
+        REQUIRE(shared{-1.5}.get() == -1);
+        REQUIRE(shared{big}.to_string() == big);
+        REQUIRE((shared{"ff", 16}.get() == 255));
+        REQUIRE_THROWS_AS(shared{"abc"}, std::invalid_argument &);
+        REQUIRE(static_cast<integer>(shared{big}) == integer{big});
+        REQUIRE(static_cast<int>(shared{-42}) == -42);
+        REQUIRE(static_cast<double>(shared{-42}) == -42.);
+        REQUIRE_THROWS_AS(static_cast<int>(shared{big}), std::overflow_error &);
+        std::ostringstream oss;
+        oss << shared{big};
+        REQUIRE(oss.str() == big);
+        // Copies share the value.
+        shared b{integer{big}};
+        REQUIRE(b.use_count() == 1);
+        auto c = b;
+        REQUIRE(b.use_count() == 2);
+        REQUIRE(c.use_count() == 2);
+        REQUIRE(&c.get() == &b.get());
+        a = c;
+        REQUIRE(b.use_count() == 3);
+        // Mutation detaches.
+        const auto &old = b.get();
+        c.get_mutable() += 1;
+        REQUIRE(c.use_count() == 1);
+        REQUIRE(b.use_count() == 2);
+        REQUIRE(&b.get() == &old);
+        REQUIRE(b.get() == integer{big});
+        REQUIRE(c.get() == integer{big} + 1);
+        // A unique value is modified in place.
+        const auto ptr = &c.get();
+        c.get_mutable() -= 1;
+        REQUIRE(&c.get() == ptr);
+        REQUIRE(c == b);
+        // Moves.
+        shared d{std::move(c)};
+        REQUIRE(d.get() == integer{big});
+        REQUIRE(c.use_count() == 0);
+        REQUIRE(c.get() == 0);
+        c = std::move(d);
+        REQUIRE(c.get() == integer{big});
+        // Mutating the default-constructed zero.
+        shared z;
+        z.get_mutable() += 5;
+        REQUIRE(z.get() == 5);
+        REQUIRE(shared{}.get() == 0);
+    }
+};
+
+TEST_CASE("shared_integer basic")
+{
+    tuple_for_each(sizes{}, basic_tester{});
+}
+
+struct arith_tester {
+    template <typename S>
+    void operator()(const S &) const
+    {
+        using integer = integer<S::value>;
+        using shared = shared_integer<S::value>;
+        REQUIRE((std::is_same<add_t<shared, shared>, shared>::value));
+        REQUIRE((std::is_same<add_t<shared, integer>, shared>::value));
+        REQUIRE((std::is_same<add_t<integer, shared>, shared>::value));
+        REQUIRE((std::is_same<add_t<shared, int>, shared>::value));
+        REQUIRE((std::is_same<add_t<unsigned long long, shared>, shared>::value));
+        REQUIRE((!is_detected<add_t, shared, shared_integer<S::value + 1u>>::value));
+        REQUIRE((!is_detected<add_t, shared, double>::value));
+        const integer n{big}, m{"987654321098765432109876543210"};
+        const shared a{n}, b{m};
+        REQUIRE((+a).use_count() == 2);
+        REQUIRE((-a).get() == -n);
+        REQUIRE((a + b).get() == n + m);
+        REQUIRE((a - b).get() == n - m);
+        REQUIRE((a * b).get() == n * m);
+        REQUIRE((a / b).get() == n / m);
+        REQUIRE((a % b).get() == n % m);
+        REQUIRE((a + m).get() == n + m);
+        REQUIRE((n - b).get() == n - m);
+        REQUIRE((a * 3).get() == n * 3);
+        REQUIRE((3u - a).get() == 3u - n);
+        REQUIRE((a / -7ll).get() == n / -7ll);
+        REQUIRE((100 % b).get() == 100);
+        REQUIRE_THROWS_AS(a / shared{}, zero_division_error &);
+        REQUIRE_THROWS_AS(a % 0, zero_division_error &);
+        // Comparisons.
+        REQUIRE(a == a);
+        REQUIRE(a == n);
+        REQUIRE(n == a);
+        REQUIRE(a != b);
+        REQUIRE(a != 1);
+        REQUIRE(a < b);
+        REQUIRE(a < 0);
+        REQUIRE(a <= n);
+        REQUIRE(b > a);
+        REQUIRE(1 > a);
+        REQUIRE(b >= m);
+        // In-place operators detach only the target.
+        auto c = a;
+        c += b;
+        REQUIRE(c.get() == n + m);
+        REQUIRE(a.get() == n);
+        REQUIRE(a.use_count() == 1);
+        c = a;
+        c -= 5;
+        REQUIRE(c.get() == n - 5);
+        REQUIRE(a.get() == n);
+        c = a;
+        c *= m;
+        REQUIRE(c.get() == n * m);
+        c = a;
+        c /= b;
+        REQUIRE(c.get() == n / m);
+        c = a;
+        c %= b;
+        REQUIRE(c.get() == n % m);
+        REQUIRE(a.get() == n);
+        REQUIRE_THROWS_AS(c /= 0, zero_division_error &);
+        REQUIRE_THROWS_AS(c %= shared{}, zero_division_error &);
+        // Self-referencing in-place operations.
+        c = a;
+        c += c;
+        REQUIRE(c.get() == 2 * n);
+        REQUIRE(a.get() == n);
+        c *= c;
+        REQUIRE(c.get() == 4 * n * n);
+        shared z;
+        z += z;
+        REQUIRE(z.get() == 0);
+    }
+};
+
+TEST_CASE("shared_integer arith")
+{
+    tuple_for_each(sizes{}, arith_tester{});
+}
@@ -125,6 +125,16 @@ inline std::string lex_cast_tr(const mppp::rational<SSize> &q)
     return q.to_string();
 }
 
+#if defined(MPPP_ENABLE_EXPRESSION_TEMPLATES)
+
+template <typename T, typename std::enable_if<mppp::is_integer_expr<T>::value, int>::type = 0>
+inline std::string lex_cast_tr(const T &e)
+{
+    return mppp::integer_expr_value(e).to_string();
+}
+
+#endif
+
 template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
 inline T lex_cast_tr(const T &x)
 {